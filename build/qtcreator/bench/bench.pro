@@ -0,0 +1,7 @@
+CONFIG += libtsduck
+include(../tsduck.pri)
+TEMPLATE = app
+TARGET = bench
+
+HEADERS += $$system(find $$SRCROOT/bench -name \\*.h)
+SOURCES += $$system(find $$SRCROOT/bench -name \\*.cpp)
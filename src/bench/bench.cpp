@@ -0,0 +1,184 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSDuck micro-benchmarks.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMain.h"
+#include "tsSafePtr.h"
+#include "tsbench.h"
+#include "tsjsonArray.h"
+#include "tsSysInfo.h"
+#include "tsVersionInfo.h"
+#include "tsTime.h"
+TSDUCK_SOURCE;
+TS_MAIN(MainCode);
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+namespace {
+    class Options: public ts::Args
+    {
+        TS_NOBUILD_NOCOPY(Options);
+    public:
+        Options(int argc, char *argv[]);
+
+        bool              list;         // list benchmarks, do not run them
+        uint32_t          no_cpu;       // disabled CPU features
+        ts::UStringVector tests;        // name filters
+        ts::MilliSecond   duration;     // target duration per benchmark
+        size_t            repetitions;  // number of measurements per benchmark
+        ts::UString       output;       // output file name
+
+        // Check if a benchmark name matches the filters.
+        bool selected(const ts::UString& name) const;
+    };
+}
+
+Options::Options(int argc, char *argv[]) :
+    Args(u"Run TSDuck micro-benchmarks and report results in JSON format", u"[options]"),
+    list(false),
+    no_cpu(0),
+    tests(),
+    duration(0),
+    repetitions(0),
+    output()
+{
+    option(u"disable-cpu-features", 0, STRING);
+    help(u"disable-cpu-features", u"'name1,name2,...'",
+         u"Do not use the specified CPU features in the optimized implementations, "
+         u"typically to measure the generic implementations. "
+         u"The possible names are " + ts::SysInfo::CPUFeatureEnum.nameList() + u" and all. "
+         u"The environment variable TSDUCK_NO_CPU_FEATURES can be used the same way in all TSDuck commands.");
+
+    option(u"duration", 'd', POSITIVE);
+    help(u"duration", u"milliseconds",
+         u"Approximate duration of the measurements of each benchmark. The default is 1000 milliseconds.");
+
+    option(u"list", 'l');
+    help(u"list", u"List the names of all benchmarks and exit.");
+
+    option(u"output", 'o', STRING);
+    help(u"output", u"filename",
+         u"Save the JSON results in the specified file. By default, the results are written on standard output.");
+
+    option(u"repetitions", 'r', POSITIVE);
+    help(u"repetitions",
+         u"Number of repeated measurements of each benchmark. "
+         u"The best and median times are reported. The default is 5.");
+
+    option(u"test", 't', STRING, 0, UNLIMITED_COUNT);
+    help(u"test", u"name",
+         u"Run only the benchmarks containing the specified string in their name (case insensitive). "
+         u"Several --test options may be specified. By default, all benchmarks are run.");
+
+    analyze(argc, argv);
+
+    list = present(u"list");
+    getValues(tests, u"test");
+    getIntValue(duration, u"duration", 1000);
+    getIntValue(repetitions, u"repetitions", 5);
+    getValue(output, u"output");
+    if (present(u"disable-cpu-features")) {
+        ts::SysInfo::DecodeCPUFeatures(no_cpu, value(u"disable-cpu-features"), *this);
+    }
+
+    exitOnError();
+}
+
+bool Options::selected(const ts::UString& name) const
+{
+    if (tests.empty()) {
+        return true;
+    }
+    for (auto it = tests.begin(); it != tests.end(); ++it) {
+        if (name.contain(*it, ts::CASE_INSENSITIVE)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+//  Program entry point
+//----------------------------------------------------------------------------
+
+int MainCode(int argc, char *argv[])
+{
+    Options opt(argc, argv);
+    ts::SysInfo* const sys = ts::SysInfo::Instance();
+
+    // Must be done before any use of the optimized implementations.
+    sys->disableCPUFeatures(opt.no_cpu);
+
+    // Global description of the execution context.
+    ts::json::Object root;
+    root.add(u"tsduck", ts::VersionInfo::GetVersion());
+    root.add(u"system", sys->systemName());
+    root.add(u"system_version", sys->systemVersion());
+    root.add(u"cpu", ts::VersionInfo::GetVersion(ts::VersionInfo::Format::CPU));
+    root.add(u"date", ts::Time::CurrentUTC().format(ts::Time::DATETIME));
+    root.add(u"duration_ms", int64_t(opt.duration));
+    root.add(u"repetitions", int64_t(opt.repetitions));
+
+    ts::json::ValuePtr results(new ts::json::Array);
+    root.add(u"benchmarks", results);
+
+    // Run all selected benchmarks, one at a time.
+    bool success = true;
+    for (auto it = tsbench::Repository::Factories().begin(); it != tsbench::Repository::Factories().end(); ++it) {
+        ts::SafePtr<tsbench::Benchmark> bench((*it)());
+        if (!opt.selected(bench->name())) {
+            continue;
+        }
+        if (opt.list) {
+            std::cout << bench->name() << std::endl;
+            continue;
+        }
+        opt.verbose(u"running %s", {bench->name()});
+        if (!bench->setup()) {
+            opt.error(u"cannot setup benchmark %s", {bench->name()});
+            success = false;
+        }
+        else {
+            results->set(tsbench::Measure(*bench, opt.duration, opt.repetitions));
+            bench->cleanup();
+        }
+    }
+
+    if (!opt.list && !root.save(opt.output, 2, true, opt)) {
+        success = false;
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
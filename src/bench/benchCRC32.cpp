@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmarks of CRC32 computation.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "tsCRC32.h"
+#include "tsByteBlock.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // Compute the CRC32 of a data block. The size is typical of a long section or a large buffer.
+    class CRC32Block: public tsbench::Benchmark
+    {
+    public:
+        CRC32Block(const ts::UString& name, size_t size) : Benchmark(name, u"bytes", 1), _data(size) {}
+        virtual bool setup() override
+        {
+            for (size_t i = 0; i < _data.size(); ++i) {
+                _data[i] = uint8_t(i * 7 + 3);
+            }
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            Sink += ts::CRC32(_data.data(), _data.size()).value();
+            return _data.size();
+        }
+    private:
+        ts::ByteBlock _data;
+    };
+
+    class CRC32Section: public CRC32Block
+    {
+    public:
+        CRC32Section() : CRC32Block(u"CRC32::section", 1024) {}
+    };
+
+    class CRC32Buffer: public CRC32Block
+    {
+    public:
+        CRC32Buffer() : CRC32Block(u"CRC32::buffer", 1024 * 1024) {}
+    };
+}
+
+TSBENCH_REGISTER(CRC32Section);
+TSBENCH_REGISTER(CRC32Buffer);
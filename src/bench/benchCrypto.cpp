@@ -0,0 +1,149 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmarks of cryptographic algorithms.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "benchData.h"
+#include "tsDVBCSA2.h"
+#include "tsAES.h"
+#include "tsCTR.h"
+#include "tsByteBlock.h"
+TSDUCK_SOURCE;
+
+namespace {
+    const uint8_t CW[8] = {0x01, 0x02, 0x03, 0x06, 0x05, 0x06, 0x07, 0x12};
+    const uint8_t AES_KEY[16] = {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+    constexpr size_t PKT_HEADER_SIZE = 4;  // Size of a TS packet header without adaptation field.
+    constexpr size_t PACKET_COUNT = 1024;
+    constexpr size_t PAYLOAD_SIZE = ts::PKT_SIZE - PKT_HEADER_SIZE;
+
+    // DVB-CSA2 encryption of TS payloads, one packet at a time.
+    class DVBCSA2Single: public tsbench::Benchmark
+    {
+    public:
+        DVBCSA2Single() : Benchmark(u"DVBCSA2::encryptInPlace", u"packets", ts::PKT_SIZE), _csa(), _packets() {}
+        virtual bool setup() override
+        {
+            tsbench::Data::PES(_packets, PACKET_COUNT);
+            return _csa.setKey(CW, sizeof(CW));
+        }
+        virtual uint64_t run() override
+        {
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                _csa.encryptInPlace(it->b + PKT_HEADER_SIZE, PAYLOAD_SIZE);
+            }
+            Sink += _packets.front().b[PKT_HEADER_SIZE];
+            return _packets.size();
+        }
+    private:
+        ts::DVBCSA2        _csa;
+        ts::TSPacketVector _packets;
+    };
+
+    // DVB-CSA2 encryption of TS payloads, using the bitsliced batch implementation.
+    class DVBCSA2Batch: public tsbench::Benchmark
+    {
+    public:
+        DVBCSA2Batch() : Benchmark(u"DVBCSA2::encryptInPlaceBatch", u"packets", ts::PKT_SIZE), _csa(), _packets(), _data(), _sizes() {}
+        virtual bool setup() override
+        {
+            tsbench::Data::PES(_packets, PACKET_COUNT);
+            _data.resize(_packets.size());
+            _sizes.resize(_packets.size());
+            for (size_t i = 0; i < _packets.size(); ++i) {
+                _data[i] = _packets[i].b + PKT_HEADER_SIZE;
+                _sizes[i] = PAYLOAD_SIZE;
+            }
+            return _csa.setKey(CW, sizeof(CW));
+        }
+        virtual uint64_t run() override
+        {
+            _csa.encryptInPlaceBatch(_data.size(), _data.data(), _sizes.data());
+            Sink += _packets.front().b[PKT_HEADER_SIZE];
+            return _packets.size();
+        }
+    private:
+        ts::DVBCSA2         _csa;
+        ts::TSPacketVector  _packets;
+        std::vector<void*>  _data;
+        std::vector<size_t> _sizes;
+    };
+
+    // AES-128 encryption of contiguous blocks (ECB).
+    class AESBlocks: public tsbench::Benchmark
+    {
+    public:
+        AESBlocks() : Benchmark(u"AES::encryptBlocks", u"bytes", 1), _aes(), _data(64 * 1024) {}
+        virtual bool setup() override
+        {
+            return _aes.setKey(AES_KEY, sizeof(AES_KEY));
+        }
+        virtual uint64_t run() override
+        {
+            _aes.encryptBlocks(_data.data(), _data.data(), _data.size() / ts::AES::BLOCK_SIZE);
+            Sink += _data[0];
+            return _data.size();
+        }
+    private:
+        ts::AES       _aes;
+        ts::ByteBlock _data;
+    };
+
+    // AES-128 encryption of TS payloads in CTR mode, as used in ATSC 3.0 or CENC.
+    class AESCTR: public tsbench::Benchmark
+    {
+    public:
+        AESCTR() : Benchmark(u"CTR<AES>::encrypt", u"packets", ts::PKT_SIZE), _ctr(), _packets(), _iv(ts::AES::BLOCK_SIZE, 0) {}
+        virtual bool setup() override
+        {
+            tsbench::Data::PES(_packets, PACKET_COUNT);
+            return _ctr.setKey(AES_KEY, sizeof(AES_KEY)) && _ctr.setIV(_iv.data(), _iv.size());
+        }
+        virtual uint64_t run() override
+        {
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                _ctr.encryptInPlace(it->b + PKT_HEADER_SIZE, PAYLOAD_SIZE);
+            }
+            Sink += _packets.front().b[PKT_HEADER_SIZE];
+            return _packets.size();
+        }
+    private:
+        ts::CTR<ts::AES>   _ctr;
+        ts::TSPacketVector _packets;
+        ts::ByteBlock      _iv;
+    };
+}
+
+TSBENCH_REGISTER(DVBCSA2Single);
+TSBENCH_REGISTER(DVBCSA2Batch);
+TSBENCH_REGISTER(AESBlocks);
+TSBENCH_REGISTER(AESCTR);
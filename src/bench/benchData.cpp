@@ -0,0 +1,153 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "benchData.h"
+#include "tsDuckContext.h"
+#include "tsOneShotPacketizer.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+TSDUCK_SOURCE;
+
+namespace {
+    constexpr ts::PID PMT_PID_BASE    = 1000;  // PMT PID of first service.
+    constexpr ts::PID ES_PID_BASE     = 2000;  // First elementary stream.
+    constexpr size_t  PKT_HEADER_SIZE = 4;     // TS packet header without adaptation field.
+
+    // Packetize a table and append its packets.
+    void AddTable(ts::DuckContext& duck, ts::TSPacketVector& packets, ts::PID pid, const ts::AbstractTable& table)
+    {
+        ts::OneShotPacketizer pzer(duck, pid);
+        ts::TSPacketVector pkts;
+        pzer.addTable(duck, table);
+        pzer.getPackets(pkts);
+        packets.insert(packets.end(), pkts.begin(), pkts.end());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build a stream of PSI/SI.
+//----------------------------------------------------------------------------
+
+void tsbench::Data::PSI(ts::TSPacketVector& packets, size_t services, size_t cycles)
+{
+    ts::DuckContext duck;
+    packets.clear();
+
+    ts::PAT pat(0, true, 1);
+    ts::SDT sdt(true, 0, true, 1, 1);
+    for (uint16_t srv = 1; srv <= services; ++srv) {
+        pat.pmts[srv] = ts::PID(PMT_PID_BASE + srv);
+        sdt.services[srv].setName(duck, ts::UString::Format(u"Service %d", {srv}));
+        sdt.services[srv].setProvider(duck, u"TSDuck");
+    }
+    AddTable(duck, packets, ts::PID_PAT, pat);
+    AddTable(duck, packets, ts::PID_SDT, sdt);
+
+    for (uint16_t srv = 1; srv <= services; ++srv) {
+        const ts::PID video = ts::PID(ES_PID_BASE + 2 * srv);
+        ts::PMT pmt(0, true, srv, video);
+        pmt.streams[video].stream_type = ts::ST_MPEG2_VIDEO;
+        pmt.streams[video + 1].stream_type = ts::ST_MPEG2_AUDIO;
+        AddTable(duck, packets, ts::PID(PMT_PID_BASE + srv), pmt);
+    }
+
+    // Add some null packets, as in any real stream.
+    packets.resize(packets.size() + packets.size() / 4, ts::NullPacket);
+
+    // Repeat the tables with contiguous continuity counters.
+    const size_t count = packets.size();
+    std::map<ts::PID, uint8_t> cc;
+    packets.resize(count * std::max<size_t>(1, cycles));
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i] = packets[i % count];
+        const ts::PID pid = packets[i].getPID();
+        if (pid != ts::PID_NULL) {
+            packets[i].setCC(cc[pid]);
+            cc[pid] = (cc[pid] + 1) & ts::CC_MASK;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build a stream of video PES packets.
+//----------------------------------------------------------------------------
+
+void tsbench::Data::PES(ts::TSPacketVector& packets, size_t count, ts::PID pid, size_t pes_size)
+{
+    packets.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        pkt.init(pid, uint8_t(i & ts::CC_MASK), uint8_t(i));
+        if (i % pes_size == 0) {
+            // Start of a video PES packet, unbounded size.
+            static const uint8_t header[] = {0x00, 0x00, 0x01, 0xE0, 0x00, 0x00, 0x80, 0x00, 0x00};
+            pkt.setPUSI();
+            ::memcpy(pkt.b + PKT_HEADER_SIZE, header, sizeof(header));
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Build a complete transport stream.
+//----------------------------------------------------------------------------
+
+void tsbench::Data::TS(ts::TSPacketVector& packets, size_t count)
+{
+    ts::TSPacketVector psi;
+    ts::TSPacketVector video;
+    PSI(psi, 4);
+    PES(video, count, ES_PID_BASE + 2);
+
+    // One PSI packet every 20 packets, one audio packet every 8 packets, video in the rest.
+    packets.resize(count);
+    size_t ipsi = 0;
+    size_t ivideo = 0;
+    uint8_t audio_cc = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 20 == 0) {
+            packets[i] = psi[ipsi++ % psi.size()];
+        }
+        else if (i % 8 == 0) {
+            packets[i].init(ES_PID_BASE + 3, audio_cc, 0xA5);
+            audio_cc = (audio_cc + 1) & ts::CC_MASK;
+        }
+        else {
+            packets[i] = video[ivideo];
+            packets[i].setCC(uint8_t(ivideo++ & ts::CC_MASK));
+            if (ivideo % 100 == 1) {
+                // Insert a PCR in the video PID.
+                packets[i].setPCR(uint64_t(i) * 27000000 / 10000, true);
+            }
+        }
+    }
+}
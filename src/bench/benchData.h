@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Synthetic transport streams for micro-benchmarks.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+
+namespace tsbench {
+    //!
+    //! Synthetic transport streams which are used as input data by benchmarks.
+    //!
+    class Data
+    {
+    public:
+        //!
+        //! Build a stream of PSI/SI: PAT, PMT's and SDT, with some null packets.
+        //! All tables are valid and can be demuxed.
+        //! @param [out] packets Returned TS packets.
+        //! @param [in] services Number of services in the stream.
+        //! @param [in] cycles Number of repetitions of all tables. Continuity counters are adjusted.
+        //!
+        static void PSI(ts::TSPacketVector& packets, size_t services = 20, size_t cycles = 1);
+
+        //!
+        //! Build a stream of video PES packets on one PID.
+        //! @param [out] packets Returned TS packets.
+        //! @param [in] count Number of TS packets.
+        //! @param [in] pid PID of the PES packets.
+        //! @param [in] pes_size Number of TS packets per PES packet.
+        //!
+        static void PES(ts::TSPacketVector& packets, size_t count, ts::PID pid = 100, size_t pes_size = 20);
+
+        //!
+        //! Build a complete transport stream with PSI/SI, audio, video and PCR's.
+        //! @param [out] packets Returned TS packets.
+        //! @param [in] count Number of TS packets.
+        //!
+        static void TS(ts::TSPacketVector& packets, size_t count);
+    };
+}
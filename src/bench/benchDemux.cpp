@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmarks of section and PES demuxes.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "benchData.h"
+#include "tsDuckContext.h"
+#include "tsSectionDemux.h"
+#include "tsPESDemux.h"
+#include "tsBinaryTable.h"
+#include "tsSection.h"
+#include "tsPESPacket.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // Demux all sections from a stream of PSI/SI, the demux is reset between iterations.
+    class SectionDemuxFeed: public tsbench::Benchmark, private ts::TableHandlerInterface, private ts::SectionHandlerInterface
+    {
+        TS_NOCOPY(SectionDemuxFeed);
+    public:
+        SectionDemuxFeed() :
+            Benchmark(u"SectionDemux::feedPacket", u"packets", ts::PKT_SIZE),
+            _duck(),
+            _demux(_duck, this, this, ts::AllPIDs),
+            _packets()
+        {
+        }
+        virtual bool setup() override
+        {
+            tsbench::Data::PSI(_packets, 20, 100);
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            _demux.reset();
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                _demux.feedPacket(*it);
+            }
+            return _packets.size();
+        }
+    private:
+        ts::DuckContext    _duck;
+        ts::SectionDemux   _demux;
+        ts::TSPacketVector _packets;
+
+        virtual void handleTable(ts::SectionDemux&, const ts::BinaryTable& table) override
+        {
+            Sink += table.tableId();
+        }
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+        {
+            Sink += section.size();
+        }
+    };
+
+    // Demux PES packets from a video PID.
+    class PESDemuxFeed: public tsbench::Benchmark, private ts::PESHandlerInterface
+    {
+        TS_NOCOPY(PESDemuxFeed);
+    public:
+        PESDemuxFeed() :
+            Benchmark(u"PESDemux::feedPacket", u"packets", ts::PKT_SIZE),
+            _duck(),
+            _demux(_duck, this, ts::AllPIDs),
+            _packets()
+        {
+        }
+        virtual bool setup() override
+        {
+            tsbench::Data::PES(_packets, 10000);
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            _demux.reset();
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                _demux.feedPacket(*it);
+            }
+            return _packets.size();
+        }
+    private:
+        ts::DuckContext    _duck;
+        ts::PESDemux       _demux;
+        ts::TSPacketVector _packets;
+
+        virtual void handlePESPacket(ts::PESDemux&, const ts::PESPacket& packet) override
+        {
+            Sink += packet.size();
+        }
+    };
+}
+
+TSBENCH_REGISTER(SectionDemuxFeed);
+TSBENCH_REGISTER(PESDemuxFeed);
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmarks of transport stream analysis.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "benchData.h"
+#include "tsDuckContext.h"
+#include "tsTSAnalyzer.h"
+#include "tsPCRAnalyzer.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // Analyze a complete transport stream, as in tsanalyze.
+    class TSAnalyzerFeed: public tsbench::Benchmark
+    {
+        TS_NOCOPY(TSAnalyzerFeed);
+    public:
+        TSAnalyzerFeed() :
+            Benchmark(u"TSAnalyzer::feedPacket", u"packets", ts::PKT_SIZE),
+            _duck(),
+            _packets()
+        {
+        }
+        virtual bool setup() override
+        {
+            tsbench::Data::TS(_packets, 20000);
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            ts::TSAnalyzer analyzer(_duck);
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                analyzer.feedPacket(*it);
+            }
+            return _packets.size();
+        }
+    private:
+        ts::DuckContext    _duck;
+        ts::TSPacketVector _packets;
+    };
+
+    // Evaluate the bitrate from PCR's, as in tsp input or plugin "pcrbitrate".
+    class PCRAnalyzerFeed: public tsbench::Benchmark
+    {
+        TS_NOCOPY(PCRAnalyzerFeed);
+    public:
+        PCRAnalyzerFeed() :
+            Benchmark(u"PCRAnalyzer::feedPacket", u"packets", ts::PKT_SIZE),
+            _packets()
+        {
+        }
+        virtual bool setup() override
+        {
+            // 20 seconds of stream at 10,000 packets/second, beyond the 10-second window.
+            tsbench::Data::TS(_packets, 200000);
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            ts::PCRAnalyzer analyzer;
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                analyzer.feedPacket(*it);
+            }
+            return _packets.size();
+        }
+    private:
+        ts::TSPacketVector _packets;
+    };
+}
+
+TSBENCH_REGISTER(TSAnalyzerFeed);
+TSBENCH_REGISTER(PCRAnalyzerFeed);
@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmarks of transport stream files.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "benchData.h"
+#include "tsTSFile.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+TSDUCK_SOURCE;
+
+namespace {
+    constexpr size_t FILE_PACKETS  = 50000;  // Packets in the test file, about 9.4 MB.
+    constexpr size_t CHUNK_PACKETS = 1024;   // Packets per read or write operation.
+
+    // Common base class for TSFile benchmarks, manage a temporary file.
+    class TSFileBench: public tsbench::Benchmark
+    {
+        TS_NOBUILD_NOCOPY(TSFileBench);
+    public:
+        TSFileBench(const ts::UString& name) :
+            Benchmark(name, u"packets", ts::PKT_SIZE),
+            _filename(ts::TempFile(u".ts")),
+            _file(),
+            _packets()
+        {
+        }
+        virtual bool setup() override
+        {
+            tsbench::Data::TS(_packets, CHUNK_PACKETS);
+            // Create the initial content of the file.
+            bool ok = _file.open(_filename, ts::TSFile::WRITE, NULLREP, ts::TSPacketFormat::TS);
+            for (size_t count = 0; ok && count < FILE_PACKETS; count += CHUNK_PACKETS) {
+                ok = _file.writePackets(_packets.data(), nullptr, CHUNK_PACKETS, NULLREP);
+            }
+            return _file.close(NULLREP) && ok;
+        }
+        virtual void cleanup() override
+        {
+            _file.close(NULLREP);
+            ts::DeleteFile(_filename);
+        }
+    protected:
+        ts::UString        _filename;
+        ts::TSFile         _file;
+        ts::TSPacketVector _packets;
+    };
+
+    // Write a complete file.
+    class TSFileWrite: public TSFileBench
+    {
+    public:
+        TSFileWrite() : TSFileBench(u"TSFile::writePackets") {}
+        virtual uint64_t run() override
+        {
+            _file.open(_filename, ts::TSFile::WRITE, NULLREP, ts::TSPacketFormat::TS);
+            for (size_t count = 0; count < FILE_PACKETS; count += CHUNK_PACKETS) {
+                _file.writePackets(_packets.data(), nullptr, CHUNK_PACKETS, NULLREP);
+            }
+            _file.close(NULLREP);
+            return FILE_PACKETS;
+        }
+    };
+
+    // Read a complete file (from the system cache, most probably).
+    class TSFileRead: public TSFileBench
+    {
+    public:
+        TSFileRead() : TSFileBench(u"TSFile::readPackets") {}
+        virtual uint64_t run() override
+        {
+            uint64_t total = 0;
+            size_t count = 0;
+            _file.open(_filename, ts::TSFile::READ, NULLREP, ts::TSPacketFormat::TS);
+            while ((count = _file.readPackets(_packets.data(), nullptr, CHUNK_PACKETS, NULLREP)) > 0) {
+                total += count;
+            }
+            _file.close(NULLREP);
+            Sink += _packets.front().b[1];
+            return total;
+        }
+    };
+
+    // Read a complete file using a memory mapping, without copying packets.
+    class TSFileReadMapped: public TSFileBench
+    {
+    public:
+        TSFileReadMapped() : TSFileBench(u"TSFile::readPacketsInPlace") {}
+        virtual uint64_t run() override
+        {
+            uint64_t total = 0;
+            size_t count = 0;
+            const ts::TSPacket* pkt = nullptr;
+            _file.setMemoryMapped(true);
+            _file.open(_filename, ts::TSFile::READ, NULLREP, ts::TSPacketFormat::TS);
+            while ((count = _file.readPacketsInPlace(pkt, nullptr, CHUNK_PACKETS, NULLREP)) > 0) {
+                total += count;
+                Sink += pkt->b[1];
+            }
+            _file.close(NULLREP);
+            return total;
+        }
+    };
+}
+
+TSBENCH_REGISTER(TSFileWrite);
+TSBENCH_REGISTER(TSFileRead);
+TSBENCH_REGISTER(TSFileReadMapped);
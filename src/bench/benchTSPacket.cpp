@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmarks of TSPacket accessors.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "benchData.h"
+TSDUCK_SOURCE;
+
+namespace {
+    constexpr size_t PACKET_COUNT = 10000;
+
+    // Read the main header fields of all packets.
+    class TSPacketGetters: public tsbench::Benchmark
+    {
+    public:
+        TSPacketGetters() : Benchmark(u"TSPacket::getters", u"packets", ts::PKT_SIZE), _packets() {}
+        virtual bool setup() override
+        {
+            tsbench::Data::TS(_packets, PACKET_COUNT);
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            uint64_t sum = 0;
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                sum += it->getPID() + it->getCC() + it->getPUSI() + it->getPayloadSize();
+                if (it->hasPCR()) {
+                    sum += it->getPCR();
+                }
+            }
+            Sink += sum;
+            return _packets.size();
+        }
+    private:
+        ts::TSPacketVector _packets;
+    };
+
+    // Modify the main header fields of all packets.
+    class TSPacketSetters: public tsbench::Benchmark
+    {
+    public:
+        TSPacketSetters() : Benchmark(u"TSPacket::setters", u"packets", ts::PKT_SIZE), _packets() {}
+        virtual bool setup() override
+        {
+            tsbench::Data::TS(_packets, PACKET_COUNT);
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            uint8_t cc = 0;
+            for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+                it->setPID(it->getPID() ^ 0x0001);
+                it->setCC(cc);
+                it->setPUSI(!it->getPUSI());
+                cc = (cc + 1) & ts::CC_MASK;
+            }
+            Sink += _packets.front().b[1];
+            return _packets.size();
+        }
+    private:
+        ts::TSPacketVector _packets;
+    };
+}
+
+TSBENCH_REGISTER(TSPacketGetters);
+TSBENCH_REGISTER(TSPacketSetters);
@@ -0,0 +1,91 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmark of an end-to-end in-process TSProcessor chain.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "tsTSProcessor.h"
+#include "tsPluginRepository.h"
+#include "tsNullReport.h"
+TSDUCK_SOURCE;
+
+namespace {
+    constexpr size_t CHAIN_PACKETS = 200000;  // Packets per chain execution.
+    constexpr size_t CHAIN_PLUGINS = 4;       // Number of packet processors in the chain.
+
+    // A minimal packet processor which touches each packet, registered in-process.
+    class BenchPassPlugin: public ts::ProcessorPlugin
+    {
+        TS_NOBUILD_NOCOPY(BenchPassPlugin);
+    public:
+        BenchPassPlugin(ts::TSP* t) : ts::ProcessorPlugin(t, u"Touch all packets (benchmark)", u"[options]") {}
+        virtual Status processPacket(ts::TSPacket& pkt, ts::TSPacketMetadata& mdata) override
+        {
+            pkt.setCC(pkt.getCC() + 1);
+            return TSP_OK;
+        }
+    };
+}
+
+TS_REGISTER_PROCESSOR_PLUGIN(u"benchpass", BenchPassPlugin);
+
+namespace {
+    // Run a complete TSProcessor chain: null input, packet processors, drop output.
+    class TSProcessorChain: public tsbench::Benchmark
+    {
+        TS_NOCOPY(TSProcessorChain);
+    public:
+        TSProcessorChain() : Benchmark(u"TSProcessor::chain", u"packets", ts::PKT_SIZE), _args() {}
+        virtual bool setup() override
+        {
+            _args.input.set(u"null", {ts::UString::Decimal(CHAIN_PACKETS, 0, true, u"")});
+            _args.plugins.resize(CHAIN_PLUGINS);
+            for (size_t i = 0; i < CHAIN_PLUGINS; ++i) {
+                _args.plugins[i].set(u"benchpass");
+            }
+            _args.output.set(u"drop");
+            return true;
+        }
+        virtual uint64_t run() override
+        {
+            ts::TSProcessor tsproc(NULLREP);
+            if (!tsproc.start(_args)) {
+                return 0;
+            }
+            tsproc.waitForTermination();
+            return CHAIN_PACKETS;
+        }
+    private:
+        ts::TSProcessorArgs _args;
+    };
+}
+
+TSBENCH_REGISTER(TSProcessorChain);
@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Benchmarks of UString conversions.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // A text with ASCII, 2-byte and 3-byte UTF-8 sequences, repeated to make a few kilobytes.
+    std::string SampleUTF8()
+    {
+        std::string text;
+        for (int i = 0; i < 64; ++i) {
+            text.append("Transport stream \xC3\xA9l\xC3\xA9mentaire, \xE2\x82\xAC 12.50, \xCE\xB1\xCE\xB2\xCE\xB3 - ");
+        }
+        return text;
+    }
+
+    // Conversion from UTF-8 to UTF-16.
+    class UStringFromUTF8: public tsbench::Benchmark
+    {
+    public:
+        UStringFromUTF8() : Benchmark(u"UString::assignFromUTF8", u"bytes", 1), _utf8(SampleUTF8()), _str() {}
+        virtual uint64_t run() override
+        {
+            _str.assignFromUTF8(_utf8);
+            Sink += _str.size();
+            return _utf8.size();
+        }
+    private:
+        std::string _utf8;
+        ts::UString _str;
+    };
+
+    // Conversion from UTF-16 to UTF-8.
+    class UStringToUTF8: public tsbench::Benchmark
+    {
+    public:
+        UStringToUTF8() : Benchmark(u"UString::toUTF8", u"characters", 2), _str(ts::UString::FromUTF8(SampleUTF8())), _utf8() {}
+        virtual uint64_t run() override
+        {
+            _str.toUTF8(_utf8);
+            Sink += _utf8.size();
+            return _str.size();
+        }
+    private:
+        ts::UString _str;
+        std::string _utf8;
+    };
+
+    // Formatting of integer values.
+    class UStringFormat: public tsbench::Benchmark
+    {
+    public:
+        UStringFormat() : Benchmark(u"UString::Format", u"strings"), _str() {}
+        virtual uint64_t run() override
+        {
+            for (int i = 0; i < 100; ++i) {
+                _str = ts::UString::Format(u"PID 0x%X (%d): %'d packets", {i, i, i * 100003});
+                Sink += _str.size();
+            }
+            return 100;
+        }
+    private:
+        ts::UString _str;
+    };
+}
+
+TSBENCH_REGISTER(UStringFromUTF8);
+TSBENCH_REGISTER(UStringToUTF8);
+TSBENCH_REGISTER(UStringFormat);
@@ -0,0 +1,146 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsbench.h"
+#include "tsMonotonic.h"
+#include "tsjsonNumber.h"
+#include "tsjsonString.h"
+TSDUCK_SOURCE;
+
+volatile uint64_t tsbench::Benchmark::Sink = 0;
+
+
+//----------------------------------------------------------------------------
+// Benchmark base class.
+//----------------------------------------------------------------------------
+
+tsbench::Benchmark::Benchmark(const ts::UString& name, const ts::UString& unit, size_t unit_size) :
+    _name(name),
+    _unit(unit),
+    _unit_size(unit_size)
+{
+}
+
+tsbench::Benchmark::~Benchmark()
+{
+}
+
+bool tsbench::Benchmark::setup()
+{
+    return true;
+}
+
+void tsbench::Benchmark::cleanup()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Repository of benchmarks.
+//----------------------------------------------------------------------------
+
+std::list<tsbench::Repository::Factory>& tsbench::Repository::List()
+{
+    // Use a static local to avoid order of initialization issues with static registrations.
+    static std::list<Factory> factories;
+    return factories;
+}
+
+void tsbench::Repository::Add(Factory factory)
+{
+    List().push_back(factory);
+}
+
+const std::list<tsbench::Repository::Factory>& tsbench::Repository::Factories()
+{
+    return List();
+}
+
+
+//----------------------------------------------------------------------------
+// Measure a benchmark.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Run a number of iterations, return the execution time.
+    ts::NanoSecond RunIterations(tsbench::Benchmark& bench, uint64_t iterations, uint64_t& units)
+    {
+        units = 0;
+        const ts::Monotonic start(true);
+        for (uint64_t i = 0; i < iterations; ++i) {
+            units += bench.run();
+        }
+        return ts::Monotonic(true) - start;
+    }
+}
+
+ts::json::ValuePtr tsbench::Measure(Benchmark& bench, ts::MilliSecond duration, size_t repetitions)
+{
+    repetitions = std::max<size_t>(1, repetitions);
+    const ts::NanoSecond target = std::max<ts::NanoSecond>(1, duration * ts::NanoSecPerMilliSec / ts::NanoSecond(repetitions));
+
+    // Calibration: find a number of iterations which runs during the target time of one repetition.
+    // The first iteration also warms up caches and lazy initializations.
+    uint64_t iterations = 1;
+    uint64_t units = 0;
+    for (;;) {
+        const ts::NanoSecond elapsed = std::max<ts::NanoSecond>(1, RunIterations(bench, iterations, units));
+        if (elapsed >= target) {
+            break;
+        }
+        // Extrapolate with a 20% margin, at most 100 times more per step.
+        iterations = std::max(iterations + 1, std::min(iterations * 100, uint64_t((iterations * target * 6) / (elapsed * 5))));
+    }
+
+    // Repeated measurements.
+    std::vector<ts::NanoSecond> times(repetitions);
+    for (size_t i = 0; i < repetitions; ++i) {
+        times[i] = std::max<ts::NanoSecond>(1, RunIterations(bench, iterations, units));
+    }
+    std::sort(times.begin(), times.end());
+    const ts::NanoSecond best = times.front();
+    const ts::NanoSecond median = times[repetitions / 2];
+
+    // Build the JSON description of the results.
+    ts::json::ValuePtr jv(new ts::json::Object);
+    jv->add(u"name", bench.name());
+    jv->add(u"unit", bench.unit());
+    jv->add(u"iterations", int64_t(iterations));
+    jv->add(u"units", int64_t(units));
+    jv->add(u"repetitions", int64_t(repetitions));
+    jv->add(u"best_ns", int64_t(best));
+    jv->add(u"median_ns", int64_t(median));
+    jv->add(u"worst_ns", int64_t(times.back()));
+    jv->add(u"ps_per_unit", int64_t((double(best) * 1000.0) / double(std::max<uint64_t>(1, units))));
+    jv->add(u"units_per_second", int64_t((double(units) * 1.0e9) / double(best)));
+    if (bench.unitSize() > 0) {
+        jv->add(u"bytes_per_second", int64_t((double(units) * double(bench.unitSize()) * 1.0e9) / double(best)));
+    }
+    return jv;
+}
@@ -0,0 +1,172 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  TSBench, a minimal micro-benchmark framework for TSDuck.
+//!
+//!  Each benchmark is a subclass of tsbench::Benchmark which processes a
+//!  fixed amount of data in each iteration of run(). The driver program
+//!  calibrates the number of iterations, repeats the measurement and
+//!  reports the results in JSON format.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsUString.h"
+#include "tsjsonObject.h"
+
+//!
+//! Micro-benchmarks namespace.
+//!
+namespace tsbench {
+    //!
+    //! Base class for all benchmarks.
+    //!
+    class Benchmark
+    {
+        TS_NOBUILD_NOCOPY(Benchmark);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] name Benchmark name, typically "Class::operation".
+        //! @param [in] unit Name of the processing unit, typically "packets" or "bytes".
+        //! @param [in] unit_size Size in bytes of a processing unit. Zero when meaningless.
+        //!
+        Benchmark(const ts::UString& name, const ts::UString& unit, size_t unit_size = 0);
+
+        //!
+        //! Virtual destructor.
+        //!
+        virtual ~Benchmark();
+
+        //!
+        //! Get the benchmark name.
+        //! @return The benchmark name.
+        //!
+        const ts::UString& name() const { return _name; }
+
+        //!
+        //! Get the name of the processing unit.
+        //! @return The name of the processing unit.
+        //!
+        const ts::UString& unit() const { return _unit; }
+
+        //!
+        //! Get the size in bytes of a processing unit.
+        //! @return The size in bytes of a processing unit or zero when meaningless.
+        //!
+        size_t unitSize() const { return _unit_size; }
+
+        //!
+        //! Prepare the benchmark. Invoked once, before all measurements.
+        //! @return True on success, false to skip the benchmark.
+        //!
+        virtual bool setup();
+
+        //!
+        //! Cleanup the benchmark. Invoked once, after all measurements.
+        //!
+        virtual void cleanup();
+
+        //!
+        //! Run one iteration of the benchmark.
+        //! @return Number of processed units.
+        //!
+        virtual uint64_t run() = 0;
+
+    protected:
+        //!
+        //! A value which is updated by benchmarks to prevent the compiler from optimizing out the measured code.
+        //!
+        static volatile uint64_t Sink;
+
+    private:
+        ts::UString _name;
+        ts::UString _unit;
+        size_t      _unit_size;
+    };
+
+    //!
+    //! Repository of all benchmarks.
+    //!
+    class Repository
+    {
+    public:
+        //!
+        //! Function profile which creates a benchmark.
+        //!
+        typedef Benchmark* (*Factory)();
+
+        //!
+        //! Register a benchmark factory.
+        //! @param [in] factory Benchmark factory.
+        //!
+        static void Add(Factory factory);
+
+        //!
+        //! Get the list of all registered benchmark factories.
+        //! @return A constant reference to the list of all registered benchmark factories.
+        //!
+        static const std::list<Factory>& Factories();
+
+        //!
+        //! A class to register benchmarks using static instances.
+        //!
+        class Register
+        {
+            TS_NOBUILD_NOCOPY(Register);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] factory Benchmark factory.
+            //!
+            Register(Factory factory) { Add(factory); }
+        };
+
+    private:
+        static std::list<Factory>& List();
+    };
+
+    //!
+    //! Measure a benchmark.
+    //! @param [in,out] bench The benchmark to run. Must have been successfully set up.
+    //! @param [in] duration Target duration in milliseconds of all measurements.
+    //! @param [in] repetitions Number of repeated measurements.
+    //! @return A JSON object describing the results.
+    //!
+    ts::json::ValuePtr Measure(Benchmark& bench, ts::MilliSecond duration, size_t repetitions);
+}
+
+//!
+//! Register a benchmark class.
+//! @hideinitializer
+//! @param classname Fully qualified class name. The class must have a default constructor.
+//!
+#define TSBENCH_REGISTER(classname) \
+    static const tsbench::Repository::Register TS_UNIQUE_NAME(_Registrar)([]() -> tsbench::Benchmark* { return new classname; })
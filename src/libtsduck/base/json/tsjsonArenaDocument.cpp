@@ -0,0 +1,766 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "tsjsonArenaDocument.h"
+#include "tsjsonNull.h"
+#include "tsjsonTrue.h"
+#include "tsjsonFalse.h"
+#include "tsjsonNumber.h"
+#include "tsjsonString.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::json::ArenaDocument::ArenaDocument(Report& report) :
+    _report(report),
+    _nodes(),
+    _children(),
+    _stack(),
+    _strings(),
+    _cur(nullptr),
+    _end(nullptr),
+    _line(0)
+{
+}
+
+ts::json::ArenaDocument::Node::Node(const ArenaDocument* doc, Type type) :
+    Value(),
+    _doc(doc),
+    _type(type),
+    _number(0),
+    _start(0),
+    _size(0),
+    _keyStart(0),
+    _keySize(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the content of the document.
+//----------------------------------------------------------------------------
+
+void ts::json::ArenaDocument::clear()
+{
+    _nodes.clear();
+    _children.clear();
+    _stack.clear();
+    _strings.clear();
+    _cur = _end = nullptr;
+    _line = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the root value of the document.
+//----------------------------------------------------------------------------
+
+const ts::json::Value& ts::json::ArenaDocument::root() const
+{
+    if (_nodes.empty()) {
+        return NullValue;
+    }
+    else {
+        return _nodes.front();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Load a JSON text.
+//----------------------------------------------------------------------------
+
+bool ts::json::ArenaDocument::parse(const UString& text)
+{
+    return parse(text.toUTF8());
+}
+
+bool ts::json::ArenaDocument::load(const UString& fileName)
+{
+    if (fileName.empty() || fileName == u"-") {
+        return load(std::cin);
+    }
+    else if (IsInlineJSON(fileName)) {
+        return parse(fileName);
+    }
+    else {
+        std::ifstream strm(fileName.toUTF8().c_str(), std::ios::in | std::ios::binary);
+        if (!strm) {
+            _report.error(u"error reading file %s", {fileName});
+            return false;
+        }
+        return load(strm);
+    }
+}
+
+bool ts::json::ArenaDocument::load(std::istream& strm)
+{
+    // Read the complete text at once, without any conversion.
+    std::string text;
+    char buffer[16 * 1024];
+    while (strm.read(buffer, sizeof(buffer)) || strm.gcount() > 0) {
+        text.append(buffer, size_t(strm.gcount()));
+    }
+    if (strm.bad()) {
+        _report.error(u"error reading input JSON document");
+        return false;
+    }
+
+    // Skip the optional UTF-8 BOM.
+    size_t start = 0;
+    if (text.size() >= UString::UTF8_BOM_SIZE && text.compare(0, UString::UTF8_BOM_SIZE, UString::UTF8_BOM, UString::UTF8_BOM_SIZE) == 0) {
+        start = UString::UTF8_BOM_SIZE;
+    }
+    return parse(text.data() + start, text.size() - start);
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a JSON text.
+//----------------------------------------------------------------------------
+
+bool ts::json::ArenaDocument::parse(const char* data, size_t size)
+{
+    clear();
+    _cur = data;
+    _end = data + size;
+    _line = 1;
+
+    // Nothing is allowed after the JSON value, except spaces.
+    uint32_t index = 0;
+    bool ok = parseValue(index);
+    if (ok) {
+        skipSpaces();
+        if (_cur < _end) {
+            _report.error(u"line %d: extraneous text after JSON value", {_line});
+            ok = false;
+        }
+    }
+
+    // Release the parsing state, keep only a consistent document.
+    _cur = _end = nullptr;
+    _stack.clear();
+    if (!ok) {
+        clear();
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Parsing helpers.
+//----------------------------------------------------------------------------
+
+void ts::json::ArenaDocument::skipSpaces()
+{
+    while (_cur < _end && (*_cur == ' ' || *_cur == '\t' || *_cur == '\n' || *_cur == '\r')) {
+        if (*_cur++ == '\n') {
+            _line++;
+        }
+    }
+}
+
+bool ts::json::ArenaDocument::match(const char* literal)
+{
+    const char* p = _cur;
+    while (*literal != '\0' && p < _end && *p == *literal) {
+        ++p;
+        ++literal;
+    }
+    if (*literal == '\0') {
+        _cur = p;
+        return true;
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a JSON value, leading spaces are ignored.
+//----------------------------------------------------------------------------
+
+bool ts::json::ArenaDocument::parseValue(uint32_t& index)
+{
+    skipSpaces();
+
+    // Allocate the new value, its type is updated later.
+    index = uint32_t(_nodes.size());
+    _nodes.push_back(Node(this, Type::Null));
+
+    if (_cur >= _end) {
+        _report.error(u"line %d: not a valid JSON value", {_line});
+        return false;
+    }
+    else if (match("null")) {
+        return true;
+    }
+    else if (match("true")) {
+        _nodes[index]._type = Type::True;
+        return true;
+    }
+    else if (match("false")) {
+        _nodes[index]._type = Type::False;
+        return true;
+    }
+    else if (*_cur == '"') {
+        uint32_t start = 0;
+        uint32_t size = 0;
+        if (!parseString(start, size)) {
+            return false;
+        }
+        Node& node(_nodes[index]);
+        node._type = Type::String;
+        node._start = start;
+        node._size = size;
+        return true;
+    }
+    else if (*_cur == '-' || (*_cur >= '0' && *_cur <= '9')) {
+        return parseNumber(index);
+    }
+    else if (*_cur == '{') {
+        _nodes[index]._type = Type::Object;
+        ++_cur;
+        return parseContainer(index, '}');
+    }
+    else if (*_cur == '[') {
+        _nodes[index]._type = Type::Array;
+        ++_cur;
+        return parseContainer(index, ']');
+    }
+    else {
+        _report.error(u"line %d: not a valid JSON value", {_line});
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parse the content of an object or array, after the opening character.
+//----------------------------------------------------------------------------
+
+bool ts::json::ArenaDocument::parseContainer(uint32_t index, char close)
+{
+    const bool is_object = close == '}';
+    const UChar* const what = is_object ? u"object" : u"array";
+
+    // The children of this container are accumulated on top of the stack.
+    const size_t base = _stack.size();
+
+    skipSpaces();
+    if (_cur < _end && *_cur == close) {
+        ++_cur;
+    }
+    else {
+        for (;;) {
+            // Field name, in objects only.
+            uint32_t key_start = 0;
+            uint32_t key_size = 0;
+            if (is_object) {
+                skipSpaces();
+                if (_cur >= _end || *_cur != '"' || !parseString(key_start, key_size)) {
+                    _report.error(u"line %d: syntax error in JSON object, field name expected", {_line});
+                    return false;
+                }
+                skipSpaces();
+                if (_cur >= _end || *_cur++ != ':') {
+                    _report.error(u"line %d: syntax error in JSON object, missing ':'", {_line});
+                    return false;
+                }
+            }
+
+            // Field or element value.
+            uint32_t child = 0;
+            if (!parseValue(child)) {
+                return false;
+            }
+            _nodes[child]._keyStart = key_start;
+            _nodes[child]._keySize = key_size;
+            _stack.push_back(child);
+
+            // Expect a comma or the end of container.
+            skipSpaces();
+            if (_cur < _end && *_cur == close) {
+                ++_cur;
+                break;
+            }
+            else if (_cur >= _end || *_cur++ != ',') {
+                _report.error(u"line %d: syntax error in JSON %s, missing ','", {_line, what});
+                return false;
+            }
+        }
+    }
+
+    // Move the children of this container at the end of the list of children.
+    Node& node(_nodes[index]);
+    node._start = uint32_t(_children.size());
+    node._size = uint32_t(_stack.size() - base);
+    _children.insert(_children.end(), _stack.begin() + base, _stack.end());
+    _stack.resize(base);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a string literal into the string pool.
+//----------------------------------------------------------------------------
+
+bool ts::json::ArenaDocument::parseString(uint32_t& start, uint32_t& size)
+{
+    assert(_cur < _end && *_cur == '"');
+    ++_cur;
+    const size_t initial = _strings.size();
+
+    while (_cur < _end && *_cur != '"') {
+        if (*_cur == '\\') {
+            // Escaped character.
+            if (++_cur >= _end) {
+                break;
+            }
+            UChar c = CHAR_NULL;
+            switch (*_cur++) {
+                case '"': c = u'"'; break;
+                case '\\': c = u'\\'; break;
+                case '/': c = u'/'; break;
+                case 'b': c = u'\b'; break;
+                case 'f': c = u'\f'; break;
+                case 'n': c = u'\n'; break;
+                case 'r': c = u'\r'; break;
+                case 't': c = u'\t'; break;
+                case 'u': {
+                    // Surrogate pairs are made of two consecutive escaped UTF-16 values.
+                    for (int i = 0; i < 4; ++i) {
+                        int digit = 0;
+                        if (_cur >= _end || (digit = ToDigit(UChar(*_cur), 16)) < 0) {
+                            _report.error(u"line %d: invalid unicode sequence in JSON string", {_line});
+                            return false;
+                        }
+                        c = UChar((c << 4) | digit);
+                        ++_cur;
+                    }
+                    break;
+                }
+                default: {
+                    _report.error(u"line %d: invalid escape sequence in JSON string", {_line});
+                    return false;
+                }
+            }
+            _strings.push_back(c);
+        }
+        else {
+            // Convert a sequence of plain UTF-8 characters.
+            const char* last = _cur;
+            while (last < _end && *last != '"' && *last != '\\') {
+                if (*last++ == '\n') {
+                    _line++;
+                }
+            }
+            const size_t previous = _strings.size();
+            _strings.resize(previous + size_t(last - _cur));
+            UChar* out = &_strings[previous];
+            UString::ConvertUTF8ToUTF16(_cur, last, out, out + (last - _cur));
+            _strings.resize(size_t(out - _strings.data()));
+            _cur = last;
+        }
+    }
+
+    if (_cur >= _end) {
+        _report.error(u"line %d: unterminated JSON string", {_line});
+        return false;
+    }
+    ++_cur; // closing quote
+    start = uint32_t(initial);
+    size = uint32_t(_strings.size() - initial);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a number.
+//----------------------------------------------------------------------------
+
+bool ts::json::ArenaDocument::parseNumber(uint32_t index)
+{
+    const bool negative = *_cur == '-';
+    if (negative) {
+        ++_cur;
+    }
+    if (_cur >= _end || *_cur < '0' || *_cur > '9') {
+        _report.error(u"line %d: not a valid JSON value", {_line});
+        return false;
+    }
+
+    // Integer part, accumulated as negative value to accept the most negative value.
+    int64_t value = 0;
+    bool overflow = false;
+    while (_cur < _end && *_cur >= '0' && *_cur <= '9') {
+        const int digit = *_cur++ - '0';
+        overflow = overflow || value < (std::numeric_limits<int64_t>::min() + digit) / 10;
+        value = overflow ? 0 : 10 * value - digit;
+    }
+    overflow = overflow || (!negative && value == std::numeric_limits<int64_t>::min());
+
+    // Optional fraction and exponent.
+    bool floating = false;
+    if (_cur < _end && *_cur == '.') {
+        floating = true;
+        ++_cur;
+        while (_cur < _end && *_cur >= '0' && *_cur <= '9') {
+            ++_cur;
+        }
+    }
+    if (_cur < _end && (*_cur == 'e' || *_cur == 'E')) {
+        floating = true;
+        if (++_cur < _end && (*_cur == '+' || *_cur == '-')) {
+            ++_cur;
+        }
+        while (_cur < _end && *_cur >= '0' && *_cur <= '9') {
+            ++_cur;
+        }
+    }
+
+    if (floating || overflow) {
+        // Same behavior as ts::json::Parse().
+        _report.error(u"line %d: JSON floating-point numbers not yet supported, using \"null\" instead", {_line});
+    }
+    else {
+        Node& node(_nodes[index]);
+        node._type = Type::Number;
+        node._number = negative ? value : -value;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Build a classical copy of the tree.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::json::ArenaDocument::toValue() const
+{
+    return _nodes.empty() ? ValuePtr() : toValue(_nodes.front());
+}
+
+ts::json::ValuePtr ts::json::ArenaDocument::toValue(const Node& node) const
+{
+    switch (node._type) {
+        case Type::True:
+            return ValuePtr(new True);
+        case Type::False:
+            return ValuePtr(new False);
+        case Type::Number:
+            return ValuePtr(new Number(node._number));
+        case Type::String:
+            return ValuePtr(new String(node.string()));
+        case Type::Object: {
+            ValuePtr obj(new Object);
+            for (uint32_t i = 0; i < node._size; ++i) {
+                const Node& field(node.child(i));
+                obj->add(field.key(), toValue(field));
+            }
+            return obj;
+        }
+        case Type::Array: {
+            ValuePtr arr(new Array);
+            for (uint32_t i = 0; i < node._size; ++i) {
+                arr->set(toValue(node.child(i)));
+            }
+            return arr;
+        }
+        case Type::Null:
+        default:
+            return ValuePtr(new Null);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Node helpers.
+//----------------------------------------------------------------------------
+
+const ts::json::ArenaDocument::Node& ts::json::ArenaDocument::Node::child(size_t index) const
+{
+    return _doc->_nodes[_doc->_children[_start + index]];
+}
+
+bool ts::json::ArenaDocument::Node::hasKey(const UString& name) const
+{
+    return _keySize == name.size() && _doc->_strings.compare(_keyStart, _keySize, name) == 0;
+}
+
+ts::UString ts::json::ArenaDocument::Node::key() const
+{
+    return _doc->_strings.substr(_keyStart, _keySize);
+}
+
+ts::UString ts::json::ArenaDocument::Node::string() const
+{
+    return _type == Type::String ? _doc->_strings.substr(_start, _size) : UString();
+}
+
+void ts::json::ArenaDocument::Node::sortedFields(std::vector<uint32_t>& fields) const
+{
+    fields.clear();
+    if (_type == Type::Object) {
+        // Sort the children by name, keeping the order of duplicate names.
+        const UString& pool(_doc->_strings);
+        fields.assign(_doc->_children.begin() + _start, _doc->_children.begin() + _start + _size);
+        std::stable_sort(fields.begin(), fields.end(), [this, &pool](uint32_t a, uint32_t b) {
+            const Node& na(_doc->_nodes[a]);
+            const Node& nb(_doc->_nodes[b]);
+            return pool.compare(na._keyStart, na._keySize, pool, nb._keyStart, nb._keySize) < 0;
+        });
+        // Keep only the last of duplicate names.
+        size_t count = 0;
+        for (size_t i = 0; i < fields.size(); ++i) {
+            if (i + 1 < fields.size()) {
+                const Node& n1(_doc->_nodes[fields[i]]);
+                const Node& n2(_doc->_nodes[fields[i + 1]]);
+                if (pool.compare(n1._keyStart, n1._keySize, pool, n2._keyStart, n2._keySize) == 0) {
+                    continue;
+                }
+            }
+            fields[count++] = fields[i];
+        }
+        fields.resize(count);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Node implementation of ts::json::Value.
+//----------------------------------------------------------------------------
+
+ts::json::Type ts::json::ArenaDocument::Node::type() const
+{
+    return _type;
+}
+
+bool ts::json::ArenaDocument::Node::isNull()   const { return _type == Type::Null; }
+bool ts::json::ArenaDocument::Node::isTrue()   const { return _type == Type::True; }
+bool ts::json::ArenaDocument::Node::isFalse()  const { return _type == Type::False; }
+bool ts::json::ArenaDocument::Node::isNumber() const { return _type == Type::Number; }
+bool ts::json::ArenaDocument::Node::isString() const { return _type == Type::String; }
+bool ts::json::ArenaDocument::Node::isObject() const { return _type == Type::Object; }
+bool ts::json::ArenaDocument::Node::isArray()  const { return _type == Type::Array; }
+
+bool ts::json::ArenaDocument::Node::toBoolean(bool defaultValue) const
+{
+    switch (_type) {
+        case Type::True: return true;
+        case Type::False: return false;
+        case Type::Number: return Number(_number).toBoolean(defaultValue);
+        case Type::String: return String(string()).toBoolean(defaultValue);
+        case Type::Null:
+        case Type::Object:
+        case Type::Array:
+        default: return defaultValue;
+    }
+}
+
+int64_t ts::json::ArenaDocument::Node::toInteger(int64_t defaultValue) const
+{
+    switch (_type) {
+        case Type::True: return 1;
+        case Type::False: return 0;
+        case Type::Number: return _number;
+        case Type::String: return String(string()).toInteger(defaultValue);
+        case Type::Null:
+        case Type::Object:
+        case Type::Array:
+        default: return defaultValue;
+    }
+}
+
+ts::UString ts::json::ArenaDocument::Node::toString(const UString& defaultValue) const
+{
+    switch (_type) {
+        case Type::True: return u"true";
+        case Type::False: return u"false";
+        case Type::Number: return UString::Decimal(_number, 0, true, UString());
+        case Type::String: return string();
+        case Type::Null:
+        case Type::Object:
+        case Type::Array:
+        default: return defaultValue;
+    }
+}
+
+size_t ts::json::ArenaDocument::Node::size() const
+{
+    switch (_type) {
+        case Type::String:
+        case Type::Array:
+            return _size;
+        case Type::Object: {
+            std::vector<uint32_t> fields;
+            sortedFields(fields);
+            return fields.size();
+        }
+        case Type::Null:
+        case Type::True:
+        case Type::False:
+        case Type::Number:
+        default:
+            return 0;
+    }
+}
+
+void ts::json::ArenaDocument::Node::getNames(UStringList& names) const
+{
+    names.clear();
+    std::vector<uint32_t> fields;
+    sortedFields(fields);
+    for (auto it = fields.begin(); it != fields.end(); ++it) {
+        names.push_back(_doc->_nodes[*it].key());
+    }
+}
+
+const ts::json::Value& ts::json::ArenaDocument::Node::value(const UString& name) const
+{
+    // Search from the end, the last duplicate field is used.
+    if (_type == Type::Object) {
+        for (size_t i = _size; i > 0; --i) {
+            const Node& field(child(i - 1));
+            if (field.hasKey(name)) {
+                return field;
+            }
+        }
+    }
+    return NullValue;
+}
+
+ts::json::Value& ts::json::ArenaDocument::Node::value(const UString& name, bool create, Type type)
+{
+    // The document is read-only, values are never created.
+    return const_cast<Value&>(static_cast<const Node*>(this)->value(name));
+}
+
+const ts::json::Value& ts::json::ArenaDocument::Node::at(size_t index) const
+{
+    if (_type == Type::Array && index < _size) {
+        return child(index);
+    }
+    else {
+        return NullValue;
+    }
+}
+
+ts::json::Value& ts::json::ArenaDocument::Node::at(size_t index)
+{
+    return const_cast<Value&>(static_cast<const Node*>(this)->at(index));
+}
+
+const ts::json::Value& ts::json::ArenaDocument::Node::query(const UString& path) const
+{
+    if (path.empty()) {
+        return *this;
+    }
+    else if (_type == Type::Object) {
+        // Same path syntax as ts::json::Object.
+        UString field, next;
+        return Object::splitPath(path, field, next) ? value(field).query(next) : NullValue;
+    }
+    else if (_type == Type::Array) {
+        // Same path syntax as ts::json::Array.
+        size_t index = 0;
+        UString next;
+        return Array::splitPath(path, index, next) ? at(index).query(next) : NullValue;
+    }
+    else {
+        return NullValue;
+    }
+}
+
+ts::json::Value& ts::json::ArenaDocument::Node::query(const UString& path, bool create, Type type)
+{
+    return const_cast<Value&>(static_cast<const Node*>(this)->query(path));
+}
+
+
+//----------------------------------------------------------------------------
+// Format the value as JSON text, same format as the classical tree.
+//----------------------------------------------------------------------------
+
+void ts::json::ArenaDocument::Node::print(TextFormatter& output) const
+{
+    switch (_type) {
+        case Type::True: {
+            output << "true";
+            break;
+        }
+        case Type::False: {
+            output << "false";
+            break;
+        }
+        case Type::Number: {
+            output << UString::Decimal(_number, 0, true, UString());
+            break;
+        }
+        case Type::String: {
+            output << '"' << string().toJSON() << '"';
+            break;
+        }
+        case Type::Object: {
+            std::vector<uint32_t> fields;
+            sortedFields(fields);
+            output << "{" << ts::indent;
+            for (size_t i = 0; i < fields.size(); ++i) {
+                const Node& field(_doc->_nodes[fields[i]]);
+                if (i > 0) {
+                    output << ",";
+                }
+                output << ts::endl << ts::margin << '"' << field.key().toJSON() << "\": ";
+                field.print(output);
+            }
+            output << ts::endl << ts::unindent << ts::margin << "}";
+            break;
+        }
+        case Type::Array: {
+            output << "[" << ts::indent;
+            for (size_t i = 0; i < _size; ++i) {
+                if (i > 0) {
+                    output << ",";
+                }
+                output << ts::endl << ts::margin;
+                child(i).print(output);
+            }
+            output << ts::endl << ts::unindent << ts::margin << "]";
+            break;
+        }
+        case Type::Null:
+        default: {
+            output << "null";
+            break;
+        }
+    }
+}
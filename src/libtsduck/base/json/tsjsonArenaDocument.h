@@ -0,0 +1,205 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only JSON document, parsed into a contiguous memory arena.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsjsonValue.h"
+
+namespace ts {
+    namespace json {
+        //!
+        //! Read-only JSON document, parsed into a contiguous memory arena.
+        //! @ingroup json
+        //!
+        //! The classical way to parse a JSON text, using ts::json::Parse(), builds a tree
+        //! of individually allocated values. Object fields are stored in maps which are
+        //! indexed by strings. This is convenient to build or modify a JSON tree but parsing
+        //! large JSON texts or many small JSON texts is expensive.
+        //!
+        //! An ArenaDocument parses the UTF-8 text directly into a few contiguous vectors:
+        //! one vector of compact values, one vector of child indexes and one string pool.
+        //! There is no per-value allocation. The parsed values implement the read-only part
+        //! of the ts::json::Value interface, including query(), and can be used wherever a
+        //! constant reference to a ts::json::Value is expected. The values cannot be modified.
+        //! Use toValue() to get a classical modifiable copy of the tree.
+        //!
+        //! The values are valid until the document is cleared, reparsed or destroyed.
+        //! Objects are printed with fields in alphabetical order, as with ts::json::Object.
+        //! When an object contains duplicate field names, the last one is used.
+        //!
+        class TSDUCKDLL ArenaDocument
+        {
+            TS_NOCOPY(ArenaDocument);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors.
+            //!
+            explicit ArenaDocument(Report& report = NULLREP);
+
+            //!
+            //! Clear the content of the document.
+            //! All references to previous values become invalid.
+            //!
+            void clear();
+
+            //!
+            //! Parse a JSON text.
+            //! @param [in] data Address of the JSON text in UTF-8 format.
+            //! @param [in] size Size in bytes of the JSON text.
+            //! @return True on success, false on error.
+            //!
+            bool parse(const char* data, size_t size);
+
+            //!
+            //! Parse a JSON text.
+            //! @param [in] text The JSON text in UTF-8 format.
+            //! @return True on success, false on error.
+            //!
+            bool parse(const std::string& text) { return parse(text.data(), text.size()); }
+
+            //!
+            //! Parse a JSON text.
+            //! @param [in] text The JSON text.
+            //! @return True on success, false on error.
+            //!
+            bool parse(const UString& text);
+
+            //!
+            //! Load a JSON text file.
+            //! @param [in] fileName The name of the JSON file. If empty or "-", the standard input is used.
+            //! If @a fileName starts with "{" or "[", this is considered as "inline JSON content".
+            //! @return True on success, false on error.
+            //!
+            bool load(const UString& fileName);
+
+            //!
+            //! Load a JSON text from an open text stream.
+            //! @param [in,out] strm A standard text stream in input mode.
+            //! @return True on success, false on error.
+            //!
+            bool load(std::istream& strm);
+
+            //!
+            //! Get the root value of the document.
+            //! @return A constant reference to the root value or to a JSON null value if the document is empty.
+            //!
+            const Value& root() const;
+
+            //!
+            //! Build a classical modifiable copy of the document.
+            //! @return A safe pointer to a deep copy of the root value, a null pointer if the document is empty.
+            //!
+            ValuePtr toValue() const;
+
+            //!
+            //! Get the number of JSON values in the document.
+            //! @return The number of JSON values in the document, at all levels.
+            //!
+            size_t valueCount() const { return _nodes.size(); }
+
+        private:
+            // Description of a value in the arena. All references are indexes in the document.
+            class Node: public Value
+            {
+            public:
+                Node(const ArenaDocument* doc, Type type);
+                Node(const Node&) = default;
+                Node& operator=(const Node&) = default;
+
+                const ArenaDocument* _doc;       // Parent document.
+                Type                 _type;      // Value type.
+                int64_t              _number;    // Value of a number.
+                uint32_t             _start;     // String: index in _strings. Object, Array: index in _children.
+                uint32_t             _size;      // String: length. Object, Array: number of children.
+                uint32_t             _keyStart;  // Name of the field in parent object: index in _strings.
+                uint32_t             _keySize;   // Name of the field in parent object: length.
+
+                // Get the n-th child of an object or array.
+                const Node& child(size_t index) const;
+
+                // Check if the key in parent object is a given string.
+                bool hasKey(const UString& name) const;
+
+                // Get the key in parent object or the string value.
+                UString key() const;
+                UString string() const;
+
+                // Get the index of the children of an object, sorted by name, without duplicates.
+                void sortedFields(std::vector<uint32_t>& fields) const;
+
+                // Implementation of ts::json::Value.
+                virtual Type type() const override;
+                virtual bool isNull() const override;
+                virtual bool isTrue() const override;
+                virtual bool isFalse() const override;
+                virtual bool isNumber() const override;
+                virtual bool isString() const override;
+                virtual bool isObject() const override;
+                virtual bool isArray() const override;
+                virtual bool toBoolean(bool defaultValue = false) const override;
+                virtual int64_t toInteger(int64_t defaultValue = 0) const override;
+                virtual UString toString(const UString& defaultValue = UString()) const override;
+                virtual void print(TextFormatter& output) const override;
+                virtual size_t size() const override;
+                virtual void getNames(UStringList& names) const override;
+                virtual const Value& value(const UString& name) const override;
+                virtual Value& value(const UString& name, bool create = false, Type type = Type::Object) override;
+                virtual const Value& at(size_t index) const override;
+                virtual Value& at(size_t index) override;
+                virtual const Value& query(const UString& path) const override;
+                virtual Value& query(const UString& path, bool create = false, Type type = Type::Object) override;
+            };
+
+            Report&               _report;    // Where to report errors.
+            std::vector<Node>     _nodes;     // All values, root first.
+            std::vector<uint32_t> _children;  // Children of objects and arrays, contiguous per parent.
+            std::vector<uint32_t> _stack;     // Children of objects and arrays being parsed.
+            UString               _strings;   // Pool of all strings and field names.
+            const char*           _cur;       // Current parsing position.
+            const char*           _end;       // End of parsed text.
+            size_t                _line;      // Current line number.
+
+            // Parsing methods.
+            bool parseValue(uint32_t& index);
+            bool parseContainer(uint32_t index, char close);
+            bool parseString(uint32_t& start, uint32_t& size);
+            bool parseNumber(uint32_t index);
+            bool match(const char* literal);
+            void skipSpaces();
+
+            // Build a classical copy of a value.
+            ValuePtr toValue(const Node& node) const;
+        };
+    }
+}
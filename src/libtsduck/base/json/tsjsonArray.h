@@ -68,7 +68,8 @@ namespace ts {
         private:
             std::vector<ValuePtr> _value;
 
-            // Split and validate a query path.
+            // Split and validate a query path (also used by ArenaDocument).
+            friend class ArenaDocument;
             static bool splitPath(const UString& path, size_t& index, UString& next);
         };
     }
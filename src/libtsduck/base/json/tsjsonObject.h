@@ -70,7 +70,8 @@ namespace ts {
         private:
             std::map<UString, ValuePtr> _fields;
 
-            // Split and validate a query path.
+            // Split and validate a query path (also used by ArenaDocument).
+            friend class ArenaDocument;
             static bool splitPath(const UString& path, UString& field, UString& next);
         };
     }
@@ -141,16 +141,30 @@ bool ts::json::RunningDocument::open(const ValuePtr& root, const UString& fileNa
 
 void ts::json::RunningDocument::add(const Value& value)
 {
-    // Add object only if the array is already open and the provided object is not null.
-    if (_open_array) {
-        if (!_empty_array) {
-            // There are already some elements in the array.
-            _text << ",";
-        }
-        _text << ts::endl << ts::margin;
-        value.print(_text);
-        _empty_array = false;
+    TextFormatter* text = startValue();
+    if (text != nullptr) {
+        value.print(*text);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Start a new value in the open array of the running document.
+//----------------------------------------------------------------------------
+
+ts::TextFormatter* ts::json::RunningDocument::startValue()
+{
+    // Add value only if the array is already open.
+    if (!_open_array) {
+        return nullptr;
+    }
+    if (!_empty_array) {
+        // There are already some elements in the array.
+        _text << ",";
     }
+    _text << ts::endl << ts::margin;
+    _empty_array = false;
+    return &_text;
 }
 
 
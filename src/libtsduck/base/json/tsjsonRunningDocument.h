@@ -86,6 +86,15 @@ namespace ts {
             //!
             void add(const Value& value);
 
+            //!
+            //! Start a new value in the open array of the running document.
+            //! This is an alternative to add() when the application directly prints the value,
+            //! without building a JSON tree. The separator and the margin are already printed.
+            //! The application shall print exactly one JSON value in the returned text formatter.
+            //! @return Address of the text formatter to use or a null pointer if the document is not open.
+            //!
+            TextFormatter* startValue();
+
             //!
             //! Close the running document.
             //! If the JSON structure is still open, it is closed.
@@ -0,0 +1,149 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "tsjsonStreamWriter.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::json::StreamWriter::StreamWriter(TextFormatter& output) :
+    _output(output),
+    _empty(),
+    _afterKey(false)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Print separators before a value.
+//----------------------------------------------------------------------------
+
+void ts::json::StreamWriter::startValue()
+{
+    if (_afterKey) {
+        // The field name is already printed, the value follows on the same line.
+        _afterKey = false;
+    }
+    else if (!_empty.empty()) {
+        // New element in an array.
+        if (!_empty.back()) {
+            _output << ",";
+        }
+        _output << ts::endl << ts::margin;
+        _empty.back() = false;
+    }
+}
+
+void ts::json::StreamWriter::key(const UString& name)
+{
+    if (!_empty.empty()) {
+        if (!_empty.back()) {
+            _output << ",";
+        }
+        _empty.back() = false;
+    }
+    _output << ts::endl << ts::margin << '"' << name.toJSON() << "\": ";
+    _afterKey = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Objects and arrays.
+//----------------------------------------------------------------------------
+
+void ts::json::StreamWriter::start(const char* open)
+{
+    startValue();
+    _output << open << ts::indent;
+    _empty.push_back(true);
+}
+
+void ts::json::StreamWriter::end(const char* close)
+{
+    assert(!_empty.empty());
+    _output << ts::endl << ts::unindent << ts::margin << close;
+    _empty.pop_back();
+}
+
+void ts::json::StreamWriter::startObject()
+{
+    start("{");
+}
+
+void ts::json::StreamWriter::endObject()
+{
+    end("}");
+}
+
+void ts::json::StreamWriter::startArray()
+{
+    start("[");
+}
+
+void ts::json::StreamWriter::endArray()
+{
+    end("]");
+}
+
+
+//----------------------------------------------------------------------------
+// Simple values.
+//----------------------------------------------------------------------------
+
+void ts::json::StreamWriter::null()
+{
+    startValue();
+    _output << "null";
+}
+
+void ts::json::StreamWriter::boolean(bool value)
+{
+    startValue();
+    _output << (value ? "true" : "false");
+}
+
+void ts::json::StreamWriter::number(int64_t value)
+{
+    startValue();
+    _output << UString::Decimal(value, 0, true, UString());
+}
+
+void ts::json::StreamWriter::string(const UString& value)
+{
+    startValue();
+    _output << '"' << value.toJSON() << '"';
+}
+
+void ts::json::StreamWriter::value(const Value& value)
+{
+    startValue();
+    value.print(_output);
+}
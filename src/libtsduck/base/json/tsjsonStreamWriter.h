@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Direct streaming writer of JSON text.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsjsonValue.h"
+
+namespace ts {
+    namespace json {
+        //!
+        //! Direct streaming writer of JSON text.
+        //! @ingroup json
+        //!
+        //! A StreamWriter prints a JSON structure in a text formatter while the application
+        //! walks through its own data, without building a JSON tree. The separators and the
+        //! indentation are managed by the writer. The output is identical to the output of
+        //! the print() method of an equivalent JSON tree, provided that the fields of the
+        //! objects are written in the same (alphabetical) order.
+        //!
+        //! Sample usage:
+        //! @code
+        //! ts::json::StreamWriter json(output);
+        //! json.startObject();
+        //! json.key(u"name");
+        //! json.string(u"foo");
+        //! json.key(u"values");
+        //! json.startArray();
+        //! json.number(1);
+        //! json.number(2);
+        //! json.endArray();
+        //! json.endObject();
+        //! @endcode
+        //!
+        //! The StreamWriter can also print the values of a ts::json::RunningDocument:
+        //! each value starts with a call to ts::json::RunningDocument::startValue()
+        //! which returns the text formatter to use.
+        //!
+        class TSDUCKDLL StreamWriter
+        {
+            TS_NOBUILD_NOCOPY(StreamWriter);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] output The text formatter where the JSON text is printed.
+            //! The referenced object must remain valid as long as this object.
+            //!
+            explicit StreamWriter(TextFormatter& output);
+
+            //!
+            //! Get the associated text formatter.
+            //! @return A reference to the associated text formatter.
+            //!
+            TextFormatter& output() { return _output; }
+
+            //!
+            //! Get the current depth in the JSON structure.
+            //! @return The number of open objects and arrays.
+            //!
+            size_t depth() const { return _empty.size(); }
+
+            //!
+            //! Start a JSON object.
+            //! Inside an object, the name of the field shall be written first using key().
+            //!
+            void startObject();
+
+            //!
+            //! End the current JSON object.
+            //!
+            void endObject();
+
+            //!
+            //! Start a JSON array.
+            //! Inside an object, the name of the field shall be written first using key().
+            //!
+            void startArray();
+
+            //!
+            //! End the current JSON array.
+            //!
+            void endArray();
+
+            //!
+            //! Write the name of the next field in the current object.
+            //! It shall be followed by exactly one value.
+            //! @param [in] name Field name.
+            //!
+            void key(const UString& name);
+
+            //!
+            //! Write a null literal.
+            //!
+            void null();
+
+            //!
+            //! Write a true or false literal.
+            //! @param [in] value The boolean value to write.
+            //!
+            void boolean(bool value);
+
+            //!
+            //! Write an integer number.
+            //! @param [in] value The value to write.
+            //!
+            void number(int64_t value);
+
+            //!
+            //! Write a string.
+            //! @param [in] value The string to write. The JSON escape sequences are generated when necessary.
+            //!
+            void string(const UString& value);
+
+            //!
+            //! Write a complete JSON value from a JSON tree.
+            //! @param [in] value The JSON value to write.
+            //!
+            void value(const Value& value);
+
+        private:
+            TextFormatter&    _output;    // Where to print.
+            std::vector<bool> _empty;     // For each open object or array, true while it is empty.
+            bool              _afterKey;  // A field name was just written.
+
+            // Print separators before a value.
+            void startValue();
+
+            // Print the opening and closing sequences of objects and arrays.
+            void start(const char* open);
+            void end(const char* close);
+        };
+    }
+}
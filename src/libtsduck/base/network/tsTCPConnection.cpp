@@ -199,6 +199,61 @@ bool ts::TCPConnection::receive(void* data,             // Buffers address
 }
 
 
+//----------------------------------------------------------------------------
+// Receive the data which are immediately available, without waiting.
+//----------------------------------------------------------------------------
+
+bool ts::TCPConnection::receiveNoWait(void* data, size_t max_size, size_t& ret_size, Report& report)
+{
+#if defined(TS_WINDOWS)
+    const int flags = 0;
+#else
+    const int flags = MSG_DONTWAIT;
+#endif
+
+    // Clear returned values
+    ret_size = 0;
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+        SysSocketSignedSizeType got = ::recv(getSocket(), SysRecvBufferPointer(data), int(max_size), flags);
+        const SysSocketErrorCode err_code = LastSysSocketErrorCode();
+        if (got > 0) {
+            // Received some data
+            assert(size_t(got) <= max_size);
+            ret_size = size_t(got);
+            return true;
+        }
+        else if (got == 0 || err_code == SYS_SOCKET_ERR_RESET) {
+            // End of connection (graceful or aborted). Do not report an error.
+            declareDisconnected(report);
+            return false;
+        }
+#if defined(TS_WINDOWS)
+        else if (err_code == WSAEWOULDBLOCK) {
+            // No data available yet.
+            return true;
+        }
+#else
+        else if (err_code == EAGAIN || err_code == EWOULDBLOCK) {
+            // No data available yet.
+            return true;
+        }
+        else if (err_code == EINTR) {
+            // Ignore signal, retry
+            report.debug(u"recv() interrupted by signal, retrying");
+        }
+#endif
+        else {
+            Guard lock(_mutex);
+            if (isOpen()) {
+                report.error(u"error receiving data from socket: " + SysSocketErrorCodeMessage(err_code));
+            }
+            return false;
+        }
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Receive data until buffer is full.
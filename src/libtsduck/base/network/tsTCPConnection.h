@@ -186,6 +186,23 @@ namespace ts {
                      const AbortInterface* abort = nullptr,
                      Report& report = CERR);
 
+        //!
+        //! Receive the data which are immediately available, without waiting.
+        //!
+        //! This version of receive() is designed for event-driven applications
+        //! which monitor sockets using poll(), epoll() or similar mechanisms. When
+        //! no data is available, it returns successfully with @a ret_size set to zero.
+        //! On Windows, the socket must have been previously set in non-blocking mode.
+        //!
+        //! @param [out] buffer Address of the buffer for the received data.
+        //! @param [in] max_size Size in bytes of the reception buffer.
+        //! @param [out] ret_size Size in bytes of the received data, zero if no data
+        //! was available. Will never be larger than @a max_size.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success or when no data is available, false on error or disconnection.
+        //!
+        bool receiveNoWait(void* buffer, size_t max_size, size_t& ret_size, Report& report = CERR);
+
         //!
         //! Receive data until buffer is full.
         //!
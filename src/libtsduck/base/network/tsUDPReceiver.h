@@ -91,6 +91,12 @@ namespace ts {
                              const AbortInterface* abort = nullptr,
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr) override;
+        virtual bool receiveBatch(void* data,
+                                  size_t max_size,
+                                  size_t max_count,
+                                  ReceivedMessageVector& messages,
+                                  const AbortInterface* abort = nullptr,
+                                  Report& report = CERR) override;
 
     private:
         bool                    _with_short_options;
@@ -108,5 +114,8 @@ namespace ts {
         SocketAddress           _use_source;         // Filter on this socket address of sender (can be a simple filter of an SSM source).
         SocketAddress           _first_source;       // Socket address of first received packet.
         std::set<SocketAddress> _sources;            // Set of all detected packet sources.
+
+        // Check if a received message matches the filtering criteria.
+        bool acceptMessage(const SocketAddress& sender, const SocketAddress& destination, MicroSecond timestamp, Report& report);
     };
 }
@@ -52,6 +52,12 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     _default_destination(),
     _mcast(),
     _ssmcast()
+#if defined(TS_LINUX)
+    , _mmsg(),
+    _mmsg_iov(),
+    _mmsg_addr(),
+    _mmsg_control()
+#endif
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -232,11 +238,22 @@ bool ts::UDPSocket::setReceiveTimestamps(bool on, Report& report)
 {
     // The option exists only on Linux and is silently ignored on other systems.
 #if defined(TS_LINUX)
-    // Set SO_TIMESTAMPNS option which reports timestamps in nanoseconds (struct timespec).
-    int enable = int(on);
-    if (::setsockopt(getSocket(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) != 0) {
-        report.error(u"socket option SO_TIMESTAMPNS: " + SysSocketErrorCodeMessage());
-        return false;
+    // First, try SO_TIMESTAMPING which reports hardware timestamps from the NIC, when enabled
+    // on the interface, in addition to the software timestamps from the kernel.
+    int flags = on ? (SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE) : 0;
+    const bool timestamping = ::setsockopt(getSocket(), SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0;
+    if (timestamping) {
+        report.debug(u"socket option SO_TIMESTAMPING set to 0x%X", {flags});
+    }
+
+    // Otherwise, use SO_TIMESTAMPNS which reports software timestamps in nanoseconds (struct timespec).
+    // When disabling timestamps, always clear SO_TIMESTAMPNS too, whichever option was previously set.
+    if (!on || !timestamping) {
+        int enable = int(on);
+        if (::setsockopt(getSocket(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) != 0) {
+            report.error(u"socket option SO_TIMESTAMPNS: " + SysSocketErrorCodeMessage());
+            return false;
+        }
     }
 #endif
 
@@ -595,11 +612,35 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
         return LastSysSocketErrorCode();
     }
 
+    // Browse returned ancillary data.
+    // The returned timestamp is in system time, raw hardware timestamps are ignored.
+    NanoSecond nano = -1;
+    getAncillaryData(hdr, destination, timestamp == nullptr ? nullptr : &nano, nullptr);
+    if (timestamp != nullptr && nano >= 0) {
+        *timestamp = nano / NanoSecPerMicroSec;
+    }
+
+#endif // Windows vs. UNIX
+
+    // Successfully received a message
+    ret_size = size_t(insize);
+    sender = SocketAddress(sender_sock);
+
+    return SYS_SUCCESS;
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze the ancillary data of a received message.
+//----------------------------------------------------------------------------
+
+#if !defined(TS_WINDOWS)
+void ts::UDPSocket::getAncillaryData(::msghdr& hdr, SocketAddress& destination, NanoSecond* timestamp, bool* hw_timestamp)
+{
     // Because of invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
     TS_PUSH_WARNING()
     TS_GCC_NOWARNING(zero-as-null-pointer-constant)
 
-    // Browse returned ancillary data.
     for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
 
         // Look for destination IP address.
@@ -614,21 +655,227 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
             // System time stamp in nanosecond.
             const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
             const NanoSecond nano = NanoSecond(ts->tv_sec) * NanoSecPerSec + NanoSecond(ts->tv_nsec);
-            // System time stamp is valid when not zero, convert it to micro-seconds.
+            // System time stamp is valid when not zero.
             if (nano != 0) {
-                *timestamp = nano / NanoSecPerMicroSec;
+                *timestamp = nano;
+                if (hw_timestamp != nullptr) {
+                    *hw_timestamp = false;
+                }
+            }
+        }
+        else if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPING && cmsg->cmsg_len >= 3 * sizeof(::timespec)) {
+            // Three time stamps: software, deprecated, raw hardware. The raw hardware time stamp comes
+            // from the PTP hardware clock of the NIC, not the system time. Use it when requested and present.
+            const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
+            const NanoSecond hw_nano = NanoSecond(ts[2].tv_sec) * NanoSecPerSec + NanoSecond(ts[2].tv_nsec);
+            const NanoSecond sw_nano = NanoSecond(ts[0].tv_sec) * NanoSecPerSec + NanoSecond(ts[0].tv_nsec);
+            if (hw_timestamp != nullptr && hw_nano != 0) {
+                *timestamp = hw_nano;
+                *hw_timestamp = true;
+            }
+            else if (sw_nano != 0) {
+                *timestamp = sw_nano;
+                if (hw_timestamp != nullptr) {
+                    *hw_timestamp = false;
+                }
             }
         }
 #endif
     }
 
     TS_POP_WARNING()
+}
+#endif
 
-#endif // Windows vs. UNIX
 
-    // Successfully received a message
-    ret_size = size_t(insize);
-    sender = SocketAddress(sender_sock);
+//----------------------------------------------------------------------------
+// Receive several messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::receiveBatch(void* data,
+                                 size_t max_size,
+                                 size_t max_count,
+                                 ReceivedMessageVector& messages,
+                                 const AbortInterface* abort,
+                                 Report& report)
+{
+    messages.clear();
+    if (max_count == 0) {
+        report.error(u"no message buffer in UDP batch receive");
+        return false;
+    }
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+
+#if defined(TS_LINUX)
+        // Wait for one or more messages.
+        const SysSocketErrorCode err = receiveMany(data, max_size, max_count, messages);
+#else
+        // Receive one message only.
+        messages.resize(1);
+        ReceivedMessage& msg(messages[0]);
+        msg.index = 0;
+        MicroSecond micro = -1;
+        const SysSocketErrorCode err = receiveOne(data, max_size, msg.size, msg.sender, msg.destination, report, &micro);
+        msg.timestamp = micro < 0 ? -1 : micro * NanoSecPerMicroSec;
+        msg.hw_timestamp = false;
+#endif
+
+        if (abort != nullptr && abort->aborting()) {
+            // Aborting, no error message.
+            messages.clear();
+            return false;
+        }
+        else if (err == SYS_SUCCESS) {
+            // Sometimes, we get "successful" empty message coming from nowhere. Ignore them.
+            size_t count = 0;
+            for (size_t i = 0; i < messages.size(); ++i) {
+                if (messages[i].size > 0 || messages[i].sender.hasAddress()) {
+                    if (count < i) {
+                        messages[count] = messages[i];
+                    }
+                    count++;
+                }
+            }
+            messages.resize(count);
+            if (count > 0) {
+                return true;
+            }
+        }
+#if !defined(TS_WINDOWS)
+        else if (err == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+#endif
+        else {
+            // Abort on non-interrupt errors.
+            report.error(u"error receiving from UDP socket: %s", {SysSocketErrorCodeMessage(err)});
+            messages.clear();
+            return false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Send several messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendBatch(const void* const data[], const size_t sizes[], size_t count, Report& report)
+{
+    return sendBatch(data, sizes, count, _default_destination, report);
+}
+
+bool ts::UDPSocket::sendBatch(const void* const data[], const size_t sizes[], size_t count, const SocketAddress& dest, Report& report)
+{
+#if defined(TS_LINUX)
 
+    // All messages use the same destination.
+    ::sockaddr addr;
+    dest.copy(addr);
+    resizeBatch(count, 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        _mmsg_iov[i].iov_base = const_cast<void*>(data[i]);
+        _mmsg_iov[i].iov_len = sizes[i];
+        ::msghdr& hdr(_mmsg[i].msg_hdr);
+        hdr.msg_name = &addr;
+        hdr.msg_namelen = sizeof(addr);
+        hdr.msg_iov = &_mmsg_iov[i];
+        hdr.msg_iovlen = 1;
+    }
+
+    // sendmmsg() may send fewer messages than requested, loop until all are sent.
+    size_t sent = 0;
+    while (sent < count) {
+        const int ret = ::sendmmsg(getSocket(), &_mmsg[sent], static_cast<unsigned int>(count - sent), 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (ret <= 0) {
+            report.error(u"error sending UDP message: " + SysSocketErrorCodeMessage());
+            return false;
+        }
+        sent += size_t(ret);
+    }
+    return true;
+
+#else
+
+    // Send messages one by one.
+    for (size_t i = 0; i < count; ++i) {
+        if (!send(data[i], sizes[i], dest, report)) {
+            return false;
+        }
+    }
+    return true;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Linux-specific batch operations.
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+
+// Resize the work areas for a batch of messages.
+void ts::UDPSocket::resizeBatch(size_t count, size_t control_size)
+{
+    if (_mmsg.size() < count) {
+        _mmsg.resize(count);
+        _mmsg_iov.resize(count);
+        _mmsg_addr.resize(count);
+    }
+    if (_mmsg_control.size() < count * control_size) {
+        _mmsg_control.resize(count * control_size);
+    }
+    ::memset(_mmsg.data(), 0, count * sizeof(::mmsghdr));
+}
+
+// Perform one batch receive operation.
+ts::SysSocketErrorCode ts::UDPSocket::receiveMany(void* data, size_t max_size, size_t max_count, ReceivedMessageVector& messages)
+{
+    // Size of ancillary data per message, large enough for the options we set.
+    static constexpr size_t CONTROL_SIZE = 256;
+
+    messages.clear();
+    resizeBatch(max_count, CONTROL_SIZE);
+
+    uint8_t* const buffers = reinterpret_cast<uint8_t*>(data);
+    for (size_t i = 0; i < max_count; ++i) {
+        _mmsg_iov[i].iov_base = buffers + i * max_size;
+        _mmsg_iov[i].iov_len = max_size;
+        ::msghdr& hdr(_mmsg[i].msg_hdr);
+        hdr.msg_name = &_mmsg_addr[i];
+        hdr.msg_namelen = sizeof(::sockaddr);
+        hdr.msg_iov = &_mmsg_iov[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = _mmsg_control.data() + i * CONTROL_SIZE;
+        hdr.msg_controllen = CONTROL_SIZE;
+    }
+
+    // Wait for the first message, then get all others which are immediately available.
+    const int count = ::recvmmsg(getSocket(), _mmsg.data(), static_cast<unsigned int>(max_count), MSG_WAITFORONE, nullptr);
+    if (count < 0) {
+        return LastSysSocketErrorCode();
+    }
+
+    messages.resize(size_t(count));
+    for (size_t i = 0; i < messages.size(); ++i) {
+        ReceivedMessage& msg(messages[i]);
+        msg.index = i;
+        msg.size = _mmsg[i].msg_len;
+        msg.sender = SocketAddress(_mmsg_addr[i]);
+        msg.destination.clear();
+        msg.timestamp = -1;
+        msg.hw_timestamp = false;
+        getAncillaryData(_mmsg[i].msg_hdr, msg.destination, &msg.timestamp, &msg.hw_timestamp);
+    }
     return SYS_SUCCESS;
 }
+
+#endif
@@ -39,6 +39,7 @@
 #include "tsAbortInterface.h"
 #include "tsReport.h"
 #include "tsMemory.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -192,13 +193,18 @@ namespace ts {
         //! Enable or disable the generation of receive timestamps.
         //!
         //! When enabled, each received UDP packets comes with a time stamp (see receive()).
-        //! When possible, a hardware timestamp from the NIC is received. Otherwise, a software
-        //! timestamp is generated by the kernel.
+        //! The kernel generates a software timestamp in system time. With receiveBatch(), when
+        //! possible, a raw hardware timestamp from the PTP hardware clock of the NIC is returned
+        //! instead. This clock is not the system time.
         //!
-        //! When enabled, this option is a @æ request, not a requirement.
+        //! When enabled, this option is a @e request, not a requirement.
         //! Currently, this option is supported on Linux only. It is ignored on other systems.
+        //! On Linux, hardware timestamps are available only when the receive timestamping
+        //! was previously enabled on the network interface (this requires privileges).
+        //! Otherwise, the kernel software timestamps are used.
         //!
-        //! @param [in] on If true, receive timestamps are activated on the socket. Otherwise, they are disabled.
+        //! @param [in] on If true, receive timestamps are activated on the socket. Otherwise, all
+        //! forms of receive timestamps are disabled.
         //! @param [in,out] report Where to report error.
         //! @return True on success, false on error.
         //!
@@ -332,6 +338,87 @@ namespace ts {
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr);
 
+        //!
+        //! Description of one message in a batch receive operation.
+        //! @see receiveBatch()
+        //!
+        struct TSDUCKDLL ReceivedMessage
+        {
+            size_t        index;        //!< Index of the message buffer in the batch.
+            size_t        size;         //!< Size in bytes of the received message.
+            SocketAddress sender;       //!< Socket address of the sender.
+            SocketAddress destination;  //!< Socket address of the packet destination.
+            NanoSecond    timestamp;    //!< Receive timestamp in nano-seconds, negative if not available.
+            bool          hw_timestamp; //!< The receive timestamp is a raw time from the PTP hardware clock of the network interface, not the system time.
+
+            //!
+            //! Default constructor.
+            //!
+            ReceivedMessage() : index(0), size(0), sender(), destination(), timestamp(-1), hw_timestamp(false) {}
+        };
+
+        //!
+        //! Vector of received messages.
+        //!
+        typedef std::vector<ReceivedMessage> ReceivedMessageVector;
+
+        //!
+        //! Receive several messages with as few system calls as possible.
+        //!
+        //! The method waits for at least one message and then returns all messages which
+        //! are immediately available, up to @a max_count. On Linux, this is one single
+        //! call to @c recvmmsg(). On other systems, only one message is returned.
+        //!
+        //! @param [out] data Address of the buffer for the received messages. This buffer
+        //! is made of @a max_count consecutive message buffers of @a max_size bytes each.
+        //! The message which is described by @a messages[i] is stored at address
+        //! @a data + @a messages[i].index * @a max_size.
+        //! @param [in] max_size Size in bytes of each message buffer.
+        //! @param [in] max_count Maximum number of messages to receive.
+        //! @param [out] messages Description of the received messages.
+        //! On success, there is at least one message.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted
+        //! (in case of user-interrupt, return, otherwise retry).
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see setReceiveTimestamps()
+        //!
+        virtual bool receiveBatch(void* data,
+                                  size_t max_size,
+                                  size_t max_count,
+                                  ReceivedMessageVector& messages,
+                                  const AbortInterface* abort = nullptr,
+                                  Report& report = CERR);
+
+        //!
+        //! Send several messages to a destination address and port with as few system calls as possible.
+        //!
+        //! On Linux, the messages are sent using @c sendmmsg(). On other systems, the
+        //! messages are sent one by one.
+        //!
+        //! @param [in] data Array of @a count addresses of messages to send.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in] destination Socket address of the destination.
+        //! Both address and port are mandatory in the socket address, they cannot
+        //! be set to @link IPAddress::AnyAddress @endlink or
+        //! @link SocketAddress::AnyPort @endlink.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendBatch(const void* const data[], const size_t sizes[], size_t count, const SocketAddress& destination, Report& report = CERR);
+
+        //!
+        //! Send several messages to the default destination address and port with as few system calls as possible.
+        //!
+        //! @param [in] data Array of @a count addresses of messages to send.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendBatch(const void* const data[], const size_t sizes[], size_t count, Report& report = CERR);
+
         // Implementation of Socket interface.
         virtual bool open(Report& report = CERR) override;
         virtual bool close(Report& report = CERR) override;
@@ -395,6 +482,26 @@ namespace ts {
         // Perform one receive operation. Hide the system mud.
         SysSocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, Report& report, MicroSecond* timestamp);
 
+#if defined(TS_LINUX)
+        // Work areas for recvmmsg() and sendmmsg(), to avoid reallocation on each call.
+        std::vector<::mmsghdr>  _mmsg;
+        std::vector<::iovec>    _mmsg_iov;
+        std::vector<::sockaddr> _mmsg_addr;
+        ByteBlock               _mmsg_control;
+
+        // Resize the work areas for a batch of messages.
+        void resizeBatch(size_t count, size_t control_size);
+
+        // Perform one batch receive operation.
+        SysSocketErrorCode receiveMany(void* data, size_t max_size, size_t max_count, ReceivedMessageVector& messages);
+#endif
+
+#if !defined(TS_WINDOWS)
+        // Analyze the ancillary data of a received message.
+        // When hw_timestamp is null, only system time stamps are returned.
+        void getAncillaryData(::msghdr& hdr, SocketAddress& destination, NanoSecond* timestamp, bool* hw_timestamp);
+#endif
+
         // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
         static volatile ::LPFN_WSARECVMSG _wsaRevcMsg;
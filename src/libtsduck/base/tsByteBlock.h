@@ -35,6 +35,7 @@
 #pragma once
 #include "tsMemory.h"
 #include "tsSafePtr.h"
+#include "tsMemoryPool.h"
 
 namespace ts {
 
@@ -549,6 +550,21 @@ namespace ts {
         //!
         TSDUCKDLL std::ostream& write(std::ostream& strm) const;
 
+        //!
+        //! Allocation operator. ByteBlock objects are allocated in a MemoryPool.
+        //! The content of the byte block is allocated by @c std::vector as usual.
+        //! @param [in] size Size of the object.
+        //! @return Address of the allocated object.
+        //!
+        static void* operator new(size_t size) { return MemoryPool::Allocate(size); }
+
+        //!
+        //! Deallocation operator.
+        //! @param [in] ptr Address of the object.
+        //! @param [in] size Size of the object.
+        //!
+        static void operator delete(void* ptr, size_t size) { MemoryPool::Deallocate(ptr, size); }
+
     private:
         // Common code for saveToFile and appendToFile.
         bool writeToFile(const UString& fileName, std::ios::openmode mode, Report* report) const;
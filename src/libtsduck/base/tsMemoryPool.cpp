@@ -0,0 +1,347 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryPool.h"
+#include "tsSysUtils.h"
+#include "tsUString.h"
+#include "tsGuard.h"
+#include "tsMutex.h"
+#include <atomic>
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::MemoryPool::GRANULARITY;
+constexpr size_t ts::MemoryPool::SMALL_BLOCK_SIZE;
+constexpr size_t ts::MemoryPool::MAX_BLOCK_SIZE;
+constexpr size_t ts::MemoryPool::MAX_CACHED_BLOCKS;
+constexpr size_t ts::MemoryPool::MAX_CACHED_BYTES;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Internal structures of the memory pool.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Size classes of small blocks: class index i contains blocks of (i+1)*GRANULARITY bytes.
+    // The following classes contain blocks of 2*SMALL_BLOCK_SIZE, 4*SMALL_BLOCK_SIZE, etc.
+    constexpr size_t SMALL_CLASS_COUNT = ts::MemoryPool::SMALL_BLOCK_SIZE / ts::MemoryPool::GRANULARITY;
+    constexpr size_t CLASS_COUNT = SMALL_CLASS_COUNT + 4;
+    static_assert(ts::MemoryPool::SMALL_BLOCK_SIZE << (CLASS_COUNT - SMALL_CLASS_COUNT) == ts::MemoryPool::MAX_BLOCK_SIZE, "inconsistent size classes");
+
+    // Size class of a block.
+    inline size_t SizeClass(size_t size)
+    {
+        if (size <= ts::MemoryPool::SMALL_BLOCK_SIZE) {
+            return size == 0 ? 0 : (size - 1) / ts::MemoryPool::GRANULARITY;
+        }
+        size_t index = SMALL_CLASS_COUNT;
+        for (size_t csize = 2 * ts::MemoryPool::SMALL_BLOCK_SIZE; csize < size; csize *= 2) {
+            index++;
+        }
+        return index;
+    }
+
+    // Actual size of blocks in a size class.
+    inline size_t ClassSize(size_t index)
+    {
+        return index < SMALL_CLASS_COUNT ? (index + 1) * ts::MemoryPool::GRANULARITY : ts::MemoryPool::SMALL_BLOCK_SIZE << (index - SMALL_CLASS_COUNT + 1);
+    }
+
+    // Maximum number of cached blocks in a size class.
+    inline size_t ClassMaxCached(size_t index)
+    {
+        return std::min(size_t(ts::MemoryPool::MAX_CACHED_BLOCKS), size_t(ts::MemoryPool::MAX_CACHED_BYTES) / ClassSize(index));
+    }
+
+    // Check once if the pool is disabled by the environment.
+    bool PoolDisabled()
+    {
+        static const bool disabled = ts::EnvironmentExists(u"TSDUCK_NO_MEMORY_POOL");
+        return disabled;
+    }
+
+    // A free block in a cache contains the address of the next free block of the same size class.
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // Statistics counters of a thread. They are modified by the owner thread only
+    // but can be read by any thread, hence the relaxed atomic operations.
+    class Counter
+    {
+        TS_NOCOPY(Counter);
+    public:
+        Counter() : _value(0) {}
+        void increment() { _value.store(_value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+        void decrement() { _value.store(_value.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed); }
+        uint64_t value() const { return _value.load(std::memory_order_relaxed); }
+    private:
+        std::atomic<uint64_t> _value;
+    };
+
+    // Cache of free blocks of one thread.
+    class ThreadCache
+    {
+        TS_NOCOPY(ThreadCache);
+    public:
+        ThreadCache();
+        ~ThreadCache();
+
+        FreeBlock* free_list[CLASS_COUNT];
+        size_t     free_count[CLASS_COUNT];
+        Counter    allocated;
+        Counter    reused;
+        Counter    deallocated;
+        Counter    released;
+        Counter    large;
+        Counter    cached;
+
+        // Add the counters into a statistics structure.
+        void addTo(ts::MemoryPool::Statistics& stats) const;
+    };
+
+    ThreadCache::ThreadCache() :
+        free_list(),
+        free_count(),
+        allocated(),
+        reused(),
+        deallocated(),
+        released(),
+        large(),
+        cached()
+    {
+    }
+
+    // The destructor returns all cached blocks to the system.
+    ThreadCache::~ThreadCache()
+    {
+        for (size_t i = 0; i < CLASS_COUNT; ++i) {
+            while (free_list[i] != nullptr) {
+                FreeBlock* block = free_list[i];
+                free_list[i] = block->next;
+                ::operator delete(block);
+            }
+        }
+    }
+
+    void ThreadCache::addTo(ts::MemoryPool::Statistics& stats) const
+    {
+        stats.allocated += allocated.value();
+        stats.reused += reused.value();
+        stats.deallocated += deallocated.value();
+        stats.released += released.value();
+        stats.large += large.value();
+        stats.cached += cached.value();
+    }
+
+    // Registry of all thread caches, for global statistics.
+    class Registry
+    {
+        TS_NOCOPY(Registry);
+    public:
+        // The registry is never destroyed since threads may terminate during the static destructions.
+        static Registry& Instance()
+        {
+            static Registry* const instance = new Registry;
+            return *instance;
+        }
+
+        // Register and deregister a thread cache.
+        void add(ThreadCache* cache)
+        {
+            ts::Guard lock(_mutex);
+            _caches.insert(cache);
+        }
+        void remove(ThreadCache* cache)
+        {
+            ts::Guard lock(_mutex);
+            // The cached blocks are released when the thread exits.
+            cache->addTo(_terminated);
+            _terminated.released += _terminated.cached;
+            _terminated.cached = 0;
+            _caches.erase(cache);
+        }
+
+        // Get cumulated statistics.
+        void getStatistics(ts::MemoryPool::Statistics& stats)
+        {
+            ts::Guard lock(_mutex);
+            stats = _terminated;
+            for (const auto& it : _caches) {
+                it->addTo(stats);
+            }
+        }
+
+    private:
+        Registry() : _mutex(), _caches(), _terminated() {}
+        ts::Mutex                  _mutex;
+        std::set<ThreadCache*>     _caches;
+        ts::MemoryPool::Statistics _terminated;  // Cumulated statistics of terminated threads.
+    };
+
+    // Cache of the current thread. Trivial thread-local variables, without initialization overhead.
+    // After the thread-local destructors of a thread, the thread no longer uses the pool.
+    thread_local ThreadCache* tls_cache = nullptr;
+    thread_local bool tls_exited = false;
+
+    // The destructor of this thread-local object releases the cache of the thread when it exits.
+    class CacheReleaser
+    {
+        TS_NOCOPY(CacheReleaser);
+    public:
+        CacheReleaser();
+        ~CacheReleaser();
+        void touch() {}
+    };
+
+    // Out-of-line constructor, make sure the object is dynamically initialized on first use.
+    CacheReleaser::CacheReleaser()
+    {
+    }
+
+    CacheReleaser::~CacheReleaser()
+    {
+        ThreadCache* cache = tls_cache;
+        tls_cache = nullptr;
+        tls_exited = true;
+        if (cache != nullptr) {
+            Registry::Instance().remove(cache);
+            delete cache;
+        }
+    }
+
+    thread_local CacheReleaser tls_releaser;
+
+    // Get the cache of the current thread, create it if necessary, null if the pool is not usable.
+    inline ThreadCache* CurrentCache()
+    {
+        ThreadCache* cache = tls_cache;
+        if (cache == nullptr && !tls_exited && !PoolDisabled()) {
+            cache = tls_cache = new ThreadCache;
+            tls_releaser.touch();
+            Registry::Instance().add(cache);
+        }
+        return cache;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate a memory block.
+//----------------------------------------------------------------------------
+
+void* ts::MemoryPool::Allocate(size_t size)
+{
+    if (size > MAX_BLOCK_SIZE) {
+        ThreadCache* cache = CurrentCache();
+        if (cache != nullptr) {
+            cache->large.increment();
+        }
+        return ::operator new(size);
+    }
+
+    const size_t index = SizeClass(size);
+    ThreadCache* cache = CurrentCache();
+    if (cache == nullptr) {
+        // Always allocate the full class size, the block may be deallocated later in a thread with a cache.
+        return ::operator new(ClassSize(index));
+    }
+
+    cache->allocated.increment();
+    FreeBlock* block = cache->free_list[index];
+    if (block == nullptr) {
+        return ::operator new(ClassSize(index));
+    }
+    else {
+        cache->free_list[index] = block->next;
+        cache->free_count[index]--;
+        cache->cached.decrement();
+        cache->reused.increment();
+        return block;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Deallocate a memory block.
+//----------------------------------------------------------------------------
+
+void ts::MemoryPool::Deallocate(void* ptr, size_t size)
+{
+    if (ptr != nullptr) {
+        ThreadCache* cache = size > MAX_BLOCK_SIZE ? nullptr : CurrentCache();
+        if (cache == nullptr) {
+            ::operator delete(ptr);
+        }
+        else {
+            const size_t index = SizeClass(size);
+            cache->deallocated.increment();
+            if (cache->free_count[index] >= ClassMaxCached(index)) {
+                cache->released.increment();
+                ::operator delete(ptr);
+            }
+            else {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+                block->next = cache->free_list[index];
+                cache->free_list[index] = block;
+                cache->free_count[index]++;
+                cache->cached.increment();
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Usage statistics.
+//----------------------------------------------------------------------------
+
+ts::MemoryPool::Statistics::Statistics() :
+    allocated(0),
+    reused(0),
+    deallocated(0),
+    released(0),
+    large(0),
+    cached(0)
+{
+}
+
+void ts::MemoryPool::GetStatistics(Statistics& stats)
+{
+    Registry::Instance().getStatistics(stats);
+}
+
+ts::UString ts::MemoryPool::Statistics::toString() const
+{
+    return UString::Format(u"allocated: %'d, reused: %'d (%d%%), deallocated: %'d, released: %'d, cached: %'d, too large: %'d",
+                           {allocated, reused, allocated == 0 ? 0 : (100 * reused) / allocated, deallocated, released, cached, large});
+}
@@ -0,0 +1,193 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Pool of memory blocks for frequently allocated objects.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+
+    class UString;
+
+    //!
+    //! Pool of memory blocks for frequently allocated objects.
+    //! @ingroup cpp
+    //!
+    //! Demuxing or packetizing sections allocates and deallocates many objects
+    //! of a few sizes: Section and ByteBlock objects, the reference counters
+    //! of SafePtr and the section reassembly buffers, up to 4 kB. This class manages
+    //! one cache of free blocks per thread and per size class. A deallocated block
+    //! is kept in the cache of the current thread and is reused by the next allocation
+    //! of the same size class, without lock.
+    //!
+    //! Classes which want to use the pool simply define their own operators @c new
+    //! and @c delete using Allocate() and Deallocate(). Containers use PoolAllocator.
+    //! Blocks can be deallocated in another thread than the one which allocated them.
+    //!
+    //! For debugging with memory checkers, the pool can be disabled by defining
+    //! the environment variable @c TSDUCK_NO_MEMORY_POOL. All allocations are
+    //! then directly forwarded to the system.
+    //!
+    class TSDUCKDLL MemoryPool
+    {
+        TS_NOBUILD_NOCOPY(MemoryPool);
+    public:
+        //!
+        //! Granularity of the size classes of small blocks in bytes.
+        //!
+        static constexpr size_t GRANULARITY = 16;
+
+        //!
+        //! Largest small block size in bytes. Above this size, the size classes are powers of 2.
+        //!
+        static constexpr size_t SMALL_BLOCK_SIZE = 256;
+
+        //!
+        //! Largest pooled block size in bytes. Larger blocks are directly allocated from the system.
+        //! This is the maximum size of a section.
+        //!
+        static constexpr size_t MAX_BLOCK_SIZE = 4096;
+
+        //!
+        //! Maximum number of free blocks in the cache of each thread, per size class.
+        //! When the cache is full, deallocated blocks are returned to the system.
+        //!
+        static constexpr size_t MAX_CACHED_BLOCKS = 1024;
+
+        //!
+        //! Maximum size in bytes of the free blocks in the cache of each thread, per size class.
+        //! For large blocks, this limit is reached before MAX_CACHED_BLOCKS.
+        //!
+        static constexpr size_t MAX_CACHED_BYTES = 256 * 1024;
+
+        //!
+        //! Allocate a memory block.
+        //! @param [in] size Size in bytes of the block.
+        //! @return Address of the allocated block. Throw std::bad_alloc on error.
+        //!
+        static void* Allocate(size_t size);
+
+        //!
+        //! Deallocate a memory block.
+        //! @param [in] ptr Address of the block, as returned by Allocate(). Ignored if null.
+        //! @param [in] size Size in bytes of the block, as passed to Allocate().
+        //!
+        static void Deallocate(void* ptr, size_t size);
+
+        //!
+        //! Usage statistics of the memory pool, in all threads.
+        //!
+        struct TSDUCKDLL Statistics
+        {
+            Statistics();              //!< Constructor.
+            uint64_t allocated;        //!< Number of pooled allocations.
+            uint64_t reused;           //!< Number of pooled allocations which reused a cached block.
+            uint64_t deallocated;      //!< Number of pooled deallocations.
+            uint64_t released;         //!< Number of deallocated blocks which were returned to the system.
+            uint64_t large;            //!< Number of allocations which are too large for the pool.
+            uint64_t cached;           //!< Number of free blocks which are currently cached.
+            UString toString() const;  //!< Format the statistics as a one-line string. @return A string.
+        };
+
+        //!
+        //! Get the usage statistics of the memory pool.
+        //! @param [out] stats Cumulated statistics of all threads, including terminated threads.
+        //!
+        static void GetStatistics(Statistics& stats);
+    };
+
+    //!
+    //! Standard allocator for containers, using a MemoryPool.
+    //! @ingroup cpp
+    //! @tparam T Type of the allocated elements.
+    //!
+    template <typename T>
+    class PoolAllocator
+    {
+    public:
+        //!
+        //! Type of the allocated elements.
+        //!
+        typedef T value_type;
+
+        //!
+        //! Default constructor.
+        //!
+        PoolAllocator() noexcept {}
+
+        //!
+        //! Conversion constructor from an allocator for another type.
+        //! @tparam U Type of the allocated elements of the other allocator.
+        //!
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+        //!
+        //! Allocate elements.
+        //! @param [in] n Number of elements.
+        //! @return Address of the allocated elements. Throw std::bad_alloc on error.
+        //!
+        T* allocate(size_t n)
+        {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+                throw std::bad_alloc();
+            }
+            return reinterpret_cast<T*>(MemoryPool::Allocate(n * sizeof(T)));
+        }
+
+        //!
+        //! Deallocate elements.
+        //! @param [in] p Address of the elements, as returned by allocate().
+        //! @param [in] n Number of elements, as passed to allocate().
+        //!
+        void deallocate(T* p, size_t n) noexcept
+        {
+            MemoryPool::Deallocate(p, n * sizeof(T));
+        }
+    };
+
+    //!
+    //! Equality of two pool allocators.
+    //! All pool allocators are equal, memory from one can be deallocated by any other one.
+    //! @return Always true.
+    //!
+    template <typename T, typename U>
+    inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept { return true; }
+
+    //!
+    //! Inequality of two pool allocators.
+    //! @return Always false.
+    //!
+    template <typename T, typename U>
+    inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept { return false; }
+}
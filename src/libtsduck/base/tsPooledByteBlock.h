@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Block of bytes with a content which is allocated in a memory pool.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMemoryPool.h"
+
+namespace ts {
+    //!
+    //! Block of bytes with a content which is allocated in a MemoryPool.
+    //! @ingroup cpp
+    //!
+    //! This is a subclass of @c std::vector on @c uint8_t with the allocator PoolAllocator.
+    //! It is designed for internal buffers which are frequently allocated, enlarged and
+    //! freed, such as the section reassembly buffers of a demux. Unlike ByteBlock, which
+    //! uses the standard allocator, it cannot be passed where a @c std::vector<uint8_t>
+    //! or a ByteBlock is expected.
+    //!
+    class PooledByteBlock : public std::vector<uint8_t, PoolAllocator<uint8_t>>
+    {
+    public:
+        //!
+        //! Explicit name of superclass, @c std::vector on @c uint8_t with a pool allocator.
+        //!
+        typedef std::vector<uint8_t, PoolAllocator<uint8_t>> ByteVector;
+
+        //!
+        //! Default constructor.
+        //! @param [in] size Initial size in bytes of the block.
+        //!
+        explicit PooledByteBlock(size_type size = 0) : ByteVector(size) {}
+
+        //!
+        //! Remove 'size' elements at index 'first'.
+        //! The STL equivalent uses iterators, not indices.
+        //! @param [in] first Index of the first byte to erase.
+        //! @param [in] size Number of bytes to erase.
+        //!
+        void erase(size_type first, size_type size)
+        {
+            assert(first + size <= this->size());
+            ByteVector::erase(begin() + first, begin() + first + size);
+        }
+
+        //!
+        //! Append raw data to a byte block.
+        //! @param [in] data Address of the new area to append.
+        //! @param [in] size Size of the area to append.
+        //!
+        void append(const void* data, size_type size)
+        {
+            if (size > 0 && data != nullptr) {
+                const size_type previous = this->size();
+                resize(previous + size);
+                ::memcpy(this->data() + previous, data, size);  // Flawfinder: ignore: memcpy()
+            }
+        }
+    };
+}
@@ -49,10 +49,14 @@ namespace ts {
         //!
         //! Constructor, based on required amount of elements.
         //! Abort application if memory allocation fails.
-        //! Do not abort if memory locking fails.
+        //! Do not abort if memory locking fails or if the requested placement cannot be honored.
         //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] page_size Requested memory page size in bytes. Zero means the default system
+        //! memory page size. A larger value means huge pages (typically 2 MB or 1 GB on Linux).
+        //! @param [in] numa_node Index of the NUMA node to bind the memory to. NPOS means no binding.
+        //! @see AllocateMemoryPages()
         //!
-        ResidentBuffer(size_t elem_count);
+        ResidentBuffer(size_t elem_count, size_t page_size = 0, size_t numa_node = NPOS);
 
         //!
         //! Destructor.
@@ -77,6 +81,42 @@ namespace ts {
             return _error_code;
         }
 
+        //!
+        //! Get error code when the requested huge pages are not available.
+        //! @return The system error code when the huge pages allocation failed.
+        //!
+        SysErrorCode pageErrorCode() const
+        {
+            return _page_error;
+        }
+
+        //!
+        //! Get error code when the buffer cannot be bound to the requested NUMA node.
+        //! @return The system error code when the NUMA binding failed.
+        //!
+        SysErrorCode numaErrorCode() const
+        {
+            return _numa_error;
+        }
+
+        //!
+        //! Get the actual memory page size of the buffer.
+        //! @return The memory page size in bytes.
+        //!
+        size_t pageSize() const
+        {
+            return _page_size;
+        }
+
+        //!
+        //! Get the NUMA node where the buffer is physically located.
+        //! @return The index of the NUMA node of the start of the buffer or NPOS if unknown.
+        //!
+        size_t numaNode() const
+        {
+            return GetMemoryNumaNode(_base);
+        }
+
         //!
         //! Return base address of the buffer.
         //! @return The address of the first @a T element in the buffer.
@@ -103,7 +143,11 @@ namespace ts {
         size_t    _locked_size;      // Locked size (mlock, multiple of page size)
         size_t    _elem_count;       // Element count in locked region
         bool      _is_locked;        // False if mlock failed.
-        SysErrorCode _error_code;       // Lock error code
+        bool      _is_mapped;        // Allocated using AllocateMemoryPages (placement).
+        size_t    _page_size;        // Actual memory page size.
+        SysErrorCode _error_code;    // Lock error code
+        SysErrorCode _page_error;    // Huge pages error code
+        SysErrorCode _numa_error;    // NUMA binding error code
     };
 }
 
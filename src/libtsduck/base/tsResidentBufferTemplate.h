@@ -45,7 +45,7 @@
 //----------------------------------------------------------------------------
 
 template <typename T>
-ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
+ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count, size_t page_size, size_t numa_node) :
     _allocated_base(nullptr),
     _locked_base(nullptr),
     _base(nullptr),
@@ -53,38 +53,59 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_size(0),
     _elem_count(elem_count),
     _is_locked(false),
-    _error_code(SYS_SUCCESS)
+    _is_mapped(false),
+    _page_size(SysInfo::Instance()->memoryPageSize()),
+    _error_code(SYS_SUCCESS),
+    _page_error(SYS_SUCCESS),
+    _numa_error(SYS_SUCCESS)
 {
     const size_t requested_size = elem_count * sizeof(T);
-    const size_t page_size = SysInfo::Instance()->memoryPageSize();
 
-    // Allocate enough space to include memory pages around the requested size
+    if (page_size > 0 || numa_node != NPOS) {
+        // Allocate memory pages with the requested placement. The allocated area
+        // is page-aligned and its size is a multiple of the actual page size.
+        _allocated_size = requested_size;
+        _page_size = page_size;
+        _allocated_base = reinterpret_cast<char*>(AllocateMemoryPages(_allocated_size, _page_size, numa_node, _page_error, _numa_error));
+        _is_mapped = _allocated_base != nullptr;
+        if (_is_mapped) {
+            _locked_base = _allocated_base;
+            _locked_size = _allocated_size;
+        }
+        else {
+            _page_size = SysInfo::Instance()->memoryPageSize();
+        }
+    }
 
-    _allocated_size = requested_size + 2 * page_size;
-    _allocated_base = new char[_allocated_size];
+    if (!_is_mapped) {
+        // Allocate enough space to include memory pages around the requested size
 
-    // Locked space starts at next page boundary after allocated base:
-    // Its size is the next multiple of page size after requested_size:
-    // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
-    // to perform arithmetics on pointers because we use modulo operations.
+        _allocated_size = requested_size + 2 * _page_size;
+        _allocated_base = new char[_allocated_size];
 
-    assert(sizeof(size_t) == sizeof(char_ptr));
-    _locked_base = char_ptr(RoundUp(size_t(_allocated_base), page_size));
-    _locked_size = RoundUp(requested_size, page_size);
+        // Locked space starts at next page boundary after allocated base:
+        // Its size is the next multiple of page size after requested_size:
+        // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
+        // to perform arithmetics on pointers because we use modulo operations.
+
+        assert(sizeof(size_t) == sizeof(char_ptr));
+        _locked_base = char_ptr(RoundUp(size_t(_allocated_base), _page_size));
+        _locked_size = RoundUp(requested_size, _page_size);
+    }
 
     _base = new (_locked_base) T[elem_count];
 
     // Integrity checks
 
     assert(_allocated_base <= _locked_base);
-    assert(_locked_base < _allocated_base + page_size);
+    assert(_locked_base < _allocated_base + _page_size);
     assert(_locked_base + _locked_size <= _allocated_base + _allocated_size);
     assert(requested_size <= _locked_size);
     assert(_locked_size <= _allocated_size);
-    assert(size_t(_locked_base) % page_size == 0);
+    assert(size_t(_locked_base) % _page_size == 0);
     assert(size_t(_locked_base) == size_t(_base));
     assert(char_ptr(_base + elem_count) <= _locked_base + _locked_size);
-    assert(_locked_size % page_size == 0);
+    assert(_locked_size % _page_size == 0);
 
 #if defined(TS_WINDOWS)
 
@@ -138,7 +159,10 @@ ts::ResidentBuffer<T>::~ResidentBuffer<T>()
     }
 
     // Free memory
-    if (_allocated_base != nullptr) {
+    if (_is_mapped) {
+        FreeMemoryPages(_allocated_base, _allocated_size);
+    }
+    else if (_allocated_base != nullptr) {
         delete[] _allocated_base;
     }
 
@@ -150,4 +174,5 @@ ts::ResidentBuffer<T>::~ResidentBuffer<T>()
     _locked_size = 0;
     _elem_count = 0;
     _is_locked = false;
+    _is_mapped = false;
 }
@@ -38,6 +38,7 @@
 #include "tsGuard.h"
 #include "tsMutex.h"
 #include "tsNullMutex.h"
+#include "tsMemoryPool.h"
 
 namespace ts {
     //!
@@ -486,6 +487,10 @@ namespace ts {
             // Destructor. Deallocate actual object (if any).
             ~SafePtrShared();
 
+            // Reference counters are frequently allocated, use a memory pool.
+            static void* operator new(size_t size) { return MemoryPool::Allocate(size); }
+            static void operator delete(void* ptr, size_t size) { MemoryPool::Deallocate(ptr, size); }
+
             // Same semantics as SafePtr counterparts:
             T* release();
             void reset(T* p);
@@ -29,6 +29,7 @@
 
 #include "tsSysInfo.h"
 #include "tsSysUtils.h"
+#include "tsNullReport.h"
 #include "tsMemory.h"
 #if defined(TS_MAC)
 #include "tsMacPList.h"
@@ -40,6 +41,19 @@ TSDUCK_SOURCE;
 // Define singleton instance
 TS_DEFINE_SINGLETON(ts::SysInfo);
 
+// Names of CPU features.
+const ts::Enumeration ts::SysInfo::CPUFeatureEnum({
+    {u"sse2",    ts::SysInfo::CPU_SSE2},
+    {u"ssse3",   ts::SysInfo::CPU_SSSE3},
+    {u"sse4.2",  ts::SysInfo::CPU_SSE42},
+    {u"avx2",    ts::SysInfo::CPU_AVX2},
+    {u"avx512f", ts::SysInfo::CPU_AVX512F},
+    {u"pclmul",  ts::SysInfo::CPU_PCLMUL},
+    {u"aes",     ts::SysInfo::CPU_AES},
+    {u"vaes",    ts::SysInfo::CPU_VAES},
+    {u"bmi2",    ts::SysInfo::CPU_BMI2},
+});
+
 
 //----------------------------------------------------------------------------
 // Constructor.
@@ -79,7 +93,10 @@ ts::SysInfo::SysInfo() :
     _systemVersion(),
     _systemName(),
     _hostName(),
-    _memoryPageSize(0)
+    _memoryPageSize(0),
+    _numaNodeCount(1),
+    _cpuDetectedFeatures(0),
+    _cpuFeatures(0)
 {
     //
     // Get operating system name and version.
@@ -224,4 +241,145 @@ ts::SysInfo::SysInfo() :
     }
 
 #endif
+
+    //
+    // Get the number of NUMA nodes (Linux only).
+    //
+#if defined(TS_LINUX)
+    std::set<size_t> nodes;
+    if (LoadIndexList(nodes, u"/sys/devices/system/node/online") && !nodes.empty()) {
+        _numaNodeCount = *nodes.rbegin() + 1;
+    }
+#endif
+
+    //
+    // Get the CPU features.
+    //
+#if (defined(TS_GCC) || defined(TS_LLVM)) && (defined(TS_X86_64) || defined(TS_I386))
+
+    // This constructor may be invoked during the initialization of static objects.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        _cpuDetectedFeatures |= CPU_SSE2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        _cpuDetectedFeatures |= CPU_SSSE3;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        _cpuDetectedFeatures |= CPU_SSE42;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        _cpuDetectedFeatures |= CPU_AVX2;
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        _cpuDetectedFeatures |= CPU_AVX512F;
+    }
+    if (__builtin_cpu_supports("pclmul")) {
+        _cpuDetectedFeatures |= CPU_PCLMUL;
+    }
+    if (__builtin_cpu_supports("aes")) {
+        _cpuDetectedFeatures |= CPU_AES;
+    }
+    if (__builtin_cpu_supports("vaes")) {
+        _cpuDetectedFeatures |= CPU_VAES;
+    }
+    if (__builtin_cpu_supports("bmi2")) {
+        _cpuDetectedFeatures |= CPU_BMI2;
+    }
+
+#endif
+
+    // Features which are disabled from the environment. Invalid names are ignored.
+    uint32_t disabled = 0;
+    if (EnvironmentExists(u"TSDUCK_NO_CPU_FEATURES")) {
+        DecodeCPUFeatures(disabled, GetEnvironment(u"TSDUCK_NO_CPU_FEATURES"), NULLREP);
+    }
+    _cpuFeatures = _cpuDetectedFeatures & ~disabled;
+}
+
+
+//----------------------------------------------------------------------------
+// Disable the usage of some CPU features.
+//----------------------------------------------------------------------------
+
+void ts::SysInfo::disableCPUFeatures(uint32_t features)
+{
+    _cpuFeatures.fetch_and(~features, std::memory_order_relaxed);
+}
+
+
+//----------------------------------------------------------------------------
+// Decode a list of CPU features names.
+//----------------------------------------------------------------------------
+
+bool ts::SysInfo::DecodeCPUFeatures(uint32_t& features, const UString& names, Report& report)
+{
+    features = 0;
+    bool success = true;
+
+    // An empty list means all features.
+    UStringVector list;
+    names.split(list, u',', true, true);
+    if (list.empty()) {
+        features = CPU_ALL;
+    }
+
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        const int value = it->similar(u"all") ? int(CPU_ALL) : CPUFeatureEnum.value(*it, false);
+        if (value == Enumeration::UNKNOWN) {
+            report.error(u"unknown CPU feature \"%s\", must be one of %s, all", {*it, CPUFeatureEnum.nameList()});
+            success = false;
+        }
+        else {
+            features |= uint32_t(value);
+        }
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the list of CPU's of a NUMA node.
+//----------------------------------------------------------------------------
+
+bool ts::SysInfo::getNumaNodeCPUs(std::set<size_t>& cpus, size_t node) const
+{
+    cpus.clear();
+#if defined(TS_LINUX)
+    return node < _numaNodeCount && LoadIndexList(cpus, UString::Format(u"/sys/devices/system/node/node%d/cpulist", {node})) && !cpus.empty();
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Load a list of CPU's or NUMA nodes from a Linux sysfs file.
+//----------------------------------------------------------------------------
+
+bool ts::SysInfo::LoadIndexList(std::set<size_t>& list, const UString& fileName)
+{
+    list.clear();
+    UStringList lines;
+    if (!UString::Load(lines, fileName) || lines.empty()) {
+        return false;
+    }
+    UStringVector ranges;
+    lines.front().split(ranges, u',', true, true);
+    for (const auto& range : ranges) {
+        size_t first = 0;
+        size_t last = 0;
+        if (range.scan(u"%d-%d", {&first, &last})) {
+            for (size_t i = first; i <= last; ++i) {
+                list.insert(i);
+            }
+        }
+        else if (range.toInteger(first)) {
+            list.insert(first);
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
 }
@@ -35,6 +35,8 @@
 #pragma once
 #include "tsSingletonManager.h"
 #include "tsUString.h"
+#include "tsReport.h"
+#include <atomic>
 
 namespace ts {
     //!
@@ -117,6 +119,84 @@ namespace ts {
         //! @return The system memory page size in bytes.
         //!
         size_t memoryPageSize() const { return _memoryPageSize; }
+        //!
+        //! Get the number of NUMA nodes in the system.
+        //! @return The number of NUMA nodes. This is 1 on systems without NUMA or when NUMA is not supported.
+        //!
+        size_t numaNodeCount() const { return _numaNodeCount; }
+        //!
+        //! Get the list of CPU's of a NUMA node.
+        //! @param [out] cpus Returned set of CPU indexes.
+        //! @param [in] node Index of the NUMA node.
+        //! @return True on success, false if the NUMA node does not exist or NUMA is not supported.
+        //!
+        bool getNumaNodeCPUs(std::set<size_t>& cpus, size_t node) const;
+
+        //!
+        //! Optional instruction set extensions of the CPU.
+        //! These values can be used as bit masks.
+        //!
+        enum CPUFeature : uint32_t {
+            CPU_SSE2    = 0x0001,  //!< Intel SSE2.
+            CPU_SSSE3   = 0x0002,  //!< Intel SSSE3.
+            CPU_SSE42   = 0x0004,  //!< Intel SSE4.2.
+            CPU_AVX2    = 0x0008,  //!< Intel AVX2.
+            CPU_AVX512F = 0x0010,  //!< Intel AVX-512 foundation.
+            CPU_PCLMUL  = 0x0020,  //!< Intel carry-less multiplication (PCLMULQDQ).
+            CPU_AES     = 0x0040,  //!< Intel AES-NI.
+            CPU_VAES    = 0x0080,  //!< Intel vector AES (VAES).
+            CPU_BMI2    = 0x0100,  //!< Intel bit manipulation instructions set 2.
+            CPU_ALL     = 0x01FF,  //!< All CPU features.
+        };
+
+        //!
+        //! Enumeration description of the CPU features (without CPU_ALL).
+        //!
+        static const Enumeration CPUFeatureEnum;
+
+        //!
+        //! Get the CPU features which were detected on the system.
+        //! @return The detected CPU features, a bit mask of CPUFeature values.
+        //!
+        uint32_t cpuDetectedFeatures() const { return _cpuDetectedFeatures; }
+
+        //!
+        //! Get the CPU features which can be used by the optimized implementations of the library.
+        //! These are the detected features, minus the disabled ones.
+        //! @return The usable CPU features, a bit mask of CPUFeature values.
+        //!
+        uint32_t cpuFeatures() const { return _cpuFeatures.load(std::memory_order_relaxed); }
+
+        //!
+        //! Check if some CPU features can be used.
+        //! @param [in] features A bit mask of CPUFeature values.
+        //! @return True if all features in @a features can be used.
+        //!
+        bool cpuHasFeatures(uint32_t features) const { return (cpuFeatures() & features) == features; }
+
+        //!
+        //! Disable the usage of some CPU features, typically to force the generic implementations for tests or benchmarks.
+        //!
+        //! The optimized implementations of the library (CRC32, AES, DVB-CSA2, etc.) select
+        //! their implementation once, the first time they are used. To be effective, this method
+        //! must be called at the start of the application, before any processing.
+        //!
+        //! The CPU features can also be disabled from the environment variable @c TSDUCK_NO_CPU_FEATURES.
+        //! Its value is a comma-separated list of feature names (see CPUFeatureEnum) or @c all.
+        //! An empty value means all features.
+        //!
+        //! @param [in] features A bit mask of CPUFeature values to disable.
+        //!
+        void disableCPUFeatures(uint32_t features);
+
+        //!
+        //! Decode a list of CPU features names.
+        //! @param [out] features A bit mask of CPUFeature values.
+        //! @param [in] names Comma-separated list of feature names (see CPUFeatureEnum) or @c all.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false if a name is invalid.
+        //!
+        static bool DecodeCPUFeatures(uint32_t& features, const UString& names, Report& report);
 
     private:
         bool    _isLinux;
@@ -133,5 +213,11 @@ namespace ts {
         UString _systemName;
         UString _hostName;
         size_t  _memoryPageSize;
+        size_t  _numaNodeCount;
+        uint32_t              _cpuDetectedFeatures;
+        std::atomic<uint32_t> _cpuFeatures;
+
+        // Load a list of CPU's or NUMA nodes from a Linux sysfs file ("0-3,8-11" format).
+        static bool LoadIndexList(std::set<size_t>& list, const UString& fileName);
     };
 }
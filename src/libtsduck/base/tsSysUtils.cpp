@@ -30,6 +30,8 @@
 #include "tsSysUtils.h"
 #include "tsStaticInstance.h"
 #include "tsMemory.h"
+#include "tsIntegerUtils.h"
+#include "tsSysInfo.h"
 #include "tsUID.h"
 #include "tsTime.h"
 #include "tsMutex.h"
@@ -42,8 +44,16 @@ TSDUCK_SOURCE;
 #include "tsWinUtils.h"
 #endif
 
-#if defined(TS_MAC)
+#if defined(TS_UNIX)
 #include <sys/resource.h>
+#endif
+
+#if defined(TS_LINUX)
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+#if defined(TS_MAC)
 #include <mach/mach.h>
 #include <mach/message.h>
 #include <mach/kern_return.h>
@@ -1013,6 +1023,145 @@ void ts::GetProcessMetrics(ProcessMetrics& metrics)
 }
 
 
+//----------------------------------------------------------------------------
+// Allocate an area of memory pages, with an optional placement.
+//----------------------------------------------------------------------------
+
+void* ts::AllocateMemoryPages(size_t& size, size_t& page_size, size_t numa_node, SysErrorCode& page_error, SysErrorCode& numa_error)
+{
+    const size_t sys_page_size = SysInfo::Instance()->memoryPageSize();
+    void* address = nullptr;
+    page_error = numa_error = SYS_SUCCESS;
+
+    if (page_size < sys_page_size) {
+        page_size = sys_page_size;
+    }
+
+#if defined(TS_WINDOWS)
+
+    // Huge pages ("large pages") require specific privileges on Windows, use normal pages.
+    if (page_size > sys_page_size) {
+        page_error = ERROR_NOT_SUPPORTED;
+        page_size = sys_page_size;
+    }
+    if (numa_node != NPOS) {
+        numa_error = ERROR_NOT_SUPPORTED;
+    }
+    size = RoundUp(size, page_size);
+    address = ::VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+#else
+
+    // Try explicit huge pages first (Linux hugetlbfs, must be reserved by the administrator).
+#if defined(TS_LINUX) && defined(MAP_HUGETLB)
+    if (page_size > sys_page_size) {
+        const size_t hsize = RoundUp(size, page_size);
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#if defined(MAP_HUGE_SHIFT)
+        int log2 = 0;
+        while ((size_t(1) << log2) < page_size) {
+            log2++;
+        }
+        flags |= log2 << MAP_HUGE_SHIFT;
+#endif
+        address = ::mmap(nullptr, hsize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (address == MAP_FAILED) {
+            address = nullptr;
+            page_error = LastSysErrorCode();
+        }
+        else {
+            size = hsize;
+        }
+    }
+#else
+    if (page_size > sys_page_size) {
+        page_error = ENOTSUP;
+    }
+#endif
+
+    // Fallback to normal pages.
+    if (address == nullptr) {
+        const bool want_huge = page_size > sys_page_size;
+        page_size = sys_page_size;
+        size = RoundUp(size, page_size);
+        address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address == MAP_FAILED) {
+            // Nothing allocated, no requested placement is honored.
+            const SysErrorCode err = LastSysErrorCode();
+            if (want_huge) {
+                page_error = err;
+            }
+            if (numa_node != NPOS) {
+                numa_error = err;
+            }
+            return nullptr;
+        }
+#if defined(TS_LINUX) && defined(MADV_HUGEPAGE)
+        // Let the kernel use transparent huge pages when possible.
+        if (want_huge) {
+            ::madvise(address, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    // Bind the memory to a NUMA node before the pages are touched.
+    if (numa_node != NPOS) {
+#if defined(TS_LINUX) && defined(SYS_mbind)
+        unsigned long mask[16];
+        TS_ZERO(mask);
+        const size_t bits = 8 * sizeof(mask[0]);
+        if (numa_node >= 8 * sizeof(mask)) {
+            numa_error = EINVAL;
+        }
+        else {
+            mask[numa_node / bits] = 1UL << (numa_node % bits);
+            if (::syscall(SYS_mbind, address, size, MPOL_BIND, mask, 8 * sizeof(mask) + 1, 0) != 0) {
+                numa_error = LastSysErrorCode();
+            }
+        }
+#else
+        numa_error = ENOTSUP;
+#endif
+    }
+
+#endif
+
+    return address;
+}
+
+
+//----------------------------------------------------------------------------
+// Free an area of memory pages.
+//----------------------------------------------------------------------------
+
+void ts::FreeMemoryPages(void* address, size_t size)
+{
+    if (address != nullptr) {
+#if defined(TS_WINDOWS)
+        ::VirtualFree(address, 0, MEM_RELEASE);
+#else
+        ::munmap(address, size);
+#endif
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the NUMA node where a memory page is physically located.
+//----------------------------------------------------------------------------
+
+size_t ts::GetMemoryNumaNode(const void* address)
+{
+    int node = -1;
+#if defined(TS_LINUX) && defined(SYS_get_mempolicy)
+    if (address != nullptr && ::syscall(SYS_get_mempolicy, &node, nullptr, 0, address, MPOL_F_NODE | MPOL_F_ADDR) != 0) {
+        node = -1;
+    }
+#endif
+    return address == nullptr || node < 0 ? NPOS : size_t(node);
+}
+
+
 //----------------------------------------------------------------------------
 // Ignore SIGPIPE. On UNIX systems: writing to a broken pipe returns an
 // error instead of killing the process. On Windows systems: does nothing.
@@ -1026,6 +1175,47 @@ void ts::IgnorePipeSignal()
 }
 
 
+//----------------------------------------------------------------------------
+// Raise the maximum number of open files in the current process.
+//----------------------------------------------------------------------------
+
+bool ts::RaiseOpenFilesLimit(size_t count, Report& report)
+{
+#if defined(TS_UNIX)
+    ::rlimit lim;
+    if (::getrlimit(RLIMIT_NOFILE, &lim) != 0) {
+        report.error(u"getrlimit error: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+    if (lim.rlim_cur == RLIM_INFINITY || (count > 0 && lim.rlim_cur >= ::rlim_t(count))) {
+        return true; // already sufficient
+    }
+    const ::rlim_t previous = lim.rlim_cur;
+    if (count == 0) {
+        lim.rlim_cur = lim.rlim_max;
+    }
+    else if (lim.rlim_max == RLIM_INFINITY || lim.rlim_max >= ::rlim_t(count)) {
+        lim.rlim_cur = ::rlim_t(count);
+    }
+    else {
+        lim.rlim_cur = lim.rlim_max;
+    }
+    if (lim.rlim_cur != previous) {
+        if (::setrlimit(RLIMIT_NOFILE, &lim) != 0) {
+            report.error(u"setrlimit error: %s", {SysErrorCodeMessage()});
+            return false;
+        }
+        report.debug(u"max open files raised from %'d to %'d", {previous, lim.rlim_cur});
+    }
+    if (count > 0 && lim.rlim_cur < ::rlim_t(count)) {
+        report.error(u"the system limits the number of open files to %'d, %'d requested", {lim.rlim_cur, count});
+        return false;
+    }
+#endif
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Put standard input / output stream in binary mode.
 // On UNIX systems, this does not make any difference.
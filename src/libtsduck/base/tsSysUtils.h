@@ -712,6 +712,41 @@ namespace ts {
     //!
     TSDUCKDLL void GetProcessMetrics(ProcessMetrics& metrics);
 
+    //!
+    //! Allocate an area of memory pages, with an optional placement.
+    //! This is typically used to allocate large memory-resident buffers.
+    //!
+    //! When a placement cannot be honored (huge pages not available, NUMA not supported),
+    //! the memory is still allocated with the default placement and the corresponding
+    //! error code is set.
+    //!
+    //! @param [in,out] size Requested size in bytes. Upon return, contain the allocated size,
+    //! a multiple of the actual page size.
+    //! @param [in,out] page_size Requested page size in bytes. Zero means the default system memory page size.
+    //! A larger value means huge pages (typically 2 MB or 1 GB on Linux). Upon return, contain
+    //! the actual page size.
+    //! @param [in] numa_node Index of the NUMA node to bind the memory to. NPOS means no binding.
+    //! @param [out] page_error System error code when the requested huge pages are not available, SYS_SUCCESS otherwise.
+    //! @param [out] numa_error System error code when the memory cannot be bound to @a numa_node, SYS_SUCCESS otherwise.
+    //! @return Address of the allocated memory or a null pointer if the memory cannot be allocated.
+    //! @see FreeMemoryPages()
+    //!
+    TSDUCKDLL void* AllocateMemoryPages(size_t& size, size_t& page_size, size_t numa_node, SysErrorCode& page_error, SysErrorCode& numa_error);
+
+    //!
+    //! Free an area of memory pages which was allocated by AllocateMemoryPages().
+    //! @param [in] address Address of the memory area.
+    //! @param [in] size Allocated size in bytes, as returned by AllocateMemoryPages().
+    //!
+    TSDUCKDLL void FreeMemoryPages(void* address, size_t size);
+
+    //!
+    //! Get the NUMA node where a memory page is physically located.
+    //! @param [in] address Any address in the memory page. The page must be already allocated.
+    //! @return The NUMA node index or NPOS if unknown or not supported on this system.
+    //!
+    TSDUCKDLL size_t GetMemoryNumaNode(const void* address);
+
     //!
     //! Ensure that writing to a broken pipe does not kill the current process.
     //!
@@ -728,6 +763,21 @@ namespace ts {
     //!
     TSDUCKDLL void IgnorePipeSignal();
 
+    //!
+    //! Raise the maximum number of open files in the current process.
+    //!
+    //! Applications which handle thousands of simultaneous network connections
+    //! need more file descriptors than the default limit of most UNIX systems
+    //! (typically 1024). The soft limit is raised, up to the hard limit.
+    //!
+    //! <strong>Windows systems:</strong> This function does nothing.
+    //!
+    //! @param [in] count Requested number of open files. When zero, raise the limit to the maximum.
+    //! @param [in,out] report Where to report errors.
+    //! @return True if the resulting limit is at least @a count, false otherwise.
+    //!
+    TSDUCKDLL bool RaiseOpenFilesLimit(size_t count = 0, Report& report = CERR);
+
     //!
     //! Check if the standard input is a terminal.
     //! @return True if the standard input is a terminal.
@@ -54,10 +54,10 @@ ts::TextParser::TextParser(const UString& text, Report& report) :
     loadDocument(text);
 }
 
-ts::TextParser::Position::Position(const UStringList& textLines) :
+ts::TextParser::Position::Position(const UStringList& textLines, size_t firstLineNumber) :
     _lines(&textLines),
     _curLine(textLines.begin()),
-    _curLineNumber(1),
+    _curLineNumber(firstLineNumber),
     _curIndex(0)
 {
 }
@@ -82,10 +82,10 @@ void ts::TextParser::clear()
 // Load the document to parse.
 //----------------------------------------------------------------------------
 
-void ts::TextParser::loadDocument(const UStringList& lines)
+void ts::TextParser::loadDocument(const UStringList& lines, size_t firstLineNumber)
 {
     _lines.clear();
-    _pos = Position(lines);
+    _pos = Position(lines, firstLineNumber);
 }
 
 void ts::TextParser::loadDocument(const UString& text)
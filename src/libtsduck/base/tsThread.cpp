@@ -222,7 +222,9 @@ bool ts::Thread::start()
     }
 
     // Set the thread priority
-    ::BOOL status = ::SetThreadPriority(_handle, ThreadAttributes::Win32Priority(_attributes._priority));
+    // There is no real-time scheduling policy per thread, use the highest priority instead.
+    const int priority = _attributes._schedPolicy == ThreadAttributes::SchedulingPolicy::DEFAULT ? _attributes._priority : ThreadAttributes::GetMaximumPriority();
+    ::BOOL status = ::SetThreadPriority(_handle, ThreadAttributes::Win32Priority(priority));
     if (status == 0) {
         ::CloseHandle(_handle);
         return false;
@@ -254,8 +256,11 @@ bool ts::Thread::start()
         }
     }
 
-    // Set scheduling policy identical as current process.
-    if (::pthread_attr_setschedpolicy(&attr, ThreadAttributes::PthreadSchedulingPolicy()) != 0) {
+    // Set scheduling policy, identical as current process by default.
+    int policy = 0;
+    int priority = 0;
+    _attributes.pthreadScheduling(policy, priority);
+    if (::pthread_attr_setschedpolicy(&attr, policy) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
     }
@@ -263,7 +268,7 @@ bool ts::Thread::start()
     // Set scheduling priority.
     ::sched_param sparam;
     TS_ZERO(sparam);
-    sparam.sched_priority = _attributes._priority;
+    sparam.sched_priority = priority;
     if (::pthread_attr_setschedparam(&attr, &sparam) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
@@ -275,6 +280,23 @@ bool ts::Thread::start()
         return false;
     }
 
+#if defined(TS_LINUX)
+    // Set CPU affinity.
+    if (!_attributes._affinity.empty()) {
+        ::cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (auto cpu : _attributes._affinity) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (::pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0) {
+            ::pthread_attr_destroy(&attr);
+            return false;
+        }
+    }
+#endif
+
     // Create the thread
     if (::pthread_create(&_pthread, &attr, Thread::ThreadProc, this) != 0) {
         ::pthread_attr_destroy(&attr);
@@ -31,6 +31,14 @@
 TSDUCK_SOURCE;
 
 
+// Enumeration description of SchedulingPolicy.
+const ts::TypedEnumeration<ts::ThreadAttributes::SchedulingPolicy> ts::ThreadAttributes::SchedulingPolicyEnum({
+    {u"default", ts::ThreadAttributes::SchedulingPolicy::DEFAULT},
+    {u"fifo",    ts::ThreadAttributes::SchedulingPolicy::FIFO},
+    {u"rr",      ts::ThreadAttributes::SchedulingPolicy::ROUND_ROBIN},
+});
+
+
 //----------------------------------------------------------------------------
 // Default operating system priorities
 //----------------------------------------------------------------------------
@@ -113,6 +121,35 @@ int ts::ThreadAttributes::PthreadSchedulingPolicy()
     return pol >= 0 ? pol : SCHED_OTHER;
 #endif
 }
+
+
+//----------------------------------------------------------------------------
+// This method is used by the implementation of ts::Thread on Unix to obtain
+// the actual scheduling policy and priority for this thread.
+//----------------------------------------------------------------------------
+
+void ts::ThreadAttributes::pthreadScheduling(int& policy, int& priority) const
+{
+    switch (_schedPolicy) {
+        case SchedulingPolicy::FIFO:
+            policy = SCHED_FIFO;
+            break;
+        case SchedulingPolicy::ROUND_ROBIN:
+            policy = SCHED_RR;
+            break;
+        case SchedulingPolicy::DEFAULT:
+        default:
+            // Same policy as current process, priority already in the right range.
+            policy = PthreadSchedulingPolicy();
+            priority = _priority;
+            return;
+    }
+
+    // Real-time priority, within the range of the real-time policy.
+    const int prioMin = ::sched_get_priority_min(policy);
+    const int prioMax = std::max(prioMin, ::sched_get_priority_max(policy));
+    priority = _schedPriority == 0 ? (prioMin + prioMax) / 2 : std::max(prioMin, std::min(prioMax, _schedPriority));
+}
 #endif
 
 
@@ -154,7 +191,10 @@ int ts::ThreadAttributes::Win32Priority(int priority)
 ts::ThreadAttributes::ThreadAttributes() :
     _stackSize(0),
     _deleteWhenTerminated(false),
-    _priority(0)
+    _priority(0),
+    _affinity(),
+    _schedPolicy(SchedulingPolicy::DEFAULT),
+    _schedPriority(0)
 {
     if (!_priorityInitialized) {
         InitializePriorities();
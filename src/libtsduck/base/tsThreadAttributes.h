@@ -33,7 +33,7 @@
 //----------------------------------------------------------------------------
 
 #pragma once
-#include "tsPlatform.h"
+#include "tsTypedEnumeration.h"
 
 namespace ts {
     //!
@@ -237,10 +237,99 @@ namespace ts {
             return GetPriority(_maximumPriority);
         }
 
+        //!
+        //! Set the CPU affinity of the thread.
+        //! The thread is allowed to run on the specified CPU's only.
+        //! This attribute is implemented on Linux only. It is ignored on other systems.
+        //! @param [in] cpus Set of CPU indexes. An empty set means no affinity,
+        //! the thread can run on all CPU's. This is the default.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setAffinity(const std::set<size_t>& cpus)
+        {
+            _affinity = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity of the thread.
+        //! @return A constant reference to the set of CPU's on which the thread is allowed to run.
+        //! An empty set means no affinity.
+        //! @see setAffinity()
+        //!
+        const std::set<size_t>& getAffinity() const
+        {
+            return _affinity;
+        }
+
+        //!
+        //! Scheduling policy of a thread.
+        //!
+        enum class SchedulingPolicy {
+            DEFAULT,      //!< Same scheduling policy as the current process, use the thread priority.
+            FIFO,         //!< Real-time first-in first-out policy (SCHED_FIFO).
+            ROUND_ROBIN,  //!< Real-time round-robin policy (SCHED_RR).
+        };
+
+        //!
+        //! Set an explicit scheduling policy for the thread.
+        //!
+        //! By default, a thread uses the same scheduling policy as the current process.
+        //! With a real-time policy, the thread preempts all threads using the default
+        //! policy, as long as it is ready to run. On Linux, this typically requires
+        //! root privileges or the capability @c CAP_SYS_NICE. Without these privileges,
+        //! the thread cannot be started.
+        //!
+        //! On Windows, there is no real-time policy for individual threads.
+        //! A real-time policy is translated into the highest thread priority.
+        //!
+        //! @param [in] policy The scheduling policy for the thread.
+        //! @param [in] priority The real-time priority for the thread, ignored with SchedulingPolicy::DEFAULT.
+        //! The value is relative to the range of priorities of the real-time policy (1 to 99 on Linux).
+        //! Zero means the middle of the range. If the value is outside the range of the policy,
+        //! the nearest valid value is used.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setSchedulingPolicy(SchedulingPolicy policy, int priority = 0)
+        {
+            _schedPolicy = policy;
+            _schedPriority = policy == SchedulingPolicy::DEFAULT ? 0 : priority;
+            return *this;
+        }
+
+        //!
+        //! Get the scheduling policy of the thread.
+        //! @return The scheduling policy of the thread.
+        //! @see setSchedulingPolicy()
+        //!
+        SchedulingPolicy getSchedulingPolicy() const
+        {
+            return _schedPolicy;
+        }
+
+        //!
+        //! Get the real-time priority of the thread.
+        //! @return The real-time priority of the thread, as specified in setSchedulingPolicy().
+        //! Zero means the middle of the range of the policy.
+        //! @see setSchedulingPolicy()
+        //!
+        int getSchedulingPriority() const
+        {
+            return _schedPriority;
+        }
+
+        //!
+        //! Enumeration description of SchedulingPolicy.
+        //!
+        static const TypedEnumeration<SchedulingPolicy> SchedulingPolicyEnum;
+
     private:
         size_t _stackSize;
         bool _deleteWhenTerminated;
         int _priority;
+        std::set<size_t> _affinity;
+        SchedulingPolicy _schedPolicy;
+        int _schedPriority;
 
         //
         // These fields describe the operating system priority range.
@@ -283,6 +372,10 @@ namespace ts {
         // This static method is used by the implementation of ts::Thread on Unix
         // to obtain the scheduling policy to use for this process.
         static int PthreadSchedulingPolicy();
+
+        // This method is used by the implementation of ts::Thread on Unix to obtain
+        // the actual scheduling policy and priority for this thread.
+        void pthreadScheduling(int& policy, int& priority) const;
 #endif
     };
 }
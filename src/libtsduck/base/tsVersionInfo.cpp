@@ -37,6 +37,10 @@
 #include "tsDektecUtils.h"
 #include "tsWebRequest.h"
 #include "tsSRTSocket.h"
+#include "tsSysInfo.h"
+#include "tsCRC32.h"
+#include "tsAES.h"
+#include "tsDVBCSA2.h"
 TSDUCK_SOURCE;
 
 // Exported version of the TSDuck library.
@@ -56,6 +60,7 @@ const ts::Enumeration ts::VersionInfo::FormatEnum({
     {u"http",     int(ts::VersionInfo::Format::HTTP)},
     {u"compiler", int(ts::VersionInfo::Format::COMPILER)},
     {u"srt",      int(ts::VersionInfo::Format::SRT)},
+    {u"cpu",      int(ts::VersionInfo::Format::CPU)},
     {u"all",      int(ts::VersionInfo::Format::ALL)},
 });
 
@@ -251,12 +256,26 @@ ts::UString ts::VersionInfo::GetVersion(Format format, const UString& applicatio
             // The version of the SRT library.
             return SRTSocket::GetLibraryVersion();
         }
+        case Format::CPU: {
+            // The CPU features and the implementations which use them.
+            const SysInfo* const sys = SysInfo::Instance();
+            UString features(SysInfo::CPUFeatureEnum.bitMaskNames(int(sys->cpuFeatures())));
+            if (features.empty()) {
+                features = u"none";
+            }
+            const uint32_t disabled = sys->cpuDetectedFeatures() & ~sys->cpuFeatures();
+            if (disabled != 0) {
+                features.format(u" (disabled: %s)", {SysInfo::CPUFeatureEnum.bitMaskNames(int(disabled))});
+            }
+            return features + u", CRC32: " + CRC32::Implementation() + u", AES: " + AES::Implementation() + u", DVB-CSA2: " + DVBCSA2::BatchImplementation();
+        }
         case Format::ALL: {
             return GetVersion(Format::LONG, applicationName) + LINE_FEED +
                 u"Built " + GetVersion(Format::DATE) + LINE_FEED +
                 u"Using " + GetVersion(Format::COMPILER) + LINE_FEED +
                 u"Web library: " + GetVersion(Format::HTTP) + LINE_FEED +
                 u"SRT library: " + GetVersion(Format::SRT) + LINE_FEED +
+                u"CPU features: " + GetVersion(Format::CPU) + LINE_FEED +
                 u"Dektec: " + GetVersion(Format::DEKTEC);
         }
         default: {
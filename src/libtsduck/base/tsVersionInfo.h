@@ -86,6 +86,7 @@ namespace ts {
             HTTP,     //!< Version of HTTP library which is used.
             COMPILER, //!< Version of the compiler which was used to build the code.
             SRT,      //!< Version of SRT library which is used.
+            CPU,      //!< CPU features and selected optimized implementations.
             ALL,      //!< Multi-line output with full details.
         };
 
@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsXXHash.h"
+#include "tsMemory.h"
+#include "tsRotate.h"
+TSDUCK_SOURCE;
+
+namespace {
+    // Constants of the xxHash64 algorithm.
+    constexpr uint64_t PRIME64_1 = TS_UCONST64(0x9E3779B185EBCA87);
+    constexpr uint64_t PRIME64_2 = TS_UCONST64(0xC2B2AE3D27D4EB4F);
+    constexpr uint64_t PRIME64_3 = TS_UCONST64(0x165667B19E3779F9);
+    constexpr uint64_t PRIME64_4 = TS_UCONST64(0x85EBCA77C2B2AE63);
+    constexpr uint64_t PRIME64_5 = TS_UCONST64(0x27D4EB2F165667C5);
+
+    // Accumulate one 64-bit input lane.
+    inline uint64_t Round(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME64_2;
+        acc = ts::ROL64c(acc, 31);
+        return acc * PRIME64_1;
+    }
+
+    // Merge one accumulator into the hash.
+    inline uint64_t MergeRound(uint64_t hash, uint64_t acc)
+    {
+        hash ^= Round(0, acc);
+        return hash * PRIME64_1 + PRIME64_4;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the xxHash64 of a data area.
+//----------------------------------------------------------------------------
+
+uint64_t ts::XXHash64(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* const end = p + size;
+    uint64_t hash = 0;
+
+    if (size >= 32) {
+        // Process stripes of 32 bytes in 4 independent accumulators.
+        const uint8_t* const limit = end - 32;
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+        do {
+            v1 = Round(v1, GetUInt64LE(p));
+            v2 = Round(v2, GetUInt64LE(p + 8));
+            v3 = Round(v3, GetUInt64LE(p + 16));
+            v4 = Round(v4, GetUInt64LE(p + 24));
+            p += 32;
+        } while (p <= limit);
+        hash = ROL64c(v1, 1) + ROL64c(v2, 7) + ROL64c(v3, 12) + ROL64c(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else {
+        hash = seed + PRIME64_5;
+    }
+
+    hash += uint64_t(size);
+
+    // Process the remaining bytes.
+    for (; p + 8 <= end; p += 8) {
+        hash ^= Round(0, GetUInt64LE(p));
+        hash = ROL64c(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        hash ^= uint64_t(GetUInt32LE(p)) * PRIME64_1;
+        hash = ROL64c(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= uint64_t(*p) * PRIME64_5;
+        hash = ROL64c(hash, 11) * PRIME64_1;
+    }
+
+    // Final avalanche.
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
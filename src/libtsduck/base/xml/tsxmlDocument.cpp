@@ -101,9 +101,10 @@ ts::UString ts::xml::Document::DisplayFileName(const UString& name, bool stdInpu
 // Parse an XML document.
 //----------------------------------------------------------------------------
 
-bool ts::xml::Document::parse(const UStringList& lines)
+bool ts::xml::Document::parse(const UStringList& lines, size_t firstLineNumber)
 {
-    TextParser parser(lines, report());
+    TextParser parser(report());
+    parser.loadDocument(lines, firstLineNumber);
     return parseNode(parser, nullptr);
 }
 
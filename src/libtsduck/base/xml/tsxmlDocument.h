@@ -62,9 +62,11 @@ namespace ts {
             //!
             //! Parse an XML document.
             //! @param [in] lines List of text lines forming the XML document.
+            //! @param [in] firstLineNumber Line number of the first line in @a lines, as reported in error
+            //! messages and in the nodes. This is useful when @a lines is only a fragment of a larger file.
             //! @return True on success, false on error.
             //!
-            bool parse(const UStringList& lines);
+            bool parse(const UStringList& lines, size_t firstLineNumber = 1);
 
             //!
             //! Parse an XML document.
@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsxmlJSONConverter.h"
+#include "tsxmlJSONSerializer.h"
 #include "tsxmlElement.h"
 #include "tsxmlText.h"
 #include "tsjsonArray.h"
@@ -46,7 +47,10 @@ const ts::UString ts::xml::JSONConverter::HashUnnamed(u"_unnamed");
 //----------------------------------------------------------------------------
 
 ts::xml::JSONConverter::JSONConverter(Report& report) :
-    ModelDocument(report)
+    ModelDocument(report),
+    _model_elements(),
+    _model_attributes(),
+    _model_hexa()
 {
 }
 
@@ -55,6 +59,45 @@ ts::xml::JSONConverter::~JSONConverter()
 }
 
 
+//----------------------------------------------------------------------------
+// The cache of model lookups is invalidated when the model is modified.
+//----------------------------------------------------------------------------
+
+void ts::xml::JSONConverter::clear()
+{
+    _model_elements.clear();
+    _model_attributes.clear();
+    _model_hexa.clear();
+    ModelDocument::clear();
+}
+
+bool ts::xml::JSONConverter::parseNode(TextParser& parser, const Node* parent)
+{
+    _model_elements.clear();
+    _model_attributes.clear();
+    _model_hexa.clear();
+    return ModelDocument::parseNode(parser, parent);
+}
+
+
+//----------------------------------------------------------------------------
+// Find a child element in the model, using the cache.
+//----------------------------------------------------------------------------
+
+const ts::xml::Element* ts::xml::JSONConverter::findModelChild(const Element* model, const UString& name) const
+{
+    if (model == nullptr) {
+        return nullptr;
+    }
+    const ModelKey key(model, name);
+    auto it = _model_elements.find(key);
+    if (it == _model_elements.end()) {
+        it = _model_elements.insert(std::make_pair(key, findModelElement(model, name))).first;
+    }
+    return it->second;
+}
+
+
 //----------------------------------------------------------------------------
 // Convert an XML document into a JSON object.
 //----------------------------------------------------------------------------
@@ -88,84 +131,133 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertToJSON(const Document& source,
 
 
 //----------------------------------------------------------------------------
-// Convert an XML tree of elements.
+// Convert a top-level XML element into JSON and print it.
 //----------------------------------------------------------------------------
 
-ts::json::ValuePtr ts::xml::JSONConverter::convertElementToJSON(const Element* model, const Element* source, const Tweaks& xml_tweaks) const
+void ts::xml::JSONConverter::printToJSON(TextFormatter& output, const Element* source) const
 {
-    // Build the JSON object for the node.
-    json::ValuePtr jobj(new json::Object());
-    CheckNonNull(jobj.pointer());
-    jobj->add(HashName, source->name());
-
-    // Get all attributes of the XML element.
-    std::map<UString,UString> attributes;
-    source->getAttributes(attributes);
+    if (source != nullptr) {
+        // Use the model only if the model root has the same name as the parent of the source.
+        const Element* parent = dynamic_cast<const Element*>(source->parent());
+        JSONSerializer json(output, *this, parent == nullptr ? UString() : parent->name());
+        json.addElement(source);
+    }
+}
 
-    // Add attributes in the JSON object.
-    for (auto it = attributes.begin(); it != attributes.end(); ++it) {
 
-        // JSON value of the attribute.
-        json::ValuePtr jvalue;
-        int64_t intValue = 0;
-        bool boolValue = false;
+//----------------------------------------------------------------------------
+// Get the JSON type of an attribute value.
+//----------------------------------------------------------------------------
 
-        // Get description of this attribute in the model.
-        UString description;
-        bool intModel = false;
-        bool boolModel = false;
-        if (model != nullptr) {
+ts::json::Type ts::xml::JSONConverter::attributeType(const Element* model, Report& report, const UString& element, size_t line, const UString& name, const UString& value, const Tweaks& xml_tweaks, int64_t& int_value) const
+{
+    bool bool_value = false;
+
+    // Get description of this attribute in the model.
+    json::Type model_type = json::Type::String;
+    if (model != nullptr) {
+        const ModelKey key(model, name);
+        const auto it = _model_attributes.find(key);
+        if (it != _model_attributes.end()) {
+            model_type = it->second;
+        }
+        else {
             // Get description, empty string without error if not found.
-            model->getAttribute(description, it->first, false);
+            UString description;
+            model->getAttribute(description, name, false);
             description.trim(true, false, false);
-            intModel = description.startWith(u"uint", CASE_INSENSITIVE) || description.startWith(u"int", CASE_INSENSITIVE);
-            boolModel = description.startWith(u"bool", CASE_INSENSITIVE);
-        }
-
-        // Try to convert as an integer or boolean if defined as such by the model.
-        if (intModel) {
-            // Should be an integer according to the model.
-            if (it->second.toInteger(intValue, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
-                if (intValue < -TS_CONST64(0xFFFFFFFF)) {
-                    // This is a "very negative" value. This is typically a large unsigned hexadecimal value
-                    // which will not be handled correctly when reading back the JSON file. We cannot use
-                    // hexadecimal literals in JSON (new in JSON 5), so we leave it as a string.
-                    jvalue = new json::String(it->second);
-                }
-                else {
-                    // Acceptable integer.
-                    jvalue = new json::Number(intValue);
-                }
+            if (description.startWith(u"uint", CASE_INSENSITIVE) || description.startWith(u"int", CASE_INSENSITIVE)) {
+                model_type = json::Type::Number;
             }
-            else {
-                source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be an integer", {it->first, source->name(), source->lineNumber(), it->second});
+            else if (description.startWith(u"bool", CASE_INSENSITIVE)) {
+                model_type = json::Type::True;
             }
+            _model_attributes.insert(std::make_pair(key, model_type));
         }
-        else if (boolModel) {
-            // Should be a boolean according to the model.
-            if (it->second.toBool(boolValue)) {
-                jvalue = json::Bool(boolValue);
-            }
-            else {
-                source->report().warning(u"attribute '%s' in <%s> line %d is '%s' but should be a boolean", {it->first, source->name(), source->lineNumber(), it->second});
-            }
-        }
-
-        // Try to enforce integer of boolean value if specified on command line.
-        if (jvalue.isNull() && xml_tweaks.x2jEnforceInteger && !intModel && it->second.toInteger(intValue, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
-            jvalue = new json::Number(intValue);
+    }
+    const bool int_model = model_type == json::Type::Number;
+    const bool bool_model = model_type == json::Type::True;
+
+    // Try to convert as an integer or boolean if defined as such by the model.
+    if (int_model) {
+        // Should be an integer according to the model.
+        if (value.toInteger(int_value, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+            // A "very negative" value is typically a large unsigned hexadecimal value which will not be
+            // handled correctly when reading back the JSON file. We cannot use hexadecimal literals in
+            // JSON (new in JSON 5), so we leave it as a string.
+            return int_value < -TS_CONST64(0xFFFFFFFF) ? json::Type::String : json::Type::Number;
         }
-        if (jvalue.isNull() && xml_tweaks.x2jEnforceBoolean && !boolModel && it->second.toBool(boolValue)) {
-            jvalue = json::Bool(boolValue);
+        report.warning(u"attribute '%s' in <%s> line %d is '%s' but should be an integer", {name, element, line, value});
+    }
+    else if (bool_model) {
+        // Should be a boolean according to the model.
+        if (value.toBool(bool_value)) {
+            return bool_value ? json::Type::True : json::Type::False;
         }
+        report.warning(u"attribute '%s' in <%s> line %d is '%s' but should be a boolean", {name, element, line, value});
+    }
 
-        // Use a string value by default.
-        if (jvalue.isNull()) {
-            jvalue = new json::String(it->second);
-        }
+    // Try to enforce integer of boolean value if specified on command line.
+    if (xml_tweaks.x2jEnforceInteger && !int_model && value.toInteger(int_value, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+        return json::Type::Number;
+    }
+    if (xml_tweaks.x2jEnforceBoolean && !bool_model && value.toBool(bool_value)) {
+        return bool_value ? json::Type::True : json::Type::False;
+    }
+
+    // Use a string value by default.
+    return json::Type::String;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the text nodes of a model element contain hexadecimal data.
+//----------------------------------------------------------------------------
+
+bool ts::xml::JSONConverter::isHexaText(const Element* model) const
+{
+    if (model == nullptr) {
+        return false;
+    }
+    auto it = _model_hexa.find(model);
+    if (it == _model_hexa.end()) {
+        UString textModel;
+        model->getText(textModel, true);
+        it = _model_hexa.insert(std::make_pair(model, textModel.startWith(u"hexa", CASE_INSENSITIVE))).first;
+    }
+    return it->second;
+}
+
+
+//----------------------------------------------------------------------------
+// Convert an XML tree of elements.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::xml::JSONConverter::convertElementToJSON(const Element* model, const Element* source, const Tweaks& xml_tweaks) const
+{
+    // Build the JSON object for the node.
+    json::ValuePtr jobj(new json::Object());
+    CheckNonNull(jobj.pointer());
+    jobj->add(HashName, source->name());
 
-        // Add the attribute in the JSON object.
-        jobj->add(it->first, jvalue);
+    // Add all attributes of the XML element in the JSON object.
+    const Element::AttributeMap& attributes(source->attributes());
+    for (auto it = attributes.begin(); it != attributes.end(); ++it) {
+        int64_t intValue = 0;
+        switch (attributeType(model, source->report(), source->name(), source->lineNumber(), it->first, it->second.value(), xml_tweaks, intValue)) {
+            case json::Type::Number:
+                jobj->add(it->first, json::ValuePtr(new json::Number(intValue)));
+                break;
+            case json::Type::True:
+                jobj->add(it->first, json::Bool(true));
+                break;
+            case json::Type::False:
+                jobj->add(it->first, json::Bool(false));
+                break;
+            default:
+                jobj->add(it->first, json::ValuePtr(new json::String(it->second.value())));
+                break;
+        }
     }
 
     // Process the list of children, if any.
@@ -188,8 +280,7 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertChildrenToJSON(const Element*
     CheckNonNull(jchildren.pointer());
 
     // Content of the text children in the model.
-    UString textModel;
-    bool getTextModel = model != nullptr;
+    bool getTextModel = true;
     bool hexaModel = false;
 
     // Loop on all children nodes.
@@ -204,7 +295,7 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertChildrenToJSON(const Element*
 
         if (elem != nullptr) {
             // Convert an element. Add a JSON child object in the array of JSON children.
-            jchildren->set(convertElementToJSON(findModelElement(model, elem->name()), elem, xml_tweaks));
+            jchildren->set(convertElementToJSON(findModelChild(model, elem->name()), elem, xml_tweaks));
         }
         else if (text != nullptr) {
             // Convert a text.
@@ -212,8 +303,7 @@ ts::json::ValuePtr ts::xml::JSONConverter::convertChildrenToJSON(const Element*
             // Get the model description once only.
             if (getTextModel) {
                 getTextModel = false;
-                model->getText(textModel, true);
-                hexaModel = textModel.startWith(u"hexa", CASE_INSENSITIVE);
+                hexaModel = isHexaText(model);
             }
             // Trim the text content according to model and command line options.
             content.trim(hexaModel || xml_tweaks.x2jTrimText, hexaModel || xml_tweaks.x2jTrimText, hexaModel || xml_tweaks.x2jCollapseText);
@@ -97,6 +97,17 @@ namespace ts {
             //!
             json::ValuePtr convertToJSON(const Document& source, bool force_root = false) const;
 
+            //!
+            //! Convert a top-level XML element into JSON and print it, without building a JSON tree.
+            //! The printed text is identical to the print of the corresponding JSON object in the
+            //! result of convertToJSON(). To print JSON without building the XML element either,
+            //! use an xml::JSONSerializer.
+            //! @param [in,out] output Where to print the JSON object.
+            //! @param [in] source The source XML element to convert. When its parent has the same
+            //! name as the root of the model, the corresponding model element is used.
+            //!
+            void printToJSON(TextFormatter& output, const Element* source) const;
+
             //!
             //! Convert a JSON object into an XML document.
             //! Not all JSON values can be converted. Basically, only JSON objects which were previously
@@ -126,13 +137,41 @@ namespace ts {
             //!
             static const UString HashUnnamed;
 
+            // Inherited from xml::Node.
+            virtual void clear() override;
+
+        protected:
+            // Inherited from xml::Node.
+            virtual bool parseNode(TextParser& parser, const Node* parent) override;
+
         private:
+            friend class JSONSerializer;
+
+            // The conversion repeatedly looks for the same elements and attributes in the model.
+            // The results of these lookups are cached, indexed by model element and name.
+            // The caches are modified by const methods: a converter shall be used by one thread only.
+            typedef std::pair<const Element*, UString> ModelKey;
+            mutable std::map<ModelKey, const Element*> _model_elements;   // Child elements in the model.
+            mutable std::map<ModelKey, json::Type>     _model_attributes; // Attribute types in the model: Number, True or String.
+            mutable std::map<const Element*, bool>     _model_hexa;       // Model elements with hexadecimal text.
+
+            // Find a child element in the model, using the cache.
+            const Element* findModelChild(const Element* model, const UString& name) const;
+
             // Convert an XML tree of elements. Null pointer on error or if not convertible.
             json::ValuePtr convertElementToJSON(const Element* model, const Element* source, const Tweaks&) const;
 
             // Convert all children of an element as a JSON array. Null pointer on error or if not convertible.
             json::ValuePtr convertChildrenToJSON(const Element* model, const Element* parent, const Tweaks&) const;
 
+            // Get the JSON type of an attribute value: String, Number, True or False.
+            // When the type is Number, the value is returned in int_value.
+            // The report, element name and line number are used for warnings only.
+            json::Type attributeType(const Element* model, Report& report, const UString& element, size_t line, const UString& name, const UString& value, const Tweaks&, int64_t& int_value) const;
+
+            // Check if the text nodes of a model element contain hexadecimal data, using the cache.
+            bool isHexaText(const Element* model) const;
+
             // Build a valid XML element name from a JSON string.
             static UString ToElementName(const UString& str);
 
@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlJSONSerializer.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::JSONSerializer::JSONSerializer(TextFormatter& output, const JSONConverter& converter, const UString& parent_name, size_t top_depth) :
+    Serializer(top_depth),
+    _json(output),
+    _converter(converter),
+    _top_model(converter.rootElement()),
+    _models()
+{
+    // Use the model only if the model root has the same name as the parent of the top-level elements.
+    if (_top_model != nullptr && !_top_model->name().similar(parent_name)) {
+        _top_model = nullptr;
+    }
+}
+
+ts::xml::JSONSerializer::~JSONSerializer()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Serialize elements, same format as JSONConverter::printToJSON().
+// The fields of a JSON object are printed in alphabetical order: "#name"
+// and "#nodes" always come first since attribute names cannot start with '#'.
+//----------------------------------------------------------------------------
+
+void ts::xml::JSONSerializer::writeStart(const Frame& frame, bool empty)
+{
+    const Element* model = _converter.findModelChild(_models.empty() ? _top_model : _models.back(), frame.name);
+
+    _json.startObject();
+    _json.key(JSONConverter::HashName);
+    _json.string(frame.name);
+
+    if (empty) {
+        writeAttributes(frame, model);
+        _json.endObject();
+    }
+    else {
+        _json.key(JSONConverter::HashNodes);
+        _json.startArray();
+        _models.push_back(model);
+    }
+}
+
+void ts::xml::JSONSerializer::writeEnd(const Frame& frame)
+{
+    _json.endArray();
+    const Element* model = nullptr;
+    if (!_models.empty()) {
+        model = _models.back();
+        _models.pop_back();
+    }
+    writeAttributes(frame, model);
+    _json.endObject();
+}
+
+void ts::xml::JSONSerializer::writeAttributes(const Frame& frame, const Element* model)
+{
+    // The attributes are printed in the order of their keys in an element, ie. lowercase names.
+    std::map<UString, const Attribute*> attributes;
+    for (auto it = frame.attributes.begin(); it != frame.attributes.end(); ++it) {
+        attributes[it->name().toLower()] = &*it;
+    }
+
+    const Tweaks& tweaks(_converter.tweaks());
+    for (auto it = attributes.begin(); it != attributes.end(); ++it) {
+        const UString& value(it->second->value());
+        _json.key(it->first);
+        int64_t intValue = 0;
+        switch (_converter.attributeType(model, _converter.report(), frame.name, 0, it->first, value, tweaks, intValue)) {
+            case json::Type::Number:
+                _json.number(intValue);
+                break;
+            case json::Type::True:
+                _json.boolean(true);
+                break;
+            case json::Type::False:
+                _json.boolean(false);
+                break;
+            default:
+                _json.string(value);
+                break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Serialize a text node, same format as JSONConverter::printToJSON().
+//----------------------------------------------------------------------------
+
+void ts::xml::JSONSerializer::writeText(const UString& value, bool)
+{
+    const Tweaks& tweaks(_converter.tweaks());
+    const bool hexa = !_models.empty() && _converter.isHexaText(_models.back());
+    UString text(value);
+    text.trim(hexa || tweaks.x2jTrimText, hexa || tweaks.x2jTrimText, hexa || tweaks.x2jCollapseText);
+    _json.string(text);
+}
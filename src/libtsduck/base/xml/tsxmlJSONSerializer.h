@@ -0,0 +1,89 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Push-style XML serializer which prints the equivalent JSON text.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlSerializer.h"
+#include "tsxmlJSONConverter.h"
+#include "tsjsonStreamWriter.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Push-style XML serializer which directly prints the equivalent JSON text.
+        //! @ingroup xml
+        //!
+        //! The XML structure is converted into JSON using the rules of xml::JSONConverter,
+        //! without building an XML tree or a JSON tree. Each top-level element is printed
+        //! as one JSON object. The printed text is identical to the print of the corresponding
+        //! JSON object in the result of xml::JSONConverter::convertToJSON().
+        //!
+        class TSDUCKDLL JSONSerializer : public Serializer
+        {
+            TS_NOBUILD_NOCOPY(JSONSerializer);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] output The text formatter where the JSON text is printed.
+            //! The referenced object must remain valid as long as this object.
+            //! @param [in] converter The XML-to-JSON converter which provides the XML model and the
+            //! conversion tweaks. The referenced object must remain valid as long as this object.
+            //! @param [in] parent_name Name of the XML parent of the top-level elements. The model of the
+            //! converter is used only when its root element has the same name, typically "tsduck".
+            //! @param [in] top_depth Depth in an XML document of the top-level elements.
+            //! The default value is the depth of the tables in a TSDuck XML file.
+            //!
+            JSONSerializer(TextFormatter& output, const JSONConverter& converter, const UString& parent_name, size_t top_depth = 2);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~JSONSerializer() override;
+
+        protected:
+            // Inherited from Serializer.
+            virtual void writeStart(const Frame& frame, bool empty) override;
+            virtual void writeEnd(const Frame& frame) override;
+            virtual void writeText(const UString& text, bool trimmable) override;
+
+        private:
+            json::StreamWriter          _json;       // JSON output.
+            const JSONConverter&        _converter;  // XML model and tweaks.
+            const Element*              _top_model;  // Model of the parent of the top-level elements.
+            std::vector<const Element*> _models;     // Model of each started element.
+
+            // Print the attributes of an element, in the order of the attribute map of an element.
+            void writeAttributes(const Frame& frame, const Element* model);
+        };
+    }
+}
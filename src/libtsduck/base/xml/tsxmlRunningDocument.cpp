@@ -108,6 +108,29 @@ void ts::xml::RunningDocument::flush()
 }
 
 
+//----------------------------------------------------------------------------
+// Start and end an element which is directly printed by the application.
+//----------------------------------------------------------------------------
+
+ts::TextFormatter* ts::xml::RunningDocument::startElement()
+{
+    if (rootElement() == nullptr) {
+        return nullptr;
+    }
+    // Print the document header and open the root the first time.
+    if (!_open_root) {
+        flush();
+    }
+    _text << ts::margin;
+    return &_text;
+}
+
+void ts::xml::RunningDocument::endElement()
+{
+    _text << std::endl;
+}
+
+
 //----------------------------------------------------------------------------
 // Close the running document.
 //----------------------------------------------------------------------------
@@ -84,6 +84,21 @@ namespace ts {
             //!
             void flush();
 
+            //!
+            //! Start a new element under the document root, which is directly printed by the application.
+            //! This is an alternative to flush() when the application prints the element without building
+            //! it, typically using an xml::TextSerializer with the tweaks of this document. The XML document
+            //! header is issued with the first element. The margin is already printed. The application shall
+            //! print exactly one XML element in the returned text formatter and then call endElement().
+            //! @return Address of the text formatter to use or a null pointer if the document is not open.
+            //!
+            TextFormatter* startElement();
+
+            //!
+            //! End an element which was started using startElement().
+            //!
+            void endElement();
+
             //!
             //! Close the running document.
             //! If the XML structure is still open, it is closed.
@@ -0,0 +1,261 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlSerializer.h"
+#include "tsxmlText.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::Serializer::Frame::Frame() :
+    name(),
+    attributes(),
+    started(false),
+    first_child(nullptr)
+{
+}
+
+ts::xml::Serializer::Serializer(size_t top_depth) :
+    _top_depth(top_depth),
+    _depth(0),
+    _frames(),
+    _next_first_child(nullptr),
+    _ancestors(nullptr),
+    _fragment(nullptr)
+{
+}
+
+ts::xml::Serializer::~Serializer()
+{
+    // Deleting the root of the fake ancestors deletes all its descendants.
+    delete _ancestors;
+    _ancestors = _fragment = nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Start and end elements.
+//----------------------------------------------------------------------------
+
+void ts::xml::Serializer::startElement(const UString& name)
+{
+    // The parent element gets a child, it must be started first.
+    if (_depth > 0) {
+        commit();
+    }
+    if (_depth >= _frames.size()) {
+        _frames.resize(_depth + 1);
+    }
+    Frame& frame(_frames[_depth++]);
+    frame.name = name;
+    frame.attributes.clear();
+    frame.started = false;
+    frame.first_child = _next_first_child;
+    _next_first_child = nullptr;
+}
+
+void ts::xml::Serializer::endElement()
+{
+    if (_depth > 0) {
+        Frame& frame(_frames[_depth - 1]);
+        if (frame.first_child != nullptr) {
+            // Not an empty element, the first child will be serialized.
+            commit();
+        }
+        if (frame.started) {
+            writeEnd(frame);
+        }
+        else {
+            writeStart(frame, true);
+        }
+        _depth--;
+    }
+}
+
+void ts::xml::Serializer::close()
+{
+    while (_depth > 0) {
+        endElement();
+    }
+}
+
+void ts::xml::Serializer::commit()
+{
+    assert(_depth > 0);
+    Frame& frame(_frames[_depth - 1]);
+    if (!frame.started) {
+        frame.started = true;
+        writeStart(frame, false);
+        if (frame.first_child != nullptr) {
+            const Element* child = frame.first_child;
+            frame.first_child = nullptr;
+            addElement(child);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Set an attribute of the current element.
+//----------------------------------------------------------------------------
+
+void ts::xml::Serializer::setAttribute(const UString& name, const UString& value, bool onlyIfNotEmpty)
+{
+    // Attributes are serialized with the start of the element, they cannot be set later.
+    assert(_depth > 0);
+    assert(!_frames[_depth - 1].started);
+
+    if (_depth > 0 && (!onlyIfNotEmpty || !value.empty())) {
+        // As in an element, the attribute names are not case-sensitive and an updated attribute moves to the end.
+        std::vector<Attribute>& attributes(_frames[_depth - 1].attributes);
+        for (auto it = attributes.begin(); it != attributes.end(); ++it) {
+            if (it->name().size() == name.size() && it->name().startWith(name, CASE_INSENSITIVE)) {
+                attributes.erase(it);
+                break;
+            }
+        }
+        attributes.push_back(Attribute(name, value));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add texts inside the current element.
+//----------------------------------------------------------------------------
+
+void ts::xml::Serializer::addText(const UString& text, bool onlyNotEmpty)
+{
+    if (_depth > 0 && (!onlyNotEmpty || !text.empty())) {
+        commit();
+        writeText(text, false);
+    }
+}
+
+void ts::xml::Serializer::addHexaText(const void* data, size_t size, bool onlyNotEmpty)
+{
+    if (data == nullptr) {
+        data = "";
+        size = 0;
+    }
+    if (_depth > 0 && (size > 0 || !onlyNotEmpty)) {
+        // Same formatting as Element::addHexaText(), at the same depth in a document.
+        const size_t dep = currentDepth();
+        const UString hex(UString::Dump(data, size, UString::HEXA | UString::BPL, 2 * dep, 16));
+        commit();
+        writeText(u"\n" + hex + UString(dep == 0 ? 0 : 2 * (dep - 1), u' '), true);
+    }
+}
+
+void ts::xml::Serializer::addHexaTextChild(const UString& name, const ByteBlock& data, bool onlyNotEmpty)
+{
+    if (!data.empty() || !onlyNotEmpty) {
+        startElement(name);
+        addHexaText(data.data(), data.size());
+        endElement();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add a copy of an existing XML element.
+//----------------------------------------------------------------------------
+
+void ts::xml::Serializer::addElement(const Element* element)
+{
+    if (element != nullptr) {
+        startElement(element->name());
+        addContent(element);
+        endElement();
+    }
+}
+
+void ts::xml::Serializer::addContent(const Element* element)
+{
+    // Copy attributes in modification order, as printed by the element.
+    UStringList names;
+    element->getAttributesNamesInModificationOrder(names);
+    for (auto it = names.begin(); it != names.end(); ++it) {
+        setAttribute(*it, element->attribute(*it).value());
+    }
+
+    // Copy elements and texts.
+    for (const Node* node = element->firstChild(); node != nullptr; node = node->nextSibling()) {
+        const Element* child = dynamic_cast<const Element*>(node);
+        const Text* text = dynamic_cast<const Text*>(node);
+        if (child != nullptr) {
+            addElement(child);
+        }
+        else if (text != nullptr) {
+            commit();
+            writeText(text->value(), text->isTrimmable());
+        }
+        else {
+            // Other nodes such as comments are not serialized but the element is not empty.
+            commit();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// XML fragments, built using the DOM API.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::Serializer::startFragment()
+{
+    assert(_depth > 0);
+    assert(_fragment == nullptr);
+
+    // The fragment is built at the same depth as the current element, with fake
+    // ancestors, so that the hexadecimal texts are identically indented.
+    if (_ancestors == nullptr) {
+        _ancestors = new Element;
+        CheckNonNull(_ancestors);
+    }
+    Element* parent = _ancestors;
+    for (size_t dep = 1; dep < currentDepth(); ++dep) {
+        Element* next = parent->firstChildElement();
+        parent = next != nullptr ? next : parent->addElement(u"ancestor");
+    }
+    _fragment = parent->addElement(u"fragment");
+    return _fragment;
+}
+
+void ts::xml::Serializer::endFragment()
+{
+    if (_fragment != nullptr) {
+        addContent(_fragment);
+        // Deallocating the fragment forces its removal from its parent through the destructor.
+        delete _fragment;
+        _fragment = nullptr;
+    }
+}
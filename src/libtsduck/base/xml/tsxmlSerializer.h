@@ -0,0 +1,319 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Abstract base class for push-style XML serializers.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlElement.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Abstract base class for push-style XML serializers.
+        //! @ingroup xml
+        //!
+        //! A serializer receives an XML structure as a sequence of calls to startElement(),
+        //! setAttribute(), addText() and endElement(). The subclasses either build an XML
+        //! tree (xml::TreeSerializer) or directly print XML or JSON text (xml::TextSerializer,
+        //! xml::JSONSerializer) without building any XML tree. The printed text is identical
+        //! to the print of the equivalent XML tree.
+        //!
+        //! The attributes of an element shall be set before its first child. They are kept
+        //! in the serializer until the first child or the end of the element. As in an XML tree,
+        //! setting an attribute twice replaces its value and moves it to the end of the attributes.
+        //!
+        //! Code which builds XML elements using the DOM API can be mixed with a serializer
+        //! using startFragment() and endFragment().
+        //!
+        class TSDUCKDLL Serializer
+        {
+            TS_NOCOPY(Serializer);
+        public:
+            //!
+            //! Destructor.
+            //!
+            virtual ~Serializer();
+
+            //!
+            //! Get the number of currently open elements.
+            //! @return The number of currently open elements.
+            //!
+            size_t depth() const { return _depth; }
+
+            //!
+            //! Start a new element, as child of the current element.
+            //! @param [in] name Element name.
+            //!
+            void startElement(const UString& name);
+
+            //!
+            //! End the current element.
+            //!
+            void endElement();
+
+            //!
+            //! End all open elements.
+            //!
+            void close();
+
+            //!
+            //! Set an attribute of the current element.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //! @param [in] onlyIfNotEmpty When true, do not insert the attribute if @a value is empty.
+            //!
+            void setAttribute(const UString& name, const UString& value, bool onlyIfNotEmpty = false);
+
+            //!
+            //! Set a bool attribute of the current element.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //!
+            void setBoolAttribute(const UString& name, bool value)
+            {
+                setAttribute(name, UString::TrueFalse(value));
+            }
+
+            //!
+            //! Set an attribute with an integer value of the current element.
+            //! @tparam INT An integer type.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //! @param [in] hexa If true, use an hexadecimal representation (0x...).
+            //!
+            template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type* = nullptr>
+            void setIntAttribute(const UString& name, INT value, bool hexa = false)
+            {
+                setAttribute(name, hexa ? UString::Hexa(value) : UString::Decimal(value));
+            }
+
+            //!
+            //! Set an optional attribute with an integer value of the current element.
+            //! @tparam INT An integer type.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute optional value. If the variable is not set, no attribute is set.
+            //! @param [in] hexa If true, use an hexadecimal representation (0x...).
+            //!
+            template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type* = nullptr>
+            void setOptionalIntAttribute(const UString& name, const Variable<INT>& value, bool hexa = false)
+            {
+                if (value.set()) {
+                    setIntAttribute<INT>(name, value.value(), hexa);
+                }
+            }
+
+            //!
+            //! Set an enumeration attribute of the current element.
+            //! @param [in] definition The definition of enumeration values.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //!
+            void setEnumAttribute(const Enumeration& definition, const UString& name, int value)
+            {
+                setAttribute(name, definition.name(value));
+            }
+
+            //!
+            //! Set an enumeration attribute of the current element.
+            //! @tparam INT An integer type.
+            //! @param [in] definition The definition of enumeration values.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //!
+            template <typename INT, typename std::enable_if<std::is_integral<INT>::value>::type* = nullptr>
+            void setIntEnumAttribute(const Enumeration& definition, const UString& name, INT value)
+            {
+                setAttribute(name, definition.name(int(value), true, 2 * sizeof(INT)));
+            }
+
+            //!
+            //! Set a date/time attribute of the current element.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //!
+            void setDateTimeAttribute(const UString& name, const Time& value)
+            {
+                setAttribute(name, Attribute::DateTimeToString(value));
+            }
+
+            //!
+            //! Set a date (without hours) attribute of the current element.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //!
+            void setDateAttribute(const UString& name, const Time& value)
+            {
+                setAttribute(name, Attribute::DateToString(value));
+            }
+
+            //!
+            //! Set a time attribute of the current element in "hh:mm:ss" format.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //!
+            void setTimeAttribute(const UString& name, Second value)
+            {
+                setAttribute(name, Attribute::TimeToString(value));
+            }
+
+            //!
+            //! Add a text inside the current element.
+            //! @param [in] text Text string.
+            //! @param [in] onlyNotEmpty When true, do not add the text if the string is empty.
+            //!
+            void addText(const UString& text, bool onlyNotEmpty = false);
+
+            //!
+            //! Add a text containing hexadecimal data inside the current element.
+            //! The text is formatted as by xml::Element::addHexaText().
+            //! @param [in] data Address of binary data.
+            //! @param [in] size Size in bytes of binary data.
+            //! @param [in] onlyNotEmpty When true, do not add the text if the data are empty.
+            //!
+            void addHexaText(const void* data, size_t size, bool onlyNotEmpty = false);
+
+            //!
+            //! Add a text containing hexadecimal data inside the current element.
+            //! @param [in] data Binary data.
+            //! @param [in] onlyNotEmpty When true, do not add the text if the data are empty.
+            //!
+            void addHexaText(const ByteBlock& data, bool onlyNotEmpty = false)
+            {
+                addHexaText(data.data(), data.size(), onlyNotEmpty);
+            }
+
+            //!
+            //! Add a child element containing an hexadecimal data text.
+            //! @param [in] name Name of the child element.
+            //! @param [in] data Binary data.
+            //! @param [in] onlyNotEmpty When true, do not add the child element if the data are empty.
+            //!
+            void addHexaTextChild(const UString& name, const ByteBlock& data, bool onlyNotEmpty = false);
+
+            //!
+            //! Add a copy of an existing XML element, with all its content, as child of the current element.
+            //! Only elements and texts are serialized. Comments, declarations and unknown nodes are ignored.
+            //! @param [in] element The element to copy. Can be in any document.
+            //!
+            void addElement(const Element* element);
+
+            //!
+            //! Specify an XML element to copy as first child of the next started element.
+            //! The element is copied when the next started element gets its first child
+            //! or is ended, after all its attributes.
+            //! @param [in] element The element to copy. Must remain valid until it is copied.
+            //!
+            void setNextFirstChild(const Element* element) { _next_first_child = element; }
+
+            //!
+            //! Start an XML fragment to build using the DOM API.
+            //! The returned element stands for the current element. The application may
+            //! set its attributes and add children to it. The content of the fragment is
+            //! serialized in the current element by endFragment(). Fragments cannot be nested.
+            //! @return The element of the fragment.
+            //!
+            virtual Element* startFragment();
+
+            //!
+            //! Serialize the content of the XML fragment in the current element.
+            //!
+            virtual void endFragment();
+
+        protected:
+            //!
+            //! Description of an open element.
+            //!
+            class TSDUCKDLL Frame
+            {
+            public:
+                Frame();                                //!< Constructor.
+                Frame(const Frame&) = default;          //!< Copy constructor.
+                Frame& operator=(const Frame&) = default; //!< Assignment operator.
+                UString                name;            //!< Element name.
+                std::vector<Attribute> attributes;      //!< Attributes, in modification order.
+                bool                   started;         //!< The element was started, its attributes were serialized.
+                const Element*         first_child;     //!< Element to copy before the first child, if not null.
+            };
+
+            //!
+            //! Constructor for subclasses.
+            //! @param [in] top_depth Depth in an XML document of the top-level elements, i.e. number
+            //! of ancestors, including the document. This is used to indent hexadecimal data as in
+            //! the corresponding XML document. For instance, use 2 for the tables in a TSDuck XML file.
+            //!
+            explicit Serializer(size_t top_depth);
+
+            //!
+            //! Get the depth in an XML document of the current element.
+            //! @return The number of ancestors of the current element in an XML document.
+            //!
+            size_t currentDepth() const { return _top_depth + _depth - 1; }
+
+            //!
+            //! Make sure that the current element is started, before adding a child.
+            //!
+            void commit();
+
+            //!
+            //! Serialize the start of an element, when it gets its first child or ends.
+            //! @param [in] frame Description of the element.
+            //! @param [in] empty If true, the element has no child, it is complete. Otherwise,
+            //! children will follow and writeEnd() will be called after them.
+            //!
+            virtual void writeStart(const Frame& frame, bool empty) = 0;
+
+            //!
+            //! Serialize the end of an element which has children.
+            //! @param [in] frame Description of the element.
+            //!
+            virtual void writeEnd(const Frame& frame) = 0;
+
+            //!
+            //! Serialize a text node in the current element.
+            //! @param [in] text Text content.
+            //! @param [in] trimmable The text can be trimmed (space reduction).
+            //!
+            virtual void writeText(const UString& text, bool trimmable) = 0;
+
+        private:
+            size_t             _top_depth;        // Depth of the top-level elements in an XML document.
+            size_t             _depth;            // Number of open elements.
+            std::vector<Frame> _frames;           // Open elements, reused, only the first _depth are valid.
+            const Element*     _next_first_child; // First child of the next started element.
+            Element*           _ancestors;        // Root of a chain of fake ancestors for fragments.
+            Element*           _fragment;         // Current fragment, if any.
+
+            // Serialize the content of an element in the current element.
+            void addContent(const Element* element);
+        };
+    }
+}
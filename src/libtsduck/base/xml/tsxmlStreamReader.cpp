@@ -0,0 +1,398 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "tsxmlStreamReader.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::StreamReader::StreamReader(Report& report) :
+    _report(report),
+    _file(),
+    _input(nullptr),
+    _state(State::CLOSED),
+    _lexical(Lexical::CONTENT),
+    _errors(false),
+    _closingTag(false),
+    _emptyTag(false),
+    _quote(CHAR_NULL),
+    _depth(0),
+    _line(),
+    _lineNumber(0),
+    _index(0),
+    _rootName(),
+    _rootTag(),
+    _element(),
+    _elementLine(0),
+    _elementStart(0)
+{
+}
+
+ts::xml::StreamReader::~StreamReader()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Open the document.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamReader::open(const UString& fileName)
+{
+    close();
+
+    // Specific case of the standard input.
+    if (fileName.empty() || fileName == u"-") {
+        return open(std::cin);
+    }
+
+    _file.open(fileName.toUTF8().c_str());
+    if (!_file) {
+        _report.error(u"error opening file %s", {fileName});
+        return false;
+    }
+    _report.debug(u"reading XML file %s", {fileName});
+    return open(_file);
+}
+
+bool ts::xml::StreamReader::open(std::istream& strm)
+{
+    // Close a previous file, unless we are opening it.
+    if (&strm != &_file) {
+        close();
+    }
+
+    _input = &strm;
+    _state = State::PROLOG;
+    _lexical = Lexical::CONTENT;
+    _errors = false;
+    _depth = 0;
+    _line.clear();
+    _lineNumber = 0;
+    _index = 0;
+    _rootName.clear();
+    _rootTag.clear();
+    _element.clear();
+
+    // Scan the prolog, up to the end of the root start tag.
+    // Stop at end of document if the root element is empty.
+    scanElement();
+    if (_rootName.empty() && !_errors) {
+        fatal(u"invalid XML document, no root element found");
+    }
+    return !_errors;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the document.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamReader::close()
+{
+    if (_file.is_open()) {
+        _file.close();
+    }
+    _file.clear();
+    _input = nullptr;
+    _state = State::CLOSED;
+    _line.clear();
+    _element.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next top-level element.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamReader::readElement(Document& doc)
+{
+    doc.clear();
+
+    while (_state == State::ROOT && scanElement()) {
+        // Build a small document: the root start tag on the first line of the
+        // element, so that line numbers are those of the complete document.
+        assert(!_element.empty());
+        _element.front().insert(0, _rootTag);
+        _element.back().append(u"</");
+        _element.back().append(_rootName);
+        _element.back().append(u">");
+        const bool ok = doc.parse(_element, _elementLine);
+        _element.clear();
+        if (ok) {
+            return true;
+        }
+        // The parser has already reported the error, skip this element.
+        _errors = true;
+        doc.clear();
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Read next line of text. Return false at end of file.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamReader::nextLine()
+{
+    if (_input == nullptr || !_line.getLine(*_input)) {
+        return false;
+    }
+    _lineNumber++;
+    _index = 0;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the current line contains a string at current index.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamReader::match(const UChar* str) const
+{
+    size_t i = _index;
+    while (*str != CHAR_NULL && i < _line.length() && _line[i] == *str) {
+        ++str;
+        ++i;
+    }
+    return *str == CHAR_NULL;
+}
+
+
+//----------------------------------------------------------------------------
+// Report a fatal error.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamReader::fatal(const UString& message)
+{
+    _report.error(message);
+    _errors = true;
+    _state = State::END;
+    _element.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Scan the document until the end of the root start tag or the end of the
+// next top-level element. Return false at end of document or on fatal error.
+//----------------------------------------------------------------------------
+
+bool ts::xml::StreamReader::scanElement()
+{
+    // Start index of the root start tag in current line.
+    size_t rootStart = 0;
+
+    for (;;) {
+        // Process end of line.
+        if (_index >= _line.length()) {
+            // Keep the end of line when inside a top-level element or the root start tag.
+            if (_state == State::ELEMENT) {
+                _element.push_back(_line.substr(_elementStart));
+                _elementStart = 0;
+            }
+            else if (_state == State::PROLOG && (_lexical == Lexical::TAG || _lexical == Lexical::QUOTE)) {
+                _rootTag.append(_line.substr(rootStart));
+                _rootTag.append(SPACE);
+                rootStart = 0;
+            }
+            if (!nextLine()) {
+                if (_state == State::PROLOG && _lexical == Lexical::CONTENT) {
+                    fatal(u"invalid XML document, no root element found");
+                }
+                else if (_state == State::PROLOG || _state == State::ROOT || _state == State::ELEMENT) {
+                    fatal(UString::Format(u"line %d: unexpected end of XML document", {_lineNumber}));
+                }
+                _state = State::END;
+                return false;
+            }
+            continue;
+        }
+
+        switch (_lexical) {
+            case Lexical::CONTENT: {
+                // Look for next markup. Text content is only allowed inside elements.
+                size_t next = _line.find(u'<', _index);
+                if (next == NPOS) {
+                    next = _line.length();
+                }
+                if (_state != State::ELEMENT) {
+                    for (size_t i = _index; i < next; ++i) {
+                        if (!IsSpace(_line[i])) {
+                            if (_state == State::ROOT) {
+                                // Text between top-level elements is ignored.
+                                break;
+                            }
+                            fatal(UString::Format(u"line %d: %s character sequence, invalid XML document", {_lineNumber, _state == State::END ? u"trailing" : u"unexpected"}));
+                            return false;
+                        }
+                    }
+                }
+                _index = next;
+                if (_index >= _line.length()) {
+                    break;
+                }
+                if (match(u"<!--")) {
+                    _lexical = Lexical::COMMENT;
+                    _index += 4;
+                }
+                else if (match(u"<![CDATA[")) {
+                    _lexical = Lexical::CDATA;
+                    _index += 9;
+                }
+                else if (match(u"<?")) {
+                    _lexical = Lexical::PI;
+                    _index += 2;
+                }
+                else if (match(u"<!")) {
+                    _lexical = Lexical::DTD;
+                    _index += 2;
+                }
+                else if (_state == State::END) {
+                    fatal(UString::Format(u"line %d: trailing character sequence, invalid XML document", {_lineNumber}));
+                    return false;
+                }
+                else {
+                    _closingTag = match(u"</");
+                    _emptyTag = false;
+                    _lexical = Lexical::TAG;
+                    if (!_closingTag && _state == State::ROOT) {
+                        // Start of a new top-level element.
+                        _state = State::ELEMENT;
+                        _element.clear();
+                        _elementLine = _lineNumber;
+                        _elementStart = _index;
+                    }
+                    else if (!_closingTag && _state == State::PROLOG) {
+                        // Start of the root element.
+                        _rootTag.clear();
+                        rootStart = _index;
+                    }
+                    _index += _closingTag ? 2 : 1;
+                }
+                break;
+            }
+            case Lexical::TAG: {
+                // Look for a quote or the end of tag.
+                while (_index < _line.length() && _lexical == Lexical::TAG) {
+                    const UChar c = _line[_index];
+                    if (c == u'"' || c == u'\'') {
+                        _quote = c;
+                        _lexical = Lexical::QUOTE;
+                    }
+                    else if (c == u'>') {
+                        // End of tag, process structure.
+                        _lexical = Lexical::CONTENT;
+                        if (_state == State::PROLOG) {
+                            if (_closingTag) {
+                                fatal(UString::Format(u"line %d: unexpected closing tag before root element", {_lineNumber}));
+                                return false;
+                            }
+                            // End of root start tag.
+                            _rootTag.append(_line.substr(rootStart, _index + 1 - rootStart));
+                            size_t end = 1;
+                            while (end < _rootTag.length() && !IsSpace(_rootTag[end]) && _rootTag[end] != u'/' && _rootTag[end] != u'>') {
+                                ++end;
+                            }
+                            _rootName = _rootTag.substr(1, end - 1);
+                            _index++;
+                            if (_emptyTag) {
+                                // Empty root element, no child element, continue scanning the epilogue.
+                                _state = State::END;
+                                break;
+                            }
+                            _depth = 1;
+                            _state = State::ROOT;
+                            return true;
+                        }
+                        else if (!_closingTag && !_emptyTag) {
+                            _depth++;
+                        }
+                        else if (_closingTag && --_depth == 0) {
+                            // End of root element, continue scanning the epilogue.
+                            _state = State::END;
+                        }
+                        _index++;
+                        if (_state == State::ELEMENT && _depth == 1) {
+                            // End of the top-level element.
+                            _element.push_back(_line.substr(_elementStart, _index - _elementStart));
+                            _state = State::ROOT;
+                            return true;
+                        }
+                        break;
+                    }
+                    else if (c == u'/') {
+                        _emptyTag = true;
+                    }
+                    else if (!IsSpace(c)) {
+                        _emptyTag = false;
+                    }
+                    _index++;
+                }
+                break;
+            }
+            case Lexical::QUOTE: {
+                const size_t end = _line.find(_quote, _index);
+                if (end == NPOS) {
+                    _index = _line.length();
+                }
+                else {
+                    _index = end + 1;
+                    _lexical = Lexical::TAG;
+                }
+                break;
+            }
+            case Lexical::COMMENT:
+            case Lexical::CDATA:
+            case Lexical::PI:
+            case Lexical::DTD: {
+                const UChar* const terminator =
+                    _lexical == Lexical::COMMENT ? u"-->" :
+                    _lexical == Lexical::CDATA ? u"]]>" :
+                    _lexical == Lexical::PI ? u"?>" : u">";
+                const size_t end = _line.find(terminator, _index);
+                if (end == NPOS) {
+                    _index = _line.length();
+                }
+                else {
+                    _index = end + UString(terminator).length();
+                    _lexical = Lexical::CONTENT;
+                }
+                break;
+            }
+            default: {
+                assert(false);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,182 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Incremental reader of XML documents, one top-level element at a time.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlDocument.h"
+#include "tsNullReport.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Incremental reader of XML documents, one top-level element at a time.
+        //! @ingroup xml
+        //!
+        //! This is the reading counterpart of RunningDocument. Some XML documents, such as
+        //! section files, are made of a root element containing an arbitrary long list of
+        //! independent elements. Loading such a document as a whole requires a memory which
+        //! is proportional to the document size.
+        //!
+        //! A StreamReader scans the input text stream and isolates each child element of the
+        //! root. Each of them is returned as a small XML document, containing an empty copy of
+        //! the root element and the child element only. The memory usage is bounded by the
+        //! size of the largest top-level element. Line numbers in parsing errors refer to the
+        //! complete input document.
+        //!
+        //! The lexical structure of the document (tags, quoted attribute values, comments,
+        //! CDATA, processing instructions) is checked by the scanner. The syntax of each
+        //! element is checked when it is parsed. The matching of the top-level closing tags
+        //! is not checked before the end of each top-level element.
+        //!
+        class TSDUCKDLL StreamReader
+        {
+            TS_NOCOPY(StreamReader);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors.
+            //!
+            explicit StreamReader(Report& report = NULLREP);
+
+            //!
+            //! Destructor.
+            //!
+            ~StreamReader();
+
+            //!
+            //! Open an XML file and read the document prolog, up to the start tag of the root element.
+            //! @param [in] fileName Name of the XML file. If empty or "-", the standard input is used.
+            //! @return True on success, false on error.
+            //!
+            bool open(const UString& fileName);
+
+            //!
+            //! Start reading an XML document from a text stream, up to the start tag of the root element.
+            //! @param [in,out] strm A standard text stream in input mode.
+            //! The referenced stream object must remain valid as long as it is used by this object.
+            //! @return True on success, false on error.
+            //!
+            bool open(std::istream& strm);
+
+            //!
+            //! Close the reader.
+            //! If the input was a file, it is closed.
+            //!
+            void close();
+
+            //!
+            //! Get the name of the root element of the document.
+            //! @return The name of the root element, empty if the document is not open.
+            //!
+            UString rootName() const { return _rootName; }
+
+            //!
+            //! Read the next top-level element, that is to say the next child element of the root.
+            //! Top-level elements which cannot be parsed are reported and skipped.
+            //! @param [out] doc The XML document receiving the element. Its previous content is cleared.
+            //! It receives a root element with the same name and attributes as the root of the input
+            //! document. The next top-level element is the unique child of this root element.
+            //! @return True when an element was read, false at end of document or on fatal error.
+            //!
+            bool readElement(Document& doc);
+
+            //!
+            //! Check if the end of the document was reached.
+            //! @return True if the end of the document (or a fatal error) was reached.
+            //!
+            bool endOfDocument() const { return _state == State::END; }
+
+            //!
+            //! Check if an error was found.
+            //! @return True when an error was found since the document was opened.
+            //!
+            bool hasErrors() const { return _errors; }
+
+        private:
+            // Position of the scanner in the document structure.
+            enum class State {
+                CLOSED,   // Document not open.
+                PROLOG,   // Before root element.
+                ROOT,     // Between elements inside root element.
+                ELEMENT,  // Inside a top-level element.
+                END,      // After the end of root element or after a fatal error.
+            };
+
+            // Lexical context of the scanner.
+            enum class Lexical {
+                CONTENT,  // Text content.
+                TAG,      // Inside a start or end tag.
+                QUOTE,    // Inside a quoted attribute value.
+                COMMENT,  // Inside a comment.
+                CDATA,    // Inside a CDATA section.
+                PI,       // Inside a processing instruction or declaration.
+                DTD,      // Inside a DTD.
+            };
+
+            Report&       _report;       // Where to report errors.
+            std::ifstream _file;         // Input file, when open by name.
+            std::istream* _input;        // Input stream.
+            State         _state;        // Position in document structure.
+            Lexical       _lexical;      // Lexical context.
+            bool          _errors;       // An error was found.
+            bool          _closingTag;   // Current tag is a closing tag.
+            bool          _emptyTag;     // Last significant character in tag is a '/'.
+            UChar         _quote;        // Current quote character.
+            size_t        _depth;        // Depth of nested elements, root is depth 1.
+            UString       _line;         // Current input line.
+            size_t        _lineNumber;   // Current line number in document.
+            size_t        _index;        // Current index in _line.
+            UString       _rootName;     // Name of the root element.
+            UString       _rootTag;      // Complete start tag of root element.
+            UStringList   _element;      // Text lines of the current top-level element.
+            size_t        _elementLine;  // Line number of the first line in _element.
+            size_t        _elementStart; // Start index of the current top-level element in _line.
+
+            // Read next line of text. Return false at end of file.
+            bool nextLine();
+
+            // Scan the document until the end of the next top-level element.
+            // Return false at end of document or on fatal error.
+            bool scanElement();
+
+            // Process the end of a tag, _index is on the '>'.
+            void endTag();
+
+            // Check if the current line contains a string at current index.
+            bool match(const UChar* str) const;
+
+            // Report a fatal error.
+            void fatal(const UString& message);
+        };
+    }
+}
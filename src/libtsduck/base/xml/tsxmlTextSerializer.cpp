@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlTextSerializer.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::TextSerializer::TextSerializer(TextFormatter& output, const Tweaks& tweaks, size_t top_depth) :
+    Serializer(top_depth),
+    _output(output),
+    _tweaks(tweaks),
+    _sticky()
+{
+}
+
+ts::xml::TextSerializer::~TextSerializer()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Serialize elements, same format as Element::print().
+//----------------------------------------------------------------------------
+
+void ts::xml::TextSerializer::writeStart(const Frame& frame, bool empty)
+{
+    // Inside a parent element, an element is printed on a new line, except after a text.
+    if (!_sticky.empty()) {
+        if (!_sticky.back()) {
+            _output << ts::endl << ts::margin;
+        }
+        _sticky.back() = false;
+    }
+
+    // Output element name and attributes, by modification order.
+    _output << "<" << frame.name;
+    for (auto it = frame.attributes.begin(); it != frame.attributes.end(); ++it) {
+        _output << " " << it->name() << "=" << it->formattedValue(_tweaks);
+    }
+
+    if (empty) {
+        _output << "/>";
+    }
+    else {
+        _output << ">" << ts::indent;
+        _sticky.push_back(false);
+    }
+}
+
+void ts::xml::TextSerializer::writeEnd(const Frame& frame)
+{
+    const bool sticky = !_sticky.empty() && _sticky.back();
+    if (!_sticky.empty()) {
+        _sticky.pop_back();
+    }
+    if (!sticky) {
+        _output << ts::endl;
+    }
+    _output << ts::unindent;
+    if (!sticky) {
+        _output << ts::margin;
+    }
+    _output << "</" << frame.name << ">";
+}
+
+
+//----------------------------------------------------------------------------
+// Serialize a text node, same format as Text::print().
+//----------------------------------------------------------------------------
+
+void ts::xml::TextSerializer::writeText(const UString& value, bool trimmable)
+{
+    if (!_sticky.empty()) {
+        _sticky.back() = true;
+    }
+    UString text(value);
+    // On non-formatting output (e.g. one-liner XML text), trim all spaces when allowed.
+    if (trimmable && !_output.formatting()) {
+        text.trim(true, true, true);
+    }
+    text.convertToHTML(_tweaks.strictTextNodeFormatting ? u"<>&'\"" : u"<>&");
+    _output << text;
+}
@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Push-style XML serializer which prints XML text.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlSerializer.h"
+#include "tsxmlTweaks.h"
+#include "tsTextFormatter.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Push-style XML serializer which directly prints XML text, without building an XML tree.
+        //! @ingroup xml
+        //!
+        //! The printed text is identical to the print of the equivalent XML elements.
+        //! Each top-level element is printed at the current position in the text formatter.
+        //!
+        class TSDUCKDLL TextSerializer : public Serializer
+        {
+            TS_NOBUILD_NOCOPY(TextSerializer);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] output The text formatter where the XML text is printed.
+            //! The referenced object must remain valid as long as this object.
+            //! @param [in] tweaks XML formatting tweaks.
+            //! @param [in] top_depth Depth in an XML document of the top-level elements.
+            //! The default value is the depth of the tables in a TSDuck XML file.
+            //!
+            explicit TextSerializer(TextFormatter& output, const Tweaks& tweaks = Tweaks(), size_t top_depth = 2);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~TextSerializer() override;
+
+        protected:
+            // Inherited from Serializer.
+            virtual void writeStart(const Frame& frame, bool empty) override;
+            virtual void writeEnd(const Frame& frame) override;
+            virtual void writeText(const UString& text, bool trimmable) override;
+
+        private:
+            TextFormatter&    _output;  // Where to print.
+            Tweaks            _tweaks;  // Formatting tweaks.
+            std::vector<bool> _sticky;  // For each started element, the last child was a sticky text.
+        };
+    }
+}
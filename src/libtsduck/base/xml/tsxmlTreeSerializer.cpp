@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlTreeSerializer.h"
+#include "tsxmlText.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::TreeSerializer::TreeSerializer(Element* root) :
+    Serializer(root == nullptr ? 0 : root->depth()),
+    _root(root),
+    _nodes()
+{
+    if (_root != nullptr) {
+        startElement(_root->name());
+    }
+}
+
+ts::xml::TreeSerializer::~TreeSerializer()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Build elements.
+//----------------------------------------------------------------------------
+
+void ts::xml::TreeSerializer::writeStart(const Frame& frame, bool empty)
+{
+    // The top-level element is the root, the others are created in their parent.
+    Element* elem = depth() == 1 ? _root : (_nodes.empty() ? nullptr : _nodes.back()->addElement(frame.name));
+    if (elem == nullptr) {
+        return;
+    }
+    for (auto it = frame.attributes.begin(); it != frame.attributes.end(); ++it) {
+        elem->setAttribute(it->name(), it->value());
+    }
+    if (!empty) {
+        _nodes.push_back(elem);
+    }
+}
+
+void ts::xml::TreeSerializer::writeEnd(const Frame&)
+{
+    if (!_nodes.empty()) {
+        _nodes.pop_back();
+    }
+}
+
+void ts::xml::TreeSerializer::writeText(const UString& text, bool trimmable)
+{
+    if (!_nodes.empty()) {
+        Text* node = _nodes.back()->addText(text);
+        node->setTrimmable(trimmable);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// XML fragments are directly built in the current element.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::TreeSerializer::startFragment()
+{
+    commit();
+    return _nodes.empty() ? nullptr : _nodes.back();
+}
+
+void ts::xml::TreeSerializer::endFragment()
+{
+}
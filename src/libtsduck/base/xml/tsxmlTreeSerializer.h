@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Push-style XML serializer which builds an XML tree.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlSerializer.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Push-style XML serializer which builds an XML tree.
+        //! @ingroup xml
+        //!
+        //! This serializer is used to fill an existing XML element with code which is
+        //! written for serializers. Typically, buildXML() in a table or descriptor class
+        //! which directly serializes its content uses this class.
+        //!
+        class TSDUCKDLL TreeSerializer : public Serializer
+        {
+            TS_NOBUILD_NOCOPY(TreeSerializer);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] root The element to fill. It is the initial current element of the
+            //! serializer: the attributes and children which are serialized at top level are added
+            //! to this element. The element is complete when the serializer is closed or destroyed.
+            //!
+            explicit TreeSerializer(Element* root);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~TreeSerializer() override;
+
+            // Inherited from Serializer.
+            virtual Element* startFragment() override;
+            virtual void endFragment() override;
+
+        protected:
+            // Inherited from Serializer.
+            virtual void writeStart(const Frame& frame, bool empty) override;
+            virtual void writeEnd(const Frame& frame) override;
+            virtual void writeText(const UString& text, bool trimmable) override;
+
+        private:
+            Element*              _root;   // Element to fill.
+            std::vector<Element*> _nodes;  // Started elements, the current one at the end.
+        };
+    }
+}
@@ -15,8 +15,14 @@
 
 #include "tsAES.h"
 #include "tsRotate.h"
+#include "tsSysInfo.h"
 TSDUCK_SOURCE;
 
+#if (defined(TS_GCC) || defined(TS_LLVM)) && (defined(TS_X86_64) || defined(TS_I386))
+    #define TS_AES_X86_ACCEL 1
+    #include <immintrin.h>
+#endif
+
 #define BYTE(x,n) (((x) >> (8 * (n))) & 255)
 
 namespace {
@@ -1013,6 +1019,167 @@ namespace {
 }
 
 
+//----------------------------------------------------------------------------
+// Hardware-accelerated implementations, using AES-NI or VAES instructions.
+// The round keys are the same as the software implementation, as byte arrays.
+// The blocks are processed by groups to interleave the instructions of
+// independent blocks and hide the latency of the AES instructions.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Encrypt or decrypt count consecutive blocks, in ECB mode.
+    typedef void (*AESBlocksFunction)(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count);
+
+    // Description of an accelerated implementation.
+    struct AESAccel
+    {
+        const ts::UChar*  name;
+        AESBlocksFunction encrypt;
+        AESBlocksFunction decrypt;
+    };
+
+#if defined(TS_AES_X86_ACCEL)
+
+    // Number of blocks which are processed in parallel.
+    const size_t AESNI_BLOCKS = 8;
+    const size_t VAES_REGS = 8;
+
+    __attribute__((target("aes,sse2")))
+    void AESNIEncrypt(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        __m128i rk[ts::AES::MAX_ROUNDS + 1];
+        for (int r = 0; r <= rounds; ++r) {
+            rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + ts::AES::BLOCK_SIZE * r));
+        }
+        while (count > 0) {
+            const size_t n = std::min(count, AESNI_BLOCKS);
+            __m128i b[AESNI_BLOCKS];
+            for (size_t i = 0; i < n; ++i) {
+                b[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i), rk[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (size_t i = 0; i < n; ++i) {
+                    b[i] = _mm_aesenc_si128(b[i], rk[r]);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesenclast_si128(b[i], rk[rounds]));
+            }
+            in += n * ts::AES::BLOCK_SIZE;
+            out += n * ts::AES::BLOCK_SIZE;
+            count -= n;
+        }
+    }
+
+    __attribute__((target("aes,sse2")))
+    void AESNIDecrypt(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        __m128i rk[ts::AES::MAX_ROUNDS + 1];
+        for (int r = 0; r <= rounds; ++r) {
+            rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + ts::AES::BLOCK_SIZE * r));
+        }
+        while (count > 0) {
+            const size_t n = std::min(count, AESNI_BLOCKS);
+            __m128i b[AESNI_BLOCKS];
+            for (size_t i = 0; i < n; ++i) {
+                b[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i), rk[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (size_t i = 0; i < n; ++i) {
+                    b[i] = _mm_aesdec_si128(b[i], rk[r]);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesdeclast_si128(b[i], rk[rounds]));
+            }
+            in += n * ts::AES::BLOCK_SIZE;
+            out += n * ts::AES::BLOCK_SIZE;
+            count -= n;
+        }
+    }
+
+    // With VAES, each 256-bit register contains two blocks.
+    __attribute__((target("vaes,avx2,aes")))
+    void VAESEncrypt(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        __m256i rk[ts::AES::MAX_ROUNDS + 1];
+        for (int r = 0; r <= rounds; ++r) {
+            rk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + ts::AES::BLOCK_SIZE * r)));
+        }
+        while (count >= 2) {
+            const size_t n = std::min(count / 2, VAES_REGS);
+            __m256i b[VAES_REGS];
+            for (size_t i = 0; i < n; ++i) {
+                b[i] = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in) + i), rk[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (size_t i = 0; i < n; ++i) {
+                    b[i] = _mm256_aesenc_epi128(b[i], rk[r]);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out) + i, _mm256_aesenclast_epi128(b[i], rk[rounds]));
+            }
+            in += 2 * n * ts::AES::BLOCK_SIZE;
+            out += 2 * n * ts::AES::BLOCK_SIZE;
+            count -= 2 * n;
+        }
+        if (count > 0) {
+            AESNIEncrypt(keys, rounds, in, out, count);
+        }
+    }
+
+    __attribute__((target("vaes,avx2,aes")))
+    void VAESDecrypt(const uint8_t* keys, int rounds, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        __m256i rk[ts::AES::MAX_ROUNDS + 1];
+        for (int r = 0; r <= rounds; ++r) {
+            rk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + ts::AES::BLOCK_SIZE * r)));
+        }
+        while (count >= 2) {
+            const size_t n = std::min(count / 2, VAES_REGS);
+            __m256i b[VAES_REGS];
+            for (size_t i = 0; i < n; ++i) {
+                b[i] = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in) + i), rk[0]);
+            }
+            for (int r = 1; r < rounds; ++r) {
+                for (size_t i = 0; i < n; ++i) {
+                    b[i] = _mm256_aesdec_epi128(b[i], rk[r]);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out) + i, _mm256_aesdeclast_epi128(b[i], rk[rounds]));
+            }
+            in += 2 * n * ts::AES::BLOCK_SIZE;
+            out += 2 * n * ts::AES::BLOCK_SIZE;
+            count -= 2 * n;
+        }
+        if (count > 0) {
+            AESNIDecrypt(keys, rounds, in, out, count);
+        }
+    }
+
+#endif
+
+    // Get the accelerated implementation for this CPU, null if there is none.
+    const AESAccel* GetAESAccel()
+    {
+#if defined(TS_AES_X86_ACCEL)
+        static const AESAccel aesni = {u"AES-NI", AESNIEncrypt, AESNIDecrypt};
+        static const AESAccel vaes = {u"VAES", VAESEncrypt, VAESDecrypt};
+        static const ts::SysInfo* const sys = ts::SysInfo::Instance();
+        static const AESAccel* const accel =
+            !sys->cpuHasFeatures(ts::SysInfo::CPU_AES) ? nullptr :
+            (sys->cpuHasFeatures(ts::SysInfo::CPU_VAES | ts::SysInfo::CPU_AVX2) ? &vaes : &aesni);
+        return accel;
+#else
+        return nullptr;
+#endif
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Schedule a new key. If rounds is zero, the default is used.
 //----------------------------------------------------------------------------
@@ -1165,6 +1332,12 @@ bool ts::AES::setKeyImpl(const void* key_, size_t key_length, size_t rounds)
     *rk++ = *rrk++;
     *rk   = *rrk;
 
+    // Byte representation of the round keys for the AES instructions.
+    for (i = 0; i < 4 * (_Nr + 1); ++i) {
+        PutUInt32(_eKb + 4 * i, _eK[i]);
+        PutUInt32(_dKb + 4 * i, _dK[i]);
+    }
+
     return true;
 }
 
@@ -1182,6 +1355,16 @@ bool ts::AES::encryptImpl(const void* plain, size_t plain_length, void* cipher,
     const uint8_t* pt = reinterpret_cast<const uint8_t*> (plain);
     uint8_t* ct = reinterpret_cast<uint8_t*> (cipher);
 
+    // Use AES instructions when available.
+    const AESAccel* const accel = GetAESAccel();
+    if (accel != nullptr) {
+        accel->encrypt(_eKb, _Nr, pt, ct, 1);
+        if (cipher_length != nullptr) {
+            *cipher_length = BLOCK_SIZE;
+        }
+        return true;
+    }
+
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
@@ -1307,6 +1490,16 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
+    // Use AES instructions when available.
+    const AESAccel* const accel = GetAESAccel();
+    if (accel != nullptr) {
+        accel->decrypt(_dKb, _Nr, ct, pt, 1);
+        if (plain_length != nullptr) {
+            *plain_length = BLOCK_SIZE;
+        }
+        return true;
+    }
+
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
@@ -1427,8 +1620,46 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
 ts::AES::AES() :
     _Nr(0),
     _eK(),
-    _dK()
+    _dK(),
+    _eKb(),
+    _dKb()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Encryption / decryption of several blocks in ECB mode.
+//----------------------------------------------------------------------------
+
+bool ts::AES::encryptBlocksImpl(const void* plain, void* cipher, size_t count)
+{
+    const AESAccel* const accel = GetAESAccel();
+    if (accel == nullptr) {
+        return BlockCipher::encryptBlocksImpl(plain, cipher, count);
+    }
+    accel->encrypt(_eKb, _Nr, reinterpret_cast<const uint8_t*>(plain), reinterpret_cast<uint8_t*>(cipher), count);
+    return true;
+}
+
+bool ts::AES::decryptBlocksImpl(const void* cipher, void* plain, size_t count)
+{
+    const AESAccel* const accel = GetAESAccel();
+    if (accel == nullptr) {
+        return BlockCipher::decryptBlocksImpl(cipher, plain, count);
+    }
+    accel->decrypt(_dKb, _Nr, reinterpret_cast<const uint8_t*>(cipher), reinterpret_cast<uint8_t*>(plain), count);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the name of the AES implementation which is used on this system.
+//----------------------------------------------------------------------------
+
+ts::UString ts::AES::Implementation()
 {
+    const AESAccel* const accel = GetAESAccel();
+    return accel == nullptr ? u"software" : accel->name;
 }
 
 
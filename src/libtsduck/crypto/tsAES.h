@@ -62,15 +62,27 @@ namespace ts {
         virtual size_t maxRounds() const override;
         virtual size_t defaultRounds() const override;
 
+        //!
+        //! Get the name of the AES implementation which is used on this system.
+        //! When the CPU supports AES instructions (AES-NI or VAES on Intel processors),
+        //! these instructions are used instead of the portable software implementation.
+        //! @return The implementation name, "software", "AES-NI" or "VAES".
+        //!
+        static UString Implementation();
+
     protected:
         // Implementation of BlockCipher interface:
         virtual bool setKeyImpl(const void* key, size_t key_length, size_t rounds) override;
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool encryptBlocksImpl(const void* plain, void* cipher, size_t count) override;
+        virtual bool decryptBlocksImpl(const void* cipher, void* plain, size_t count) override;
 
     private:
         int      _Nr;     //!< Number of rounds
         uint32_t _eK[60]; //!< Scheduled encryption keys
         uint32_t _dK[60]; //!< Scheduled decryption keys
+        uint8_t  _eKb[BLOCK_SIZE * (MAX_ROUNDS + 1)]; //!< Scheduled encryption keys as bytes, for AES instructions
+        uint8_t  _dKb[BLOCK_SIZE * (MAX_ROUNDS + 1)]; //!< Scheduled decryption keys as bytes, for AES instructions
     };
 }
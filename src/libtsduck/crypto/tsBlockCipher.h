@@ -189,6 +189,33 @@ namespace ts {
         //!
         bool decryptInPlace(void* data, size_t data_length, size_t* max_actual_length = nullptr);
 
+        //!
+        //! Encrypt several consecutive blocks of data, each block being encrypted independently.
+        //!
+        //! This is the equivalent of successive calls to encrypt() on each block (ECB mode)
+        //! but some subclasses process several blocks in parallel. This is typically used
+        //! by chaining modes. The key usage counter is incremented by @a count, as with
+        //! successive calls to encrypt().
+        //!
+        //! @param [in] plain Address of plain text, @a count times blockSize() bytes.
+        //! @param [out] cipher Address of buffer for cipher text, @a count times blockSize() bytes.
+        //! It can be the same as @a plain but the two areas must not partially overlap.
+        //! @param [in] count Number of blocks.
+        //! @return True on success, false on error.
+        //!
+        bool encryptBlocks(const void* plain, void* cipher, size_t count);
+
+        //!
+        //! Decrypt several consecutive blocks of data, each block being decrypted independently.
+        //! @param [in] cipher Address of cipher text, @a count times blockSize() bytes.
+        //! @param [out] plain Address of buffer for plain text, @a count times blockSize() bytes.
+        //! It can be the same as @a cipher but the two areas must not partially overlap.
+        //! @param [in] count Number of blocks.
+        //! @return True on success, false on error.
+        //! @see encryptBlocks()
+        //!
+        bool decryptBlocks(const void* cipher, void* plain, size_t count);
+
         //!
         //! Get the number of times the current key was used for encryption.
         //! @return The number of times the current key was used for encryption.
@@ -314,6 +341,45 @@ namespace ts {
         //!
         virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length);
 
+        //!
+        //! Encrypt several consecutive blocks of data (implementation of algorithm-specific part).
+        //! The default implementation is to call encryptImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] plain Address of plain text, @a count times blockSize() bytes.
+        //! @param [out] cipher Address of buffer for cipher text. Can be the same as @a plain.
+        //! @param [in] count Number of blocks.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptBlocksImpl(const void* plain, void* cipher, size_t count);
+
+        //!
+        //! Decrypt several consecutive blocks of data (implementation of algorithm-specific part).
+        //! The default implementation is to call decryptImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] cipher Address of cipher text, @a count times blockSize() bytes.
+        //! @param [out] plain Address of buffer for plain text. Can be the same as @a cipher.
+        //! @param [in] count Number of blocks.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptBlocksImpl(const void* cipher, void* plain, size_t count);
+
+        //!
+        //! Check if encryption is allowed with the current key and increment the usage counter.
+        //! This is automatically done by encrypt() and encryptInPlace(). A subclass which provides
+        //! additional encryption methods shall call it once per encrypted data block.
+        //! @param [in] count Number of data blocks to encrypt.
+        //! @return True if encryption is allowed, false otherwise.
+        //!
+        bool allowEncrypt(size_t count = 1);
+
+        //!
+        //! Check if decryption is allowed with the current key and increment the usage counter.
+        //! @param [in] count Number of data blocks to decrypt.
+        //! @return True if decryption is allowed, false otherwise.
+        //! @see allowEncrypt()
+        //!
+        bool allowDecrypt(size_t count = 1);
+
     private:
         bool      _key_set;                // Current key successfully set.
         int       _cipher_id;              // Cipher identity (from application).
@@ -323,9 +389,5 @@ namespace ts {
         size_t    _key_decrypt_max;        // Maximum number of times a key should be used for decryption.
         ByteBlock _current_key;            // Current unscheduled key.
         BlockCipherAlertInterface* _alert; // Alert handler.
-
-        // Check if encryption or decryption is allowed. Increment counters.
-        bool allowEncrypt();
-        bool allowDecrypt();
     };
 }
@@ -53,7 +53,7 @@ namespace ts {
         //!
         //! Constructor.
         //!
-        CBC() : CipherChainingTemplate<CIPHER>(1, 1, 1) {}
+        CBC() : CipherChainingTemplate<CIPHER>(1, 1, 1), _batch() {}
 
         // Implementation of BlockCipher and CipherChaining interfaces.
         // For some reason, doxygen is unable to automatically inherit the
@@ -69,12 +69,24 @@ namespace ts {
         //! @copydoc ts::BlockCipher::name()
         virtual UString name() const override;
 
+        //! @copydoc ts::CipherChaining::encryptInPlaceBatch()
+        virtual bool encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]) override;
+
+        //! @copydoc ts::CipherChaining::decryptInPlaceBatch()
+        virtual bool decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]) override;
+
     protected:
         //! @copydoc ts::BlockCipher::encryptImpl()
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
 
         //! @copydoc ts::BlockCipher::decryptImpl()
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+
+    private:
+        ByteBlock _batch;  // Work buffer for batches of messages.
+
+        // Check the messages of a batch, return the total number of blocks.
+        bool checkBatch(size_t count, void* const data[], const size_t sizes[], size_t& total_blocks, size_t& max_blocks) const;
     };
 }
 
@@ -102,6 +102,24 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
+    // When the cipher and plain texts do not overlap, decrypt all blocks at once,
+    // possibly in parallel, and then XOR each block with the previous cipher text.
+    const size_t count = cipher_length / this->block_size;
+    if (count > 1 && (ct + count * this->block_size <= pt || pt + count * this->block_size <= ct)) {
+        if (!this->algo->decryptBlocks(ct, pt, count)) {
+            return false;
+        }
+        for (size_t blk = 0; blk < count; ++blk) {
+            for (size_t i = 0; i < this->block_size; ++i) {
+                pt[i] ^= previous[i];
+            }
+            previous = ct;
+            ct += this->block_size;
+            pt += this->block_size;
+        }
+        cipher_length -= count * this->block_size;
+    }
+
     while (cipher_length > 0) {
         // work = decrypt (cipher-text)
         if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
@@ -123,6 +141,141 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
 }
 
 
+//----------------------------------------------------------------------------
+// Check the messages of a batch.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::checkBatch(size_t count, void* const data[], const size_t sizes[], size_t& total_blocks, size_t& max_blocks) const
+{
+    total_blocks = max_blocks = 0;
+    if (this->algo == nullptr || this->iv.size() != this->block_size || (count > 0 && (data == nullptr || sizes == nullptr))) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] % this->block_size != 0 || (data[i] == nullptr && sizes[i] > 0)) {
+            return false;
+        }
+        const size_t blocks = sizes[i] / this->block_size;
+        total_blocks += blocks;
+        max_blocks = std::max(max_blocks, blocks);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Encryption of a batch of messages in CBC mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    size_t total_blocks = 0;
+    size_t max_blocks = 0;
+    if (!checkBatch(count, data, sizes, total_blocks, max_blocks)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!this->allowEncrypt()) {
+            return false;
+        }
+    }
+
+    // The chaining is serial inside a message but the messages are independent.
+    // Encrypt the same block index of all messages in one call to the block cipher.
+    const size_t bsize = this->block_size;
+    _batch.resize(count * bsize);
+
+    for (size_t blk = 0; blk < max_blocks; ++blk) {
+        const size_t offset = blk * bsize;
+        // batch = previous-cipher XOR plain-text, for all messages with that block.
+        uint8_t* out = _batch.data();
+        for (size_t i = 0; i < count; ++i) {
+            if (offset < sizes[i]) {
+                const uint8_t* pt = reinterpret_cast<const uint8_t*>(data[i]) + offset;
+                const uint8_t* previous = blk == 0 ? this->iv.data() : pt - bsize;
+                for (size_t n = 0; n < bsize; ++n) {
+                    out[n] = previous[n] ^ pt[n];
+                }
+                out += bsize;
+            }
+        }
+        // batch = encrypt(batch), all blocks at once.
+        const size_t lanes = (out - _batch.data()) / bsize;
+        if (!this->algo->encryptBlocks(_batch.data(), _batch.data(), lanes)) {
+            return false;
+        }
+        // cipher-text = batch
+        const uint8_t* in = _batch.data();
+        for (size_t i = 0; i < count; ++i) {
+            if (offset < sizes[i]) {
+                ::memcpy(reinterpret_cast<uint8_t*>(data[i]) + offset, in, bsize);
+                in += bsize;
+            }
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decryption of a batch of messages in CBC mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    size_t total_blocks = 0;
+    size_t max_blocks = 0;
+    if (!checkBatch(count, data, sizes, total_blocks, max_blocks)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!this->allowDecrypt()) {
+            return false;
+        }
+    }
+
+    // All blocks can be decrypted independently. Copy the cipher texts of all messages
+    // in the first half of the batch buffer and decrypt them at once in the second half.
+    const size_t bsize = this->block_size;
+    const size_t total_size = total_blocks * bsize;
+    _batch.resize(2 * total_size);
+    uint8_t* const cipher = _batch.data();
+    uint8_t* const output = cipher + total_size;
+
+    uint8_t* ct = cipher;
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] > 0) {
+            ::memcpy(ct, data[i], sizes[i]);
+            ct += sizes[i];
+        }
+    }
+    if (total_blocks > 0 && !this->algo->decryptBlocks(cipher, output, total_blocks)) {
+        return false;
+    }
+
+    // plain-text = previous-cipher XOR output
+    ct = cipher;
+    const uint8_t* wk = output;
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* pt = reinterpret_cast<uint8_t*>(data[i]);
+        const uint8_t* previous = this->iv.data();
+        for (size_t blk = sizes[i] / bsize; blk > 0; --blk) {
+            for (size_t n = 0; n < bsize; ++n) {
+                pt[n] = previous[n] ^ wk[n];
+            }
+            previous = ct;
+            ct += bsize;
+            wk += bsize;
+            pt += bsize;
+        }
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Simple virtual methods.
 //----------------------------------------------------------------------------
@@ -79,19 +79,34 @@ namespace ts {
         // Implementation of BlockCipher interface.
         virtual UString name() const override;
 
+        // Implementation of CipherChaining interface.
+        virtual bool encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]) override;
+        virtual bool decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]) override;
+
     protected:
         // Implementation of BlockCipher interface.
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
 
     private:
-        size_t _counter_bits; // size in bits of the counter part.
+        size_t    _counter_bits; // size in bits of the counter part.
+        ByteBlock _batch;        // Counters and encrypted counters for batches of messages.
+
+        // Number of successive counter values which are encrypted in one call to the block cipher.
+        static constexpr size_t PARALLEL_BLOCKS = 8;
 
-        // We need two work blocks.
+        // Max number of blocks from several messages which are encrypted in one call to the block cipher.
+        static constexpr size_t BATCH_BLOCKS = 128;
+
+        // We need 1 + 2 * PARALLEL_BLOCKS work blocks.
         // The first one contains the "input block" or counter.
-        // The second one contains the "output block", the encrypted counter.
+        // The next PARALLEL_BLOCKS contain successive values of the counter.
+        // The last PARALLEL_BLOCKS contain the "output blocks", the encrypted counters.
         // This private method increments the counter block.
         bool incrementCounter();
+
+        // Encrypt or decrypt a batch of messages, without checking the usage counters.
+        bool processBatch(size_t count, void* const data[], const size_t sizes[]);
     };
 }
 
@@ -37,8 +37,9 @@
 
 template<class CIPHER>
 ts::CTR<CIPHER>::CTR(size_t counter_bits) :
-    CipherChainingTemplate<CIPHER>(1, 1, 2),
-    _counter_bits(0)
+    CipherChainingTemplate<CIPHER>(1, 1, 1 + 2 * PARALLEL_BLOCKS),
+    _counter_bits(0),
+    _batch()
 {
     setCounterBits(counter_bits);
 }
@@ -121,7 +122,7 @@ bool ts::CTR<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
 {
     if (this->algo == nullptr ||
         this->iv.size() != this->block_size ||
-        this->work.size() < 2 * this->block_size ||
+        this->work.size() < (1 + 2 * PARALLEL_BLOCKS) * this->block_size ||
         cipher_maxsize < plain_length)
     {
         return false;
@@ -133,27 +134,36 @@ bool ts::CTR<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     // work[0] = iv
     ::memcpy(this->work.data(), this->iv.data(), this->block_size);
 
-    // Loop on all blocks, including last truncated one.
+    // Successive counters and encrypted counters in the work buffer.
+    uint8_t* const counters = this->work.data() + this->block_size;
+    uint8_t* const output = counters + PARALLEL_BLOCKS * this->block_size;
+
+    // Loop on groups of blocks, including last truncated one.
 
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
     while (plain_length > 0) {
-        // work[1] = encrypt(work[0])
-        if (!this->algo->encrypt(this->work.data(), this->block_size, this->work.data() + this->block_size, this->block_size)) {
+        // Number of blocks in this group:
+        const size_t count = std::min(PARALLEL_BLOCKS, (plain_length + this->block_size - 1) / this->block_size);
+        // work[1..count] = successive values of work[0], work[0] += count
+        for (size_t blk = 0; blk < count; ++blk) {
+            ::memcpy(counters + blk * this->block_size, this->work.data(), this->block_size);
+            if (!incrementCounter()) {
+                return false;
+            }
+        }
+        // output = encrypt(counters), all blocks at once
+        if (!this->algo->encryptBlocks(counters, output, count)) {
             return false;
         }
-        // This block size:
-        const size_t size = std::min(plain_length, this->block_size);
-        // cipher-text = plain-text XOR work[1]
+        // This group size:
+        const size_t size = std::min(plain_length, count * this->block_size);
+        // cipher-text = plain-text XOR output
         for (size_t i = 0; i < size; ++i) {
-            ct[i] = this->work[this->block_size + i] ^ pt[i];
+            ct[i] = output[i] ^ pt[i];
         }
-        // work[0] += 1
-        if (!incrementCounter()) {
-            return false;
-        }
-        // advance one block
+        // advance the group
         ct += size;
         pt += size;
         plain_length -= size;
@@ -172,3 +182,102 @@ bool ts::CTR<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     // With CTR, the encryption and decryption are identical operations.
     return this->encryptImpl(cipher, cipher_length, plain, plain_maxsize, plain_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Encryption or decryption of a batch of messages in CTR mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CTR<CIPHER>::encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!this->allowEncrypt()) {
+            return false;
+        }
+    }
+    return processBatch(count, data, sizes);
+}
+
+template<class CIPHER>
+bool ts::CTR<CIPHER>::decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    // With CTR, the encryption and decryption are identical operations.
+    for (size_t i = 0; i < count; ++i) {
+        if (!this->allowDecrypt()) {
+            return false;
+        }
+    }
+    return processBatch(count, data, sizes);
+}
+
+template<class CIPHER>
+bool ts::CTR<CIPHER>::processBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    if (this->algo == nullptr ||
+        this->iv.size() != this->block_size ||
+        this->work.size() < 2 * this->block_size ||
+        (count > 0 && (data == nullptr || sizes == nullptr)))
+    {
+        return false;
+    }
+
+    // Max number of blocks in a message, including last truncated one.
+    const size_t bsize = this->block_size;
+    size_t max_blocks = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == nullptr && sizes[i] > 0) {
+            return false;
+        }
+        max_blocks = std::max(max_blocks, (sizes[i] + bsize - 1) / bsize);
+    }
+
+    // All messages start from the same IV. Compute the sequence of counters once, for the longest message.
+    // The batch buffer contains this sequence, followed by the counters and output blocks of a group of messages.
+    const size_t group_blocks = std::max(max_blocks, size_t(BATCH_BLOCKS));
+    _batch.resize((max_blocks + 2 * group_blocks) * bsize);
+    uint8_t* const sequence = _batch.data();
+    uint8_t* const counters = sequence + max_blocks * bsize;
+    uint8_t* const output = counters + group_blocks * bsize;
+
+    // work[0] = iv
+    ::memcpy(this->work.data(), this->iv.data(), bsize);
+    for (size_t blk = 0; blk < max_blocks; ++blk) {
+        ::memcpy(sequence + blk * bsize, this->work.data(), bsize);
+        if (!incrementCounter()) {
+            return false;
+        }
+    }
+
+    // Encrypt the counters of a group of messages in one call to the block cipher.
+    size_t first = 0;
+    while (first < count) {
+        // Build the counters of all messages in the group.
+        size_t end = first;
+        size_t blocks = 0;
+        for (; end < count; ++end) {
+            const size_t msg_blocks = (sizes[end] + bsize - 1) / bsize;
+            if (blocks + msg_blocks > group_blocks) {
+                break;
+            }
+            ::memcpy(counters + blocks * bsize, sequence, msg_blocks * bsize);
+            blocks += msg_blocks;
+        }
+
+        // output = encrypt(counters), all blocks at once.
+        if (blocks > 0 && !this->algo->encryptBlocks(counters, output, blocks)) {
+            return false;
+        }
+
+        // data = data XOR output
+        const uint8_t* out = output;
+        for (; first < end; ++first) {
+            uint8_t* dt = reinterpret_cast<uint8_t*>(data[first]);
+            for (size_t n = 0; n < sizes[first]; ++n) {
+                dt[n] ^= out[n];
+            }
+            out += ((sizes[first] + bsize - 1) / bsize) * bsize;
+        }
+    }
+    return true;
+}
@@ -125,3 +125,29 @@ bool ts::CipherChaining::setIV(const void* iv_data, size_t iv_length)
         return true;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt several independent messages in place.
+// Default implementation: one message at a time, empty messages are ignored.
+//----------------------------------------------------------------------------
+
+bool ts::CipherChaining::encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] > 0 && !encryptInPlace(data[i], sizes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::CipherChaining::decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] > 0 && !decryptInPlace(data[i], sizes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
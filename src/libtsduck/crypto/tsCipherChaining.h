@@ -91,6 +91,31 @@ namespace ts {
         //!
         virtual bool residueAllowed() const = 0;
 
+        //!
+        //! Encrypt several independent messages in place.
+        //!
+        //! Each message is encrypted as with encryptInPlace(), starting from the current IV.
+        //! This is typically used to scramble the payloads of many TS packets at once. The
+        //! default implementation encrypts the messages one by one. Some chaining modes process
+        //! the blocks of all messages in parallel in the underlying block cipher.
+        //!
+        //! @param [in] count Number of messages.
+        //! @param [in,out] data Array of @a count addresses of messages to encrypt.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]);
+
+        //!
+        //! Decrypt several independent messages in place.
+        //! @param [in] count Number of messages.
+        //! @param [in,out] data Array of @a count addresses of messages to decrypt.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages.
+        //! @return True on success, false on error.
+        //! @see encryptInPlaceBatch()
+        //!
+        virtual bool decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]);
+
     protected:
         // Protected fields, for chaining mode subclass implementation.
         BlockCipher* algo;        //!< An instance of the block cipher.
@@ -10,6 +10,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsSysInfo.h"
 TSDUCK_SOURCE;
 
 // Operations on 64-bit areas.
@@ -61,7 +62,8 @@ ts::DVBCSA2::DVBCSA2(EntropyMode mode) :
     _init(false),
     _mode(mode),
     _block(),
-    _stream()
+    _stream(),
+    _batch_work()
 {
 }
 
@@ -566,6 +568,334 @@ void ts::DVBCSA2::BlockCipher::encipher (const uint8_t *bd, uint8_t *ib)
 }
 
 
+//----------------------------------------------------------------------------
+// Bitsliced stream cipher, used to process many packets at a time.
+//
+// Each bit of the stream cipher state is represented by a word of type W.
+// Bit n of the word contains the state bit of the n-th packet. The word W
+// is either a uint64_t (portable implementation) or a GCC/clang vector of
+// 2, 4 or 8 uint64_t, compiled with SSE2, AVX2 or AVX-512 instructions.
+// The s-boxes are computed from their algebraic normal form.
+//
+// Only the stream cipher is bitsliced. The block cipher is table-driven and
+// remains processed packet per packet.
+//----------------------------------------------------------------------------
+
+#if (defined(TS_GCC) || defined(TS_LLVM)) && (defined(TS_X86_64) || defined(TS_I386))
+    #define TS_CSA_X86_VECTORS 1
+#endif
+
+#if defined(TS_GCC) || defined(TS_LLVM)
+    #define TS_CSA_INLINE inline __attribute__((always_inline))
+#else
+    #define TS_CSA_INLINE inline
+#endif
+
+namespace {
+
+    // Maximum number of packets which are processed in parallel (AVX-512).
+    const size_t CSA_MAX_LANES = 512;
+
+#if defined(TS_CSA_X86_VECTORS)
+    typedef uint64_t csa_v128 __attribute__((vector_size(16)));
+    typedef uint64_t csa_v256 __attribute__((vector_size(32)));
+    typedef uint64_t csa_v512 __attribute__((vector_size(64)));
+#endif
+
+    // Word manipulations. Words are never passed by value to avoid ABI issues with vectors.
+    template <typename W>
+    TS_CSA_INLINE void CSAFill(W& w, bool set)
+    {
+        std::memset(&w, set ? 0xFF : 0x00, sizeof(W));
+    }
+
+    // Transpose a 64x64 bit matrix: bit c of a[r] becomes bit r of a[c].
+    TS_CSA_INLINE void CSATranspose64(uint64_t a[64])
+    {
+        uint64_t m = TS_UCONST64(0x00000000FFFFFFFF);
+        for (size_t j = 32; j != 0; j >>= 1, m ^= m << j) {
+            for (size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+                const uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+                a[k] ^= t << j;
+                a[k | j] ^= t;
+            }
+        }
+    }
+
+    // Compute a 5-to-2 bits s-box from the ANF of its two output bits.
+    // In the ANF masks, bit n is set when the monomial made of the inputs
+    // which are set in the binary representation of n is present.
+    template <typename W>
+    TS_CSA_INLINE void CSASbox(W out[2], const W& x4, const W& x3, const W& x2, const W& x1, const W& x0, uint32_t anf0, uint32_t anf1)
+    {
+        const W* const in[5] = {&x0, &x1, &x2, &x3, &x4};
+        W mono[32];
+        CSAFill(mono[0], true);
+        for (size_t i = 0; i < 5; ++i) {
+            const size_t bit = size_t(1) << i;
+            for (size_t k = 0; k < bit; ++k) {
+                mono[bit + k] = mono[k] & *in[i];
+            }
+        }
+        CSAFill(out[0], false);
+        CSAFill(out[1], false);
+        for (size_t k = 0; k < 32; ++k) {
+            if ((anf0 & (uint32_t(1) << k)) != 0) {
+                out[0] ^= mono[k];
+            }
+            if ((anf1 & (uint32_t(1) << k)) != 0) {
+                out[1] ^= mono[k];
+            }
+        }
+    }
+
+    // Bitsliced state of the stream cipher, same names as in StreamCipher.
+    // Index 0 of A and B is unused. Each nibble has 4 bit words.
+    template <typename W>
+    struct CSASlicedStream
+    {
+        W A[11][4], B[11][4], X[4], Y[4], Z[4], D[4], E[4], F[4], p, q, r;
+
+        // Load a control word in all lanes.
+        TS_CSA_INLINE void init(const uint8_t* key)
+        {
+            for (size_t n = 0; n < 4; ++n) {
+                for (size_t k = 0; k < 4; ++k) {
+                    CSAFill(A[2*n+1][k], ((key[n] >> (k + 4)) & 1) != 0);
+                    CSAFill(A[2*n+2][k], ((key[n] >> k) & 1) != 0);
+                    CSAFill(B[2*n+1][k], ((key[n+4] >> (k + 4)) & 1) != 0);
+                    CSAFill(B[2*n+2][k], ((key[n+4] >> k) & 1) != 0);
+                }
+            }
+            for (size_t k = 0; k < 4; ++k) {
+                CSAFill(A[9][k], false);
+                CSAFill(A[10][k], false);
+                CSAFill(B[9][k], false);
+                CSAFill(B[10][k], false);
+                CSAFill(X[k], false);
+                CSAFill(Y[k], false);
+                CSAFill(Z[k], false);
+                CSAFill(D[k], false);
+                CSAFill(E[k], false);
+                CSAFill(F[k], false);
+            }
+            CSAFill(p, false);
+            CSAFill(q, false);
+            CSAFill(r, false);
+        }
+
+        // One round, 2 output bits. During initialization, in points to the 8 bits of the input byte.
+        TS_CSA_INLINE void round(const W* in, size_t j, W& out1, W& out0)
+        {
+            W s1[2], s2[2], s3[2], s4[2], s5[2], s6[2], s7[2];
+            CSASbox(s1, A[4][0], A[1][2], A[6][1], A[7][3], A[9][0], 0x35020B24, 0x5D59766F);
+            CSASbox(s2, A[2][1], A[3][2], A[6][3], A[7][0], A[9][1], 0x29182835, 0x1E4001E7);
+            CSASbox(s3, A[1][3], A[2][0], A[5][1], A[5][3], A[6][2], 0x0001012C, 0x52FD5FE7);
+            CSASbox(s4, A[3][3], A[1][1], A[2][3], A[4][2], A[8][0], 0x5B861A1D, 0x5B87419B);
+            CSASbox(s5, A[5][2], A[4][3], A[6][0], A[8][1], A[9][2], 0x0FF226B8, 0x66D66BEF);
+            CSASbox(s6, A[3][1], A[4][1], A[5][0], A[7][2], A[9][3], 0x48C854D2, 0x02093824);
+            CSASbox(s7, A[2][2], A[3][0], A[7][1], A[8][2], A[8][3], 0x0C0111DA, 0x48DA091E);
+
+            W extra_B[4];
+            extra_B[3] = B[3][0] ^ B[6][1] ^ B[7][2] ^ B[9][3];
+            extra_B[2] = B[6][0] ^ B[8][1] ^ B[3][3] ^ B[4][2];
+            extra_B[1] = B[5][3] ^ B[8][2] ^ B[4][0] ^ B[5][1];
+            extra_B[0] = B[9][2] ^ B[6][3] ^ B[3][1] ^ B[8][0];
+
+            // T1 and T2, input byte is used during initialization only.
+            W next_A1[4], next_B1[4];
+            for (size_t k = 0; k < 4; ++k) {
+                next_A1[k] = A[10][k] ^ X[k];
+                next_B1[k] = B[7][k] ^ B[10][k] ^ Y[k];
+                if (in != nullptr) {
+                    next_A1[k] ^= D[k] ^ in[(j % 2) != 0 ? k : k + 4];
+                    next_B1[k] ^= in[(j % 2) != 0 ? k + 4 : k];
+                }
+            }
+
+            // If p=1, rotate next_B1 left.
+            W rot_B1[4];
+            for (size_t k = 0; k < 4; ++k) {
+                rot_B1[k] = next_B1[k] ^ ((next_B1[k] ^ next_B1[(k + 3) % 4]) & p);
+            }
+
+            // T3 and T4. When q=1, F = Z + E + r and r is the carry.
+            W carry = r;
+            for (size_t k = 0; k < 4; ++k) {
+                D[k] = E[k] ^ Z[k] ^ extra_B[k];
+                const W sum = Z[k] ^ E[k] ^ carry;
+                carry = (Z[k] & E[k]) | (carry & (Z[k] ^ E[k]));
+                const W next_F = E[k] ^ ((sum ^ E[k]) & q);
+                E[k] = F[k];
+                F[k] = next_F;
+            }
+            r ^= (carry ^ r) & q;
+
+            // Shift registers.
+            for (size_t n = 10; n > 1; --n) {
+                for (size_t k = 0; k < 4; ++k) {
+                    A[n][k] = A[n-1][k];
+                    B[n][k] = B[n-1][k];
+                }
+            }
+            for (size_t k = 0; k < 4; ++k) {
+                A[1][k] = next_A1[k];
+                B[1][k] = rot_B1[k];
+            }
+
+            X[3] = s4[0]; X[2] = s3[0]; X[1] = s2[1]; X[0] = s1[1];
+            Y[3] = s6[0]; Y[2] = s5[0]; Y[1] = s4[1]; Y[0] = s3[1];
+            Z[3] = s2[0]; Z[2] = s1[0]; Z[1] = s6[1]; Z[0] = s5[1];
+            p = s7[1];
+            q = s7[0];
+
+            // 2 output bits are a function of the 4 bits of D.
+            out1 = D[2] ^ D[3];
+            out0 = D[0] ^ D[1];
+        }
+    };
+
+    // Compute the keystreams of 64*sizeof(W)/8 packets.
+    // The 8-byte initialization block of packet n is iv[n]. Block i of the keystream of
+    // packet n is returned in ks[n * stride + i]. All 64-bit values are little endian
+    // representations of 8-byte blocks (bit 8*i+j is bit j of byte i).
+    template <typename W>
+    TS_CSA_INLINE void CSAKeyStream(const uint8_t* key, const uint64_t* iv, size_t nks, uint64_t* ks, size_t stride)
+    {
+        const size_t groups = sizeof(W) / 8;
+        CSASlicedStream<W> state;
+        W slices[64];
+        uint64_t matrix[64];
+
+        // Stream cipher initialization with the first block of each packet.
+        state.init(key);
+        for (size_t g = 0; g < groups; ++g) {
+            std::memcpy(matrix, iv + 64 * g, sizeof(matrix));
+            CSATranspose64(matrix);
+            for (size_t c = 0; c < 64; ++c) {
+                std::memcpy(reinterpret_cast<uint8_t*>(&slices[c]) + 8 * g, &matrix[c], 8);
+            }
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                W out1, out0;
+                state.round(slices + 8 * i, j, out1, out0);
+            }
+        }
+
+        // Generation of the keystream blocks.
+        for (size_t n = 0; n < nks; ++n) {
+            for (size_t i = 0; i < 8; ++i) {
+                for (size_t j = 0; j < 4; ++j) {
+                    state.round(nullptr, j, slices[8 * i + 7 - 2 * j], slices[8 * i + 6 - 2 * j]);
+                }
+            }
+            for (size_t g = 0; g < groups; ++g) {
+                for (size_t c = 0; c < 64; ++c) {
+                    std::memcpy(&matrix[c], reinterpret_cast<const uint8_t*>(&slices[c]) + 8 * g, 8);
+                }
+                CSATranspose64(matrix);
+                for (size_t k = 0; k < 64; ++k) {
+                    ks[(64 * g + k) * stride + n] = matrix[k];
+                }
+            }
+        }
+    }
+
+    // Instances of the bitsliced keystream generator.
+    typedef void (*CSAKeyStreamFunction)(const uint8_t* key, const uint64_t* iv, size_t nks, uint64_t* ks, size_t stride);
+
+    void CSAKeyStream64(const uint8_t* key, const uint64_t* iv, size_t nks, uint64_t* ks, size_t stride)
+    {
+        CSAKeyStream<uint64_t>(key, iv, nks, ks, stride);
+    }
+
+#if defined(TS_CSA_X86_VECTORS)
+    __attribute__((target("sse2")))
+    void CSAKeyStream128(const uint8_t* key, const uint64_t* iv, size_t nks, uint64_t* ks, size_t stride)
+    {
+        CSAKeyStream<csa_v128>(key, iv, nks, ks, stride);
+    }
+
+    __attribute__((target("avx2")))
+    void CSAKeyStream256(const uint8_t* key, const uint64_t* iv, size_t nks, uint64_t* ks, size_t stride)
+    {
+        CSAKeyStream<csa_v256>(key, iv, nks, ks, stride);
+    }
+
+    __attribute__((target("avx512f")))
+    void CSAKeyStream512(const uint8_t* key, const uint64_t* iv, size_t nks, uint64_t* ks, size_t stride)
+    {
+        CSAKeyStream<csa_v512>(key, iv, nks, ks, stride);
+    }
+#endif
+
+    // Description of an implementation of the bitsliced keystream generator.
+    struct CSAKeyStreamImpl
+    {
+        const ts::UChar*     name;
+        size_t               lanes;
+        CSAKeyStreamFunction func;
+    };
+
+    // List of implementations which are supported by the CPU, from narrowest to widest.
+    class CSAKeyStreamImpls
+    {
+        TS_NOCOPY(CSAKeyStreamImpls);
+    public:
+        size_t           count;
+        CSAKeyStreamImpl impl[4];
+
+        CSAKeyStreamImpls() :
+            count(0),
+            impl()
+        {
+            add(u"portable", 64, CSAKeyStream64);
+#if defined(TS_CSA_X86_VECTORS)
+            const ts::SysInfo* const sys = ts::SysInfo::Instance();
+            if (sys->cpuHasFeatures(ts::SysInfo::CPU_SSE2)) {
+                add(u"SSE2", 128, CSAKeyStream128);
+            }
+            if (sys->cpuHasFeatures(ts::SysInfo::CPU_AVX2)) {
+                add(u"AVX2", 256, CSAKeyStream256);
+            }
+            if (sys->cpuHasFeatures(ts::SysInfo::CPU_AVX512F)) {
+                add(u"AVX-512", 512, CSAKeyStream512);
+            }
+#endif
+        }
+
+        // Select the narrowest implementation which processes the given number of packets at once.
+        const CSAKeyStreamImpl& select(size_t packets) const
+        {
+            size_t i = 0;
+            while (i + 1 < count && impl[i].lanes < packets) {
+                i++;
+            }
+            return impl[i];
+        }
+
+    private:
+        void add(const ts::UChar* name, size_t lanes, CSAKeyStreamFunction func)
+        {
+            impl[count].name = name;
+            impl[count].lanes = lanes;
+            impl[count].func = func;
+            count++;
+        }
+    };
+
+    const CSAKeyStreamImpls& CSAKeyStreamList()
+    {
+        static const CSAKeyStreamImpls list;
+        return list;
+    }
+
+    // Below this number of packets, the bitsliced implementation is slower than the classical one.
+    const size_t CSA_MIN_BATCH = 8;
+}
+
+
 //----------------------------------------------------------------------------
 // Set the control word for subsequent encrypt/decrypt operations
 //----------------------------------------------------------------------------
@@ -719,6 +1049,180 @@ bool ts::DVBCSA2::decryptInPlaceImpl(void* addr, size_t size, size_t* max_actual
 }
 
 
+//----------------------------------------------------------------------------
+// Encrypt or decrypt several data blocks in place.
+//----------------------------------------------------------------------------
+
+ts::UString ts::DVBCSA2::BatchImplementation()
+{
+    const CSAKeyStreamImpls& list(CSAKeyStreamList());
+    return list.impl[list.count - 1].name;
+}
+
+bool ts::DVBCSA2::checkBatch(size_t count, void* const data[], const size_t sizes[]) const
+{
+    if (!_init || (count > 0 && (data == nullptr || sizes == nullptr))) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if ((data[i] == nullptr && sizes[i] > 0) || sizes[i] > MAX_DATA_SIZE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::DVBCSA2::encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    if (!checkBatch(count, data, sizes)) {
+        return false;
+    }
+
+    const CSAKeyStreamImpls& list(CSAKeyStreamList());
+    _batch_work.resize((MAX_NBLOCKS + 1) * 8 * CSA_MAX_LANES);
+    uint64_t* const ivs = reinterpret_cast<uint64_t*>(_batch_work.data());
+    uint64_t* const ks = ivs + CSA_MAX_LANES;
+
+    while (count > 0) {
+
+        // Process small sets of packets using the classical implementation.
+        if (count < CSA_MIN_BATCH) {
+            for (size_t i = 0; i < count; ++i) {
+                if (sizes[i] > 0 && !encryptInPlace(data[i], sizes[i])) {
+                    return false;
+                }
+            }
+            break;
+        }
+
+        const CSAKeyStreamImpl& impl(list.select(count));
+        const size_t lanes = std::min(count, impl.lanes);
+        size_t nks = 0;
+
+        // Perform block cipher in reverse CBC mode on each packet. The intermediate blocks
+        // replace the clear data. The first block is used to initialize the stream cipher.
+        for (size_t n = 0; n < lanes; ++n) {
+            if (!allowEncrypt()) {
+                return false;
+            }
+            uint8_t* const pkt = reinterpret_cast<uint8_t*>(data[n]);
+            const size_t nblocks = sizes[n] / 8;
+            ivs[n] = 0;
+            if (nblocks > 0) {
+                uint8_t ib[8];
+                uint8_t iblock[8];
+                clear_8(ib);
+                for (size_t i = nblocks; i-- > 0; ) {
+                    xor_8(iblock, pkt + 8*i, ib);
+                    _block.encipher(iblock, ib);
+                    memcpy_8(pkt + 8*i, ib);
+                }
+                ivs[n] = GetUInt64LE(pkt);
+                nks = std::max(nks, nblocks - 1 + (sizes[n] % 8 != 0 ? 1 : 0));
+            }
+        }
+        std::memset(ivs + lanes, 0, (impl.lanes - lanes) * sizeof(uint64_t));
+
+        // Compute the keystreams of all packets at once.
+        impl.func(_key, ivs, nks, ks, MAX_NBLOCKS);
+
+        // Apply the keystreams on all blocks, except the first one, and on the residue.
+        for (size_t n = 0; n < lanes; ++n) {
+            uint8_t* const pkt = reinterpret_cast<uint8_t*>(data[n]);
+            const size_t size = sizes[n];
+            if (size >= 8) {
+                const uint64_t* const pks = ks + n * MAX_NBLOCKS;
+                size_t i = 1;
+                for (; 8 * i + 8 <= size; ++i) {
+                    PutUInt64LE(pkt + 8*i, GetUInt64LE(pkt + 8*i) ^ pks[i-1]);
+                }
+                for (size_t k = 8 * i; k < size; ++k) {
+                    pkt[k] ^= uint8_t(pks[i-1] >> (8 * (k % 8)));
+                }
+            }
+        }
+
+        data += lanes;
+        sizes += lanes;
+        count -= lanes;
+    }
+    return true;
+}
+
+bool ts::DVBCSA2::decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[])
+{
+    if (!checkBatch(count, data, sizes)) {
+        return false;
+    }
+
+    const CSAKeyStreamImpls& list(CSAKeyStreamList());
+    _batch_work.resize((MAX_NBLOCKS + 1) * 8 * CSA_MAX_LANES);
+    uint64_t* const ivs = reinterpret_cast<uint64_t*>(_batch_work.data());
+    uint64_t* const ks = ivs + CSA_MAX_LANES;
+
+    while (count > 0) {
+
+        // Process small sets of packets using the classical implementation.
+        if (count < CSA_MIN_BATCH) {
+            for (size_t i = 0; i < count; ++i) {
+                if (sizes[i] > 0 && !decryptInPlace(data[i], sizes[i])) {
+                    return false;
+                }
+            }
+            break;
+        }
+
+        const CSAKeyStreamImpl& impl(list.select(count));
+        const size_t lanes = std::min(count, impl.lanes);
+        size_t nks = 0;
+
+        // The stream cipher is initialized with the first 8 bytes of each scrambled packet.
+        for (size_t n = 0; n < lanes; ++n) {
+            if (!allowDecrypt()) {
+                return false;
+            }
+            const size_t size = sizes[n];
+            ivs[n] = 0;
+            if (size >= 8) {
+                ivs[n] = GetUInt64LE(data[n]);
+                nks = std::max(nks, size / 8 - 1 + (size % 8 != 0 ? 1 : 0));
+            }
+        }
+        std::memset(ivs + lanes, 0, (impl.lanes - lanes) * sizeof(uint64_t));
+
+        // Compute the keystreams of all packets at once.
+        impl.func(_key, ivs, nks, ks, MAX_NBLOCKS);
+
+        // Decipher the blocks of each packet, same as decryptInPlaceImpl().
+        for (size_t n = 0; n < lanes; ++n) {
+            uint8_t* const pkt = reinterpret_cast<uint8_t*>(data[n]);
+            const size_t size = sizes[n];
+            const size_t nblocks = size / 8;
+            if (nblocks > 0) {
+                const uint64_t* const pks = ks + n * MAX_NBLOCKS;
+                uint8_t ib[8];
+                uint8_t oblock[8];
+                memcpy_8(ib, pkt);
+                for (size_t i = 1; i < nblocks; i++) {
+                    _block.decipher(ib, oblock);
+                    PutUInt64LE(ib, GetUInt64LE(pkt + 8*i) ^ pks[i-1]);
+                    xor_8(pkt + 8*(i-1), ib, oblock);
+                }
+                _block.decipher(ib, pkt + 8*(nblocks-1));
+                for (size_t k = 8 * nblocks; k < size; ++k) {
+                    pkt[k] ^= uint8_t(pks[nblocks-1] >> (8 * (k % 8)));
+                }
+            }
+        }
+
+        data += lanes;
+        sizes += lanes;
+        count -= lanes;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Wrappers for encrypt and decrypt.
 //----------------------------------------------------------------------------
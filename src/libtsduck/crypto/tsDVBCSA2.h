@@ -88,6 +88,43 @@ namespace ts {
         //!
         static bool IsReducedCW(const uint8_t *cw);
 
+        //!
+        //! Maximum size in bytes of a data block to scramble or descramble (the payload of a TS packet).
+        //!
+        static const size_t MAX_DATA_SIZE = 184;
+
+        //!
+        //! Encrypt several data blocks in place, all with the current control word.
+        //!
+        //! This is typically used to scramble the payloads of many TS packets at once. The data blocks
+        //! are processed in parallel using a bitsliced implementation of the stream cipher. Depending on
+        //! the CPU, 64 (portable implementation), 128 (SSE2), 256 (AVX2) or 512 (AVX-512) data blocks
+        //! are processed at a time. The result is identical to individual calls to encryptInPlace().
+        //!
+        //! @param [in] count Number of data blocks.
+        //! @param [in,out] data Array of @a count addresses of data blocks to encrypt.
+        //! @param [in] sizes Array of @a count sizes in bytes of the data blocks. Each size must not
+        //! exceed MAX_DATA_SIZE. Data blocks shorter than 8 bytes are left unchanged.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]) override;
+
+        //!
+        //! Decrypt several data blocks in place, all with the current control word.
+        //! @param [in] count Number of data blocks.
+        //! @param [in,out] data Array of @a count addresses of data blocks to decrypt.
+        //! @param [in] sizes Array of @a count sizes in bytes of the data blocks.
+        //! @return True on success, false on error.
+        //! @see encryptInPlaceBatch()
+        //!
+        virtual bool decryptInPlaceBatch(size_t count, void* const data[], const size_t sizes[]) override;
+
+        //!
+        //! Get the name of the bitsliced implementation which is used on this CPU.
+        //! @return The implementation name, for instance "AVX2".
+        //!
+        static UString BatchImplementation();
+
         // Implementation of CipherChaining interface. Cannot set IV with DVB CSA.
         virtual bool setIV(const void*, size_t) override;
         virtual size_t minIVSize() const override;
@@ -151,5 +188,9 @@ namespace ts {
         uint8_t      _key[KEY_SIZE];
         BlockCipher  _block;
         StreamCipher _stream;
+        ByteBlock    _batch_work;  // Work area for multi-packet processing.
+
+        // Check the parameters of a multi-packet operation.
+        bool checkBatch(size_t count, void* const data[], const size_t sizes[]) const;
     };
 }
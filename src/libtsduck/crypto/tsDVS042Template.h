@@ -192,6 +192,24 @@ bool ts::DVS042<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, v
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
 
+    // When the cipher and plain texts do not overlap, decrypt all blocks at once,
+    // possibly in parallel, and then XOR each block with the previous cipher text.
+    const size_t count = cipher_length / this->block_size;
+    if (count > 1 && (ct + count * this->block_size <= pt || pt + count * this->block_size <= ct)) {
+        if (!this->algo->decryptBlocks(ct, pt, count)) {
+            return false;
+        }
+        for (size_t blk = 0; blk < count; ++blk) {
+            for (size_t i = 0; i < this->block_size; ++i) {
+                pt[i] ^= previous[i];
+            }
+            previous = ct;
+            ct += this->block_size;
+            pt += this->block_size;
+        }
+        cipher_length -= count * this->block_size;
+    }
+
     while (cipher_length >= this->block_size) {
         // work = decrypt (cipher-text)
         if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
@@ -34,7 +34,7 @@
 #include "tsPSIRepository.h"
 #include "tsPSIBuffer.h"
 #include "tsDuckContext.h"
-#include "tsxmlElement.h"
+#include "tsxmlTreeSerializer.h"
 TSDUCK_SOURCE;
 
 #define MY_XML_NAME u"content_descriptor"
@@ -113,12 +113,19 @@ void ts::ContentDescriptor::DisplayDescriptor(TablesDisplay& disp, PSIBuffer& bu
 //----------------------------------------------------------------------------
 
 void ts::ContentDescriptor::buildXML(DuckContext& duck, xml::Element* root) const
+{
+    xml::TreeSerializer output(root);
+    serializeXML(duck, output);
+}
+
+void ts::ContentDescriptor::serializeXML(DuckContext& duck, xml::Serializer& output) const
 {
     for (auto it = entries.begin(); it != entries.end(); ++it) {
-        xml::Element* e = root->addElement(u"content");
-        e->setIntAttribute(u"content_nibble_level_1", it->content_nibble_level_1);
-        e->setIntAttribute(u"content_nibble_level_2", it->content_nibble_level_2);
-        e->setIntAttribute(u"user_byte", uint8_t((it->user_nibble_1 << 4) | it->user_nibble_2), true);
+        output.startElement(u"content");
+        output.setIntAttribute(u"content_nibble_level_1", it->content_nibble_level_1);
+        output.setIntAttribute(u"content_nibble_level_2", it->content_nibble_level_2);
+        output.setIntAttribute(u"user_byte", uint8_t((it->user_nibble_1 << 4) | it->user_nibble_2), true);
+        output.endElement();
     }
 }
 
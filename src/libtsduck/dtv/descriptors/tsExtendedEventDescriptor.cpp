@@ -34,7 +34,7 @@
 #include "tsPSIRepository.h"
 #include "tsPSIBuffer.h"
 #include "tsDuckContext.h"
-#include "tsxmlElement.h"
+#include "tsxmlTreeSerializer.h"
 TSDUCK_SOURCE;
 
 #define MY_XML_NAME u"extended_event_descriptor"
@@ -281,15 +281,28 @@ void ts::ExtendedEventDescriptor::DisplayDescriptor(TablesDisplay& disp, PSIBuff
 
 void ts::ExtendedEventDescriptor::buildXML(DuckContext& duck, xml::Element* root) const
 {
-    root->setIntAttribute(u"descriptor_number", descriptor_number, false);
-    root->setIntAttribute(u"last_descriptor_number", last_descriptor_number, false);
-    root->setAttribute(u"language_code", language_code);
-    root->addElement(u"text")->addText(text);
+    xml::TreeSerializer output(root);
+    serializeXML(duck, output);
+}
+
+void ts::ExtendedEventDescriptor::serializeXML(DuckContext& duck, xml::Serializer& output) const
+{
+    output.setIntAttribute(u"descriptor_number", descriptor_number, false);
+    output.setIntAttribute(u"last_descriptor_number", last_descriptor_number, false);
+    output.setAttribute(u"language_code", language_code);
+    output.startElement(u"text");
+    output.addText(text);
+    output.endElement();
 
     for (EntryList::const_iterator it = entries.begin(); it != entries.end(); ++it) {
-        xml::Element* e = root->addElement(u"item");
-        e->addElement(u"description")->addText(it->item_description);
-        e->addElement(u"name")->addText(it->item);
+        output.startElement(u"item");
+        output.startElement(u"description");
+        output.addText(it->item_description);
+        output.endElement();
+        output.startElement(u"name");
+        output.addText(it->item);
+        output.endElement();
+        output.endElement();
     }
 }
 
@@ -33,7 +33,7 @@
 #include "tsPSIRepository.h"
 #include "tsPSIBuffer.h"
 #include "tsDuckContext.h"
-#include "tsxmlElement.h"
+#include "tsxmlTreeSerializer.h"
 TSDUCK_SOURCE;
 
 #define MY_XML_NAME u"short_event_descriptor"
@@ -176,9 +176,19 @@ void ts::ShortEventDescriptor::DisplayDescriptor(TablesDisplay& disp, PSIBuffer&
 
 void ts::ShortEventDescriptor::buildXML(DuckContext& duck, xml::Element* root) const
 {
-    root->setAttribute(u"language_code", language_code);
-    root->addElement(u"event_name")->addText(event_name);
-    root->addElement(u"text")->addText(text);
+    xml::TreeSerializer output(root);
+    serializeXML(duck, output);
+}
+
+void ts::ShortEventDescriptor::serializeXML(DuckContext& duck, xml::Serializer& output) const
+{
+    output.setAttribute(u"language_code", language_code);
+    output.startElement(u"event_name");
+    output.addText(event_name);
+    output.endElement();
+    output.startElement(u"text");
+    output.addText(text);
+    output.endElement();
 }
 
 
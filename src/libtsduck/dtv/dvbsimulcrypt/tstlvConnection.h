@@ -113,6 +113,24 @@ namespace ts {
             //!
             bool receive(MessagePtr& msg, const AbortInterface* abort, Logger& logger);
 
+            //!
+            //! Receive the TLV messages which are available, without waiting for complete messages.
+            //! This method is designed for event-driven applications which monitor many connections
+            //! using poll(), epoll() or similar mechanisms. It performs exactly one receive operation
+            //! on the socket, which never blocks. When no data is available yet, for instance when the
+            //! socket was reported as readable too early, no message is returned and this is not an error.
+            //! All complete messages are deserialized and validated. The data of an incomplete
+            //! message are kept for the next call. Invalid messages are processed as in receive().
+            //! This method shall not be mixed with receive() on the same connection.
+            //! @param [in,out] msgs The received messages are appended to this vector.
+            //! @param [in,out] logger Where to report errors and messages.
+            //! @param [in,out] responses If not null, the automatic error responses to invalid
+            //! messages are appended to this vector instead of being sent. This is useful when
+            //! the application must not block on sending.
+            //! @return True on success, false on error or disconnection.
+            //!
+            bool receiveAvailable(std::vector<MessagePtr>& msgs, Logger& logger, std::vector<MessagePtr>* responses = nullptr);
+
             //!
             //! Get invalid incoming messages processing.
             //! @return True if, when an invalid message is received, the corresponding
@@ -155,6 +173,12 @@ namespace ts {
             size_t          _invalid_msg_count;
             MUTEX           _send_mutex;
             MUTEX           _receive_mutex;
+            ByteBlock       _in_buffer;   // Incomplete message data in receiveAvailable().
+
+            // Analyze a received message. Set msg to null if the message is invalid.
+            // The automatic error response is sent or appended to responses if not null.
+            // Return false if the connection shall be abandoned.
+            bool analyzeMessage(const uint8_t* data, size_t size, MessagePtr& msg, Logger& logger, std::vector<MessagePtr>* responses);
         };
     }
 }
@@ -46,7 +46,8 @@ ts::tlv::Connection<MUTEX>::Connection(const Protocol* protocol, bool auto_error
     _max_invalid_msg(max_invalid_msg),
     _invalid_msg_count(0),
     _send_mutex(),
-    _receive_mutex()
+    _receive_mutex(),
+    _in_buffer()
 {
 }
 
@@ -65,6 +66,7 @@ void ts::tlv::Connection<MUTEX>::handleConnected(Report& report)
 {
     SuperClass::handleConnected(report);
     _invalid_msg_count = 0;
+    _in_buffer.clear();
 }
 
 TS_POP_WARNING()
@@ -135,33 +137,106 @@ bool ts::tlv::Connection<MUTEX>::receive(MessagePtr& msg, const AbortInterface*
         }
 
         // Analyze the message
-        MessageFactory mf(bb.data(), bb.size(), _protocol);
-        if (mf.errorStatus() == tlv::OK) {
-            _invalid_msg_count = 0;
-            mf.factory(msg);
-            if (!msg.isNull()) {
-                logger.log(*msg, u"received message from " + peerName());
-            }
+        if (!analyzeMessage(bb.data(), bb.size(), msg, logger, nullptr)) {
+            return false;
+        }
+        else if (_invalid_msg_count == 0) {
             return true;
         }
+    }
+}
 
-        // Received an invalid message
-        _invalid_msg_count++;
 
-        // Send back an error message if necessary
-        if (_auto_error_response) {
-            MessagePtr resp;
-            mf.buildErrorResponse(resp);
-            if (!send(*resp, logger.report())) {
-                return false;
-            }
+//----------------------------------------------------------------------------
+// Receive the available TLV messages, without waiting for complete messages.
+//----------------------------------------------------------------------------
+
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::receiveAvailable(std::vector<MessagePtr>& msgs, Logger& logger, std::vector<MessagePtr>* responses)
+{
+    const bool has_version(_protocol->hasVersion());
+    const size_t header_size(has_version ? 5 : 4);
+    const size_t length_offset(has_version ? 3 : 2);
+
+    Guard lock(_receive_mutex);
+
+    // Append the available data to the previous incomplete message, if any.
+    const size_t previous = _in_buffer.size();
+    size_t ret_size = 0;
+    _in_buffer.resize(std::max<size_t>(previous + 4096, 2 * previous));
+    if (!SuperClass::receiveNoWait(_in_buffer.data() + previous, _in_buffer.size() - previous, ret_size, logger.report())) {
+        _in_buffer.clear();
+        return false;
+    }
+    _in_buffer.resize(previous + ret_size);
+    if (ret_size == 0) {
+        // No data yet, the socket was reported as readable too early or the data were already read.
+        return true;
+    }
+
+    // Extract all complete messages.
+    size_t start = 0;
+    while (_in_buffer.size() - start >= header_size) {
+        const size_t size = header_size + GetUInt16(_in_buffer.data() + start + length_offset);
+        if (_in_buffer.size() - start < size) {
+            break;
         }
+        MessagePtr msg;
+        if (!analyzeMessage(_in_buffer.data() + start, size, msg, logger, responses)) {
+            _in_buffer.clear();
+            return false;
+        }
+        if (!msg.isNull()) {
+            msgs.push_back(msg);
+        }
+        start += size;
+    }
+
+    // Keep the incomplete message for next time.
+    _in_buffer.erase(0, start);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a received message.
+//----------------------------------------------------------------------------
 
-        // If invalid message max has been reached, break the connection
-        if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
-            logger.report().error(u"too many invalid messages from %s, disconnecting", {peerName()});
-            disconnect(logger.report());
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::analyzeMessage(const uint8_t* data, size_t size, MessagePtr& msg, Logger& logger, std::vector<MessagePtr>* responses)
+{
+    msg.clear();
+
+    MessageFactory mf(data, size, _protocol);
+    if (mf.errorStatus() == tlv::OK) {
+        _invalid_msg_count = 0;
+        mf.factory(msg);
+        if (!msg.isNull()) {
+            logger.log(*msg, u"received message from " + peerName());
+        }
+        return true;
+    }
+
+    // Received an invalid message
+    _invalid_msg_count++;
+
+    // Send back an error message if necessary
+    if (_auto_error_response) {
+        MessagePtr resp;
+        mf.buildErrorResponse(resp);
+        if (responses != nullptr) {
+            responses->push_back(resp);
+        }
+        else if (!send(*resp, logger.report())) {
             return false;
         }
     }
+
+    // If invalid message max has been reached, break the connection
+    if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
+        logger.report().error(u"too many invalid messages from %s, disconnecting", {peerName()});
+        disconnect(logger.report());
+        return false;
+    }
+    return true;
 }
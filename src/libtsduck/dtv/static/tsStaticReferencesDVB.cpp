@@ -52,6 +52,8 @@
 #include "tshlsOutputPlugin.h"
 #include "tsSRTInputPlugin.h"
 #include "tsSRTOutputPlugin.h"
+#include "tsSharedMemoryInputPlugin.h"
+#include "tsSharedMemoryOutputPlugin.h"
 TSDUCK_SOURCE;
 
 // Macros to generate a unique symbol name.
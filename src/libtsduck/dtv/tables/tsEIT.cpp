@@ -38,7 +38,7 @@
 #include "tsPSIRepository.h"
 #include "tsPSIBuffer.h"
 #include "tsDuckContext.h"
-#include "tsxmlElement.h"
+#include "tsxmlTreeSerializer.h"
 TSDUCK_SOURCE;
 
 #define MY_XML_NAME u"EIT"
@@ -475,29 +475,37 @@ void ts::EIT::DisplaySection(TablesDisplay& disp, const ts::Section& section, PS
 //----------------------------------------------------------------------------
 
 void ts::EIT::buildXML(DuckContext& duck, xml::Element* root) const
+{
+    // EIT's are frequently converted in large numbers, they are directly serialized.
+    xml::TreeSerializer output(root);
+    serializeXML(duck, output);
+}
+
+void ts::EIT::serializeXML(DuckContext& duck, xml::Serializer& output) const
 {
     if (isPresentFollowing()) {
-        root->setAttribute(u"type", u"pf");
+        output.setAttribute(u"type", u"pf");
     }
     else {
-        root->setIntAttribute(u"type", _table_id - (isActual() ? TID_EIT_S_ACT_MIN : TID_EIT_S_OTH_MIN));
+        output.setIntAttribute(u"type", _table_id - (isActual() ? TID_EIT_S_ACT_MIN : TID_EIT_S_OTH_MIN));
     }
-    root->setIntAttribute(u"version", version);
-    root->setBoolAttribute(u"current", is_current);
-    root->setBoolAttribute(u"actual", isActual());
-    root->setIntAttribute(u"service_id", service_id, true);
-    root->setIntAttribute(u"transport_stream_id", ts_id, true);
-    root->setIntAttribute(u"original_network_id", onetw_id, true);
-    root->setIntAttribute(u"last_table_id", last_table_id, true);
+    output.setIntAttribute(u"version", version);
+    output.setBoolAttribute(u"current", is_current);
+    output.setBoolAttribute(u"actual", isActual());
+    output.setIntAttribute(u"service_id", service_id, true);
+    output.setIntAttribute(u"transport_stream_id", ts_id, true);
+    output.setIntAttribute(u"original_network_id", onetw_id, true);
+    output.setIntAttribute(u"last_table_id", last_table_id, true);
 
     for (auto it = events.begin(); it != events.end(); ++it) {
-        xml::Element* e = root->addElement(u"event");
-        e->setIntAttribute(u"event_id", it->second.event_id, true);
-        e->setDateTimeAttribute(u"start_time", it->second.start_time);
-        e->setTimeAttribute(u"duration", it->second.duration);
-        e->setEnumAttribute(RST::RunningStatusNames, u"running_status", it->second.running_status);
-        e->setBoolAttribute(u"CA_mode", it->second.CA_controlled);
-        it->second.descs.toXML(duck, e);
+        output.startElement(u"event");
+        output.setIntAttribute(u"event_id", it->second.event_id, true);
+        output.setDateTimeAttribute(u"start_time", it->second.start_time);
+        output.setTimeAttribute(u"duration", it->second.duration);
+        output.setEnumAttribute(RST::RunningStatusNames, u"running_status", it->second.running_status);
+        output.setBoolAttribute(u"CA_mode", it->second.CA_controlled);
+        it->second.descs.toXML(duck, output);
+        output.endElement();
     }
 }
 
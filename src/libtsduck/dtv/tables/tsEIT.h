@@ -367,6 +367,7 @@ namespace ts {
         virtual void serializePayload(BinaryTable&, PSIBuffer&) const override;
         virtual void deserializePayload(PSIBuffer&, const Section&) override;
         virtual void buildXML(DuckContext&, xml::Element*) const override;
+        virtual void serializeXML(DuckContext&, xml::Serializer&) const override;
         virtual bool analyzeXML(DuckContext&, const xml::Element*) override;
 
     private:
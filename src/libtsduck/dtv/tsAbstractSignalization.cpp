@@ -31,6 +31,7 @@
 #include "tsDuckContext.h"
 #include "tsByteBlock.h"
 #include "tsxmlElement.h"
+#include "tsxmlSerializer.h"
 TSDUCK_SOURCE;
 
 const ts::UChar* const ts::AbstractSignalization::XML_GENERIC_DESCRIPTOR  = u"generic_descriptor";
@@ -113,6 +114,22 @@ ts::xml::Element* ts::AbstractSignalization::toXML(DuckContext& duck, xml::Eleme
     return root;
 }
 
+bool ts::AbstractSignalization::toXML(DuckContext& duck, xml::Serializer& output) const
+{
+    if (_is_valid) {
+        output.startElement(_xml_name);
+        serializeXML(duck, output);
+        output.endElement();
+    }
+    return _is_valid;
+}
+
+void ts::AbstractSignalization::serializeXML(DuckContext& duck, xml::Serializer& output) const
+{
+    buildXML(duck, output.startFragment());
+    output.endFragment();
+}
+
 void ts::AbstractSignalization::fromXML(DuckContext& duck, const xml::Element* element)
 {
     // Make sure the object is cleared before analyzing the XML.
@@ -91,6 +91,19 @@ namespace ts {
         //!
         xml::Element* toXML(DuckContext& duck, xml::Element* parent) const;
 
+        //!
+        //! This method converts this object to XML using a serializer.
+        //!
+        //! When this object is valid, this method starts an element with the default XML
+        //! name and then invokes serializeXML() in the subclass to populate the element.
+        //! This is typically used to print XML or JSON without building an XML tree.
+        //!
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in,out] output The XML serializer.
+        //! @return True on success, false if this object is not valid.
+        //!
+        bool toXML(DuckContext& duck, xml::Serializer& output) const;
+
         //!
         //! This method converts an XML structure to a table or descriptor in this object.
         //!
@@ -171,6 +184,23 @@ namespace ts {
         //!
         virtual void buildXML(DuckContext& duck, xml::Element* root) const = 0;
 
+        //!
+        //! Helper method to convert this object to XML using a serializer.
+        //!
+        //! It is called by toXML() only when the object is valid. The element is already
+        //! started with the appropriate XML node name. In serializeXML(), the subclass
+        //! shall simply set the attributes and serialize the children of the element.
+        //!
+        //! The default implementation builds the content of the element in an XML fragment
+        //! using buildXML(). Tables and descriptors which are frequently converted in large
+        //! numbers, such as EIT's, directly serialize their content. Their buildXML() uses
+        //! an xml::TreeSerializer to call serializeXML().
+        //!
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in,out] output The XML serializer.
+        //!
+        virtual void serializeXML(DuckContext& duck, xml::Serializer& output) const;
+
         //!
         //! Helper method to convert this object from XML.
         //!
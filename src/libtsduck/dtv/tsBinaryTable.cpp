@@ -34,6 +34,7 @@
 #include "tsDuckContext.h"
 #include "tsSection.h"
 #include "tsxmlElement.h"
+#include "tsxmlSerializer.h"
 TSDUCK_SOURCE;
 
 
@@ -588,7 +589,70 @@ ts::xml::Element* ts::BinaryTable::toXML(DuckContext& duck, xml::Element* parent
     return node;
 }
 
+bool ts::BinaryTable::toXML(DuckContext& duck, xml::Serializer& output, const XMLOptions& opt) const
+{
+    // Filter invalid tables.
+    if (!_is_valid || _sections.size() == 0 || _sections[0].isNull()) {
+        return false;
+    }
+
+    // Optional metadata, copied as first child of the table, as in toXML() above.
+    xml::Element meta;
+    if ((opt.setPID && _source_pid != PID_NULL) || opt.setLocalTime || opt.setPackets) {
+        meta.setValue(u"metadata");
+        if (opt.setPID && _source_pid != PID_NULL) {
+            meta.setIntAttribute(u"PID", _source_pid);
+        }
+        if (opt.setLocalTime) {
+            meta.setDateTimeAttribute(u"time", Time::CurrentLocalTime());
+        }
+        if (opt.setPackets) {
+            meta.setIntAttribute(u"first_ts_packet", getFirstTSPacketIndex());
+            meta.setIntAttribute(u"last_ts_packet", getLastTSPacketIndex());
+        }
+        output.setNextFirstChild(&meta);
+    }
+
+    // Try to serialize a specialized XML structure.
+    if (!opt.forceGeneric) {
+        PSIRepository::TableFactory fac = PSIRepository::Instance()->getTableFactory(_tid, duck.standards(), _source_pid);
+        if (fac != nullptr) {
+            AbstractTablePtr tp = fac();
+            if (!tp.isNull()) {
+                tp->deserialize(duck, *this);
+                if (tp->toXML(duck, output)) {
+                    return true;
+                }
+            }
+        }
+    }
 
+    // If we could not serialize a typed node, serialize a generic one.
+    if (_sections[0]->isShortSection()) {
+        output.startElement(AbstractTable::XML_GENERIC_SHORT_TABLE);
+        output.setIntAttribute(u"table_id", _tid, true);
+        output.setBoolAttribute(u"private", _sections[0]->isPrivateSection());
+        output.addHexaText(_sections[0]->payload(), _sections[0]->payloadSize());
+        output.endElement();
+    }
+    else {
+        output.startElement(AbstractTable::XML_GENERIC_LONG_TABLE);
+        output.setIntAttribute(u"table_id", _tid, true);
+        output.setIntAttribute(u"table_id_ext", _tid_ext, true);
+        output.setIntAttribute(u"version", _version);
+        output.setBoolAttribute(u"current", _sections[0]->isCurrent());
+        output.setBoolAttribute(u"private", _sections[0]->isPrivateSection());
+        for (size_t index = 0; index < _sections.size(); ++index) {
+            if (!_sections[index].isNull() && _sections[index]->isValid()) {
+                output.startElement(u"section");
+                output.addHexaText(_sections[index]->payload(), _sections[index]->payloadSize());
+                output.endElement();
+            }
+        }
+        output.endElement();
+    }
+    return true;
+}
 
 
 //----------------------------------------------------------------------------
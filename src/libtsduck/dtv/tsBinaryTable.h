@@ -325,6 +325,18 @@ namespace ts {
         //!
         xml::Element* toXML(DuckContext& duck, xml::Element* parent, const XMLOptions& opt = XMLOptions()) const;
 
+        //!
+        //! This method converts the table to XML using a serializer.
+        //! If the table has a specialized implementation, serialize a specialized XML structure.
+        //! Otherwise, serialize a \<generic_short_table> or \<generic_long_table> node.
+        //! This is typically used to print XML or JSON without building an XML tree.
+        //! @param [in,out] duck TSDuck execution environment.
+        //! @param [in,out] output The XML serializer.
+        //! @param [in] opt Conversion options.
+        //! @return True on success, false if the table is not valid. In that case, nothing is serialized.
+        //!
+        bool toXML(DuckContext& duck, xml::Serializer& output, const XMLOptions& opt = XMLOptions()) const;
+
         //!
         //! This method converts an XML node as a binary table.
         //! @param [in,out] duck TSDuck execution environment.
@@ -28,8 +28,14 @@
 //----------------------------------------------------------------------------
 
 #include "tsCRC32.h"
+#include "tsSysInfo.h"
 TSDUCK_SOURCE;
 
+#if (defined(TS_GCC) || defined(TS_LLVM)) && (defined(TS_X86_64) || defined(TS_I386))
+    #define TS_CRC32_X86_ACCEL 1
+    #include <immintrin.h>
+#endif
+
 
 // The FCS-32 generator polynomial:
 //     x**0 + x**1 + x**2 + x**4 + x**5 +
@@ -105,13 +111,200 @@ namespace {
     };
 }
 
-// Continue the computation of a data area, following a previous CRC32
+//----------------------------------------------------------------------------
+// Portable implementations.
+// The CRC is computed MSB first (not reflected), the state of the computation
+// is the CRC register. When the CRC register is XOR'ed with the next 4 bytes of
+// data (big endian), the computation can continue with a null register.
+//----------------------------------------------------------------------------
 
-void ts::CRC32::add (const void* data, size_t size)
-{
-    const uint8_t* cp = static_cast <const uint8_t*> (data);
+namespace {
+
+    // Continue a CRC32 computation on a data area, return the new CRC register.
+    typedef uint32_t (*CRC32Function)(uint32_t fcs, const uint8_t* data, size_t size);
+
+    // Original byte-at-a-time implementation.
+    uint32_t CRC32Bytes(uint32_t fcs, const uint8_t* data, size_t size)
+    {
+        while (size-- > 0) {
+            fcs = (fcs << 8) ^ fcstab_32[((fcs >> 24) ^ (*data++)) & 0xFF];
+        }
+        return fcs;
+    }
+
+    // Tables for slicing-by-8: tab[k][b] is the contribution of byte b, followed by k null bytes.
+    struct SlicingTables
+    {
+        uint32_t tab[8][256];
+        SlicingTables();
+    };
+
+    SlicingTables::SlicingTables()
+    {
+        ::memcpy(tab[0], fcstab_32, sizeof(tab[0]));
+        for (size_t k = 1; k < 8; ++k) {
+            for (size_t b = 0; b < 256; ++b) {
+                tab[k][b] = (tab[k-1][b] << 8) ^ fcstab_32[tab[k-1][b] >> 24];
+            }
+        }
+    }
+
+    const SlicingTables& GetSlicingTables()
+    {
+        static const SlicingTables tables;
+        return tables;
+    }
+
+    // Slicing-by-8 implementation, 8 bytes per iteration.
+    uint32_t CRC32Slicing8(uint32_t fcs, const uint8_t* data, size_t size)
+    {
+        const SlicingTables& t(GetSlicingTables());
+        while (size >= 8) {
+            fcs ^= (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+            fcs = t.tab[7][fcs >> 24] ^ t.tab[6][(fcs >> 16) & 0xFF] ^ t.tab[5][(fcs >> 8) & 0xFF] ^ t.tab[4][fcs & 0xFF] ^
+                  t.tab[3][data[4]] ^ t.tab[2][data[5]] ^ t.tab[1][data[6]] ^ t.tab[0][data[7]];
+            data += 8;
+            size -= 8;
+        }
+        return CRC32Bytes(fcs, data, size);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Hardware-accelerated implementation, using carry-less multiplications.
+// The data are loaded in 128-bit registers, byte-reversed to get the natural
+// polynomial order. An accumulator A = Ah.x**64 + Al, followed by n bits of
+// data, is folded into n bits as Ah.(x**(n+64) mod P) + Al.(x**n mod P). Four
+// accumulators are folded in parallel to hide the latency of PCLMULQDQ. The
+// final 128 bits are reduced using the tables, which is negligible on large
+// areas and avoids a Barrett reduction with its own constants.
+//----------------------------------------------------------------------------
+
+namespace {
+
+#if defined(TS_CRC32_X86_ACCEL)
+
+    // Minimum data size for the accelerated implementation.
+    const size_t PCLMUL_MIN_SIZE = 128;
+
+    // Compute x**n modulo the FCS-32 polynomial.
+    uint32_t XPowerModP(size_t n)
+    {
+        uint32_t r = 1;
+        while (n-- > 0) {
+            r = (r << 1) ^ ((r & 0x80000000) != 0 ? fcstab_32[1] : 0);
+        }
+        return r;
+    }
+
+    // Folding constants, high quadword for Ah, low quadword for Al.
+    struct FoldConstants
+    {
+        uint64_t fold128[2];
+        uint64_t fold512[2];
+        FoldConstants();
+    };
 
-    while (size-- > 0) {
-        _fcs = (_fcs << 8) ^ fcstab_32 [((_fcs >> 24) ^ (*cp++)) & 0xFF];
+    FoldConstants::FoldConstants()
+    {
+        fold128[0] = XPowerModP(128);
+        fold128[1] = XPowerModP(128 + 64);
+        fold512[0] = XPowerModP(512);
+        fold512[1] = XPowerModP(512 + 64);
     }
+
+    __attribute__((target("pclmul,ssse3")))
+    inline __m128i Fold(__m128i acc, __m128i k, __m128i data)
+    {
+        return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x11), _mm_clmulepi64_si128(acc, k, 0x00)), data);
+    }
+
+    __attribute__((target("pclmul,ssse3")))
+    uint32_t CRC32PCLMUL(uint32_t fcs, const uint8_t* data, size_t size)
+    {
+        if (size < PCLMUL_MIN_SIZE) {
+            return CRC32Slicing8(fcs, data, size);
+        }
+
+        static const FoldConstants kc;
+        const __m128i k128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kc.fold128));
+        const __m128i k512 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kc.fold512));
+        const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i* in = reinterpret_cast<const __m128i*>(data);
+
+        // Load the first 64 bytes, the CRC register is XOR'ed with the first 32 bits.
+        __m128i a0 = _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128(in), reverse), _mm_set_epi32(int(fcs), 0, 0, 0));
+        __m128i a1 = _mm_shuffle_epi8(_mm_loadu_si128(in + 1), reverse);
+        __m128i a2 = _mm_shuffle_epi8(_mm_loadu_si128(in + 2), reverse);
+        __m128i a3 = _mm_shuffle_epi8(_mm_loadu_si128(in + 3), reverse);
+        in += 4;
+        size -= 64;
+
+        // Fold by 512 bits.
+        while (size >= 64) {
+            a0 = Fold(a0, k512, _mm_shuffle_epi8(_mm_loadu_si128(in), reverse));
+            a1 = Fold(a1, k512, _mm_shuffle_epi8(_mm_loadu_si128(in + 1), reverse));
+            a2 = Fold(a2, k512, _mm_shuffle_epi8(_mm_loadu_si128(in + 2), reverse));
+            a3 = Fold(a3, k512, _mm_shuffle_epi8(_mm_loadu_si128(in + 3), reverse));
+            in += 4;
+            size -= 64;
+        }
+
+        // Fold the four accumulators into one, then by 128 bits.
+        a1 = Fold(a0, k128, a1);
+        a2 = Fold(a1, k128, a2);
+        a3 = Fold(a2, k128, a3);
+        while (size >= 16) {
+            a3 = Fold(a3, k128, _mm_shuffle_epi8(_mm_loadu_si128(in++), reverse));
+            size -= 16;
+        }
+
+        // Final reduction of the accumulator and remaining bytes, starting with a null register.
+        uint8_t last[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(last), _mm_shuffle_epi8(a3, reverse));
+        return CRC32Slicing8(CRC32Slicing8(0, last, sizeof(last)), reinterpret_cast<const uint8_t*>(in), size);
+    }
+
+#endif
+
+    // Description of an implementation.
+    struct CRC32Impl
+    {
+        const ts::UChar* name;
+        CRC32Function    compute;
+    };
+
+    // Get the best implementation for this CPU.
+    const CRC32Impl& GetCRC32Impl()
+    {
+        static const CRC32Impl slicing = {u"slicing-by-8", CRC32Slicing8};
+#if defined(TS_CRC32_X86_ACCEL)
+        static const CRC32Impl pclmul = {u"PCLMULQDQ", CRC32PCLMUL};
+        static const CRC32Impl& impl = ts::SysInfo::Instance()->cpuHasFeatures(ts::SysInfo::CPU_PCLMUL | ts::SysInfo::CPU_SSSE3) ? pclmul : slicing;
+        return impl;
+#else
+        return slicing;
+#endif
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the name of the CRC32 implementation which is used on this system.
+//----------------------------------------------------------------------------
+
+ts::UString ts::CRC32::Implementation()
+{
+    return GetCRC32Impl().name;
+}
+
+
+//----------------------------------------------------------------------------
+// Continue the computation of a data area, following a previous CRC32.
+//----------------------------------------------------------------------------
+
+void ts::CRC32::add(const void* data, size_t size)
+{
+    _fcs = GetCRC32Impl().compute(_fcs, static_cast<const uint8_t*>(data), size);
 }
@@ -35,7 +35,7 @@
 //----------------------------------------------------------------------------
 
 #pragma once
-#include "tsPlatform.h"
+#include "tsUString.h"
 
 namespace ts {
     //!
@@ -68,6 +68,15 @@ namespace ts {
         //!
         void add(const void* data, size_t size);
 
+        //!
+        //! Get the name of the CRC32 implementation which is used on this system.
+        //! Large data areas are processed using carry-less multiplications when the
+        //! CPU supports them (PCLMULQDQ on Intel processors). Otherwise, a portable
+        //! slicing-by-8 implementation is used. All implementations give identical results.
+        //! @return The implementation name, "slicing-by-8" or "PCLMULQDQ".
+        //!
+        static UString Implementation();
+
         //!
         //! Get the value of the CRC32 as computed so far.
         //! @return The value of the CRC32 as computed so far.
@@ -32,6 +32,7 @@
 #include "tsAbstractDescriptor.h"
 #include "tsPSIRepository.h"
 #include "tsxmlElement.h"
+#include "tsxmlSerializer.h"
 TSDUCK_SOURCE;
 
 
@@ -276,6 +277,35 @@ ts::xml::Element* ts::Descriptor::toXML(DuckContext& duck, xml::Element* parent,
     return node;
 }
 
+bool ts::Descriptor::toXML(DuckContext& duck, xml::Serializer& output, PDS pds, TID tid, bool forceGeneric) const
+{
+    // Filter invalid descriptors.
+    if (!isValid()) {
+        return false;
+    }
+
+    // Try to serialize a specialized XML structure.
+    if (!forceGeneric) {
+        PSIRepository::DescriptorFactory fac = PSIRepository::Instance()->getDescriptorFactory(edid(pds), tid);
+        if (fac != nullptr) {
+            AbstractDescriptorPtr dp = fac();
+            if (!dp.isNull()) {
+                dp->deserialize(duck, *this);
+                if (dp->toXML(duck, output)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    // If we could not serialize a typed node, serialize a generic one.
+    output.startElement(AbstractDescriptor::XML_GENERIC_DESCRIPTOR);
+    output.setIntAttribute(u"tag", tag(), true);
+    output.addHexaText(payload(), payloadSize());
+    output.endElement();
+    return true;
+}
+
 
 //----------------------------------------------------------------------------
 // This method converts an XML node as a binary descriptor.
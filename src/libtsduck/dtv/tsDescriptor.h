@@ -267,6 +267,19 @@ namespace ts {
         //!
         xml::Element* toXML(DuckContext& duck, xml::Element* parent, PDS pds = 0, TID tid = TID_NULL, bool forceGeneric = false) const;
 
+        //!
+        //! This method converts a descriptor to XML using a serializer.
+        //! If the descriptor has a specialized implementation, serialize a specialized
+        //! XML structure. Otherwise, serialize a \<generic_descriptor> node.
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in,out] output The XML serializer.
+        //! @param [in] pds Associated private data specifier.
+        //! @param [in] tid Optional table id of the table containing the descriptor.
+        //! @param [in] forceGeneric Force a \<generic_descriptor> node even if the descriptor can be specialized.
+        //! @return True on success, false if the descriptor is not valid.
+        //!
+        bool toXML(DuckContext& duck, xml::Serializer& output, PDS pds = 0, TID tid = TID_NULL, bool forceGeneric = false) const;
+
         //!
         //! This method converts an XML node as a binary descriptor.
         //! @param [in,out] duck TSDuck execution context.
@@ -33,6 +33,7 @@
 #include "tsPrivateDataSpecifierDescriptor.h"
 #include "tsDuckContext.h"
 #include "tsxmlElement.h"
+#include "tsxmlSerializer.h"
 #include "tsNames.h"
 TSDUCK_SOURCE;
 
@@ -662,6 +663,17 @@ bool ts::DescriptorList::toXML(DuckContext& duck, xml::Element* parent) const
     return success;
 }
 
+bool ts::DescriptorList::toXML(DuckContext& duck, xml::Serializer& output) const
+{
+    bool success = true;
+    for (size_t index = 0; index < _list.size(); ++index) {
+        if (_list[index].desc.isNull() || !_list[index].desc->toXML(duck, output, duck.actualPDS(_list[index].pds), tableId(), false)) {
+            success = false;
+        }
+    }
+    return success;
+}
+
 
 //----------------------------------------------------------------------------
 // These methods decode an XML list of descriptors.
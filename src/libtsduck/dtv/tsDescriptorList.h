@@ -367,6 +367,15 @@ namespace ts {
         //!
         bool toXML(DuckContext& duck, xml::Element* parent) const;
 
+        //!
+        //! This method converts a descriptor list to XML using a serializer.
+        //! The descriptors are serialized as children of the current element.
+        //! @param [in,out] duck TSDuck execution context.
+        //! @param [in,out] output The XML serializer.
+        //! @return True on success, false on error.
+        //!
+        bool toXML(DuckContext& duck, xml::Serializer& output) const;
+
         //!
         //! This method decodes an XML list of descriptors.
         //! @param [in,out] duck TSDuck execution context.
@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Small hash table of values, indexed by ETID.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsETID.h"
+
+namespace ts {
+    //!
+    //! Small hash table of values, indexed by "Extended Table Id".
+    //! @ingroup mpeg
+    //!
+    //! This is an open-addressed hash table with linear probing. It is designed
+    //! for the few tables which are usually found in one PID, with a fast access
+    //! on each section. The storage is allocated on first insertion and doubles
+    //! in size when the table is half full. Entries are never individually removed,
+    //! only the whole table is cleared.
+    //!
+    //! When the storage grows, the values are moved to the new storage. Therefore,
+    //! any reference or pointer to a value is invalidated by the insertion of a new
+    //! ETID. No reference to a value shall be kept across an insertion.
+    //!
+    //! @tparam T The type of the values. It must be default-constructible and move-assignable.
+    //!
+    template <typename T>
+    class ETIDTable
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        ETIDTable();
+
+        //!
+        //! Get the value for an ETID, create it if it does not exist.
+        //! @param [in] etid The ETID to search.
+        //! @return A reference to the value for @a etid. The reference is
+        //! invalidated by the next insertion of a new ETID in the table.
+        //!
+        T& operator[](const ETID& etid);
+
+        //!
+        //! Get the value for an ETID, if it exists.
+        //! @param [in] etid The ETID to search.
+        //! @return The address of the value for @a etid or a null pointer if @a etid is not in the table.
+        //! The pointer is invalidated by the next insertion of a new ETID in the table.
+        //!
+        T* find(const ETID& etid);
+
+        //!
+        //! Get the value for an ETID, if it exists (constant version).
+        //! @param [in] etid The ETID to search.
+        //! @return The address of the value for @a etid or a null pointer if @a etid is not in the table.
+        //!
+        const T* find(const ETID& etid) const;
+
+        //!
+        //! Get the number of ETID's in the table.
+        //! @return The number of ETID's in the table.
+        //!
+        size_t size() const { return _count; }
+
+        //!
+        //! Check if the table is empty.
+        //! @return True if the table is empty.
+        //!
+        bool empty() const { return _count == 0; }
+
+        //!
+        //! Get the list of ETID's in the table, in increasing order.
+        //! @param [out] etids Returned list of ETID's.
+        //!
+        void getSortedKeys(std::vector<ETID>& etids) const;
+
+        //!
+        //! Remove all entries and deallocate the storage.
+        //!
+        void clear();
+
+    private:
+        // One entry in the table.
+        struct Entry
+        {
+            bool  used;   // The entry is used.
+            ETID  etid;   // Key of the entry.
+            T     value;  // Value of the entry.
+            Entry() : used(false), etid(), value() {}
+        };
+
+        std::vector<Entry> _entries;  // Table size is zero or a power of 2.
+        size_t             _count;    // Number of used entries.
+
+        // Initial size and maximum load factor (as a shift on table size).
+        static constexpr size_t INITIAL_SIZE = 8;
+        static constexpr size_t LOAD_SHIFT = 1;
+
+        // Get the index in _entries where an ETID is or should be placed.
+        size_t lookup(const ETID& etid) const;
+    };
+}
+
+#include "tsETIDTableTemplate.h"
@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+template <typename T> constexpr size_t ts::ETIDTable<T>::INITIAL_SIZE;
+template <typename T> constexpr size_t ts::ETIDTable<T>::LOAD_SHIFT;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::ETIDTable<T>::ETIDTable() :
+    _entries(),
+    _count(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Remove all entries.
+//----------------------------------------------------------------------------
+
+template <typename T>
+void ts::ETIDTable<T>::clear()
+{
+    _entries.clear();
+    _count = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the index in _entries where an ETID is or should be placed, using
+// linear probing. The table must not be empty and must not be full.
+//----------------------------------------------------------------------------
+
+template <typename T>
+size_t ts::ETIDTable<T>::lookup(const ETID& etid) const
+{
+    const uint32_t key = (etid.isLongSection() ? 0x01000000 : 0) | (uint32_t(etid.tid()) << 16) | etid.tidExt();
+    const size_t mask = _entries.size() - 1;
+    size_t index = size_t(uint32_t(key * 0x9E3779B1) >> 7) & mask;
+    while (_entries[index].used && _entries[index].etid != etid) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the value for an ETID.
+//----------------------------------------------------------------------------
+
+template <typename T>
+T* ts::ETIDTable<T>::find(const ETID& etid)
+{
+    if (_entries.empty()) {
+        return nullptr;
+    }
+    Entry& entry(_entries[lookup(etid)]);
+    return entry.used ? &entry.value : nullptr;
+}
+
+template <typename T>
+const T* ts::ETIDTable<T>::find(const ETID& etid) const
+{
+    if (_entries.empty()) {
+        return nullptr;
+    }
+    const Entry& entry(_entries[lookup(etid)]);
+    return entry.used ? &entry.value : nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the value for an ETID, create it if it does not exist.
+//----------------------------------------------------------------------------
+
+template <typename T>
+T& ts::ETIDTable<T>::operator[](const ETID& etid)
+{
+    // Allocate the table on first use.
+    if (_entries.empty()) {
+        _entries.resize(INITIAL_SIZE);
+    }
+
+    size_t index = lookup(etid);
+    if (!_entries[index].used) {
+        // New ETID. When the maximum load is reached, double the size of the table.
+        // The values are moved, not copied, into the new storage.
+        if (_count >= (_entries.size() >> LOAD_SHIFT)) {
+            std::vector<Entry> old(_entries.size() * 2);
+            old.swap(_entries);
+            for (auto it = old.begin(); it != old.end(); ++it) {
+                if (it->used) {
+                    Entry& entry(_entries[lookup(it->etid)]);
+                    entry.used = true;
+                    entry.etid = it->etid;
+                    entry.value = std::move(it->value);
+                }
+            }
+            index = lookup(etid);
+        }
+        _entries[index].used = true;
+        _entries[index].etid = etid;
+        _count++;
+    }
+    return _entries[index].value;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the list of ETID's in the table, in increasing order.
+//----------------------------------------------------------------------------
+
+template <typename T>
+void ts::ETIDTable<T>::getSortedKeys(std::vector<ETID>& etids) const
+{
+    etids.clear();
+    etids.reserve(_count);
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->used) {
+            etids.push_back(it->etid);
+        }
+    }
+    std::sort(etids.begin(), etids.end());
+}
@@ -30,6 +30,7 @@
 #include "tsNames.h"
 #include "tsDuckContext.h"
 #include "tsSysUtils.h"
+#include "tsXXHash.h"
 #include "tsFatal.h"
 #include "tsCerrReport.h"
 #include "tsPSIRepository.h"
@@ -408,22 +409,85 @@ ts::UString ts::names::AC3ComponentType(uint8_t type, Flags flags)
 }
 
 
+//----------------------------------------------------------------------------
+// Layout of a binary image. All integers are in native byte order.
+// All structures have a size which is a multiple of 8 bytes to keep the
+// 64-bit fields aligned in the memory-mapped image.
+//----------------------------------------------------------------------------
+
+struct ts::Names::BinaryHeader
+{
+    char     magic[8];       // BINARY_MAGIC
+    uint32_t version;        // BINARY_VERSION, also checks the byte order.
+    uint32_t sectionCount;   // Number of BinarySection, sorted by UTF-8 name.
+    uint64_t sourceSize;     // Size of the text file which was compiled.
+    int64_t  sourceTime;     // Modification time of the text file, in milliseconds since the UNIX epoch, or NO_SOURCE_TIME.
+    uint64_t sourceHash;     // XXHash64 of the content of the text file.
+    uint32_t entryCount;     // Number of BinaryEntry, sorted by first value in each section.
+    uint32_t stringsSize;    // Size in bytes of the UTF-8 string pool.
+};
+
+struct ts::Names::BinarySection
+{
+    uint32_t nameOffset;     // Section name in string pool (lower case).
+    uint32_t nameSize;       // Size in bytes of section name.
+    uint32_t bits;           // Number of significant bits in values.
+    uint32_t firstEntry;     // Index of first BinaryEntry.
+    uint32_t entryCount;     // Number of BinaryEntry.
+    uint32_t reserved;       // Padding, zero.
+};
+
+struct ts::Names::BinaryEntry
+{
+    uint64_t first;          // First value in the range.
+    uint64_t last;           // Last value in the range.
+    uint32_t nameOffset;     // Name in string pool.
+    uint32_t nameSize;       // Size in bytes of name.
+};
+
+namespace {
+    const char BINARY_MAGIC[8] = {'T', 'S', 'N', 'A', 'M', 'E', 'S', 0};
+    const uint32_t BINARY_VERSION = 2;
+
+    // Source time in binary header when the modification time of the text file is not reliable.
+    const int64_t NO_SOURCE_TIME = std::numeric_limits<int64_t>::min();
+
+    // Modification time of a file, in milliseconds since the UNIX epoch.
+    int64_t FileTime(const ts::UString& fileName)
+    {
+        return int64_t(ts::GetFileModificationTimeUTC(fileName) - ts::Time::UnixEpoch);
+    }
+
+    // Hash of the content of a file, zero if the file cannot be read.
+    uint64_t FileHash(const ts::UString& fileName)
+    {
+        ts::ByteBlock content;
+        return content.loadFromFile(fileName, std::numeric_limits<size_t>::max(), nullptr) ? ts::XXHash64(content.data(), content.size()) : 0;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor (load the configuration file).
 //----------------------------------------------------------------------------
 
-ts::Names::Names(const UString& fileName, bool mergeExtensions) :
+ts::Names::Names(const UString& fileName, bool mergeExtensions, bool useBinary) :
     _log(CERR),
     _configFile(SearchConfigurationFile(fileName)),
     _configErrors(0),
-    _sections()
+    _sections(),
+    _image(nullptr),
+    _imageSize(0),
+    _imageMapped(false),
+    _imageData()
 {
     // Locate the configuration file.
     if (_configFile.empty()) {
         // Cannot load configuration, names will not be available.
         _log.error(u"configuration file '%s' not found", {fileName});
     }
-    else {
+    else if (!useBinary || !loadBinaryFile(_configFile + u".bin")) {
+        // No usable precompiled image, load the text file.
         loadFile(_configFile);
     }
 
@@ -482,9 +546,10 @@ void ts::Names::loadFile(const UString& fileName)
                 section = it->second;
             }
             else {
-                // Create new section.
+                // Create new section, possibly overlaying a section from the binary image.
                 section = new ConfigSection;
                 CheckNonNull(section);
+                section->image = findBinarySection(line);
                 _sections.insert(std::make_pair(line, section));
             }
         }
@@ -545,7 +610,7 @@ bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section)
 
     // Add the definition.
     if (valid) {
-        if (section->freeRange(first, last)) {
+        if (section->freeRange(first, last) && binaryFreeRange(section->image, first, last)) {
             section->addEntry(first, last, value);
         }
         else {
@@ -568,6 +633,7 @@ ts::Names::~Names()
         delete it->second;
     }
     _sections.clear();
+    unloadBinaryFile();
 }
 
 
@@ -588,7 +654,8 @@ ts::Names::ConfigEntry::ConfigEntry(Value l, const UString& n) :
 
 ts::Names::ConfigSection::ConfigSection() :
     bits(0),
-    entries()
+    entries(),
+    image(nullptr)
 {
 }
 
@@ -762,6 +829,41 @@ ts::UString ts::Names::Formatted(Value value, const UString& name, names::Flags
 }
 
 
+//----------------------------------------------------------------------------
+// Find a section, either in text sections or in the binary image.
+//----------------------------------------------------------------------------
+
+void ts::Names::findSection(const UString& sectionName, const ConfigSection*& text, const BinarySection*& bin) const
+{
+    const ConfigSectionMap::const_iterator it = _sections.find(sectionName);
+    text = it == _sections.end() ? nullptr : it->second;
+    bin = text != nullptr ? text->image : findBinarySection(sectionName);
+}
+
+
+//----------------------------------------------------------------------------
+// Get a name from a value, empty if not found.
+//----------------------------------------------------------------------------
+
+ts::UString ts::Names::getName(const ConfigSection* text, const BinarySection* bin, Value val) const
+{
+    // The text sections from extensions take precedence over the binary image.
+    UString name;
+    if (text != nullptr) {
+        name = text->getName(val);
+    }
+    if (name.empty() && bin != nullptr) {
+        name = getBinaryName(bin, val);
+    }
+    return name;
+}
+
+size_t ts::Names::getBits(const ConfigSection* text, const BinarySection* bin) const
+{
+    return text != nullptr && text->bits != 0 ? text->bits : (bin != nullptr ? size_t(bin->bits) : 0);
+}
+
+
 //----------------------------------------------------------------------------
 // Check if a name exists in a specified section.
 //----------------------------------------------------------------------------
@@ -769,8 +871,10 @@ ts::UString ts::Names::Formatted(Value value, const UString& name, names::Flags
 bool ts::Names::nameExists(const UString& sectionName, Value value) const
 {
     // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    return it != _sections.end() && !it->second->getName(value).empty();
+    const ConfigSection* text = nullptr;
+    const BinarySection* bin = nullptr;
+    findSection(sectionName.toTrimmed().toLower(), text, bin);
+    return !getName(text, bin, value).empty();
 }
 
 
@@ -781,15 +885,16 @@ bool ts::Names::nameExists(const UString& sectionName, Value value) const
 ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value, names::Flags flags, size_t bits, Value alternateValue) const
 {
     // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? nullptr : it->second;
+    const ConfigSection* text = nullptr;
+    const BinarySection* bin = nullptr;
+    findSection(sectionName.toTrimmed().toLower(), text, bin);
 
-    if (section == nullptr) {
+    if (text == nullptr && bin == nullptr) {
         // Non-existent section, no name.
         return Formatted(value, UString(), flags, bits, alternateValue);
     }
     else {
-        return Formatted(value, section->getName(value), flags, bits != 0 ? bits : section->bits, alternateValue);
+        return Formatted(value, getName(text, bin, value), flags, bits != 0 ? bits : getBits(text, bin), alternateValue);
     }
 }
 
@@ -801,22 +906,305 @@ ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value,
 ts::UString ts::Names::nameFromSectionWithFallback(const UString& sectionName, Value value1, Value value2, names::Flags flags, size_t bits, Value alternateValue) const
 {
     // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? nullptr : it->second;
+    const ConfigSection* text = nullptr;
+    const BinarySection* bin = nullptr;
+    findSection(sectionName.toTrimmed().toLower(), text, bin);
 
-    if (section == nullptr) {
+    if (text == nullptr && bin == nullptr) {
         // Non-existent section, no name.
         return Formatted(value1, UString(), flags, bits, alternateValue);
     }
     else {
-        const UString name(section->getName(value1));
+        const UString name(getName(text, bin, value1));
         if (!name.empty()) {
             // value1 has a name
-            return Formatted(value1, name, flags, bits != 0 ? bits : section->bits, alternateValue);
+            return Formatted(value1, name, flags, bits != 0 ? bits : getBits(text, bin), alternateValue);
         }
         else {
             // value1 has no name, use value2.
-            return Formatted(value2, section->getName(value2), flags, bits != 0 ? bits : section->bits, alternateValue);
+            return Formatted(value2, getName(text, bin, value2), flags, bits != 0 ? bits : getBits(text, bin), alternateValue);
         }
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Map a binary image, return false if not found or invalid.
+//----------------------------------------------------------------------------
+
+bool ts::Names::loadBinaryFile(const UString& fileName)
+{
+    if (!FileExists(fileName)) {
+        return false;
+    }
+
+#if defined(TS_UNIX)
+    // Check the header first, do not map obsolete images.
+    const int fd = ::open(fileName.toUTF8().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    BinaryHeader header;
+    void* base = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 &&
+        size_t(st.st_size) >= sizeof(header) &&
+        ::pread(fd, &header, sizeof(header), 0) == ssize_t(sizeof(header)) &&
+        checkBinaryHeader(header, fileName))
+    {
+        // Map the file in memory. The file is never modified, the mapping is shared by all processes.
+        base = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    _image = reinterpret_cast<const uint8_t*>(base);
+    _imageSize = size_t(st.st_size);
+    _imageMapped = true;
+#else
+    // Load the file in memory.
+    if (!_imageData.loadFromFile(fileName) ||
+        _imageData.size() < sizeof(BinaryHeader) ||
+        !checkBinaryHeader(*reinterpret_cast<const BinaryHeader*>(_imageData.data()), fileName))
+    {
+        _imageData.clear();
+        return false;
+    }
+    _image = _imageData.data();
+    _imageSize = _imageData.size();
+    _imageMapped = false;
+#endif
+
+    // Check the structure of the image.
+    const BinaryHeader* hdr = reinterpret_cast<const BinaryHeader*>(_image);
+    bool valid = uint64_t(_imageSize) == sizeof(BinaryHeader) + uint64_t(hdr->sectionCount) * sizeof(BinarySection) + uint64_t(hdr->entryCount) * sizeof(BinaryEntry) + hdr->stringsSize;
+
+    // Check that all sections and names are inside the image.
+    const BinarySection* sections = reinterpret_cast<const BinarySection*>(_image + sizeof(BinaryHeader));
+    const BinaryEntry* entries = reinterpret_cast<const BinaryEntry*>(sections + (valid ? hdr->sectionCount : 0));
+    for (size_t i = 0; valid && i < hdr->sectionCount; ++i) {
+        valid = uint64_t(sections[i].nameOffset) + sections[i].nameSize <= hdr->stringsSize &&
+            uint64_t(sections[i].firstEntry) + sections[i].entryCount <= hdr->entryCount;
+    }
+    for (size_t i = 0; valid && i < hdr->entryCount; ++i) {
+        valid = uint64_t(entries[i].nameOffset) + entries[i].nameSize <= hdr->stringsSize;
+    }
+
+    if (!valid) {
+        _log.debug(u"ignoring invalid names image %s", {fileName});
+        unloadBinaryFile();
+    }
+    return valid;
+}
+
+
+//----------------------------------------------------------------------------
+// Check the header of a binary image, return false if invalid or obsolete.
+//----------------------------------------------------------------------------
+
+bool ts::Names::checkBinaryHeader(const BinaryHeader& hdr, const UString& fileName) const
+{
+    if (::memcmp(hdr.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 || hdr.version != BINARY_VERSION) {
+        _log.debug(u"ignoring invalid names image %s", {fileName});
+        return false;
+    }
+
+    // Ignore obsolete images, when the text file was modified after compilation. When the text file
+    // has the same size but not the same modification time (a modification or simply a copy of the
+    // file), the content of the text file is checked.
+    if (GetFileSize(_configFile) != int64_t(hdr.sourceSize) ||
+        (FileTime(_configFile) != hdr.sourceTime && FileHash(_configFile) != hdr.sourceHash))
+    {
+        _log.debug(u"ignoring obsolete names image %s", {fileName});
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the binary image.
+//----------------------------------------------------------------------------
+
+void ts::Names::unloadBinaryFile()
+{
+#if defined(TS_UNIX)
+    if (_image != nullptr && _imageMapped) {
+        ::munmap(const_cast<uint8_t*>(_image), _imageSize);
+    }
+#endif
+    _image = nullptr;
+    _imageSize = 0;
+    _imageMapped = false;
+    _imageData.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Binary search of a section in the binary image.
+//----------------------------------------------------------------------------
+
+const ts::Names::BinarySection* ts::Names::findBinarySection(const UString& sectionName) const
+{
+    if (_image == nullptr) {
+        return nullptr;
+    }
+
+    const BinaryHeader* hdr = reinterpret_cast<const BinaryHeader*>(_image);
+    const BinarySection* sections = reinterpret_cast<const BinarySection*>(_image + sizeof(BinaryHeader));
+    const char* strings = reinterpret_cast<const char*>(_image + _imageSize - hdr->stringsSize);
+    const std::string name(sectionName.toUTF8());
+
+    // Sections are sorted by UTF-8 name, using byte comparison.
+    size_t low = 0;
+    size_t high = hdr->sectionCount;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const int cmp = name.compare(0, std::string::npos, strings + sections[mid].nameOffset, sections[mid].nameSize);
+        if (cmp == 0) {
+            return &sections[mid];
+        }
+        else if (cmp < 0) {
+            high = mid;
+        }
+        else {
+            low = mid + 1;
+        }
+    }
+    return nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Binary search of a value in a section of the binary image.
+//----------------------------------------------------------------------------
+
+ts::UString ts::Names::getBinaryName(const BinarySection* bin, Value val) const
+{
+    const BinaryHeader* hdr = reinterpret_cast<const BinaryHeader*>(_image);
+    const BinaryEntry* entries = reinterpret_cast<const BinaryEntry*>(_image + sizeof(BinaryHeader) + hdr->sectionCount * sizeof(BinarySection)) + bin->firstEntry;
+    const char* strings = reinterpret_cast<const char*>(_image + _imageSize - hdr->stringsSize);
+
+    // Find the first entry which starts after val. The previous one, if any, may contain val.
+    const BinaryEntry* const end = entries + bin->entryCount;
+    const BinaryEntry* it = std::upper_bound(entries, end, val, [](Value v, const BinaryEntry& e) { return v < e.first; });
+    if (it != entries && (--it)->last >= val) {
+        return UString::FromUTF8(strings + it->nameOffset, it->nameSize);
+    }
+    return UString();
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a range is free in a section of the binary image.
+//----------------------------------------------------------------------------
+
+bool ts::Names::binaryFreeRange(const BinarySection* bin, Value first, Value last) const
+{
+    if (bin == nullptr) {
+        return true;
+    }
+
+    const BinaryHeader* hdr = reinterpret_cast<const BinaryHeader*>(_image);
+    const BinaryEntry* entries = reinterpret_cast<const BinaryEntry*>(_image + sizeof(BinaryHeader) + hdr->sectionCount * sizeof(BinarySection)) + bin->firstEntry;
+
+    // Find the first entry which starts after last. The previous one, if any, must end before first.
+    const BinaryEntry* const end = entries + bin->entryCount;
+    const BinaryEntry* it = std::upper_bound(entries, end, last, [](Value v, const BinaryEntry& e) { return v < e.first; });
+    return it == entries || (--it)->last < first;
+}
+
+
+//----------------------------------------------------------------------------
+// Compile a names file into a binary image.
+//----------------------------------------------------------------------------
+
+bool ts::Names::CompileFile(const UString& textFile, const UString& binFile, Report& report)
+{
+    if (!FileExists(textFile)) {
+        report.error(u"file %s not found", {textFile});
+        return false;
+    }
+
+    // Load the text file only, ignoring any previous binary image.
+    Names names(textFile, false, false);
+    if (names.errorCount() > 0) {
+        report.error(u"%d errors in %s, not compiled", {names.errorCount(), textFile});
+        return false;
+    }
+    return names.saveBinaryFile(binFile.empty() ? textFile + u".bin" : binFile, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Write the binary image of the loaded sections.
+//----------------------------------------------------------------------------
+
+bool ts::Names::saveBinaryFile(const UString& fileName, Report& report) const
+{
+    // Sort sections by UTF-8 names, the order of the binary search.
+    std::map<std::string, const ConfigSection*> sorted;
+    for (auto it = _sections.begin(); it != _sections.end(); ++it) {
+        sorted[it->first.toUTF8()] = it->second;
+    }
+
+    std::vector<BinarySection> sections;
+    std::vector<BinaryEntry> entries;
+    std::string strings;
+    sections.reserve(sorted.size());
+
+    for (auto sit = sorted.begin(); sit != sorted.end(); ++sit) {
+        BinarySection sec;
+        TS_ZERO(sec);
+        sec.nameOffset = uint32_t(strings.size());
+        sec.nameSize = uint32_t(sit->first.size());
+        sec.bits = uint32_t(sit->second->bits);
+        sec.firstEntry = uint32_t(entries.size());
+        sec.entryCount = uint32_t(sit->second->entries.size());
+        strings.append(sit->first);
+        sections.push_back(sec);
+
+        // The entries are already sorted by first value in the map.
+        for (auto eit = sit->second->entries.begin(); eit != sit->second->entries.end(); ++eit) {
+            const std::string name(eit->second->name.toUTF8());
+            BinaryEntry ent;
+            TS_ZERO(ent);
+            ent.first = eit->first;
+            ent.last = eit->second->last;
+            ent.nameOffset = uint32_t(strings.size());
+            ent.nameSize = uint32_t(name.size());
+            strings.append(name);
+            entries.push_back(ent);
+        }
+    }
+
+    BinaryHeader hdr;
+    TS_ZERO(hdr);
+    ::memcpy(hdr.magic, BINARY_MAGIC, sizeof(hdr.magic));
+    hdr.version = BINARY_VERSION;
+    hdr.sectionCount = uint32_t(sections.size());
+    hdr.sourceSize = uint64_t(GetFileSize(_configFile));
+    // The modification times have a one second resolution. When the text file was modified less than
+    // one second ago, it can be modified again with the same time. Then, the time is not recorded and
+    // the content of the text file is always checked.
+    const int64_t sourceTime = FileTime(_configFile);
+    hdr.sourceTime = int64_t(Time::CurrentUTC() - Time::UnixEpoch) - sourceTime > MilliSecPerSec ? sourceTime : NO_SOURCE_TIME;
+    hdr.sourceHash = FileHash(_configFile);
+    hdr.entryCount = uint32_t(entries.size());
+    hdr.stringsSize = uint32_t(strings.size());
+
+    // Build the complete image.
+    ByteBlock image;
+    image.reserve(sizeof(hdr) + sections.size() * sizeof(BinarySection) + entries.size() * sizeof(BinaryEntry) + strings.size());
+    image.append(&hdr, sizeof(hdr));
+    image.append(sections.data(), sections.size() * sizeof(BinarySection));
+    image.append(entries.data(), entries.size() * sizeof(BinaryEntry));
+    image.append(strings.data(), strings.size());
+
+    if (!image.saveToFile(fileName, &report)) {
+        return false;
+    }
+    report.verbose(u"%s: %d sections, %d names, %'d bytes", {fileName, sections.size(), entries.size(), image.size()});
+    return true;
+}
@@ -40,6 +40,8 @@
 #include "tsCASFamily.h"
 #include "tsCodecType.h"
 #include "tsReport.h"
+#include "tsCerrReport.h"
+#include "tsByteBlock.h"
 #include "tsSingletonManager.h"
 
 // Forward declaration to allow using the '|' operator in the definition of the enum type.
@@ -366,6 +368,13 @@ namespace ts {
     //! A repository of names for MPEG/DVB entities.
     //! All names are loaded from configuration files @em tsduck*.names.
     //!
+    //! A names file can be precompiled into a binary image (see CompileFile()). When
+    //! a valid binary image named after the text file with an additional ".bin" suffix
+    //! is found in the same directory as the text file, the binary image is memory-mapped
+    //! and searched using binary search, instead of loading and parsing the text file.
+    //! The names files from extensions are always loaded as text and take precedence
+    //! over the binary image.
+    //!
     class TSDUCKDLL Names
     {
         TS_NOBUILD_NOCOPY(Names);
@@ -374,8 +383,9 @@ namespace ts {
         //! Constructor.
         //! @param [in] fileName Configuration file name. Typically without directory name.
         //! @param [in] mergeExtensions If true, merge the content of names files from extensions.
+        //! @param [in] useBinary If true, use the precompiled binary image of the file when available.
         //!
-        Names(const UString& fileName, bool mergeExtensions = false);
+        Names(const UString& fileName, bool mergeExtensions = false, bool useBinary = true);
 
         //!
         //! Virtual destructor.
@@ -396,6 +406,15 @@ namespace ts {
             return _configFile;
         }
 
+        //!
+        //! Check if the names were loaded from a precompiled binary image.
+        //! @return True if the names were loaded from a binary image, false if loaded from the text file.
+        //!
+        bool isBinaryImage() const
+        {
+            return _image != nullptr;
+        }
+
         //!
         //! Get the number of errors in the configuration file.
         //! @return The number of errors in the configuration file.
@@ -447,7 +466,24 @@ namespace ts {
         //!
         static UString Formatted(Value value, const UString& name, names::Flags flags, size_t bits, Value alternateValue = 0);
 
+        //!
+        //! Compile a names file into a binary image.
+        //! The binary image contains all sections and ranges of values, sorted and ready for
+        //! binary search. The binary image is specific to the byte order of the system.
+        //! @param [in] textFile Name of the input names file, in text format.
+        //! @param [in] binFile Name of the output binary image. When empty, use the name
+        //! of the text file with an additional ".bin" suffix.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        static bool CompileFile(const UString& textFile, const UString& binFile = UString(), Report& report = CERR);
+
     private:
+        // Layout of a binary image, defined in implementation.
+        struct BinaryHeader;
+        struct BinarySection;
+        struct BinaryEntry;
+
         // Description of a configuration entry.
         // The first value of the range is the key in a map.
         class ConfigEntry
@@ -466,9 +502,11 @@ namespace ts {
         // The name of the section is the key in a map.
         class ConfigSection
         {
+            TS_NOCOPY(ConfigSection);
         public:
-            size_t          bits;     // Number of significant bits in values of the type.
-            ConfigEntryMap  entries;  // All entries, indexed by names.
+            size_t               bits;     // Number of significant bits in values of the type.
+            ConfigEntryMap       entries;  // All entries, indexed by names.
+            const BinarySection* image;    // Section with same name in binary image, if any.
 
             ConfigSection();
             ~ConfigSection();
@@ -498,11 +536,40 @@ namespace ts {
         // Load a configuration file and merge its content into this instance.
         void loadFile(const UString& fileName);
 
+        // Map a binary image, return false if not found or invalid.
+        bool loadBinaryFile(const UString& fileName);
+
+        // Check the header of a binary image, return false if invalid or obsolete.
+        bool checkBinaryHeader(const BinaryHeader& hdr, const UString& fileName) const;
+
+        // Unmap the binary image.
+        void unloadBinaryFile();
+
+        // Write the binary image of the loaded sections.
+        bool saveBinaryFile(const UString& fileName, Report& report) const;
+
+        // Find a section, either in text sections or in the binary image.
+        // The section name must be normalized (trimmed, lower case).
+        void findSection(const UString& sectionName, const ConfigSection*& text, const BinarySection*& bin) const;
+        const BinarySection* findBinarySection(const UString& sectionName) const;
+
+        // Get a name from a value, empty if not found, in a text section and/or a binary section.
+        UString getName(const ConfigSection* text, const BinarySection* bin, Value val) const;
+        UString getBinaryName(const BinarySection* bin, Value val) const;
+        bool binaryFreeRange(const BinarySection* bin, Value first, Value last) const;
+
+        // Get the number of bits of a section.
+        size_t getBits(const ConfigSection* text, const BinarySection* bin) const;
+
         // Names private fields.
         Report&          _log;           // Error logger.
         const UString    _configFile;    // Configuration file path.
         size_t           _configErrors;  // Number of errors in configuration file.
-        ConfigSectionMap _sections;      // Configuration sections.
+        ConfigSectionMap _sections;      // Configuration sections in text files.
+        const uint8_t*   _image;         // Binary image, null if none.
+        size_t           _imageSize;     // Size in bytes of binary image.
+        bool             _imageMapped;   // Binary image is memory-mapped (otherwise in _imageData).
+        ByteBlock        _imageData;     // Binary image content when not memory-mapped.
     };
 
     //!
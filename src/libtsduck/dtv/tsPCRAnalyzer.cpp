@@ -49,13 +49,11 @@ ts::PCRAnalyzer::PCRAnalyzer(size_t min_pid, size_t min_pcr) :
     _ts_bitrate_188(0),
     _ts_bitrate_204(0),
     _ts_bitrate_cnt(0),
-    _inst_ts_bitrate_188(0),
-    _inst_ts_bitrate_204(0),
     _completed_pids(0),
     _pcr_pids(0),
     _discontinuities(0),
     _pid(),
-    _packet_pcr_index_map()
+    _last_clock_pid(PID_NULL)
 {
     TS_ZERO(_pid);
 }
@@ -82,8 +80,98 @@ ts::PCRAnalyzer::PIDAnalysis::PIDAnalysis() :
     last_pcr_packet(0),
     ts_bitrate_188(0),
     ts_bitrate_204(0),
-    ts_bitrate_cnt(0)
+    ts_bitrate_cnt(0),
+    windows()
 {
+    // Sliding windows of 1, 10 and 60 seconds, in the order of enum Window.
+    // The 1-second window keeps all values, the others are decimated.
+    windows.reserve(WINDOW_COUNT);
+    windows.push_back(SlidingWindow(SYSTEM_CLOCK_FREQ, 0));
+    windows.push_back(SlidingWindow(10 * SYSTEM_CLOCK_FREQ, 10 * SYSTEM_CLOCK_FREQ / 1000));
+    windows.push_back(SlidingWindow(60 * SYSTEM_CLOCK_FREQ, 60 * SYSTEM_CLOCK_FREQ / 1000));
+    assert(windows.size() == WINDOW_COUNT);
+}
+
+
+//----------------------------------------------------------------------------
+// SlidingWindow
+//----------------------------------------------------------------------------
+
+ts::PCRAnalyzer::SlidingWindow::SlidingWindow(uint64_t duration, uint64_t min_interval) :
+    bitrate_188(0),
+    bitrate_204(0),
+    pid_bitrate_188(0),
+    pid_bitrate_204(0),
+    _duration(duration),
+    _min_interval(min_interval),
+    _entries(),
+    _first(0),
+    _count(0)
+{
+}
+
+void ts::PCRAnalyzer::SlidingWindow::clear()
+{
+    _first = _count = 0;
+}
+
+bool ts::PCRAnalyzer::SlidingWindow::isBackward(bool use_dts, uint64_t clock) const
+{
+    if (_count == 0) {
+        return false;
+    }
+    const uint64_t last = _entries[(_first + _count - 1) & (CAPACITY - 1)].clock;
+    return use_dts ? !SequencedPTS(last, clock) : (clock < last && !WrapUpPCR(last, clock));
+}
+
+void ts::PCRAnalyzer::SlidingWindow::update(bool use_dts, uint64_t clock, PacketCounter packet, PacketCounter pid_packet)
+{
+    // A value in the past would be seen as a huge forward difference after wrap up.
+    if (isBackward(use_dts, clock)) {
+        return;
+    }
+
+    // Drop values older than the window duration.
+    while (_count > 0 && DiffClock(use_dts, _entries[_first].clock, clock) > _duration) {
+        _first = (_first + 1) & (CAPACITY - 1);
+        _count--;
+    }
+
+    // These are the actual bitrates over the window, not an average of bitrates between PCR's.
+    if (_count > 0) {
+        const Entry& oldest(_entries[_first]);
+        const uint64_t diff = DiffClock(use_dts, oldest.clock, clock);
+        bitrate_188 = diff == 0 ? 0 : ((packet - oldest.packet) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) / diff;
+        bitrate_204 = diff == 0 ? 0 : ((packet - oldest.packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE * 8) / diff;
+        pid_bitrate_188 = diff == 0 ? 0 : ((pid_packet - oldest.pid_packet) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) / diff;
+        pid_bitrate_204 = diff == 0 ? 0 : ((pid_packet - oldest.pid_packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE * 8) / diff;
+    }
+}
+
+void ts::PCRAnalyzer::SlidingWindow::push(bool use_dts, uint64_t clock, PacketCounter packet, PacketCounter pid_packet)
+{
+    if (isBackward(use_dts, clock)) {
+        // Out of order value, keep the window monotonic.
+        return;
+    }
+    if (_count > 0 && _min_interval > 0 && DiffClock(use_dts, _entries[(_first + _count - 1) & (CAPACITY - 1)].clock, clock) < _min_interval) {
+        // Too close to previous value, not useful for the evaluation.
+        return;
+    }
+    if (_entries.empty()) {
+        // Only the PID's with PCR/DTS use the ring buffer.
+        _entries.resize(CAPACITY);
+    }
+    if (_count == CAPACITY) {
+        // Make sure that some crazy TS does not accumulate thousands of values: drop oldest.
+        _first = (_first + 1) & (CAPACITY - 1);
+        _count--;
+    }
+    Entry& e(_entries[(_first + _count) & (CAPACITY - 1)]);
+    e.clock = clock;
+    e.packet = packet;
+    e.pid_packet = pid_packet;
+    _count++;
 }
 
 
@@ -100,7 +188,9 @@ ts::PCRAnalyzer::Status::Status() :
     pcr_pids(0),
     discontinuities(0),
     instantaneous_bitrate_188(0),
-    instantaneous_bitrate_204(0)
+    instantaneous_bitrate_204(0),
+    window_bitrate_188(),
+    window_bitrate_204()
 {
 }
 
@@ -116,8 +206,9 @@ ts::PCRAnalyzer::Status::Status(const PCRAnalyzer& an) : Status()
 
 ts::UString ts::PCRAnalyzer::Status::toString() const
 {
-    return UString::Format(u"valid: %s, bitrate: %'d b/s, packets: %'d, PCRs: %'d, PIDs with PCR: %'d, discont: %'d, instantaneous bitrate: %'d b/s",
-                           {bitrate_valid, bitrate_188, packet_count, pcr_count, pcr_pids, discontinuities, instantaneous_bitrate_188});
+    return UString::Format(u"valid: %s, bitrate: %'d b/s, packets: %'d, PCRs: %'d, PIDs with PCR: %'d, discont: %'d, instantaneous bitrate: %'d b/s, 10s: %'d b/s, 60s: %'d b/s",
+                           {bitrate_valid, bitrate_188, packet_count, pcr_count, pcr_pids, discontinuities, instantaneous_bitrate_188,
+                            window_bitrate_188[size_t(Window::SEC10)], window_bitrate_188[size_t(Window::SEC60)]});
 }
 
 
@@ -146,8 +237,6 @@ void ts::PCRAnalyzer::reset()
     _ts_bitrate_cnt = 0;
     _completed_pids = 0;
     _pcr_pids = 0;
-    _inst_ts_bitrate_188 = 0;
-    _inst_ts_bitrate_204 = 0;
 
     for (size_t i = 0; i < PID_MAX; ++i) {
         if (_pid[i] != nullptr) {
@@ -155,8 +244,7 @@ void ts::PCRAnalyzer::reset()
             _pid[i] = nullptr;
         }
     }
-
-    _packet_pcr_index_map.clear();
+    _last_clock_pid = PID_NULL;
 }
 
 
@@ -194,9 +282,11 @@ void ts::PCRAnalyzer::processDiscontinuity()
     for (size_t i = 0; i < PID_MAX; ++i) {
         if (_pid[i] != nullptr) {
             _pid[i]->last_pcr_value = INVALID_PCR;
+            for (auto& win : _pid[i]->windows) {
+                win.clear();
+            }
         }
     }
-    _packet_pcr_index_map.clear();
 }
 
 
@@ -217,12 +307,40 @@ ts::BitRate ts::PCRAnalyzer::bitrate204() const
 
 ts::BitRate ts::PCRAnalyzer::instantaneousBitrate188() const
 {
-    return BitRate(_inst_ts_bitrate_188);
+    return windowBitrate188(Window::SEC1);
 }
 
 ts::BitRate ts::PCRAnalyzer::instantaneousBitrate204() const
 {
-    return BitRate(_inst_ts_bitrate_204);
+    return windowBitrate204(Window::SEC1);
+}
+
+ts::BitRate ts::PCRAnalyzer::windowBitrate188(Window window) const
+{
+    const size_t index = size_t(window);
+    const PIDAnalysis* ps = _last_clock_pid < PID_MAX ? _pid[_last_clock_pid] : nullptr;
+    return ps != nullptr && index < ps->windows.size() ? BitRate(ps->windows[index].bitrate_188) : 0;
+}
+
+ts::BitRate ts::PCRAnalyzer::windowBitrate204(Window window) const
+{
+    const size_t index = size_t(window);
+    const PIDAnalysis* ps = _last_clock_pid < PID_MAX ? _pid[_last_clock_pid] : nullptr;
+    return ps != nullptr && index < ps->windows.size() ? BitRate(ps->windows[index].bitrate_204) : 0;
+}
+
+ts::BitRate ts::PCRAnalyzer::windowBitrate188(PID pid, Window window) const
+{
+    const size_t index = size_t(window);
+    const PIDAnalysis* ps = pid < PID_MAX ? _pid[pid] : nullptr;
+    return ps != nullptr && index < ps->windows.size() ? BitRate(ps->windows[index].pid_bitrate_188) : 0;
+}
+
+ts::BitRate ts::PCRAnalyzer::windowBitrate204(PID pid, Window window) const
+{
+    const size_t index = size_t(window);
+    const PIDAnalysis* ps = pid < PID_MAX ? _pid[pid] : nullptr;
+    return ps != nullptr && index < ps->windows.size() ? BitRate(ps->windows[index].pid_bitrate_204) : 0;
 }
 
 
@@ -269,6 +387,10 @@ void ts::PCRAnalyzer::getStatus(Status& stat) const
     stat.discontinuities = _discontinuities;
     stat.instantaneous_bitrate_188 = instantaneousBitrate188();
     stat.instantaneous_bitrate_204 = instantaneousBitrate204();
+    for (size_t i = 0; i < WINDOW_COUNT; ++i) {
+        stat.window_bitrate_188[i] = windowBitrate188(Window(i));
+        stat.window_bitrate_204[i] = windowBitrate204(Window(i));
+    }
 }
 
 
@@ -348,33 +470,13 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
         if (ps->last_pcr_value != INVALID_PCR && ps->last_pcr_value != pcr_dts) {
 
             // Compute transport rate in b/s since last PCR/DTS
-            uint64_t diff_values = _use_dts ?
-                DiffPTS(ps->last_pcr_value, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                DiffPCR(ps->last_pcr_value, pcr_dts);
+            const uint64_t diff_values = DiffClock(_use_dts, ps->last_pcr_value, pcr_dts);
 
-            uint64_t ts_bitrate_188 = diff_values == 0 ? 0 :
+            const uint64_t ts_bitrate_188 = diff_values == 0 ? 0 :
                 ((_ts_pkt_cnt - ps->last_pcr_packet) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) / diff_values;
-            uint64_t ts_bitrate_204 = diff_values == 0 ? 0 :
+            const uint64_t ts_bitrate_204 = diff_values == 0 ? 0 :
                 ((_ts_pkt_cnt - ps->last_pcr_packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE * 8) / diff_values;
 
-            // Clear out values older than 1 second from _packet_pcr_index_map.
-            // Note that this is a map that covers PCR/DTS packets across all PIDs
-            // as long as the clocks used to generate the PCR/DTS values for different
-            // programs is the same clock, there should be no issue, but if the PCR/DTS values
-            // across the two programs are wildly different, then the following approach won't work.
-            while (!_packet_pcr_index_map.empty()) {
-                const uint64_t earliestPCR_DTS = _packet_pcr_index_map.begin()->first;
-                diff_values = _use_dts ?
-                    DiffPTS(earliestPCR_DTS, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(earliestPCR_DTS, pcr_dts);
-                if (diff_values > SYSTEM_CLOCK_FREQ) {
-                    _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
-                }
-                else {
-                    break;
-                }
-            }
-
             // Per-PID statistics:
             ps->ts_bitrate_188 += ts_bitrate_188;
             ps->ts_bitrate_204 += ts_bitrate_204;
@@ -389,17 +491,13 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             _ts_bitrate_204 += ts_bitrate_204;
             _ts_bitrate_cnt++;
 
-            // Transport stream instantaneous statistics.
-            // For instantaneous bit rates, these are the actual bit rates, and it doesn't use the "count" approach.
-            if (!_packet_pcr_index_map.empty()) {
-                diff_values = _use_dts ?
-                    DiffPTS(_packet_pcr_index_map.begin()->first, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(_packet_pcr_index_map.begin()->first, pcr_dts);
-                _inst_ts_bitrate_188 = diff_values == 0 ? 0 :
-                    ((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) / diff_values;
-                _inst_ts_bitrate_204 = diff_values == 0 ? 0 :
-                    ((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE * 8) / diff_values;
+            // Transport stream and PID statistics over sliding windows (including instantaneous bitrate).
+            // Each PID has its own windows because the DTS of different PID's are not in sequence.
+            // The windows of the PID with the last PCR/DTS give the TS bitrates.
+            for (auto& win : ps->windows) {
+                win.update(_use_dts, pcr_dts, _ts_pkt_cnt, ps->ts_pkt_cnt);
             }
+            _last_clock_pid = pid;
 
             // Check if we got enough values for this PID
             if (ps->ts_bitrate_cnt == _min_pcr) {
@@ -413,13 +511,9 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             ps->last_pcr_value = pcr_dts;
             ps->last_pcr_packet = _ts_pkt_cnt;
 
-            // Also add PCR (or DTS)/packet index combo to map for use in instantaneous bit rate calculations.
-            _packet_pcr_index_map[pcr_dts] = _ts_pkt_cnt;
-
-            // Make sure that some crazy TS does not accumulate thousands of PCR values in the same second range.
-            while (_packet_pcr_index_map.size() > FOOLPROOF_MAP_LIMIT) {
-                // Erase older entries.
-                _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
+            // Also add PCR (or DTS)/packet index combo to sliding windows of this PID.
+            for (auto& win : ps->windows) {
+                win.push(_use_dts, pcr_dts, _ts_pkt_cnt, ps->ts_pkt_cnt);
             }
         }
     }
@@ -53,6 +53,20 @@ namespace ts {
         //!
         PCRAnalyzer(size_t min_pid = 1, size_t min_pcr = 64);
 
+        //!
+        //! Sliding time windows for the evaluation of the recent bitrate.
+        //!
+        enum class Window {
+            SEC1  = 0,  //!< Last second, the "instantaneous" bitrate.
+            SEC10 = 1,  //!< Last 10 seconds.
+            SEC60 = 2,  //!< Last 60 seconds.
+        };
+
+        //!
+        //! Number of sliding time windows.
+        //!
+        static constexpr size_t WINDOW_COUNT = 3;
+
         //!
         //! Destructor.
         //!
@@ -152,6 +166,38 @@ namespace ts {
         //!
         BitRate instantaneousBitrate204() const;
 
+        //!
+        //! Get the evaluated TS bitrate in bits/second based on 188-byte packets over a sliding time window.
+        //! @param [in] window The sliding time window, ending at the last PCR, in the PID of the last PCR.
+        //! @return The evaluated TS bitrate in bits/second based on 188-byte packets.
+        //!
+        BitRate windowBitrate188(Window window) const;
+
+        //!
+        //! Get the evaluated TS bitrate in bits/second based on 204-byte packets over a sliding time window.
+        //! @param [in] window The sliding time window, ending at the last PCR, in the PID of the last PCR.
+        //! @return The evaluated TS bitrate in bits/second based on 204-byte packets.
+        //!
+        BitRate windowBitrate204(Window window) const;
+
+        //!
+        //! Get the evaluated PID bitrate in bits/second based on 188-byte packets over a sliding time window.
+        //! @param [in] pid The PID to evaluate. The PID must carry PCR's (or DTS's).
+        //! @param [in] window The sliding time window, ending at the last PCR in @a pid.
+        //! @return The evaluated bitrate of @a pid in bits/second based on 188-byte packets.
+        //! Zero if @a pid does not carry PCR's (or DTS's).
+        //!
+        BitRate windowBitrate188(PID pid, Window window) const;
+
+        //!
+        //! Get the evaluated PID bitrate in bits/second based on 204-byte packets over a sliding time window.
+        //! @param [in] pid The PID to evaluate. The PID must carry PCR's (or DTS's).
+        //! @param [in] window The sliding time window, ending at the last PCR in @a pid.
+        //! @return The evaluated bitrate of @a pid in bits/second based on 204-byte packets.
+        //! Zero if @a pid does not carry PCR's (or DTS's).
+        //!
+        BitRate windowBitrate204(PID pid, Window window) const;
+
         //!
         //! Get the number of TS packets on a PID.
         //! @param [in] pid The PID to evaluate.
@@ -174,6 +220,8 @@ namespace ts {
             size_t        discontinuities; //!< The number of discontinuities.
             BitRate       instantaneous_bitrate_188;  //!< The evaluated TS bitrate in bits/second based on 188-byte packets for the last second.
             BitRate       instantaneous_bitrate_204;  //!< The evaluated TS bitrate in bits/second based on 204-byte packets for the last second.
+            BitRate       window_bitrate_188[WINDOW_COUNT]; //!< The evaluated TS bitrates in bits/second based on 188-byte packets, indexed by Window.
+            BitRate       window_bitrate_204[WINDOW_COUNT]; //!< The evaluated TS bitrates in bits/second based on 204-byte packets, indexed by Window.
 
             //!
             //! Default constructor.
@@ -200,6 +248,45 @@ namespace ts {
         // Process a discontinuity in the transport stream
         void processDiscontinuity();
 
+        // Sliding time window of PCR/DTS values in one PID, with the index of their packets in the
+        // TS and in the PID. This is a fixed-capacity ring buffer, in order of arrival. Values which
+        // are before the last stored one are ignored. Thus, the values are monotonic and the oldest
+        // values are always at the front of the buffer. The buffer is allocated on first use.
+        class SlidingWindow
+        {
+        public:
+            // Constructor. Consecutive values which are closer than min_interval are not stored.
+            SlidingWindow(uint64_t duration, uint64_t min_interval);
+            // Forget all values.
+            void clear();
+            // Drop the values which are outside the window ending at the current clock value
+            // and compute the bitrates since the oldest remaining value. Ignored if the clock
+            // value is before the last stored one.
+            void update(bool use_dts, uint64_t clock, PacketCounter packet, PacketCounter pid_packet);
+            // Add a new clock value. Ignored if the clock value is before the last stored one.
+            void push(bool use_dts, uint64_t clock, PacketCounter packet, PacketCounter pid_packet);
+            // Last computed bitrates, for the TS and for the PID.
+            uint64_t bitrate_188;
+            uint64_t bitrate_204;
+            uint64_t pid_bitrate_188;
+            uint64_t pid_bitrate_204;
+        private:
+            struct Entry {
+                uint64_t      clock;
+                PacketCounter packet;
+                PacketCounter pid_packet;
+            };
+            static constexpr size_t CAPACITY = 1024;  // Must be a power of 2.
+            const uint64_t     _duration;
+            const uint64_t     _min_interval;
+            std::vector<Entry> _entries;   // Ring buffer of CAPACITY entries.
+            size_t             _first;     // Index of oldest entry.
+            size_t             _count;     // Number of entries.
+
+            // Check if a clock value is before the last stored one, taking wrap up into account.
+            bool isBackward(bool use_dts, uint64_t clock) const;
+        };
+
         // Analysis of one PID
         struct PIDAnalysis
         {
@@ -213,8 +300,15 @@ namespace ts {
             uint64_t ts_bitrate_188;   // Sum of all computed TS bitrates (188-byte)
             uint64_t ts_bitrate_204;   // Sum of all computed TS bitrates (204-byte)
             uint64_t ts_bitrate_cnt;   // Count of computed TS bitrates
+            std::vector<SlidingWindow> windows;  // Sliding time windows on PCR/DTS of this PID, indexed by Window.
         };
 
+        // Difference between two PCR or DTS, in PCR units.
+        static uint64_t DiffClock(bool use_dts, uint64_t clock1, uint64_t clock2)
+        {
+            return use_dts ? DiffPTS(clock1, clock2) * SYSTEM_CLOCK_SUBFACTOR : DiffPCR(clock1, clock2);
+        }
+
         // Private members:
         bool     _use_dts;             // Use DTS instead of PCR
         bool     _ignore_errors;       // Ignore TS errors such as discontinuities.
@@ -225,13 +319,10 @@ namespace ts {
         uint64_t _ts_bitrate_188;      // Sum of all computed TS bitrates (188-byte)
         uint64_t _ts_bitrate_204;      // Sum of all computed TS bitrates (204-byte)
         uint64_t _ts_bitrate_cnt;      // Count of computed bitrates
-        uint64_t _inst_ts_bitrate_188; // Sum of all computed TS bitrates (188-byte) for last second
-        uint64_t _inst_ts_bitrate_204; // Sum of all computed TS bitrates (204-byte) for last second
         size_t   _completed_pids;      // Number of PIDs with enough PCRs
         size_t   _pcr_pids;            // Number of PIDs with PCRs
         size_t   _discontinuities;     // Number of discontinuities
         PIDAnalysis* _pid[PID_MAX];    // Per-PID stats
-        std::map<uint64_t, uint64_t> _packet_pcr_index_map; // Map of PCR/DTS to packet index across entire TS
-        static constexpr size_t FOOLPROOF_MAP_LIMIT = 1000; // Max number of entries in the PCR map
+        PID      _last_clock_pid;      // PID of last PCR/DTS, its sliding windows are used for the TS.
     };
 }
@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Dense table of values, indexed by PID.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! Dense table of values, indexed by PID.
+    //! @ingroup mpeg
+    //!
+    //! The interface is a subset of @c std::map with PID as key: the entries are
+    //! @c std::pair with the PID as @c first and the value as @c second and the
+    //! iterations are done in increasing order of PID. But the values are stored
+    //! in a vector of PID_MAX entries and the access by PID is direct.
+    //!
+    //! The storage is allocated on first insertion and freed when the table is cleared.
+    //! Unlike @c std::map, any reference or iterator in the table is invalidated when
+    //! the table is cleared. Inserting or removing one PID does not invalidate them.
+    //!
+    //! @tparam T The type of the values. It must be default-constructible and assignable.
+    //! This is typically a safe pointer to some context structure.
+    //!
+    template <typename T>
+    class PIDTable
+    {
+    public:
+        //!
+        //! Type of the entries in the table.
+        //!
+        typedef std::pair<PID, T> value_type;
+
+    private:
+        // Generic iterator, const or non-const depending on TABLE and ENTRY.
+        template <class TABLE, class ENTRY>
+        class BaseIterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef PIDTable::value_type      value_type;
+            typedef std::ptrdiff_t            difference_type;
+            typedef ENTRY*                    pointer;
+            typedef ENTRY&                    reference;
+
+            BaseIterator(TABLE* table = nullptr, size_t index = PID_MAX) : _table(table), _index(index) {}
+            template <class TABLE2, class ENTRY2>
+            BaseIterator(const BaseIterator<TABLE2,ENTRY2>& other) : _table(other._table), _index(other._index) {}
+
+            ENTRY& operator*() const { return _table->_entries[_index]; }
+            ENTRY* operator->() const { return &_table->_entries[_index]; }
+            BaseIterator& operator++() { _index = _table->next(_index + 1); return *this; }
+            BaseIterator operator++(int) { BaseIterator tmp(*this); ++*this; return tmp; }
+            bool operator==(const BaseIterator& other) const { return _index == other._index; }
+            bool operator!=(const BaseIterator& other) const { return _index != other._index; }
+
+        private:
+            template <class TABLE2, class ENTRY2> friend class BaseIterator;
+            TABLE* _table;
+            size_t _index;
+        };
+
+    public:
+        //!
+        //! Iterator over the entries of the table, in increasing order of PID.
+        //!
+        typedef BaseIterator<PIDTable, value_type> iterator;
+
+        //!
+        //! Constant iterator over the entries of the table, in increasing order of PID.
+        //!
+        typedef BaseIterator<const PIDTable, const value_type> const_iterator;
+
+        //!
+        //! Default constructor.
+        //!
+        PIDTable();
+
+        //!
+        //! Get the value for a PID, create it with a default value if it does not exist.
+        //! @param [in] pid The PID to access, must be lower than PID_MAX.
+        //! @return A reference to the value for @a pid.
+        //!
+        T& operator[](PID pid);
+
+        //!
+        //! Check if a PID is in the table.
+        //! @param [in] pid The PID to search.
+        //! @return 1 if @a pid is in the table, 0 otherwise.
+        //!
+        size_t count(PID pid) const { return pid < PID_MAX && _used.test(pid) ? 1 : 0; }
+
+        //!
+        //! Get the number of PID's in the table.
+        //! @return The number of PID's in the table.
+        //!
+        size_t size() const { return _count; }
+
+        //!
+        //! Check if the table is empty.
+        //! @return True if the table is empty.
+        //!
+        bool empty() const { return _count == 0; }
+
+        //!
+        //! Remove one PID from the table.
+        //! @param [in] pid The PID to remove.
+        //! @return The number of removed entries, 1 or 0.
+        //!
+        size_t erase(PID pid);
+
+        //!
+        //! Remove all entries and deallocate the storage.
+        //!
+        void clear();
+
+        //!
+        //! Search a PID in the table.
+        //! @param [in] pid The PID to search.
+        //! @return An iterator to the entry of @a pid or end() if @a pid is not in the table.
+        //!
+        iterator find(PID pid) { return iterator(this, count(pid) != 0 ? pid : PID_MAX); }
+
+        //!
+        //! Search a PID in the table (constant version).
+        //! @param [in] pid The PID to search.
+        //! @return An iterator to the entry of @a pid or end() if @a pid is not in the table.
+        //!
+        const_iterator find(PID pid) const { return const_iterator(this, count(pid) != 0 ? pid : PID_MAX); }
+
+        //!
+        //! Get an iterator to the first entry, with the lowest PID.
+        //! @return An iterator to the first entry.
+        //!
+        iterator begin() { return iterator(this, next(0)); }
+
+        //!
+        //! Get an iterator after the last entry.
+        //! @return An iterator after the last entry.
+        //!
+        iterator end() { return iterator(this, PID_MAX); }
+
+        //!
+        //! Get a constant iterator to the first entry, with the lowest PID.
+        //! @return A constant iterator to the first entry.
+        //!
+        const_iterator begin() const { return const_iterator(this, next(0)); }
+
+        //!
+        //! Get a constant iterator after the last entry.
+        //! @return A constant iterator after the last entry.
+        //!
+        const_iterator end() const { return const_iterator(this, PID_MAX); }
+
+    private:
+        std::vector<value_type> _entries;  // Indexed by PID, empty or PID_MAX entries.
+        PIDSet                  _used;     // PID's which are in the table.
+        size_t                  _count;    // Number of PID's in the table.
+
+        // Get the first used PID, starting at index, PID_MAX if there is none.
+        size_t next(size_t index) const;
+    };
+}
+
+#include "tsPIDTableTemplate.h"
@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::PIDTable<T>::PIDTable() :
+    _entries(),
+    _used(),
+    _count(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get the value for a PID, create it if it does not exist.
+//----------------------------------------------------------------------------
+
+template <typename T>
+T& ts::PIDTable<T>::operator[](PID pid)
+{
+    assert(pid < PID_MAX);
+
+    // Allocate the storage on first use.
+    if (_entries.empty()) {
+        _entries.reserve(PID_MAX);
+        for (PID p = 0; p < PID_MAX; ++p) {
+            _entries.push_back(value_type(p, T()));
+        }
+    }
+
+    if (!_used.test(pid)) {
+        _used.set(pid);
+        _count++;
+    }
+    return _entries[pid].second;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove one PID from the table.
+//----------------------------------------------------------------------------
+
+template <typename T>
+size_t ts::PIDTable<T>::erase(PID pid)
+{
+    if (count(pid) == 0) {
+        return 0;
+    }
+    else {
+        _entries[pid].second = T();
+        _used.reset(pid);
+        _count--;
+        return 1;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Remove all entries and deallocate the storage.
+//----------------------------------------------------------------------------
+
+template <typename T>
+void ts::PIDTable<T>::clear()
+{
+    std::vector<value_type>().swap(_entries);
+    _used.reset();
+    _count = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the first used PID, starting at index.
+//----------------------------------------------------------------------------
+
+template <typename T>
+size_t ts::PIDTable<T>::next(size_t index) const
+{
+    while (index < PID_MAX && !_used.test(index)) {
+        index++;
+    }
+    return index;
+}
@@ -32,7 +32,10 @@
 #include "tsBinaryTable.h"
 #include "tsSectionFile.h"
 #include "tsxmlComment.h"
+#include "tsxmlDeclaration.h"
 #include "tsxmlElement.h"
+#include "tsxmlTextSerializer.h"
+#include "tsxmlJSONSerializer.h"
 #include "tsjsonArray.h"
 #include "tsjsonObject.h"
 #include "tsTSPacket.h"
@@ -62,6 +65,7 @@ ts::PSILogger::PSILogger(TablesDisplay& display) :
     _log_json_line(false),
     _use_current(true),
     _use_next(false),
+    _skip_unchanged(false),
     _text_destination(),
     _xml_destination(),
     _json_destination(),
@@ -75,6 +79,7 @@ ts::PSILogger::PSILogger(TablesDisplay& display) :
     _x2j_conv(_report),
     _json_doc(_report),
     _abort(false),
+    _skipped_reported(false),
     _pat_ok(_cat_only),
     _cat_ok(_clear),
     _sdt_ok(_cat_only),
@@ -150,6 +155,11 @@ void ts::PSILogger::defineArgs(Args& args) const
               u"If you need text formatting on the standard output in addition to other output such as XML, "
               u"explicitly specify this option with \"-\" as output file name.");
 
+    args.option(u"skip-unchanged");
+    args.help(u"skip-unchanged",
+              u"With --all-versions, do not display a new version of a table when its content has not "
+              u"changed, except the version number. Unchanged sections are not parsed.");
+
     args.option(u"text-output", 0, Args::STRING);
     args.help(u"text-output", u"filename", u"A synonym for --output-file.");
 
@@ -200,6 +210,7 @@ bool ts::PSILogger::loadArgs(DuckContext& duck, Args& args)
     _dump = args.present(u"dump");
     _use_current = !args.present(u"exclude-current");
     _use_next = args.present(u"include-next");
+    _skip_unchanged = args.present(u"skip-unchanged");
 
     // Load XML options.
     return _xml_tweaks.loadArgs(duck, args);
@@ -269,12 +280,20 @@ bool ts::PSILogger::open()
 
     // Type of sections to get.
     _demux.setCurrentNext(_use_current, _use_next);
+    _demux.setSkipUnchanged(_skip_unchanged);
+    _skipped_reported = false;
 
     return true;
 }
 
 void ts::PSILogger::close()
 {
+    // Report skipped tables only once, close() is also invoked by the destructor.
+    if (_skip_unchanged && !_skipped_reported) {
+        _skipped_reported = true;
+        const SectionDemux::Status status(_demux);
+        _report.verbose(u"skipped %'d unchanged tables and %'d unchanged sections", {status.unchanged_table, status.unchanged_sect});
+    }
     _xml_doc.close();
     _json_doc.close();
 }
@@ -527,65 +546,60 @@ void ts::PSILogger::displayTable(const BinaryTable& table)
     BinaryTable::XMLOptions xml_options;
     xml_options.setPID = true;
 
+    // The table is directly serialized in XML or JSON, without building an XML structure.
+    if (!table.isValid()) {
+        return;
+    }
+
     // Full XML output.
     if (_use_xml) {
-        // Convert the table into an XML structure.
-        table.toXML(_duck, _xml_doc.rootElement(), xml_options);
-
-        // Print and delete the new table.
-        _xml_doc.flush();
+        TextFormatter* text = _xml_doc.startElement();
+        if (text != nullptr) {
+            xml::TextSerializer output(*text, _xml_doc.tweaks());
+            table.toXML(_duck, output, xml_options);
+            output.close();
+            _xml_doc.endElement();
+        }
     }
 
     // Save table in JSON format.
     if (_use_json) {
-        // First, build an XML document with the table.
-        xml::Document doc(_report);
-        doc.initialize(u"tsduck");
-        table.toXML(_duck, doc.rootElement(), xml_options);
-
-        // Convert to JSON. Force "tsduck" root to appear so that the path to the first table is always the same.
-        // Query the first (and only) converted table and add it to the running document.
-        _json_doc.add(_x2j_conv.convertToJSON(doc, true)->query(u"#nodes[0]"));
+        TextFormatter* text = _json_doc.startValue();
+        if (text != nullptr) {
+            xml::JSONSerializer output(*text, _x2j_conv, u"tsduck");
+            table.toXML(_duck, output, xml_options);
+        }
     }
 
     // XML and/or JSON one-liner in the log.
     if (_log_xml_line || _log_json_line) {
 
-        // Build an XML document.
-        xml::Document doc;
-        doc.initialize(u"tsduck");
-
-        // Convert the table into an XML structure.
-        xml::Element* elem = table.toXML(_duck, doc.rootElement(), xml_options);
-        if (elem != nullptr) {
-
-            // Initialize a text formatter for one-liner.
-            TextFormatter text(_report);
-            text.setString();
-            text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+        // Initialize a text formatter for one-liner.
+        TextFormatter text(_report);
+        text.setString();
+        text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+
+        // Log the XML line, as a complete document with default XML tweaks.
+        if (_log_xml_line) {
+            text << "<?" << UString(xml::Declaration::DEFAULT_XML_DECLARATION) << "?>" << ts::endl;
+            xml::TextSerializer output(text, xml::Tweaks(), 1);
+            output.startElement(u"tsduck");
+            table.toXML(_duck, output, xml_options);
+            output.close();
+            text << ts::endl;
+            _report.info(_log_xml_prefix + text.toString());
+        }
 
-            // Log the XML line.
+        // Log the JSON line.
+        if (_log_json_line) {
+            // Reset the text formatter if already used for XML.
             if (_log_xml_line) {
-                doc.print(text);
-                _report.info(_log_xml_prefix + text.toString());
-            }
-
-            // Log the JSON line.
-            if (_log_json_line) {
-
-                // Convert the XML document into JSON.
-                // Force "tsduck" root to appear so that the path to the first table is always the same.
-                const json::ValuePtr root(_x2j_conv.convertToJSON(doc, true));
-
-                // Reset the text formatter if already used for XML.
-                if (_log_xml_line) {
-                    text.setString();
-                }
-
-                // Query the first (and only) converted table and log it as one line.
-                root->query(u"#nodes[0]").print(text);
-                _report.info(_log_json_prefix + text.toString());
+                text.setString();
             }
+            xml::JSONSerializer output(text, _x2j_conv, u"tsduck");
+            table.toXML(_duck, output, xml_options);
+            output.close();
+            _report.info(_log_json_prefix + text.toString());
         }
     }
 }
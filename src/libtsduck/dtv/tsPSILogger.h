@@ -122,6 +122,7 @@ namespace ts {
         bool        _log_json_line;           // Log tables as one JSON line in the system message log.
         bool        _use_current;             // Use PSI tables with "current" flag.
         bool        _use_next;                // Use PSI tables with "next" flag.
+        bool        _skip_unchanged;          // Ignore new versions of tables with unchanged content.
         UString     _text_destination;        // Text output file name.
         UString     _xml_destination;         // XML output file name.
         UString     _json_destination;        // JSON output file name.
@@ -137,6 +138,7 @@ namespace ts {
         xml::JSONConverter    _x2j_conv;      // XML-to-JSON converter.
         json::RunningDocument _json_doc;      // JSON document, built on-the-fly.
         bool                  _abort;
+        bool                  _skipped_reported;  // Skipped tables were already reported.
         bool                  _pat_ok;        // Got a PAT
         bool                  _cat_ok;        // Got a CAT or not interested in CAT
         bool                  _sdt_ok;        // Got an SDT
@@ -0,0 +1,278 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketPacer.h"
+#include "tsNullReport.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr ts::NanoSecond ts::PacketPacer::MAX_SPIN;
+constexpr ts::NanoSecond ts::PacketPacer::MIN_SPIN;
+constexpr ts::NanoSecond ts::PacketPacer::MAX_LATENESS;
+#endif
+
+// Number of short sleeps to calibrate the spin tail.
+#define CALIBRATION_COUNT 16
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::PacketPacer::PacketPacer(Report* report) :
+    _report(report == nullptr ? NullReport::Instance() : report),
+    _mode(Mode::BITRATE),
+    _fixed_bitrate(0),
+    _user_pid(PID_NULL),
+    _pid(PID_NULL),
+    _calibrated(false),
+    _spin(MIN_SPIN),
+    _started(false),
+    _pkt_index(0),
+    _base(),
+    _base_pkt(0),
+    _ns_per_pkt(0.0),
+    _bitrate(0),
+    _pcr_rate(false),
+    _last_pcr(INVALID_PCR),
+    _last_pcr_time(),
+    _last_pcr_pkt(0),
+    _deadline(),
+    _now(),
+    _wake(),
+    _has_previous(false),
+    _previous(0),
+    _resync_count(0),
+    _lateness(),
+    _jitter()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the pacing state and the statistics.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::reset()
+{
+    _pid = _user_pid;
+    _calibrated = false;
+    _started = false;
+    _pkt_index = 0;
+    _base_pkt = 0;
+    _ns_per_pkt = 0.0;
+    _bitrate = 0;
+    _pcr_rate = false;
+    _last_pcr = INVALID_PCR;
+    _last_pcr_pkt = 0;
+    _has_previous = false;
+    _previous = 0;
+    _resync_count = 0;
+    _lateness.reset();
+    _jitter.reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Calibrate the spin tail on the wake-up latency of a few short sleeps.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::calibrate()
+{
+    NanoSecond latency = 0;
+    for (size_t i = 0; i < CALIBRATION_COUNT; ++i) {
+        _wake.getSystemTime();
+        _wake += 100 * NanoSecPerMicroSec;
+        _wake.wait();
+        _now.getSystemTime();
+        latency = std::max(latency, _now - _wake);
+    }
+    _spin = std::max(MIN_SPIN, std::min(MAX_SPIN, latency + latency / 4));
+    _calibrated = true;
+    _report->debug(u"pacing: max wake-up latency: %'d ns, spin tail: %'d ns", {latency, _spin});
+}
+
+
+//----------------------------------------------------------------------------
+// Packet timeline.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::rebase(PacketCounter pkt, const Monotonic& base)
+{
+    _base = base;
+    _base_pkt = pkt;
+    _started = true;
+}
+
+void ts::PacketPacer::packetTime(Monotonic& time, PacketCounter pkt) const
+{
+    time = _base;
+    time += NanoSecond(double(int64_t(pkt) - int64_t(_base_pkt)) * _ns_per_pkt);
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until the deadline of the next group of packets.
+//----------------------------------------------------------------------------
+
+void ts::PacketPacer::pace(const TSPacket* pkt, size_t count, BitRate bitrate)
+{
+    if (!_calibrated) {
+        calibrate();
+    }
+
+    const PacketCounter index = _pkt_index;
+    _pkt_index += count;
+
+    // Is the time of the first packet in the group known?
+    bool known = _started && _ns_per_pkt > 0.0;
+    if (known) {
+        packetTime(_deadline, index);
+    }
+
+    // In PCR mode, the PCR's of the reference PID define the timeline.
+    if (_mode == Mode::PCR) {
+        for (size_t i = 0; i < count; ++i) {
+            if (pkt[i].hasPCR()) {
+                const PID pid = pkt[i].getPID();
+                if (_pid == PID_NULL) {
+                    _pid = pid;
+                    _report->verbose(u"pacing on PCR PID 0x%X (%d)", {_pid, _pid});
+                }
+                if (pid == _pid) {
+                    const uint64_t pcr = pkt[i].getPCR();
+                    const PacketCounter pcr_pkt = index + i;
+                    const uint64_t diff = _last_pcr == INVALID_PCR ? INVALID_PCR : DiffPCR(_last_pcr, pcr);
+                    if (diff != INVALID_PCR && diff <= SYSTEM_CLOCK_FREQ && pcr_pkt > _last_pcr_pkt) {
+                        // Regular PCR, less than one second after the previous one: the packet rate is known.
+                        const NanoSecond duration = NanoSecond((diff * NanoSecPerSec) / SYSTEM_CLOCK_FREQ);
+                        _ns_per_pkt = double(duration) / double(pcr_pkt - _last_pcr_pkt);
+                        _pcr_rate = true;
+                        _last_pcr_time += duration;
+                        rebase(pcr_pkt, _last_pcr_time);
+                        packetTime(_deadline, index);
+                        known = true;
+                    }
+                    else {
+                        // First PCR or discontinuity, anchor this PCR on the current timeline.
+                        if (_last_pcr != INVALID_PCR) {
+                            _report->debug(u"pacing: PCR discontinuity, resynchronizing");
+                        }
+                        if (known) {
+                            packetTime(_last_pcr_time, pcr_pkt);
+                        }
+                        else {
+                            _last_pcr_time.getSystemTime();
+                        }
+                    }
+                    _last_pcr = pcr;
+                    _last_pcr_pkt = pcr_pkt;
+                    break;
+                }
+            }
+        }
+    }
+
+    // In bitrate mode, or in PCR mode until two PCR's are found, the bitrate defines the timeline.
+    const BitRate br = _fixed_bitrate > 0 ? _fixed_bitrate : bitrate;
+    if ((_mode == Mode::BITRATE || !_pcr_rate) && br > 0 && br != _bitrate) {
+        // The new bitrate applies from the current group.
+        if (known) {
+            rebase(index, _deadline);
+        }
+        else {
+            _now.getSystemTime();
+            rebase(index, _now);
+        }
+        _bitrate = br;
+        _ns_per_pkt = double(PKT_SIZE_BITS * NanoSecPerSec) / double(br);
+        packetTime(_deadline, index);
+        known = true;
+    }
+
+    // Without packet rate, the packets cannot be paced.
+    if (!known) {
+        return;
+    }
+
+    // When the flow is too late (input starvation for instance) or the deadline is
+    // unexpectedly far (inconsistent rate), resynchronize on the current time.
+    _now.getSystemTime();
+    const NanoSecond late = _now - _deadline;
+    if (late > MAX_LATENESS || late < -NanoSecPerSec) {
+        _resync_count++;
+        _report->debug(u"pacing: resynchronizing, deadline was %'d microseconds late", {late / NanoSecPerMicroSec});
+        _base += late;
+        _last_pcr_time += late;
+        _deadline = _now;
+        _has_previous = false;
+    }
+
+    // Wait and collect statistics.
+    const NanoSecond lateness = waitUntil(_deadline);
+    _lateness.feed(double(lateness) / double(NanoSecPerMicroSec));
+    if (_has_previous) {
+        _jitter.feed(double(lateness - _previous) / double(NanoSecPerMicroSec));
+    }
+    _previous = lateness;
+    _has_previous = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until a precise time of the monotonic clock.
+//----------------------------------------------------------------------------
+
+ts::NanoSecond ts::PacketPacer::waitUntil(const Monotonic& deadline)
+{
+    // Sleep on an absolute time until the beginning of the spin tail.
+    _now.getSystemTime();
+    if (deadline - _now > _spin) {
+        _wake = deadline;
+        _wake -= _spin;
+        _wake.wait();
+        _now.getSystemTime();
+
+        // Adjust the spin tail on the observed wake-up latency.
+        // Increase immediately after a late wake-up, decrease slowly otherwise.
+        const NanoSecond latency = _now - _wake;
+        if (latency > _spin) {
+            _spin = std::min(MAX_SPIN, latency + latency / 4);
+        }
+        else {
+            _spin = std::max(MIN_SPIN, _spin - (_spin - latency) / 64);
+        }
+    }
+
+    // Active wait until the deadline.
+    while (_now < deadline) {
+        _now.getSystemTime();
+    }
+    return _now - deadline;
+}
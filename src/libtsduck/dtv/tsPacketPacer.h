@@ -0,0 +1,199 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Precise pacing of groups of TS packets, by bitrate or PCR.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+#include "tsTSPacket.h"
+#include "tsReport.h"
+#include "tsMonotonic.h"
+#include "tsSingleDataStatistics.h"
+
+namespace ts {
+    //!
+    //! Precise pacing of groups of TS packets, typically UDP datagrams, by bitrate or PCR.
+    //! @ingroup mpeg
+    //! @see BitRateRegulator
+    //! @see PCRRegulator
+    //!
+    //! BitRateRegulator and PCRRegulator suspend the flow by bursts of several
+    //! milliseconds. This class computes an absolute deadline for each group of
+    //! packets and waits until this precise time. The wait is a sleep on an absolute
+    //! time of the monotonic clock (clock_nanosleep() on Linux), ending a bit before
+    //! the deadline, followed by an active wait ("spin") until the deadline. The
+    //! duration of the spin tail is continuously calibrated on the observed wake-up
+    //! latency of the system.
+    //!
+    class TSDUCKDLL PacketPacer
+    {
+        TS_NOCOPY(PacketPacer);
+    public:
+        //!
+        //! Pacing mode.
+        //!
+        enum class Mode {
+            BITRATE,  //!< Pace packets at the bitrate of the stream.
+            PCR,      //!< Pace packets according to the PCR's of a reference PID.
+        };
+
+        //!
+        //! Maximum duration of the spin tail in nanoseconds.
+        //! If the wake-up latency of the system is higher, the precision is degraded.
+        //!
+        static constexpr NanoSecond MAX_SPIN = 2 * NanoSecPerMilliSec;
+
+        //!
+        //! Minimum duration of the spin tail in nanoseconds.
+        //!
+        static constexpr NanoSecond MIN_SPIN = 10 * NanoSecPerMicroSec;
+
+        //!
+        //! Maximum lateness in nanoseconds.
+        //! When a group of packets is later than this, the pacing is resynchronized
+        //! on the current time, instead of bursting to catch up.
+        //!
+        static constexpr NanoSecond MAX_LATENESS = 100 * NanoSecPerMilliSec;
+
+        //!
+        //! Constructor.
+        //! @param [in,out] report Where to report debug messages.
+        //!
+        PacketPacer(Report* report = nullptr);
+
+        //!
+        //! Set the pacing mode.
+        //! @param [in] mode Pacing mode.
+        //!
+        void setMode(Mode mode) { _mode = mode; }
+
+        //!
+        //! Set a fixed bitrate.
+        //! @param [in] bitrate Fixed bitrate of the stream. With Mode::BITRATE, this bitrate is used
+        //! instead of the bitrate which is passed to pace(). With Mode::PCR, this bitrate is used before
+        //! the packet rate is known from two PCR's. Zero means no fixed bitrate.
+        //!
+        void setBitRate(BitRate bitrate) { _fixed_bitrate = bitrate; }
+
+        //!
+        //! Set the PCR reference PID.
+        //! @param [in] pid Reference PID. If PID_NULL, use the first PID containing PCR's.
+        //!
+        void setReferencePID(PID pid) { _user_pid = pid; }
+
+        //!
+        //! Reset the pacing state and the statistics.
+        //! The first call after reset() calibrates the spin tail.
+        //!
+        void reset();
+
+        //!
+        //! Wait until the deadline of the next group of packets.
+        //! All packets of the stream must be passed, in order, through successive calls.
+        //! @param [in] pkt Address of the first packet of the group.
+        //! @param [in] count Number of packets in the group.
+        //! @param [in] bitrate Current bitrate of the stream, used when no fixed bitrate is set. Zero if unknown.
+        //! When no rate can be determined, the packets are not delayed.
+        //!
+        void pace(const TSPacket* pkt, size_t count, BitRate bitrate);
+
+        //!
+        //! Wait until a precise time of the monotonic clock.
+        //! @param [in] deadline Time to wait for.
+        //! @return The lateness in nanoseconds, the difference between the actual time at the end of
+        //! the wait and @a deadline. Normally zero or positive.
+        //!
+        NanoSecond waitUntil(const Monotonic& deadline);
+
+        //!
+        //! Get the statistics of the lateness of each group of packets after waiting.
+        //! @return The statistics of lateness in microseconds.
+        //!
+        const SingleDataStatistics<double>& latenessStatistics() const { return _lateness; }
+
+        //!
+        //! Get the statistics of the inter-packet jitter.
+        //! The jitter is the difference between the actual interval between two consecutive
+        //! groups of packets and their scheduled interval.
+        //! @return The statistics of the jitter in microseconds.
+        //!
+        const SingleDataStatistics<double>& jitterStatistics() const { return _jitter; }
+
+        //!
+        //! Get the number of times the pacing was resynchronized because the flow was too late.
+        //! @return The number of resynchronizations.
+        //!
+        size_t resyncCount() const { return _resync_count; }
+
+        //!
+        //! Get the current duration of the spin tail.
+        //! @return The duration of the active wait before each deadline in nanoseconds.
+        //!
+        NanoSecond spinDuration() const { return _spin; }
+
+    private:
+        Report*       _report;
+        Mode          _mode;
+        BitRate       _fixed_bitrate;   // User-specified bitrate.
+        PID           _user_pid;        // User-specified reference PID.
+        PID           _pid;             // Current reference PID.
+        bool          _calibrated;      // Spin tail is calibrated.
+        NanoSecond    _spin;            // Duration of the spin tail.
+        bool          _started;         // The base time is set.
+        PacketCounter _pkt_index;       // Index of next packet to pace.
+        Monotonic     _base;            // Time of base packet.
+        PacketCounter _base_pkt;        // Index of base packet.
+        double        _ns_per_pkt;      // Current packet interval in nanoseconds, zero if unknown.
+        BitRate       _bitrate;         // Bitrate for _ns_per_pkt in bitrate mode.
+        bool          _pcr_rate;        // The packet interval comes from PCR's.
+        uint64_t      _last_pcr;        // Last PCR value in reference PID.
+        Monotonic     _last_pcr_time;   // Time of packet with last PCR.
+        PacketCounter _last_pcr_pkt;    // Index of packet with last PCR.
+        Monotonic     _deadline;        // Deadline of current group.
+        Monotonic     _now;             // Current time.
+        Monotonic     _wake;            // Wake-up time, before the spin tail.
+        bool          _has_previous;    // There is a previous lateness for the jitter.
+        NanoSecond    _previous;        // Lateness of previous group.
+        size_t        _resync_count;    // Number of resynchronizations.
+        SingleDataStatistics<double> _lateness;
+        SingleDataStatistics<double> _jitter;
+
+        // Calibrate the spin tail on the wake-up latency of a few short sleeps.
+        void calibrate();
+
+        // Rebase the packet timeline: packet at index pkt is now at time base.
+        void rebase(PacketCounter pkt, const Monotonic& base);
+
+        // Compute the time of a packet index from the base, using the current packet interval.
+        void packetTime(Monotonic& time, PacketCounter pkt) const;
+    };
+}
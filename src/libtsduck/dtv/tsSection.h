@@ -665,6 +665,20 @@ namespace ts {
         template <class CONTAINER>
         static PacketCounter PacketCount(const CONTAINER& container, bool pack = true);
 
+        //!
+        //! Allocation operator. Section objects are allocated in a MemoryPool.
+        //! @param [in] size Size of the object.
+        //! @return Address of the allocated object.
+        //!
+        static void* operator new(size_t size) { return MemoryPool::Allocate(size); }
+
+        //!
+        //! Deallocation operator.
+        //! @param [in] ptr Address of the object.
+        //! @param [in] size Size of the object.
+        //!
+        static void operator delete(void* ptr, size_t size) { MemoryPool::Deallocate(ptr, size); }
+
         // Implementation of AbstractDefinedByStandards
         virtual Standards definingStandards() const override;
 
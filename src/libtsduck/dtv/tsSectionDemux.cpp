@@ -33,9 +33,34 @@
 #include "tsBinaryTable.h"
 #include "tsTSPacket.h"
 #include "tsEIT.h"
+#include "tsXXHash.h"
 TSDUCK_SOURCE;
 
 
+//----------------------------------------------------------------------------
+// Compute a hash of the content of a section, ignoring version and CRC32.
+//----------------------------------------------------------------------------
+
+namespace {
+    uint64_t ContentHash(const uint8_t* data, size_t size, bool long_header)
+    {
+        uint64_t hash = 0;
+        if (long_header && size >= ts::MIN_LONG_SECTION_SIZE) {
+            // Mask the version in the long header, skip the CRC32.
+            uint8_t header[ts::LONG_SECTION_HEADER_SIZE];
+            ::memcpy(header, data, sizeof(header));
+            header[5] &= 0xC1;
+            hash = ts::XXHash64(data + sizeof(header), size - sizeof(header) - ts::SECTION_CRC32_SIZE, ts::XXHash64(header, sizeof(header)));
+        }
+        else {
+            hash = ts::XXHash64(data, size);
+        }
+        // Zero means "no previous section" in the ETID contexts.
+        return hash == 0 ? 1 : hash;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Demux status information.
 //----------------------------------------------------------------------------
@@ -47,7 +72,10 @@ ts::SectionDemux::Status::Status() :
     inv_sect_length(0),
     inv_sect_index(0),
     wrong_crc(0),
-    is_next(0)
+    is_next(0),
+    unchanged_sect(0),
+    unchanged_table(0),
+    skip_unchanged(false)
 {
 }
 
@@ -66,9 +94,11 @@ void ts::SectionDemux::Status::reset()
     inv_sect_index = 0;
     wrong_crc = 0;
     is_next = 0;
+    unchanged_sect = 0;
+    unchanged_table = 0;
 }
 
-// Check if any counter is non zero.
+// Check if any error counter is non zero.
 bool ts::SectionDemux::Status::hasErrors() const
 {
     return
@@ -111,6 +141,10 @@ std::ostream& ts::SectionDemux::Status::display(std::ostream& strm, int indent,
     if (!errors_only || is_next != 0) {
         strm << margin << "Next sections (not yet applicable): " << UString::Decimal(is_next) << std::endl;
     }
+    if (!errors_only && (skip_unchanged || unchanged_sect != 0 || unchanged_table != 0)) {
+        strm << margin << "Skipped unchanged sections: " << UString::Decimal(unchanged_sect) << std::endl;
+        strm << margin << "Skipped unchanged tables: " << UString::Decimal(unchanged_table) << std::endl;
+    }
 
     return strm;
 }
@@ -125,7 +159,9 @@ ts::SectionDemux::ETIDContext::ETIDContext() :
     version(0),
     sect_expected(0),
     sect_received(0),
-    sects()
+    sects(),
+    sect_hashes(),
+    table_hashes()
 {
 }
 
@@ -165,15 +201,38 @@ void ts::SectionDemux::ETIDContext::notify(SectionDemux& demux, bool pack, bool
             EIT::Fix(table, EIT::ADD_MISSING);
         }
 
-        // Invoke the table handler.
+        // Invoke the table handler, unless the content is unchanged.
         if (table.isValid()) {
             notified = true;
-            demux._table_handler->handleTable(demux, table);
+            if (demux._skip_unchanged && !updateTableHashes(table)) {
+                demux._status.unchanged_table++;
+            }
+            else {
+                demux._table_handler->handleTable(demux, table);
+            }
         }
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Update the content hashes of the last notified table.
+//----------------------------------------------------------------------------
+
+bool ts::SectionDemux::ETIDContext::updateTableHashes(const BinaryTable& table)
+{
+    bool changed = table_hashes.size() != table.sectionCount();
+    table_hashes.resize(table.sectionCount());
+    for (size_t i = 0; i < table.sectionCount(); ++i) {
+        const SectionPtr sect(table.sectionAt(i));
+        const uint64_t hash = ContentHash(sect->content(), sect->size(), sect->isLongSection());
+        changed = changed || hash != table_hashes[i];
+        table_hashes[i] = hash;
+    }
+    return changed;
+}
+
+
 //----------------------------------------------------------------------------
 // Analysis context for one PID.
 //----------------------------------------------------------------------------
@@ -206,10 +265,29 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
     _pids(),
     _status(),
     _get_current(true),
-    _get_next(false)
+    _get_next(false),
+    _skip_unchanged(false)
 {
 }
 
+ts::SectionDemux::~SectionDemux()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get the context of a PID, create it if it does not exist.
+//----------------------------------------------------------------------------
+
+ts::SectionDemux::PIDContext& ts::SectionDemux::getPIDContext(PID pid)
+{
+    PIDContextPtr& pc(_pids[pid]);
+    if (pc.isNull()) {
+        pc = new PIDContext;
+    }
+    return *pc;
+}
+
 
 //----------------------------------------------------------------------------
 // Reset the analysis context (partially built sections and tables).
@@ -251,7 +329,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
     // Get PID and reference to the PID context.
     // The PID context is created if did not exist.
     const PID pid = pkt.getPID();
-    PIDContext& pc(_pids[pid]);
+    PIDContext& pc(getPIDContext(pid));
 
     // If TS packet is scrambled, we cannot decode it and we loose synchronization
     // on this PID (usually, PID's carrying sections are not scrambled).
@@ -463,6 +541,8 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             // Get reference to the ETID context for this PID.
             // The ETID context is created if did not exist.
             // Avoid accumulating partial sections when there is no table handler.
+            // There is at most one insertion in pc.tids for this section: the
+            // ETID context is accessed once, either here or for the section hashes.
 
             ETIDContext* tc = _table_handler == nullptr ? nullptr : &pc.tids[etid];
 
@@ -487,11 +567,29 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
                 }
             }
 
+            // When unchanged sections are skipped, compare the raw section data with the last section
+            // which was passed to the section handler, before creating a Section and checking its CRC32.
+            bool call_handler = section_ok && _section_handler != nullptr;
+            ETIDContext* hc = nullptr;
+            uint64_t hash = 0;
+
+            if (call_handler && _skip_unchanged) {
+                hc = tc != nullptr ? tc : &pc.tids[etid];
+                if (hc->sect_hashes.size() <= section_number) {
+                    hc->sect_hashes.resize(size_t(section_number) + 1, 0);
+                }
+                hash = ContentHash(ts_start, section_length, long_header);
+                if (hash == hc->sect_hashes[section_number]) {
+                    _status.unchanged_sect++;
+                    call_handler = false;
+                }
+            }
+
             // Create a new Section object if necessary (ie. if a section
-            // hendler is registered or if this is a new section).
+            // hendler must be invoked or if this is a new section).
             SectionPtr sect_ptr;
 
-            if (section_ok && (_section_handler != nullptr || (tc != nullptr && tc->sects[section_number].isNull()))) {
+            if (section_ok && (call_handler || (tc != nullptr && tc->sects[section_number].isNull()))) {
                 sect_ptr = new Section(ts_start, section_length, pid, CRC32::CHECK);
                 sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
                 sect_ptr->setLastTSPacketIndex(_packet_count);
@@ -507,7 +605,10 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             beforeCallingHandler(pid);
             try {
                 // If a handler is defined for sections, invoke it.
-                if (section_ok && _section_handler != nullptr) {
+                if (section_ok && call_handler) {
+                    if (hc != nullptr) {
+                        hc->sect_hashes[section_number] = hash;
+                    }
                     _section_handler->handleSection(*this, *sect_ptr);
                 }
 
@@ -560,20 +661,26 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
 
 void ts::SectionDemux::fixAndFlush(bool pack, bool fill_eit)
 {
+    std::vector<ETID> etids;
+
     // Loop on all PID's.
-    for (auto it1 = _pids.begin(); it1 != _pids.end(); ++it1) {
-        const PID pid = it1->first;
-        PIDContext& pc(it1->second);
+    for (auto pit = _pids.begin(); pit != _pids.end(); ++pit) {
+        const PID pid = pit->first;
 
         // Mark that we are in the context of a table or section handler.
         // This is used to prevent the destruction of PID contexts during
         // the execution of a handler.
         beforeCallingHandler(pid);
         try {
-            // Loop on all TID's currently found in the PID.
-            for (auto it2 = pc.tids.begin(); it2 != pc.tids.end(); ++it2) {
+            // Loop on all TID's currently found in the PID, in ETID order.
+            ETIDTable<ETIDContext>& tids(pit->second->tids);
+            tids.getSortedKeys(etids);
+            for (auto it = etids.begin(); it != etids.end(); ++it) {
                 // Force a notification of the partial table, if any.
-                it2->second.notify(*this, pack, fill_eit);
+                ETIDContext* tc = tids.find(*it);
+                if (tc != nullptr) {
+                    tc->notify(*this, pack, fill_eit);
+                }
             }
         }
         catch (...) {
@@ -36,7 +36,9 @@
 #include "tsAbstractDemux.h"
 #include "tsTableHandlerInterface.h"
 #include "tsSectionHandlerInterface.h"
-#include "tsETID.h"
+#include "tsETIDTable.h"
+#include "tsPIDTable.h"
+#include "tsPooledByteBlock.h"
 
 namespace ts {
     //!
@@ -69,6 +71,11 @@ namespace ts {
                               SectionHandlerInterface* section_handler = nullptr,
                               const PIDSet& pid_filter = NoPID);
 
+        //!
+        //! Destructor.
+        //!
+        virtual ~SectionDemux() override;
+
         // Inherited methods
         virtual void feedPacket(const TSPacket& pkt) override;
 
@@ -135,6 +142,27 @@ namespace ts {
             _get_next = next;
         }
 
+        //!
+        //! Skip sections and tables with unchanged content.
+        //!
+        //! When this option is set, the demux computes a 64-bit hash of the content of each section.
+        //! The table and section handlers are invoked only when the content has changed, ignoring the
+        //! version number and the CRC32. A section is compared with the last section with the same
+        //! table id, table id extension and section number in the same PID. A complete table is
+        //! compared with the last notified table with the same table id and table id extension.
+        //!
+        //! This means that new versions of a table where the sections have not actually changed are
+        //! not notified. Similarly, repeated short sections, which have no version, are notified only
+        //! when their content changes. Skipped sections are not parsed and their CRC32 is not checked
+        //! twice. The numbers of skipped sections and tables are available in the status.
+        //!
+        //! @param [in] skip If true, skip unchanged sections and tables. This is false by default.
+        //!
+        void setSkipUnchanged(bool skip)
+        {
+            _skip_unchanged = skip;
+        }
+
         //!
         //! Demux status information.
         //! It contains error counters.
@@ -149,6 +177,9 @@ namespace ts {
             uint64_t inv_sect_index;   //!< Number of invalid section index.
             uint64_t wrong_crc;        //!< Number of sections with wrong CRC32.
             uint64_t is_next;          //!< Number of sections with "next" flag (not yet applicable).
+            uint64_t unchanged_sect;   //!< Number of unchanged sections which were not passed to the section handler (not an error).
+            uint64_t unchanged_table;  //!< Number of unchanged tables which were not passed to the table handler (not an error).
+            bool     skip_unchanged;   //!< Unchanged sections and tables are skipped (see setSkipUnchanged()).
 
             //!
             //! Default constructor.
@@ -167,7 +198,7 @@ namespace ts {
             void reset();
 
             //!
-            //! Check if any counter is non zero.
+            //! Check if any error counter is non zero.
             //! @return True if any error counter is not zero.
             //!
             bool hasErrors() const;
@@ -189,6 +220,7 @@ namespace ts {
         void getStatus(Status& status) const
         {
             status = _status;
+            status.skip_unchanged = _skip_unchanged;
         }
 
         //!
@@ -217,6 +249,8 @@ namespace ts {
             size_t  sect_expected;  // Number of expected sections in table
             size_t  sect_received;  // Number of received sections in table
             SectionPtrVector sects; // Array of sections
+            std::vector<uint64_t> sect_hashes;   // Content hashes of last sections passed to section handler (skip unchanged)
+            std::vector<uint64_t> table_hashes;  // Content hashes of sections in last notified table (skip unchanged)
 
             // Default constructor.
             ETIDContext();
@@ -229,16 +263,19 @@ namespace ts {
             // If pack is true, build a packed version of the table and report it.
             // If fill_eit is true, add missing sections in EIT.
             void notify(SectionDemux& demux, bool pack, bool fill_eit);
+
+            // Update the content hashes of the last notified table. Return false if the content is unchanged.
+            bool updateTableHashes(const BinaryTable& table);
         };
 
         // This internal structure contains the analysis context for one PID.
         struct PIDContext
         {
-            PacketCounter pusi_pkt_index;     // Index of last packet with PUSI in this PID
-            uint8_t       continuity;         // Last continuity counter
-            bool          sync;               // We are synchronous in this PID
-            ByteBlock     ts;                 // TS payload buffer
-            std::map<ETID,ETIDContext> tids;  // TID analysis contexts
+            PacketCounter pusi_pkt_index;  // Index of last packet with PUSI in this PID
+            uint8_t       continuity;      // Last continuity counter
+            bool          sync;            // We are synchronous in this PID
+            PooledByteBlock ts;            // TS payload buffer
+            ETIDTable<ETIDContext> tids;   // TID analysis contexts, no reference shall be kept across an insertion.
 
             // Default constructor.
             PIDContext();
@@ -247,6 +284,11 @@ namespace ts {
             void syncLost();
         };
 
+        typedef SafePtr<PIDContext, NullMutex> PIDContextPtr;
+
+        // Get the context of a PID, create it if it does not exist.
+        PIDContext& getPIDContext(PID pid);
+
         // Notify the application if the table is complete.
         // Do not notify twice the same table.
         // If pack is true, build a packed version of the table and report it.
@@ -256,10 +298,11 @@ namespace ts {
         // Private members:
         TableHandlerInterface*   _table_handler;
         SectionHandlerInterface* _section_handler;
-        std::map<PID,PIDContext> _pids;
+        PIDTable<PIDContextPtr>  _pids;  // Indexed by PID, contexts are allocated on first use.
         Status                   _status;
         bool                     _get_current;
         bool                     _get_next;
+        bool                     _skip_unchanged;
     };
 }
 
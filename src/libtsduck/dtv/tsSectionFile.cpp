@@ -591,16 +591,42 @@ bool ts::SectionFile::LoadModel(xml::Document& doc, bool load_extensions)
 
 bool ts::SectionFile::loadXML(const UString& file_name)
 {
-    xml::Document doc(_report);
-    doc.setTweaks(_xmlTweaks);
-    return doc.load(file_name, false, true) && parseDocument(doc);
+    // Inline XML content is already in memory, parse it as a whole.
+    if (xml::Document::IsInlineXML(file_name)) {
+        return parseXML(file_name);
+    }
+    xml::StreamReader reader(_report);
+    return reader.open(file_name) && loadXML(reader);
 }
 
 bool ts::SectionFile::loadXML(std::istream& strm)
 {
+    xml::StreamReader reader(_report);
+    return reader.open(strm) && loadXML(reader);
+}
+
+bool ts::SectionFile::loadXML(xml::StreamReader& reader)
+{
+    // Load the XML model for TSDuck files, if not already done.
+    if (!loadThisModel()) {
+        return false;
+    }
+
+    // Check the root element once, not with each table.
+    const xml::Element* model_root = _model.rootElement();
+    if (model_root != nullptr && !model_root->name().similar(reader.rootName())) {
+        _report.error(u"invalid XML document, expected <%s> as root, found <%s>", {model_root->name(), reader.rootName()});
+        return false;
+    }
+
+    // Read, validate and convert tables one by one. Only one table is in memory in XML form.
+    bool success = true;
     xml::Document doc(_report);
     doc.setTweaks(_xmlTweaks);
-    return doc.load(strm) && parseDocument(doc);
+    while (reader.readElement(doc)) {
+        success = parseDocument(doc) && success;
+    }
+    return success && !reader.hasErrors();
 }
 
 bool ts::SectionFile::parseXML(const UString& xml_content)
@@ -667,37 +693,30 @@ ts::UString ts::SectionFile::toXML() const
 
 bool ts::SectionFile::loadJSON(const UString& file_name)
 {
-    json::ValuePtr root;
-    xml::Document doc(_report);
-    doc.setTweaks(_xmlTweaks);
-
-    return loadThisModel() &&
-           json::LoadFile(root, file_name, _report) &&
-           _model.convertToXML(*root, doc, true) &&
-           parseDocument(doc);
+    json::ArenaDocument root(_report);
+    return root.load(file_name) && parseJSON(root);
 }
 
 bool ts::SectionFile::loadJSON(std::istream& strm)
 {
-    json::ValuePtr root;
-    xml::Document doc(_report);
-    doc.setTweaks(_xmlTweaks);
-
-    return loadThisModel() &&
-           json::LoadStream(root, strm, _report) &&
-           _model.convertToXML(*root, doc, true) &&
-           parseDocument(doc);
+    json::ArenaDocument root(_report);
+    return root.load(strm) && parseJSON(root);
 }
 
 bool ts::SectionFile::parseJSON(const UString& json_content)
 {
-    json::ValuePtr root;
+    json::ArenaDocument root(_report);
+    return root.parse(json_content) && parseJSON(root);
+}
+
+bool ts::SectionFile::parseJSON(const json::ArenaDocument& root)
+{
+    // The JSON document is read-only and directly converted into XML, without intermediate JSON tree.
     xml::Document doc(_report);
     doc.setTweaks(_xmlTweaks);
 
     return loadThisModel() &&
-           json::Parse(root, json_content, _report) &&
-           _model.convertToXML(*root, doc, true) &&
+           _model.convertToXML(root.root(), doc, true) &&
            parseDocument(doc);
 }
 
@@ -35,7 +35,9 @@
 #pragma once
 #include "tsxmlJSONConverter.h"
 #include "tsxmlElement.h"
+#include "tsxmlStreamReader.h"
 #include "tsjson.h"
+#include "tsjsonArenaDocument.h"
 #include "tsSection.h"
 #include "tsBinaryTable.h"
 #include "tsUString.h"
@@ -517,6 +519,12 @@ namespace ts {
         // Parse an XML document.
         bool parseDocument(const xml::Document& doc);
 
+        // Load an XML file, one table at a time.
+        bool loadXML(xml::StreamReader& reader);
+
+        // Convert a parsed JSON document.
+        bool parseJSON(const json::ArenaDocument& root);
+
         // Generate an XML document.
         bool generateDocument(xml::Document& doc) const;
 
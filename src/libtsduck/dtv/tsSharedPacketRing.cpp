@@ -0,0 +1,690 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedPacketRing.h"
+#include "tsSysUtils.h"
+#include "tsIntegerUtils.h"
+#include "tsNullReport.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_UNIX)
+#include <sys/mman.h>
+#include <fcntl.h>
+#endif
+
+#if defined(TS_LINUX)
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+// The atomic counters in shared memory must be usable from several processes.
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "lock-free atomics are required");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futexes require plain 32-bit atomics");
+
+// Constants of the shared memory layout.
+namespace {
+    constexpr uint32_t RING_MAGIC = 0x54535052;    // "TSPR"
+    constexpr uint32_t RING_VERSION = 1;           // Increment when the layout changes.
+    constexpr size_t   RING_ALIGN = 64;            // Alignment of structures, the size of a cache line.
+    constexpr ts::MilliSecond RING_POLL = 100;     // Maximum sleep time before checking abort and peer processes.
+}
+
+
+//----------------------------------------------------------------------------
+// Header of the shared memory segment.
+// The segment is initially zero-filled by the system.
+//----------------------------------------------------------------------------
+
+struct ts::SharedPacketRing::Header
+{
+    // Description of a reader. A free slot has a zero pid.
+    struct Reader {
+        std::atomic<uint32_t> pid;                // Process id of the reader.
+        std::atomic<uint64_t> position;           // Index of the next packet to read.
+    };
+
+    uint32_t              magic;                  // RING_MAGIC.
+    uint32_t              version;                // RING_VERSION.
+    uint32_t              header_size;            // Size of this structure.
+    uint32_t              metadata_size;          // Size of TSPacketMetadata.
+    uint32_t              size;                   // Ring size in packets.
+    uint32_t              non_blocking;           // The writer does not wait for readers.
+    std::atomic<uint32_t> ready;                  // The header is initialized.
+    std::atomic<uint32_t> eof;                    // The writer has closed the ring.
+    std::atomic<uint32_t> writer_pid;             // Process id of the writer.
+    std::atomic<uint32_t> write_seq;              // Incremented when packets are written (futex).
+    std::atomic<uint32_t> read_seq;               // Incremented when packets are read (futex).
+    std::atomic<uint32_t> waiting_readers;        // Number of readers waiting on write_seq.
+    std::atomic<uint32_t> waiting_writer;         // The writer is waiting on read_seq.
+    std::atomic<uint64_t> bitrate;                // Bitrate of the stream, zero if unknown.
+    std::atomic<uint64_t> reserved;               // Number of packets written or being written.
+    std::atomic<uint64_t> written;                // Number of written packets.
+    Reader                readers[MAX_READERS];   // Description of the readers.
+};
+
+
+//----------------------------------------------------------------------------
+// Process synchronization on 32-bit values in the shared memory.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Wait until the value changes from the specified one, with a timeout.
+    void WaitValue(std::atomic<uint32_t>& addr, uint32_t value)
+    {
+#if defined(TS_LINUX)
+        ::timespec timeout;
+        timeout.tv_sec = RING_POLL / 1000;
+        timeout.tv_nsec = (RING_POLL % 1000) * 1000000;
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&addr), FUTEX_WAIT, value, &timeout, nullptr, 0);
+#else
+        // No portable inter-process futex, poll the value.
+        if (addr.load() == value) {
+            ts::SleepThread(1);
+        }
+#endif
+    }
+
+    // Wake up all processes which wait on a value.
+    void WakeUp(std::atomic<uint32_t>& addr)
+    {
+#if defined(TS_LINUX)
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&addr), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    // Check if a process still exists.
+    bool ProcessAlive(uint32_t pid)
+    {
+#if defined(TS_UNIX)
+        return pid != 0 && (::kill(pid_t(pid), 0) == 0 || errno == EPERM);
+#else
+        return false;
+#endif
+    }
+
+    // Process id of this process.
+    uint32_t CurrentPID()
+    {
+        return uint32_t(ts::CurrentProcessId());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::SharedPacketRing::SharedPacketRing() :
+    _name(),
+    _writer(false),
+    _aborted(false),
+    _size(0),
+    _map_size(0),
+    _header(nullptr),
+    _packets(nullptr),
+    _metadata(nullptr),
+    _reader_slot(0),
+    _position(0),
+    _lost(0)
+{
+}
+
+ts::SharedPacketRing::~SharedPacketRing()
+{
+    close(NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the mapped size of a ring of a given size.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedPacketRing::MapSize(size_t size)
+{
+    return RoundUp(sizeof(Header), RING_ALIGN) + RoundUp(size * PKT_SIZE, RING_ALIGN) + size * sizeof(TSPacketMetadata);
+}
+
+
+//----------------------------------------------------------------------------
+// Normalize the name of the shared memory segment.
+//----------------------------------------------------------------------------
+
+ts::UString ts::SharedPacketRing::SegmentName(const UString& name)
+{
+    return name.startWith(u"/") ? name : u"/" + name;
+}
+
+
+//----------------------------------------------------------------------------
+// Map / unmap the shared memory segment, locate the packets.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::map(int fd, size_t size, Report& report)
+{
+#if defined(TS_UNIX)
+    void* const addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        report.error(u"error mapping shared memory %s: %s", {_name, SysErrorCodeMessage()});
+        return false;
+    }
+    _map_size = size;
+    _header = reinterpret_cast<Header*>(addr);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ts::SharedPacketRing::locate()
+{
+    uint8_t* const base = reinterpret_cast<uint8_t*>(_header);
+    _packets = reinterpret_cast<TSPacket*>(base + RoundUp(sizeof(Header), RING_ALIGN));
+    _metadata = reinterpret_cast<TSPacketMetadata*>(base + RoundUp(sizeof(Header), RING_ALIGN) + RoundUp(_size * PKT_SIZE, RING_ALIGN));
+}
+
+void ts::SharedPacketRing::unmap()
+{
+#if defined(TS_UNIX)
+    if (_header != nullptr) {
+        ::munmap(_header, _map_size);
+    }
+#endif
+    _header = nullptr;
+    _packets = nullptr;
+    _metadata = nullptr;
+    _map_size = 0;
+    _size = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Create the shared memory ring, as writer.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::create(const UString& name, size_t size, bool non_blocking, Report& report, int mode)
+{
+    if (isOpen()) {
+        report.error(u"shared memory ring already open");
+        return false;
+    }
+
+#if defined(TS_UNIX)
+
+    _name = SegmentName(name);
+    _writer = true;
+    _aborted = false;
+    _size = std::max<size_t>(size, 1);
+    _position = 0;
+    _lost = 0;
+
+    const std::string uname(_name.toUTF8());
+    const size_t map_size = MapSize(_size);
+
+    // Create the segment. If it already exists, reuse it only if its writer is dead.
+    int fd = ::shm_open(uname.c_str(), O_CREAT | O_EXCL | O_RDWR, mode_t(mode));
+    if (fd < 0 && errno == EEXIST) {
+        const int old = ::shm_open(uname.c_str(), O_RDONLY, 0);
+        uint32_t old_pid = 0;
+        if (old >= 0) {
+            void* const addr = ::mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, old, 0);
+            if (addr != MAP_FAILED) {
+                old_pid = reinterpret_cast<Header*>(addr)->writer_pid.load();
+                ::munmap(addr, sizeof(Header));
+            }
+            ::close(old);
+        }
+        if (ProcessAlive(old_pid)) {
+            report.error(u"shared memory %s already used by process %d", {_name, old_pid});
+            return false;
+        }
+        report.verbose(u"replacing stale shared memory %s", {_name});
+        ::shm_unlink(uname.c_str());
+        fd = ::shm_open(uname.c_str(), O_CREAT | O_EXCL | O_RDWR, mode_t(mode));
+    }
+    if (fd < 0) {
+        report.error(u"error creating shared memory %s: %s", {_name, SysErrorCodeMessage()});
+        return false;
+    }
+
+    // Set the size of the segment and map it. The segment is zero-filled.
+    bool ok = ::ftruncate(fd, off_t(map_size)) == 0;
+    if (!ok) {
+        report.error(u"error resizing shared memory %s: %s", {_name, SysErrorCodeMessage()});
+    }
+    else {
+        ok = map(fd, map_size, report);
+    }
+    ::close(fd);
+    if (!ok) {
+        ::shm_unlink(uname.c_str());
+        unmap();
+        return false;
+    }
+
+    // Initialize the header. The readers wait for the ready flag.
+    _header->magic = RING_MAGIC;
+    _header->version = RING_VERSION;
+    _header->header_size = uint32_t(sizeof(Header));
+    _header->metadata_size = uint32_t(sizeof(TSPacketMetadata));
+    _header->size = uint32_t(_size);
+    _header->non_blocking = non_blocking;
+    _header->writer_pid = CurrentPID();
+    locate();
+    _header->ready.store(1, std::memory_order_release);
+
+    report.debug(u"created shared memory %s, %'d packets, %'d bytes", {_name, _size, _map_size});
+    return true;
+
+#else
+    report.error(u"shared memory rings are not implemented on this system");
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Open an existing shared memory ring, as reader.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::open(const UString& name, bool wait_writer, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory ring already open");
+        return false;
+    }
+
+#if defined(TS_UNIX)
+
+    _name = SegmentName(name);
+    _writer = false;
+    _aborted = false;
+    _position = 0;
+    _lost = 0;
+
+    const std::string uname(_name.toUTF8());
+
+    // Wait for the segment to be created and initialized by the writer.
+    for (;;) {
+        const int fd = ::shm_open(uname.c_str(), O_RDWR, 0);
+        if (fd < 0 && (errno != ENOENT || !wait_writer)) {
+            report.error(u"error opening shared memory %s: %s", {_name, SysErrorCodeMessage()});
+            return false;
+        }
+        if (fd >= 0) {
+            // Check that the segment is large enough to get the header.
+            struct ::stat st;
+            const bool ok = ::fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(Header) && map(fd, size_t(st.st_size), report);
+            ::close(fd);
+            if (ok) {
+                if (_header->ready.load(std::memory_order_acquire) != 0) {
+                    break;
+                }
+                unmap();
+            }
+        }
+        if (!wait_writer) {
+            report.error(u"shared memory %s is not initialized", {_name});
+            return false;
+        }
+        if (_aborted) {
+            return false;
+        }
+        SleepThread(RING_POLL);
+    }
+
+    // Check the compatibility of the layout.
+    if (_header->magic != RING_MAGIC ||
+        _header->version != RING_VERSION ||
+        _header->header_size != sizeof(Header) ||
+        _header->metadata_size != sizeof(TSPacketMetadata) ||
+        _header->size == 0 ||
+        MapSize(_header->size) != _map_size)
+    {
+        report.error(u"shared memory %s is not a compatible TS packet ring", {_name});
+        unmap();
+        return false;
+    }
+
+    // Now compute the actual packet addresses.
+    _size = _header->size;
+    locate();
+
+    // Allocate a reader slot. Free slots have a zero pid. Slots of dead readers are reused.
+    const uint32_t pid = CurrentPID();
+    bool found = false;
+    for (size_t i = 0; !found && i < MAX_READERS; ++i) {
+        uint32_t old = _header->readers[i].pid.load();
+        if ((old == 0 || !ProcessAlive(old)) && _header->readers[i].pid.compare_exchange_strong(old, pid)) {
+            found = true;
+            _reader_slot = i;
+        }
+    }
+    if (!found) {
+        report.error(u"too many readers on shared memory %s, max: %d", {_name, MAX_READERS});
+        unmap();
+        return false;
+    }
+
+    // Start reading at the current position of the writer.
+    _position = _header->written.load(std::memory_order_acquire);
+    _header->readers[_reader_slot].position.store(_position);
+    _header->read_seq.fetch_add(1);
+    WakeUp(_header->read_seq);
+
+    report.debug(u"opened shared memory %s, %'d packets, reader slot %d", {_name, _size, _reader_slot});
+    return true;
+
+#else
+    report.error(u"shared memory rings are not implemented on this system");
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Close the shared memory ring.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::close(Report& report)
+{
+    if (!isOpen()) {
+        return true;
+    }
+
+    bool ok = true;
+    if (_writer) {
+        // Signal the end of stream to all readers and remove the name.
+        _header->eof.store(1);
+        _header->write_seq.fetch_add(1);
+        WakeUp(_header->write_seq);
+#if defined(TS_UNIX)
+        if (::shm_unlink(_name.toUTF8().c_str()) < 0) {
+            report.error(u"error deleting shared memory %s: %s", {_name, SysErrorCodeMessage()});
+            ok = false;
+        }
+#endif
+    }
+    else {
+        // Release the reader slot and wake up the writer if it waits for us.
+        _header->readers[_reader_slot].pid.store(0);
+        _header->read_seq.fetch_add(1);
+        WakeUp(_header->read_seq);
+        if (_lost > 0) {
+            report.verbose(u"lost %'d packets from shared memory %s", {_lost, _name});
+        }
+    }
+
+    unmap();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Abort any pending or future operation.
+//----------------------------------------------------------------------------
+
+void ts::SharedPacketRing::abort()
+{
+    _aborted = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Bitrate of the stream.
+//----------------------------------------------------------------------------
+
+void ts::SharedPacketRing::setBitrate(BitRate bitrate)
+{
+    if (_header != nullptr) {
+        _header->bitrate.store(bitrate, std::memory_order_relaxed);
+    }
+}
+
+ts::BitRate ts::SharedPacketRing::bitrate() const
+{
+    return _header == nullptr ? 0 : BitRate(_header->bitrate.load(std::memory_order_relaxed));
+}
+
+
+//----------------------------------------------------------------------------
+// Readers which are attached to the ring.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedPacketRing::readersCount() const
+{
+    size_t count = 0;
+    if (_header != nullptr) {
+        for (size_t i = 0; i < MAX_READERS; ++i) {
+            const uint32_t pid = _header->readers[i].pid.load();
+            if (pid != 0 && ProcessAlive(pid)) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+bool ts::SharedPacketRing::waitReaders(size_t count, const AbortInterface* abort, Report& report)
+{
+    if (!isOpen() || !_writer) {
+        report.error(u"shared memory ring not open for writing");
+        return false;
+    }
+    while (readersCount() < count) {
+        if (_aborted || (abort != nullptr && abort->aborting())) {
+            return false;
+        }
+        SleepThread(RING_POLL);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Number of free slots in the ring for the writer.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedPacketRing::freeSlots()
+{
+    if (_header->non_blocking) {
+        return _size;
+    }
+
+    // The free space is limited by the slowest active reader.
+    uint64_t slowest = _position;
+    for (size_t i = 0; i < MAX_READERS; ++i) {
+        Header::Reader& reader(_header->readers[i]);
+        uint32_t pid = reader.pid.load();
+        if (pid != 0) {
+            const uint64_t pos = reader.position.load(std::memory_order_acquire);
+            if (pos < slowest && _position - pos >= _size && !ProcessAlive(pid)) {
+                // The slowest reader blocks the ring but has died, release its slot.
+                reader.pid.compare_exchange_strong(pid, 0);
+            }
+            else {
+                slowest = std::min(slowest, pos);
+            }
+        }
+    }
+    return _size - size_t(std::min<uint64_t>(_size, _position - slowest));
+}
+
+
+//----------------------------------------------------------------------------
+// Write packets in the ring.
+//----------------------------------------------------------------------------
+
+bool ts::SharedPacketRing::write(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t count, const AbortInterface* abort, Report& report)
+{
+    if (!isOpen() || !_writer) {
+        report.error(u"shared memory ring not open for writing");
+        return false;
+    }
+
+    while (count > 0) {
+
+        // Wait for free slots in the ring.
+        size_t free = freeSlots();
+        if (free == 0) {
+            // Declare that we wait before checking again. Either a reader sees us waiting
+            // and wakes us up, or we see its new position here.
+            _header->waiting_writer.store(1);
+            const uint32_t seq = _header->read_seq.load();
+            free = freeSlots();
+            if (free == 0) {
+                WaitValue(_header->read_seq, seq);
+            }
+            _header->waiting_writer.store(0);
+            if (_aborted || (abort != nullptr && abort->aborting())) {
+                return false;
+            }
+            continue;
+        }
+
+        // Copy the packets and metadata in at most two contiguous parts of the ring.
+        // Publish the reserved range first, to let non-blocking readers detect overwritten packets.
+        const size_t n = std::min(count, free);
+        _header->reserved.store(_position + n);
+        // Like in a seqlock, the writes of the packets shall not be reordered before the reservation.
+        // This fence pairs with the acquire fence of the readers, after their copy of the packets.
+        std::atomic_thread_fence(std::memory_order_release);
+        const size_t index = size_t(_position % _size);
+        const size_t first = std::min(n, _size - index);
+        TSPacket::Copy(_packets + index, buffer, first);
+        TSPacket::Copy(_packets, buffer + first, n - first);
+        if (pkt_data != nullptr) {
+            TSPacketMetadata::Copy(_metadata + index, pkt_data, first);
+            TSPacketMetadata::Copy(_metadata, pkt_data + first, n - first);
+            pkt_data += n;
+        }
+        else {
+            TSPacketMetadata::Reset(_metadata + index, first);
+            TSPacketMetadata::Reset(_metadata, n - first);
+        }
+        buffer += n;
+        count -= n;
+        _position += n;
+
+        // Publish the packets and wake up the readers which are waiting.
+        _header->written.store(_position, std::memory_order_release);
+        _header->write_seq.fetch_add(1);
+        if (_header->waiting_readers.load() != 0) {
+            WakeUp(_header->write_seq);
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read packets from the ring.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedPacketRing::read(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets, Report& report)
+{
+    if (!isOpen() || _writer) {
+        report.error(u"shared memory ring not open for reading");
+        return 0;
+    }
+
+    while (max_packets > 0 && !_aborted) {
+
+        const uint64_t written = _header->written.load(std::memory_order_acquire);
+
+        // A slow reader in non-blocking mode may have been overtaken by the writer.
+        if (written - _position > _size) {
+            _lost += written - _size - _position;
+            _position = written - _size;
+        }
+
+        if (written > _position) {
+            // Copy the packets and metadata in at most two contiguous parts of the ring.
+            size_t n = size_t(std::min<uint64_t>(max_packets, written - _position));
+            const size_t index = size_t(_position % _size);
+            const size_t first = std::min(n, _size - index);
+            TSPacket::Copy(buffer, _packets + index, first);
+            TSPacket::Copy(buffer + first, _packets, n - first);
+            if (pkt_data != nullptr) {
+                TSPacketMetadata::Copy(pkt_data, _metadata + index, first);
+                TSPacketMetadata::Copy(pkt_data + first, _metadata, n - first);
+            }
+
+            // Drop the first packets if the writer has started to overwrite them during the copy.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const uint64_t reserved = _header->reserved.load();
+            if (reserved > _position + _size) {
+                const size_t overwritten = size_t(std::min<uint64_t>(n, reserved - _size - _position));
+                for (size_t i = overwritten; i < n; ++i) {
+                    buffer[i - overwritten] = buffer[i];
+                    if (pkt_data != nullptr) {
+                        pkt_data[i - overwritten] = pkt_data[i];
+                    }
+                }
+                _lost += overwritten;
+                _position += overwritten;
+                n -= overwritten;
+            }
+
+            // Release the slots and wake up the writer if it waits for them.
+            _position += n;
+            _header->readers[_reader_slot].position.store(_position, std::memory_order_release);
+            if (!_header->non_blocking) {
+                _header->read_seq.fetch_add(1);
+                if (_header->waiting_writer.load() != 0) {
+                    WakeUp(_header->read_seq);
+                }
+            }
+            if (n > 0) {
+                return n;
+            }
+            continue;
+        }
+
+        // No packet available, check end of stream.
+        if (_header->eof.load() != 0) {
+            break;
+        }
+
+        // Wait for new packets. Declare that we wait before checking again. Either the
+        // writer sees us waiting and wakes us up, or we see its new packets here.
+        _header->waiting_readers.fetch_add(1);
+        const uint32_t seq = _header->write_seq.load();
+        if (_header->written.load() == written && _header->eof.load() == 0) {
+            WaitValue(_header->write_seq, seq);
+        }
+        _header->waiting_readers.fetch_sub(1);
+
+        // Check that the writer is still there after a timeout.
+        if (_header->written.load() == written && _header->eof.load() == 0 && !ProcessAlive(_header->writer_pid.load())) {
+            report.error(u"writer process of shared memory %s has terminated", {_name});
+            break;
+        }
+    }
+    return 0;
+}
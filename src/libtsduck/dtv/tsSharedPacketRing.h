@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Ring of TS packets in a named shared memory segment.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+#include "tsReport.h"
+#include "tsAbortInterface.h"
+#include <atomic>
+
+namespace ts {
+    //!
+    //! Ring of TS packets in a named shared memory segment, for inter-process transport.
+    //! @ingroup mpeg
+    //!
+    //! One writer process creates the ring. Up to MAX_READERS reader processes open the
+    //! ring using the same name. Each reader receives all packets which are written after
+    //! it opened the ring. Each slot in the ring contains a TS packet and its metadata.
+    //!
+    //! The packets are directly copied into and out of the shared memory, without system call.
+    //! The positions of the writer and the readers are atomic counters in the shared memory.
+    //! A process sleeps only when the ring is empty (reader) or full (writer). On Linux, it
+    //! sleeps on a futex in the shared memory, which is woken up by the other processes only
+    //! when some process is actually sleeping. On other UNIX systems, it polls the ring.
+    //!
+    //! By default, when the ring is full, the writer waits for the slowest reader. In
+    //! non-blocking mode, the writer never waits and a reader which is too slow loses
+    //! packets. The death of a process is detected and does not block the others.
+    //!
+    //! All processes must use the same version of TSDuck. Not implemented on Windows.
+    //!
+    class TSDUCKDLL SharedPacketRing
+    {
+        TS_NOCOPY(SharedPacketRing);
+    public:
+        //!
+        //! Default size in packets of the ring.
+        //!
+        static const size_t DEFAULT_SIZE = 16384;
+
+        //!
+        //! Maximum number of simultaneous readers.
+        //!
+        static const size_t MAX_READERS = 16;
+
+        //!
+        //! Default access mode of the shared memory segment (UNIX permissions).
+        //! Only the processes of the same user can open the ring.
+        //!
+        static const int DEFAULT_MODE = 0600;
+
+        //!
+        //! Default constructor.
+        //!
+        SharedPacketRing();
+
+        //!
+        //! Destructor.
+        //!
+        ~SharedPacketRing();
+
+        //!
+        //! Create the shared memory ring, as writer.
+        //! A previous ring with the same name is reused only when its writer process has terminated.
+        //! @param [in] name Name of the shared memory segment.
+        //! @param [in] size Size of the ring in packets.
+        //! @param [in] non_blocking If true, never wait for slow readers.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] mode Access mode of the shared memory segment (UNIX permissions).
+        //! The readers need read and write access to the segment. The permissions are
+        //! still restricted by the umask of the writer process.
+        //! @return True on success, false on error.
+        //!
+        bool create(const UString& name, size_t size, bool non_blocking, Report& report, int mode = DEFAULT_MODE);
+
+        //!
+        //! Open an existing shared memory ring, as reader.
+        //! @param [in] name Name of the shared memory segment.
+        //! @param [in] wait_writer If true and the ring does not exist, wait until it is created
+        //! by the writer or abort() is called. If false, fail when the ring does not exist.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& name, bool wait_writer, Report& report);
+
+        //!
+        //! Close the shared memory ring.
+        //! When the writer closes the ring, the readers get an end of stream after the last packet
+        //! and the name is removed. The shared memory disappears when the last reader closes it.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
+        //!
+        //! Check if the ring is open.
+        //! @return True if the ring is open.
+        //!
+        bool isOpen() const { return _header != nullptr; }
+
+        //!
+        //! Get the size of the ring in packets.
+        //! @return The size of the ring in packets, zero if not open.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Write packets in the ring (writer only).
+        //! In blocking mode, wait for the slowest reader when the ring is full.
+        //! @param [in] buffer Address of the packets to write.
+        //! @param [in] pkt_data Address of the packet metadata. Can be null.
+        //! @param [in] count Number of packets to write.
+        //! @param [in] abort If non-zero, invoked when waiting for readers to check if the application is aborting.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error or abort.
+        //!
+        bool write(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t count, const AbortInterface* abort, Report& report);
+
+        //!
+        //! Get the number of readers which are currently attached to the ring.
+        //! @return The number of live reader processes, zero if not open.
+        //!
+        size_t readersCount() const;
+
+        //!
+        //! Wait until some number of readers are attached to the ring (writer only).
+        //! @param [in] count Minimum number of readers to wait for.
+        //! @param [in] abort If non-zero, invoked while waiting to check if the application is aborting.
+        //! @param [in,out] report Where to report errors.
+        //! @return True when the readers are present, false on error or abort.
+        //!
+        bool waitReaders(size_t count, const AbortInterface* abort, Report& report);
+
+        //!
+        //! Publish the bitrate of the stream (writer only).
+        //! @param [in] bitrate Bitrate of the stream. Zero if unknown.
+        //!
+        void setBitrate(BitRate bitrate);
+
+        //!
+        //! Read packets from the ring (reader only).
+        //! Wait until at least one packet is available.
+        //! @param [out] buffer Address of the buffer for the packets.
+        //! @param [out] pkt_data Address of the buffer for the packet metadata. Can be null.
+        //! @param [in] max_packets Maximum number of packets to read.
+        //! @param [in,out] report Where to report errors.
+        //! @return The number of read packets. Zero at end of stream, on error or abort.
+        //!
+        size_t read(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets, Report& report);
+
+        //!
+        //! Get the bitrate of the stream, as published by the writer.
+        //! @return The bitrate of the stream or zero if unknown.
+        //!
+        BitRate bitrate() const;
+
+        //!
+        //! Get the number of lost packets (reader only).
+        //! Packets are lost by slow readers in non-blocking mode.
+        //! @return The number of packets which were overwritten before being read.
+        //!
+        PacketCounter lostPackets() const { return _lost; }
+
+        //!
+        //! Abort any pending or future operation.
+        //! Can be called from any thread.
+        //!
+        void abort();
+
+    private:
+        struct Header;
+
+        UString           _name;          // Name of the shared memory segment.
+        bool              _writer;        // This is the writer side.
+        std::atomic<bool> _aborted;       // Abort current operations.
+        size_t            _size;          // Ring size in packets.
+        size_t            _map_size;      // Mapped size in bytes.
+        Header*           _header;        // Shared memory header, null when not open.
+        TSPacket*         _packets;       // Packets in shared memory.
+        TSPacketMetadata* _metadata;      // Packet metadata in shared memory.
+        size_t            _reader_slot;   // Index of the reader in the header (reader only).
+        uint64_t          _position;      // Index of next packet to write or read.
+        PacketCounter     _lost;          // Lost packets (reader only).
+
+        // Map the shared memory segment. Return false on error.
+        bool map(int fd, size_t size, Report& report);
+
+        // Compute the addresses of the packets and metadata in the mapped segment.
+        void locate();
+
+        // Unmap the shared memory segment.
+        void unmap();
+
+        // Compute the mapped size of a ring of a given size.
+        static size_t MapSize(size_t size);
+
+        // Number of free slots in the ring for the writer.
+        size_t freeSlots();
+
+        // Normalize the name of the shared memory segment.
+        static UString SegmentName(const UString& name);
+    };
+}
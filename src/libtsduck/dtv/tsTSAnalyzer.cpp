@@ -188,6 +188,94 @@ void ts::TSAnalyzer::resetSectionDemux()
 }
 
 
+//----------------------------------------------------------------------------
+// Merge the analysis context of another analyzer into this one.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::merge(const TSAnalyzer& other)
+{
+    // Packet indexes in the other analyzer are shifted by our number of packets.
+    const uint64_t offset = _ts_pkt_cnt;
+
+    // Global counters.
+    _ts_pkt_cnt += other._ts_pkt_cnt;
+    _invalid_sync += other._invalid_sync;
+    _transport_errors += other._transport_errors;
+    _suspect_ignored += other._suspect_ignored;
+    _ts_bitrate_sum += other._ts_bitrate_sum;
+    _ts_bitrate_cnt += other._ts_bitrate_cnt;
+    _tid_present |= other._tid_present;
+
+    // Identification of the stream, from the latest part when defined.
+    if (other._ts_id_valid) {
+        _ts_id = other._ts_id;
+        _ts_id_valid = true;
+    }
+    if (!other._country_code.empty()) {
+        _country_code = other._country_code;
+    }
+
+    // Time stamps: first ones from the earliest part, last ones from the latest part.
+    if (other._first_utc != Time::Epoch && (_first_utc == Time::Epoch || other._first_utc < _first_utc)) {
+        _first_utc = other._first_utc;
+        _first_local = other._first_local;
+    }
+    if (_first_tdt == Time::Epoch) {
+        _first_tdt = other._first_tdt;
+    }
+    if (other._last_tdt != Time::Epoch) {
+        _last_tdt = other._last_tdt;
+    }
+    if (_first_tot == Time::Epoch) {
+        _first_tot = other._first_tot;
+    }
+    if (other._last_tot != Time::Epoch) {
+        _last_tot = other._last_tot;
+    }
+    if (_first_stt == Time::Epoch) {
+        _first_stt = other._first_stt;
+    }
+    if (other._last_stt != Time::Epoch) {
+        _last_stt = other._last_stt;
+    }
+
+    // Merge all services.
+    for (auto it = other._services.begin(); it != other._services.end(); ++it) {
+        getService(it->first)->merge(*it->second);
+    }
+
+    // Merge all PID's. Continue to demux the same PID's as the other analyzer.
+    for (auto it = other._pids.begin(); it != other._pids.end(); ++it) {
+        getPID(it->first)->merge(*it->second, offset);
+        if (other._demux.hasPID(it->first)) {
+            _demux.addPID(it->first);
+        }
+        if (other._t2mi_demux.hasPID(it->first)) {
+            _t2mi_demux.addPID(it->first);
+        }
+    }
+
+    // Recount the PID's which are incrementally counted during the analysis.
+    _scrambled_pid_cnt = 0;
+    _pcr_pid_cnt = 0;
+    for (auto it = _pids.begin(); it != _pids.end(); ++it) {
+        if (it->second->scrambled) {
+            _scrambled_pid_cnt++;
+        }
+        if (it->second->pcr_cnt > 0) {
+            _pcr_pid_cnt++;
+        }
+    }
+
+    // The state of suspect packet detection comes from the latest part.
+    _preceding_errors = other._preceding_errors;
+    _preceding_suspects = other._preceding_suspects;
+
+    // Global statistics need to be recomputed.
+    _modified = true;
+}
+
+
 //----------------------------------------------------------------------------
 // Description of a few known PID's
 //----------------------------------------------------------------------------
@@ -318,6 +406,47 @@ ts::TSAnalyzer::ETIDContext::ETIDContext(const ETID& etid_) :
 }
 
 
+//----------------------------------------------------------------------------
+// Merge the description of the same table from another analyzer.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::ETIDContext::merge(const ETIDContext& other, uint64_t packet_offset)
+{
+    section_count += other.section_count;
+
+    if (other.table_count > 0) {
+        const uint64_t other_first = other.first_pkt + packet_offset;
+        if (table_count == 0) {
+            // First occurence of table is in the other part.
+            first_pkt = other_first;
+            first_version = other.first_version;
+            min_repetition_ts = other.min_repetition_ts;
+            max_repetition_ts = other.max_repetition_ts;
+        }
+        else if (other.table_count > 1) {
+            // The interval between the two parts is not a reliable repetition interval
+            // since the sections which overlap the boundary are lost. Only combine the
+            // intervals which were measured inside each part.
+            if (table_count > 1) {
+                min_repetition_ts = std::min(min_repetition_ts, other.min_repetition_ts);
+                max_repetition_ts = std::max(max_repetition_ts, other.max_repetition_ts);
+            }
+            else {
+                min_repetition_ts = other.min_repetition_ts;
+                max_repetition_ts = other.max_repetition_ts;
+            }
+        }
+        table_count += other.table_count;
+        last_pkt = other.last_pkt + packet_offset;
+        last_version = other.last_version;
+        versions |= other.versions;
+        if (table_count > 1) {
+            repetition_ts = (last_pkt - first_pkt + (table_count - 1) / 2) / (table_count - 1);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor for the Service context
 //----------------------------------------------------------------------------
@@ -372,6 +501,35 @@ ts::UString ts::TSAnalyzer::ServiceContext::getName() const
 }
 
 
+//----------------------------------------------------------------------------
+// Merge the description of the same service from another analyzer.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::ServiceContext::merge(const ServiceContext& other)
+{
+    if (other.orig_netw_id != 0) {
+        orig_netw_id = other.orig_netw_id;
+    }
+    if (other.service_type != 0) {
+        service_type = other.service_type;
+    }
+    if (!other.name.empty()) {
+        name = other.name;
+    }
+    if (!other.provider.empty()) {
+        provider = other.provider;
+    }
+    if (other.pmt_pid != 0) {
+        pmt_pid = other.pmt_pid;
+    }
+    if (other.pcr_pid != 0) {
+        pcr_pid = other.pcr_pid;
+    }
+    carry_ssu = carry_ssu || other.carry_ssu;
+    carry_t2mi = carry_t2mi || other.carry_t2mi;
+}
+
+
 //----------------------------------------------------------------------------
 // Return an ETID context. Allocate a new entry if ETID not found.
 //----------------------------------------------------------------------------
@@ -401,7 +559,7 @@ ts::TSAnalyzer::ETIDContextPtr ts::TSAnalyzer::getETID(const Section& section)
 
 bool ts::TSAnalyzer::pidExists(PID pid) const
 {
-    return Contains(_pids, pid);
+    return _pids.count(pid) != 0;
 }
 
 
@@ -411,18 +569,17 @@ bool ts::TSAnalyzer::pidExists(PID pid) const
 
 ts::TSAnalyzer::PIDContextPtr ts::TSAnalyzer::getPID(PID pid, const UString& description)
 {
-    const PIDContextPtr p(_pids[pid]);
-    if (p.isNull()) {
-        // The PID was not yet used, map entry just created.
-        return _pids[pid] = new PIDContext(pid, description);
+    assert(pid < PID_MAX);
+    PIDContextPtr& pc(_pids[pid]);
+    if (pc.isNull()) {
+        // The PID was not yet used, table entry just created.
+        pc = new PIDContext(pid, description);
     }
-    else {
+    else if (pc->description == UNREFERENCED && description != UNREFERENCED) {
         // If the PID was marked as unreferenced, now use actual description.
-        if (p->description == UNREFERENCED && description != UNREFERENCED) {
-            p->description = description;
-        }
-        return p;
+        pc->description = description;
     }
+    return pc;
 }
 
 
@@ -461,6 +618,106 @@ void ts::TSAnalyzer::PIDContext::addService(uint16_t service_id)
 }
 
 
+//----------------------------------------------------------------------------
+// Merge the description of the same PID from another analyzer.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::PIDContext::merge(const PIDContext& other, uint64_t packet_offset)
+{
+    // Descriptive properties, from the latest part when defined.
+    if (other.description != UNREFERENCED && !other.description.empty()) {
+        description = other.description;
+    }
+    if (!other.comment.empty()) {
+        comment = other.comment;
+    }
+    if (!other.language.empty()) {
+        language = other.language;
+    }
+    if (other.cas_id != 0) {
+        cas_id = other.cas_id;
+    }
+    for (auto it = other.attributes.begin(); it != other.attributes.end(); ++it) {
+        AppendUnique(attributes, *it);
+    }
+
+    // Sets and boolean properties.
+    services.insert(other.services.begin(), other.services.end());
+    cas_operators.insert(other.cas_operators.begin(), other.cas_operators.end());
+    ssu_oui.insert(other.ssu_oui.begin(), other.ssu_oui.end());
+    is_pmt_pid = is_pmt_pid || other.is_pmt_pid;
+    is_pcr_pid = is_pcr_pid || other.is_pcr_pid;
+    referenced = referenced || other.referenced;
+    optional = optional && other.optional;
+    carry_pes = carry_pes || other.carry_pes;
+    carry_section = carry_section || other.carry_section;
+    carry_ecm = carry_ecm || other.carry_ecm;
+    carry_emm = carry_emm || other.carry_emm;
+    carry_audio = carry_audio || other.carry_audio;
+    carry_video = carry_video || other.carry_video;
+    carry_t2mi = carry_t2mi || other.carry_t2mi;
+    scrambled = scrambled || other.scrambled;
+
+    // PES stream id, the same in the two parts or none in one part.
+    if (pes_stream_id == 0) {
+        pes_stream_id = other.pes_stream_id;
+        same_stream_id = other.same_stream_id;
+    }
+    else if (other.pes_stream_id != 0) {
+        same_stream_id = same_stream_id && other.same_stream_id && pes_stream_id == other.pes_stream_id;
+    }
+
+    // Counters.
+    ts_pkt_cnt += other.ts_pkt_cnt;
+    ts_af_cnt += other.ts_af_cnt;
+    unit_start_cnt += other.unit_start_cnt;
+    pl_start_cnt += other.pl_start_cnt;
+    pmt_cnt += other.pmt_cnt;
+    unexp_discont += other.unexp_discont;
+    exp_discont += other.exp_discont;
+    duplicated += other.duplicated;
+    ts_sc_cnt += other.ts_sc_cnt;
+    inv_ts_sc_cnt += other.inv_ts_sc_cnt;
+    inv_pes_start += other.inv_pes_start;
+    t2mi_cnt += other.t2mi_cnt;
+    pcr_cnt += other.pcr_cnt;
+    cryptop_cnt += other.cryptop_cnt;
+    cryptop_ts_cnt += other.cryptop_ts_cnt;
+    ts_bitrate_sum += other.ts_bitrate_sum;
+    ts_bitrate_cnt += other.ts_bitrate_cnt;
+    for (auto it = other.t2mi_plp_ts.begin(); it != other.t2mi_plp_ts.end(); ++it) {
+        t2mi_plp_ts[it->first] += it->second;
+    }
+
+    // Average crypto-period from the merged counters (the first crypto-period is ignored).
+    if (cryptop_cnt > 1) {
+        crypto_period = cryptop_ts_cnt / (cryptop_cnt - 1);
+    }
+    else if (crypto_period == 0) {
+        crypto_period = other.crypto_period;
+    }
+
+    // Tables in this PID.
+    for (auto it = other.sections.begin(); it != other.sections.end(); ++it) {
+        ETIDContextPtr& etc(sections[it->first]);
+        if (etc.isNull()) {
+            etc = new ETIDContext(it->first);
+            etc->first_version = it->second->first_version;
+        }
+        etc->merge(*it->second, packet_offset);
+    }
+
+    // The analysis state comes from the latest part.
+    if (other.ts_pkt_cnt > 0) {
+        cur_continuity = other.cur_continuity;
+        cur_ts_sc = other.cur_ts_sc;
+        cur_ts_sc_pkt = other.cur_ts_sc_pkt + packet_offset;
+        last_pcr = other.last_pcr;
+        last_pcr_pkt = other.last_pcr_pkt + packet_offset;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // This hook is invoked when a complete section is available.
 // Implementation of SectionHandlerInterface
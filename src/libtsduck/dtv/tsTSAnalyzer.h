@@ -50,6 +50,7 @@
 #include "tsTime.h"
 #include "tsUString.h"
 #include "tsSafePtr.h"
+#include "tsPIDTable.h"
 
 namespace ts {
     //!
@@ -91,6 +92,37 @@ namespace ts {
         //!
         void reset();
 
+        //!
+        //! Merge the analysis context of another analyzer into this one.
+        //!
+        //! This is typically used to analyze several parts of a stream in parallel, one analyzer
+        //! per part, and merge all analyzers in the end. The other analyzer is considered as
+        //! the analysis of the next part of the same stream, after the packets which were
+        //! passed to this object. The merge follows the following rules:
+        //!
+        //! - All counters are added: packets, errors, sections, PCR's, etc.
+        //! - Packet indexes in the other analyzer (table repetition) are shifted by the number
+        //!   of packets in this analyzer. The interval between the last table in this analyzer
+        //!   and the first one in the other analyzer is not used as a repetition interval.
+        //! - Sets are merged: services of a PID, table versions, CAS operators, etc.
+        //! - Boolean properties are merged using an "or": scrambled, carry audio, etc.
+        //! - Descriptive properties, which are normally updated during the analysis, are taken
+        //!   from the other analyzer when they are defined there: service name, PID description,
+        //!   language, etc. Otherwise, the current value is kept.
+        //! - The state of the continuity analysis, PCR analysis, etc. is taken from the other
+        //!   analyzer. A continuity error or a PCR interval across the boundary between the two
+        //!   parts is not detected. A table, a section or a PES packet which is split between
+        //!   the two parts is not analyzed.
+        //! - The global statistics are recomputed.
+        //!
+        //! After the merge, the analysis can continue with packets following the other part.
+        //! The two analyzers must use distinct instances of DuckContext if they run in
+        //! distinct threads.
+        //!
+        //! @param [in] other Another analyzer, containing the analysis of the next part of the stream.
+        //!
+        void merge(const TSAnalyzer& other);
+
         //!
         //! Specify a "bitrate hint" for the analysis.
         //! @param [in] bitrate_hint Optional bitrate "hint" for the analysis.
@@ -211,6 +243,15 @@ namespace ts {
             //! @return A displayable provider name.
             //!
             UString getProvider() const;
+
+            //!
+            //! Merge the description of the same service from another analyzer.
+            //! Descriptive properties are updated when defined in the other service.
+            //! The statistics are left unmodified, they are recomputed by the analyzer.
+            //! @param [in] other The same service in another analyzer.
+            //! @see TSAnalyzer::merge()
+            //!
+            void merge(const ServiceContext& other);
         };
 
         //!
@@ -269,6 +310,14 @@ namespace ts {
             //! @param [in] etid Extended table id.
             //!
             ETIDContext(const ETID& etid);
+
+            //!
+            //! Merge the description of the same table from another analyzer.
+            //! @param [in] other The same table in another analyzer.
+            //! @param [in] packet_offset Offset of the packet indexes in the other analyzer.
+            //! @see TSAnalyzer::merge()
+            //!
+            void merge(const ETIDContext& other, uint64_t packet_offset);
         };
 
         //!
@@ -378,6 +427,17 @@ namespace ts {
             //!
             UString fullDescription(bool include_attributes) const;
 
+            //!
+            //! Merge the description of the same PID from another analyzer.
+            //! The PID is optional only when it is optional in the two analyzers. The average
+            //! crypto-period is computed from the merged counters. The bitrates are left unmodified,
+            //! they are recomputed by the analyzer.
+            //! @param [in] other The same PID in another analyzer.
+            //! @param [in] packet_offset Offset of the packet indexes in the other analyzer.
+            //! @see TSAnalyzer::merge()
+            //!
+            void merge(const PIDContext& other, uint64_t packet_offset);
+
         private:
             // Description of a few known PID's
             struct KnownPID
@@ -397,9 +457,9 @@ namespace ts {
         typedef SafePtr<PIDContext, NullMutex> PIDContextPtr;
 
         //!
-        //! Map of PIDContext, indexed by PID.
+        //! Dense table of PIDContext, indexed by PID, iterated in increasing order of PID.
         //!
-        typedef std::map<PID, PIDContextPtr> PIDContextMap;
+        typedef PIDTable<PIDContextPtr> PIDContextMap;
 
         //!
         //! Check if a PID context exists.
@@ -471,7 +531,7 @@ namespace ts {
         UString      _country_code;       //!< TOT country code.
         uint16_t     _scrambled_services_cnt; //!< Number of scrambled services;.
         std::bitset<TID_MAX> _tid_present;    //!< Array of detected tables.
-        PIDContextMap        _pids;           //!< Description of PIDs.
+        PIDContextMap        _pids;           //!< Description of PIDs, ordered by PID value.
         ServiceContextMap    _services;       //!< Description of services, map key: service id..
 
     private:
@@ -522,15 +582,15 @@ namespace ts {
         virtual void handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, const TSPacket& ts) override;
 
         // TSAnalyzer private members (state data, used during analysis):
-        bool              _modified;                  // Internal data modified, need recomputeStatistics
-        uint64_t          _ts_bitrate_sum;            // Sum of all computed TS bitrates
-        uint64_t          _ts_bitrate_cnt;            // Number of computed TS bitrates
-        uint64_t          _preceding_errors;          // Number of contiguous invalid packets before current packet
-        uint64_t          _preceding_suspects;        // Number of contiguous suspects packets before current packet
-        uint64_t          _min_error_before_suspect;  // Required number of invalid packets before starting suspect
-        uint64_t          _max_consecutive_suspects;  // Max number of consecutive suspect packets before clearing suspect
-        SectionDemux      _demux;                     // PSI tables analysis
-        PESDemux          _pes_demux;                 // Audio/video analysis
-        T2MIDemux         _t2mi_demux;                // T2-MI analysis
+        bool                        _modified;                  // Internal data modified, need recomputeStatistics
+        uint64_t                    _ts_bitrate_sum;            // Sum of all computed TS bitrates
+        uint64_t                    _ts_bitrate_cnt;            // Number of computed TS bitrates
+        uint64_t                    _preceding_errors;          // Number of contiguous invalid packets before current packet
+        uint64_t                    _preceding_suspects;        // Number of contiguous suspects packets before current packet
+        uint64_t                    _min_error_before_suspect;  // Required number of invalid packets before starting suspect
+        uint64_t                    _max_consecutive_suspects;  // Max number of consecutive suspect packets before clearing suspect
+        SectionDemux                _demux;                     // PSI tables analysis
+        PESDemux                    _pes_demux;                 // Audio/video analysis
+        T2MIDemux                   _t2mi_demux;                // T2-MI analysis
     };
 }
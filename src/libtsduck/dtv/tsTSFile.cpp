@@ -31,8 +31,12 @@
 #include "tsTSPacketMetadata.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
+#include "tsSysInfo.h"
 TSDUCK_SOURCE;
 
+// Size of chunks of already read data to release in a memory-mapped file.
+#define MAP_RELEASE_CHUNK (64 * 1024 * 1024)
+
 
 //----------------------------------------------------------------------------
 // Default constructor.
@@ -55,6 +59,13 @@ ts::TSFile::TSFile() :
     _aborted(false),
     _rewindable(false),
     _regular(false),
+    _direct(false),
+    _map_request(false),
+    _map_base(nullptr),
+    _map_size(0),
+    _map_pos(0),
+    _map_released(0),
+    _copy_buffer(),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -85,6 +96,13 @@ ts::TSFile::TSFile(const TSFile& other) :
     _aborted(false),
     _rewindable(false),
     _regular(false),
+    _direct(false),
+    _map_request(other._map_request),
+    _map_base(nullptr),
+    _map_size(0),
+    _map_pos(0),
+    _map_released(0),
+    _copy_buffer(),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -115,6 +133,13 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
     _aborted(other._aborted),
     _rewindable(other._rewindable),
     _regular(other._regular),
+    _direct(other._direct),
+    _map_request(other._map_request),
+    _map_base(other._map_base),
+    _map_size(other._map_size),
+    _map_pos(other._map_pos),
+    _map_released(other._map_released),
+    _copy_buffer(std::move(other._copy_buffer)),
 #if defined(TS_WINDOWS)
     _handle(other._handle)
 #else
@@ -123,6 +148,7 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
 {
     // Mark other object as closed, just in case.
     other._is_open = false;
+    other._map_base = nullptr;
 #if defined(TS_WINDOWS)
     other._handle = INVALID_HANDLE_VALUE;
 #else
@@ -374,6 +400,7 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
 
     // Close first if this is a reopen.
     if (reopen) {
+        unmapFile();
         ::close(_fd);
         _fd = -1;
     }
@@ -393,6 +420,11 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
     if (write_access && keep_file) {
         uflags |= O_EXCL;
     }
+#if defined(TS_LINUX)
+    if (write_access && (_flags & DIRECT) != 0) {
+        uflags |= O_DIRECT;
+    }
+#endif
 
     if (_filename.empty()) {
         // File name is empty means standard input or output. No need to open.
@@ -400,7 +432,16 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
     }
     else {
         // Open a named file.
-        if ((_fd = ::open(_filename.toUTF8().c_str(), uflags, mode)) < 0) {
+        _fd = ::open(_filename.toUTF8().c_str(), uflags, mode);
+#if defined(TS_LINUX)
+        if (_fd < 0 && (uflags & O_DIRECT) != 0 && LastSysErrorCode() == EINVAL) {
+            // Direct I/O not supported by the file system, use standard I/O.
+            report.debug(u"direct I/O not supported on %s", {getDisplayFileName()});
+            uflags &= ~O_DIRECT;
+            _fd = ::open(_filename.toUTF8().c_str(), uflags, mode);
+        }
+#endif
+        if (_fd < 0) {
             const SysErrorCode err = LastSysErrorCode();
             report.log(_severity, u"cannot open file %s: %s", {getDisplayFileName(), SysErrorCodeMessage(err)});
             return false;
@@ -449,6 +490,28 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
         return false;
     }
 
+    // Check if direct I/O is actually used.
+    _direct = false;
+    if (write_access && (_flags & DIRECT) != 0 && _regular) {
+#if defined(TS_LINUX)
+        const int fdflags = ::fcntl(_fd, F_GETFL);
+        _direct = fdflags != -1 && (fdflags & O_DIRECT) != 0;
+#elif defined(TS_MAC)
+        _direct = ::fcntl(_fd, F_NOCACHE, 1) != -1;
+#endif
+        // When appending, the end of the existing file may not be aligned.
+        const off_t pos = ::lseek(_fd, 0, SEEK_CUR);
+        if (_direct && (pos == off_t(-1) || pos % off_t(DIRECT_IO_ALIGNMENT) != 0)) {
+            disableDirectIO(report);
+        }
+        report.debug(u"direct I/O %s on %s", {_direct ? u"enabled" : u"disabled", getDisplayFileName()});
+    }
+
+    // Optionally read regular files through a memory mapping.
+    if (_map_request && read_only && _regular) {
+        mapFile(report);
+    }
+
 #endif
 
     // Reset counters only if not a reopen.
@@ -508,6 +571,13 @@ bool ts::TSFile::seekInternal(uint64_t index, Report& report)
 
     report.debug(u"seeking %s at offset %'d", {_filename, _start_offset + index});
 
+    // In a memory-mapped file, simply move the read position.
+    if (_map_base != nullptr) {
+        _map_pos = _start_offset + index;
+        _at_eof = false;
+        return true;
+    }
+
 #if defined(TS_WINDOWS)
     // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
     uint64_t where = _start_offset + index;
@@ -563,6 +633,8 @@ bool ts::TSFile::close(Report& report)
         writeStuffing(_close_null, report);
     }
 
+    unmapFile();
+
     if (!_filename.empty()) {
 #if defined(TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -571,7 +643,7 @@ bool ts::TSFile::close(Report& report)
 #endif
     }
 
-    _is_open = _at_eof = _aborted = false;
+    _is_open = _at_eof = _aborted = _direct = false;
     _flags = NONE;
     _filename.clear();
 
@@ -605,6 +677,19 @@ bool ts::TSFile::readStreamPartial(void* buffer, size_t request_size, size_t& re
         return true;
     }
 
+    // Memory-mapped file: copy from the mapping.
+    if (_map_base != nullptr) {
+        if (_map_pos >= _map_size) {
+            _at_eof = true;
+            return false;
+        }
+        releaseMapped();
+        read_size = size_t(std::min<uint64_t>(request_size, _map_size - _map_pos));
+        ::memcpy(buffer, _map_base + _map_pos, read_size);
+        _map_pos += read_size;
+        return true;
+    }
+
 #if defined(TS_WINDOWS)
 
     // Windows implementation
@@ -718,6 +803,127 @@ size_t ts::TSFile::readPackets(TSPacket* buffer, TSPacketMetadata* metadata, siz
 }
 
 
+//----------------------------------------------------------------------------
+// Read TS packets without copy when possible.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFile::readPacketsInPlace(const TSPacket*& packets, TSPacketMetadata* metadata, size_t max_packets, Report& report)
+{
+    packets = nullptr;
+
+    // Zero copy is possible only on memory-mapped plain TS files, outside artificial stuffing.
+    if (_map_base != nullptr && packetFormat() == TSPacketFormat::TS && _open_null_read == 0 && !_at_eof && !_aborted && max_packets > 0) {
+
+        // Number of complete packets after the current position. Truncate incomplete packets at end of file.
+        size_t count = _map_pos >= _map_size ? 0 : size_t(std::min<uint64_t>(max_packets, (_map_size - _map_pos) / PKT_SIZE));
+
+        // At end of file, rewind if the file must be repeated.
+        if (count == 0 && (_repeat == 0 || ++_counter < _repeat) && seekInternal(0, report) && _map_pos < _map_size) {
+            count = size_t(std::min<uint64_t>(max_packets, (_map_size - _map_pos) / PKT_SIZE));
+        }
+
+        if (count > 0) {
+            // Previously returned packets are no longer used, release them.
+            releaseMapped();
+            packets = reinterpret_cast<const TSPacket*>(_map_base + _map_pos);
+            _map_pos += count * PKT_SIZE;
+            _total_read += count;
+            if (metadata != nullptr) {
+                TSPacketMetadata::Reset(metadata, count);
+            }
+            return count;
+        }
+
+        // End of file, may still have to return final artificial stuffing.
+        _at_eof = true;
+    }
+
+    // Other cases, read a copy of the packets in the internal buffer.
+    _copy_buffer.resize(max_packets);
+    const size_t count = readPackets(_copy_buffer.data(), metadata, max_packets, report);
+    if (count > 0) {
+        packets = _copy_buffer.data();
+    }
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Memory mapping of input files.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::mapFile(Report& report)
+{
+#if defined(TS_UNIX)
+
+    struct stat st;
+    if (::fstat(_fd, &st) < 0 || st.st_size <= 0 || uint64_t(st.st_size) > uint64_t(std::numeric_limits<size_t>::max())) {
+        report.debug(u"cannot map %s, using standard I/O", {getDisplayFileName()});
+        return;
+    }
+
+    void* base = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, _fd, 0);
+    if (base == MAP_FAILED) {
+        const SysErrorCode err = LastSysErrorCode();
+        report.debug(u"cannot map %s, using standard I/O: %s", {getDisplayFileName(), SysErrorCodeMessage(err)});
+        return;
+    }
+
+    // Hints to the kernel: aggressive read-ahead and huge pages when supported.
+    // Errors are ignored, these are only optimizations.
+    ::madvise(base, size_t(st.st_size), MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+    ::madvise(base, size_t(st.st_size), MADV_HUGEPAGE);
+#endif
+
+    _map_base = reinterpret_cast<uint8_t*>(base);
+    _map_size = uint64_t(st.st_size);
+    _map_pos = _start_offset;
+    _map_released = 0;
+    report.debug(u"reading %s through a memory mapping of %'d bytes", {getDisplayFileName(), _map_size});
+
+    // Detect plain TS files now to allow zero copy from the first packet.
+    // Let the packet stream detect other formats while reading.
+    if (packetFormat() == TSPacketFormat::AUTODETECT && _map_pos + PKT_SIZE <= _map_size && _map_base[_map_pos] == SYNC_BYTE) {
+        const uint8_t* const next = _map_base + _map_pos + PKT_SIZE;
+        const bool rs204 = _map_pos + PKT_SIZE + RS_SIZE < _map_size && next[0] != SYNC_BYTE && next[RS_SIZE] == SYNC_BYTE;
+        resetPacketStream(rs204 ? TSPacketFormat::RS204 : TSPacketFormat::TS, this, this);
+        report.debug(u"detected TS file format %s", {packetFormatString()});
+    }
+
+#endif
+}
+
+void ts::TSFile::unmapFile()
+{
+#if defined(TS_UNIX)
+    if (_map_base != nullptr) {
+        ::munmap(_map_base, size_t(_map_size));
+    }
+#endif
+    _map_base = nullptr;
+    _map_size = _map_pos = _map_released = 0;
+}
+
+void ts::TSFile::releaseMapped()
+{
+#if defined(TS_UNIX)
+    // Release physical pages which were already read, by large chunks.
+    // This keeps the resident size of the process low when reading huge files.
+    if (_map_pos < _map_released) {
+        // Rewound in the file.
+        _map_released = 0;
+    }
+    else if (_map_pos - _map_released >= MAP_RELEASE_CHUNK) {
+        const uint64_t page_size = SysInfo::Instance()->memoryPageSize();
+        const uint64_t end = _map_pos - _map_pos % page_size;
+        ::madvise(_map_base + _map_released, size_t(end - _map_released), MADV_DONTNEED);
+        _map_released = end;
+    }
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of AbstractWriteStreamInterface
 //----------------------------------------------------------------------------
@@ -765,9 +971,19 @@ bool ts::TSFile::writeStream(const void* buffer, size_t data_size, size_t& writt
     size_t remain = data_size;
     ssize_t outsize = 0;
 
+    // Direct I/O requires aligned addresses and sizes.
+    if (_direct && ((reinterpret_cast<size_t>(data) | data_size) % DIRECT_IO_ALIGNMENT) != 0) {
+        disableDirectIO(report);
+    }
+
     // Loop on write until everything is gone
     while (remain > 0) {
         outsize = ::write(_fd, data, remain);
+        if (outsize < 0 && _direct && LastSysErrorCode() == EINVAL) {
+            // Alignment constraints of the file system are stronger than expected.
+            disableDirectIO(report);
+            outsize = ::write(_fd, data, remain);
+        }
         if (outsize > 0) {
             // Normal case, some data were written
             outsize = std::min<ssize_t>(outsize, remain);
@@ -790,6 +1006,27 @@ bool ts::TSFile::writeStream(const void* buffer, size_t data_size, size_t& writt
 }
 
 
+//----------------------------------------------------------------------------
+// Revert to standard cached I/O after using direct I/O.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::disableDirectIO(Report& report)
+{
+    if (_direct) {
+#if defined(TS_LINUX)
+        const int fdflags = ::fcntl(_fd, F_GETFL);
+        if (fdflags != -1) {
+            ::fcntl(_fd, F_SETFL, fdflags & ~O_DIRECT);
+        }
+#elif defined(TS_MAC)
+        ::fcntl(_fd, F_NOCACHE, 0);
+#endif
+        _direct = false;
+        report.debug(u"reverting to cached I/O on %s", {getDisplayFileName()});
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Read/write artificial stuffing.
 //----------------------------------------------------------------------------
@@ -120,8 +120,25 @@ namespace ts {
             TEMPORARY   = 0x0020,   //!< Temporary file, deleted on close, not always visible in the file system.
             REOPEN      = 0x0040,   //!< Close and reopen the file instead of rewind to start of file when looping on input file.
             REOPEN_SPEC = 0x0080,   //!< Force REOPEN when the file is not a regular file.
+            DIRECT      = 0x0100,   //!< Write using direct I/O, bypassing the system cache, when possible (Linux, macOS). See DIRECT_IO_ALIGNMENT.
         };
 
+        //!
+        //! Alignment of memory addresses, sizes and file offsets for direct I/O.
+        //! When a file is open with flag DIRECT, direct I/O is used as long as all write operations
+        //! use addresses and sizes which are multiples of this value. The first unaligned write
+        //! operation transparently reverts to standard cached I/O for the rest of the file.
+        //! With the plain TS format, the size of a group of packets is aligned when the number
+        //! of packets is a multiple of 1024.
+        //!
+        static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+        //!
+        //! Check if the file is currently written using direct I/O.
+        //! @return True if the file is open and written using direct I/O.
+        //!
+        bool isDirectIO() const { return _direct; }
+
         //!
         //! Open or create the file (generic form).
         //! The file is rewindable if the underlying file is seekable, eg. not a pipe.
@@ -178,6 +195,26 @@ namespace ts {
         //!
         void setStuffing(size_t initial, size_t final);
 
+        //!
+        //! Request to read the file through a memory mapping.
+        //! This method shall be called before opening the file.
+        //! The memory mapping is used only when the file is a regular file which is opened
+        //! in read-only mode. Otherwise, the request is silently ignored and the file is
+        //! read using standard I/O. The file is accessed sequentially (kernel read-ahead
+        //! hints) and huge pages are used for the mapping when the system supports them.
+        //! The size of the file is sampled when the file is opened. Any data which are
+        //! later appended to the file are not read.
+        //! @param [in] on True to read the file through a memory mapping.
+        //! @see readPacketsInPlace()
+        //!
+        void setMemoryMapped(bool on) { _map_request = on; }
+
+        //!
+        //! Check if the file is currently read through a memory mapping.
+        //! @return True if the file is open and read through a memory mapping.
+        //!
+        bool isMemoryMapped() const { return _map_base != nullptr; }
+
         //!
         //! Abort any currenly read/write operation in progress.
         //! The file is left in a broken state and can be only closed.
@@ -207,26 +244,50 @@ namespace ts {
         // Override TSPacketStream implementation
         virtual size_t readPackets(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets, Report& report) override;
 
+        //!
+        //! Read TS packets without copy when possible.
+        //! When the file is read through a memory mapping and its format is plain 188-byte TS,
+        //! the returned packets are directly located in the memory mapping. In all other cases
+        //! (other formats, artificial stuffing, no memory mapping), the packets are read in an
+        //! internal buffer using readPackets().
+        //! @param [out] packets Address of the first read packet. The returned packets are
+        //! valid until the next read, seek or close operation on this object.
+        //! @param [out] metadata Optional packet metadata. If the pointer is not null, it must
+        //! point to an array of @a max_packets elements.
+        //! @param [in] max_packets Maximum number of packets to read.
+        //! @param [in,out] report Where to report errors.
+        //! @return The actual number of read packets. Returning zero means error or end of file.
+        //! @see setMemoryMapped()
+        //!
+        size_t readPacketsInPlace(const TSPacket*& packets, TSPacketMetadata* metadata, size_t max_packets, Report& report);
+
     private:
-        UString       _filename;         //!< Input file name.
-        size_t        _repeat;           //!< Repeat count (0 means infinite)
-        size_t        _counter;          //!< Current repeat count
-        uint64_t      _start_offset;     //!< Initial byte offset in file
-        size_t        _open_null;        //!< Number of artificial null packets to insert after open().
-        size_t        _close_null;       //!< Number of artificial null packets to insert before close().
-        size_t        _open_null_read;   //!< Remaining null packets to read after open().
-        size_t        _close_null_read;  //!< Remaining null packets to read before close().
-        volatile bool _is_open;          //!< Check if file is actually open
-        OpenFlags     _flags;            //!< Flags which were specified at open
-        int           _severity;         //!< Severity level for error reporting
-        volatile bool _at_eof;           //!< End of file has been reached
-        volatile bool _aborted;          //!< Operation has been aborted, no operation available
-        bool          _rewindable;       //!< Opened in rewindable mode
-        bool          _regular;          //!< Is a regular file (ie. not a pipe or special device)
+        UString        _filename;         //!< Input file name.
+        size_t         _repeat;           //!< Repeat count (0 means infinite)
+        size_t         _counter;          //!< Current repeat count
+        uint64_t       _start_offset;     //!< Initial byte offset in file
+        size_t         _open_null;        //!< Number of artificial null packets to insert after open().
+        size_t         _close_null;       //!< Number of artificial null packets to insert before close().
+        size_t         _open_null_read;   //!< Remaining null packets to read after open().
+        size_t         _close_null_read;  //!< Remaining null packets to read before close().
+        volatile bool  _is_open;          //!< Check if file is actually open
+        OpenFlags      _flags;            //!< Flags which were specified at open
+        int            _severity;         //!< Severity level for error reporting
+        volatile bool  _at_eof;           //!< End of file has been reached
+        volatile bool  _aborted;          //!< Operation has been aborted, no operation available
+        bool           _rewindable;       //!< Opened in rewindable mode
+        bool           _regular;          //!< Is a regular file (ie. not a pipe or special device)
+        bool           _direct;           //!< Direct I/O is currently used.
+        bool           _map_request;      //!< Read through a memory mapping when possible.
+        uint8_t*       _map_base;         //!< Base address of the memory mapping (null if not mapped).
+        uint64_t       _map_size;         //!< Size of the memory mapping.
+        uint64_t       _map_pos;          //!< Current read position in the memory mapping.
+        uint64_t       _map_released;     //!< Start of the unreleased part of the memory mapping.
+        TSPacketVector _copy_buffer;      //!< Internal buffer for readPacketsInPlace() when copy is required.
 #if defined(TS_WINDOWS)
-        ::HANDLE      _handle;         //!< File handle
+        ::HANDLE       _handle;           //!< File handle
 #else
-        int           _fd;             //!< File descriptor
+        int            _fd;               //!< File descriptor
 #endif
 
         // Implementation of AbstractReadStreamInterface
@@ -244,6 +305,10 @@ namespace ts {
         bool openInternal(bool reopen, Report& report);
         bool seekCheck(Report& report);
         bool seekInternal(uint64_t index, Report& report);
+        void mapFile(Report& report);
+        void unmapFile();
+        void releaseMapped();
+        void disableDirectIO(Report& report);
 
         // Inaccessible operations.
         TSFile& operator=(TSFile&) = delete;
@@ -140,18 +140,10 @@ void ts::TSPacketMetadata::setInputTimeStamp(uint64_t time_stamp, uint64_t ticks
         // Convert into PCR units only when needed.
         if (ticks_per_second != SYSTEM_CLOCK_FREQ) {
             // Generic conversion: (time_stamp / ticks_per_second) * SYSTEM_CLOCK_FREQ;
-            // Try to avoid losing intermediate accuracy and avoid intermediate overflow at the same time.
-            const uint64_t intermediate = time_stamp * SYSTEM_CLOCK_FREQ;
-            if (intermediate >= time_stamp) {
-                // No intermediate overflow. No accuracy is lost.
-                time_stamp = intermediate / ticks_per_second;
-            }
-            else {
-                // Intermediate overflow. Do it the opposite way, possibly loosing intermediate accuracy.
-                // But, because there was an overflow, the time_stamp value but be already very large,
-                // reducing the impact of intermediate accuracy loss.
-                time_stamp = (time_stamp / ticks_per_second) * SYSTEM_CLOCK_FREQ;
-            }
+            // Convert the seconds and the sub-second part separately. This avoids intermediate
+            // overflow with large time stamps (typically system time since the Epoch in micro or
+            // nano-seconds) without losing accuracy.
+            time_stamp = (time_stamp / ticks_per_second) * SYSTEM_CLOCK_FREQ + ((time_stamp % ticks_per_second) * SYSTEM_CLOCK_FREQ) / ticks_per_second;
         }
         // Make sure we remain in the usual PCR range.
         // This can create an issue if the input value wraps up at 2^64.
@@ -40,15 +40,18 @@ TSDUCK_SOURCE;
 ts::TSPacketQueue::TSPacketQueue(size_t size) :
     _eof(false),
     _stopped(false),
+    _inCount(0),
+    _bitrate(0),
+    _pcrBitrate(0),
+    _readerSleeping(false),
+    _writerSleeping(false),
     _mutex(),
     _enqueued(),
     _dequeued(),
-    _buffer(size),
+    _buffer(std::max<size_t>(size, 1)),
     _pcr(1, 12),
-    _inCount(0),
     _readIndex(0),
-    _writeIndex(0),
-    _bitrate(0)
+    _writeIndex(0)
 {
 }
 
@@ -59,37 +62,59 @@ ts::TSPacketQueue::TSPacketQueue(size_t size) :
 
 void ts::TSPacketQueue::reset(size_t size)
 {
-    Guard lock(_mutex);
-
     // Resize the buffer if requested.
     if (size != NPOS) {
         // Refuse to shrink too much. Keep at least one packet.
         _buffer.resize(std::max<size_t>(size, 1));
     }
 
-    _eof = false;
-    _stopped = false;
-    _inCount = 0;
+    _pcr.reset();
     _readIndex = 0;
     _writeIndex = 0;
+    _readerSleeping = false;
+    _writerSleeping = false;
     _bitrate = 0;
+    _pcrBitrate = 0;
+    _inCount = 0;
+    _eof = false;
+    _stopped = false;
 }
 
 
 //----------------------------------------------------------------------------
-// Get the size of the buffer in packets.
+// Wake up the other thread if it is sleeping on a condition.
 //----------------------------------------------------------------------------
 
-size_t ts::TSPacketQueue::bufferSize() const
+void ts::TSPacketQueue::wakeUp(std::atomic<bool>& sleeping, Condition& condition)
 {
-    Guard lock(_mutex);
-    return _buffer.size();
+    // Make sure that all updates from the caller are visible before checking if the other
+    // thread sleeps. Paired with the fence in the waiting functions. If the other thread
+    // is not yet sleeping, it will see the updates before going to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+        Guard lock(_mutex);
+        condition.signal();
+    }
 }
 
-size_t ts::TSPacketQueue::currentSize() const
+
+//----------------------------------------------------------------------------
+// Suspend the writer thread until enough packets are free in the buffer.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketQueue::waitFreeSpace(size_t min_size)
 {
-    Guard lock(_mutex);
-    return _inCount;
+    if (!_stopped && _buffer.size() - _inCount.load(std::memory_order_acquire) < min_size) {
+        // Declare that we are sleeping before checking the condition again.
+        // Either the reader thread sees us sleeping and signals us, or we see its updates here.
+        GuardCondition lock(_mutex, _dequeued);
+        _writerSleeping = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!_stopped && _buffer.size() - _inCount.load(std::memory_order_acquire) < min_size) {
+            lock.waitCondition();
+        }
+        _writerSleeping = false;
+    }
 }
 
 
@@ -99,10 +124,7 @@ size_t ts::TSPacketQueue::currentSize() const
 
 bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size, size_t min_size)
 {
-    GuardCondition lock(_mutex, _dequeued);
-
     // Maximum size we can allocate to the write window.
-    assert(_readIndex < _buffer.size());
     assert(_writeIndex < _buffer.size());
     const size_t max_size = _buffer.size() - _writeIndex;
 
@@ -111,28 +133,21 @@ bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size,
     min_size = std::max<size_t>(1, std::min(min_size, max_size));
 
     // Wait until we get enough free space.
-    while (!_stopped && _buffer.size() - _inCount < min_size) {
-        lock.waitCondition();
-    }
+    waitFreeSpace(min_size);
 
     // Return the write window.
     buffer = &_buffer[_writeIndex];
     if (_stopped) {
         // The reader thread has reported a stop condition, we can no longer write into the buffer.
         buffer_size = 0;
-    }
-    else if (_readIndex > _writeIndex) {
-        // The write window extends up to the read index (where packets were not yet consumed).
-        buffer_size = _readIndex - _writeIndex;
+        return false;
     }
     else {
-        // The write window wraps up at the end of the buffer.
-        // Return only the first contiguous part of the write window.
-        buffer_size = max_size;
+        // The free area starts at the write index and extends up to the read index, which is
+        // private to the reader thread. Return only the first contiguous part of the free area.
+        buffer_size = std::min(_buffer.size() - _inCount.load(std::memory_order_acquire), max_size);
+        return true;
     }
-
-    // A write buffer is returned only when the reader thread does not want to terminate.
-    return !_stopped;
 }
 
 
@@ -142,12 +157,9 @@ bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size,
 
 void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
 {
-    GuardCondition lock(_mutex, _enqueued);
-
     // Verify that the specified size is compatible with the current write window.
-    assert(_readIndex < _buffer.size());
     assert(_writeIndex < _buffer.size());
-    const size_t max_count = (_readIndex > _writeIndex ? _readIndex : _buffer.size()) - _writeIndex;
+    const size_t max_count = std::min(_buffer.size() - _inCount.load(std::memory_order_acquire), _buffer.size() - _writeIndex);
 
     // This is a bug in the application to specify more than the max size.
     assert(count <= max_count);
@@ -158,18 +170,44 @@ void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
     }
 
     // When the writer thread did not specify a bitrate, analyze PCR's.
-    if (_bitrate == 0) {
+    if (_bitrate == 0 && count > 0) {
         for (size_t i = 0; i < count; ++i) {
             _pcr.feedPacket(_buffer[_writeIndex + i]);
         }
+        if (_pcr.bitrateIsValid()) {
+            _pcrBitrate.store(_pcr.bitrate188(), std::memory_order_relaxed);
+        }
     }
 
-    // Mark written packets as part of the buffer.
-    _inCount += count;
+    // Publish written packets to the reader thread.
     _writeIndex = (_writeIndex + count) % _buffer.size();
+    _inCount.fetch_add(count, std::memory_order_release);
 
-    // Signal that packets have been enqueued
-    lock.signal();
+    // Signal that packets have been enqueued.
+    wakeUp(_readerSleeping, _enqueued);
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the writer thread to copy a range of packets into the buffer.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketQueue::putPackets(const TSPacket* buffer, size_t count)
+{
+    // Copy packets by contiguous chunks of the circular buffer.
+    while (count > 0) {
+        TSPacket* out_buffer = nullptr;
+        size_t out_count = 0;
+        if (!lockWriteBuffer(out_buffer, out_count, count)) {
+            return false;
+        }
+        out_count = std::min(out_count, count);
+        TSPacket::Copy(out_buffer, buffer, out_count);
+        releaseWriteBuffer(out_count);
+        buffer += out_count;
+        count -= out_count;
+    }
+    return true;
 }
 
 
@@ -179,14 +217,13 @@ void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
 
 void ts::TSPacketQueue::setBitrate(BitRate bitrate)
 {
-    Guard lock(_mutex);
-
     // Remember the bitrate value.
     _bitrate = bitrate;
 
     // If a specific value is given, reset PCR analysis.
     if (bitrate > 0) {
         _pcr.reset();
+        _pcrBitrate = 0;
     }
 }
 
@@ -197,8 +234,7 @@ void ts::TSPacketQueue::setBitrate(BitRate bitrate)
 
 bool ts::TSPacketQueue::eof() const
 {
-    Guard lock(_mutex);
-    return _eof && _inCount == 0;
+    return _eof && _inCount.load(std::memory_order_acquire) == 0;
 }
 
 
@@ -208,59 +244,44 @@ bool ts::TSPacketQueue::eof() const
 
 void ts::TSPacketQueue::setEOF()
 {
-    GuardCondition lock(_mutex, _enqueued);
     _eof = true;
 
     // We did not really enqueue packets but if a reader thread is waiting we need to wake it up.
-    lock.signal();
-}
-
-
-//----------------------------------------------------------------------------
-// Get bitrate, must be called with mutex held.
-//----------------------------------------------------------------------------
-
-ts::BitRate ts::TSPacketQueue::getBitrate() const
-{
-    if (_bitrate != 0) {
-        return _bitrate;
-    }
-    else if (_pcr.bitrateIsValid()) {
-        return _pcr.bitrate188();
-    }
-    else {
-        return 0;
-    }
+    wakeUp(_readerSleeping, _enqueued);
 }
 
 
 //----------------------------------------------------------------------------
-// Called by the reader thread to get the next packet.
+// Called by the reader thread to get the next packets without waiting.
 //----------------------------------------------------------------------------
 
-bool ts::TSPacketQueue::getPacket(TSPacket& packet, BitRate& bitrate)
+bool ts::TSPacketQueue::getPackets(TSPacket* buffer, size_t buffer_count, size_t& actual_count, BitRate& bitrate)
 {
-    GuardCondition lock(_mutex, _dequeued);
-
-    // Get bitrate, either from reader thread or from PCR analysis.
-    bitrate = getBitrate();
+    // Get bitrate, either from writer thread or from PCR analysis.
+    const BitRate user_bitrate = _bitrate.load(std::memory_order_relaxed);
+    bitrate = user_bitrate != 0 ? user_bitrate : _pcrBitrate.load(std::memory_order_relaxed);
 
-    // Get packet when available.
-    if (_inCount == 0) {
-        // No packet available.
+    // Number of packets to return.
+    actual_count = std::min(_inCount.load(std::memory_order_acquire), buffer_count);
+    if (actual_count == 0) {
         return false;
     }
-    else {
-        // Return next packet.
-        packet = _buffer[_readIndex];
-        _readIndex = (_readIndex + 1) % _buffer.size();
-        _inCount--;
-
-        // Signal the condition that a packet was freed.
-        lock.signal();
 
-        return true;
+    // Copy packets in at most two contiguous parts of the circular buffer.
+    assert(_readIndex < _buffer.size());
+    const size_t first = std::min(actual_count, _buffer.size() - _readIndex);
+    TSPacket::Copy(buffer, &_buffer[_readIndex], first);
+    if (first < actual_count) {
+        TSPacket::Copy(buffer + first, &_buffer[0], actual_count - first);
     }
+
+    // Free the packets in the buffer.
+    _readIndex = (_readIndex + actual_count) % _buffer.size();
+    _inCount.fetch_sub(actual_count, std::memory_order_release);
+
+    // Signal that packets were freed.
+    wakeUp(_writerSleeping, _dequeued);
+    return true;
 }
 
 
@@ -270,33 +291,22 @@ bool ts::TSPacketQueue::getPacket(TSPacket& packet, BitRate& bitrate)
 
 bool ts::TSPacketQueue::waitPackets(TSPacket* buffer, size_t buffer_count, size_t& actual_count, BitRate& bitrate)
 {
-    // Clear out params.
-    actual_count = 0;
-
     // Wait until there is some packet in the buffer.
-    GuardCondition lock(_mutex, _enqueued);
-    while (!_eof && !_stopped && _inCount == 0) {
-        lock.waitCondition();
-    }
-
-    // Return as many packets as we can. Ignore eof for now.
-    while (_inCount > 0 && buffer_count > 0) {
-        *buffer++ = _buffer[_readIndex];
-        buffer_count--;
-        actual_count++;
-        _readIndex = (_readIndex + 1) % _buffer.size();
-        _inCount--;
+    if (_inCount.load(std::memory_order_acquire) == 0 && !_eof && !_stopped) {
+        // Declare that we are sleeping before checking the condition again.
+        // Either the writer thread sees us sleeping and signals us, or we see its updates here.
+        GuardCondition lock(_mutex, _enqueued);
+        _readerSleeping = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (_inCount.load(std::memory_order_acquire) == 0 && !_eof && !_stopped) {
+            lock.waitCondition();
+        }
+        _readerSleeping = false;
     }
 
-    // Get bitrate, either from reader thread or from PCR analysis.
-    bitrate = getBitrate();
-
-    // Signal that packets were freed.
-    _dequeued.signal();
-
-    // Return false when no packet is returned. Do not return false immediately
-    // when _eof is true, wait for all enqueued packets to be returned.
-    return actual_count > 0;
+    // Return as many packets as we can. Return false when no packet is returned.
+    // Do not return false immediately when _eof is true, wait for all enqueued packets to be returned.
+    return getPackets(buffer, buffer_count, actual_count, bitrate);
 }
 
 
@@ -306,12 +316,9 @@ bool ts::TSPacketQueue::waitPackets(TSPacket* buffer, size_t buffer_count, size_
 
 void ts::TSPacketQueue::stop()
 {
-    GuardCondition lock(_mutex, _dequeued);
-
     // Report a stop condition.
     _stopped = true;
 
-    // Signal the condition that a packet was freed. This is not really freeing
-    // a packet but it means that the writer thread should wake up.
-    lock.signal();
+    // This is not really freeing a packet but it means that the writer thread should wake up.
+    wakeUp(_writerSleeping, _dequeued);
 }
@@ -37,6 +37,7 @@
 #include "tsPCRAnalyzer.h"
 #include "tsMutex.h"
 #include "tsCondition.h"
+#include <atomic>
 
 namespace ts {
     //!
@@ -46,10 +47,11 @@ namespace ts {
     //! A writer thread produces packets. The input packets are directly written
     //! into the buffer. The writer thread invokes lockWriteBuffer() to get
     //! a write window inside the buffer. When packets have been written into
-    //! this buffer, the writer thread calls releaseWriteBuffer().
+    //! this buffer, the writer thread calls releaseWriteBuffer(). Alternatively,
+    //! the writer thread can copy a range of packets using putPackets().
     //!
-    //! A reader thread consumes packets. The packets are consumed one by one
-    //! and copied out of the buffer using getPacket().
+    //! A reader thread consumes packets. The packets are copied out of the buffer
+    //! one by one using getPacket() or by ranges using getPackets() and waitPackets().
     //!
     //! The input bitrate, if known, is transmitted to the reader thread. If the
     //! writer thread is aware of the exact bitrate, it calls setBitrate() and
@@ -58,6 +60,12 @@ namespace ts {
     //!
     //! Termination conditions can be triggered on both sides.
     //!
+    //! There must be exactly one writer thread and one reader thread. The queue is
+    //! lock-free: each side owns its own index in the circular buffer and the number
+    //! of packets in the buffer is an atomic counter. A mutex and condition variables
+    //! are used only to sleep when the buffer is empty (reader side) or full (writer
+    //! side). The other side takes the mutex only when the thread is actually sleeping.
+    //!
     class TSDUCKDLL TSPacketQueue
     {
         TS_NOCOPY(TSPacketQueue);
@@ -75,7 +83,7 @@ namespace ts {
 
         //!
         //! Reset and resize the buffer.
-        //! It is illegal to reset the buffer while the writer thread has locked the buffer.
+        //! It is illegal to reset the buffer while the writer or reader thread is using the buffer.
         //! This is not enforced by this class. It is the responsibility of the application to check this.
         //! @param [in] size New size of the buffer in packets. By default, when set to NPOS,
         //! reset the queue without resizing the buffer.
@@ -86,13 +94,13 @@ namespace ts {
         //! Get the size of the buffer in packets.
         //! @return The size of the buffer in packets.
         //!
-        size_t bufferSize() const;
+        size_t bufferSize() const { return _buffer.size(); }
 
         //!
         //! Get the current number of packets in the buffer.
         //! @return The current number of packets in the buffer.
         //!
-        size_t currentSize() const;
+        size_t currentSize() const { return _inCount.load(std::memory_order_acquire); }
 
         //!
         //! Called by the writer thread to get a write buffer.
@@ -117,6 +125,17 @@ namespace ts {
         //!
         void releaseWriteBuffer(size_t count);
 
+        //!
+        //! Called by the writer thread to copy a range of packets into the buffer.
+        //! The writer thread is suspended while the buffer is full, until all packets
+        //! are copied or the reader thread triggers a stop condition.
+        //! @param [in] buffer Address of the packets to copy.
+        //! @param [in] count Number of packets to copy.
+        //! @return True when all packets were copied. False when the reader thread
+        //! has signalled a stop condition.
+        //!
+        bool putPackets(const TSPacket* buffer, size_t count);
+
         //!
         //! Called by the writer thread to report the input bitrate.
         //! @param [in] bitrate Input bitrate. If zero, the input bitrate is unknown
@@ -133,7 +152,7 @@ namespace ts {
         //! Check if the reader thread has reported a stop condition.
         //! @return True if the reader thread has reported a stop condition.
         //!
-        bool stopped() const { return _stopped; }
+        bool stopped() const { return _stopped.load(std::memory_order_acquire); }
 
         //!
         //! Called by the reader thread to get the next packet without waiting.
@@ -143,7 +162,23 @@ namespace ts {
         //! @return True if a packet was returned in @a packet. False if none was available
         //! or an end of file occured.
         //!
-        bool getPacket(TSPacket& packet, BitRate& bitrate);
+        bool getPacket(TSPacket& packet, BitRate& bitrate)
+        {
+            size_t count = 0;
+            return getPackets(&packet, 1, count, bitrate);
+        }
+
+        //!
+        //! Called by the reader thread to get the next packets without waiting.
+        //! The reader thread is never suspended.
+        //! @param [out] buffer Address of packet buffer.
+        //! @param [in] buffer_count Size of @a buffer in number of packets.
+        //! @param [out] actual_count Number of returned packets in @a buffer.
+        //! @param [out] bitrate Input bitrate or zero if unknown.
+        //! @return True if a packets were returned in @a buffer. False if none was available
+        //! or an end of file occured.
+        //!
+        bool getPackets(TSPacket* buffer, size_t buffer_count, size_t& actual_count, BitRate& bitrate);
 
         //!
         //! Called by the reader thread to wait for packets.
@@ -168,19 +203,29 @@ namespace ts {
         void stop();
 
     private:
-        volatile bool     _eof;         // The writer thread has reported an end of file.
-        volatile bool     _stopped;     // The read thread has reported a stop condition.
-        mutable Mutex     _mutex;       // Protect access to shared data.
-        mutable Condition _enqueued;    // Signaled when packets are inserted.
-        mutable Condition _dequeued;    // Signaled when packets were freed.
-        TSPacketVector    _buffer;      // The packet buffer.
-        PCRAnalyzer       _pcr;         // PCR analyzer to get the bitrate.
-        size_t            _inCount;     // Number of packets currently inside the buffer.
-        size_t            _readIndex;   // Index of next packet to read.
-        size_t            _writeIndex;  // Index of next packet to write.
-        BitRate           _bitrate;     // Bitrate as set by the writer thread.
-
-        // Get bitrate, must be called with mutex held.
-        BitRate getBitrate() const;
+        // Shared state, modified without lock.
+        std::atomic<bool>    _eof;            // The writer thread has reported an end of file.
+        std::atomic<bool>    _stopped;        // The read thread has reported a stop condition.
+        std::atomic<size_t>  _inCount;        // Number of packets currently inside the buffer.
+        std::atomic<BitRate> _bitrate;        // Bitrate as set by the writer thread.
+        std::atomic<BitRate> _pcrBitrate;     // Bitrate as computed from PCR's by the writer thread.
+        std::atomic<bool>    _readerSleeping; // The reader thread is sleeping or about to sleep on _enqueued.
+        std::atomic<bool>    _writerSleeping; // The writer thread is sleeping or about to sleep on _dequeued.
+
+        // Used only to sleep when the buffer is empty or full.
+        mutable Mutex     _mutex;      // Protect the conditions.
+        mutable Condition _enqueued;   // Signaled when packets are inserted.
+        mutable Condition _dequeued;   // Signaled when packets were freed.
+
+        TSPacketVector _buffer;      // The packet buffer.
+        PCRAnalyzer    _pcr;         // PCR analyzer to get the bitrate (writer thread only).
+        size_t         _readIndex;   // Index of next packet to read (reader thread only).
+        size_t         _writeIndex;  // Index of next packet to write (writer thread only).
+
+        // Wake up the other thread if it is sleeping on a condition.
+        void wakeUp(std::atomic<bool>& sleeping, Condition& condition);
+
+        // Suspend the writer thread until at least min_size packets are free in the buffer.
+        void waitFreeSpace(size_t min_size);
     };
 }
@@ -52,7 +52,10 @@ ts::TSScrambling::TSScrambling(Report& report, uint8_t scrambling) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_packets(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(scrambling);
 }
@@ -72,7 +75,10 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_packets(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -94,7 +100,10 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _batch_packets(),
+    _batch_data(),
+    _batch_sizes()
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -582,3 +591,94 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt a batch of TS packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::encrypt(TSPacket* const pkts[], size_t count)
+{
+    bool ok = true;
+    _batch_packets.clear();
+    for (size_t i = 0; ok && i < count; ++i) {
+        TSPacket& pkt(*pkts[i]);
+        if (pkt.isScrambled()) {
+            _report.error(u"try to scramble an already scrambled packet");
+            ok = false;
+        }
+        else if (pkt.hasPayload()) {
+            _batch_packets.push_back(&pkt);
+        }
+    }
+
+    // If no current parity is set, start with even by default.
+    if (!_batch_packets.empty() && _encrypt_scv == SC_CLEAR && !setEncryptParity(SC_EVEN_KEY)) {
+        return false;
+    }
+    return processBatch(true, _encrypt_scv) && ok;
+}
+
+bool ts::TSScrambling::decrypt(TSPacket* const pkts[], size_t count)
+{
+    // Process consecutive packets with the same parity at once.
+    _batch_packets.clear();
+    for (size_t i = 0; i < count; ++i) {
+        TSPacket& pkt(*pkts[i]);
+        const uint8_t scv = pkt.getScrambling();
+        if (scv == SC_EVEN_KEY || scv == SC_ODD_KEY) {
+            if (scv != _decrypt_scv) {
+                // Flush previous packets with previous parity before switching to the next key.
+                if (!processBatch(false, _decrypt_scv)) {
+                    return false;
+                }
+                // In case of fixed control word, use next key when the scrambling control changes.
+                _decrypt_scv = scv;
+                if (hasFixedCW() && !setNextFixedCW(_decrypt_scv)) {
+                    return false;
+                }
+            }
+            _batch_packets.push_back(&pkt);
+        }
+    }
+    return processBatch(false, _decrypt_scv);
+}
+
+bool ts::TSScrambling::processBatch(bool encryption, uint8_t scv)
+{
+    if (_batch_packets.empty()) {
+        return true;
+    }
+
+    // Select scrambling algo.
+    assert(scv == SC_EVEN_KEY || scv == SC_ODD_KEY);
+    CipherChaining* algo = _scrambler[scv & 1];
+    assert(algo != nullptr);
+
+    // Build the list of payloads. Remove the residue if the algo cannot process it.
+    const size_t count = _batch_packets.size();
+    const size_t bsize = algo->residueAllowed() ? 0 : algo->blockSize();
+    _batch_data.resize(count);
+    _batch_sizes.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t psize = _batch_packets[i]->getPayloadSize();
+        _batch_data[i] = _batch_packets[i]->getPayload();
+        _batch_sizes[i] = bsize == 0 ? psize : psize - psize % bsize;
+    }
+
+    // Encrypt or decrypt all payloads at once.
+    const bool ok = encryption ?
+        algo->encryptInPlaceBatch(count, _batch_data.data(), _batch_sizes.data()) :
+        algo->decryptInPlaceBatch(count, _batch_data.data(), _batch_sizes.data());
+
+    if (ok) {
+        for (size_t i = 0; i < count; ++i) {
+            _batch_packets[i]->setScrambling(encryption ? scv : uint8_t(SC_CLEAR));
+        }
+    }
+    else {
+        _report.error(u"packet %s error using %s", {encryption ? u"encryption" : u"decryption", algo->name()});
+    }
+    _batch_packets.clear();
+    return ok;
+}
@@ -192,6 +192,26 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Encrypt several TS packets with the current parity and corresponding CW.
+        //! The packets are encrypted in parallel, which is much faster than encrypting them one
+        //! by one. With DVB-CSA2, the stream cipher is bitsliced. With AES-based algorithms, the
+        //! AES blocks of all packets are pipelined in the block cipher.
+        //! @param [in,out] pkts Array of @a count addresses of packets to encrypt.
+        //! @param [in] count Number of packets in @a pkts.
+        //! @return True on success, false on error. An already encrypted packet is an error.
+        //!
+        bool encrypt(TSPacket* const pkts[], size_t count);
+
+        //!
+        //! Decrypt several TS packets with the CW corresponding to the parity in each packet.
+        //! Consecutive packets with the same parity are decrypted in parallel.
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt.
+        //! @param [in] count Number of packets in @a pkts.
+        //! @return True on success, false on error. Clear packets are not an error.
+        //!
+        bool decrypt(TSPacket* const pkts[], size_t count);
+
     private:
         // List of control words
         typedef std::list<ByteBlock> CWList;
@@ -211,6 +231,12 @@ namespace ts {
         CBC<AES>         _aescbc[2];
         CTR<AES>         _aesctr[2];
         CipherChaining*  _scrambler[2];
+        std::vector<TSPacket*> _batch_packets;  // Packets to process in a batch.
+        std::vector<void*>     _batch_data;     // Payloads of the packets in the batch.
+        std::vector<size_t>    _batch_sizes;    // Payload sizes of the packets in the batch.
+
+        // Encrypt or decrypt all packets in _batch_packets with the key for scv, then clear the batch.
+        bool processBatch(bool encryption, uint8_t scv);
 
         // Set the next fixed control word as scrambling key.
         bool setNextFixedCW(int parity);
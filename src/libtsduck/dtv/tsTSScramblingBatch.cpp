@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSScramblingBatch.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::TSScramblingBatch::DEFAULT_OFFLINE_PACKET_WINDOW;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TSScramblingBatch::TSScramblingBatch(bool encryption) :
+    _encryption(encryption),
+    _packet_window(0),
+    _batching(false),
+    _scrambling(nullptr),
+    _batch(),
+    _failed(nullptr)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options.
+//----------------------------------------------------------------------------
+
+void ts::TSScramblingBatch::defineArgs(Args& args) const
+{
+    const UString verb(_encryption ? u"scrambl" : u"descrambl");
+
+    args.option(u"packet-window", 0, Args::UNSIGNED);
+    args.help(u"packet-window", u"count",
+              u"Number of packets which are processed at once. " + UString(_encryption ? u"S" : u"Des") + u"crambling many "
+              u"packets at a time is much faster than " + verb + u"ing them one by one but introduces "
+              u"some latency. The default is " + UString::Decimal(DEFAULT_OFFLINE_PACKET_WINDOW) +
+              u" packets in offline mode and 0 (packets are " + verb + u"ed one by one) in real-time mode.");
+}
+
+void ts::TSScramblingBatch::loadArgs(Args& args, bool realtime)
+{
+    _packet_window = args.intValue<size_t>(u"packet-window", realtime ? 0 : DEFAULT_OFFLINE_PACKET_WINDOW);
+}
+
+
+//----------------------------------------------------------------------------
+// Batch processing.
+//----------------------------------------------------------------------------
+
+void ts::TSScramblingBatch::reset()
+{
+    _batching = false;
+    _scrambling = nullptr;
+    _batch.clear();
+    _failed = nullptr;
+}
+
+void ts::TSScramblingBatch::start()
+{
+    _batching = true;
+}
+
+size_t ts::TSScramblingBatch::stop(const TSPacketWindow& win, size_t count)
+{
+    flush();
+    _batching = false;
+
+    // In case of error, terminate before the first packet of the failed batch.
+    if (_failed != nullptr) {
+        for (size_t i = 0; i < count; ++i) {
+            if (win.packet(i) == _failed) {
+                count = i;
+                break;
+            }
+        }
+        _failed = nullptr;
+    }
+    return count;
+}
+
+bool ts::TSScramblingBatch::process(TSScrambling& scrambling, TSPacket& pkt)
+{
+    if (!_batching) {
+        return _encryption ? scrambling.encrypt(pkt) : scrambling.decrypt(pkt);
+    }
+    else if (&scrambling != _scrambling && !flush()) {
+        return false;
+    }
+    else {
+        _scrambling = &scrambling;
+        _batch.push_back(&pkt);
+        return true;
+    }
+}
+
+bool ts::TSScramblingBatch::flush()
+{
+    bool ok = true;
+    if (!_batch.empty()) {
+        assert(_scrambling != nullptr);
+        ok = _encryption ? _scrambling->encrypt(_batch.data(), _batch.size()) : _scrambling->decrypt(_batch.data(), _batch.size());
+        if (!ok && _failed == nullptr) {
+            _failed = _batch.front();
+        }
+        _batch.clear();
+    }
+    return ok;
+}
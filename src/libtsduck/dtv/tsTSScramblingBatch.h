@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Batch scrambling or descrambling of the TS packets of a packet window.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSScrambling.h"
+#include "tsTSPacketWindow.h"
+#include "tsArgs.h"
+
+namespace ts {
+    //!
+    //! Batch scrambling or descrambling of the TS packets of a packet window.
+    //! @ingroup mpeg
+    //!
+    //! This class is a helper for plugins which scramble or descramble packets using
+    //! a packet window. In processPacketWindow(), the packets are collected one by one
+    //! by the packet processing method and they are scrambled or descrambled at once, using
+    //! the batch methods of TSScrambling. The batch is flushed before a control word change.
+    //!
+    //! Include command line arguments processing for the option @c \--packet-window.
+    //!
+    class TSDUCKDLL TSScramblingBatch
+    {
+        TS_NOBUILD_NOCOPY(TSScramblingBatch);
+    public:
+        //!
+        //! Default size of the packet window in offline mode.
+        //!
+        static constexpr size_t DEFAULT_OFFLINE_PACKET_WINDOW = 512;
+
+        //!
+        //! Constructor.
+        //! @param [in] encryption If true, the packets are scrambled. If false, they are descrambled.
+        //!
+        TSScramblingBatch(bool encryption);
+
+        //!
+        //! Add the command line option @c \--packet-window.
+        //! @param [in,out] args Command line arguments to update.
+        //!
+        void defineArgs(Args& args) const;
+
+        //!
+        //! Load the command line option @c \--packet-window.
+        //! @param [in,out] args Command line arguments.
+        //! @param [in] realtime If true, the default is to process the packets one by one.
+        //!
+        void loadArgs(Args& args, bool realtime);
+
+        //!
+        //! Get the size of the packet window, as returned by the plugin's getPacketWindowSize().
+        //! @return The number of packets to process at once or zero to process packets one by one.
+        //!
+        size_t packetWindowSize() const { return _packet_window; }
+
+        //!
+        //! Reset the state of the batch, typically when the plugin starts.
+        //!
+        void reset();
+
+        //!
+        //! Start collecting packets, at the beginning of the plugin's processPacketWindow().
+        //!
+        void start();
+
+        //!
+        //! Process the remaining packets, at the end of the plugin's processPacketWindow().
+        //! @param [in] win The packet window.
+        //! @param [in] count Number of packets which were processed in the window.
+        //! @return The number of processed packets. In case of error, this is the index
+        //! of the first packet of the batch which failed.
+        //!
+        size_t stop(const TSPacketWindow& win, size_t count);
+
+        //!
+        //! Scramble or descramble a packet, immediately or later in the current batch.
+        //! @param [in,out] scrambling Scrambling engine to use. When the engine changes,
+        //! the previous batch is processed first.
+        //! @param [in,out] pkt The packet to scramble or descramble.
+        //! @return True on success, false on error.
+        //!
+        bool process(TSScrambling& scrambling, TSPacket& pkt);
+
+        //!
+        //! Scramble or descramble all packets in the current batch.
+        //! This shall be called before changing the control words.
+        //! @return True on success, false on error.
+        //!
+        bool flush();
+
+    private:
+        const bool             _encryption;     // Scramble or descramble.
+        size_t                 _packet_window;  // Number of packets to process at once.
+        bool                   _batching;       // Packets are processed in batch (in processPacketWindow()).
+        TSScrambling*          _scrambling;     // Scrambling engine for all packets in current batch.
+        std::vector<TSPacket*> _batch;          // Packets to process in the current batch.
+        const TSPacket*        _failed;         // First packet of a batch which could not be processed.
+    };
+}
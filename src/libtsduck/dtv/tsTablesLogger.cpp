@@ -38,7 +38,10 @@
 #include "tsSimulCryptDate.h"
 #include "tsDuckProtocol.h"
 #include "tsxmlComment.h"
+#include "tsxmlDeclaration.h"
 #include "tsxmlElement.h"
+#include "tsxmlTextSerializer.h"
+#include "tsxmlJSONSerializer.h"
 #include "tsjsonArray.h"
 #include "tsjsonObject.h"
 TSDUCK_SOURCE;
@@ -86,6 +89,7 @@ ts::TablesLogger::TablesLogger(TablesDisplay& display) :
     _logger(false),
     _log_size(DEFAULT_LOG_SIZE),
     _no_duplicate(false),
+    _skip_unchanged(false),
     _pack_all_sections(false),
     _pack_and_flush(false),
     _fill_eit(false),
@@ -278,6 +282,14 @@ void ts::TablesLogger::defineArgs(Args& args) const
               u"With --json-output, rewrite the same file with each table. "
               u"The specified file always contains one single table, the latest one.");
 
+    args.option(u"skip-unchanged");
+    args.help(u"skip-unchanged",
+              u"Do not report tables or sections with the same content as the previous occurrence of "
+              u"the same table or section in the same PID, even if the version number has changed. "
+              u"A table is identified by its table id and table id extension. A section is additionally "
+              u"identified by its section number. Contrary to --no-duplicate, this option applies to "
+              u"all tables and sections, not only consecutive ones, and unchanged sections are not parsed.");
+
     args.option(u"text-output", 0, Args::STRING);
     args.help(u"text-output", u"filename", u"A synonym for --output-file.");
 
@@ -353,6 +365,7 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
     _logger = args.present(u"log");
     args.getIntValue(_log_size, u"log-size", DEFAULT_LOG_SIZE);
     _no_duplicate = args.present(u"no-duplicate");
+    _skip_unchanged = args.present(u"skip-unchanged");
     _udp_raw = args.present(u"no-encapsulation");
     _use_current = !args.present(u"exclude-current");
     _use_next = args.present(u"include-next");
@@ -421,6 +434,7 @@ bool ts::TablesLogger::open()
 
     // Type of sections to get.
     _demux.setCurrentNext(_use_current, _use_next);
+    _demux.setSkipUnchanged(_skip_unchanged);
     _cas_mapper.setCurrentNext(_use_current, _use_next);
 
     // Load the XML model for tables if we need to convert to JSON.
@@ -498,6 +512,12 @@ void ts::TablesLogger::close()
             _demux.fillAndFlushEITs();
         }
 
+        // Report skipped sections.
+        if (_skip_unchanged) {
+            const SectionDemux::Status status(_demux);
+            _report.verbose(u"skipped %'d unchanged tables and %'d unchanged sections", {status.unchanged_table, status.unchanged_sect});
+        }
+
         // Close files and documents.
         _xml_doc.close();
         _json_doc.close();
@@ -590,28 +610,35 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
             table.toXML(_duck, doc.rootElement(), _xml_options);
             doc.save(_xml_destination, 2, true);
         }
-        else {
-            // Just add the table in the running doc.
-            // Convert the table into an XML structure, print and delete the XML table.
-            table.toXML(_duck, _xml_doc.rootElement(), _xml_options);
-            _xml_doc.flush();
+        else if (table.isValid()) {
+            // Directly serialize the table in the running doc, without building an XML structure.
+            TextFormatter* text = _xml_doc.startElement();
+            if (text != nullptr) {
+                xml::TextSerializer output(*text, _xml_doc.tweaks());
+                table.toXML(_duck, output, _xml_options);
+                output.close();
+                _xml_doc.endElement();
+            }
         }
     }
 
     // Save table in JSON format.
     if (_use_json) {
-        // First, build an XML document with the table.
-        xml::Document doc(_report);
-        doc.initialize(u"tsduck");
-        table.toXML(_duck, doc.rootElement(), _xml_options);
         if (_rewrite_json) {
+            // First, build an XML document with the table.
+            xml::Document doc(_report);
+            doc.initialize(u"tsduck");
+            table.toXML(_duck, doc.rootElement(), _xml_options);
             // Convert to JSON and save a new document each time.
             _x2j_conv.convertToJSON(doc)->save(_json_destination, 2, true, _report);
         }
-        else {
-            // Convert to JSON. Force "tsduck" root to appear so that the path to the first table is always the same.
-            // Query the first (and only) converted table and add it to the running document.
-            _json_doc.add(_x2j_conv.convertToJSON(doc, true)->query(u"#nodes[0]"));
+        else if (table.isValid()) {
+            // Directly serialize the table as the next JSON value in the running document.
+            TextFormatter* text = _json_doc.startValue();
+            if (text != nullptr) {
+                xml::JSONSerializer output(*text, _x2j_conv, u"tsduck");
+                table.toXML(_duck, output, _xml_options);
+            }
         }
     }
 
@@ -756,41 +783,40 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
 
 void ts::TablesLogger::logXMLJSON(const BinaryTable& table)
 {
-    // Build an XML document.
-    xml::Document doc;
-    doc.initialize(u"tsduck");
-    xml::Element* elem = table.toXML(_duck, doc.rootElement(), _xml_options);
-    if (elem == nullptr) {
-        // Error serializing the table, error message already printed.
-        return;
-    }
-
     // Initialize a text formatter for one-liner.
     TextFormatter text(_report);
     text.setString();
     text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
 
-    // Log the XML line.
+    // Log the XML line, as a complete document with default XML tweaks.
     if (_log_xml_line) {
-        doc.print(text);
+        text << "<?" << UString(xml::Declaration::DEFAULT_XML_DECLARATION) << "?>" << ts::endl;
+        xml::TextSerializer output(text, xml::Tweaks(), 1);
+        output.startElement(u"tsduck");
+        const bool ok = table.toXML(_duck, output, _xml_options);
+        output.close();
+        text << ts::endl;
+        if (!ok) {
+            // Error serializing the table, error message already printed.
+            return;
+        }
         _report.info(_log_xml_prefix + text.toString());
     }
 
-    // Log the JSON line.
+    // Log the JSON line, directly serialized from the table.
     if (_log_json_line) {
 
-        // Convert the XML document into JSON.
-        // Force "tsduck" root to appear so that the path to the first table is always the same.
-        const json::ValuePtr root(_x2j_conv.convertToJSON(doc, true));
-
         // Reset the text formatter if already used for XML.
         if (_log_xml_line) {
             text.setString();
         }
 
-        // Query the first (and only) converted table and log it as one line.
-        root->query(u"#nodes[0]").print(text);
-        _report.info(_log_json_prefix + text.toString());
+        xml::JSONSerializer output(text, _x2j_conv, u"tsduck");
+        const bool ok = table.toXML(_duck, output, _xml_options);
+        output.close();
+        if (ok) {
+            _report.info(_log_json_prefix + text.toString());
+        }
     }
 }
 
@@ -177,6 +177,7 @@ namespace ts {
         bool                     _logger;            // Table logger.
         size_t                   _log_size;          // Size of table to log.
         bool                     _no_duplicate;      // Exclude duplicated short sections on a PID.
+        bool                     _skip_unchanged;    // Exclude tables and sections with unchanged content.
         bool                     _pack_all_sections; // Pack all sections as if they were one table.
         bool                     _pack_and_flush;    // Pack and flush incomplete tables before exiting.
         bool                     _fill_eit;          // Add missing empty sections to incomplete EIT's before exiting.
@@ -212,7 +213,7 @@ namespace ts {
         // Save a section in a binary file
         void saveBinarySection(const Section&);
 
-        // Log XML and/or JSON one-liners.
+        // Log XML and/or JSON one-liners of a table.
         void logXMLJSON(const BinaryTable& table);
 
         // Send UDP table and section.
@@ -41,4 +41,5 @@ const ts::TypedEnumeration<ts::TimeSource> ts::TimeSourceEnum({
     {u"PCR",       ts::TimeSource::PCR},
     {u"DTS",       ts::TimeSource::DTS},
     {u"PTS",       ts::TimeSource::PTS},
+    {u"PHC",       ts::TimeSource::PHC},
 });
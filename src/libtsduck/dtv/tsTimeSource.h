@@ -50,6 +50,7 @@ namespace ts {
         PCR,            //!< PCR (Program Clock Reference), the transport stream system clock.
         DTS,            //!< DTS (Decoding Time Stamp), in a video or audio stream.
         PTS,            //!< PTS (Presentation Time Stamp), in a video or audio stream.
+        PHC,            //!< Raw time stamp from the PTP Hardware Clock of a network interface, not synchronized with the system time.
     };
 
     //!
@@ -37,6 +37,42 @@
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
+namespace {
+    // Format the CPU affinity and scheduling policy of a plugin thread, empty if all defaults.
+    ts::UString ThreadLayout(const ts::ThreadAttributes& attr)
+    {
+        ts::UStringList items;
+
+        // Format the CPU affinity as a list of ranges, as in "0-3,8".
+        const std::set<size_t>& cpus(attr.getAffinity());
+        if (!cpus.empty()) {
+            ts::UString list;
+            for (auto it = cpus.begin(); it != cpus.end(); ) {
+                const size_t first = *it;
+                size_t last = first;
+                while (++it != cpus.end() && *it == last + 1) {
+                    last = *it;
+                }
+                list.format(u"%s%d", {list.empty() ? u"" : u",", first});
+                if (last > first) {
+                    list.format(u"-%d", {last});
+                }
+            }
+            items.push_back(u"cpu: " + list);
+        }
+
+        // Scheduling policy, the priority is displayed only when explicitly specified.
+        if (attr.getSchedulingPolicy() != ts::ThreadAttributes::SchedulingPolicy::DEFAULT) {
+            items.push_back(u"policy: " + ts::ThreadAttributes::SchedulingPolicyEnum.name(attr.getSchedulingPolicy()));
+            if (attr.getSchedulingPriority() != 0) {
+                items.push_back(ts::UString::Format(u"priority: %d", {attr.getSchedulingPriority()}));
+            }
+        }
+
+        return items.empty() ? ts::UString() : u" [" + ts::UString::Join(items, u", ") + u"]";
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor and destructor.
@@ -271,11 +307,14 @@ void ts::tsp::ControlServer::listOnePlugin(size_t index, UChar type, PluginExecu
 {
     const bool verbose = response.verbose();
     const bool suspended = plugin->getSuspended();
-    response.info(u"%2d: %s-%c %s", {
+    ThreadAttributes attr;
+    plugin->getAttributes(attr);
+    response.info(u"%2d: %s-%c %s%s", {
                   index,
                   verbose && suspended ? u"(suspended) " : u"",
                   type,
-                  verbose ? plugin->plugin()->commandLine() : plugin->pluginName() });
+                  verbose ? plugin->plugin()->commandLine() : plugin->pluginName(),
+                  ThreadLayout(attr)});
 }
 
 
@@ -435,7 +435,8 @@ void ts::tsp::InputExecutor::main()
         size_t pkt_read = 0;
 
         // Read from the plugin if not already terminated.
-        if (!plugin_completed) {
+        // In lock-free mode, waitWork() may return no space when interrupted by a restart.
+        if (!plugin_completed && pkt_max > 0) {
             pkt_read = receiveAndStuff(pkt_first, pkt_max);
             plugin_completed = pkt_read == 0;
         }
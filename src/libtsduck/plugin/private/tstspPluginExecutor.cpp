@@ -31,8 +31,30 @@
 #include "tsPluginRepository.h"
 #include "tsGuardCondition.h"
 #include "tsGuard.h"
+#include <thread>
 TSDUCK_SOURCE;
 
+// Adaptive spinning in lock-free mode: bounds and initial number of spin iterations.
+#define MIN_SPIN_COUNT       16
+#define MAX_SPIN_COUNT     8192
+#define INIT_SPIN_COUNT     512
+
+namespace {
+    // Hint the CPU that we are in a spin-wait loop.
+    inline void CpuRelax()
+    {
+#if defined(TS_MSC)
+        ::YieldProcessor();
+#elif defined(TS_I386) || defined(TS_X86_64)
+        __builtin_ia32_pause();
+#elif defined(TS_ARM) || defined(TS_ARM64)
+        __asm__ __volatile__("yield");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -58,7 +80,10 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _input_end(false),
     _bitrate(0),
     _restart(false),
-    _restart_data()
+    _restart_data(),
+    _park_mutex(),
+    _sleeping(false),
+    _spin_limit(std::thread::hardware_concurrency() > 1 ? INIT_SPIN_COUNT : 0)
 {
     // Preset common default options.
     if (plugin() != nullptr) {
@@ -100,9 +125,38 @@ void ts::tsp::PluginExecutor::signalPluginEvent(uint32_t event_code, Object* plu
 
 void ts::tsp::PluginExecutor::setAbort()
 {
-    Guard lock(_global_mutex);
-    _tsp_aborting = true;
-    ringPrevious<PluginExecutor>()->_to_do.signal();
+    if (_options.lock_free) {
+        _tsp_aborting = true;
+        ringPrevious<PluginExecutor>()->wakeUp();
+    }
+    else {
+        Guard lock(_global_mutex);
+        _tsp_aborting = true;
+        ringPrevious<PluginExecutor>()->wakeUp();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wake up the plugin thread when it waits for something to do.
+// In mutex mode, the global mutex must be held by the caller.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::wakeUp()
+{
+    if (!_options.lock_free) {
+        _to_do.signal();
+    }
+    else {
+        // Make sure that all updates from the caller are visible before checking if the
+        // plugin thread sleeps. Paired with the fence in waitWorkLockFree(). If the plugin
+        // thread is not yet sleeping, it will see the updates before going to sleep.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_sleeping) {
+            Guard lock(_park_mutex);
+            _to_do.signal();
+        }
+    }
 }
 
 
@@ -152,6 +206,16 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", {count, bitrate, input_end, aborted});
 
+    return _options.lock_free ? passPacketsLockFree(count, bitrate, input_end, aborted) : passPacketsLocked(count, bitrate, input_end, aborted);
+}
+
+
+//----------------------------------------------------------------------------
+// Pass processed packets, mutex mode.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::PluginExecutor::passPacketsLocked(size_t count, BitRate bitrate, bool input_end, bool aborted)
+{
     // We access data under the protection of the global mutex.
     Guard lock(_global_mutex);
 
@@ -165,11 +229,13 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
 
     // Propagate bitrate and end of input flag to next processor.
     next->_bitrate = bitrate;
-    next->_input_end = next->_input_end || input_end;
+    if (input_end) {
+        next->_input_end = true;
+    }
 
     // Wake the next processor when there is some new input data or end of input.
     if (count > 0 || input_end) {
-        next->_to_do.signal();
+        next->wakeUp();
     }
 
     // Force to abort our processor when the next one is aborting. Already done in waitWork() but force immediately.
@@ -180,8 +246,55 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
 
     // Wake the previous processor when we abort (propagate abort conditions backward).
     if (aborted) {
-        _tsp_aborting = true; // volatile bool in TSP superclass
-        ringPrevious<PluginExecutor>()->_to_do.signal();
+        _tsp_aborting = true; // atomic bool in TSP superclass
+        ringPrevious<PluginExecutor>()->wakeUp();
+    }
+
+    // Return false when the current processor shall stop.
+    return !input_end && !aborted;
+}
+
+
+//----------------------------------------------------------------------------
+// Pass processed packets, lock-free mode.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::PluginExecutor::passPacketsLockFree(size_t count, BitRate bitrate, bool input_end, bool aborted)
+{
+    // Between two consecutive plugins, there is exactly one producer (the previous plugin thread,
+    // which increments the packet count of the next one) and one consumer (the plugin thread, which
+    // decrements its own packet count). The starting index is private to the plugin thread.
+    // The bitrate is published before the packets and the end of input after them, so that the
+    // next plugin never sees the end of input without the corresponding last packets.
+
+    // Update our buffer: we remove the first 'count' packets from the beginning of our slice of the buffer.
+    _pkt_first = (_pkt_first + count) % _buffer->count();
+    _pkt_cnt -= count;
+
+    // Update next processor's buffer: add 'count' packets at the end of its slice of the buffer.
+    PluginExecutor* next = ringNext<PluginExecutor>();
+    next->_bitrate = bitrate;
+    if (count > 0) {
+        next->_pkt_cnt += count;
+    }
+    if (input_end) {
+        next->_input_end = true;
+    }
+
+    // Wake the next processor when there is some new input data or end of input.
+    if (count > 0 || input_end) {
+        next->wakeUp();
+    }
+
+    // Force to abort our processor when the next one is aborting (see passPacketsLocked()).
+    if (plugin()->type() != PluginType::OUTPUT) {
+        aborted = aborted || next->_tsp_aborting;
+    }
+
+    // Wake the previous processor when we abort (propagate abort conditions backward).
+    if (aborted) {
+        _tsp_aborting = true;
+        ringPrevious<PluginExecutor>()->wakeUp();
     }
 
     // Return false when the current processor shall stop.
@@ -203,21 +316,47 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
         min_pkt_cnt = _buffer->count();
     }
 
-    // We access data under the protection of the global mutex.
-    GuardCondition lock(_global_mutex, _to_do);
-
-    PluginExecutor* next = ringNext<PluginExecutor>();
     timeout = false;
 
-    // Loop until enough packets are available (or some error condition).
-    while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
-        // If packet area for this processor is empty, wait for some packet.
-        // The mutex is implicitely released, we wait for the condition
-        // '_to_do' and, once we get it, implicitely relock the mutex.
-        // We loop on this until packets are actually available.
-        // If there is a timeout in the packet reception, call the plugin handler.
-        timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+    if (_options.lock_free) {
+        // No lock, spin or sleep until enough packets are available (or some error condition).
+        waitWorkLockFree(min_pkt_cnt, timeout);
+        getWork(min_pkt_cnt, timeout, pkt_first, pkt_cnt, bitrate, input_end, aborted);
     }
+    else {
+        // We access data under the protection of the global mutex.
+        GuardCondition lock(_global_mutex, _to_do);
+        PluginExecutor* next = ringNext<PluginExecutor>();
+
+        // Loop until enough packets are available (or some error condition).
+        while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
+            // If packet area for this processor is empty, wait for some packet.
+            // The mutex is implicitely released, we wait for the condition
+            // '_to_do' and, once we get it, implicitely relock the mutex.
+            // We loop on this until packets are actually available.
+            // If there is a timeout in the packet reception, call the plugin handler.
+            timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+        }
+
+        getWork(min_pkt_cnt, timeout, pkt_first, pkt_cnt, bitrate, input_end, aborted);
+    }
+
+    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
+        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+}
+
+
+//----------------------------------------------------------------------------
+// Build the description of the work to return from waitWork().
+// In mutex mode, the global mutex must be held by the caller.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::getWork(size_t min_pkt_cnt, bool timeout, size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted)
+{
+    // Take a snapshot of the shared state. In lock-free mode, the end of input must be read
+    // before the packet count because the previous plugin sets it after publishing its packets.
+    const bool end = _input_end;
+    const size_t cnt = _pkt_cnt;
 
     // The number of returned packets is limited up to the wrap-up point of the circular buffer,
     // if allowed by the requested minimum number of packets.
@@ -227,24 +366,66 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     }
     else if (_pkt_first + min_pkt_cnt <= _buffer->count()) {
         // Return up to the wrap-up point. This will satisfy the requested minimum.
-        pkt_cnt = std::min(_pkt_cnt, _buffer->count() - _pkt_first);
+        pkt_cnt = std::min(cnt, _buffer->count() - _pkt_first);
     }
     else {
         // The requested minimum does not fit into a contiguous area.
-        pkt_cnt = _pkt_cnt;
+        pkt_cnt = cnt;
     }
 
     pkt_first = _pkt_first;
     bitrate = _bitrate;
-    input_end = _input_end && pkt_cnt == _pkt_cnt;
+    input_end = end && pkt_cnt == cnt;
 
     // Force to abort our processor when the next one is aborting.
     // Don't do that if current is output and next is input because
     // there is no propagation of packets from output back to input.
-    aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
+    aborted = plugin()->type() != PluginType::OUTPUT && ringNext<PluginExecutor>()->_tsp_aborting;
+}
 
-    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
-        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+
+//----------------------------------------------------------------------------
+// Wait for packets to process or some error condition, lock-free mode.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::waitWorkLockFree(size_t min_pkt_cnt, bool& timeout)
+{
+    PluginExecutor* next = ringNext<PluginExecutor>();
+
+    // Spin a little while, hoping that the previous plugin will soon pass packets.
+    size_t spin = 0;
+    while (_pkt_cnt < min_pkt_cnt && !_input_end && !_restart && !next->_tsp_aborting) {
+        if (spin >= _spin_limit) {
+            break;
+        }
+        CpuRelax();
+        spin++;
+    }
+
+    // Adapt the spin limit: spin longer next time if spinning was useful, shorter otherwise.
+    if (_pkt_cnt >= min_pkt_cnt || _input_end || _restart || next->_tsp_aborting) {
+        if (spin > 0) {
+            _spin_limit = std::min<size_t>(2 * _spin_limit, MAX_SPIN_COUNT);
+        }
+        return;
+    }
+    else if (_spin_limit > 0) {
+        _spin_limit = std::max<size_t>(_spin_limit / 2, MIN_SPIN_COUNT);
+    }
+
+    // Nothing yet, go to sleep. Declare that we are sleeping before checking the
+    // condition again. Paired with the fence in wakeUp(): either the previous plugin
+    // sees us sleeping and signals us, or we see its updates here. A pending restart
+    // also wakes us up, it is signalled under _park_mutex by restart().
+    GuardCondition lock(_park_mutex, _to_do);
+    _sleeping = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    while (_pkt_cnt < min_pkt_cnt && !_input_end && !_restart && !timeout && !next->_tsp_aborting) {
+        timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+    }
+
+    _sleeping = false;
 }
 
 
@@ -282,7 +463,7 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
     // Acquire the global mutex to modify global data.
     // To avoid deadlocks, always acquire the global mutex first, then a RestartData mutex.
     {
-        GuardCondition lock1(_global_mutex, _to_do);
+        Guard lock1(_global_mutex);
 
         // If there was a previous pending restart operation, cancel it.
         if (!_restart_data.isNull()) {
@@ -298,7 +479,17 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
         _restart = true;
 
         // Signal the plugin thread that there is something to do.
-        lock1.signal();
+        // In mutex mode, the plugin thread waits on _to_do with the global mutex.
+        if (!_options.lock_free) {
+            _to_do.signal();
+        }
+    }
+
+    // In lock-free mode, the plugin thread waits on _to_do with _park_mutex.
+    // Signal under the same mutex, after setting _restart, so that the wakeup cannot be lost.
+    if (_options.lock_free) {
+        Guard lock(_park_mutex);
+        _to_do.signal();
     }
 
     // Now wait for the restart operation to complete.
@@ -326,6 +517,12 @@ bool ts::tsp::PluginExecutor::pendingRestart()
 
 bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
 {
+    // In lock-free mode, do not take the global mutex on each call when there is obviously no pending restart.
+    if (_options.lock_free && !_restart) {
+        restarted = false;
+        return true;
+    }
+
     // Run under the protection of the global mutex.
     // To avoid deadlocks, always acquire the global mutex first, then a RestartData mutex.
     Guard lock1(_global_mutex);
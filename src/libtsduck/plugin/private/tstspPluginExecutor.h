@@ -42,6 +42,7 @@
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
+#include <atomic>
 
 namespace ts {
     namespace tsp {
@@ -187,6 +188,7 @@ namespace ts {
             //!
             //! @param [in] min_pkt_cnt Minimum number of packets to return. Wait until at least this number
             //! of packets can be returned in @a pkt_cnt (unless it is too large or some error occurs).
+            //! In lock-free mode, less packets, possibly zero, are returned when a restart is pending.
             //! @param [out] pkt_first Index of first packet to process in the buffer.
             //! @param [out] pkt_cnt Number of packets to process in the buffer.
             //! @param [out] bitrate Current bitrate, as computed from previous processors.
@@ -222,13 +224,31 @@ namespace ts {
             // The following private data must be accessed exclusively under the protection of the global mutex.
             // Implementation details: see the file src/docs/developing-plugins.dox.
             // [*] After initialization, these fields are read/written only in passPackets() and waitWork().
-            Condition      _to_do;         // Notify processor to do something.
-            size_t         _pkt_first;     // Starting index of packets area [*]
-            size_t         _pkt_cnt;       // Size of packets area [*]
-            bool           _input_end;     // No more packet after current ones [*]
-            BitRate        _bitrate;       // Input bitrate (set by previous plugin) [*]
-            bool           _restart;       // Restart the plugin asap using _restart_data
-            RestartDataPtr _restart_data;  // How to restart the plugin
+            // [L] In lock-free mode (--lock-free), these fields are accessed without the global mutex:
+            //     _pkt_first is only used by the plugin thread, _pkt_cnt, _input_end and _bitrate are
+            //     atomically updated by the previous plugin thread (producer) and this thread (consumer).
+            Condition            _to_do;         // Notify processor to do something.
+            size_t               _pkt_first;     // Starting index of packets area [*] [L]
+            std::atomic<size_t>  _pkt_cnt;       // Size of packets area [*] [L]
+            std::atomic<bool>    _input_end;     // No more packet after current ones [*] [L]
+            std::atomic<BitRate> _bitrate;       // Input bitrate (set by previous plugin) [*] [L]
+            std::atomic<bool>    _restart;       // Restart the plugin asap using _restart_data [L]
+            RestartDataPtr       _restart_data;  // How to restart the plugin
+
+            // Waiting state in lock-free mode. The thread spins a little while before sleeping on _to_do.
+            // The spin limit adapts itself: it grows when spinning was useful, it shrinks otherwise.
+            Mutex                _park_mutex;    // Protect sleeping on _to_do in lock-free mode.
+            std::atomic<bool>    _sleeping;      // The plugin thread is sleeping or about to sleep on _to_do.
+            size_t               _spin_limit;    // Current max number of spin iterations before sleeping.
+
+            // Implementation of passPackets() and waitWork() in both modes.
+            bool passPacketsLocked(size_t count, BitRate bitrate, bool input_end, bool aborted);
+            bool passPacketsLockFree(size_t count, BitRate bitrate, bool input_end, bool aborted);
+            void waitWorkLockFree(size_t min_pkt_cnt, bool& timeout);
+            void getWork(size_t min_pkt_cnt, bool timeout, size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted);
+
+            // Wake up the plugin thread when it waits for something to do.
+            void wakeUp();
 
             // Description of a restart operation.
             class RestartData
@@ -42,7 +42,8 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
                                                              const UString& description,
                                                              const UString& syntax,
                                                              const UString& system_time_name,
-                                                             const UString& system_time_description) :
+                                                             const UString& system_time_description,
+                                                             size_t max_datagrams) :
     InputPlugin(tsp_, description, syntax),
     _eval_time(0),
     _display_time(0),
@@ -56,11 +57,16 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
     _packets_0(0),
     _start_1(Time::Epoch),
     _packets_1(0),
+    _datagram_size(std::max(buffer_size, 7 * PKT_SIZE)),
+    _max_datagrams(std::max<size_t>(max_datagrams, 1)),
     _inbuf_count(0),
     _inbuf_next(0),
     _mdata_next(0),
-    _inbuf(std::max(buffer_size, 7 * PKT_SIZE)),
-    _mdata(_inbuf.size() / PKT_SIZE)
+    _inbuf(_datagram_size * _max_datagrams),
+    _mdata(_inbuf.size() / PKT_SIZE),
+    _dg_sizes(_max_datagrams),
+    _dg_timestamps(_max_datagrams),
+    _dg_sources(_max_datagrams)
 {
     option(u"display-interval", 'd', POSITIVE);
     help(u"display-interval",
@@ -163,79 +169,24 @@ ts::BitRate ts::AbstractDatagramInputPlugin::getBitrate()
 
 size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
 {
-    MicroSecond timestamp = -1;
-
     // Check if we receive new packets or process remain of previous buffer.
-    bool new_packets = false;
+    const bool new_packets = _inbuf_count == 0;
 
-    // If there is no remaining packet in the input buffer, wait for a datagram message.
+    // If there is no remaining packet in the input buffer, wait for datagram messages.
     // Loop until we get some TS packets.
     while (_inbuf_count == 0) {
 
-        // Wait for a datagram message
-        size_t insize = 0;
-        if (!receiveDatagram(_inbuf.data(), _inbuf.size(), insize, timestamp)) {
+        // Wait for one or more datagram messages.
+        size_t dg_count = 0;
+        if (!receiveDatagrams(_inbuf.data(), _datagram_size, _max_datagrams, dg_count, _dg_sizes.data(), _dg_timestamps.data(), _dg_sources.data())) {
             return 0;
         }
 
-        // Look for TS packets in the UDP message.
-        new_packets = TSPacket::Locate(_inbuf.data(), insize, _inbuf_next, _inbuf_count);
-
-        if (new_packets) {
-
-            // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
-            // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
-            const bool rtp = _inbuf_next >= RTP_HEADER_SIZE && (_inbuf[1] & 0x7F) == RTP_PT_MP2T;
-            const uint32_t rtp_timestamp = rtp ? GetUInt32(_inbuf.data() + 4) : 0;
-
-            // Use RTP time stamp if there is one and RTP is the preferred choice.
-            bool use_rtp = false;
-            bool use_kernel = false;
-            switch (_time_priority) {
-                case RTP_SYSTEM_TSP:
-                    use_rtp = rtp;
-                    use_kernel = !rtp && timestamp >= 0;
-                    break;
-                case SYSTEM_RTP_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = !use_kernel && rtp;
-                    break;
-                case RTP_TSP:
-                    use_rtp = rtp;
-                    use_kernel = false;
-                    break;
-                case SYSTEM_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = false;
-                    break;
-                case TSP_ONLY:
-                default:
-                    use_rtp = false;
-                    use_kernel = false;
-                    break;
-            }
-
-            // Build time stamps in packet metadata.
-            _mdata_next = 0;
-            for (size_t i = 0; i < _inbuf_count; ++i) {
-                if (use_rtp) {
-                    // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
-                    _mdata[i].setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
-                }
-                else if (use_kernel) {
-                    // IP time stamp unit is microseconds.
-                    _mdata[i].setInputTimeStamp(uint64_t(timestamp), MicroSecPerSec, TimeSource::KERNEL);
-                }
-                else {
-                    _mdata[i].clearInputTimeStamp();
-                }
-            }
-
-            break; // found packets.
+        // Look for TS packets in all UDP messages and pack them at the beginning of the input buffer.
+        _inbuf_next = _mdata_next = 0;
+        for (size_t i = 0; i < dg_count && i < _max_datagrams; ++i) {
+            processDatagram(_inbuf.data() + i * _datagram_size, _dg_sizes[i], _dg_timestamps[i], _dg_sources[i]);
         }
-
-        // No TS packet found in UDP message, wait for another one.
-        tsp->debug(u"no TS packet in message, %s bytes", {insize});
     }
 
     // If new packets were received, we may need to re-evaluate the real-time input bitrate.
@@ -288,3 +239,95 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
 
     return pkt_cnt;
 }
+
+
+//----------------------------------------------------------------------------
+// Default implementation of multiple datagrams reception.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramInputPlugin::receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], NanoSecond timestamps[], TimeSource sources[])
+{
+    ret_count = 0;
+    MicroSecond timestamp = -1;
+    if (max_count == 0 || !receiveDatagram(buffer, buffer_size, ret_sizes[0], timestamp)) {
+        return false;
+    }
+    ret_count = 1;
+    timestamps[0] = timestamp < 0 ? -1 : timestamp * NanoSecPerMicroSec;
+    sources[0] = TimeSource::KERNEL;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Locate TS packets in a received datagram, move them after the previous
+// ones in the input buffer and build their metadata.
+//----------------------------------------------------------------------------
+
+void ts::AbstractDatagramInputPlugin::processDatagram(const uint8_t* datagram, size_t size, NanoSecond timestamp, TimeSource source)
+{
+    // Look for TS packets in the UDP message.
+    size_t start = 0;
+    size_t count = 0;
+    if (!TSPacket::Locate(datagram, size, start, count)) {
+        // No TS packet found in UDP message.
+        tsp->debug(u"no TS packet in message, %s bytes", {size});
+        return;
+    }
+
+    // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
+    // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
+    const bool rtp = start >= RTP_HEADER_SIZE && (datagram[1] & 0x7F) == RTP_PT_MP2T;
+    const uint32_t rtp_timestamp = rtp ? GetUInt32(datagram + 4) : 0;
+
+    // Use RTP time stamp if there is one and RTP is the preferred choice.
+    bool use_rtp = false;
+    bool use_kernel = false;
+    switch (_time_priority) {
+        case RTP_SYSTEM_TSP:
+            use_rtp = rtp;
+            use_kernel = !rtp && timestamp >= 0;
+            break;
+        case SYSTEM_RTP_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = !use_kernel && rtp;
+            break;
+        case RTP_TSP:
+            use_rtp = rtp;
+            use_kernel = false;
+            break;
+        case SYSTEM_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = false;
+            break;
+        case TSP_ONLY:
+        default:
+            use_rtp = false;
+            use_kernel = false;
+            break;
+    }
+
+    // Build time stamps in packet metadata.
+    for (size_t i = 0; i < count; ++i) {
+        TSPacketMetadata& mdata(_mdata[_inbuf_count + i]);
+        if (use_rtp) {
+            // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
+            mdata.setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
+        }
+        else if (use_kernel) {
+            // System time stamp unit is nanoseconds.
+            mdata.setInputTimeStamp(uint64_t(timestamp), NanoSecPerSec, source);
+        }
+        else {
+            mdata.clearInputTimeStamp();
+        }
+    }
+
+    // Move the TS packets after the previous ones. The destination area is always
+    // before the datagram in the input buffer, but the two areas may overlap.
+    uint8_t* const dest = _inbuf.data() + _inbuf_count * PKT_SIZE;
+    if (dest != datagram + start) {
+        ::memmove(dest, datagram + start, count * PKT_SIZE);
+    }
+    _inbuf_count += count;
+}
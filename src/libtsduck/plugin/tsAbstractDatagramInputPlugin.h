@@ -68,13 +68,16 @@ namespace ts {
         //! @param [in] system_time_name When the subclass provides timestamps, this is a lowercase name
         //! which is used in option -\-timestamp-priority. When empty, there is no timestamps from the subclass.
         //! @param [in] system_time_description Description of @a system_time_name for help text.
+        //! @param [in] max_datagrams Maximum number of datagrams which can be received at once
+        //! by receiveDatagrams(). The input buffer contains that number of datagram buffers.
         //!
         AbstractDatagramInputPlugin(TSP* tsp,
                                     size_t buffer_size,
                                     const UString& description = UString(),
                                     const UString& syntax = UString(),
                                     const UString& system_time_name = UString(),
-                                    const UString& system_time_description = UString());
+                                    const UString& system_time_description = UString(),
+                                    size_t max_datagrams = 1);
 
         //!
         //! Receive a datagram message.
@@ -87,6 +90,25 @@ namespace ts {
         //!
         virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) = 0;
 
+        //!
+        //! Receive several datagram messages, as many as immediately available.
+        //! The default implementation receives one datagram using receiveDatagram().
+        //! Subclasses may provide a more efficient implementation.
+        //! @param [out] buffer Address of the buffer for the received messages.
+        //! This buffer is made of @a max_count consecutive datagram buffers of @a buffer_size bytes.
+        //! @param [in] buffer_size Size in bytes of each datagram buffer.
+        //! @param [in] max_count Maximum number of datagrams to receive, never zero.
+        //! @param [out] ret_count Number of used datagram buffers, at least one on success.
+        //! @param [out] ret_sizes Array of @a max_count sizes. Upon return, the first @a ret_count
+        //! entries contain the size of the message in each datagram buffer, possibly zero.
+        //! @param [out] timestamps Array of @a max_count timestamps. Upon return, the first @a ret_count
+        //! entries contain the receive timestamp of each datagram in nano-seconds or -1 if not available.
+        //! @param [out] sources Array of @a max_count time sources. Upon return, the first @a ret_count
+        //! entries contain the source of the corresponding timestamps.
+        //! @return True on success, false on error.
+        //!
+        virtual bool receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], NanoSecond timestamps[], TimeSource sources[]);
+
     private:
         // Order of priority for input timestamps. SYSTEM means lower layer from subclass (UDP, SRT, etc).
         enum TimePriority {RTP_SYSTEM_TSP, SYSTEM_RTP_TSP, RTP_TSP, SYSTEM_TSP, TSP_ONLY};
@@ -103,10 +125,18 @@ namespace ts {
         PacketCounter _packets_0;             // Number of received packets since _start_0
         Time          _start_1;               // Start of previous bitrate evaluation period
         PacketCounter _packets_1;             // Number of received packets since _start_1
+        size_t        _datagram_size;         // Size of each datagram buffer in _inbuf
+        size_t        _max_datagrams;         // Number of datagram buffers in _inbuf
         size_t        _inbuf_count;           // Number of remaining TS packets in inbuf
         size_t        _inbuf_next;            // Byte index in _inbuf of next TS packet to return
         size_t        _mdata_next;            // Index in _mdata of next TS packet metadata to return
         ByteBlock     _inbuf;                 // Input buffer
         TSPacketMetadataVector _mdata;        // Metadata for packets in _inbuf
+        std::vector<size_t>      _dg_sizes;      // Sizes of received datagrams
+        std::vector<NanoSecond>  _dg_timestamps; // Timestamps of received datagrams
+        std::vector<TimeSource>  _dg_sources;    // Sources of timestamps of received datagrams
+
+        // Locate TS packets in a received datagram, move them after the previous ones and build their metadata.
+        void processDatagram(const uint8_t* datagram, size_t size, NanoSecond timestamp, TimeSource source);
     };
 }
@@ -38,6 +38,7 @@
 #include "tsSection.h"
 #include "tsServiceDiscovery.h"
 #include "tsTSScrambling.h"
+#include "tsTSScramblingBatch.h"
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
@@ -61,6 +62,8 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     protected:
@@ -270,6 +273,7 @@ namespace ts {
         ServiceDiscovery   _service;           // Service to descramble (by name, id or none).
         size_t             _stack_usage;       // Stack usage for ECM deciphering.
         SectionDemux       _demux;             // Section demux to extract ECM's.
+        TSScramblingBatch  _batch;             // Packets to descramble at once in processPacketWindow().
         ECMStreamMap       _ecm_streams;       // ECM streams, indexed by PID.
         ScrambledStreamMap _scrambled_streams; // Scrambled streams, indexed by PID.
         Mutex              _mutex;             // Exclusive access to protected areas
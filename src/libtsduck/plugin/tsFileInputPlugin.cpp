@@ -47,6 +47,7 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
     _aborted(true),
     _interleave(false),
     _first_terminate(false),
+    _memory_map(false),
     _interleave_chunk(0),
     _interleave_remain(0),
     _current_filename(0),
@@ -122,6 +123,13 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
          u"For a given file, if the computed label is above the maximum (" +
          UString::Decimal(TSPacketMetadata::LABEL_MAX) + u"), its packets are not labelled.");
 
+    option(u"memory-map", 'm');
+    help(u"memory-map",
+         u"Read regular files through a memory mapping instead of read system calls. "
+         u"This may be more efficient on large files. "
+         u"The size of each file is sampled when the file is opened. "
+         u"Therefore, do not use this option on files which are still being written.");
+
     option(u"packet-offset", 'p', UNSIGNED);
     help(u"packet-offset",
          u"Start reading each file at the specified TS packet (default: 0). "
@@ -146,6 +154,7 @@ bool ts::FileInputPlugin::getOptions()
     _start_offset = intValue<uint64_t>(u"byte-offset", intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE);
     _interleave = present(u"interleave");
     _first_terminate = present(u"first-terminate");
+    _memory_map = present(u"memory-map");
     getIntValue(_interleave_chunk, u"interleave", 1);
     getIntValue(_base_label, u"label-base", TSPacketMetadata::LABEL_MAX + 1);
     getIntValue(_file_format, u"format", TSPacketFormat::AUTODETECT);
@@ -195,8 +204,9 @@ bool ts::FileInputPlugin::openFile(size_t name_index, size_t file_index)
         tsp->verbose(u"reading file %s", {name.empty() ? u"'stdin'" : name});
     }
 
-    // Preset artificial stuffing.
+    // Preset artificial stuffing and memory mapping.
     _files[file_index].setStuffing(_start_stuffing[name_index], _stop_stuffing[name_index]);
+    _files[file_index].setMemoryMapped(_memory_map);
 
     // Actually open the file.
     return _files[file_index].openRead(name, _repeat_count, _start_offset, *tsp, _file_format);
@@ -67,6 +67,7 @@ namespace ts {
         volatile bool  _aborted;            // Set when abortInput() is set.
         bool           _interleave;         // Read all files simultaneously with interleaving.
         bool           _first_terminate;    // With _interleave, terminate when the first file terminates.
+        bool           _memory_map;         // Read regular files through a memory mapping.
         size_t         _interleave_chunk;   // Number of packets per chunk when _interleave.
         size_t         _interleave_remain;  // Remaining packets to read in current chunk of current file.
         size_t         _current_filename;   // Current file index in _filenames.
@@ -31,6 +31,9 @@
 #include "tsPluginRepository.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
+#include "tsGuard.h"
+#include "tsGuardCondition.h"
+#include "tsMonotonic.h"
 TSDUCK_SOURCE;
 
 TS_REGISTER_OUTPUT_PLUGIN(u"file", ts::FileOutputPlugin);
@@ -39,6 +42,8 @@ TS_REGISTER_OUTPUT_PLUGIN(u"file", ts::FileOutputPlugin);
 const int ts::FileOutputPlugin::REFERENCE = 0;
 
 #define DEF_RETRY_INTERVAL 2000 // milliseconds
+#define DEF_QUEUE_DEPTH      16 // buffers in asynchronous mode
+#define BUFFER_PACKETS     2048 // packets per buffer in asynchronous mode, multiple of 1024 for direct I/O alignment
 
 
 //----------------------------------------------------------------------------
@@ -55,7 +60,31 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     _retry_max(0),
     _start_stuffing(0),
     _stop_stuffing(0),
-    _file()
+    _async(false),
+    _queue_depth(DEF_QUEUE_DEPTH),
+    _file(),
+    _writer(this),
+    _mutex(),
+    _queued(),
+    _written(),
+    _buffers_mem(),
+    _buffers(nullptr),
+    _buffers_mdata(),
+    _buffers_count(),
+    _fill_index(0),
+    _fill_count(0),
+    _queue_first(0),
+    _queue_count(0),
+    _terminate(false),
+    _write_error(false),
+    _stat_buffers(0),
+    _stat_direct(0),
+    _stat_max_queue(0),
+    _stat_waits(0),
+    _stat_wait_time(0),
+    _stat_write_min(0),
+    _stat_write_max(0),
+    _stat_write_total(0)
 {
     option(u"", 0, STRING, 0, 1);
     help(u"", u"Name of the created output file. Use standard output by default.");
@@ -73,6 +102,19 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     option(u"append", 'a');
     help(u"append", u"If the file already exists, append to the end of the file. By default, existing files are overwritten.");
 
+    option(u"asynchronous");
+    help(u"asynchronous",
+         u"Write the file from a dedicated internal thread. "
+         u"The packets are staged into a queue of buffers and the other plugins are not "
+         u"blocked when the file system is slow to write. See also option --queue-depth.");
+
+    option(u"direct-io");
+    help(u"direct-io",
+         u"Write the file using direct I/O, bypassing the system cache, when the operating "
+         u"system and the file system support it. This option implies --asynchronous. "
+         u"Direct I/O is used with the standard TS format only. "
+         u"The last partial buffer at end of stream is written using standard cached I/O.");
+
     option(u"format", 0, TSPacketFormatEnum);
     help(u"format", u"name",
          u"Specify the format of the created file. "
@@ -94,6 +136,13 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
          u"attempting to reopen the file after a failure. The default is " +
          UString::Decimal(DEF_RETRY_INTERVAL) + u" milliseconds.");
 
+    option(u"queue-depth", 0, INTEGER, 0, 1, 2, UNLIMITED_VALUE);
+    help(u"queue-depth", u"count",
+         u"With --asynchronous, specify the number of buffers in the queue to the writer thread. "
+         u"Each buffer contains " + UString::Decimal(BUFFER_PACKETS) + u" TS packets. "
+         u"The default is " + UString::Decimal(DEF_QUEUE_DEPTH) + u" buffers. "
+         u"When the queue is full, the previous plugins wait for a free buffer.");
+
     option(u"max-retry", 0, UINT32);
     help(u"max-retry",
          u"With --reopen-on-error, specify the maximum number of times the file is reopened on error. "
@@ -101,6 +150,22 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
 }
 
 
+ts::FileOutputPlugin::~FileOutputPlugin()
+{
+    _writer.waitForTermination();
+}
+
+ts::FileOutputPlugin::Writer::Writer(FileOutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::FileOutputPlugin::Writer::~Writer()
+{
+    waitForTermination();
+}
+
+
 //----------------------------------------------------------------------------
 // Output plugin methods
 //----------------------------------------------------------------------------
@@ -115,6 +180,11 @@ bool ts::FileOutputPlugin::getOptions()
     if (present(u"keep")) {
         _flags |= TSFile::KEEP;
     }
+    if (present(u"direct-io")) {
+        _flags |= TSFile::DIRECT;
+    }
+    _async = present(u"asynchronous") || present(u"direct-io");
+    getIntValue(_queue_depth, u"queue-depth", DEF_QUEUE_DEPTH);
     _reopen = present(u"reopen-on-error");
     getIntValue(_retry_max, u"max-retry", 0);
     getIntValue(_retry_interval, u"retry-interval", DEF_RETRY_INTERVAL);
@@ -128,15 +198,190 @@ bool ts::FileOutputPlugin::start()
 {
     _file.setStuffing(_start_stuffing, _stop_stuffing);
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
-    return openAndRetry(false, retry_allowed);
+    if (!openAndRetry(false, retry_allowed)) {
+        return false;
+    }
+
+    if (_async) {
+        // Allocate the buffers. The packet buffers are aligned for direct I/O.
+        const size_t buffer_size = BUFFER_PACKETS * PKT_SIZE;
+        _buffers_mem.resize(_queue_depth * buffer_size + TSFile::DIRECT_IO_ALIGNMENT);
+        uint8_t* base = _buffers_mem.data();
+        base += (TSFile::DIRECT_IO_ALIGNMENT - reinterpret_cast<size_t>(base) % TSFile::DIRECT_IO_ALIGNMENT) % TSFile::DIRECT_IO_ALIGNMENT;
+        _buffers = reinterpret_cast<TSPacket*>(base);
+        _buffers_mdata.resize(_file_format == TSPacketFormat::TS ? 0 : _queue_depth * BUFFER_PACKETS);
+        _buffers_count.resize(_queue_depth);
+
+        // Reset the queue state and statistics.
+        _fill_index = _fill_count = _queue_first = _queue_count = 0;
+        _terminate = _write_error = false;
+        _stat_buffers = _stat_direct = _stat_waits = 0;
+        _stat_max_queue = 0;
+        _stat_wait_time = _stat_write_min = _stat_write_max = _stat_write_total = 0;
+
+        // Start the writer thread.
+        _writer.setAttributes(ThreadAttributes().setStackSize(stackUsage()));
+        if (!_writer.start()) {
+            tsp->error(u"cannot start writer thread");
+            _file.close(NULLREP);
+            return false;
+        }
+    }
+    return true;
 }
 
 bool ts::FileOutputPlugin::stop()
 {
-    return _file.close(*tsp);
+    bool success = true;
+
+    if (_async) {
+        // Queue the last partial buffer and let the writer thread terminate after the last buffer.
+        {
+            Guard lock(_mutex);
+            if (_fill_count > 0 && !_write_error) {
+                _buffers_count[_fill_index] = _fill_count;
+                _queue_count++;
+                _fill_count = 0;
+            }
+            _terminate = true;
+            _queued.signal();
+        }
+        _writer.waitForTermination();
+        success = !_write_error;
+
+        // Report statistics.
+        tsp->verbose(u"asynchronous write: %'d buffers, %'d using direct I/O, max queue: %d/%d",
+                     {_stat_buffers, _stat_direct, _stat_max_queue, _queue_depth});
+        if (_stat_buffers > 0) {
+            tsp->verbose(u"buffer write time: min: %'d us, max: %'d us, average: %'d us",
+                         {_stat_write_min / NanoSecPerMicroSec, _stat_write_max / NanoSecPerMicroSec, _stat_write_total / NanoSecPerMicroSec / NanoSecond(_stat_buffers)});
+        }
+        tsp->verbose(u"waiting for free buffers (back-pressure): %'d times, total: %'d ms", {_stat_waits, _stat_wait_time / NanoSecPerMilliSec});
+    }
+
+    return _file.close(*tsp) && success;
 }
 
 bool ts::FileOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
+{
+    // Synchronous mode, write packets now.
+    if (!_async) {
+        return writeAndRetry(buffer, pkt_data, packet_count);
+    }
+
+    // Asynchronous mode, copy packets into the buffers.
+    while (packet_count > 0) {
+        const size_t count = std::min(packet_count, BUFFER_PACKETS - _fill_count);
+        const size_t first = _fill_index * BUFFER_PACKETS + _fill_count;
+        TSPacket::Copy(_buffers + first, buffer, count);
+        if (!_buffers_mdata.empty() && pkt_data != nullptr) {
+            TSPacketMetadata::Copy(&_buffers_mdata[first], pkt_data, count);
+        }
+        buffer += count;
+        pkt_data += count;
+        packet_count -= count;
+        _fill_count += count;
+        if (_fill_count == BUFFER_PACKETS && !queueBuffer()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Asynchronous mode: queue the buffer being filled, wait for a free buffer.
+//----------------------------------------------------------------------------
+
+bool ts::FileOutputPlugin::queueBuffer()
+{
+    GuardCondition lock(_mutex, _written);
+
+    // Pass the buffer to the writer thread.
+    _buffers_count[_fill_index] = _fill_count;
+    _queue_count++;
+    _stat_max_queue = std::max(_stat_max_queue, _queue_count);
+    _queued.signal();
+
+    // Back-pressure: wait until the writer thread frees the next buffer.
+    if (_queue_count >= _queue_depth && !_write_error) {
+        const Monotonic start(true);
+        while (_queue_count >= _queue_depth && !_write_error) {
+            lock.waitCondition();
+        }
+        _stat_waits++;
+        _stat_wait_time += Monotonic(true) - start;
+    }
+
+    // Fill the next buffer.
+    _fill_index = (_fill_index + 1) % _queue_depth;
+    _fill_count = 0;
+    return !_write_error;
+}
+
+
+//----------------------------------------------------------------------------
+// Asynchronous mode: writer thread.
+//----------------------------------------------------------------------------
+
+void ts::FileOutputPlugin::Writer::main()
+{
+    _plugin->tsp->debug(u"file writer thread started");
+
+    for (;;) {
+        size_t index = 0;
+        size_t count = 0;
+
+        // Wait for a buffer to write.
+        {
+            GuardCondition lock(_plugin->_mutex, _plugin->_queued);
+            while (_plugin->_queue_count == 0 && !_plugin->_terminate) {
+                lock.waitCondition();
+            }
+            if (_plugin->_queue_count == 0) {
+                break; // termination requested and nothing more to write
+            }
+            index = _plugin->_queue_first;
+            count = _plugin->_buffers_count[index];
+        }
+
+        // Write the buffer without holding the mutex.
+        const Monotonic start(true);
+        const bool success = _plugin->writeAndRetry(_plugin->_buffers + index * BUFFER_PACKETS,
+                                                    _plugin->_buffers_mdata.empty() ? nullptr : &_plugin->_buffers_mdata[index * BUFFER_PACKETS],
+                                                    count);
+        const NanoSecond duration = Monotonic(true) - start;
+        const bool direct = _plugin->_file.isDirectIO();
+
+        // Release the buffer.
+        {
+            GuardCondition lock(_plugin->_mutex, _plugin->_written);
+            _plugin->_queue_first = (index + 1) % _plugin->_queue_depth;
+            _plugin->_queue_count--;
+            _plugin->_stat_write_min = _plugin->_stat_buffers == 0 ? duration : std::min(_plugin->_stat_write_min, duration);
+            _plugin->_stat_write_max = std::max(_plugin->_stat_write_max, duration);
+            _plugin->_stat_write_total += duration;
+            _plugin->_stat_buffers++;
+            if (direct) {
+                _plugin->_stat_direct++;
+            }
+            _plugin->_write_error = !success;
+            lock.signal();
+        }
+        if (!success) {
+            break;
+        }
+    }
+
+    _plugin->tsp->debug(u"file writer thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Write packets in the file, reopen and retry on error if necessary.
+//----------------------------------------------------------------------------
+
+bool ts::FileOutputPlugin::writeAndRetry(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
 {
     // Total number of retries.
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
@@ -35,6 +35,10 @@
 #pragma once
 #include "tsOutputPlugin.h"
 #include "tsTSFile.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -51,6 +55,11 @@ namespace ts {
         //!
         FileOutputPlugin(TSP* tsp);
 
+        //!
+        //! Destructor.
+        //!
+        virtual ~FileOutputPlugin() override;
+
         // Implementation of plugin API
         virtual bool getOptions() override;
         virtual bool start() override;
@@ -63,6 +72,19 @@ namespace ts {
         //! @endcond
 
     private:
+        // Internal thread which writes the file in asynchronous mode.
+        class Writer : public Thread
+        {
+            TS_NOBUILD_NOCOPY(Writer);
+        public:
+            Writer(FileOutputPlugin* plugin);
+            virtual ~Writer() override;
+            virtual void main() override;
+        private:
+            FileOutputPlugin* _plugin;
+        };
+
+        // Command line options.
         UString           _name;
         TSFile::OpenFlags _flags;
         TSPacketFormat    _file_format;
@@ -71,10 +93,45 @@ namespace ts {
         size_t            _retry_max;
         size_t            _start_stuffing;
         size_t            _stop_stuffing;
+        bool              _async;           // Write the file from an internal thread.
+        size_t            _queue_depth;     // Number of buffers in asynchronous mode.
         TSFile            _file;
 
+        // Asynchronous mode. The buffer being filled is private to the plugin thread.
+        // All other buffers are either free or queued for the writer thread.
+        Writer                 _writer;
+        Mutex                  _mutex;          // Protect the queue state.
+        Condition              _queued;         // Signaled when a buffer is queued.
+        Condition              _written;        // Signaled when a buffer is written.
+        ByteBlock              _buffers_mem;    // Memory for all buffers, including alignment.
+        TSPacket*              _buffers;        // Base of all packet buffers, aligned for direct I/O.
+        TSPacketMetadataVector _buffers_mdata;  // Packet metadata for all buffers.
+        std::vector<size_t>    _buffers_count;  // Number of packets in each queued buffer.
+        size_t                 _fill_index;     // Index of buffer being filled.
+        size_t                 _fill_count;     // Number of packets in buffer being filled.
+        size_t                 _queue_first;    // Index of first queued buffer, being written.
+        size_t                 _queue_count;    // Number of queued buffers.
+        bool                   _terminate;      // Writer thread shall terminate when the queue is empty.
+        bool                   _write_error;    // Writer thread has terminated on error.
+
+        // Asynchronous mode statistics, protected by _mutex.
+        uint64_t               _stat_buffers;     // Number of written buffers.
+        uint64_t               _stat_direct;      // Number of buffers written using direct I/O.
+        size_t                 _stat_max_queue;   // Maximum number of queued buffers.
+        uint64_t               _stat_waits;       // Number of times the plugin thread waited for a free buffer.
+        NanoSecond             _stat_wait_time;   // Total time spent waiting for a free buffer.
+        NanoSecond             _stat_write_min;   // Minimum write time of a buffer.
+        NanoSecond             _stat_write_max;   // Maximum write time of a buffer.
+        NanoSecond             _stat_write_total; // Total write time of all buffers.
+
         // Open the file, retry on error if necessary.
         // Use max number of retries. Updated with remaining number of retries.
         bool openAndRetry(bool initial_wait, size_t& retry_allowed);
+
+        // Write packets in the file, reopen and retry on error if necessary.
+        bool writeAndRetry(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count);
+
+        // Asynchronous mode: queue the buffer being filled, wait for a free buffer.
+        bool queueBuffer();
     };
 }
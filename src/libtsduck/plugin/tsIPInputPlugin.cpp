@@ -38,6 +38,9 @@ TS_REGISTER_INPUT_PLUGIN(u"ip", ts::IPInputPlugin);
 // A dummy storage value to force inclusion of this module when using the static library.
 const int ts::IPInputPlugin::REFERENCE = 0;
 
+// Maximum number of UDP datagrams which are received with one system call.
+#define MAX_DATAGRAM_BATCH 32
+
 
 //----------------------------------------------------------------------------
 // Input constructor
@@ -45,8 +48,10 @@ const int ts::IPInputPlugin::REFERENCE = 0;
 
 ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
     AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE, u"Receive TS packets from UDP/IP, multicast or unicast", u"[options] [address:]port",
-                                u"kernel", u"A kernel-provided time-stamp for the packet, when available (Linux only)"),
-    _sock(*tsp_)
+                                u"kernel", u"A kernel-provided time-stamp for the packet or a raw time-stamp from the PTP hardware clock of the network interface, when available (Linux only)",
+                                MAX_DATAGRAM_BATCH),
+    _sock(*tsp_),
+    _messages()
 {
     // Add UDP receiver common options.
     _sock.defineArgs(*this);
@@ -121,3 +126,30 @@ bool ts::IPInputPlugin::receiveDatagram(void* buffer, size_t buffer_size, size_t
     SocketAddress destination;
     return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *tsp, &timestamp);
 }
+
+
+//----------------------------------------------------------------------------
+// Multiple datagrams reception method.
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], NanoSecond timestamps[], TimeSource sources[])
+{
+    ret_count = 0;
+    if (!_sock.receiveBatch(buffer, buffer_size, max_count, _messages, tsp, *tsp)) {
+        return false;
+    }
+
+    // Some datagram buffers may be unused when messages were filtered out.
+    for (size_t i = 0; i < _messages.size(); ++i) {
+        const UDPSocket::ReceivedMessage& msg(_messages[i]);
+        while (ret_count < msg.index) {
+            ret_sizes[ret_count] = 0;
+            timestamps[ret_count] = -1;
+            sources[ret_count++] = TimeSource::UNDEFINED;
+        }
+        ret_sizes[ret_count] = msg.size;
+        timestamps[ret_count] = msg.timestamp;
+        sources[ret_count++] = msg.hw_timestamp ? TimeSource::PHC : TimeSource::KERNEL;
+    }
+    return true;
+}
@@ -66,8 +66,10 @@ namespace ts {
     protected:
         // Implementation of AbstractDatagramInputPlugin.
         virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
+        virtual bool receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], NanoSecond timestamps[], TimeSource sources[]) override;
 
     private:
-        UDPReceiver _sock; // Incoming socket with associated command line options.
+        UDPReceiver                      _sock;      // Incoming socket with associated command line options.
+        UDPSocket::ReceivedMessageVector _messages;  // Description of received messages in a batch.
     };
 }
@@ -42,6 +42,9 @@ const int ts::IPOutputPlugin::REFERENCE = 0;
 #define DEF_PACKET_BURST    7  // 1316 B, fits (with headers) in Ethernet MTU
 #define MAX_PACKET_BURST  128  // ~ 48 kB
 
+// Maximum number of UDP datagrams which are sent with one system call.
+#define MAX_DATAGRAM_BATCH 64
+
 
 //----------------------------------------------------------------------------
 // Output constructor
@@ -73,7 +76,13 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
     _pkt_count(0),
     _sock(false, *tsp_),
     _out_count(0),
-    _out_buffer()
+    _out_buffer(),
+    _batch_count(0),
+    _batch_data(MAX_DATAGRAM_BATCH),
+    _batch_sizes(MAX_DATAGRAM_BATCH),
+    _rtp_buffer(),
+    _pacing(false),
+    _pacer(tsp_)
 {
     option(u"", 0, STRING, 1, 1);
     help(u"",
@@ -125,10 +134,30 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
         u"With --rtp, specify the payload type. "
         u"By default, use " + UString::Decimal(RTP_PT_MP2T) + u", the standard RTP type for MPEG2-TS.");
 
+    option(u"pacing", 0, Enumeration({
+        {u"bitrate", int(PacketPacer::Mode::BITRATE)},
+        {u"pcr",     int(PacketPacer::Mode::PCR)},
+    }), 0, 1, true);
+    help(u"pacing", u"name",
+         u"Send each UDP datagram at a precise time, instead of sending datagrams as soon as they are received "
+         u"from the previous plugin. The optional value specifies the time reference. "
+         u"With \"bitrate\" (the default), the datagrams are evenly spread according to the bitrate of the stream. "
+         u"With \"pcr\", the time of each datagram is computed from the PCR's of a reference PID (see option --pcr-pid). "
+         u"The precision is typically better than 100 microseconds: each datagram is sent after a sleep on an absolute time, "
+         u"followed by a short active wait which uses some CPU. "
+         u"Unlike the plugin \"regulate\", the datagrams are not sent in bursts. "
+         u"Statistics on the achieved inter-datagram jitter are reported at the end in verbose mode.");
+
+    option(u"pacing-bitrate", 0, POSITIVE);
+    help(u"pacing-bitrate",
+         u"With --pacing, specify the bitrate of the output stream. "
+         u"By default, use the bitrate of the stream as reported by the previous plugins. "
+         u"With --pacing=pcr, this bitrate is used only until two PCR's are found.");
+
     option(u"pcr-pid", 0, PIDVAL);
     help(u"pcr-pid",
-        u"With --rtp, specify the PID containing the PCR's which are used as reference for RTP timestamps. "
-        u"By default, use the first PID containing PCR's.");
+        u"With --rtp or --pacing=pcr, specify the PID containing the PCR's which are used as reference "
+        u"for RTP timestamps or pacing. By default, use the first PID containing PCR's.");
 
     option(u"start-sequence-number", 0, UINT16);
     help(u"start-sequence-number",
@@ -173,6 +202,10 @@ bool ts::IPOutputPlugin::getOptions()
     _rtp_fixed_ssrc = present(u"ssrc-identifier");
     _rtp_user_ssrc = intValue<uint32_t>(u"ssrc-identifier");
     _pcr_user_pid = intValue<PID>(u"pcr-pid", PID_NULL);
+    _pacing = present(u"pacing");
+    _pacer.setMode(intValue<PacketPacer::Mode>(u"pacing", PacketPacer::Mode::BITRATE));
+    _pacer.setBitRate(intValue<BitRate>(u"pacing-bitrate", 0));
+    _pacer.setReferencePID(_pcr_user_pid);
     return true;
 }
 
@@ -206,6 +239,12 @@ bool ts::IPOutputPlugin::start()
         _out_count = 0;
     }
 
+    // The batch of datagrams is empty.
+    _batch_count = 0;
+    if (_use_rtp) {
+        _rtp_buffer.resize(MAX_DATAGRAM_BATCH * (RTP_HEADER_SIZE + _pkt_burst * PKT_SIZE));
+    }
+
     // Initialize RTP parameters.
     if (_use_rtp) {
         // Use a system PRNG. This type of RNG does not need to be seeded.
@@ -233,6 +272,7 @@ bool ts::IPOutputPlugin::start()
     _last_rtp_pcr_pkt = 0;
     _rtp_pcr_offset = 0;
     _pkt_count = 0;
+    _pacer.reset();
 
     return true;
 }
@@ -245,6 +285,19 @@ bool ts::IPOutputPlugin::start()
 bool ts::IPOutputPlugin::stop()
 {
     _sock.close(*tsp);
+
+    // Report pacing statistics.
+    if (_pacing && tsp->verbose()) {
+        const SingleDataStatistics<double>& lateness(_pacer.latenessStatistics());
+        const SingleDataStatistics<double>& jitter(_pacer.jitterStatistics());
+        tsp->verbose(u"pacing: %'d datagrams, %d resynchronizations, spin tail: %'d microseconds",
+                     {lateness.count(), _pacer.resyncCount(), _pacer.spinDuration() / NanoSecPerMicroSec});
+        if (jitter.count() > 0) {
+            tsp->verbose(u"pacing: lateness: mean %s, max %s microseconds; inter-datagram jitter: std dev %s, min %s, max %s microseconds",
+                         {lateness.meanString(), UString::Float(lateness.maximum(), 0, 2),
+                          jitter.standardDeviationString(), UString::Float(jitter.minimum(), 0, 2), UString::Float(jitter.maximum(), 0, 2)});
+        }
+    }
     return true;
 }
 
@@ -291,6 +344,11 @@ bool ts::IPOutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pkt_d
         packet_count -= count;
     }
 
+    // Send all datagrams at once. This must be done before overwriting the output buffer.
+    if (!flushDatagrams()) {
+        return false;
+    }
+
     // If remaining packets are present, save them in output buffer.
     if (packet_count > 0) {
         assert(_enforce_burst);
@@ -309,7 +367,17 @@ bool ts::IPOutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pkt_d
 
 bool ts::IPOutputPlugin::sendDatagram(const TSPacket* pkt, size_t packet_count)
 {
-    bool status = true;
+    // Send the current batch first if it is full.
+    if (_batch_count >= MAX_DATAGRAM_BATCH && !flushDatagrams()) {
+        return false;
+    }
+
+    // With --pacing, wait for the precise time of the datagram. The datagram is
+    // sent alone, the current batch was flushed after the previous datagram.
+    if (_pacing) {
+        assert(_batch_count == 0);
+        _pacer.pace(pkt, packet_count, tsp->bitrate());
+    }
 
     if (_use_rtp) {
         // RTP datagram are relatively trivial to build, except the time stamp.
@@ -321,14 +389,14 @@ bool ts::IPOutputPlugin::sendDatagram(const TSPacket* pkt, size_t packet_count)
         // Then keep this difference and resynchronize at each PCR.
         // But never jump back in RTP timestamps, only increase "more slowly" when adjusting.
 
-        // Build an RTP datagram. Use a simple RTP header without options nor extensions.
-        ByteBlock buffer(RTP_HEADER_SIZE + packet_count * PKT_SIZE);
+        // Build an RTP datagram in the batch buffer. Use a simple RTP header without options nor extensions.
+        uint8_t* const buffer = _rtp_buffer.data() + _batch_count * (RTP_HEADER_SIZE + _pkt_burst * PKT_SIZE);
 
         // Build the RTP header, except the timestamp.
         buffer[0] = 0x80;             // Version = 2, P = 0, X = 0, CC = 0
         buffer[1] = _rtp_pt & 0x7F;   // M = 0, payload type
-        PutUInt16(&buffer[2], _rtp_sequence++);
-        PutUInt32(&buffer[8], _rtp_ssrc);
+        PutUInt16(buffer + 2, _rtp_sequence++);
+        PutUInt32(buffer + 8, _rtp_ssrc);
 
         // Get current bitrate to compute timestamps.
         const BitRate bitrate = tsp->bitrate();
@@ -391,23 +459,39 @@ bool ts::IPOutputPlugin::sendDatagram(const TSPacket* pkt, size_t packet_count)
         }
 
         // Insert the RTP timestamp in RTP clock units.
-        PutUInt32(&buffer[4], uint32_t((rtp_pcr * RTP_RATE_MP2T) / SYSTEM_CLOCK_FREQ));
+        PutUInt32(buffer + 4, uint32_t((rtp_pcr * RTP_RATE_MP2T) / SYSTEM_CLOCK_FREQ));
 
         // Remember position and value of last datagram.
         _last_rtp_pcr = rtp_pcr;
         _last_rtp_pcr_pkt = _pkt_count;
 
-        // Copy the TS packets after the RTP header and send the packets.
-        ::memcpy(buffer.data() + RTP_HEADER_SIZE, pkt, packet_count * PKT_SIZE);
-        status = _sock.send(buffer.data(), buffer.size(), *tsp);
+        // Copy the TS packets after the RTP header and add the datagram in the batch.
+        ::memcpy(buffer + RTP_HEADER_SIZE, pkt, packet_count * PKT_SIZE);
+        _batch_data[_batch_count] = buffer;
+        _batch_sizes[_batch_count] = RTP_HEADER_SIZE + packet_count * PKT_SIZE;
     }
     else {
         // No RTP, send TS packets directly as datagram.
-        status = _sock.send(pkt, packet_count * PKT_SIZE, *tsp);
+        _batch_data[_batch_count] = pkt;
+        _batch_sizes[_batch_count] = packet_count * PKT_SIZE;
     }
+    _batch_count++;
 
     // Count packets datagram per datagram.
     _pkt_count += packet_count;
 
-    return status;
+    // With --pacing, send each datagram immediately.
+    return !_pacing || flushDatagrams();
+}
+
+
+//----------------------------------------------------------------------------
+// Send all datagrams in the current batch.
+//----------------------------------------------------------------------------
+
+bool ts::IPOutputPlugin::flushDatagrams()
+{
+    const size_t count = _batch_count;
+    _batch_count = 0;
+    return count == 0 || _sock.sendBatch(_batch_data.data(), _batch_sizes.data(), count, *tsp);
 }
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsOutputPlugin.h"
 #include "tsUDPSocket.h"
+#include "tsPacketPacer.h"
 
 namespace ts {
     //!
@@ -89,8 +90,17 @@ namespace ts {
         UDPSocket      _sock;               // Outgoing socket
         size_t         _out_count;          // Number of packets in _out_buffer
         TSPacketVector _out_buffer;         // Buffered packets for output with --enforce-burst
+        size_t         _batch_count;        // Number of datagrams in current batch
+        std::vector<const void*> _batch_data;  // Addresses of datagrams in current batch
+        std::vector<size_t>      _batch_sizes; // Sizes of datagrams in current batch
+        ByteBlock      _rtp_buffer;         // Buffer for RTP datagrams in current batch
+        bool           _pacing;             // Pace datagrams individually.
+        PacketPacer    _pacer;              // Pacing engine.
 
-        // Send contiguous packets in one single datagram.
+        // Prepare contiguous packets in one single datagram, add it to the current batch.
         bool sendDatagram(const TSPacket* pkt, size_t packet_count);
+
+        // Send all datagrams in the current batch.
+        bool flushDatagrams();
     };
 }
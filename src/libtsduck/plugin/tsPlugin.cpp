@@ -47,6 +47,29 @@ ts::Plugin::Plugin(TSP* to_tsp, const UString& description, const UString& synta
     tsp(to_tsp),
     duck(to_tsp)
 {
+    // The thread options are defined in all plugins.
+    option(u"cpu", 0, UNSIGNED, 0, UNLIMITED_COUNT);
+    help(u"cpu", u"cpu1[-cpu2]",
+         u"Run the thread which executes this plugin on the specified CPU's only. "
+         u"Several --cpu options may be specified. "
+         u"By default, the thread may run on all CPU's or on all CPU's of the NUMA node which is specified in the tsp option --numa-node. "
+         u"This option is implemented on Linux only. "
+         u"This is a generic option which is defined in all plugins.");
+
+    option(u"realtime-policy", 0, ThreadAttributes::SchedulingPolicyEnum);
+    help(u"realtime-policy",
+         u"Run the thread which executes this plugin with the specified scheduling policy. "
+         u"The real-time policies \"fifo\" and \"rr\" (round-robin) prevent the thread from being preempted by plugins using the default policy. "
+         u"On Linux, real-time policies require root privileges or the capability CAP_SYS_NICE. "
+         u"On Windows, a real-time policy is implemented as the highest thread priority. "
+         u"This is a generic option which is defined in all plugins.");
+
+    option(u"realtime-priority", 0, POSITIVE);
+    help(u"realtime-priority",
+         u"With --realtime-policy fifo or rr, specify the real-time priority of the thread. "
+         u"The range of valid priorities depends on the system, 1 to 99 on Linux. "
+         u"By default, use the middle of the range. "
+         u"This is a generic option which is defined in all plugins.");
 }
 
 
@@ -72,6 +95,23 @@ void ts::Plugin::resetContext(const DuckContext::SavedArgs& state)
 }
 
 
+//----------------------------------------------------------------------------
+// Apply the thread options of the plugin to the attributes of its thread.
+//----------------------------------------------------------------------------
+
+void ts::Plugin::getThreadOptions(ThreadAttributes& attributes) const
+{
+    if (present(u"cpu")) {
+        std::set<size_t> cpus;
+        getIntValues(cpus, u"cpu");
+        attributes.setAffinity(cpus);
+    }
+    if (present(u"realtime-policy")) {
+        attributes.setSchedulingPolicy(intValue<ThreadAttributes::SchedulingPolicy>(u"realtime-policy", ThreadAttributes::SchedulingPolicy::DEFAULT), intValue<int>(u"realtime-priority", 0));
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Default implementations of virtual methods.
 //----------------------------------------------------------------------------
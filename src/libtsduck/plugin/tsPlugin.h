@@ -39,6 +39,7 @@
 #include "tsTSPacketMetadata.h"
 #include "tsTypedEnumeration.h"
 #include "tsDuckContext.h"
+#include "tsThreadAttributes.h"
 
 namespace ts {
     //!
@@ -175,6 +176,16 @@ namespace ts {
         //!
         void resetContext(const DuckContext::SavedArgs& state);
 
+        //!
+        //! Apply the thread options of the plugin to the attributes of its thread.
+        //! The options --cpu, --realtime-policy and --realtime-priority are defined
+        //! in all plugins. They shall be applied before starting the thread which
+        //! executes the plugin, after analyzing the command line.
+        //! @param [in,out] attributes Attributes of the thread which executes the plugin.
+        //! Only the attributes which are specified on the command line are modified.
+        //!
+        void getThreadOptions(ThreadAttributes& attributes) const;
+
     protected:
         TSP* const  tsp;   //!< The TSP callback structure can be directly accessed by subclasses.
         DuckContext duck;  //!< The TSDuck context with various MPEG/DV features.
@@ -92,9 +92,10 @@ ts::PluginThread::PluginThread(Report* report, const UString& appName, PluginTyp
     // The process should have terminated on argument error.
     assert(_shlib->valid());
 
-    // Define thread stack size
+    // Define thread stack size, CPU affinity and scheduling policy.
     ThreadAttributes attr(attributes);
     attr.setStackSize(STACK_SIZE_OVERHEAD + _shlib->stackUsage());
+    _shlib->getThreadOptions(attr);
     Thread::setAttributes(attr);
 }
 
@@ -170,37 +170,12 @@ size_t ts::PushInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data
 bool ts::PushInputPlugin::pushPackets(const TSPacket* buffer, size_t count)
 {
     // We are executing in the context of the receiver thread.
-    // Send packets by chunks, loop until everything is pushed.
-    while (count > 0) {
-
-        TSPacket* out_buffer = nullptr;
-        size_t out_count = 0;
-
-        // Abort now if the application is terminating.
-        if (tsp->aborting() || _queue.stopped()) {
-            _interrupted = true;
-            return false;
-        }
-
-        // Wait for space in the queue buffer.
-        if (!_queue.lockWriteBuffer(out_buffer, out_count, count)) {
-            return false;
-        }
-
-        assert(out_buffer != nullptr);
-        assert(out_count > 0);
-
-        // Move packets into the queue.
-        if (out_count > count) {
-            out_count = count;
-        }
-        TSPacket::Copy(out_buffer, buffer, out_count);
-        buffer += out_count;
-        count -= out_count;
-
-        // Signal the new packets in the queue.
-        _queue.releaseWriteBuffer(out_count);
+    // Abort now if the application is terminating.
+    if (tsp->aborting() || _queue.stopped()) {
+        _interrupted = true;
+        return false;
     }
 
-    return true;
+    // Copy the packets into the queue, waiting for free space when necessary.
+    return _queue.putPackets(buffer, count);
 }
@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryInputPlugin.h"
+#include "tsPluginRepository.h"
+TSDUCK_SOURCE;
+
+TS_REGISTER_INPUT_PLUGIN(u"shm", ts::SharedMemoryInputPlugin);
+
+// A dummy storage value to force inclusion of this module when using the static library.
+const int ts::SharedMemoryInputPlugin::REFERENCE = 0;
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryInputPlugin::SharedMemoryInputPlugin(TSP* tsp_) :
+    InputPlugin(tsp_, u"Receive TS packets from a shared memory ring, written by another process", u"[options] name"),
+    _name(),
+    _wait_writer(false),
+    _lost(0),
+    _ring()
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"",
+         u"Name of the shared memory ring, as specified in the output plugin \"shm\" of the writer process. "
+         u"The packets which are written after the input plugin is started are received, "
+         u"with their labels and time stamps.");
+
+    option(u"wait-writer", 'w');
+    help(u"wait-writer",
+         u"Wait for the creation of the shared memory ring by the writer process. "
+         u"By default, the input plugin fails when the shared memory ring does not exist.");
+}
+
+
+//----------------------------------------------------------------------------
+// Input methods
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryInputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    _wait_writer = present(u"wait-writer");
+    return true;
+}
+
+bool ts::SharedMemoryInputPlugin::start()
+{
+    _lost = 0;
+    return _ring.open(_name, _wait_writer, *tsp);
+}
+
+bool ts::SharedMemoryInputPlugin::stop()
+{
+    return _ring.close(*tsp);
+}
+
+bool ts::SharedMemoryInputPlugin::abortInput()
+{
+    _ring.abort();
+    return true;
+}
+
+ts::BitRate ts::SharedMemoryInputPlugin::getBitrate()
+{
+    return _ring.bitrate();
+}
+
+size_t ts::SharedMemoryInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    const size_t count = _ring.read(buffer, pkt_data, max_packets, *tsp);
+
+    // Report packets which were lost because we were too slow (non-blocking writer only).
+    if (_ring.lostPackets() > _lost) {
+        tsp->warning(u"lost %'d packets, reader too slow", {_ring.lostPackets() - _lost});
+        _lost = _ring.lostPackets();
+    }
+    return count;
+}
@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryOutputPlugin.h"
+#include "tsPluginRepository.h"
+TSDUCK_SOURCE;
+
+TS_REGISTER_OUTPUT_PLUGIN(u"shm", ts::SharedMemoryOutputPlugin);
+
+// A dummy storage value to force inclusion of this module when using the static library.
+const int ts::SharedMemoryOutputPlugin::REFERENCE = 0;
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryOutputPlugin::SharedMemoryOutputPlugin(TSP* tsp_) :
+    OutputPlugin(tsp_, u"Send TS packets to a shared memory ring, read by other processes", u"[options] name"),
+    _name(),
+    _buffer_size(0),
+    _non_blocking(false),
+    _wait_readers(0),
+    _readers_ready(false),
+    _ring()
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"",
+         u"Name of the shared memory ring. The same name shall be used in the input plugin \"shm\" "
+         u"or in the plugin \"merge\" of the reader processes. Up to " + UString::Decimal(SharedPacketRing::MAX_READERS) +
+         u" reader processes can simultaneously receive the packets, without system call and with their labels and time stamps.");
+
+    option(u"buffered-packets", 'b', POSITIVE);
+    help(u"buffered-packets",
+         u"Specifies the size of the shared memory ring in number of TS packets. "
+         u"The default is " + UString::Decimal(SharedPacketRing::DEFAULT_SIZE) + u" packets.");
+
+    option(u"non-blocking", 'n');
+    help(u"non-blocking",
+         u"Never wait for slow readers. When a reader process is too slow, packets are overwritten before "
+         u"being read and this reader loses them. By default, when the ring is full, the output plugin "
+         u"waits for the slowest reader. Terminated readers are detected and never block the output plugin.");
+
+    option(u"wait-readers", 'w', POSITIVE);
+    help(u"wait-readers", u"count",
+         u"Before sending the first packet, wait until the specified number of reader processes are attached "
+         u"to the shared memory ring. By default, the packets are sent immediately and a reader process "
+         u"receives the packets which are written after it is attached.");
+}
+
+
+//----------------------------------------------------------------------------
+// Output methods
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryOutputPlugin::getOptions()
+{
+    getValue(_name, u"");
+    getIntValue(_buffer_size, u"buffered-packets", SharedPacketRing::DEFAULT_SIZE);
+    _non_blocking = present(u"non-blocking");
+    getIntValue(_wait_readers, u"wait-readers", 0);
+    return true;
+}
+
+bool ts::SharedMemoryOutputPlugin::start()
+{
+    _readers_ready = _wait_readers == 0;
+    return _ring.create(_name, _buffer_size, _non_blocking, *tsp);
+}
+
+bool ts::SharedMemoryOutputPlugin::stop()
+{
+    return _ring.close(*tsp);
+}
+
+bool ts::SharedMemoryOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
+{
+    // Before the first packets, wait for the expected readers, if any.
+    if (!_readers_ready) {
+        tsp->verbose(u"waiting for %d reader processes", {_wait_readers});
+        if (!_ring.waitReaders(_wait_readers, tsp, *tsp)) {
+            return false;
+        }
+        _readers_ready = true;
+    }
+    _ring.setBitrate(tsp->bitrate());
+    return _ring.write(buffer, pkt_data, packet_count, tsp, *tsp);
+}
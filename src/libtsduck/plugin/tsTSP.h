@@ -36,6 +36,7 @@
 #include "tsReport.h"
 #include "tsAbortInterface.h"
 #include "tsTS.h"
+#include <atomic>
 
 namespace ts {
 
@@ -206,10 +207,10 @@ namespace ts {
         virtual ~TSP() override;
 
     protected:
-        bool          _use_realtime;  //!< The plugin should use realtime defaults.
-        BitRate       _tsp_bitrate;   //!< TSP input bitrate.
-        MilliSecond   _tsp_timeout;   //!< Timeout when waiting for packets (infinite by default).
-        volatile bool _tsp_aborting;  //!< TSP is currently aborting.
+        bool              _use_realtime;  //!< The plugin should use realtime defaults.
+        BitRate           _tsp_bitrate;   //!< TSP input bitrate.
+        MilliSecond       _tsp_timeout;   //!< Timeout when waiting for packets (infinite by default).
+        std::atomic<bool> _tsp_aborting;  //!< TSP is currently aborting, read by other plugin threads without lock.
 
         //!
         //! Constructor for subclasses.
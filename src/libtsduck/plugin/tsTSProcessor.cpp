@@ -34,6 +34,8 @@
 #include "tstspControlServer.h"
 #include "tsMonotonic.h"
 #include "tsGuard.h"
+#include "tsSysInfo.h"
+#include "tsMemoryPool.h"
 TSDUCK_SOURCE;
 
 
@@ -140,10 +142,17 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // plugin has a hight priority to make room in the buffer, but not as
         // high as the input which must remain the top-most priority?
 
-        _input = new tsp::InputExecutor(_args, *this, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), _mutex, &_report);
+        // When a NUMA node is specified, all plugin threads run on the CPU's of this node.
+        std::set<size_t> cpus;
+        if (_args.numa_node != NPOS && !SysInfo::Instance()->getNumaNodeCPUs(cpus, _args.numa_node)) {
+            _report.error(u"invalid NUMA node %d, there are %d NUMA nodes on this system", {_args.numa_node, SysInfo::Instance()->numaNodeCount()});
+            return false;
+        }
+
+        _input = new tsp::InputExecutor(_args, *this, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()).setAffinity(cpus), _mutex, &_report);
         CheckNonNull(_input);
 
-        _output = new tsp::OutputExecutor(_args, *this, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _mutex, &_report);
+        _output = new tsp::OutputExecutor(_args, *this, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()).setAffinity(cpus), _mutex, &_report);
         CheckNonNull(_output);
 
         _output->ringInsertAfter(_input);
@@ -152,7 +161,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         bool realtime = _args.realtime == Tristate::TRUE || _input->isRealTime() || _output->isRealTime();
 
         for (size_t i = 0; i < _args.plugins.size(); ++i) {
-            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, ThreadAttributes(), _mutex, &_report);
+            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, ThreadAttributes().setAffinity(cpus), _mutex, &_report);
             CheckNonNull(p);
             p->ringInsertBefore(_output);
             realtime = realtime || p->isRealTime();
@@ -186,19 +195,40 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
 
         // Allocate a memory-resident buffer of TS packets
-        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE);
+        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE, _args.huge_page_size, _args.numa_node);
         CheckNonNull(_packet_buffer);
         if (!_packet_buffer->isLocked()) {
             _report.verbose(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
                             {_packet_buffer->lockErrorCode(), ts::SysErrorCodeMessage(_packet_buffer->lockErrorCode())});
         }
+        if (_args.huge_page_size > 0 && _packet_buffer->pageSize() < _args.huge_page_size) {
+            _report.warning(u"tsp: %'d-byte huge pages not available (%s), using normal pages",
+                            {_args.huge_page_size, ts::SysErrorCodeMessage(_packet_buffer->pageErrorCode())});
+        }
+        if (_args.numa_node != NPOS && _packet_buffer->numaErrorCode() != SYS_SUCCESS) {
+            _report.warning(u"tsp: cannot bind buffer to NUMA node %d (%s)",
+                            {_args.numa_node, ts::SysErrorCodeMessage(_packet_buffer->numaErrorCode())});
+        }
         _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes", {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE});
 
         // Buffer for the packet metadata.
         // A packet and its metadata have the same index in their respective buffer.
-        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
+        // Huge pages are not used for the metadata, which are much smaller.
+        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count(), 0, _args.numa_node);
         CheckNonNull(_metadata_buffer);
 
+        // Report the actual placement of the buffer. A buffer which is not where it was requested is worth a warning.
+        const size_t node = _packet_buffer->numaNode();
+        if (_args.numa_node != NPOS && _packet_buffer->numaErrorCode() == SYS_SUCCESS && node != NPOS && node != _args.numa_node) {
+            _report.warning(u"tsp: buffer is located on NUMA node %d instead of %d", {node, _args.numa_node});
+        }
+        _report.verbose(u"tsp: buffer placement: %'d bytes, page size: %'d bytes, NUMA node: %s, threads: %s, %s",
+                        {_packet_buffer->count() * ts::PKT_SIZE,
+                         _packet_buffer->pageSize(),
+                         node == NPOS ? UString(u"unknown") : UString::Decimal(node),
+                         cpus.empty() ? UString(u"all CPU's") : UString::Format(u"%d CPU's of NUMA node %d", {cpus.size(), _args.numa_node}),
+                         _packet_buffer->isLocked() ? u"locked" : u"not locked"});
+
         // End of locked section.
     }
 
@@ -230,11 +260,18 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         return false;
     }
 
-    // Start all plugin executors threads.
-    tsp::PluginExecutor* proc = _input;
+    // Start all plugin executors threads, in reverse order (input last).
+    // Exit application in case of error (typically a real-time scheduling policy without privilege).
+    tsp::PluginExecutor* proc = _output;
     do {
-        proc->start();
-    } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
+        if (!proc->start()) {
+            ThreadAttributes attr;
+            proc->getAttributes(attr);
+            _report.error(u"cannot start the thread of plugin %s%s", {proc->pluginName(), attr.getSchedulingPolicy() == ThreadAttributes::SchedulingPolicy::DEFAULT ? u"" : u", real-time policy may require privileges"});
+            cleanupInternal();
+            return false;
+        }
+    } while ((proc = proc->ringPrevious<tsp::PluginExecutor>()) != _output);
 
     // Create a control server thread. Display but ignore errors (not a fatal error).
     _control = new tsp::ControlServer(_args, _report, _mutex, _input);
@@ -296,5 +333,12 @@ void ts::TSProcessor::waitForTermination()
 
         // Deallocate all plugins and plugin executor
         cleanupInternal();
+
+        // All plugin threads are terminated, their memory pool statistics are cumulated.
+        if (_report.maxSeverity() >= Severity::Debug) {
+            MemoryPool::Statistics stats;
+            MemoryPool::GetStatistics(stats);
+            _report.debug(u"memory pool: %s", {stats.toString()});
+        }
     }
 }
@@ -45,6 +45,11 @@ constexpr size_t ts::TSProcessorArgs::MIN_BUFFER_SIZE;
 #define DEF_MAX_INPUT_PKT_RT            1000  // packets
 #define DEF_CONTROL_TIMEOUT             5000  // milliseconds
 
+const ts::Enumeration ts::TSProcessorArgs::HugePageSizes({
+    {u"2MB", 2 * 1024 * 1024},
+    {u"1GB", 1024 * 1024 * 1024},
+});
+
 
 //----------------------------------------------------------------------------
 // Constructor.
@@ -55,7 +60,10 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     monitor(false),
     ignore_jt(false),
     log_plugin_index(false),
+    lock_free(false),
     ts_buffer_size(DEFAULT_BUFFER_SIZE),
+    huge_page_size(0),
+    numa_node(NPOS),
     max_flush_pkt(0),
     max_input_pkt(0),
     init_input_pkt(0),
@@ -155,6 +163,15 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"Specify the reception timeout in milliseconds for control commands. "
               u"The default timeout is " TS_STRINGIFY(DEF_CONTROL_TIMEOUT) u" ms.");
 
+    args.option(u"huge-pages", 0, HugePageSizes, 0, 1, true);
+    args.help(u"huge-pages", u"size",
+              u"Allocate the global buffer of TS packets using huge memory pages of the specified size. "
+              u"The default size is 2MB. Using huge pages reduces the TLB misses when the plugins access "
+              u"the buffer. This is implemented on Linux only. The huge pages must be reserved by the "
+              u"system administrator (see /proc/sys/vm/nr_hugepages and the kernel parameters hugepagesz "
+              u"and hugepages). When the requested huge pages are not available, the buffer is allocated "
+              u"using normal pages, with transparent huge pages when possible.");
+
     args.option(u"ignore-joint-termination", 'i');
     args.help(u"ignore-joint-termination",
               u"Ignore all --joint-termination options in plugins. "
@@ -175,6 +192,16 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"a valid bitrate value from the beginning. "
               u"The default initial load is half the size of the global buffer.");
 
+    args.option(u"lock-free");
+    args.help(u"lock-free",
+              u"Pass packets from one plugin thread to the next one without using the "
+              u"global buffer mutex. Each plugin thread publishes its processed packets "
+              u"to the next plugin using atomic counters and waits for new packets by "
+              u"spinning for a short while before sleeping. This can reduce the contention "
+              u"on long chains of plugins at high bitrates, at the expense of some CPU "
+              u"time when the stream is idle. "
+              u"By default, all plugin threads synchronize on one single global mutex.");
+
     args.option(u"log-plugin-index");
     args.help(u"log-plugin-index",
               u"In log messages, add the plugin index to the plugin name. "
@@ -208,6 +235,13 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"This includes CPU load, virtual memory usage. Useful to verify the "
               u"stability of the application.");
 
+    args.option(u"numa-node", 0, Args::UNSIGNED);
+    args.help(u"numa-node", u"index",
+              u"Bind the global buffer of TS packets to the memory of the specified NUMA node and run "
+              u"all plugin threads on the CPU's of this node. On multi-socket servers, this avoids "
+              u"cross-node memory traffic. This is implemented on Linux only. "
+              u"By default, the operating system decides where the buffer and the threads are located.");
+
     args.option(u"realtime", 'r', Args::TRISTATE, 0, 1, -255, 256, true);
     args.help(u"realtime",
               u"Specifies if tsp and all plugins should use default values for real-time "
@@ -229,7 +263,10 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     app_name = args.appName();
     monitor = args.present(u"monitor");
     log_plugin_index = args.present(u"log-plugin-index");
+    lock_free = args.present(u"lock-free");
     ts_buffer_size = args.intValue<size_t>(u"buffer-size-mb", DEFAULT_BUFFER_SIZE);
+    huge_page_size = args.present(u"huge-pages") ? args.intValue<size_t>(u"huge-pages", 2 * 1024 * 1024) : 0;
+    numa_node = args.intValue<size_t>(u"numa-node", NPOS);
     fixed_bitrate = args.intValue<BitRate>(u"bitrate", 0);
     bitrate_adj = MilliSecPerSec * args.intValue(u"bitrate-adjust-interval", DEF_BITRATE_INTERVAL);
     max_flush_pkt = args.intValue<size_t>(u"max-flushed-packets", 0);
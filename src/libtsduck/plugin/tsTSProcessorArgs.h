@@ -50,7 +50,10 @@ namespace ts {
         bool            monitor;          //!< Run a resource monitoring thread.
         bool            ignore_jt;        //!< Ignore "joint termination" options in plugins.
         bool            log_plugin_index; //!< Log plugin index with plugin name.
+        bool            lock_free;        //!< Pass packets between plugin threads without the global mutex.
         size_t          ts_buffer_size;   //!< Size in bytes of the global TS packet buffer.
+        size_t          huge_page_size;   //!< Memory page size of the global TS packet buffer, zero for default pages.
+        size_t          numa_node;        //!< NUMA node for the global TS packet buffer and the plugin threads, NPOS for none.
         size_t          max_flush_pkt;    //!< Max processed packets before flush.
         size_t          max_input_pkt;    //!< Max packets per input operation.
         size_t          init_input_pkt;   //!< Initial number of input packets to read before starting the processing (zero means default).
@@ -76,6 +79,11 @@ namespace ts {
         static constexpr size_t DEFAULT_BUFFER_SIZE = 16 * 1000000;  //!< Default size in bytes of global TS buffer.
         static constexpr size_t MIN_BUFFER_SIZE = 18800;             //!< Minimum size in bytes of global TS buffer.
 
+        //!
+        //! Enumeration of huge page sizes for the global TS buffer (option --huge-pages).
+        //!
+        static const Enumeration HugePageSizes;
+
         //!
         //! Constructor.
         //!
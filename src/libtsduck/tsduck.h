@@ -261,6 +261,7 @@
 #include "tsEnumUtils.h"
 #include "tsERT.h"
 #include "tsETID.h"
+#include "tsETIDTable.h"
 #include "tsETT.h"
 #include "tsEutelsatChannelNumberDescriptor.h"
 #include "tsEventGroupDescriptor.h"
@@ -345,6 +346,7 @@
 #include "tsITT.h"
 #include "tsJ2KVideoDescriptor.h"
 #include "tsjson.h"
+#include "tsjsonArenaDocument.h"
 #include "tsjsonArray.h"
 #include "tsjsonFalse.h"
 #include "tsjsonNull.h"
@@ -352,6 +354,7 @@
 #include "tsjsonObject.h"
 #include "tsjsonOutputArgs.h"
 #include "tsjsonRunningDocument.h"
+#include "tsjsonStreamWriter.h"
 #include "tsjsonString.h"
 #include "tsjsonTrue.h"
 #include "tsjsonValue.h"
@@ -370,6 +373,7 @@
 #include "tsMaximumBitrateDescriptor.h"
 #include "tsMD5.h"
 #include "tsMemory.h"
+#include "tsMemoryPool.h"
 #include "tsMessageDescriptor.h"
 #include "tsMessagePriorityQueue.h"
 #include "tsMessageQueue.h"
@@ -428,6 +432,7 @@
 #include "tsPacketEncapsulation.h"
 #include "tsPacketInsertionController.h"
 #include "tsPacketizer.h"
+#include "tsPacketPacer.h"
 #include "tsPagerArgs.h"
 #include "tsParentalRatingDescriptor.h"
 #include "tsPartialReceptionDescriptor.h"
@@ -449,6 +454,7 @@
 #include "tsPESProviderInterface.h"
 #include "tsPESStreamPacketizer.h"
 #include "tsPIDOperator.h"
+#include "tsPIDTable.h"
 #include "tsPlatform.h"
 #include "tsPlugin.h"
 #include "tsPluginEventContext.h"
@@ -461,6 +467,7 @@
 #include "tsPolledFile.h"
 #include "tsPollFiles.h"
 #include "tsPollFilesListener.h"
+#include "tsPooledByteBlock.h"
 #include "tsPrefetchDescriptor.h"
 #include "tsPrivateDataIndicatorDescriptor.h"
 #include "tsPrivateDataSpecifierDescriptor.h"
@@ -520,6 +527,9 @@
 #include "tsSHA256.h"
 #include "tsSHA512.h"
 #include "tsSharedLibrary.h"
+#include "tsSharedMemoryInputPlugin.h"
+#include "tsSharedMemoryOutputPlugin.h"
+#include "tsSharedPacketRing.h"
 #include "tsSHDeliverySystemDescriptor.h"
 #include "tsShortEventDescriptor.h"
 #include "tsShortNodeInformationDescriptor.h"
@@ -668,6 +678,7 @@
 #include "tsTSProcessorArgs.h"
 #include "tsTSScanner.h"
 #include "tsTSScrambling.h"
+#include "tsTSScramblingBatch.h"
 #include "tsTSSpeedMetrics.h"
 #include "tsTuner.h"
 #include "tsTunerArgs.h"
@@ -712,13 +723,19 @@
 #include "tsxmlDocument.h"
 #include "tsxmlElement.h"
 #include "tsxmlJSONConverter.h"
+#include "tsxmlJSONSerializer.h"
 #include "tsxmlModelDocument.h"
 #include "tsxmlNode.h"
 #include "tsxmlPatchDocument.h"
 #include "tsxmlRunningDocument.h"
+#include "tsxmlSerializer.h"
+#include "tsxmlStreamReader.h"
 #include "tsxmlText.h"
+#include "tsxmlTextSerializer.h"
+#include "tsxmlTreeSerializer.h"
 #include "tsxmlTweaks.h"
 #include "tsxmlUnknown.h"
+#include "tsXXHash.h"
 
 #if defined(TS_LINUX)
 #include "tsDTVProperties.h"
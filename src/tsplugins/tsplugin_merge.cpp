@@ -36,6 +36,7 @@
 #include "tsSignalizationHandlerInterface.h"
 #include "tsSignalizationDemux.h"
 #include "tsTSForkPipe.h"
+#include "tsSharedPacketRing.h"
 #include "tsTSPacketQueue.h"
 #include "tsPacketInsertionController.h"
 #include "tsPSIMerger.h"
@@ -79,6 +80,7 @@ namespace ts {
 
         // Command line options.
         UString        _command;             // Command which generates the main stream.
+        UString        _shm_name;            // Shared memory segment which contains the merged stream.
         TSPacketFormat _format;              // Packet format on the pipe
         size_t         _max_queue;           // Maximum number of queued packets.
         size_t         _accel_threshold;     // Queue threshold after which insertion is accelerated.
@@ -101,6 +103,7 @@ namespace ts {
         PacketCounter _hold_count;         // Number of times we didn't try to merge to perform smoothing insertion.
         PacketCounter _empty_count;        // Number of times we could merge but there was no packet to merge.
         TSForkPipe    _pipe;               // Executed command.
+        SharedPacketRing _ring;            // Shared memory ring, when used instead of a command.
         TSPacketQueue _queue;              // TS packet queur from merge to main.
         PIDSet        _main_pids;          // Set of detected PID's in main stream.
         PIDSet        _merge_pids;         // Set of detected PID's in merged stream that we pass in main stream.
@@ -163,6 +166,7 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
     ProcessorPlugin(tsp_, u"Merge TS packets coming from the standard output of a command", u"[options] 'command'"),
     Thread(ThreadAttributes().setStackSize(SERVER_THREAD_STACK_SIZE)),
     _command(),
+    _shm_name(),
     _format(TSPacketFormat::AUTODETECT),
     _max_queue(DEFAULT_MAX_QUEUED_PACKETS),
     _accel_threshold(_max_queue / 2),
@@ -183,6 +187,7 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
     _hold_count(0),
     _empty_count(0),
     _pipe(),
+    _ring(),
     _queue(),
     _main_pids(),
     _merge_pids(),
@@ -194,9 +199,10 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
     _insert_control.setMainStreamName(u"main stream");
     _insert_control.setSubStreamName(u"merged stream");
 
-    option(u"", 0, STRING, 1, 1);
+    option(u"", 0, STRING, 0, 1);
     help(u"",
-         u"Specifies the command line to execute in the created process.");
+         u"Specifies the command line to execute in the created process. "
+         u"Exactly one of the command line or option --shared-memory must be specified.");
 
     option(u"acceleration-threshold", 0, UNSIGNED);
     help(u"acceleration-threshold",
@@ -301,6 +307,12 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
          u"PCR value in this packet. Note that this creates a small PCR leap in the stream. "
          u"The option has, of course, no effect on scrambled streams.");
 
+    option(u"shared-memory", 0, STRING);
+    help(u"shared-memory", u"name",
+         u"Read the stream to merge from the specified shared memory segment instead of "
+         u"the standard output of a command. The segment is created by another tsp process "
+         u"using the output plugin 'shm'. No command line parameter shall be specified with this option.");
+
     option(u"terminate");
     help(u"terminate",
         u"Terminate packet processing when the merged stream is terminated. "
@@ -333,6 +345,7 @@ ts::MergePlugin::MergePlugin(TSP* tsp_) :
 bool ts::MergePlugin::getOptions()
 {
     getValue(_command);
+    getValue(_shm_name, u"shared-memory");
     _no_wait = present(u"no-wait");
     const bool transparent = present(u"transparent");
     getIntValue(_max_queue, u"max-queue", DEFAULT_MAX_QUEUED_PACKETS);
@@ -350,6 +363,11 @@ bool ts::MergePlugin::getOptions()
     getIntValues(_setLabels, u"set-label");
     getIntValues(_resetLabels, u"reset-label");
 
+    if (_command.empty() == _shm_name.empty()) {
+        tsp->error(u"specify exactly one of a command line or --shared-memory");
+        return false;
+    }
+
     if (_terminate && tsp->useJointTermination()) {
         tsp->error(u"--terminate and --joint-termination are mutually exclusive");
         return false;
@@ -454,13 +472,16 @@ bool ts::MergePlugin::start()
     // because this is the size of the system pipe buffer (Windows only). This is
     // a limited resource and we cannot let a user set an arbitrary large value for it.
     // The user can only change the queue size in tsp's virtual memory.
-    const bool ok = _pipe.open(_command,
-                               _no_wait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
-                               PKT_SIZE * DEFAULT_MAX_QUEUED_PACKETS,
-                               *tsp,
-                               ForkPipe::STDOUT_PIPE,
-                               ForkPipe::STDIN_NONE,
-                               _format);
+    // With --shared-memory, attach to the ring of an existing writer instead.
+    const bool ok = !_shm_name.empty() ?
+        _ring.open(_shm_name, false, *tsp) :
+        _pipe.open(_command,
+                   _no_wait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
+                   PKT_SIZE * DEFAULT_MAX_QUEUED_PACKETS,
+                   *tsp,
+                   ForkPipe::STDOUT_PIPE,
+                   ForkPipe::STDIN_NONE,
+                   _format);
 
     // Start the internal thread which receives the TS to merge.
     if (ok) {
@@ -485,10 +506,19 @@ bool ts::MergePlugin::stop()
     _queue.stop();
 
     // Close the pipe and terminate the created process.
-    _pipe.close(*tsp);
+    // A shared memory reader is only interrupted here and detached after the thread terminates.
+    if (_shm_name.empty()) {
+        _pipe.close(*tsp);
+    }
+    else {
+        _ring.abort();
+    }
 
     // Wait for actual thread termination.
     Thread::waitForTermination();
+    if (_ring.isOpen()) {
+        _ring.close(*tsp);
+    }
     return true;
 }
 
@@ -505,6 +535,7 @@ void ts::MergePlugin::main()
     // Specify the bitrate of the incoming stream.
     // When zero, packet queue will compute it from the PCR.
     _queue.setBitrate(_user_bitrate);
+    BitRate shm_bitrate = 0;
 
     // Loop on packet reception until the plugin request to stop.
     while (!_queue.stopped()) {
@@ -523,6 +554,22 @@ void ts::MergePlugin::main()
         assert(buffer != nullptr);
         assert(buffer_size > 0);
 
+        // Read TS packets from the shared memory ring, up to buffer size.
+        // Without user-specified bitrate, use the bitrate which is published by the writer, if any.
+        if (!_shm_name.empty()) {
+            const size_t count = _ring.read(buffer, nullptr, buffer_size, *tsp);
+            if (count == 0) {
+                _queue.setEOF();
+                break;
+            }
+            if (_user_bitrate == 0 && _ring.bitrate() != shm_bitrate) {
+                shm_bitrate = _ring.bitrate();
+                _queue.setBitrate(shm_bitrate);
+            }
+            _queue.releaseWriteBuffer(count);
+            continue;
+        }
+
         // Read TS packets from the pipe, up to buffer size (but maybe less).
         // We request to read only multiples of 188 bytes (the packet size).
         if (!_pipe.readStreamChunks(buffer, PKT_SIZE * buffer_size, PKT_SIZE, read_size, *tsp)) {
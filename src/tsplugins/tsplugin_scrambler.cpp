@@ -35,6 +35,7 @@
 #include "tsPluginRepository.h"
 #include "tsServiceDiscovery.h"
 #include "tsTSScrambling.h"
+#include "tsTSScramblingBatch.h"
 #include "tsByteBlock.h"
 #include "tsCyclingPacketizer.h"
 #include "tsOneShotPacketizer.h"
@@ -103,6 +104,8 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual size_t getPacketWindowSize() override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -195,6 +198,7 @@ namespace ts {
         size_t            _current_ecm;         // Index to current ECM (ECM being broadcast)
         TSScrambling      _scrambling;          // Scrambler
         CyclingPacketizer _pzer_pmt;            // Packetizer for modified PMT
+        TSScramblingBatch _batch;               // Packets to scramble at once in processPacketWindow().
 
         // Return current/next CryptoPeriod for CW or ECM
         CryptoPeriod& currentCW()  { return _cp[_current_cw]; }
@@ -264,7 +268,8 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
     _current_cw(0),
     _current_ecm(0),
     _scrambling(*tsp),
-    _pzer_pmt(duck)
+    _pzer_pmt(duck),
+    _batch(true)
 {
     // We need to define character sets to specify service names.
     duck.defineArgsForCharset(*this);
@@ -308,6 +313,8 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
          u"Do not scramble video components in the selected service. By default, "
          u"all video components are scrambled.");
 
+    _batch.defineArgs(*this);
+
     option(u"partial-scrambling", 0, POSITIVE);
     help(u"partial-scrambling", u"count",
          u"Do not scramble all packets, only one packet every \"count\" packets. "
@@ -366,6 +373,7 @@ bool ts::ScramblerPlugin::getOptions()
     _scramble_video = !present(u"no-video");
     _scramble_subtitles = present(u"subtitles");
     _partial_scrambling = intValue<PacketCounter>(u"partial-scrambling", 1);
+    _batch.loadArgs(*this, tsp->realtime());
     _ignore_scrambled = present(u"ignore-scrambled");
     _ecm_pid = intValue<PID>(u"pid-ecm", PID_NULL);
     _ecm_bitrate = intValue<BitRate>(u"bitrate-ecm", DEFAULT_ECM_BITRATE);
@@ -430,6 +438,7 @@ bool ts::ScramblerPlugin::start()
     _delay_start = 0;
     _current_cw = 0;
     _current_ecm = 0;
+    _batch.reset();
 
     // Initialize the scrambling engine.
     if (!_scrambling.start()) {
@@ -683,6 +692,11 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
 
 bool ts::ScramblerPlugin::changeCW()
 {
+    // Packets which are waiting in the current batch use the previous CW.
+    if (!_batch.flush()) {
+        return false;
+    }
+
     if (_scrambling.hasFixedCW()) {
         // A list of fixed CW was loaded from a file.
 
@@ -741,6 +755,23 @@ void ts::ScramblerPlugin::changeECM()
 }
 
 
+//----------------------------------------------------------------------------
+// Packet window processing: the packets to scramble are collected by
+// processPacket() and scrambled at once.
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::getPacketWindowSize()
+{
+    return _batch.packetWindowSize();
+}
+
+size_t ts::ScramblerPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    _batch.start();
+    return _batch.stop(win, ProcessorPlugin::processPacketWindow(win));
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -848,8 +879,8 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
         _partial_clear = _partial_scrambling - 1;
     }
 
-    // Scramble the packet payload.
-    if (!_scrambling.encrypt(pkt)) {
+    // Scramble the packet payload, immediately or later in the current batch.
+    if (!_batch.process(_scrambling, pkt)) {
         return TSP_END;
     }
     _scrambled_count++;
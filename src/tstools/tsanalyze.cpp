@@ -37,9 +37,16 @@
 #include "tsTSFile.h"
 #include "tsPagerArgs.h"
 #include "tsDuckContext.h"
+#include "tsAsyncReport.h"
+#include "tsThread.h"
+#include "tsGuard.h"
+#include "tsSysUtils.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
+// Minimum size of a chunk of file in parallel analysis (approximately 20 MB).
+#define MIN_CHUNK_PACKETS 100000
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -54,19 +61,21 @@ namespace {
 
         ts::DuckContext       duck;      // TSDuck execution context.
         ts::BitRate           bitrate;   // Expected bitrate (188-byte packets)
-        ts::UString           infile;    // Input file name
+        ts::UStringVector     infiles;   // Input file names
         ts::TSPacketFormat    format;    // Input file format.
+        size_t                threads;   // Number of analysis threads.
         ts::TSAnalyzerOptions analysis;  // Analysis options.
         ts::PagerArgs         pager;     // Output paging options.
     };
 }
 
 Options::Options(int argc, char *argv[]) :
-    ts::Args(u"Analyze the structure of a transport stream", u"[options] [filename]"),
+    ts::Args(u"Analyze the structure of a transport stream", u"[options] [filename ...]"),
     duck(this),
     bitrate(0),
-    infile(),
+    infiles(),
     format(ts::TSPacketFormat::AUTODETECT),
+    threads(1),
     analysis(),
     pager(true, true)
 {
@@ -78,8 +87,11 @@ Options::Options(int argc, char *argv[]) :
     pager.defineArgs(*this);
     analysis.defineArgs(*this);
 
-    option(u"", 0, STRING, 0, 1);
-    help(u"", u"Input transport stream file (standard input if omitted).");
+    option(u"", 0, STRING, 0, UNLIMITED_COUNT);
+    help(u"",
+         u"Input transport stream files (standard input if omitted). "
+         u"When several files are specified, they are analyzed as consecutive parts "
+         u"of the same transport stream and one single report is produced.");
 
     option(u"bitrate", 'b', UNSIGNED);
     help(u"bitrate",
@@ -89,12 +101,21 @@ Options::Options(int argc, char *argv[]) :
 
     option(u"format", 0, ts::TSPacketFormatEnum);
     help(u"format", u"name",
-         u"Specify the format of the input file. "
+         u"Specify the format of the input files. "
          u"By default, the format is automatically detected. "
          u"But the auto-detection may fail in some cases "
          u"(for instance when the first time-stamp of an M2TS file starts with 0x47). "
          u"Using this option forces a specific format.");
 
+    option(u"threads", 't', POSITIVE);
+    help(u"threads", u"count",
+         u"Number of threads to use for the analysis. The default is 1, one single analysis thread. "
+         u"With more than one thread, the input files are split into consecutive chunks which are "
+         u"analyzed in parallel. Each chunk, except the first one, starts with the first packet of a PAT "
+         u"so that the PSI/SI are immediately analyzed. The analyses of all chunks are merged into one report. "
+         u"A discontinuity or a PCR interval across two chunks is not analyzed. "
+         u"Only regular files can be split into chunks.");
+
     analyze(argc, argv);
 
     // Define all standard analysis options.
@@ -102,14 +123,229 @@ Options::Options(int argc, char *argv[]) :
     pager.loadArgs(duck, *this);
     analysis.loadArgs(duck, *this);
 
-    getValue(infile, u"");
+    getValues(infiles, u"");
     getIntValue(bitrate, u"bitrate");
     getIntValue(format, u"format", ts::TSPacketFormat::AUTODETECT);
+    getIntValue(threads, u"threads", 1);
+
+    // Standard input when no file is specified.
+    if (infiles.empty()) {
+        infiles.push_back(ts::UString());
+    }
 
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+//  A chunk of input file, analyzed in parallel with other chunks.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Chunk
+    {
+        TS_NOBUILD_NOCOPY(Chunk);
+    public:
+        // Constructor. The chunk starts at packet index "first" in the file, up to index "last",
+        // excluded, or end of file when "last" is zero. The actual boundaries are moved to the
+        // first packet of a PAT, except at start and end of file.
+        Chunk(const Options& opt, ts::Report& report, const ts::UString& filename, ts::TSPacketFormat format, size_t packet_size, ts::PacketCounter first, ts::PacketCounter last);
+
+        // Analyze the chunk. Return false on error.
+        bool analyze();
+
+        ts::DuckContext        duck;      // Distinct execution context per analysis thread.
+        ts::TSAnalyzerReport   analyzer;  // Analysis of the chunk.
+
+    private:
+        ts::Report&              _report;
+        const ts::UString        _filename;
+        const ts::TSPacketFormat _format;
+        const size_t             _packet_size;
+        const ts::PacketCounter  _first;
+        const ts::PacketCounter  _last;
+
+        // Check if a packet is a chunk boundary.
+        static bool IsBoundary(const ts::TSPacket& pkt) { return pkt.hasValidSync() && pkt.getPID() == ts::PID_PAT && pkt.getPUSI(); }
+    };
+
+    typedef ts::SafePtr<Chunk, ts::NullMutex> ChunkPtr;
+    typedef std::vector<ChunkPtr> ChunkPtrVector;
+}
+
+Chunk::Chunk(const Options& opt, ts::Report& report, const ts::UString& filename, ts::TSPacketFormat format, size_t packet_size, ts::PacketCounter first, ts::PacketCounter last) :
+    duck(&report),
+    analyzer(duck, opt.bitrate),
+    _report(report),
+    _filename(filename),
+    _format(format),
+    _packet_size(packet_size),
+    _first(first),
+    _last(last)
+{
+    ts::DuckContext::SavedArgs args;
+    opt.duck.saveArgs(args);
+    duck.restoreArgs(args);
+    analyzer.setAnalysisOptions(opt.analysis);
+}
+
+bool Chunk::analyze()
+{
+    ts::TSFile file;
+    file.setMemoryMapped(true);
+    if (!file.openRead(_filename, 1, _first * _packet_size, _report, _format)) {
+        return false;
+    }
+
+    // Except at start of file, skip packets up to the first PAT in the chunk.
+    ts::PacketCounter index = _first;
+    bool started = _first == 0;
+    bool completed = false;
+
+    const ts::TSPacket* pkt = nullptr;
+    size_t count = 0;
+    while (!completed && (count = file.readPacketsInPlace(pkt, nullptr, 1024, _report)) > 0) {
+        for (size_t i = 0; !completed && i < count; ++i, ++index) {
+            if (_last != 0 && index >= _last && IsBoundary(pkt[i])) {
+                // Reached the start of next chunk.
+                completed = true;
+            }
+            else if (started || IsBoundary(pkt[i])) {
+                started = true;
+                analyzer.feedPacket(pkt[i]);
+            }
+            else if (_last != 0 && index >= _last) {
+                // No PAT in the chunk, all packets belong to the previous one.
+                completed = true;
+            }
+        }
+    }
+    file.close(_report);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+//  Analysis thread: analyze chunks until there is none left.
+//----------------------------------------------------------------------------
+
+namespace {
+    class AnalysisThread: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(AnalysisThread);
+    public:
+        AnalysisThread(ChunkPtrVector& chunks, size_t& next_chunk, ts::Mutex& mutex, bool& success);
+        virtual void main() override;
+
+    private:
+        ChunkPtrVector& _chunks;
+        size_t&         _next_chunk;
+        ts::Mutex&      _mutex;
+        bool&           _success;
+    };
+
+    typedef ts::SafePtr<AnalysisThread, ts::NullMutex> AnalysisThreadPtr;
+}
+
+AnalysisThread::AnalysisThread(ChunkPtrVector& chunks, size_t& next_chunk, ts::Mutex& mutex, bool& success) :
+    ts::Thread(),
+    _chunks(chunks),
+    _next_chunk(next_chunk),
+    _mutex(mutex),
+    _success(success)
+{
+}
+
+void AnalysisThread::main()
+{
+    for (;;) {
+        // Get the index of the next chunk to analyze.
+        size_t index = 0;
+        {
+            ts::Guard lock(_mutex);
+            if (_next_chunk >= _chunks.size()) {
+                return;
+            }
+            index = _next_chunk++;
+        }
+        if (!_chunks[index]->analyze()) {
+            ts::Guard lock(_mutex);
+            _success = false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Parallel analysis of all input files into one analyzer.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool ParallelAnalysis(Options& opt, ts::TSAnalyzerReport& analyzer)
+    {
+        // Use an asynchronous report to serialize messages from all threads.
+        ts::AsyncReport report(opt.maxSeverity());
+
+        // Get the format and size of all files.
+        std::vector<ts::TSPacketFormat> formats(opt.infiles.size(), opt.format);
+        std::vector<size_t> packet_sizes(opt.infiles.size(), 0);
+        std::vector<ts::PacketCounter> packet_counts(opt.infiles.size(), 0);
+        ts::PacketCounter total_packets = 0;
+        for (size_t i = 0; i < opt.infiles.size(); ++i) {
+            const ts::UString& name(opt.infiles[i]);
+            const int64_t size = name.empty() || name == u"-" ? 0 : ts::GetFileSize(name);
+            if (size > 0) {
+                // Read the first packet to get the actual file format.
+                ts::TSFile file;
+                ts::TSPacket pkt;
+                if (!file.openRead(name, 1, 0, report, opt.format)) {
+                    return false;
+                }
+                if (file.readPackets(&pkt, nullptr, 1, report) == 1) {
+                    formats[i] = file.packetFormat();
+                    packet_sizes[i] = file.packetHeaderSize() + ts::PKT_SIZE + file.packetTrailerSize();
+                    packet_counts[i] = ts::PacketCounter(size) / packet_sizes[i];
+                    total_packets += packet_counts[i];
+                }
+                file.close(report);
+            }
+        }
+
+        // Split the regular files into chunks of approximately the same size, one per thread.
+        const ts::PacketCounter chunk_packets = std::max<ts::PacketCounter>(MIN_CHUNK_PACKETS, total_packets / opt.threads);
+        ChunkPtrVector chunks;
+        for (size_t i = 0; i < opt.infiles.size(); ++i) {
+            const ts::PacketCounter count = packet_sizes[i] == 0 ? 1 : std::max<ts::PacketCounter>(1, (packet_counts[i] + chunk_packets / 2) / chunk_packets);
+            for (ts::PacketCounter c = 0; c < count; ++c) {
+                const ts::PacketCounter first = (c * packet_counts[i]) / count;
+                const ts::PacketCounter last = c + 1 == count ? 0 : ((c + 1) * packet_counts[i]) / count;
+                chunks.push_back(new Chunk(opt, report, opt.infiles[i], formats[i], packet_sizes[i], first, last));
+            }
+        }
+        report.debug(u"%d packets, %d chunks, %d threads", {total_packets, chunks.size(), opt.threads});
+
+        // Start all analysis threads and wait for their completion.
+        ts::Mutex mutex;
+        size_t next_chunk = 0;
+        bool success = true;
+        std::vector<AnalysisThreadPtr> threads(std::min(opt.threads, chunks.size()));
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i] = new AnalysisThread(chunks, next_chunk, mutex, success);
+            threads[i]->start();
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i]->waitForTermination();
+        }
+
+        // Merge all analyses in order.
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            analyzer.merge(chunks[i]->analyzer);
+        }
+        return success;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -123,18 +359,34 @@ int MainCode(int argc, char *argv[])
     ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate);
     analyzer.setAnalysisOptions(opt.analysis);
 
-    // Open the TS file.
-    ts::TSFile file;
-    if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
-        return EXIT_FAILURE;
+    if (opt.threads > 1) {
+        // Analyze chunks of files in parallel.
+        if (!ParallelAnalysis(opt, analyzer)) {
+            return EXIT_FAILURE;
+        }
     }
+    else {
+        // Analyze all files in sequence.
+        for (size_t i = 0; i < opt.infiles.size(); ++i) {
+
+            // Open the TS file. Regular files are read through a memory mapping.
+            ts::TSFile file;
+            file.setMemoryMapped(true);
+            if (!file.openRead(opt.infiles[i], 1, 0, opt, opt.format)) {
+                return EXIT_FAILURE;
+            }
 
-    // Analyze all packets in the file.
-    ts::TSPacket pkt;
-    while (file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        analyzer.feedPacket(pkt);
+            // Analyze all packets in the file, without copy when possible.
+            const ts::TSPacket* pkt = nullptr;
+            size_t count = 0;
+            while ((count = file.readPacketsInPlace(pkt, nullptr, 1024, opt)) > 0) {
+                for (size_t n = 0; n < count; ++n) {
+                    analyzer.feedPacket(pkt[n]);
+                }
+            }
+            file.close(opt);
+        }
     }
-    file.close(opt);
 
     // Display analysis results.
     analyzer.report(opt.pager.output(opt), opt.analysis, opt);
@@ -204,20 +204,27 @@ namespace {
             out << "* File " << filename << std::endl;
         }
 
-        // Open the TS file.
+        // Open the TS file. Regular files are read through a memory mapping.
         ts::TSFile file;
+        file.setMemoryMapped(true);
         if (!file.openRead(filename, 1, 0, opt, opt.format)) {
             return;
         }
 
-        // Read all packets in the file.
-        ts::TSPacket pkt;
-        for (ts::PacketCounter packet_index = 0; packet_index < opt.max_packets && file.readPackets(&pkt, nullptr, 1, opt) > 0; packet_index++) {
-            if (opt.pids.test(pkt.getPID())) {
-                if (!opt.log) {
-                    out << std::endl << "* Packet " << ts::UString::Decimal(packet_index) << std::endl;
+        // Read all packets in the file, without copy when possible.
+        // Read packets one by one on pipes to display them as soon as they arrive.
+        const size_t max_read = file.isMemoryMapped() ? 1024 : 1;
+        const ts::TSPacket* pkt = nullptr;
+        size_t count = 0;
+        ts::PacketCounter packet_index = 0;
+        while (packet_index < opt.max_packets && (count = file.readPacketsInPlace(pkt, nullptr, max_read, opt)) > 0) {
+            for (size_t i = 0; i < count && packet_index < opt.max_packets; ++i, ++packet_index) {
+                if (opt.pids.test(pkt[i].getPID())) {
+                    if (!opt.log) {
+                        out << std::endl << "* Packet " << ts::UString::Decimal(packet_index) << std::endl;
+                    }
+                    pkt[i].display(out, opt.dump_flags, opt.log ? 0 : 2, opt.log_size);
                 }
-                pkt.display(out, opt.dump_flags, opt.log ? 0 : 2, opt.log_size);
             }
         }
         file.close(opt);
@@ -31,6 +31,7 @@
 //
 //----------------------------------------------------------------------------
 
+
 #include "tsMain.h"
 #include "tsDuckContext.h"
 #include "tsAsyncReport.h"
@@ -44,9 +45,17 @@
 #include "tsDuckProtocol.h"
 #include "tsVariable.h"
 #include "tsOneShotPacketizer.h"
+#include "tsMessageQueue.h"
+#include "tsMonotonic.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
+#if defined(TS_LINUX)
+#include <sys/epoll.h>
+#elif defined(TS_UNIX)
+#include <poll.h>
+#endif
+
 namespace {
     // Command line default arguments.
     static const uint16_t DEFAULT_SERVER_PORT       = 2222;
@@ -55,13 +64,26 @@ namespace {
     static const int16_t  DEFAULT_DELAY_STOP        = 200;
     static const int16_t  DEFAULT_TRANS_DELAY_START = -500;
     static const int16_t  DEFAULT_TRANS_DELAY_STOP  = 0;
+    static const size_t   DEFAULT_WORKERS           = 4;
 
     // Stack size for execution of the client connection thread
     static const size_t CLIENT_STACK_SIZE = 128 * 1024;
 
+    // Number of one-millisecond slots in the timer wheel of the event loop.
+    static const size_t TIMER_SLOTS = 1024;
+
+    // Maximum wait time in the event loop (must be less than one turn of the timer wheel).
+    static const ts::MilliSecond EVENT_LOOP_TIMEOUT = 1000;
+
     // Instantiation of a TCP connection in a multi-thread context for TLV messages.
     typedef ts::tlv::Connection<ts::Mutex> ECMGConnection;
     typedef ts::SafePtr<ECMGConnection, ts::Mutex> ECMGConnectionPtr;
+
+    // Format a timestamp.
+    ts::UString TimeStamp()
+    {
+        return ts::Time::CurrentLocalTime().format(ts::Time::DATE | ts::Time::TIME);
+    }
 }
 
 
@@ -81,6 +103,8 @@ namespace {
         int                        log_data;       // Log level for CW/ECM data messages.
         bool                       once;           // Accept only one client.
         bool                       reusePort;      // Socket option.
+        bool                       eventLoop;      // Serve all clients from one event loop.
+        size_t                     workers;        // Number of ECM worker threads in event loop mode.
         ts::MilliSecond            ecmCompTime;    // ECM computation time.
         ts::SocketAddress          serverAddress;  // TCP server local address.
         ts::ecmgscs::ChannelStatus channelStatus;  // Standard parameters required by this ECMG.
@@ -95,6 +119,8 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
     log_data(ts::Severity::Debug),
     once(false),
     reusePort(false),
+    eventLoop(false),
+    workers(0),
     ecmCompTime(0),
     serverAddress(),
     channelStatus(),
@@ -139,6 +165,15 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
          u"Specify the version of the ECMG <=> SCS DVB SimulCrypt protocol. "
          u"Valid values are 2 and 3. The default is 2.");
 
+    option(u"event-loop", 'e');
+    help(u"event-loop",
+         u"Serve all client connections from one single event loop thread instead of "
+         u"one thread per connection. The ECM's are built by a pool of worker threads "
+         u"(see option --workers) and the emulated computation time (see option --comp-time) "
+         u"is managed by a timer, without blocking any thread. Use this option when "
+         u"thousands of SCS connections are expected, typically in load tests. "
+         u"This option is not supported on Windows.");
+
     option(u"log-data", 0, ts::Severity::Enums, 0, 1, true);
     help(u"log-data", u"level",
          u"Same as --log-protocol but applies to CW_provision and ECM_response "
@@ -155,7 +190,8 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
     help(u"max-comp-time",
          u"Specify the maximum ECM computation time in milliseconds. This option sets "
          u"the DVB SimulCrypt option 'max_comp_time'. By default, use the value of "
-         u"--comp-time (which is itself zero by default) plus 100 ms.");
+         u"--comp-time (which is itself zero by default) plus 100 ms. "
+         u"A warning is reported for each ECM which is returned later than this delay.");
 
     option(u"no-reuse-port", 0);
     help(u"no-reuse-port", u"Disable the reuse port socket option. Do not use unless completely necessary.");
@@ -187,11 +223,18 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
          u"This option sets the DVB SimulCrypt option 'transition_delay_stop', in "
          u"milliseconds. Default: " + ts::UString::Decimal(DEFAULT_TRANS_DELAY_STOP) + u" ms.");
 
+    option(u"workers", 'w', POSITIVE);
+    help(u"workers", u"count",
+         u"With --event-loop, specify the number of worker threads which build the ECM's. "
+         u"Default: " + ts::UString::Decimal(DEFAULT_WORKERS) + u".");
+
     analyze(argc, argv);
 
     serverAddress.setPort(intValue<uint16_t>(u"port", DEFAULT_SERVER_PORT));
     once = present(u"once");
     reusePort = !present(u"no-reuse-port");
+    eventLoop = present(u"event-loop");
+    workers = intValue<size_t>(u"workers", DEFAULT_WORKERS);
     ecmCompTime = intValue<ts::MilliSecond>(u"comp-time", 0);
     log_protocol = present(u"log-protocol") ? intValue<int>(u"log-protocol", ts::Severity::Info) : ts::Severity::Debug;
     log_data = present(u"log-data") ? intValue<int>(u"log-data", ts::Severity::Info) : log_protocol;
@@ -223,6 +266,12 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
     channelStatus.min_CP_duration = 10;  // Minimum crypto period in 100 x ms, 1 second here.
     streamStatus.access_criteria_transfer_mode = false;  // We don't really need access criteria.
 
+#if defined(TS_WINDOWS)
+    if (eventLoop) {
+        error(u"--event-loop is not supported on Windows");
+    }
+#endif
+
     exitOnError();
 }
 
@@ -294,26 +343,356 @@ bool ECMGSharedData::closeChannel(uint16_t id)
 
 
 //----------------------------------------------------------------------------
-// A class implementing a thread which manages a client connection.
+// Build and send ECM responses, common to all modes.
 //----------------------------------------------------------------------------
 
-class ECMGClientHandler: public ts::Thread
+namespace {
+    // Build the ECM response to a valid CW_provision message.
+    void BuildECMResponse(const ECMGOptions& opt, const ts::ecmgscs::CWProvision& msg, ts::ecmgscs::ECMResponse& resp)
+    {
+        // Start to build the response.
+        resp.channel_id = msg.channel_id;
+        resp.stream_id = msg.stream_id;
+        resp.CP_number = msg.CP_number;
+
+        // Add all CW's in the ECM (in the clear, yeah, but that's a fake/test ECMG).
+        ts::duck::ClearECM ecm;
+        for (auto it = msg.CP_CW_combination.begin(); it != msg.CP_CW_combination.end(); ++it) {
+            if ((it->CP & 0x01) == 0) {
+                ecm.cw_even = it->CW;
+            }
+            else {
+                ecm.cw_odd = it->CW;
+            }
+        }
+
+        // Add optional access criteria in ECM.
+        if (msg.has_access_criteria) {
+            ecm.access_criteria = msg.access_criteria;
+        }
+
+        // Serialize the ECM section payload.
+        ts::ByteBlockPtr ecmBin(new ts::ByteBlock);
+        ts::tlv::Serializer serial(ecmBin);
+        ecm.serialize(serial);
+
+        // Compute the table id for the ECM, 0x80 or 0x81. There are two incompatible possibilities.
+        // First method is to copy the parity of the crypto period number. Second method is to
+        // alternate between the two, request after request in the stream. There is no requirement
+        // that the table id has the same parity as the CP. However, it is safe to do it just in
+        // case some CAS relies on it. On the other hand, if the SCS sends non-consecutive CP
+        // numbers, it is possible that two adjacent CP have the same parity. Anyway, since there
+        // is no perfect solution, we use the first one since it is simpler.
+        const ts::TID tid = ts::TID(ts::TID_ECM_80 | (msg.CP_number & 0x01));
+
+        // Build the ECM section.
+        ts::SectionPtr ecmSection(new ts::Section(tid, true, ecmBin->data(), ecmBin->size()));
+
+        // Format ECM for the response message.
+        if (opt.channelStatus.section_TSpkt_flag) {
+            // Send ECM as TS packets, packetize the section.
+            ts::TSPacketVector ecmPackets;
+            ts::OneShotPacketizer zer(opt.duck);
+            zer.addSection(ecmSection);
+            zer.getPackets(ecmPackets);
+            if (!ecmPackets.empty()) {
+                resp.ECM_datagram.copy(ecmPackets[0].b, ecmPackets.size() * ts::PKT_SIZE);
+            }
+        }
+        else {
+            // Send ECM as a section.
+            resp.ECM_datagram.copy(ecmSection->content(), ecmSection->size());
+        }
+    }
+
+    // Report ECM's which are returned after max_comp_time.
+    void CheckECMDelay(const ECMGOptions& opt, ECMGSharedData* shared, const ts::UString& peer, const ts::ecmgscs::ECMResponse& resp, const ts::Monotonic& received)
+    {
+        const ts::MilliSecond delay = (ts::Monotonic(true) - received) / ts::NanoSecPerMilliSec;
+        if (delay > opt.channelStatus.max_comp_time) {
+            shared->report().warning(u"%s: ECM for stream %d, CP %d returned after %'d ms, max_comp_time is %'d ms",
+                                     {peer, resp.stream_id, resp.CP_number, delay, opt.channelStatus.max_comp_time});
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// The output of a client connection in event loop mode. The responses are
+// queued by the event loop and the workers. They are sent by the event loop
+// thread only, without blocking, when the socket is writable. Once the
+// session is closed, all responses are dropped.
+//----------------------------------------------------------------------------
+
+class ECMGOutput
 {
-    TS_NOBUILD_NOCOPY(ECMGClientHandler);
+    TS_NOBUILD_NOCOPY(ECMGOutput);
 public:
     // Constructor.
-    // When deleteWhenTerminated is true, this object is automatically deleted when the thread terminates.
-    ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated);
+    ECMGOutput(ts::SysSocketType sock_, const ts::UString& peer_) :
+        sock(sock_),
+        peer(peer_),
+        waiting_output(false),
+        _mutex(),
+        _closed(false),
+        _data()
+    {
+    }
 
-    // Destructor.
-    virtual ~ECMGClientHandler() override;
+    const ts::SysSocketType sock;            // Socket of the client connection.
+    const ts::UString       peer;            // Name of the client.
+    bool                    waiting_output;  // The socket is monitored for output (event loop thread only).
 
-    // Main code of the thread.
-    virtual void main() override;
+    // Serialize and queue a message. Return false if the session is closed.
+    bool append(const ts::tlv::Message& msg, ts::tlv::Logger& logger);
+
+    // Check if the session is closed.
+    bool closed() const;
+
+    // Close the session, drop all pending data.
+    void close();
+
+    // Send as much pending data as possible without blocking (event loop thread only).
+    // Set remaining to true if some data could not be sent yet. Return false on error.
+    bool flush(bool& remaining, ts::Report& report);
+
+private:
+    mutable ts::Mutex _mutex;   // Protect the state and the pending data.
+    bool              _closed;  // The session is closed.
+    ts::ByteBlock     _data;    // Pending serialized messages.
+};
+
+typedef ts::SafePtr<ECMGOutput, ts::Mutex> ECMGOutputPtr;
+
+// Serialize and queue a message.
+bool ECMGOutput::append(const ts::tlv::Message& msg, ts::tlv::Logger& logger)
+{
+    ts::ByteBlockPtr bbp(new ts::ByteBlock);
+    ts::tlv::Serializer serial(bbp);
+    msg.serialize(serial);
+
+    ts::Guard lock(_mutex);
+    if (_closed) {
+        return false;
+    }
+    logger.log(msg, u"sending message to " + peer);
+    _data.append(*bbp);
+    return true;
+}
+
+// Check if the session is closed.
+bool ECMGOutput::closed() const
+{
+    ts::Guard lock(_mutex);
+    return _closed;
+}
+
+// Close the session, drop all pending data.
+void ECMGOutput::close()
+{
+    ts::Guard lock(_mutex);
+    _closed = true;
+    _data.clear();
+}
+
+// Send as much pending data as possible without blocking.
+bool ECMGOutput::flush(bool& remaining, ts::Report& report)
+{
+    ts::Guard lock(_mutex);
+    bool ok = true;
+    size_t start = 0;
+#if defined(TS_UNIX)
+    while (ok && !_closed && start < _data.size()) {
+        const ssize_t ret = ::send(sock, _data.data() + start, _data.size() - start, MSG_DONTWAIT);
+        if (ret >= 0) {
+            start += size_t(ret);
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            // Socket buffer full, wait until the socket is writable.
+            break;
+        }
+        else if (errno != EINTR) {
+            report.error(u"%s: error sending data: %s", {peer, ts::SysErrorCodeMessage()});
+            ok = false;
+        }
+    }
+#else
+    report.error(u"event loop not supported on this system");
+    ok = false;
+#endif
+    _data.erase(0, start);
+    remaining = ok && !_closed && !_data.empty();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Notification of the event loop by the workers when responses are queued.
+// A byte is written into a pipe which is monitored by the event loop.
+//----------------------------------------------------------------------------
+
+class ECMGNotifier
+{
+    TS_NOCOPY(ECMGNotifier);
+public:
+    // Constructor and destructor.
+    ECMGNotifier();
+    ~ECMGNotifier();
+
+    // Create the notification pipe.
+    bool open(ts::Report& report);
+
+    // Get the handle to monitor in the event loop.
+    ts::SysSocketType handle() const { return _read; }
+
+    // Notify the event loop that responses were queued in an output (worker threads).
+    void notify(const ECMGOutputPtr& output);
+
+    // Get the outputs with queued responses (event loop thread).
+    void get(std::vector<ECMGOutputPtr>& outputs);
+
+private:
+    ts::SysSocketType          _read;     // Read end of the pipe.
+    ts::SysSocketType          _write;    // Write end of the pipe.
+    ts::Mutex                  _mutex;    // Protect the list of outputs.
+    std::vector<ECMGOutputPtr> _outputs;  // Outputs with queued responses.
+};
+
+ECMGNotifier::ECMGNotifier() :
+    _read(ts::SYS_SOCKET_INVALID),
+    _write(ts::SYS_SOCKET_INVALID),
+    _mutex(),
+    _outputs()
+{
+}
+
+ECMGNotifier::~ECMGNotifier()
+{
+#if defined(TS_UNIX)
+    if (_read != ts::SYS_SOCKET_INVALID) {
+        ::close(_read);
+        ::close(_write);
+    }
+#endif
+}
+
+// Create the notification pipe.
+bool ECMGNotifier::open(ts::Report& report)
+{
+#if defined(TS_UNIX)
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        report.error(u"error creating pipe: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+    // Both ends are non-blocking: the workers never wait and the event loop drains the pipe.
+    for (size_t i = 0; i < 2; ++i) {
+        ::fcntl(fds[i], F_SETFL, ::fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        ::fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    _read = fds[0];
+    _write = fds[1];
+    return true;
+#else
+    report.error(u"event loop not supported on this system");
+    return false;
+#endif
+}
+
+// Notify the event loop that responses were queued in an output.
+void ECMGNotifier::notify(const ECMGOutputPtr& output)
+{
+    ts::Guard lock(_mutex);
+    _outputs.push_back(output);
+#if defined(TS_UNIX)
+    // Wake up the event loop only once until it gets the list of outputs.
+    const uint8_t byte = 0;
+    if (_outputs.size() == 1 && ::write(_write, &byte, 1) < 0) {
+        // The pipe is full, the event loop is already notified.
+    }
+#endif
+}
+
+// Get the outputs with queued responses.
+void ECMGNotifier::get(std::vector<ECMGOutputPtr>& outputs)
+{
+#if defined(TS_UNIX)
+    // Drain the pipe before getting the list. A notification which comes
+    // after getting the list is kept in the pipe for the next time.
+    uint8_t buffer[64];
+    while (::read(_read, buffer, sizeof(buffer)) > 0) {
+    }
+#endif
+    outputs.clear();
+    ts::Guard lock(_mutex);
+    outputs.swap(_outputs);
+}
+
+
+//----------------------------------------------------------------------------
+// An ECM request, when the ECM is built outside the client session.
+//----------------------------------------------------------------------------
+
+class ECMRequest
+{
+    TS_NOBUILD_NOCOPY(ECMRequest);
+public:
+    // Constructor.
+    ECMRequest(const ECMGOutputPtr& output_, const ts::ecmgscs::CWProvision& msg_, const ts::Monotonic& received_) :
+        output(output_),
+        msg(msg_),
+        received(received_)
+    {
+    }
+
+    ECMGOutputPtr            output;    // Output of the client connection.
+    ts::ecmgscs::CWProvision msg;       // Copy of the request.
+    ts::Monotonic            received;  // Reception time of the request.
+};
+
+typedef ts::SafePtr<ECMRequest, ts::Mutex> ECMRequestPtr;
+
+// Interface of an object which sends the responses and builds the ECM's out of the client session.
+class ECMSchedulerInterface
+{
+public:
+    // Send a response message to the client of a socket. Return false on error.
+    virtual bool sendMessage(ts::SysSocketType sock, const ts::tlv::Message& msg) = 0;
+
+    // Schedule the computation of an ECM for the client of a socket.
+    virtual void scheduleECM(ts::SysSocketType sock, const ts::ecmgscs::CWProvision& msg, const ts::Monotonic& received) = 0;
+
+    // Virtual destructor.
+    virtual ~ECMSchedulerInterface() {}
+};
+
+
+//----------------------------------------------------------------------------
+// A class implementing the protocol of a client session.
+//----------------------------------------------------------------------------
+
+class ECMGSession
+{
+    TS_NOBUILD_NOCOPY(ECMGSession);
+public:
+    // Constructor.
+    // When scheduler is null, the responses and ECM's are built and sent in the context of the caller.
+    ECMGSession(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, ECMSchedulerInterface* scheduler);
+
+    // Destructor, release the channel if not done by the client.
+    ~ECMGSession();
+
+    // Process one message from the client. Return false on error, when the session must be terminated.
+    bool handleMessage(const ts::tlv::MessagePtr& msg);
+
+    // Get the connection and the name of the client.
+    const ECMGConnectionPtr& connection() const { return _conn; }
+    const ts::UString& peer() const { return _peer; }
 
 private:
     const ECMGOptions&          _opt;
     ECMGSharedData*             _shared;
+    ECMSchedulerInterface*      _scheduler;
     ECMGConnectionPtr           _conn;
     ts::UString                 _peer;
     ts::Variable<uint16_t>      _channel;  // Current channel id.
@@ -331,111 +710,70 @@ private:
     // Send a response message.
     bool send(const ts::tlv::Message* msg)
     {
-        return _conn->send(*msg, _shared->logger());
+        return _scheduler != nullptr ? _scheduler->sendMessage(_conn->getSocket(), *msg) : _conn->send(*msg, _shared->logger());
     }
 
     // Send an error related to the msg.
     bool sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus);
-
-    // Format a timestamp.
-    static ts::UString TimeStamp()
-    {
-        return ts::Time::CurrentLocalTime().format(ts::Time::DATE | ts::Time::TIME);
-    }
 };
 
 
 //----------------------------------------------------------------------------
-// ECMG client constructor and destructor.
+// ECMG session constructor and destructor.
 //----------------------------------------------------------------------------
 
-ECMGClientHandler::ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated) :
-    ts::Thread(),
+ECMGSession::ECMGSession(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, ECMSchedulerInterface* scheduler) :
     _opt(opt),
     _shared(shared),
+    _scheduler(scheduler),
     _conn(conn),
-    _peer(),
+    _peer(conn->peerName()),
     _channel(),
     _streams()
 {
-    // Set thread attributes. Beware of deleteWhenTerminated...
-    ts::ThreadAttributes attr;
-    attr.setStackSize(CLIENT_STACK_SIZE);
-    attr.setDeleteWhenTerminated(deleteWhenTerminated);
-    setAttributes(attr);
 }
 
-ECMGClientHandler::~ECMGClientHandler()
+ECMGSession::~ECMGSession()
 {
-    // Wait for completion of the thread.
-    waitForTermination();
+    // Make sure to release the channel if not done by the clients.
+    if (_channel.set()) {
+        _shared->closeChannel(_channel.value());
+        _channel.clear();
+    }
 }
 
 
 //----------------------------------------------------------------------------
-// Main code of the client connection thread.
+// Process one message from the client.
 //----------------------------------------------------------------------------
 
-void ECMGClientHandler::main()
+bool ECMGSession::handleMessage(const ts::tlv::MessagePtr& msg)
 {
-    _peer = _conn->peerName();
-    _shared->report().verbose(u"%s: %s: session started", {_peer, TimeStamp()});
-
-    // Normally, an ECMG should handle incoming and outgoing messages independently.
-    // However, here we have a minimal implementation. We never send any request to
-    // the client and the ECM generation is instantaneous. So, we simply wait for
-    // requests from the client and respond to them immediately.
-
-    // Loop on message reception
-    ts::tlv::MessagePtr msg;
-    bool ok = true;
-    while (ok && _conn->receive(msg, nullptr, _shared->logger())) {
-        switch (msg->tag()) {
-            case ts::ecmgscs::Tags::channel_setup:
-                ok = handleChannelSetup(dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::channel_test:
-                ok = handleChannelTest(dynamic_cast<ts::ecmgscs::ChannelTest*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::channel_close:
-                ok = handleChannelClose(dynamic_cast<ts::ecmgscs::ChannelClose*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::stream_setup:
-                ok = handleStreamSetup(dynamic_cast<ts::ecmgscs::StreamSetup*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::stream_test:
-                ok = handleStreamTest(dynamic_cast<ts::ecmgscs::StreamTest*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::stream_close_request:
-                ok = handleStreamCloseRequest(dynamic_cast<ts::ecmgscs::StreamCloseRequest*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::CW_provision:
-                ok = handleCWProvision(dynamic_cast<ts::ecmgscs::CWProvision*>(msg.pointer()));
-                break;
-            case ts::ecmgscs::Tags::channel_status:
-            case ts::ecmgscs::Tags::stream_status:
-            case ts::ecmgscs::Tags::channel_error:
-            case ts::ecmgscs::Tags::stream_error:
-                // Silently ignore unsollicited status or error messages.
-                break;
-            default:
-                // Received an invalid message for ECMG.
-                ok = sendErrorResponse(msg.pointer(), ts::ecmgscs::Errors::inv_message);
-                break;
-        }
-    }
-
-    // Error while receiving or sending messages, most likely a client disconnection.
-    _conn->disconnect(NULLREP);
-    _conn->close(_shared->report());
-
-    // Make sure to release the channel if not done by the clients.
-    if (_channel.set()) {
-        _shared->closeChannel(_channel.value());
-        _channel.clear();
+    switch (msg->tag()) {
+        case ts::ecmgscs::Tags::channel_setup:
+            return handleChannelSetup(dynamic_cast<ts::ecmgscs::ChannelSetup*>(msg.pointer()));
+        case ts::ecmgscs::Tags::channel_test:
+            return handleChannelTest(dynamic_cast<ts::ecmgscs::ChannelTest*>(msg.pointer()));
+        case ts::ecmgscs::Tags::channel_close:
+            return handleChannelClose(dynamic_cast<ts::ecmgscs::ChannelClose*>(msg.pointer()));
+        case ts::ecmgscs::Tags::stream_setup:
+            return handleStreamSetup(dynamic_cast<ts::ecmgscs::StreamSetup*>(msg.pointer()));
+        case ts::ecmgscs::Tags::stream_test:
+            return handleStreamTest(dynamic_cast<ts::ecmgscs::StreamTest*>(msg.pointer()));
+        case ts::ecmgscs::Tags::stream_close_request:
+            return handleStreamCloseRequest(dynamic_cast<ts::ecmgscs::StreamCloseRequest*>(msg.pointer()));
+        case ts::ecmgscs::Tags::CW_provision:
+            return handleCWProvision(dynamic_cast<ts::ecmgscs::CWProvision*>(msg.pointer()));
+        case ts::ecmgscs::Tags::channel_status:
+        case ts::ecmgscs::Tags::stream_status:
+        case ts::ecmgscs::Tags::channel_error:
+        case ts::ecmgscs::Tags::stream_error:
+            // Silently ignore unsollicited status or error messages.
+            return true;
+        default:
+            // Received an invalid message for ECMG.
+            return sendErrorResponse(msg.pointer(), ts::ecmgscs::Errors::inv_message);
     }
-
-    _shared->report().verbose(u"%s: %s: session completed", {_peer, TimeStamp()});
 }
 
 
@@ -443,7 +781,7 @@ void ECMGClientHandler::main()
 // Send an error related to the msg.
 //----------------------------------------------------------------------------
 
-bool ECMGClientHandler::sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus)
+bool ECMGSession::sendErrorResponse(const ts::tlv::Message* msg, uint16_t errorStatus)
 {
     const ts::tlv::ChannelMessage* channelMsg = nullptr;
     const ts::tlv::StreamMessage* streamMsg = nullptr;
@@ -481,7 +819,7 @@ bool ECMGClientHandler::sendErrorResponse(const ts::tlv::Message* msg, uint16_t
 // Handle the various types of messages from the client.
 //----------------------------------------------------------------------------
 
-bool ECMGClientHandler::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
+bool ECMGSession::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
 {
     assert(msg != nullptr);
     if (_channel.set()) {
@@ -502,7 +840,7 @@ bool ECMGClientHandler::handleChannelSetup(ts::ecmgscs::ChannelSetup* msg)
 }
 
 
-bool ECMGClientHandler::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
+bool ECMGSession::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -519,7 +857,7 @@ bool ECMGClientHandler::handleChannelTest(ts::ecmgscs::ChannelTest* msg)
 }
 
 
-bool ECMGClientHandler::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
+bool ECMGSession::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -536,7 +874,7 @@ bool ECMGClientHandler::handleChannelClose(ts::ecmgscs::ChannelClose* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
+bool ECMGSession::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -559,7 +897,7 @@ bool ECMGClientHandler::handleStreamSetup(ts::ecmgscs::StreamSetup* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamTest(ts::ecmgscs::StreamTest* msg)
+bool ECMGSession::handleStreamTest(ts::ecmgscs::StreamTest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -581,7 +919,7 @@ bool ECMGClientHandler::handleStreamTest(ts::ecmgscs::StreamTest* msg)
 }
 
 
-bool ECMGClientHandler::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg)
+bool ECMGSession::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest* msg)
 {
     assert(msg != nullptr);
     if (_channel != msg->channel_id) {
@@ -603,9 +941,11 @@ bool ECMGClientHandler::handleStreamCloseRequest(ts::ecmgscs::StreamCloseRequest
 }
 
 
-bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
+bool ECMGSession::handleCWProvision(ts::ecmgscs::CWProvision* msg)
 {
     assert(msg != nullptr);
+    const ts::Monotonic received(true);
+
     if (_channel != msg->channel_id) {
         // Not the right channel.
         return sendErrorResponse(msg, ts::ecmgscs::Errors::inv_channel_id);
@@ -618,76 +958,759 @@ bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
         // Not the right number of CW in the request.
         return sendErrorResponse(msg, ts::ecmgscs::Errors::not_enough_CW);
     }
+
+    // Check if 16-bit crypto-period numbers wrap over 0xFFFF.
+    const uint16_t cpMax = msg->CP_number + _opt.channelStatus.lead_CW;
+    const bool cpWrap = cpMax < msg->CP_number;
+
+    // Check the crypto-period numbers of all CW's.
+    for (auto it = msg->CP_CW_combination.begin(); it != msg->CP_CW_combination.end(); ++it) {
+        if ((!cpWrap && (it->CP < msg->CP_number || it->CP > cpMax)) || (cpWrap && it->CP > cpMax && it->CP < msg->CP_number)) {
+            // Incorrect CP/CW combination.
+            return sendErrorResponse(msg, ts::ecmgscs::Errors::not_enough_CW);
+        }
+    }
+
+    if (_scheduler != nullptr) {
+        // The ECM is built and sent later, out of the session.
+        _scheduler->scheduleECM(_conn->getSocket(), *msg, received);
+        return true;
+    }
     else {
-        // Start to build the response.
         ts::ecmgscs::ECMResponse resp;
-        resp.channel_id = msg->channel_id;
-        resp.stream_id = msg->stream_id;
-        resp.CP_number = msg->CP_number;
+        BuildECMResponse(_opt, *msg, resp);
 
-        // Check if 16-bit crypto-period numbers wrap over 0xFFFF.
-        const uint16_t cpMax = msg->CP_number + _opt.channelStatus.lead_CW;
-        const bool cpWrap = cpMax < msg->CP_number;
-
-        // Add all CW's in the ECM (in the clear, yeah, but that's a fake/test ECMG).
-        ts::duck::ClearECM ecm;
-        for (auto it = msg->CP_CW_combination.begin(); it != msg->CP_CW_combination.end(); ++it) {
-            if ((!cpWrap && (it->CP < msg->CP_number || it->CP > cpMax)) || (cpWrap && it->CP > cpMax && it->CP < msg->CP_number)) {
-                // Incorrect CP/CW combination.
-                return sendErrorResponse(msg, ts::ecmgscs::Errors::not_enough_CW);
-            }
-            if ((it->CP & 0x01) == 0) {
-                ecm.cw_even = it->CW;
-            }
-            else {
-                ecm.cw_odd = it->CW;
-            }
+        // Emulate the computation time of a real ECMG.
+        if (_opt.ecmCompTime > 0) {
+            ts::SleepThread(_opt.ecmCompTime);
         }
 
-        // Add optional access criteria in ECM.
-        if (msg->has_access_criteria) {
-            ecm.access_criteria = msg->access_criteria;
+        const bool ok = send(&resp);
+        if (ok) {
+            CheckECMDelay(_opt, _shared, _peer, resp, received);
         }
+        return ok;
+    }
+}
 
-        // Serialize the ECM section payload.
-        ts::ByteBlockPtr ecmBin(new ts::ByteBlock);
-        ts::tlv::Serializer serial(ecmBin);
-        ecm.serialize(serial);
 
-        // Compute the table id for the ECM, 0x80 or 0x81. There are two incompatible possibilities.
-        // First method is to copy the parity of the crypto period number. Second method is to
-        // alternate between the two, request after request in the stream. There is no requirement
-        // that the table id has the same parity as the CP. However, it is safe to do it just in
-        // case some CAS relies on it. On the other hand, if the SCS sends non-consecutive CP
-        // numbers, it is possible that two adjacent CP have the same parity. Anyway, since there
-        // is no perfect solution, we use the first one since it is simpler.
-        const ts::TID tid = ts::TID(ts::TID_ECM_80 | (msg->CP_number & 0x01));
+//----------------------------------------------------------------------------
+// A class implementing a thread which manages a client connection.
+//----------------------------------------------------------------------------
 
-        // Build the ECM section.
-        ts::SectionPtr ecmSection(new ts::Section(tid, true, ecmBin->data(), ecmBin->size()));
+class ECMGClientHandler: public ts::Thread
+{
+    TS_NOBUILD_NOCOPY(ECMGClientHandler);
+public:
+    // Constructor.
+    // When deleteWhenTerminated is true, this object is automatically deleted when the thread terminates.
+    ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated);
 
-        // Format ECM for the response message.
-        if (_opt.channelStatus.section_TSpkt_flag) {
-            // Send ECM as TS packets, packetize the section.
-            ts::TSPacketVector ecmPackets;
-            ts::OneShotPacketizer zer(_opt.duck);
-            zer.addSection(ecmSection);
-            zer.getPackets(ecmPackets);
-            if (!ecmPackets.empty()) {
-                resp.ECM_datagram.copy(ecmPackets[0].b, ecmPackets.size() * ts::PKT_SIZE);
+    // Destructor.
+    virtual ~ECMGClientHandler() override;
+
+    // Main code of the thread.
+    virtual void main() override;
+
+private:
+    const ECMGOptions& _opt;
+    ECMGSharedData*    _shared;
+    ECMGConnectionPtr  _conn;
+};
+
+
+//----------------------------------------------------------------------------
+// ECMG client constructor and destructor.
+//----------------------------------------------------------------------------
+
+ECMGClientHandler::ECMGClientHandler(const ECMGOptions& opt, const ECMGConnectionPtr& conn, ECMGSharedData* shared, bool deleteWhenTerminated) :
+    ts::Thread(),
+    _opt(opt),
+    _shared(shared),
+    _conn(conn)
+{
+    // Set thread attributes. Beware of deleteWhenTerminated...
+    ts::ThreadAttributes attr;
+    attr.setStackSize(CLIENT_STACK_SIZE);
+    attr.setDeleteWhenTerminated(deleteWhenTerminated);
+    setAttributes(attr);
+}
+
+ECMGClientHandler::~ECMGClientHandler()
+{
+    // Wait for completion of the thread.
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Main code of the client connection thread.
+//----------------------------------------------------------------------------
+
+void ECMGClientHandler::main()
+{
+    ts::UString peer;
+    {
+        ECMGSession session(_opt, _conn, _shared, nullptr);
+        peer = session.peer();
+        _shared->report().verbose(u"%s: %s: session started", {peer, TimeStamp()});
+
+        // Normally, an ECMG should handle incoming and outgoing messages independently.
+        // However, here we have a minimal implementation. We never send any request to
+        // the client and the ECM generation is instantaneous. So, we simply wait for
+        // requests from the client and respond to them immediately.
+
+        // Loop on message reception
+        ts::tlv::MessagePtr msg;
+        bool ok = true;
+        while (ok && _conn->receive(msg, nullptr, _shared->logger())) {
+            ok = session.handleMessage(msg);
+        }
+
+        // Error while receiving or sending messages, most likely a client disconnection.
+        _conn->disconnect(NULLREP);
+        _conn->close(_shared->report());
+    }
+    _shared->report().verbose(u"%s: %s: session completed", {peer, TimeStamp()});
+}
+
+
+//----------------------------------------------------------------------------
+// A timer wheel, used in event loop mode for the ECM deadlines.
+// Each slot represents one millisecond. Events which are more than one turn
+// of the wheel ahead remain in their slot until their actual time.
+//----------------------------------------------------------------------------
+
+template <typename T>
+class TimerWheel
+{
+    TS_NOCOPY(TimerWheel);
+public:
+    // Constructor.
+    explicit TimerWheel(size_t slots) :
+        _origin(true),
+        _current(0),
+        _next(NONE),
+        _count(0),
+        _slots(slots)
+    {
+    }
+
+    // Add an item which expires at the specified time.
+    void add(const ts::Monotonic& due, const T& item)
+    {
+        const int64_t tick = std::max(ticks(due), _current + 1);
+        _slots[size_t(tick % int64_t(_slots.size()))].push_back(std::make_pair(tick, item));
+        _next = std::min(_next, tick);
+        _count++;
+    }
+
+    // Get the number of milliseconds before the next expiration, up to a maximum.
+    ts::MilliSecond timeout(const ts::Monotonic& now, ts::MilliSecond max_timeout) const
+    {
+        return _count == 0 ? max_timeout : std::max<ts::MilliSecond>(0, std::min<ts::MilliSecond>(max_timeout, _next - ticks(now)));
+    }
+
+    // Remove all items which are expired at the specified time.
+    void expire(const ts::Monotonic& now, std::list<T>& expired)
+    {
+        const int64_t last = ticks(now);
+        if (_next <= last) {
+            const int64_t count = std::min(last - _current, int64_t(_slots.size()));
+            for (int64_t tick = _current + 1; _count > 0 && tick <= _current + count; ++tick) {
+                Slot& slot(_slots[size_t(tick % int64_t(_slots.size()))]);
+                for (auto it = slot.begin(); it != slot.end(); ) {
+                    if (it->first <= last) {
+                        expired.push_back(it->second);
+                        it = slot.erase(it);
+                        _count--;
+                    }
+                    else {
+                        ++it;
+                    }
+                }
             }
+            _current = std::max(_current, last);
+            findNext();
         }
         else {
-            // Send ECM as a section.
-            resp.ECM_datagram.copy(ecmSection->content(), ecmSection->size());
+            _current = std::max(_current, last);
         }
+    }
 
-        // Emulate the computation time of a real ECMG.
-        if (_opt.ecmCompTime > 0) {
-            ts::SleepThread(_opt.ecmCompTime);
+private:
+    typedef std::list<std::pair<int64_t,T>> Slot;
+    static constexpr int64_t NONE = std::numeric_limits<int64_t>::max();
+
+    ts::Monotonic     _origin;   // Time of tick zero.
+    int64_t           _current;  // Last expired tick.
+    int64_t           _next;     // First tick with an item, NONE when the wheel is empty.
+    size_t            _count;    // Number of items in the wheel.
+    std::vector<Slot> _slots;    // Items by expiration tick modulo the number of slots.
+
+    // Recompute the first tick with an item, after expiration.
+    // Usually, it is found in the next turn of the wheel, after a few slots.
+    void findNext()
+    {
+        _next = NONE;
+        if (_count > 0) {
+            for (int64_t tick = _current + 1; tick <= _current + int64_t(_slots.size()); ++tick) {
+                const Slot& slot(_slots[size_t(tick % int64_t(_slots.size()))]);
+                for (auto it = slot.begin(); it != slot.end(); ++it) {
+                    if (it->first == tick) {
+                        _next = tick;
+                        return;
+                    }
+                }
+            }
+            // All items are more than one turn ahead.
+            for (auto sit = _slots.begin(); sit != _slots.end(); ++sit) {
+                for (auto it = sit->begin(); it != sit->end(); ++it) {
+                    _next = std::min(_next, it->first);
+                }
+            }
         }
+    }
 
-        return send(&resp);
+    // Number of ticks since the origin.
+    int64_t ticks(const ts::Monotonic& time) const
+    {
+        return (time - _origin) / ts::NanoSecPerMilliSec;
+    }
+};
+
+
+//----------------------------------------------------------------------------
+// Wait for readable or writable sockets (epoll on Linux, poll on other UNIX).
+//----------------------------------------------------------------------------
+
+class SocketPoller
+{
+    TS_NOCOPY(SocketPoller);
+public:
+    // Constructor and destructor.
+    SocketPoller();
+    ~SocketPoller();
+
+    // Add or remove a socket to monitor. The sockets are initially monitored for input only.
+    bool add(ts::SysSocketType sock, ts::Report& report);
+    bool remove(ts::SysSocketType sock, ts::Report& report);
+
+    // Start or stop monitoring a socket for output.
+    bool setOutput(ts::SysSocketType sock, bool on, ts::Report& report);
+
+    // Wait for readable or writable sockets. The lists of ready sockets are empty on timeout.
+    bool wait(std::vector<ts::SysSocketType>& readable, std::vector<ts::SysSocketType>& writable, ts::MilliSecond timeout, ts::Report& report);
+
+private:
+#if defined(TS_LINUX)
+    int _epoll;
+    std::vector<::epoll_event> _events;
+#elif defined(TS_UNIX)
+    std::vector<::pollfd> _fds;
+#endif
+};
+
+SocketPoller::SocketPoller()
+#if defined(TS_LINUX)
+    : _epoll(::epoll_create1(EPOLL_CLOEXEC)),
+      _events(256)
+#elif defined(TS_UNIX)
+    : _fds()
+#endif
+{
+}
+
+SocketPoller::~SocketPoller()
+{
+#if defined(TS_LINUX)
+    if (_epoll >= 0) {
+        ::close(_epoll);
+    }
+#endif
+}
+
+bool SocketPoller::add(ts::SysSocketType sock, ts::Report& report)
+{
+#if defined(TS_LINUX)
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = sock;
+    if (::epoll_ctl(_epoll, EPOLL_CTL_ADD, sock, &ev) != 0) {
+        report.error(u"epoll_ctl error: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+    return true;
+#elif defined(TS_UNIX)
+    ::pollfd pfd;
+    TS_ZERO(pfd);
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+    _fds.push_back(pfd);
+    return true;
+#else
+    report.error(u"event loop not supported on this system");
+    return false;
+#endif
+}
+
+bool SocketPoller::remove(ts::SysSocketType sock, ts::Report& report)
+{
+#if defined(TS_LINUX)
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    if (::epoll_ctl(_epoll, EPOLL_CTL_DEL, sock, &ev) != 0) {
+        report.error(u"epoll_ctl error: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+    return true;
+#elif defined(TS_UNIX)
+    for (auto it = _fds.begin(); it != _fds.end(); ++it) {
+        if (it->fd == sock) {
+            _fds.erase(it);
+            break;
+        }
+    }
+    return true;
+#else
+    report.error(u"event loop not supported on this system");
+    return false;
+#endif
+}
+
+bool SocketPoller::setOutput(ts::SysSocketType sock, bool on, ts::Report& report)
+{
+#if defined(TS_LINUX)
+    ::epoll_event ev;
+    TS_ZERO(ev);
+    ev.events = on ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    ev.data.fd = sock;
+    if (::epoll_ctl(_epoll, EPOLL_CTL_MOD, sock, &ev) != 0) {
+        report.error(u"epoll_ctl error: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+    return true;
+#elif defined(TS_UNIX)
+    for (auto it = _fds.begin(); it != _fds.end(); ++it) {
+        if (it->fd == sock) {
+            it->events = on ? (POLLIN | POLLOUT) : POLLIN;
+            break;
+        }
+    }
+    return true;
+#else
+    report.error(u"event loop not supported on this system");
+    return false;
+#endif
+}
+
+bool SocketPoller::wait(std::vector<ts::SysSocketType>& readable, std::vector<ts::SysSocketType>& writable, ts::MilliSecond timeout, ts::Report& report)
+{
+    readable.clear();
+    writable.clear();
+#if defined(TS_LINUX)
+    const int count = ::epoll_wait(_epoll, _events.data(), int(_events.size()), int(timeout));
+    if (count < 0 && errno != EINTR) {
+        report.error(u"epoll_wait error: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        if ((_events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0) {
+            readable.push_back(_events[i].data.fd);
+        }
+        if ((_events[i].events & EPOLLOUT) != 0) {
+            writable.push_back(_events[i].data.fd);
+        }
+    }
+    return true;
+#elif defined(TS_UNIX)
+    const int count = ::poll(_fds.data(), ::nfds_t(_fds.size()), int(timeout));
+    if (count < 0 && errno != EINTR) {
+        report.error(u"poll error: %s", {ts::SysErrorCodeMessage()});
+        return false;
+    }
+    for (size_t i = 0; count > 0 && i < _fds.size(); ++i) {
+        if ((_fds[i].revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+            readable.push_back(_fds[i].fd);
+        }
+        if ((_fds[i].revents & POLLOUT) != 0) {
+            writable.push_back(_fds[i].fd);
+        }
+    }
+    return true;
+#else
+    report.error(u"event loop not supported on this system");
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// A worker thread which builds and queues ECM's in event loop mode.
+//----------------------------------------------------------------------------
+
+typedef ts::MessageQueue<ECMRequest, ts::Mutex> ECMRequestQueue;
+
+class ECMGWorker: public ts::Thread
+{
+    TS_NOBUILD_NOCOPY(ECMGWorker);
+public:
+    // Constructor and destructor.
+    ECMGWorker(const ECMGOptions& opt, ECMGSharedData* shared, ECMRequestQueue& queue, ECMGNotifier& notifier);
+    virtual ~ECMGWorker() override;
+
+private:
+    const ECMGOptions& _opt;
+    ECMGSharedData*    _shared;
+    ECMRequestQueue&   _queue;
+    ECMGNotifier&      _notifier;
+
+    // Main code of the thread.
+    virtual void main() override;
+};
+
+ECMGWorker::ECMGWorker(const ECMGOptions& opt, ECMGSharedData* shared, ECMRequestQueue& queue, ECMGNotifier& notifier) :
+    ts::Thread(ts::ThreadAttributes().setStackSize(CLIENT_STACK_SIZE)),
+    _opt(opt),
+    _shared(shared),
+    _queue(queue),
+    _notifier(notifier)
+{
+}
+
+ECMGWorker::~ECMGWorker()
+{
+    waitForTermination();
+}
+
+void ECMGWorker::main()
+{
+    // A null request means terminate.
+    ECMRequestPtr request;
+    while (_queue.dequeue(request) && !request.isNull()) {
+        // The requests of the sessions which were closed in the meantime are dropped.
+        // The response is sent by the event loop, the workers never write on the sockets.
+        if (!request->output->closed()) {
+            ts::ecmgscs::ECMResponse resp;
+            BuildECMResponse(_opt, request->msg, resp);
+            if (request->output->append(resp, _shared->logger())) {
+                _notifier.notify(request->output);
+                CheckECMDelay(_opt, _shared, request->output->peer, resp, request->received);
+            }
+        }
+        request.clear();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// The event loop, serving all client connections from one thread.
+//----------------------------------------------------------------------------
+
+class ECMGEventLoop: private ECMSchedulerInterface
+{
+    TS_NOBUILD_NOCOPY(ECMGEventLoop);
+public:
+    // Constructor and destructor.
+    ECMGEventLoop(const ECMGOptions& opt, ECMGSharedData* shared, ts::TCPServer& server);
+    virtual ~ECMGEventLoop() override;
+
+    // Run the event loop. Return when the server fails or at the end of the session with --once.
+    bool run();
+
+private:
+    typedef ts::SafePtr<ECMGSession, ts::NullMutex> ECMGSessionPtr;
+    typedef ts::SafePtr<ECMGWorker, ts::NullMutex> ECMGWorkerPtr;
+
+    // A client session and its output.
+    struct ECMGClient
+    {
+        ECMGClient() : session(), output() {}
+        ECMGSessionPtr session;
+        ECMGOutputPtr  output;
+    };
+
+    const ECMGOptions&                     _opt;
+    ECMGSharedData*                        _shared;
+    ts::TCPServer&                         _server;
+    SocketPoller                           _poller;
+    ECMRequestQueue                        _queue;     // ECM requests to workers.
+    ECMGNotifier                           _notifier;  // Notifications of queued ECM's from the workers.
+    TimerWheel<ECMRequestPtr>              _timers;    // ECM requests waiting for the computation time.
+    std::vector<ECMGWorkerPtr>             _workers;   // Worker threads.
+    std::map<ts::SysSocketType,ECMGClient> _sessions;  // Client sessions, indexed by socket.
+
+    // Accept a new client connection.
+    bool acceptClient();
+
+    // Process all available messages from a client. Return false if the session is terminated.
+    bool receiveMessages(const ECMGClient& client);
+
+    // Send the pending responses of a client without blocking. The socket is monitored
+    // for output as long as some data remain to send. Return false on error.
+    bool flushOutput(const ECMGOutputPtr& output);
+
+    // Terminate a client session.
+    void closeSession(ts::SysSocketType sock);
+
+    // Implementation of ECMSchedulerInterface.
+    virtual bool sendMessage(ts::SysSocketType sock, const ts::tlv::Message& msg) override;
+    virtual void scheduleECM(ts::SysSocketType sock, const ts::ecmgscs::CWProvision& msg, const ts::Monotonic& received) override;
+};
+
+
+//----------------------------------------------------------------------------
+// Event loop constructor and destructor.
+//----------------------------------------------------------------------------
+
+ECMGEventLoop::ECMGEventLoop(const ECMGOptions& opt, ECMGSharedData* shared, ts::TCPServer& server) :
+    _opt(opt),
+    _shared(shared),
+    _server(server),
+    _poller(),
+    _queue(),
+    _notifier(),
+    _timers(TIMER_SLOTS),
+    _workers(),
+    _sessions()
+{
+}
+
+ECMGEventLoop::~ECMGEventLoop()
+{
+    // Close all client sessions.
+    while (!_sessions.empty()) {
+        closeSession(_sessions.begin()->first);
+    }
+
+    // Send a termination request to all workers and wait for them.
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        ECMRequestPtr end;
+        _queue.forceEnqueue(end);
+    }
+    _workers.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Send a response message (called from the sessions).
+//----------------------------------------------------------------------------
+
+bool ECMGEventLoop::sendMessage(ts::SysSocketType sock, const ts::tlv::Message& msg)
+{
+    const auto it = _sessions.find(sock);
+    return it != _sessions.end() && it->second.output->append(msg, _shared->logger()) && flushOutput(it->second.output);
+}
+
+
+//----------------------------------------------------------------------------
+// Schedule the computation of an ECM (called from the sessions).
+//----------------------------------------------------------------------------
+
+void ECMGEventLoop::scheduleECM(ts::SysSocketType sock, const ts::ecmgscs::CWProvision& msg, const ts::Monotonic& received)
+{
+    const auto it = _sessions.find(sock);
+    if (it == _sessions.end()) {
+        return;
+    }
+
+    ECMRequestPtr request(new ECMRequest(it->second.output, msg, received));
+    ts::CheckNonNull(request.pointer());
+
+    if (_opt.ecmCompTime <= 0) {
+        // Send the request immediately to the workers.
+        _queue.forceEnqueue(request);
+    }
+    else {
+        // Wait for the emulated computation time in the timer wheel.
+        ts::Monotonic due(received);
+        due += _opt.ecmCompTime * ts::NanoSecPerMilliSec;
+        _timers.add(due, request);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Run the event loop.
+//----------------------------------------------------------------------------
+
+bool ECMGEventLoop::run()
+{
+    // Thousands of client connections need as many file descriptors.
+    ts::RaiseOpenFilesLimit(0, _shared->report());
+
+    // The workers notify the event loop through a pipe when ECM's are ready to send.
+    if (!_notifier.open(_shared->report()) || !_poller.add(_notifier.handle(), _shared->report())) {
+        return false;
+    }
+
+    // Start the worker threads.
+    for (size_t i = 0; i < _opt.workers; ++i) {
+        ECMGWorkerPtr worker(new ECMGWorker(_opt, _shared, _queue, _notifier));
+        ts::CheckNonNull(worker.pointer());
+        _workers.push_back(worker);
+        worker->start();
+    }
+
+    // Monitor the incoming client connections.
+    bool accepting = _poller.add(_server.getSocket(), _shared->report());
+    bool ok = accepting;
+
+    std::vector<ts::SysSocketType> readable;
+    std::vector<ts::SysSocketType> writable;
+    std::vector<ECMGOutputPtr> outputs;
+    std::list<ECMRequestPtr> expired;
+
+    while (ok && (accepting || !_sessions.empty())) {
+
+        // Wait for incoming messages, ready ECM's, writable sockets or the next ECM deadline.
+        ok = _poller.wait(readable, writable, _timers.timeout(ts::Monotonic(true), EVENT_LOOP_TIMEOUT), _shared->report());
+
+        for (size_t i = 0; ok && i < readable.size(); ++i) {
+            if (readable[i] == _server.getSocket()) {
+                // Incoming client connection. With --once, accept only one client.
+                ok = acceptClient();
+                if (_opt.once) {
+                    accepting = false;
+                    _poller.remove(_server.getSocket(), _shared->report());
+                }
+            }
+            else if (readable[i] == _notifier.handle()) {
+                // Send the ECM's which were queued by the workers. Ignore the outputs of closed
+                // sessions, their socket may have been reused by another client.
+                _notifier.get(outputs);
+                for (auto it = outputs.begin(); it != outputs.end(); ++it) {
+                    if (!(*it)->closed() && !flushOutput(*it)) {
+                        closeSession((*it)->sock);
+                    }
+                }
+            }
+            else {
+                const auto it = _sessions.find(readable[i]);
+                if (it != _sessions.end() && !receiveMessages(it->second)) {
+                    closeSession(readable[i]);
+                }
+            }
+        }
+
+        // Send the pending responses on sockets which became writable.
+        for (size_t i = 0; ok && i < writable.size(); ++i) {
+            const auto it = _sessions.find(writable[i]);
+            if (it != _sessions.end() && !flushOutput(it->second.output)) {
+                closeSession(writable[i]);
+            }
+        }
+
+        // Pass the ECM requests which reached the end of their computation time to the workers.
+        // The requests of the sessions which were closed in the meantime are dropped.
+        expired.clear();
+        _timers.expire(ts::Monotonic(true), expired);
+        for (auto it = expired.begin(); it != expired.end(); ++it) {
+            if (!(*it)->output->closed()) {
+                _queue.forceEnqueue(*it);
+            }
+        }
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Accept a new client connection.
+//----------------------------------------------------------------------------
+
+bool ECMGEventLoop::acceptClient()
+{
+    ts::SocketAddress clientAddress;
+    ECMGConnectionPtr conn(new ECMGConnection(ts::ecmgscs::Protocol::Instance(), true, 3));
+    ts::CheckNonNull(conn.pointer());
+    if (!_server.accept(*conn, clientAddress, _shared->report())) {
+        return false;
+    }
+
+    // The client socket is non-blocking. A readable socket may have been closed and its file
+    // descriptor reused by a new client during the same iteration of the event loop.
+    const ts::SysSocketType sock = conn->getSocket();
+#if defined(TS_UNIX)
+    ::fcntl(sock, F_SETFL, ::fcntl(sock, F_GETFL) | O_NONBLOCK);
+#endif
+    ECMGSessionPtr session(new ECMGSession(_opt, conn, _shared, this));
+    ts::CheckNonNull(session.pointer());
+    if (!_poller.add(sock, _shared->report())) {
+        conn->close(_shared->report());
+        return true; // this client is lost but the server is still valid
+    }
+    ECMGClient& client(_sessions[sock]);
+    client.session = session;
+    client.output = new ECMGOutput(sock, session->peer());
+    ts::CheckNonNull(client.output.pointer());
+    _shared->report().verbose(u"%s: %s: session started", {session->peer(), TimeStamp()});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Process all available messages from a client.
+//----------------------------------------------------------------------------
+
+bool ECMGEventLoop::receiveMessages(const ECMGClient& client)
+{
+    std::vector<ts::tlv::MessagePtr> msgs;
+    std::vector<ts::tlv::MessagePtr> errors;
+    bool ok = client.session->connection()->receiveAvailable(msgs, _shared->logger(), &errors);
+
+    // The automatic error responses to invalid messages are queued as all other responses.
+    for (size_t i = 0; ok && i < errors.size(); ++i) {
+        ok = client.output->append(*errors[i], _shared->logger());
+    }
+    for (size_t i = 0; ok && i < msgs.size(); ++i) {
+        ok = client.session->handleMessage(msgs[i]);
+    }
+    return ok && flushOutput(client.output);
+}
+
+
+//----------------------------------------------------------------------------
+// Send the pending responses of a client without blocking.
+//----------------------------------------------------------------------------
+
+bool ECMGEventLoop::flushOutput(const ECMGOutputPtr& output)
+{
+    bool remaining = false;
+    if (!output->flush(remaining, _shared->report())) {
+        return false;
+    }
+    else if (remaining != output->waiting_output) {
+        // Monitor the socket for output only when some data are pending.
+        output->waiting_output = remaining;
+        return _poller.setOutput(output->sock, remaining, _shared->report());
+    }
+    else {
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Terminate a client session.
+//----------------------------------------------------------------------------
+
+void ECMGEventLoop::closeSession(ts::SysSocketType sock)
+{
+    const auto it = _sessions.find(sock);
+    if (it != _sessions.end()) {
+        const ECMGClient client(it->second);
+        _sessions.erase(it);
+        _poller.remove(sock, NULLREP);
+
+        // The pending ECM requests of this session are dropped by the workers and the event
+        // loop once the output is closed. Since only the event loop thread writes on the
+        // socket, the connection can be closed immediately.
+        client.output->close();
+        client.session->connection()->disconnect(NULLREP);
+        client.session->connection()->close(NULLREP);
+        _shared->report().verbose(u"%s: %s: session completed", {client.session->peer(), TimeStamp()});
     }
 }
 
@@ -700,6 +1723,9 @@ int MainCode(int argc, char *argv[])
 {
     ECMGOptions opt(argc, argv);
 
+    // A client may disconnect while a response is sent. Get an error instead of being killed.
+    ts::IgnorePipeSignal();
+
     // Create ECMG shared data (including the asynchronous report).
     ECMGSharedData shared(opt);
 
@@ -708,13 +1734,19 @@ int MainCode(int argc, char *argv[])
     if (!server.open(shared.report()) ||
         !server.reusePort(opt.reusePort, shared.report()) ||
         !server.bind(opt.serverAddress, shared.report()) ||
-        !server.listen(5, shared.report()))
+        !server.listen(opt.eventLoop ? SOMAXCONN : 5, shared.report()))
     {
         return EXIT_FAILURE;
     }
     shared.report().verbose(u"TCP server listening on %s, using ECMG <=> SCS protocol version %d",
                             {opt.serverAddress, ts::ecmgscs::Protocol::Instance()->version()});
 
+    // In event loop mode, serve all clients from the main thread.
+    if (opt.eventLoop) {
+        ECMGEventLoop loop(opt, &shared, server);
+        return loop.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // Manage incoming client connections.
     for (;;) {
 
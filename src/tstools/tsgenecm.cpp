@@ -38,6 +38,9 @@
 #include "tsStandaloneTableDemux.h"
 #include "tsSectionFile.h"
 #include "tsTSPacket.h"
+#include "tsMonotonic.h"
+#include "tsSysUtils.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
@@ -59,6 +62,8 @@ namespace {
         uint16_t           cpNumber;   // Crypto-period number
         ts::ByteBlock      cwCurrent;  // Current CW
         ts::ByteBlock      cwNext;     // Next CW
+        size_t             loadTest;   // Number of simultaneous ECM streams in load test mode.
+        ts::Second         duration;   // Duration of the load test.
     };
 }
 
@@ -69,25 +74,42 @@ GenECMOptions::GenECMOptions(int argc, char *argv[]) :
     ecmg(),
     cpNumber(0),
     cwCurrent(),
-    cwNext()
+    cwNext(),
+    loadTest(0),
+    duration(0)
 {
     setIntro(u"This command connects to a DVB SimulCrypt compliant ECMG and requests "
              u"the generation of one ECM. Restriction: The target ECMG shall support "
              u"current or current/next control words in ECM, meaning CW_per_msg = 1 or 2 "
-             u"and lead_CW = 0 or 1.");
+             u"and lead_CW = 0 or 1. "
+             u"With option --load-test, the command opens many ECM streams in parallel "
+             u"and reports the latency of the ECM generation.");
 
-    option(u"", 0, STRING, 1, 1);
-    help(u"", u"filename", u"Name of the binary output file which receives the ECM.");
+    option(u"", 0, STRING, 0, 1);
+    help(u"", u"filename", u"Name of the binary output file which receives the ECM. Required without --load-test.");
 
     option(u"cp-number", 0, UINT16);
     help(u"cp-number", u"Crypto-period number. Default: 0.");
 
-    option(u"cw-current", 'c', STRING, 1, 1);
-    help(u"cw-current", u"Current control word (required). The value must be a suite of hexadecimal digits.");
+    option(u"cw-current", 'c', STRING);
+    help(u"cw-current", u"Current control word (required without --load-test). The value must be a suite of hexadecimal digits.");
 
     option(u"cw-next", 'n', STRING);
     help(u"cw-next", u"Next control word (optional). The value must be a suite of hexadecimal digits.");
 
+    option(u"duration", 0, POSITIVE);
+    help(u"duration", u"seconds",
+         u"With --load-test, specify the duration of the test in seconds. Default: 10 seconds.");
+
+    option(u"load-test", 'l', POSITIVE);
+    help(u"load-test", u"count",
+         u"Load test mode: open the specified number of connections to the ECMG, each one with "
+         u"one ECM stream, and continuously request one ECM per crypto-period on each stream. "
+         u"The ECM_channel_id, ECM_stream_id and ECM_id of the streams are successively incremented, "
+         u"starting at the values of --channel-id, --stream-id and --ecm-id. The requests are evenly "
+         u"spread over the crypto-period. At the end of the test, the statistics on the ECM latency "
+         u"are reported. The ECM's are not saved in load test mode.");
+
     // Common ECMG parameters.
     ecmg.defineArgs(*this);
 
@@ -98,9 +120,27 @@ GenECMOptions::GenECMOptions(int argc, char *argv[]) :
     ecmg.loadArgs(duck, *this);
     getValue(outFile, u"");
     cpNumber = intValue<uint16_t>(u"cp-number", 0);
+    loadTest = intValue<size_t>(u"load-test", 0);
+    duration = intValue<ts::Second>(u"duration", 10);
     if (!value(u"cw-current").hexaDecode(cwCurrent) || !value(u"cw-next").hexaDecode(cwNext)) {
         error(u"invalid control word value");
     }
+    if (loadTest == 0 && outFile.empty()) {
+        error(u"missing output file name");
+    }
+    if (loadTest == 0 && cwCurrent.empty()) {
+        error(u"missing current control word, use --cw-current");
+    }
+    if (loadTest > 0 && cwCurrent.empty()) {
+        // In load test mode, use a dummy CW by default.
+        cwCurrent.resize(8);
+        for (size_t i = 0; i < cwCurrent.size(); ++i) {
+            cwCurrent[i] = uint8_t(i);
+        }
+    }
+    if (loadTest > 0 && cwNext.empty()) {
+        cwNext = cwCurrent;
+    }
 
     exitOnError();
 }
@@ -155,6 +195,161 @@ namespace {
 }
 
 
+//----------------------------------------------------------------------------
+//  Load test mode.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Maximum time to wait for the last ECM's at the end of a load test.
+    static const ts::MilliSecond LOAD_TEST_DRAIN_TIME = 5000;
+
+    // Statistics which are shared by all streams in load test mode.
+    class LoadStatistics
+    {
+        TS_NOCOPY(LoadStatistics);
+    public:
+        LoadStatistics() : mutex(), submitted(0), errors(0), latencies() {}
+
+        ts::Mutex                   mutex;      // Exclusive access to all fields.
+        size_t                      submitted;  // Number of submitted ECM requests.
+        size_t                      errors;     // Number of failed requests.
+        std::vector<ts::NanoSecond> latencies;  // Latencies of all received ECM's.
+    };
+
+    // One ECM stream, with its own connection to the ECMG, in load test mode.
+    class LoadStream: public ts::ECMGClientHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(LoadStream);
+    public:
+        // Constructor.
+        LoadStream(LoadStatistics& stats) : _stats(stats), _mutex(), _pending(), _client() {}
+
+        // Access the connection to the ECMG.
+        ts::ECMGClient& client() { return _client; }
+
+        // Submit an ECM request.
+        bool submit(GenECMOptions& opt, uint16_t cp_number)
+        {
+            {
+                ts::Guard lock(_mutex);
+                _pending[cp_number] = ts::Monotonic(true);
+            }
+            const bool ok = _client.submitECM(cp_number, opt.cwCurrent, opt.cwNext, opt.ecmg.access_criteria, uint16_t(opt.ecmg.cp_duration / 100), this);
+            ts::Guard lock(_stats.mutex);
+            if (ok) {
+                _stats.submitted++;
+            }
+            else {
+                _stats.errors++;
+            }
+            return ok;
+        }
+
+        // Implementation of ECMGClientHandlerInterface.
+        virtual void handleECM(const ts::ecmgscs::ECMResponse& response) override
+        {
+            const ts::Monotonic now(true);
+            ts::Monotonic start;
+            {
+                ts::Guard lock(_mutex);
+                const auto it = _pending.find(response.CP_number);
+                if (it == _pending.end()) {
+                    return;
+                }
+                start = it->second;
+                _pending.erase(it);
+            }
+            ts::Guard lock(_stats.mutex);
+            _stats.latencies.push_back(now - start);
+        }
+
+    private:
+        LoadStatistics&                   _stats;
+        ts::Mutex                         _mutex;    // Exclusive access to _pending.
+        std::map<uint16_t, ts::Monotonic> _pending;  // Submission time of pending requests, by CP number.
+        ts::ECMGClient                    _client;   // Connection to the ECMG, destroyed first.
+    };
+
+    typedef ts::SafePtr<LoadStream, ts::NullMutex> LoadStreamPtr;
+
+    // Format a latency in milliseconds with microsecond precision.
+    ts::UString LatencyString(ts::NanoSecond ns)
+    {
+        const ts::MicroSecond us = ns / ts::NanoSecPerMicroSec;
+        return ts::UString::Format(u"%'d.%03d ms", {us / 1000, us % 1000});
+    }
+
+    // Run a load test.
+    bool LoadTest(GenECMOptions& opt, const ts::tlv::Logger& logger)
+    {
+        LoadStatistics stats;
+        std::vector<LoadStreamPtr> streams;
+
+        // Each connection to the ECMG needs one file descriptor.
+        ts::RaiseOpenFilesLimit(opt.loadTest + 32, opt);
+
+        // Open all ECM streams, one connection per stream.
+        ts::ecmgscs::ChannelStatus channelStatus;
+        ts::ecmgscs::StreamStatus streamStatus;
+        ts::ECMGClientArgs args(opt.ecmg);
+        bool ok = true;
+        for (size_t i = 0; ok && i < opt.loadTest; ++i) {
+            LoadStreamPtr stream(new LoadStream(stats));
+            args.ecm_channel_id = uint16_t(opt.ecmg.ecm_channel_id + i);
+            args.ecm_stream_id = uint16_t(opt.ecmg.ecm_stream_id + i);
+            args.ecm_id = uint16_t(opt.ecmg.ecm_id + i);
+            ok = stream->client().connect(args, channelStatus, streamStatus, nullptr, logger);
+            if (ok) {
+                streams.push_back(stream);
+            }
+        }
+        opt.verbose(u"%d ECM streams connected", {streams.size()});
+
+        // Submit one ECM per crypto-period on each stream, evenly spread over the crypto-period.
+        const ts::NanoSecond interval = std::max<ts::NanoSecond>(1, opt.ecmg.cp_duration * ts::NanoSecPerMilliSec / ts::NanoSecond(opt.loadTest));
+        const ts::Monotonic start(true);
+        ts::Monotonic end(start);
+        end += opt.duration * ts::NanoSecPerSec;
+        ts::Monotonic due(start);
+        for (size_t count = 0; ok && due < end; ++count, due += interval) {
+            due.wait();
+            ok = streams[count % streams.size()]->submit(opt, uint16_t(opt.cpNumber + count / streams.size()));
+        }
+
+        // Wait for the last ECM's.
+        for (ts::MilliSecond wait = 0; wait < LOAD_TEST_DRAIN_TIME; wait += 10) {
+            {
+                ts::Guard lock(stats.mutex);
+                if (stats.latencies.size() >= stats.submitted) {
+                    break;
+                }
+            }
+            ts::SleepThread(10);
+        }
+
+        // Close all streams.
+        for (size_t i = 0; i < streams.size(); ++i) {
+            streams[i]->client().disconnect();
+        }
+
+        // Report the latency statistics.
+        ts::Guard lock(stats.mutex);
+        std::vector<ts::NanoSecond>& lat(stats.latencies);
+        std::sort(lat.begin(), lat.end());
+        opt.info(u"ECM streams: %'d, submitted ECM requests: %'d, received ECM's: %'d, errors: %'d",
+                 {streams.size(), stats.submitted, lat.size(), stats.errors});
+        if (!lat.empty()) {
+            const auto percentile = [&lat](double p) { return lat[std::min(lat.size() - 1, size_t(p * double(lat.size())))]; };
+            opt.info(u"ECM latency: min: %s, p50: %s, p90: %s, p99: %s, p99.9: %s, max: %s",
+                     {LatencyString(lat.front()), LatencyString(percentile(0.50)), LatencyString(percentile(0.90)),
+                      LatencyString(percentile(0.99)), LatencyString(percentile(0.999)), LatencyString(lat.back())});
+        }
+        return ok && stats.errors == 0 && lat.size() == stats.submitted;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -175,6 +370,11 @@ int MainCode(int argc, char *argv[])
     // Specify which ECMG <=> SCS version to use.
     ts::ecmgscs::Protocol::Instance()->setVersion(opt.ecmg.dvbsim_version);
 
+    // Load test mode.
+    if (opt.loadTest > 0) {
+        return LoadTest(opt, logger) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // Connect to ECMG.
     if (!ecmg.connect(opt.ecmg, channelStatus, streamStatus, nullptr, logger)) {
         // Error connecting to ECMG, error message already reported
@@ -38,6 +38,7 @@
 #include "tsxmlPatchDocument.h"
 #include "tsxmlJSONConverter.h"
 #include "tsjsonOutputArgs.h"
+#include "tsjsonArenaDocument.h"
 #include "tsTextFormatter.h"
 #include "tsSectionFile.h"
 #include "tsOutputRedirector.h"
@@ -254,8 +255,8 @@ int MainCode(int argc, char *argv[])
         bool ok = true;
         if (opt.from_json) {
             // Load a JSON fil and convert it to XML.
-            ts::json::ValuePtr root;
-            ok = ts::json::LoadFile(root, file_name, opt) && model.convertToXML(*root, doc, false);
+            ts::json::ArenaDocument root(opt);
+            ok = root.load(file_name) && model.convertToXML(root.root(), doc, false);
         }
         else {
             // Load a true XML file.
@@ -0,0 +1,155 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::CRC32
+//
+//----------------------------------------------------------------------------
+
+#include "tsCRC32.h"
+#include "tsByteBlock.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class CRC32Test: public tsunit::Test
+{
+public:
+    CRC32Test();
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testKnownValues();
+    void testSizes();
+    void testChunks();
+
+    TSUNIT_TEST_BEGIN(CRC32Test);
+    TSUNIT_TEST(testKnownValues);
+    TSUNIT_TEST(testSizes);
+    TSUNIT_TEST(testChunks);
+    TSUNIT_TEST_END();
+
+private:
+    ts::ByteBlock _data;
+
+    // Reference bit-by-bit implementation.
+    static uint32_t Reference(const uint8_t* data, size_t size, uint32_t fcs = 0xFFFFFFFF);
+};
+
+TSUNIT_REGISTER(CRC32Test);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+CRC32Test::CRC32Test() :
+    _data()
+{
+}
+
+// Test suite initialization method.
+void CRC32Test::beforeTest()
+{
+    // Pseudo-random data, larger than the folding blocks of accelerated implementations.
+    _data.resize(5000);
+    uint32_t x = 0x12345678;
+    for (size_t i = 0; i < _data.size(); ++i) {
+        x = x * 1103515245 + 12345;
+        _data[i] = uint8_t(x >> 16);
+    }
+}
+
+// Test suite cleanup method.
+void CRC32Test::afterTest()
+{
+}
+
+// Reference bit-by-bit implementation of the MPEG-2 CRC32.
+uint32_t CRC32Test::Reference(const uint8_t* data, size_t size, uint32_t fcs)
+{
+    for (size_t i = 0; i < size; ++i) {
+        fcs ^= uint32_t(data[i]) << 24;
+        for (int bit = 0; bit < 8; ++bit) {
+            fcs = (fcs << 1) ^ ((fcs & 0x80000000) != 0 ? 0x04C11DB7 : 0);
+        }
+    }
+    return fcs;
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void CRC32Test::testKnownValues()
+{
+    debug() << "CRC32Test: implementation: " << ts::CRC32::Implementation() << std::endl;
+
+    // Standard check value of CRC-32/MPEG-2.
+    const char check[] = "123456789";
+    TSUNIT_EQUAL(0x0376E6E7, ts::CRC32(check, 9).value());
+
+    // Empty area.
+    TSUNIT_EQUAL(0xFFFFFFFF, ts::CRC32(check, 0).value());
+
+    // The CRC32 of a section, including its CRC32 field, is zero.
+    ts::ByteBlock sec(_data.data(), 1020);
+    sec.appendUInt32(ts::CRC32(sec.data(), sec.size()));
+    TSUNIT_EQUAL(0, ts::CRC32(sec.data(), sec.size()).value());
+}
+
+void CRC32Test::testSizes()
+{
+    // All sizes up to a few folding blocks, at all alignments modulo 16.
+    for (size_t start = 0; start < 16; ++start) {
+        for (size_t size = 0; start + size <= 700; ++size) {
+            TSUNIT_EQUAL(Reference(&_data[start], size), ts::CRC32(&_data[start], size).value());
+        }
+    }
+    TSUNIT_EQUAL(Reference(_data.data(), _data.size()), ts::CRC32(_data.data(), _data.size()).value());
+}
+
+void CRC32Test::testChunks()
+{
+    // Computing in several chunks gives the same result as in one call.
+    const uint32_t expected = Reference(_data.data(), _data.size());
+    static const size_t chunks[] = {1, 3, 7, 16, 63, 64, 65, 127, 128, 129, 188, 1000, 4096};
+    for (size_t ic = 0; ic < sizeof(chunks) / sizeof(chunks[0]); ++ic) {
+        ts::CRC32 crc;
+        for (size_t pos = 0; pos < _data.size(); pos += chunks[ic]) {
+            crc.add(&_data[pos], std::min(chunks[ic], _data.size() - pos));
+        }
+        TSUNIT_EQUAL(expected, crc.value());
+    }
+}
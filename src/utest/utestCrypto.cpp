@@ -88,6 +88,8 @@ public:
     void testAES_CTS3();
     void testAES_CTS4();
     void testAES_DVS042();
+    void testAES_Blocks();
+    void testAES_Batch();
     void testDES();
     void testTDES();
     void testTDES_CBC();
@@ -111,6 +113,8 @@ public:
     TSUNIT_TEST(testAES_CTS3);
     TSUNIT_TEST(testAES_CTS4);
     TSUNIT_TEST(testAES_DVS042);
+    TSUNIT_TEST(testAES_Blocks);
+    TSUNIT_TEST(testAES_Batch);
     TSUNIT_TEST(testDES);
     TSUNIT_TEST(testTDES);
     TSUNIT_TEST(testTDES_CBC);
@@ -417,6 +421,120 @@ void CryptoTest::testAES_DVS042()
     testChainingSizes(dvs042_aes, 16, 17, 23, 31, 32, 33, 45, 64, 67, 184, 12345, 0);
 }
 
+void CryptoTest::testAES_Blocks()
+{
+    debug() << "CryptoTest: AES implementation: " << ts::AES::Implementation() << std::endl;
+
+    ts::SystemRandomGenerator prng;
+    ts::AES aes;
+
+    // Multi-block processing shall give the same results as block by block.
+    for (size_t key_size = 16; key_size <= 32; key_size += 8) {
+        for (size_t count = 1; count <= 41; count += 4) {
+            ts::ByteBlock key(key_size);
+            ts::ByteBlock plain(count * ts::AES::BLOCK_SIZE);
+            ts::ByteBlock cipher(plain.size());
+            ts::ByteBlock ref(plain.size());
+            TSUNIT_ASSERT(prng.read(key.data(), key.size()));
+            TSUNIT_ASSERT(prng.read(plain.data(), plain.size()));
+            TSUNIT_ASSERT(aes.setKey(key.data(), key.size()));
+
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_ASSERT(aes.encrypt(&plain[i * ts::AES::BLOCK_SIZE], ts::AES::BLOCK_SIZE, &ref[i * ts::AES::BLOCK_SIZE], ts::AES::BLOCK_SIZE));
+            }
+            TSUNIT_EQUAL(count, aes.encryptionCount());
+            TSUNIT_ASSERT(aes.encryptBlocks(plain.data(), cipher.data(), count));
+            TSUNIT_ASSERT(cipher == ref);
+
+            // The key usage counter is incremented once per block.
+            TSUNIT_EQUAL(2 * count, aes.encryptionCount());
+
+            TSUNIT_ASSERT(aes.decryptBlocks(cipher.data(), cipher.data(), count));
+            TSUNIT_ASSERT(cipher == plain);
+
+            TSUNIT_ASSERT(aes.encryptBlocks(cipher.data(), cipher.data(), count));
+            TSUNIT_ASSERT(cipher == ref);
+        }
+    }
+
+    // CTR mode on long messages, encrypting several counter values at once.
+    ts::CTR<ts::AES> ctr_aes;
+    ts::ByteBlock key(16);
+    ts::ByteBlock iv(16);
+    ts::ByteBlock plain(301);
+    ts::ByteBlock cipher(plain.size());
+    TSUNIT_ASSERT(prng.read(key.data(), key.size()));
+    TSUNIT_ASSERT(prng.read(plain.data(), plain.size()));
+    iv[15] = 0xF0; // force a carry on the counter.
+    TSUNIT_ASSERT(aes.setKey(key.data(), key.size()));
+    TSUNIT_ASSERT(ctr_aes.setKey(key.data(), key.size()));
+    TSUNIT_ASSERT(ctr_aes.setIV(iv.data(), iv.size()));
+    TSUNIT_ASSERT(ctr_aes.encrypt(plain.data(), plain.size(), cipher.data(), cipher.size()));
+
+    for (size_t i = 0; i < plain.size(); i += ts::AES::BLOCK_SIZE) {
+        uint8_t mask[ts::AES::BLOCK_SIZE];
+        TSUNIT_ASSERT(aes.encrypt(iv.data(), iv.size(), mask, sizeof(mask)));
+        for (size_t j = 0; j < ts::AES::BLOCK_SIZE && i + j < plain.size(); ++j) {
+            TSUNIT_EQUAL(plain[i + j] ^ mask[j], cipher[i + j]);
+        }
+        // Increment the counter in the 64 least significant bits.
+        for (size_t j = iv.size(); j-- > 8 && ++iv[j] == 0; ) {
+        }
+    }
+}
+
+void CryptoTest::testAES_Batch()
+{
+    ts::SystemRandomGenerator prng;
+    ts::ByteBlock key(16);
+    ts::ByteBlock iv(16);
+    TSUNIT_ASSERT(prng.read(key.data(), key.size()));
+    TSUNIT_ASSERT(prng.read(iv.data(), iv.size()));
+
+    ts::CBC<ts::AES> cbc_aes;
+    ts::CTR<ts::AES> ctr_aes;
+    ts::DVBCISSA cissa;
+    ts::CipherChaining* const algos[] = {&cbc_aes, &ctr_aes, &cissa};
+
+    // Same messages sizes as TS packet payloads, truncated to the block size when the residue is not allowed.
+    const size_t sizes[] = {184, 0, 176, 12, 183, 16, 45, 184, 184, 100, 1, 184};
+    const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (auto algo : algos) {
+        debug() << "CryptoTest::testAES_Batch: " << algo->name() << std::endl;
+        TSUNIT_ASSERT(algo->setKey(key.data(), key.size()));
+        if (algo != &cissa) {
+            TSUNIT_ASSERT(algo->setIV(iv.data(), iv.size()));
+        }
+
+        std::vector<ts::ByteBlock> plain(count);
+        std::vector<ts::ByteBlock> data(count);
+        std::vector<void*> addr(count);
+        std::vector<size_t> bsizes(count);
+        for (size_t i = 0; i < count; ++i) {
+            bsizes[i] = algo->residueAllowed() ? sizes[i] : sizes[i] - sizes[i] % algo->blockSize();
+            plain[i].resize(bsizes[i]);
+            TSUNIT_ASSERT(prng.read(plain[i].data(), plain[i].size()));
+            data[i] = plain[i];
+            addr[i] = data[i].data();
+        }
+
+        // Encrypting a batch gives the same result as message by message.
+        TSUNIT_ASSERT(algo->encryptInPlaceBatch(count, addr.data(), bsizes.data()));
+        for (size_t i = 0; i < count; ++i) {
+            ts::ByteBlock ref(plain[i]);
+            TSUNIT_ASSERT(ref.empty() || algo->encryptInPlace(ref.data(), ref.size()));
+            TSUNIT_ASSERT(data[i] == ref);
+        }
+
+        // Decrypting a batch returns the plain texts.
+        TSUNIT_ASSERT(algo->decryptInPlaceBatch(count, addr.data(), bsizes.data()));
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_ASSERT(data[i] == plain[i]);
+        }
+    }
+}
+
 void CryptoTest::testDES()
 {
     ts::DES des;
@@ -93,6 +93,7 @@ public:
     void testTDT();
     void testTOT();
     void testHEVC();
+    void testSkipUnchanged();
 
     TSUNIT_TEST_BEGIN(DemuxTest);
     TSUNIT_TEST(testPAT);
@@ -106,6 +107,7 @@ public:
     TSUNIT_TEST(testTDT);
     TSUNIT_TEST(testTOT);
     TSUNIT_TEST(testHEVC);
+    TSUNIT_TEST(testSkipUnchanged);
     TSUNIT_TEST_END();
 
 private:
@@ -490,3 +492,71 @@ void DemuxTest::testHEVC()
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+// Count the tables and sections which are notified by a demux.
+namespace {
+    class CountHandler: public ts::TableHandlerInterface, public ts::SectionHandlerInterface
+    {
+    public:
+        CountHandler() : tables(0), sections(0) {}
+        size_t tables;
+        size_t sections;
+        virtual void handleTable(ts::SectionDemux&, const ts::BinaryTable&) override { tables++; }
+        virtual void handleSection(ts::SectionDemux&, const ts::Section&) override { sections++; }
+    };
+}
+
+void DemuxTest::testSkipUnchanged()
+{
+    ts::DuckContext duck;
+
+    // Build a sequence of PAT: v1, v1 (repetition), v2 (unchanged), v3 (new service), v4 (unchanged).
+    ts::TSPacketVector packets;
+    ts::OneShotPacketizer pzer(duck, ts::PID_PAT);
+    ts::PAT pat(0, true, 0x1234);
+    pat.pmts[100] = 1000;
+
+    static const uint8_t versions[] = {1, 1, 2, 3, 4};
+    for (auto version : versions) {
+        pat.version = version;
+        if (version == 3) {
+            pat.pmts[200] = 2000;
+        }
+        ts::TSPacketVector pkts;
+        pzer.removeAll();
+        pzer.addTable(duck, pat);
+        pzer.getPackets(pkts);
+        packets.insert(packets.end(), pkts.begin(), pkts.end());
+    }
+
+    // By default, all sections and all new versions of the table are notified.
+    CountHandler handler1;
+    ts::SectionDemux demux1(duck, &handler1, &handler1, ts::AllPIDs);
+    for (const auto& pkt : packets) {
+        demux1.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(4, handler1.tables);
+    TSUNIT_EQUAL(5, handler1.sections);
+
+    // Skip unchanged content, ignoring versions.
+    CountHandler handler2;
+    ts::SectionDemux demux2(duck, &handler2, &handler2, ts::AllPIDs);
+    demux2.setSkipUnchanged(true);
+    for (const auto& pkt : packets) {
+        demux2.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(2, handler2.tables);
+    TSUNIT_EQUAL(2, handler2.sections);
+
+    const ts::SectionDemux::Status status(demux2);
+    TSUNIT_EQUAL(2, status.unchanged_table);
+    TSUNIT_EQUAL(3, status.unchanged_sect);
+    TSUNIT_ASSERT(!status.hasErrors());
+
+    // The skipped sections are displayed only when skipping is enabled.
+    std::ostringstream out1, out2;
+    ts::SectionDemux::Status(demux1).display(out1);
+    status.display(out2);
+    TSUNIT_ASSERT(out1.str().find("Skipped unchanged") == std::string::npos);
+    TSUNIT_ASSERT(out2.str().find("Skipped unchanged tables: 2") != std::string::npos);
+}
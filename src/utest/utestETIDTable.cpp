@@ -0,0 +1,172 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::ETIDTable
+//
+//----------------------------------------------------------------------------
+
+#include "tsETIDTable.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class ETIDTableTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testEmpty();
+    void testInsert();
+    void testMoveOnGrowth();
+
+    TSUNIT_TEST_BEGIN(ETIDTableTest);
+    TSUNIT_TEST(testEmpty);
+    TSUNIT_TEST(testInsert);
+    TSUNIT_TEST(testMoveOnGrowth);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(ETIDTableTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void ETIDTableTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void ETIDTableTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// A value class which can be moved but not copied.
+//----------------------------------------------------------------------------
+
+namespace {
+    class MoveOnly
+    {
+    public:
+        int value;
+        MoveOnly() : value(0) {}
+        MoveOnly(MoveOnly&& other) : value(other.value) { other.value = -1; }
+        MoveOnly& operator=(MoveOnly&& other) { value = other.value; other.value = -1; return *this; }
+        MoveOnly(const MoveOnly&) = delete;
+        MoveOnly& operator=(const MoveOnly&) = delete;
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void ETIDTableTest::testEmpty()
+{
+    ts::ETIDTable<int> table;
+    TSUNIT_ASSERT(table.empty());
+    TSUNIT_EQUAL(0, table.size());
+    TSUNIT_ASSERT(table.find(ts::ETID(0x42, 0x1234)) == nullptr);
+
+    std::vector<ts::ETID> keys;
+    table.getSortedKeys(keys);
+    TSUNIT_ASSERT(keys.empty());
+}
+
+void ETIDTableTest::testInsert()
+{
+    ts::ETIDTable<int> table;
+
+    // Short and long sections with the same TID are distinct entries.
+    table[ts::ETID(0x42)] = 1;
+    table[ts::ETID(0x42, 0x0000)] = 2;
+    table[ts::ETID(0x42, 0x0001)] = 3;
+    table[ts::ETID(0x00)] = 4;
+
+    TSUNIT_ASSERT(!table.empty());
+    TSUNIT_EQUAL(4, table.size());
+    TSUNIT_EQUAL(1, table[ts::ETID(0x42)]);
+    TSUNIT_EQUAL(2, table[ts::ETID(0x42, 0x0000)]);
+    TSUNIT_EQUAL(3, table[ts::ETID(0x42, 0x0001)]);
+    TSUNIT_EQUAL(4, table[ts::ETID(0x00)]);
+    TSUNIT_EQUAL(4, table.size());
+
+    // Access to a new ETID creates a default value.
+    TSUNIT_ASSERT(table.find(ts::ETID(0x4E, 0x0001)) == nullptr);
+    TSUNIT_EQUAL(0, table[ts::ETID(0x4E, 0x0001)]);
+    TSUNIT_EQUAL(5, table.size());
+    TSUNIT_ASSERT(table.find(ts::ETID(0x4E, 0x0001)) != nullptr);
+
+    std::vector<ts::ETID> keys;
+    table.getSortedKeys(keys);
+    TSUNIT_EQUAL(5, keys.size());
+    TSUNIT_ASSERT(keys[0] == ts::ETID(0x00));
+    TSUNIT_ASSERT(keys[1] == ts::ETID(0x42));
+    TSUNIT_ASSERT(keys[2] == ts::ETID(0x42, 0x0000));
+    TSUNIT_ASSERT(keys[3] == ts::ETID(0x42, 0x0001));
+    TSUNIT_ASSERT(keys[4] == ts::ETID(0x4E, 0x0001));
+
+    table.clear();
+    TSUNIT_ASSERT(table.empty());
+    TSUNIT_EQUAL(0, table.size());
+    TSUNIT_ASSERT(table.find(ts::ETID(0x42)) == nullptr);
+}
+
+void ETIDTableTest::testMoveOnGrowth()
+{
+    // Many EIT's in the same table, the storage grows several times.
+    // The values are not copyable, they must be moved.
+    ts::ETIDTable<MoveOnly> table;
+    for (int i = 0; i < 1000; ++i) {
+        table[ts::ETID(ts::TID(0x50 + i % 16), uint16_t(i / 16))].value = i;
+        TSUNIT_EQUAL(size_t(i + 1), table.size());
+    }
+    for (int i = 0; i < 1000; ++i) {
+        const MoveOnly* p = table.find(ts::ETID(ts::TID(0x50 + i % 16), uint16_t(i / 16)));
+        TSUNIT_ASSERT(p != nullptr);
+        TSUNIT_EQUAL(i, p->value);
+    }
+
+    std::vector<ts::ETID> keys;
+    table.getSortedKeys(keys);
+    TSUNIT_EQUAL(1000, keys.size());
+    for (size_t i = 1; i < keys.size(); ++i) {
+        TSUNIT_ASSERT(keys[i-1] < keys[i]);
+    }
+}
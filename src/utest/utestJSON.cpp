@@ -41,6 +41,8 @@
 #include "tsjsonObject.h"
 #include "tsjsonArray.h"
 #include "tsjsonRunningDocument.h"
+#include "tsjsonArenaDocument.h"
+#include "tsjsonStreamWriter.h"
 #include "tsSysUtils.h"
 #include "tsCerrReport.h"
 #include "tsNullReport.h"
@@ -66,6 +68,8 @@ public:
     void testQuery();
     void testRunningDocumentEmpty();
     void testRunningDocument();
+    void testArenaDocument();
+    void testStreamWriter();
 
     TSUNIT_TEST_BEGIN(JsonTest);
     TSUNIT_TEST(testSimple);
@@ -74,6 +78,8 @@ public:
     TSUNIT_TEST(testQuery);
     TSUNIT_TEST(testRunningDocumentEmpty);
     TSUNIT_TEST(testRunningDocument);
+    TSUNIT_TEST(testArenaDocument);
+    TSUNIT_TEST(testStreamWriter);
     TSUNIT_TEST_END();
 
 private:
@@ -822,3 +828,139 @@ void JsonTest::testRunningDocument()
                  u"}",
                  loadTempFile());
 }
+
+
+void JsonTest::testArenaDocument()
+{
+    ts::json::ArenaDocument doc(CERR);
+    TSUNIT_ASSERT(doc.root().isNull());
+    TSUNIT_EQUAL(0, doc.valueCount());
+
+    // Same content as testSimple().
+    TSUNIT_ASSERT(doc.parse(u"[ true, {\"ab\":67, \"foo\" : \"bar\"} ]"));
+    TSUNIT_EQUAL(5, doc.valueCount());
+    const ts::json::Value& jv(doc.root());
+    TSUNIT_ASSERT(jv.isArray());
+    TSUNIT_EQUAL(ts::json::Type::Array, jv.type());
+    TSUNIT_EQUAL(2, jv.size());
+    TSUNIT_ASSERT(jv.at(0).isTrue());
+    TSUNIT_ASSERT(jv.at(1).isObject());
+    TSUNIT_ASSERT(jv.at(2).isNull());
+    TSUNIT_ASSERT(jv.at(2).value(u"jjj").at(3424).isNull());
+    TSUNIT_EQUAL(2, jv.at(1).size());
+    TSUNIT_EQUAL(67, jv.at(1).value(u"ab").toInteger());
+    TSUNIT_EQUAL(u"bar", jv.at(1).value(u"foo").toString());
+    TSUNIT_ASSERT(jv.at(1).value(u"ss").isNull());
+    TSUNIT_EQUAL(
+        u"[\n"
+        u"  true,\n"
+        u"  {\n"
+        u"    \"ab\": 67,\n"
+        u"    \"foo\": \"bar\"\n"
+        u"  }\n"
+        u"]",
+        jv.printed());
+
+    // Same result as the classical parser.
+    static const ts::UChar* const text =
+        u"{\n"
+        u"  \"zz\": [1, -2, 9223372036854775807, -9223372036854775808, \"\", {}, []],\n"
+        u"  \"str\": \"a\\\"b\\\\c\\/d\\n\\u00E9\\uD83D\\uDE00 à €\",\n"
+        u"  \"obj\": {\"x\": null, \"y\": false, \"a\": {\"b\": [0, {\"c\": \"deep\"}]}},\n"
+        u"  \"dup\": 1,\n"
+        u"  \"dup\": 2\n"
+        u"}\n";
+    ts::json::ValuePtr tree;
+    TSUNIT_ASSERT(ts::json::Parse(tree, text, CERR));
+    TSUNIT_ASSERT(doc.parse(text));
+    const ts::json::Value& root(doc.root());
+    TSUNIT_EQUAL(tree->printed(), root.printed());
+    TSUNIT_EQUAL(tree->printed(), doc.toValue()->printed());
+
+    ts::UStringList names1, names2;
+    tree->getNames(names1);
+    root.getNames(names2);
+    TSUNIT_ASSERT(names1 == names2);
+    TSUNIT_EQUAL(4, root.size());
+    TSUNIT_EQUAL(2, root.value(u"dup").toInteger());
+    TSUNIT_EQUAL(u"a\"b\\c/d\né\U0001F600 à €", root.value(u"str").toString());
+    TSUNIT_EQUAL(std::numeric_limits<int64_t>::max(), root.query(u"zz[2]").toInteger());
+    TSUNIT_EQUAL(std::numeric_limits<int64_t>::min(), root.query(u"zz[3]").toInteger());
+    TSUNIT_EQUAL(-2, root.query(u"zz[1]").toInteger());
+    TSUNIT_ASSERT(root.query(u"zz[4]").isString());
+    TSUNIT_EQUAL(0, root.query(u"zz[4]").size());
+    TSUNIT_ASSERT(root.query(u"zz[5]").isObject());
+    TSUNIT_ASSERT(root.query(u"zz[6]").isArray());
+    TSUNIT_ASSERT(root.query(u"zz[7]").isNull());
+    TSUNIT_EQUAL(u"deep", root.query(u"obj.a.b[1].c").toString());
+    TSUNIT_ASSERT(root.query(u"obj.a.b[1].d").isNull());
+    TSUNIT_ASSERT(root.query(u"obj[1]").isNull());
+    TSUNIT_ASSERT(root.query(u"obj.y").isFalse());
+    TSUNIT_ASSERT(!root.query(u"obj.y").toBoolean(true));
+    TSUNIT_ASSERT(root.query(u"obj.x").isNull());
+    TSUNIT_ASSERT(root.query(u"obj.x.foo").isNull());
+
+    // Errors leave an empty document.
+    ts::json::ArenaDocument bad(NULLREP);
+    TSUNIT_ASSERT(!bad.parse(u""));
+    TSUNIT_ASSERT(bad.root().isNull());
+    TSUNIT_ASSERT(!bad.parse(u"   false  true  "));
+    TSUNIT_ASSERT(!bad.parse(u"{\"a\": 1,}"));
+    TSUNIT_ASSERT(!bad.parse(u"[1 2]"));
+    TSUNIT_ASSERT(!bad.parse(u"\"abc"));
+    TSUNIT_EQUAL(0, bad.valueCount());
+
+    // Floating-point values are not supported, same as the classical parser.
+    TSUNIT_ASSERT(bad.parse(u"[1.5, 2e3, 99999999999999999999]"));
+    TSUNIT_EQUAL(3, bad.root().size());
+    TSUNIT_ASSERT(bad.root().at(0).isNull());
+    TSUNIT_ASSERT(bad.root().at(1).isNull());
+    TSUNIT_ASSERT(bad.root().at(2).isNull());
+}
+
+void JsonTest::testStreamWriter()
+{
+    // Build the same structure as a tree.
+    ts::json::Object tree;
+    tree.add(u"name", u"foo\"bar");
+    tree.add(u"count", 12);
+    tree.add(u"empty", ts::json::ValuePtr(new ts::json::Array));
+    tree.value(u"sub", true).add(u"flag", ts::json::Bool(true));
+    tree.value(u"sub").add(u"none", ts::json::ValuePtr(new ts::json::Null));
+    tree.query(u"values", true, ts::json::Type::Array).set(-5);
+    tree.query(u"values").set(u"x");
+    tree.query(u"values[]", true).add(u"a", 1);
+
+    ts::TextFormatter out(CERR);
+    out.setString();
+    ts::json::StreamWriter json(out);
+    json.startObject();
+    json.key(u"count");
+    json.number(12);
+    json.key(u"empty");
+    json.startArray();
+    json.endArray();
+    json.key(u"name");
+    json.string(u"foo\"bar");
+    json.key(u"sub");
+    json.startObject();
+    json.key(u"flag");
+    json.boolean(true);
+    json.key(u"none");
+    json.null();
+    json.endObject();
+    json.key(u"values");
+    json.startArray();
+    TSUNIT_EQUAL(2, json.depth());
+    json.number(-5);
+    json.string(u"x");
+    json.value(tree.query(u"values[2]"));
+    json.endArray();
+    json.endObject();
+    TSUNIT_EQUAL(0, json.depth());
+
+    ts::UString str;
+    out.getString(str);
+    TSUNIT_EQUAL(tree.printed(), str);
+    debug() << "JsonTest::testStreamWriter:" << std::endl << str << std::endl;
+}
@@ -0,0 +1,290 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for MemoryPool class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryPool.h"
+#include "tsPooledByteBlock.h"
+#include "tsSection.h"
+#include "tsSysUtils.h"
+#include "utestTSUnitThread.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class MemoryPoolTest: public tsunit::Test
+{
+public:
+    MemoryPoolTest();
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testReuse();
+    void testLarge();
+    void testPowerClasses();
+    void testAllocator();
+    void testSection();
+    void testThread();
+
+    TSUNIT_TEST_BEGIN(MemoryPoolTest);
+    TSUNIT_TEST(testReuse);
+    TSUNIT_TEST(testLarge);
+    TSUNIT_TEST(testPowerClasses);
+    TSUNIT_TEST(testAllocator);
+    TSUNIT_TEST(testSection);
+    TSUNIT_TEST(testThread);
+    TSUNIT_TEST_END();
+
+private:
+    bool _disabled;
+};
+
+TSUNIT_REGISTER(MemoryPoolTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+MemoryPoolTest::MemoryPoolTest() :
+    _disabled(false)
+{
+}
+
+// Test suite initialization method.
+void MemoryPoolTest::beforeTest()
+{
+    _disabled = ts::EnvironmentExists(u"TSDUCK_NO_MEMORY_POOL");
+}
+
+// Test suite cleanup method.
+void MemoryPoolTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void MemoryPoolTest::testReuse()
+{
+    ts::MemoryPool::Statistics before, after;
+    ts::MemoryPool::GetStatistics(before);
+
+    void* p1 = ts::MemoryPool::Allocate(40);
+    TSUNIT_ASSERT(p1 != nullptr);
+    ts::MemoryPool::Deallocate(p1, 40);
+
+    // Same size class, the block is reused.
+    void* p2 = ts::MemoryPool::Allocate(48);
+    TSUNIT_ASSERT(p2 != nullptr);
+    ts::MemoryPool::Deallocate(p2, 48);
+
+    ts::MemoryPool::GetStatistics(after);
+    debug() << "MemoryPoolTest::testReuse: " << after.toString() << std::endl;
+
+    if (!_disabled) {
+        TSUNIT_ASSERT(p1 == p2);
+        TSUNIT_EQUAL(before.allocated + 2, after.allocated);
+        TSUNIT_EQUAL(before.deallocated + 2, after.deallocated);
+        TSUNIT_ASSERT(after.reused >= before.reused + 1);
+    }
+
+    // Deallocating a null pointer is allowed.
+    ts::MemoryPool::Deallocate(nullptr, 40);
+}
+
+void MemoryPoolTest::testLarge()
+{
+    ts::MemoryPool::Statistics before, after;
+    ts::MemoryPool::GetStatistics(before);
+
+    uint8_t* p = reinterpret_cast<uint8_t*>(ts::MemoryPool::Allocate(ts::MemoryPool::MAX_BLOCK_SIZE + 1));
+    TSUNIT_ASSERT(p != nullptr);
+    p[ts::MemoryPool::MAX_BLOCK_SIZE] = 0xAB;
+    ts::MemoryPool::Deallocate(p, ts::MemoryPool::MAX_BLOCK_SIZE + 1);
+
+    ts::MemoryPool::GetStatistics(after);
+    TSUNIT_EQUAL(before.allocated, after.allocated);
+    TSUNIT_EQUAL(before.deallocated, after.deallocated);
+    if (!_disabled) {
+        TSUNIT_EQUAL(before.large + 1, after.large);
+    }
+}
+
+void MemoryPoolTest::testPowerClasses()
+{
+    ts::MemoryPool::Statistics before, after;
+
+    // 1000 and 1024 bytes are in the same size class, not 1025.
+    void* p1 = ts::MemoryPool::Allocate(1000);
+    ts::MemoryPool::Deallocate(p1, 1000);
+    void* p2 = ts::MemoryPool::Allocate(1024);
+    ts::MemoryPool::Deallocate(p2, 1024);
+    void* p3 = ts::MemoryPool::Allocate(1025);
+    ts::MemoryPool::Deallocate(p3, 1025);
+    if (!_disabled) {
+        TSUNIT_ASSERT(p1 == p2);
+        TSUNIT_ASSERT(p1 != p3);
+    }
+
+    // The number of cached blocks of maximum size is limited by MAX_CACHED_BYTES.
+    const size_t count = ts::MemoryPool::MAX_CACHED_BYTES / ts::MemoryPool::MAX_BLOCK_SIZE + 10;
+    std::vector<void*> blocks(count);
+    for (size_t i = 0; i < count; ++i) {
+        blocks[i] = ts::MemoryPool::Allocate(ts::MemoryPool::MAX_BLOCK_SIZE);
+    }
+    ts::MemoryPool::GetStatistics(before);
+    for (size_t i = 0; i < count; ++i) {
+        ts::MemoryPool::Deallocate(blocks[i], ts::MemoryPool::MAX_BLOCK_SIZE);
+    }
+    ts::MemoryPool::GetStatistics(after);
+    debug() << "MemoryPoolTest::testPowerClasses: " << after.toString() << std::endl;
+    if (!_disabled) {
+        TSUNIT_EQUAL(before.released + 10, after.released);
+    }
+}
+
+void MemoryPoolTest::testAllocator()
+{
+    // The content of a pooled byte block is allocated in the pool and reused.
+    const uint8_t* data = nullptr;
+    {
+        ts::PooledByteBlock bb(1000);
+        data = bb.data();
+    }
+    ts::PooledByteBlock bb;
+    bb.resize(900, 0xAA);
+    if (!_disabled) {
+        TSUNIT_ASSERT(bb.data() == data);
+    }
+    TSUNIT_EQUAL(900, bb.size());
+    TSUNIT_EQUAL(0xAA, bb[899]);
+
+    // Growing beyond the pooled sizes.
+    bb.resize(3 * ts::MemoryPool::MAX_BLOCK_SIZE, 0x11);
+    TSUNIT_EQUAL(0xAA, bb[899]);
+    TSUNIT_EQUAL(0x11, bb[900]);
+    TSUNIT_EQUAL(0x11, bb[bb.size() - 1]);
+
+    // Append and erase, as in a section reassembly buffer.
+    static const uint8_t more[] = {0x01, 0x02, 0x03};
+    bb.append(more, sizeof(more));
+    TSUNIT_EQUAL(3 * ts::MemoryPool::MAX_BLOCK_SIZE + 3, bb.size());
+    bb.erase(0, 3 * ts::MemoryPool::MAX_BLOCK_SIZE + 1);
+    TSUNIT_EQUAL(2, bb.size());
+    TSUNIT_EQUAL(0x02, bb[0]);
+    TSUNIT_EQUAL(0x03, bb[1]);
+
+    // Other element types.
+    std::vector<uint32_t, ts::PoolAllocator<uint32_t>> vec;
+    for (uint32_t i = 0; i < 100; ++i) {
+        vec.push_back(i);
+    }
+    TSUNIT_EQUAL(100, vec.size());
+    TSUNIT_EQUAL(99, vec[99]);
+    TSUNIT_ASSERT(ts::PoolAllocator<uint8_t>() == ts::PoolAllocator<uint32_t>());
+}
+
+void MemoryPoolTest::testSection()
+{
+    ts::MemoryPool::Statistics before, after;
+    ts::MemoryPool::GetStatistics(before);
+
+    {
+        // Allocate a section, its byte block and their two reference counters.
+        ts::SectionPtr section(new ts::Section(ts::TID_PAT, false, 0x1234, 3, true, 0, 0, nullptr, 0, ts::PID_PAT));
+        TSUNIT_ASSERT(section->isValid());
+        TSUNIT_EQUAL(3, section->version());
+    }
+
+    ts::MemoryPool::GetStatistics(after);
+    debug() << "MemoryPoolTest::testSection: " << after.toString() << std::endl;
+
+    if (!_disabled) {
+        TSUNIT_ASSERT(after.allocated >= before.allocated + 4);
+        TSUNIT_EQUAL(after.allocated - before.allocated, after.deallocated - before.deallocated);
+    }
+}
+
+// A thread which deallocates blocks which were allocated in the main thread.
+namespace {
+    class PoolThread: public utest::TSUnitThread
+    {
+        TS_NOCOPY(PoolThread);
+    public:
+        explicit PoolThread(std::vector<void*>& blocks) : utest::TSUnitThread(), _blocks(blocks) {}
+        virtual ~PoolThread() override { waitForTermination(); }
+        virtual void test() override
+        {
+            for (auto it : _blocks) {
+                ts::MemoryPool::Deallocate(it, 100);
+            }
+            _blocks.clear();
+        }
+    private:
+        std::vector<void*>& _blocks;
+    };
+}
+
+void MemoryPoolTest::testThread()
+{
+    ts::MemoryPool::Statistics before, after;
+    ts::MemoryPool::GetStatistics(before);
+
+    std::vector<void*> blocks(200);
+    for (auto& it : blocks) {
+        it = ts::MemoryPool::Allocate(100);
+        TSUNIT_ASSERT(it != nullptr);
+    }
+    {
+        PoolThread thread(blocks);
+        TSUNIT_ASSERT(thread.start());
+    }
+    TSUNIT_ASSERT(blocks.empty());
+
+    ts::MemoryPool::GetStatistics(after);
+    debug() << "MemoryPoolTest::testThread: " << after.toString() << std::endl;
+
+    if (!_disabled) {
+        // The blocks were cached by the thread and released when it terminated.
+        // The statistics are global, other threads of the process may use the pool in the meantime.
+        TSUNIT_ASSERT(after.allocated >= before.allocated + 200);
+        TSUNIT_ASSERT(after.deallocated >= before.deallocated + 200);
+        TSUNIT_ASSERT(after.released >= before.released + 200);
+    }
+}
@@ -33,6 +33,7 @@
 
 #include "tsNames.h"
 #include "tsSysUtils.h"
+#include "tsNullReport.h"
 #include "tsDuckContext.h"
 #include "tsMPEG2.h"
 #include "tsAVC.h"
@@ -87,6 +88,7 @@ public:
     void testAudioType();
     void testT2MIPacketType();
     void testPlatformId();
+    void testBinaryImage();
 
     TSUNIT_TEST_BEGIN(NamesTest);
     TSUNIT_TEST(testConfigFile);
@@ -125,6 +127,7 @@ public:
     TSUNIT_TEST(testAudioType);
     TSUNIT_TEST(testT2MIPacketType);
     TSUNIT_TEST(testPlatformId);
+    TSUNIT_TEST(testBinaryImage);
     TSUNIT_TEST_END();
 };
 
@@ -412,3 +415,79 @@ void NamesTest::testPlatformId()
     TSUNIT_EQUAL(u"0x000004 (TV digitale mobile, Telecom Italia)", ts::names::PlatformId(4, ts::names::FIRST));
     TSUNIT_EQUAL(u"VTC Mobile TV (0x704001)", ts::names::PlatformId(0x704001, ts::names::VALUE));
 }
+
+void NamesTest::testBinaryImage()
+{
+    const ts::UString textFile(ts::TempFile(u".names"));
+    const ts::UString binFile(textFile + u".bin");
+    const ts::UStringList lines({
+        u"[Foo]",
+        u"Bits = 8",
+        u"0x01 = One",
+        u"0x10-0x1F = Teen",
+        u"0xFF = Last",
+        u"[BAR]",
+        u"0x123456 = Bar name \u00E9t\u00E9",
+        u"[Empty]",
+    });
+    TSUNIT_ASSERT(ts::UString::Save(lines, textFile));
+
+    // Reference names, from the text file.
+    ts::Names text(textFile, false, false);
+    TSUNIT_ASSERT(!text.isBinaryImage());
+    TSUNIT_EQUAL(0, text.errorCount());
+
+    // Compile and reload the same names from the binary image.
+    TSUNIT_ASSERT(ts::Names::CompileFile(textFile, ts::UString(), NULLREP));
+    TSUNIT_ASSERT(ts::FileExists(binFile));
+    {
+        ts::Names bin(textFile);
+        TSUNIT_ASSERT(bin.isBinaryImage());
+        TSUNIT_EQUAL(0, bin.errorCount());
+
+        const ts::Names::Value values[] = {0, 1, 2, 0x0F, 0x10, 0x15, 0x1F, 0x20, 0xFF, 0x100, 0x123456};
+        const ts::UChar* const sections[] = {u"foo", u" FOO ", u"bar", u"empty", u"nonexistent"};
+        for (auto sec : sections) {
+            for (auto val : values) {
+                TSUNIT_EQUAL(text.nameExists(sec, val), bin.nameExists(sec, val));
+                TSUNIT_EQUAL(text.nameFromSection(sec, val, ts::names::VALUE), bin.nameFromSection(sec, val, ts::names::VALUE));
+                TSUNIT_EQUAL(text.nameFromSectionWithFallback(sec, val, 0x11, ts::names::BOTH), bin.nameFromSectionWithFallback(sec, val, 0x11, ts::names::BOTH));
+            }
+        }
+        TSUNIT_EQUAL(u"Teen (0x15)", bin.nameFromSection(u"Foo", 0x15, ts::names::VALUE));
+        TSUNIT_EQUAL(u"unknown (0x20)", bin.nameFromSection(u"Foo", 0x20, ts::names::VALUE));
+        TSUNIT_EQUAL(u"Bar name \u00E9t\u00E9", bin.nameFromSection(u"Bar", 0x123456));
+    }
+
+    // A text file which is written again with the same content, typically a copy, keeps the binary image.
+    TSUNIT_ASSERT(ts::UString::Save(lines, textFile));
+    {
+        ts::Names bin(textFile);
+        TSUNIT_ASSERT(bin.isBinaryImage());
+        TSUNIT_EQUAL(u"One", bin.nameFromSection(u"Foo", 1));
+    }
+
+    // A modified text file with the same size makes the binary image obsolete.
+    const int64_t size = ts::GetFileSize(textFile);
+    ts::UStringList modified(lines);
+    std::replace(modified.begin(), modified.end(), ts::UString(u"0x01 = One"), ts::UString(u"0x01 = Uno"));
+    TSUNIT_ASSERT(ts::UString::Save(modified, textFile));
+    TSUNIT_EQUAL(size, ts::GetFileSize(textFile));
+    {
+        ts::Names bin(textFile);
+        TSUNIT_ASSERT(!bin.isBinaryImage());
+        TSUNIT_EQUAL(u"Uno", bin.nameFromSection(u"Foo", 1));
+    }
+
+    // An obsolete binary image is ignored.
+    TSUNIT_ASSERT(ts::UString::Save(ts::UStringList({u"[Foo]", u"0x02 = Two"}), textFile, true));
+    {
+        ts::Names bin(textFile);
+        TSUNIT_ASSERT(!bin.isBinaryImage());
+        TSUNIT_EQUAL(u"Two", bin.nameFromSection(u"Foo", 2));
+        TSUNIT_EQUAL(u"Uno", bin.nameFromSection(u"Foo", 1));
+    }
+
+    ts::DeleteFile(binFile);
+    ts::DeleteFile(textFile);
+}
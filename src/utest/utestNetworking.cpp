@@ -69,6 +69,7 @@ public:
     void testSocketAddress();
     void testTCPSocket();
     void testUDPSocket();
+    void testUDPBatch();
     void testIPHeader();
 
     TSUNIT_TEST_BEGIN(NetworkingTest);
@@ -81,6 +82,7 @@ public:
     TSUNIT_TEST(testSocketAddress);
     TSUNIT_TEST(testTCPSocket);
     TSUNIT_TEST(testUDPSocket);
+    TSUNIT_TEST(testUDPBatch);
     TSUNIT_TEST(testIPHeader);
     TSUNIT_TEST_END();
 
@@ -680,6 +682,58 @@ void NetworkingTest::testUDPSocket()
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+// Test batch send and receive.
+void NetworkingTest::testUDPBatch()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12346;
+    const size_t count = 5;
+    const size_t max_size = 100;
+
+    // Create receiver and sender sockets.
+    ts::UDPSocket receiver(true);
+    TSUNIT_ASSERT(receiver.isOpen());
+    TSUNIT_ASSERT(receiver.reusePort(true, CERR));
+    TSUNIT_ASSERT(receiver.bind(ts::SocketAddress(ts::IPAddress::LocalHost, portNumber), CERR));
+
+    ts::UDPSocket sender(true);
+    TSUNIT_ASSERT(sender.isOpen());
+    TSUNIT_ASSERT(sender.bind(ts::SocketAddress(ts::IPAddress::LocalHost, ts::SocketAddress::AnyPort), CERR));
+    TSUNIT_ASSERT(sender.setDefaultDestination(ts::SocketAddress(ts::IPAddress::LocalHost, portNumber), CERR));
+
+    // Send messages of distinct sizes and contents.
+    uint8_t messages[count][max_size];
+    const void* data[count];
+    size_t sizes[count];
+    for (size_t i = 0; i < count; ++i) {
+        ::memset(messages[i], int(i + 1), max_size);
+        data[i] = messages[i];
+        sizes[i] = 10 * (i + 1);
+    }
+    TSUNIT_ASSERT(sender.sendBatch(data, sizes, count, CERR));
+
+    // Receive all messages, possibly in several batches.
+    uint8_t buffer[count * max_size];
+    ts::UDPSocket::ReceivedMessageVector received;
+    size_t next = 0;
+    while (next < count) {
+        const size_t max_count = count - next;
+        TSUNIT_ASSERT(receiver.receiveBatch(buffer, max_size, max_count, received, nullptr, CERR));
+        TSUNIT_ASSERT(!received.empty());
+        TSUNIT_ASSERT(received.size() <= max_count);
+        CERR.debug(u"UDPSocketTest: received batch of %d messages", {received.size()});
+        for (size_t i = 0; i < received.size(); ++i) {
+            const ts::UDPSocket::ReceivedMessage& msg(received[i]);
+            TSUNIT_ASSERT(msg.index < max_count);
+            TSUNIT_EQUAL(sizes[next], msg.size);
+            TSUNIT_ASSERT(::memcmp(buffer + msg.index * max_size, messages[next], msg.size) == 0);
+            TSUNIT_ASSERT(ts::IPAddress(msg.sender) == ts::IPAddress::LocalHost);
+            next++;
+        }
+    }
+}
+
 // Test IP header
 void NetworkingTest::testIPHeader()
 {
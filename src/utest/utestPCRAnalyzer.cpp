@@ -0,0 +1,262 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PCRAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsPCRAnalyzer.h"
+#include "tsTSPacket.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PCRAnalyzerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testConstantRate();
+    void testCapacityWrap();
+    void testUnorderedDTS();
+
+    TSUNIT_TEST_BEGIN(PCRAnalyzerTest);
+    TSUNIT_TEST(testConstantRate);
+    TSUNIT_TEST(testCapacityWrap);
+    TSUNIT_TEST(testUnorderedDTS);
+    TSUNIT_TEST_END();
+
+private:
+    // Build a packet with a PCR.
+    static ts::TSPacket PCRPacket(ts::PID pid, uint8_t cc, uint64_t pcr);
+    // Build a packet with a PES header containing a PTS and a DTS.
+    static ts::TSPacket DTSPacket(ts::PID pid, uint8_t cc, uint64_t dts);
+    // Check the bitrates over all sliding windows.
+    static void CheckWindows(const ts::PCRAnalyzer& zer, ts::BitRate bitrate);
+};
+
+TSUNIT_REGISTER(PCRAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+void PCRAnalyzerTest::beforeTest()
+{
+}
+
+void PCRAnalyzerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test helpers.
+//----------------------------------------------------------------------------
+
+ts::TSPacket PCRAnalyzerTest::PCRPacket(ts::PID pid, uint8_t cc, uint64_t pcr)
+{
+    ts::TSPacket pkt;
+    pkt.init(pid, cc);
+    TSUNIT_ASSERT(pkt.setPCR(pcr, true));
+    return pkt;
+}
+
+ts::TSPacket PCRAnalyzerTest::DTSPacket(ts::PID pid, uint8_t cc, uint64_t dts)
+{
+    // Video PES header with PTS and DTS (both initially zero).
+    static const uint8_t header[] = {
+        0x00, 0x00, 0x01, 0xE0, 0x00, 0x00, 0x80, 0xC0, 0x0A,
+        0x31, 0x00, 0x01, 0x00, 0x01,
+        0x11, 0x00, 0x01, 0x00, 0x01,
+    };
+    ts::TSPacket pkt;
+    pkt.init(pid, cc);
+    pkt.setPUSI();
+    ::memcpy(pkt.b + 4, header, sizeof(header));
+    pkt.setPTS(dts);
+    pkt.setDTS(dts);
+    TSUNIT_EQUAL(dts, pkt.getDTS());
+    return pkt;
+}
+
+void PCRAnalyzerTest::CheckWindows(const ts::PCRAnalyzer& zer, ts::BitRate bitrate)
+{
+    const ts::BitRate bitrate204 = ts::BitRate((uint64_t(bitrate) * ts::PKT_RS_SIZE) / ts::PKT_SIZE);
+    const ts::PCRAnalyzer::Status status(zer);
+    debug() << "PCRAnalyzerTest: " << status << std::endl;
+
+    TSUNIT_EQUAL(bitrate, zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC1));
+    TSUNIT_EQUAL(bitrate, zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC10));
+    TSUNIT_EQUAL(bitrate, zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC60));
+    TSUNIT_EQUAL(bitrate204, zer.windowBitrate204(ts::PCRAnalyzer::Window::SEC1));
+    TSUNIT_EQUAL(bitrate204, zer.windowBitrate204(ts::PCRAnalyzer::Window::SEC10));
+    TSUNIT_EQUAL(bitrate204, zer.windowBitrate204(ts::PCRAnalyzer::Window::SEC60));
+    TSUNIT_EQUAL(bitrate, zer.instantaneousBitrate188());
+
+    for (size_t i = 0; i < ts::PCRAnalyzer::WINDOW_COUNT; ++i) {
+        TSUNIT_EQUAL(bitrate, status.window_bitrate_188[i]);
+        TSUNIT_EQUAL(bitrate204, status.window_bitrate_204[i]);
+    }
+    TSUNIT_EQUAL(bitrate, status.instantaneous_bitrate_188);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Constant rate stream: one PCR every 10 packets, 1 Mb/s, 70 seconds.
+void PCRAnalyzerTest::testConstantRate()
+{
+    const ts::BitRate bitrate = 1000000;
+    const uint64_t pkt_duration = (ts::PKT_SIZE * 8 * ts::SYSTEM_CLOCK_FREQ) / bitrate;
+    const size_t pkt_count = size_t(70 * ts::SYSTEM_CLOCK_FREQ / pkt_duration);
+
+    ts::PCRAnalyzer zer;
+    uint8_t cc_pcr = 0;
+    uint8_t cc_data = 0;
+    for (size_t i = 0; i < pkt_count; ++i) {
+        if (i % 10 == 0) {
+            zer.feedPacket(PCRPacket(0x0100, cc_pcr, i * pkt_duration));
+            cc_pcr = (cc_pcr + 1) & ts::CC_MASK;
+        }
+        else {
+            ts::TSPacket pkt;
+            pkt.init(0x0200, cc_data);
+            zer.feedPacket(pkt);
+            cc_data = (cc_data + 1) & ts::CC_MASK;
+        }
+        if (i == 10 * ts::SYSTEM_CLOCK_FREQ / pkt_duration) {
+            // After 10 seconds, the 60-second window is not yet full but must be accurate.
+            CheckWindows(zer, bitrate);
+        }
+    }
+
+    TSUNIT_ASSERT(zer.bitrateIsValid());
+    TSUNIT_EQUAL(bitrate, zer.bitrate188());
+    CheckWindows(zer, bitrate);
+    TSUNIT_EQUAL(bitrate / 10, zer.windowBitrate188(0x0100, ts::PCRAnalyzer::Window::SEC10));
+    TSUNIT_EQUAL(bitrate / 10, zer.windowBitrate188(0x0100, ts::PCRAnalyzer::Window::SEC60));
+
+    const ts::PCRAnalyzer::Status status(zer);
+    TSUNIT_ASSERT(status.bitrate_valid);
+    TSUNIT_EQUAL(pkt_count, status.packet_count);
+    TSUNIT_EQUAL(1, status.pcr_pids);
+    TSUNIT_EQUAL(0, status.discontinuities);
+}
+
+// One PCR in each packet at 20 Mb/s: more than 1024 PCR's per second, the ring buffers wrap.
+// After 2 seconds, the bitrate doubles: the last second contains only the new bitrate.
+void PCRAnalyzerTest::testCapacityWrap()
+{
+    const ts::BitRate bitrate = 20304000;
+    const uint64_t pkt_duration = (ts::PKT_SIZE * 8 * ts::SYSTEM_CLOCK_FREQ) / bitrate;
+    const size_t pkt_count = size_t(12 * ts::SYSTEM_CLOCK_FREQ / pkt_duration);
+    TSUNIT_EQUAL(2000, pkt_duration);
+
+    ts::PCRAnalyzer zer;
+    uint8_t cc = 0;
+    uint64_t pcr = 0;
+    for (size_t i = 0; i < pkt_count; ++i) {
+        zer.feedPacket(PCRPacket(0x0100, cc, pcr));
+        cc = (cc + 1) & ts::CC_MASK;
+        pcr += pkt_duration;
+    }
+    CheckWindows(zer, bitrate);
+
+    // Double bitrate during 1.5 second.
+    for (size_t i = 0; i < 3 * ts::SYSTEM_CLOCK_FREQ / pkt_duration; ++i) {
+        zer.feedPacket(PCRPacket(0x0100, cc, pcr));
+        cc = (cc + 1) & ts::CC_MASK;
+        pcr += pkt_duration / 2;
+    }
+    TSUNIT_EQUAL(2 * bitrate, zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC1));
+    TSUNIT_ASSERT(zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC10) > bitrate);
+    TSUNIT_ASSERT(zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC10) < 2 * bitrate);
+    TSUNIT_ASSERT(zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC60) > bitrate);
+    TSUNIT_ASSERT(zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC60) < zer.windowBitrate188(ts::PCRAnalyzer::Window::SEC10));
+}
+
+// Two video PID's with DTS, the second one is 2 seconds ahead of the first one.
+// The DTS are not in sequence across the two PID's. Each PID has its own sliding windows.
+void PCRAnalyzerTest::testUnorderedDTS()
+{
+    const ts::BitRate bitrate = 1504000;
+    const uint64_t pkt_duration = (ts::PKT_SIZE * 8 * ts::SYSTEM_CLOCK_SUBFREQ) / bitrate;
+    const size_t pkt_count = size_t(70 * ts::SYSTEM_CLOCK_SUBFREQ / pkt_duration);
+    const uint64_t offset = 2 * ts::SYSTEM_CLOCK_SUBFREQ;
+    TSUNIT_EQUAL(90, pkt_duration);
+
+    ts::PCRAnalyzer zer;
+    zer.resetAndUseDTS();
+    uint8_t cc1 = 0;
+    uint8_t cc2 = 0;
+    uint8_t cc3 = 0;
+    for (size_t i = 0; i < pkt_count; ++i) {
+        if (i % 40 == 0) {
+            zer.feedPacket(DTSPacket(0x0100, cc1, i * pkt_duration));
+            cc1 = (cc1 + 1) & ts::CC_MASK;
+        }
+        else if (i % 40 == 20) {
+            zer.feedPacket(DTSPacket(0x0200, cc2, i * pkt_duration + offset));
+            cc2 = (cc2 + 1) & ts::CC_MASK;
+        }
+        else {
+            ts::TSPacket pkt;
+            pkt.init(0x0300, cc3);
+            zer.feedPacket(pkt);
+            cc3 = (cc3 + 1) & ts::CC_MASK;
+        }
+        if (i % 20 == 0 && i >= 40) {
+            // Check after each DTS, on both PID's.
+            CheckWindows(zer, bitrate);
+            for (size_t w = 0; w < ts::PCRAnalyzer::WINDOW_COUNT; ++w) {
+                TSUNIT_EQUAL(bitrate / 40, zer.windowBitrate188(0x0100, ts::PCRAnalyzer::Window(w)));
+                if (i >= 60) {
+                    TSUNIT_EQUAL(bitrate / 40, zer.windowBitrate188(0x0200, ts::PCRAnalyzer::Window(w)));
+                    TSUNIT_EQUAL(40800, zer.windowBitrate204(0x0200, ts::PCRAnalyzer::Window(w)));
+                }
+            }
+        }
+    }
+
+    TSUNIT_ASSERT(zer.bitrateIsValid());
+    TSUNIT_EQUAL(bitrate, zer.bitrate188());
+    CheckWindows(zer, bitrate);
+
+    // No PCR or DTS in the data PID.
+    TSUNIT_EQUAL(0, zer.windowBitrate188(0x0300, ts::PCRAnalyzer::Window::SEC1));
+}
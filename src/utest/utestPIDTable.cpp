@@ -0,0 +1,201 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PIDTable
+//
+//----------------------------------------------------------------------------
+
+#include "tsPIDTable.h"
+#include "tsUString.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PIDTableTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testEmpty();
+    void testInsert();
+    void testIterator();
+    void testErase();
+
+    TSUNIT_TEST_BEGIN(PIDTableTest);
+    TSUNIT_TEST(testEmpty);
+    TSUNIT_TEST(testInsert);
+    TSUNIT_TEST(testIterator);
+    TSUNIT_TEST(testErase);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(PIDTableTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PIDTableTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void PIDTableTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PIDTableTest::testEmpty()
+{
+    const ts::PIDTable<int> table;
+    TSUNIT_ASSERT(table.empty());
+    TSUNIT_EQUAL(0, table.size());
+    TSUNIT_EQUAL(0, table.count(0));
+    TSUNIT_EQUAL(0, table.count(ts::PID_NULL));
+    TSUNIT_ASSERT(table.begin() == table.end());
+    TSUNIT_ASSERT(table.find(100) == table.end());
+}
+
+void PIDTableTest::testInsert()
+{
+    ts::PIDTable<ts::UString> table;
+
+    table[100] = u"foo";
+    table[ts::PID_NULL] = u"null";
+    table[0] = u"pat";
+
+    TSUNIT_ASSERT(!table.empty());
+    TSUNIT_EQUAL(3, table.size());
+    TSUNIT_EQUAL(1, table.count(0));
+    TSUNIT_EQUAL(1, table.count(100));
+    TSUNIT_EQUAL(1, table.count(ts::PID_NULL));
+    TSUNIT_EQUAL(0, table.count(101));
+    TSUNIT_EQUAL(0, table.count(ts::PID_MAX));
+    TSUNIT_EQUAL(u"foo", table[100]);
+    TSUNIT_EQUAL(3, table.size());
+
+    // Access to a new PID creates a default value.
+    TSUNIT_EQUAL(u"", table[200]);
+    TSUNIT_EQUAL(4, table.size());
+
+    auto it = table.find(100);
+    TSUNIT_ASSERT(it != table.end());
+    TSUNIT_EQUAL(100, it->first);
+    TSUNIT_EQUAL(u"foo", it->second);
+    TSUNIT_ASSERT(table.find(101) == table.end());
+
+    // References remain valid after insertion of other PID's.
+    ts::UString& ref(table[100]);
+    for (ts::PID pid = 1000; pid < 2000; ++pid) {
+        table[pid] = u"other";
+    }
+    TSUNIT_EQUAL(u"foo", ref);
+    TSUNIT_EQUAL(1004, table.size());
+
+    table.clear();
+    TSUNIT_ASSERT(table.empty());
+    TSUNIT_EQUAL(0, table.size());
+    TSUNIT_EQUAL(0, table.count(100));
+    TSUNIT_ASSERT(table.begin() == table.end());
+}
+
+void PIDTableTest::testIterator()
+{
+    ts::PIDTable<int> table;
+    table[ts::PID_NULL] = 4;
+    table[0x100] = 3;
+    table[0x20] = 2;
+    table[0] = 1;
+
+    // Iterations are in increasing order of PID.
+    std::vector<ts::PID> pids;
+    std::vector<int> values;
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        pids.push_back(it->first);
+        values.push_back(it->second);
+    }
+    TSUNIT_EQUAL(4, pids.size());
+    TSUNIT_EQUAL(0x0000, pids[0]);
+    TSUNIT_EQUAL(0x0020, pids[1]);
+    TSUNIT_EQUAL(0x0100, pids[2]);
+    TSUNIT_EQUAL(0x1FFF, pids[3]);
+    TSUNIT_EQUAL(1, values[0]);
+    TSUNIT_EQUAL(2, values[1]);
+    TSUNIT_EQUAL(3, values[2]);
+    TSUNIT_EQUAL(4, values[3]);
+
+    // Values can be modified through an iterator.
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        it->second *= 10;
+    }
+
+    // Constant iteration, conversion from iterator.
+    const ts::PIDTable<int>& ctable(table);
+    int sum = 0;
+    for (ts::PIDTable<int>::const_iterator it = table.begin(); it != ctable.end(); it++) {
+        sum += (*it).second;
+    }
+    TSUNIT_EQUAL(100, sum);
+}
+
+void PIDTableTest::testErase()
+{
+    ts::PIDTable<int> table;
+    table[10] = 1;
+    table[20] = 2;
+    table[30] = 3;
+
+    TSUNIT_EQUAL(1, table.erase(20));
+    TSUNIT_EQUAL(0, table.erase(20));
+    TSUNIT_EQUAL(0, table.erase(40));
+    TSUNIT_EQUAL(2, table.size());
+    TSUNIT_EQUAL(0, table.count(20));
+
+    auto it = table.begin();
+    TSUNIT_EQUAL(10, it->first);
+    ++it;
+    TSUNIT_EQUAL(30, it->first);
+    ++it;
+    TSUNIT_ASSERT(it == table.end());
+
+    // A removed PID is recreated with a default value.
+    TSUNIT_EQUAL(0, table[20]);
+    TSUNIT_EQUAL(3, table.size());
+}
@@ -0,0 +1,139 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for PacketPacer class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPacketPacer.h"
+#include "tsMonotonic.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PacketPacerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testBitRate();
+    void testPCR();
+
+    TSUNIT_TEST_BEGIN(PacketPacerTest);
+    TSUNIT_TEST(testBitRate);
+    TSUNIT_TEST(testPCR);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(PacketPacerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PacketPacerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void PacketPacerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void PacketPacerTest::testBitRate()
+{
+    // 7 packets every 500 microseconds.
+    const ts::BitRate bitrate = ts::BitRate((7 * ts::PKT_SIZE_BITS * ts::NanoSecPerSec) / (500 * ts::NanoSecPerMicroSec));
+    ts::TSPacketVector packets(7, ts::NullPacket);
+
+    ts::PacketPacer pacer;
+    pacer.setMode(ts::PacketPacer::Mode::BITRATE);
+    pacer.setBitRate(bitrate);
+    pacer.reset();
+
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < 41; ++i) {
+        pacer.pace(packets.data(), packets.size(), 0);
+    }
+    ts::Monotonic end(true);
+    const ts::NanoSecond elapsed = end - start;
+
+    debug() << "PacketPacerTest::testBitRate: elapsed: " << elapsed << " ns, spin: " << pacer.spinDuration()
+            << " ns, lateness: " << pacer.latenessStatistics().meanString() << " us, jitter: "
+            << pacer.jitterStatistics().standardDeviationString() << " us" << std::endl;
+
+    // 40 intervals of 500 microseconds between the first and last datagram.
+    TSUNIT_ASSERT(elapsed >= 20 * ts::NanoSecPerMilliSec);
+    TSUNIT_EQUAL(41, pacer.latenessStatistics().count());
+    TSUNIT_EQUAL(40, pacer.jitterStatistics().count());
+    TSUNIT_EQUAL(0, pacer.resyncCount());
+    TSUNIT_ASSERT(pacer.latenessStatistics().minimum() >= 0.0);
+}
+
+void PacketPacerTest::testPCR()
+{
+    // 10 packets per group, one PCR at the beginning of each group, 1 ms between PCR's.
+    ts::TSPacketVector packets(10, ts::NullPacket);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].init(100);
+    }
+    TSUNIT_ASSERT(packets[0].setPCR(0, true));
+
+    ts::PacketPacer pacer;
+    pacer.setMode(ts::PacketPacer::Mode::PCR);
+    pacer.reset();
+
+    ts::Monotonic start(true);
+    for (uint64_t pcr = 0; pcr <= 20 * (ts::SYSTEM_CLOCK_FREQ / 1000); pcr += ts::SYSTEM_CLOCK_FREQ / 1000) {
+        packets[0].setPCR(pcr);
+        pacer.pace(packets.data(), packets.size(), 0);
+    }
+    ts::Monotonic end(true);
+    const ts::NanoSecond elapsed = end - start;
+
+    debug() << "PacketPacerTest::testPCR: elapsed: " << elapsed << " ns, lateness: "
+            << pacer.latenessStatistics().meanString() << " us" << std::endl;
+
+    // The first group sets the origin, the next 20 groups are paced, 1 ms apart.
+    TSUNIT_ASSERT(elapsed >= 20 * ts::NanoSecPerMilliSec);
+    TSUNIT_EQUAL(20, pacer.latenessStatistics().count());
+    TSUNIT_EQUAL(0, pacer.resyncCount());
+}
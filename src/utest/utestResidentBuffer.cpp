@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsResidentBuffer.h"
+#include "tsSysInfo.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
 
@@ -47,9 +48,11 @@ public:
     virtual void afterTest() override;
 
     void testResidentBuffer();
+    void testPlacement();
 
     TSUNIT_TEST_BEGIN(ResidentBufferTest);
     TSUNIT_TEST(testResidentBuffer);
+    TSUNIT_TEST(testPlacement);
     TSUNIT_TEST_END();
 };
 
@@ -87,3 +90,30 @@ void ResidentBufferTest::testResidentBuffer()
     TSUNIT_ASSERT(buf.isLocked());
     TSUNIT_ASSERT(buf.count() >= buf_size);
 }
+
+void ResidentBufferTest::testPlacement()
+{
+    const size_t buf_size = 100000;
+    const size_t huge_page_size = 2 * 1024 * 1024;
+    const size_t sys_page_size = ts::SysInfo::Instance()->memoryPageSize();
+
+    // Huge pages may be unavailable, in which case normal pages are used.
+    ts::ResidentBuffer<uint8_t> buf(buf_size, huge_page_size, 0);
+
+    debug() << "ResidentBufferTest: isLocked() = " << buf.isLocked()
+            << ", pageSize() = " << buf.pageSize()
+            << ", numaNode() = " << buf.numaNode()
+            << ", pageErrorCode() = " << buf.pageErrorCode()
+            << ", numaErrorCode() = " << buf.numaErrorCode()
+            << ", NUMA nodes: " << ts::SysInfo::Instance()->numaNodeCount() << std::endl;
+
+    TSUNIT_ASSERT(buf.count() >= buf_size);
+    TSUNIT_ASSERT(buf.pageSize() == huge_page_size || buf.pageSize() == sys_page_size);
+    TSUNIT_EQUAL(buf.pageSize() == huge_page_size, buf.pageErrorCode() == ts::SYS_SUCCESS);
+    TSUNIT_EQUAL(0, size_t(buf.base()) % buf.pageSize());
+    TSUNIT_ASSERT(buf.numaNode() == ts::NPOS || buf.numaNode() < ts::SysInfo::Instance()->numaNodeCount());
+
+    // The whole buffer is usable.
+    ::memset(buf.base(), 0xAA, buf.count());
+    TSUNIT_EQUAL(0xAA, buf.base()[buf.count() - 1]);
+}
@@ -32,8 +32,10 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsTSScrambling.h"
 #include "tsTSPacket.h"
 #include "tsNames.h"
+#include "tsNullReport.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
 
@@ -49,10 +51,17 @@ public:
     virtual void afterTest() override;
 
     void testScrambling();
+    void testBatch();
+    void testPacketBatch();
 
     TSUNIT_TEST_BEGIN(ScramblingTest);
     TSUNIT_TEST(testScrambling);
+    TSUNIT_TEST(testBatch);
+    TSUNIT_TEST(testPacketBatch);
     TSUNIT_TEST_END();
+
+private:
+    void testPacketBatch(uint8_t type, const ts::ByteBlock& cw_even, const ts::ByteBlock& cw_odd);
 };
 
 TSUNIT_REGISTER(ScramblingTest);
@@ -211,3 +220,129 @@ void ScramblingTest::testScrambling()
         TSUNIT_ASSERT(::memcmp(pkt.b + header_size, vec->cipher.b + header_size, payload_size) == 0);
     }
 }
+
+// Compare multi-packet operations with packet-per-packet ones.
+void ScramblingTest::testBatch()
+{
+    debug() << "ScramblingTest::testBatch: implementation: " << ts::DVBCSA2::BatchImplementation() << std::endl;
+
+    static const uint8_t cw[ts::DVBCSA2::KEY_SIZE] = {0xC0, 0xB1, 0xF0, 0x61, 0xA6, 0xED, 0x71, 0x04};
+    static const size_t counts[] = {1, 7, 8, 63, 64, 65, 300, 1000};
+    ts::DVBCSA2 single;
+    ts::DVBCSA2 batch;
+    TSUNIT_ASSERT(single.setKey(cw, sizeof(cw)));
+    TSUNIT_ASSERT(batch.setKey(cw, sizeof(cw)));
+
+    for (size_t ci = 0; ci < sizeof(counts) / sizeof(counts[0]); ++ci) {
+        const size_t count = counts[ci];
+        std::vector<ts::ByteBlock> plain(count);
+        std::vector<ts::ByteBlock> cipher(count);
+        std::vector<void*> data(count);
+        std::vector<size_t> sizes(count);
+
+        // Mostly full payloads, some with residue or shorter than one block.
+        for (size_t i = 0; i < count; ++i) {
+            const size_t size = i % 5 == 0 ? 1 + (i * 37) % ts::DVBCSA2::MAX_DATA_SIZE : ts::DVBCSA2::MAX_DATA_SIZE;
+            plain[i].resize(size);
+            for (size_t k = 0; k < size; ++k) {
+                plain[i][k] = uint8_t(i * 13 + k * 7 + (k >> 3));
+            }
+            cipher[i] = plain[i];
+            TSUNIT_ASSERT(single.encryptInPlace(cipher[i].data(), size));
+        }
+
+        // Batch encryption.
+        std::vector<ts::ByteBlock> work(plain);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = work[i].data();
+            sizes[i] = work[i].size();
+        }
+        TSUNIT_ASSERT(batch.encryptInPlaceBatch(count, data.data(), sizes.data()));
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_ASSERT(work[i] == cipher[i]);
+        }
+
+        // Batch decryption.
+        TSUNIT_ASSERT(batch.decryptInPlaceBatch(count, data.data(), sizes.data()));
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_ASSERT(work[i] == plain[i]);
+        }
+    }
+
+    // Invalid sizes.
+    uint8_t buffer[ts::DVBCSA2::MAX_DATA_SIZE + 1];
+    void* data = buffer;
+    size_t size = sizeof(buffer);
+    TSUNIT_ASSERT(!batch.encryptInPlaceBatch(1, &data, &size));
+}
+
+// Multi-packet scrambling of TS packets, with parity changes.
+void ScramblingTest::testPacketBatch()
+{
+    static const uint8_t cw_even[ts::DVBCSA2::KEY_SIZE] = {0xA6, 0x34, 0x69, 0x43, 0xD3, 0xEE, 0x85, 0x46};
+    static const uint8_t cw_odd[ts::DVBCSA2::KEY_SIZE] = {0x03, 0x0B, 0x48, 0x56, 0x54, 0x37, 0x75, 0x00};
+    static const uint8_t aes_even[16] = {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+    static const uint8_t aes_odd[16] = {0x60, 0x3D, 0xEB, 0x10, 0x15, 0xCA, 0x71, 0xBE, 0x2B, 0x73, 0xAE, 0xF0, 0x85, 0x7D, 0x77, 0x81};
+
+    testPacketBatch(ts::SCRAMBLING_DVB_CSA2, ts::ByteBlock(cw_even, sizeof(cw_even)), ts::ByteBlock(cw_odd, sizeof(cw_odd)));
+    testPacketBatch(ts::SCRAMBLING_DVB_CISSA1, ts::ByteBlock(aes_even, sizeof(aes_even)), ts::ByteBlock(aes_odd, sizeof(aes_odd)));
+    testPacketBatch(ts::SCRAMBLING_ATIS_IIF_IDSA, ts::ByteBlock(aes_even, sizeof(aes_even)), ts::ByteBlock(aes_odd, sizeof(aes_odd)));
+    testPacketBatch(ts::SCRAMBLING_DUCK_AES_CBC, ts::ByteBlock(aes_even, sizeof(aes_even)), ts::ByteBlock(aes_odd, sizeof(aes_odd)));
+    testPacketBatch(ts::SCRAMBLING_DUCK_AES_CTR, ts::ByteBlock(aes_even, sizeof(aes_even)), ts::ByteBlock(aes_odd, sizeof(aes_odd)));
+}
+
+void ScramblingTest::testPacketBatch(uint8_t type, const ts::ByteBlock& cw_even, const ts::ByteBlock& cw_odd)
+{
+    static const size_t count = 200;
+
+    ts::TSScrambling single(NULLREP, type);
+    ts::TSScrambling batch(NULLREP, type);
+    TSUNIT_ASSERT(single.start());
+    TSUNIT_ASSERT(batch.start());
+    debug() << "ScramblingTest::testPacketBatch: " << single.algoName() << std::endl;
+
+    std::vector<ts::TSPacket> plain(count);
+    std::vector<ts::TSPacket> cipher(count);
+    std::vector<ts::TSPacket*> pkts(count);
+    for (size_t i = 0; i < count; ++i) {
+        plain[i].init(ts::PID(100 + i % 3), uint8_t(i & 0x0F), uint8_t(i));
+        for (size_t k = 4; k < ts::PKT_SIZE; ++k) {
+            plain[i].b[k] = uint8_t(i * 11 + k);
+        }
+        // Some packets with adaptation fields, various payload sizes, with or without residue.
+        if (i % 7 == 3) {
+            plain[i].b[3] |= 0x20;
+            plain[i].b[4] = uint8_t(i % 50);
+            plain[i].b[5] = 0x00;
+        }
+        cipher[i] = plain[i];
+        pkts[i] = &cipher[i];
+    }
+
+    // Scramble first half with even key, second half with odd key.
+    TSUNIT_ASSERT(single.setCW(cw_even, ts::SC_EVEN_KEY));
+    TSUNIT_ASSERT(single.setCW(cw_odd, ts::SC_ODD_KEY));
+    TSUNIT_ASSERT(batch.setCW(cw_even, ts::SC_EVEN_KEY));
+    TSUNIT_ASSERT(batch.setCW(cw_odd, ts::SC_ODD_KEY));
+
+    TSUNIT_ASSERT(batch.setEncryptParity(ts::SC_EVEN_KEY));
+    TSUNIT_ASSERT(batch.encrypt(pkts.data(), count / 2));
+    TSUNIT_ASSERT(batch.setEncryptParity(ts::SC_ODD_KEY));
+    TSUNIT_ASSERT(batch.encrypt(pkts.data() + count / 2, count - count / 2));
+
+    for (size_t i = 0; i < count; ++i) {
+        ts::TSPacket pkt(plain[i]);
+        TSUNIT_ASSERT(single.setEncryptParity(i < count / 2 ? ts::SC_EVEN_KEY : ts::SC_ODD_KEY));
+        TSUNIT_ASSERT(single.encrypt(pkt));
+        TSUNIT_ASSERT(pkt == cipher[i]);
+    }
+
+    // Already scrambled packets cannot be scrambled again.
+    TSUNIT_ASSERT(!batch.encrypt(pkts.data(), count));
+
+    // Batch descrambling with mixed parities.
+    TSUNIT_ASSERT(batch.decrypt(pkts.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(cipher[i] == plain[i]);
+    }
+}
@@ -198,6 +198,14 @@ void SectionFileTest::testTable(const char* name, const ts::UChar* ref_xml, cons
 
     // Convert binary tables to XML.
     TSUNIT_EQUAL(ref_xml, xml.toXML());
+
+    // Same tables when the XML content is read one table at a time from a stream.
+    std::istringstream xml_strm(ts::UString(ref_xml).toUTF8());
+    ts::SectionFile xml2(duck);
+    TSUNIT_ASSERT(xml2.loadXML(xml_strm));
+    std::ostringstream strm2;
+    TSUNIT_ASSERT(xml2.saveBinary(strm2));
+    TSUNIT_ASSERT(strm2.str() == sections);
 }
 
 
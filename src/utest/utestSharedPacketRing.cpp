@@ -0,0 +1,266 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::SharedPacketRing
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedPacketRing.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+#include "utestTSUnitThread.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class SharedPacketRingTest: public tsunit::Test
+{
+public:
+    SharedPacketRingTest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testTransfer();
+    void testNonBlocking();
+    void testErrors();
+
+    TSUNIT_TEST_BEGIN(SharedPacketRingTest);
+    TSUNIT_TEST(testTransfer);
+    TSUNIT_TEST(testNonBlocking);
+    TSUNIT_TEST(testErrors);
+    TSUNIT_TEST_END();
+
+private:
+    ts::UString _name;
+};
+
+TSUNIT_REGISTER(SharedPacketRingTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+SharedPacketRingTest::SharedPacketRingTest() :
+    _name(ts::UString::Format(u"tsduck-utest-%d", {ts::CurrentProcessId()}))
+{
+}
+
+// Test suite initialization method.
+void SharedPacketRingTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void SharedPacketRingTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+#if defined(TS_UNIX)
+
+namespace {
+    // Build a packet with a 32-bit sequence number in the payload.
+    void MakePacket(ts::TSPacket& pkt, uint32_t seq)
+    {
+        pkt = ts::NullPacket;
+        ts::PutUInt32(pkt.b + 4, seq);
+    }
+
+    // A reader thread which checks the sequence numbers of all packets.
+    class ReaderThread: public utest::TSUnitThread
+    {
+        TS_NOCOPY(ReaderThread);
+    public:
+        ReaderThread(ts::SharedPacketRing& ring) : utest::TSUnitThread(), _ring(ring), _count(0) {}
+        virtual ~ReaderThread() override { waitForTermination(); }
+        uint32_t count() const { return _count; }
+        virtual void test() override
+        {
+            ts::TSPacketVector pkts(13);
+            ts::TSPacketMetadataVector mdata(pkts.size());
+            size_t n = 0;
+            while ((n = _ring.read(pkts.data(), mdata.data(), pkts.size(), NULLREP)) > 0) {
+                TSUNIT_ASSERT(n <= pkts.size());
+                for (size_t i = 0; i < n; ++i) {
+                    TSUNIT_EQUAL(_count, ts::GetUInt32(pkts[i].b + 4));
+                    TSUNIT_EQUAL(_count % 3 == 0, mdata[i].hasLabel(3));
+                    _count++;
+                }
+            }
+        }
+    private:
+        ts::SharedPacketRing& _ring;
+        uint32_t _count;
+    };
+}
+
+void SharedPacketRingTest::testTransfer()
+{
+    // Small ring with many packets to exercise wrap-around and sleeping on both sides.
+    constexpr uint32_t COUNT = 50000;
+    ts::SharedPacketRing writer;
+    TSUNIT_ASSERT(writer.create(_name, 29, false, NULLREP));
+    TSUNIT_EQUAL(29, writer.size());
+
+    ts::SharedPacketRing reader1;
+    ts::SharedPacketRing reader2;
+    TSUNIT_ASSERT(reader1.open(_name, false, NULLREP));
+    TSUNIT_ASSERT(reader2.open(_name, false, NULLREP));
+    TSUNIT_EQUAL(29, reader1.size());
+
+    writer.setBitrate(3000000);
+    TSUNIT_EQUAL(3000000, reader2.bitrate());
+
+    {
+        ReaderThread thread1(reader1);
+        ReaderThread thread2(reader2);
+        TSUNIT_ASSERT(thread1.start());
+        TSUNIT_ASSERT(thread2.start());
+
+        ts::TSPacketVector pkts(17);
+        ts::TSPacketMetadataVector mdata(pkts.size());
+        uint32_t seq = 0;
+        while (seq < COUNT) {
+            const size_t n = std::min<size_t>(pkts.size(), COUNT - seq);
+            for (size_t i = 0; i < n; ++i) {
+                mdata[i].reset();
+                if ((seq + i) % 3 == 0) {
+                    mdata[i].setLabel(3);
+                }
+                MakePacket(pkts[i], uint32_t(seq + i));
+            }
+            TSUNIT_ASSERT(writer.write(pkts.data(), mdata.data(), n, nullptr, NULLREP));
+            seq += uint32_t(n);
+        }
+        TSUNIT_ASSERT(writer.close(NULLREP));
+
+        TSUNIT_ASSERT(thread1.waitForTermination());
+        TSUNIT_ASSERT(thread2.waitForTermination());
+        TSUNIT_EQUAL(COUNT, thread1.count());
+        TSUNIT_EQUAL(COUNT, thread2.count());
+    }
+
+    TSUNIT_EQUAL(0, reader1.lostPackets());
+    TSUNIT_EQUAL(0, reader2.lostPackets());
+    TSUNIT_ASSERT(reader1.close(NULLREP));
+    TSUNIT_ASSERT(reader2.close(NULLREP));
+}
+
+void SharedPacketRingTest::testNonBlocking()
+{
+    ts::SharedPacketRing writer;
+    ts::SharedPacketRing reader;
+    TSUNIT_ASSERT(writer.create(_name, 10, true, NULLREP));
+    TSUNIT_ASSERT(reader.open(_name, false, NULLREP));
+
+    // Write 25 packets without reading: the writer never waits, the first 15 packets are lost.
+    ts::TSPacketVector pkts(25);
+    for (uint32_t i = 0; i < pkts.size(); ++i) {
+        MakePacket(pkts[i], i);
+    }
+    TSUNIT_ASSERT(writer.write(pkts.data(), nullptr, pkts.size(), nullptr, NULLREP));
+
+    ts::TSPacketVector out(20);
+    ts::TSPacketMetadataVector mdata(out.size());
+    TSUNIT_EQUAL(10, reader.read(out.data(), mdata.data(), out.size(), NULLREP));
+    TSUNIT_EQUAL(15, reader.lostPackets());
+    TSUNIT_EQUAL(15, ts::GetUInt32(out[0].b + 4));
+    TSUNIT_EQUAL(24, ts::GetUInt32(out[9].b + 4));
+    TSUNIT_ASSERT(!mdata[0].hasAnyLabel());
+
+    // End of stream after the last packets.
+    TSUNIT_ASSERT(writer.write(pkts.data(), nullptr, 3, nullptr, NULLREP));
+    TSUNIT_ASSERT(writer.close(NULLREP));
+    TSUNIT_EQUAL(3, reader.read(out.data(), nullptr, out.size(), NULLREP));
+    TSUNIT_EQUAL(2, ts::GetUInt32(out[2].b + 4));
+    TSUNIT_EQUAL(0, reader.read(out.data(), nullptr, out.size(), NULLREP));
+    TSUNIT_ASSERT(reader.close(NULLREP));
+}
+
+void SharedPacketRingTest::testErrors()
+{
+    ts::SharedPacketRing writer;
+    ts::SharedPacketRing other;
+    ts::SharedPacketRing reader;
+
+    // Not existing.
+    TSUNIT_ASSERT(!reader.open(_name, false, NULLREP));
+    TSUNIT_ASSERT(!reader.isOpen());
+
+    // Already used by a living writer.
+    TSUNIT_ASSERT(writer.create(_name, 100, false, NULLREP));
+    TSUNIT_ASSERT(!other.create(_name, 100, false, NULLREP));
+
+    // Only the owner can access the segment by default.
+    const int fd = ::shm_open((u"/" + _name).toUTF8().c_str(), O_RDONLY, 0);
+    TSUNIT_ASSERT(fd >= 0);
+    struct stat st;
+    TSUNIT_EQUAL(0, ::fstat(fd, &st));
+    TSUNIT_EQUAL(0600, st.st_mode & 0777);
+    ::close(fd);
+
+    // Wrong direction.
+    ts::TSPacket pkt(ts::NullPacket);
+    TSUNIT_ASSERT(reader.open(_name, false, NULLREP));
+    TSUNIT_ASSERT(!reader.write(&pkt, nullptr, 1, nullptr, NULLREP));
+    TSUNIT_EQUAL(0, writer.read(&pkt, nullptr, 1, NULLREP));
+
+    // The name is removed when the writer closes the ring.
+    TSUNIT_ASSERT(writer.close(NULLREP));
+    TSUNIT_ASSERT(reader.close(NULLREP));
+    TSUNIT_ASSERT(!reader.open(_name, false, NULLREP));
+}
+
+#else
+
+void SharedPacketRingTest::testTransfer()
+{
+    debug() << "SharedPacketRingTest: shared memory rings not implemented on this system" << std::endl;
+}
+
+void SharedPacketRingTest::testNonBlocking()
+{
+}
+
+void SharedPacketRingTest::testErrors()
+{
+}
+
+#endif
@@ -33,6 +33,7 @@
 
 #include "tsSysUtils.h"
 #include "tsSysInfo.h"
+#include "tsNullReport.h"
 #include "tsRegistry.h"
 #include "tsMonotonic.h"
 #include "tsTime.h"
@@ -63,6 +64,7 @@ public:
     void testEnvironment();
     void testRegistry();
     void testIgnoreBrokenPipes();
+    void testOpenFilesLimit();
     void testErrorCode();
     void testUid();
     void testVernacularFilePath();
@@ -77,6 +79,7 @@ public:
     void testProcessMetrics();
     void testIsTerminal();
     void testSysInfo();
+    void testCPUFeatures();
     void testSymLinks();
     void testCurrentWorkingDirectory();
     void testIsAbsoluteFilePath();
@@ -91,6 +94,7 @@ public:
     TSUNIT_TEST(testEnvironment);
     TSUNIT_TEST(testRegistry);
     TSUNIT_TEST(testIgnoreBrokenPipes);
+    TSUNIT_TEST(testOpenFilesLimit);
     TSUNIT_TEST(testErrorCode);
     TSUNIT_TEST(testUid);
     TSUNIT_TEST(testVernacularFilePath);
@@ -105,6 +109,7 @@ public:
     TSUNIT_TEST(testProcessMetrics);
     TSUNIT_TEST(testIsTerminal);
     TSUNIT_TEST(testSysInfo);
+    TSUNIT_TEST(testCPUFeatures);
     TSUNIT_TEST(testSymLinks);
     TSUNIT_TEST(testCurrentWorkingDirectory);
     TSUNIT_TEST(testIsAbsoluteFilePath);
@@ -383,6 +388,14 @@ void SysUtilsTest::testIgnoreBrokenPipes()
     }
 }
 
+void SysUtilsTest::testOpenFilesLimit()
+{
+    // Any system allows a few open files.
+    TSUNIT_ASSERT(ts::RaiseOpenFilesLimit(64, CERR));
+    TSUNIT_ASSERT(ts::RaiseOpenFilesLimit(0, CERR));
+    TSUNIT_ASSERT(ts::RaiseOpenFilesLimit(64, CERR));
+}
+
 void SysUtilsTest::testErrorCode()
 {
     // Hard to make automated tests since we do not expect portable strings
@@ -738,6 +751,30 @@ void SysUtilsTest::testSysInfo()
     TSUNIT_ASSERT(ts::SysInfo::Instance()->memoryPageSize() % 256 == 0);
 }
 
+void SysUtilsTest::testCPUFeatures()
+{
+    const ts::SysInfo* const sys = ts::SysInfo::Instance();
+    debug() << "SysUtilsTest::testCPUFeatures: " << std::endl
+            << "    detected: " << ts::SysInfo::CPUFeatureEnum.bitMaskNames(int(sys->cpuDetectedFeatures())) << std::endl
+            << "    usable: " << ts::SysInfo::CPUFeatureEnum.bitMaskNames(int(sys->cpuFeatures())) << std::endl;
+
+    // Usable features are a subset of detected features.
+    TSUNIT_EQUAL(0, sys->cpuFeatures() & ~sys->cpuDetectedFeatures());
+    TSUNIT_EQUAL(0, sys->cpuDetectedFeatures() & ~uint32_t(ts::SysInfo::CPU_ALL));
+    TSUNIT_ASSERT(sys->cpuHasFeatures(0));
+    TSUNIT_EQUAL(sys->cpuFeatures() == ts::SysInfo::CPU_ALL, sys->cpuHasFeatures(ts::SysInfo::CPU_ALL));
+
+    uint32_t features = 0;
+    TSUNIT_ASSERT(ts::SysInfo::DecodeCPUFeatures(features, u"avx2, AES", NULLREP));
+    TSUNIT_EQUAL(ts::SysInfo::CPU_AVX2 | ts::SysInfo::CPU_AES, features);
+    TSUNIT_ASSERT(ts::SysInfo::DecodeCPUFeatures(features, u"sse4.2,all", NULLREP));
+    TSUNIT_EQUAL(ts::SysInfo::CPU_ALL, features);
+    TSUNIT_ASSERT(ts::SysInfo::DecodeCPUFeatures(features, u"", NULLREP));
+    TSUNIT_EQUAL(ts::SysInfo::CPU_ALL, features);
+    TSUNIT_ASSERT(!ts::SysInfo::DecodeCPUFeatures(features, u"pclmul,foo", NULLREP));
+    TSUNIT_EQUAL(ts::SysInfo::CPU_PCLMUL, features);
+}
+
 void SysUtilsTest::testSymLinks()
 {
     debug() << "SysUtilsTest::testSymLinks: " << std::endl
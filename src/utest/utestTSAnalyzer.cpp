@@ -0,0 +1,334 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerOptions.h"
+#include "tsDuckContext.h"
+#include "tsTSPacket.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+#include "tables/psi_pat_r4_packets.h"
+#include "tables/psi_sdt_r3_packets.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSAnalyzerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testMerge();
+    void testPIDMerge();
+
+    TSUNIT_TEST_BEGIN(TSAnalyzerTest);
+    TSUNIT_TEST(testMerge);
+    TSUNIT_TEST(testPIDMerge);
+    TSUNIT_TEST_END();
+
+private:
+    // Build a test stream of 'count' cycles of PAT, SDT, data and null packets.
+    static void BuildStream(ts::TSPacketVector& packets, size_t count);
+};
+
+TSUNIT_REGISTER(TSAnalyzerTest);
+
+namespace {
+    // Give access to the protected analysis contexts.
+    class TestAnalyzer: public ts::TSAnalyzer
+    {
+    public:
+        typedef ts::TSAnalyzer::PIDContext PIDContext;
+        typedef ts::TSAnalyzer::ETIDContext ETIDContext;
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::beforeTest()
+{
+}
+
+void TSAnalyzerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build a test stream.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::BuildStream(ts::TSPacketVector& packets, size_t count)
+{
+    packets.clear();
+    uint8_t cc = 0;
+    for (size_t cycle = 0; cycle < count; ++cycle) {
+        ts::TSPacket pkt;
+        pkt.copyFrom(psi_pat_r4_packets);
+        pkt.setCC(cc);
+        packets.push_back(pkt);
+        pkt.copyFrom(psi_sdt_r3_packets);
+        pkt.setCC(cc);
+        packets.push_back(pkt);
+        for (size_t i = 0; i < 10; ++i) {
+            pkt = ts::NullPacket;
+            pkt.setPID(0x0100);
+            pkt.setCC(uint8_t(cycle * 10 + i));
+            packets.push_back(pkt);
+            packets.push_back(ts::NullPacket);
+        }
+        cc = (cc + 1) & ts::CC_MASK;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::testMerge()
+{
+    ts::DuckContext duck1;
+    ts::DuckContext duck2;
+    ts::DuckContext duck3;
+    ts::TSAnalyzerOptions opt;
+    opt.normalized = true;
+    opt.deterministic = true;
+
+    ts::TSPacketVector packets;
+    BuildStream(packets, 20);
+    const size_t half = packets.size() / 2;
+
+    // Analyze the complete stream in one analyzer.
+    ts::TSAnalyzerReport all(duck1);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        all.feedPacket(packets[i]);
+    }
+
+    // Analyze the two halves in two analyzers and merge them.
+    ts::TSAnalyzerReport part1(duck2);
+    ts::TSAnalyzerReport part2(duck3);
+    for (size_t i = 0; i < half; ++i) {
+        part1.feedPacket(packets[i]);
+    }
+    for (size_t i = half; i < packets.size(); ++i) {
+        part2.feedPacket(packets[i]);
+    }
+    part1.merge(part2);
+
+    std::vector<ts::PID> pids;
+    part1.getPIDs(pids);
+    TSUNIT_EQUAL(4, pids.size());
+
+    std::vector<uint16_t> services;
+    part1.getServiceIds(services);
+    TSUNIT_ASSERT(!services.empty());
+
+    const ts::UString ref(all.reportToString(opt));
+    const ts::UString merged(part1.reportToString(opt));
+    debug() << "TSAnalyzerTest::testMerge: reference: " << std::endl << ref << std::endl
+            << "TSAnalyzerTest::testMerge: merged: " << std::endl << merged << std::endl;
+    TSUNIT_EQUAL(ref, merged);
+}
+
+void TSAnalyzerTest::testPIDMerge()
+{
+    TestAnalyzer::PIDContext pc1(0x0100);
+    TestAnalyzer::PIDContext pc2(0x0100, u"MPEG-2 Video");
+    const ts::ETID etid(ts::TID_ECM_80);
+
+    // First part: a few packets, no description.
+    pc1.attributes.push_back(u"attr1");
+    pc1.services.insert(1);
+    pc1.is_pmt_pid = true;
+    pc1.optional = true;
+    pc1.carry_pes = true;
+    pc1.same_stream_id = true;
+    pc1.pes_stream_id = 0xE0;
+    pc1.cas_operators.insert(10);
+    pc1.ssu_oui.insert(100);
+    pc1.t2mi_plp_ts[1] = 5;
+    pc1.ts_pkt_cnt = 10;
+    pc1.cryptop_cnt = 1;
+    pc1.cryptop_ts_cnt = 0;
+    pc1.crypto_period = 0;
+    pc1.ts_pcr_bitrate = 1000;
+    pc1.bitrate = 2000;
+    pc1.cur_continuity = 3;
+    pc1.cur_ts_sc = 2;
+    pc1.cur_ts_sc_pkt = 4;
+    pc1.last_pcr = 1234;
+    pc1.last_pcr_pkt = 5;
+
+    // Second part: every field is set.
+    pc2.comment = u"comment";
+    pc2.attributes.push_back(u"attr1");
+    pc2.attributes.push_back(u"attr2");
+    pc2.services.insert(2);
+    pc2.is_pcr_pid = true;
+    pc2.referenced = true;
+    pc2.optional = false;
+    pc2.carry_section = true;
+    pc2.carry_ecm = true;
+    pc2.carry_emm = true;
+    pc2.carry_audio = true;
+    pc2.carry_video = true;
+    pc2.carry_t2mi = true;
+    pc2.scrambled = true;
+    pc2.same_stream_id = true;
+    pc2.pes_stream_id = 0xE0;
+    pc2.ts_pkt_cnt = 1;
+    pc2.ts_af_cnt = 2;
+    pc2.unit_start_cnt = 3;
+    pc2.pl_start_cnt = 4;
+    pc2.pmt_cnt = 5;
+    pc2.unexp_discont = 6;
+    pc2.exp_discont = 7;
+    pc2.duplicated = 8;
+    pc2.ts_sc_cnt = 9;
+    pc2.inv_ts_sc_cnt = 10;
+    pc2.inv_pes_start = 11;
+    pc2.t2mi_cnt = 12;
+    pc2.pcr_cnt = 13;
+    pc2.ts_pcr_bitrate = 3000;
+    pc2.bitrate = 4000;
+    pc2.language = u"fre";
+    pc2.cas_id = 0x0500;
+    pc2.cas_operators.insert(20);
+    pc2.ssu_oui.insert(200);
+    pc2.t2mi_plp_ts[1] = 6;
+    pc2.t2mi_plp_ts[2] = 7;
+    pc2.cur_continuity = 14;
+    pc2.cur_ts_sc = 3;
+    pc2.cur_ts_sc_pkt = 15;
+    pc2.cryptop_cnt = 3;
+    pc2.cryptop_ts_cnt = 400;
+    pc2.crypto_period = 200;
+    pc2.last_pcr = 5678;
+    pc2.last_pcr_pkt = 16;
+    pc2.ts_bitrate_sum = 17;
+    pc2.ts_bitrate_cnt = 18;
+    pc2.sections[etid] = new TestAnalyzer::ETIDContext(etid);
+    pc2.sections[etid]->section_count = 19;
+
+    pc1.merge(pc2, 1000);
+
+    // Descriptive properties.
+    TSUNIT_EQUAL(0x0100, pc1.pid);
+    TSUNIT_EQUAL(u"MPEG-2 Video", pc1.description);
+    TSUNIT_EQUAL(u"comment", pc1.comment);
+    TSUNIT_EQUAL(2, pc1.attributes.size());
+    TSUNIT_EQUAL(u"attr1", pc1.attributes[0]);
+    TSUNIT_EQUAL(u"attr2", pc1.attributes[1]);
+    TSUNIT_EQUAL(u"fre", pc1.language);
+    TSUNIT_EQUAL(0x0500, pc1.cas_id);
+
+    // Sets and boolean properties.
+    TSUNIT_EQUAL(2, pc1.services.size());
+    TSUNIT_EQUAL(2, pc1.cas_operators.size());
+    TSUNIT_EQUAL(2, pc1.ssu_oui.size());
+    TSUNIT_ASSERT(pc1.is_pmt_pid);
+    TSUNIT_ASSERT(pc1.is_pcr_pid);
+    TSUNIT_ASSERT(pc1.referenced);
+    TSUNIT_ASSERT(!pc1.optional);
+    TSUNIT_ASSERT(pc1.carry_pes);
+    TSUNIT_ASSERT(pc1.carry_section);
+    TSUNIT_ASSERT(pc1.carry_ecm);
+    TSUNIT_ASSERT(pc1.carry_emm);
+    TSUNIT_ASSERT(pc1.carry_audio);
+    TSUNIT_ASSERT(pc1.carry_video);
+    TSUNIT_ASSERT(pc1.carry_t2mi);
+    TSUNIT_ASSERT(pc1.scrambled);
+    TSUNIT_ASSERT(pc1.same_stream_id);
+    TSUNIT_EQUAL(0xE0, pc1.pes_stream_id);
+
+    // Counters.
+    TSUNIT_EQUAL(11, pc1.ts_pkt_cnt);
+    TSUNIT_EQUAL(2, pc1.ts_af_cnt);
+    TSUNIT_EQUAL(3, pc1.unit_start_cnt);
+    TSUNIT_EQUAL(4, pc1.pl_start_cnt);
+    TSUNIT_EQUAL(5, pc1.pmt_cnt);
+    TSUNIT_EQUAL(6, pc1.unexp_discont);
+    TSUNIT_EQUAL(7, pc1.exp_discont);
+    TSUNIT_EQUAL(8, pc1.duplicated);
+    TSUNIT_EQUAL(9, pc1.ts_sc_cnt);
+    TSUNIT_EQUAL(10, pc1.inv_ts_sc_cnt);
+    TSUNIT_EQUAL(11, pc1.inv_pes_start);
+    TSUNIT_EQUAL(12, pc1.t2mi_cnt);
+    TSUNIT_EQUAL(13, pc1.pcr_cnt);
+    TSUNIT_EQUAL(4, pc1.cryptop_cnt);
+    TSUNIT_EQUAL(400, pc1.cryptop_ts_cnt);
+    TSUNIT_EQUAL(133, pc1.crypto_period);
+    TSUNIT_EQUAL(17, pc1.ts_bitrate_sum);
+    TSUNIT_EQUAL(18, pc1.ts_bitrate_cnt);
+    TSUNIT_EQUAL(2, pc1.t2mi_plp_ts.size());
+    TSUNIT_EQUAL(11, pc1.t2mi_plp_ts[1]);
+    TSUNIT_EQUAL(7, pc1.t2mi_plp_ts[2]);
+    TSUNIT_EQUAL(1, pc1.sections.size());
+    TSUNIT_EQUAL(19, pc1.sections[etid]->section_count);
+
+    // Bitrates are recomputed by the analyzer.
+    TSUNIT_EQUAL(1000, pc1.ts_pcr_bitrate);
+    TSUNIT_EQUAL(2000, pc1.bitrate);
+
+    // Analysis state from the latest part.
+    TSUNIT_EQUAL(14, pc1.cur_continuity);
+    TSUNIT_EQUAL(3, pc1.cur_ts_sc);
+    TSUNIT_EQUAL(1015, pc1.cur_ts_sc_pkt);
+    TSUNIT_EQUAL(5678, pc1.last_pcr);
+    TSUNIT_EQUAL(1016, pc1.last_pcr_pkt);
+
+    // Crypto-period only known in the other part, PES stream id different in the two parts.
+    TestAnalyzer::PIDContext pc3(0x0200);
+    TestAnalyzer::PIDContext pc4(0x0200);
+    pc3.optional = true;
+    pc3.pes_stream_id = 0xC0;
+    pc3.same_stream_id = true;
+    pc4.optional = true;
+    pc4.pes_stream_id = 0xC1;
+    pc4.same_stream_id = true;
+    pc4.crypto_period = 50;
+    pc3.merge(pc4, 0);
+    TSUNIT_ASSERT(pc3.optional);
+    TSUNIT_EQUAL(0xC0, pc3.pes_stream_id);
+    TSUNIT_ASSERT(!pc3.same_stream_id);
+    TSUNIT_EQUAL(50, pc3.crypto_period);
+    TSUNIT_EQUAL(u"Unreferenced", pc3.description);
+}
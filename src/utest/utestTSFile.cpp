@@ -34,6 +34,7 @@
 #include "tsTSFile.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
+#include "tsByteBlock.h"
 #include "tsCerrReport.h"
 #include "tsSysUtils.h"
 #include "tsunit.h"
@@ -57,6 +58,8 @@ public:
     void testDuck();
     void testStuffingRead();
     void testStuffingWrite();
+    void testMemoryMapped();
+    void testDirectIO();
 
     TSUNIT_TEST_BEGIN(TSFileTest);
     TSUNIT_TEST(testTS);
@@ -64,6 +67,8 @@ public:
     TSUNIT_TEST(testDuck);
     TSUNIT_TEST(testStuffingRead);
     TSUNIT_TEST(testStuffingWrite);
+    TSUNIT_TEST(testMemoryMapped);
+    TSUNIT_TEST(testDirectIO);
     TSUNIT_TEST_END();
 
 private:
@@ -395,3 +400,120 @@ void TSFileTest::testStuffingWrite()
     TSUNIT_EQUAL(184, packets[5].getPayloadSize());
     TSUNIT_EQUAL(0xFF, packets[5].getPayload()[0]);
 }
+
+void TSFileTest::testMemoryMapped()
+{
+    ts::TSFile file;
+    ts::TSPacketVector packets(10);
+
+    // Create a file with 10 packets.
+    TSUNIT_ASSERT(!ts::FileExists(_tempFileName));
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i] = ts::NullPacket;
+        packets[i].setPID(ts::PID(100 + i));
+    }
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(1880, ts::GetFileSize(_tempFileName));
+
+    // Read it twice, from the third packet, with artificial stuffing.
+    ts::TSFile file2;
+    const ts::TSPacket* pkt = nullptr;
+    ts::TSPacketMetadata mdata[4];
+    file2.setMemoryMapped(true);
+    file2.setStuffing(1, 1);
+    TSUNIT_ASSERT(file2.openRead(_tempFileName, 2, 2 * ts::PKT_SIZE, CERR));
+#if defined(TS_UNIX)
+    TSUNIT_ASSERT(file2.isMemoryMapped());
+    TSUNIT_EQUAL(ts::TSPacketFormat::TS, file2.packetFormat());
+#endif
+
+    // Initial stuffing is copied, with the first packets of the file.
+    TSUNIT_EQUAL(4, file2.readPacketsInPlace(pkt, mdata, 4, CERR));
+    TSUNIT_ASSERT(pkt != nullptr);
+    TSUNIT_EQUAL(ts::PID_NULL, pkt[0].getPID());
+    TSUNIT_ASSERT(mdata[0].getInputStuffing());
+    TSUNIT_EQUAL(102, pkt[1].getPID());
+    TSUNIT_EQUAL(104, pkt[3].getPID());
+    TSUNIT_ASSERT(!mdata[3].getInputStuffing());
+
+    // File content.
+    ts::PID pid = 105;
+    for (size_t count = 3; count < 16; ) {
+        const size_t n = file2.readPacketsInPlace(pkt, mdata, 4, CERR);
+        TSUNIT_ASSERT(n > 0);
+        TSUNIT_ASSERT(n <= 4);
+        for (size_t i = 0; i < n; ++i) {
+            TSUNIT_EQUAL(pid, pkt[i].getPID());
+            TSUNIT_ASSERT(!mdata[i].getInputStuffing());
+            pid = pid == 109 ? 102 : pid + 1;
+        }
+        count += n;
+        TSUNIT_ASSERT(count <= 16);
+    }
+
+    // Final stuffing, then end of file.
+    TSUNIT_EQUAL(1, file2.readPacketsInPlace(pkt, mdata, 4, CERR));
+    TSUNIT_EQUAL(ts::PID_NULL, pkt[0].getPID());
+    TSUNIT_ASSERT(mdata[0].getInputStuffing());
+    TSUNIT_EQUAL(0, file2.readPacketsInPlace(pkt, mdata, 4, CERR));
+    TSUNIT_EQUAL(18, file2.readPacketsCount());
+
+    // Rewindable mode, mixed with copying reads.
+    TSUNIT_ASSERT(file2.close(CERR));
+    TSUNIT_ASSERT(!file2.isMemoryMapped());
+    file2.setStuffing(0, 0);
+    TSUNIT_ASSERT(file2.openRead(_tempFileName, 0, CERR));
+    TSUNIT_EQUAL(3, file2.readPackets(packets.data(), nullptr, 3, CERR));
+    TSUNIT_EQUAL(102, packets[2].getPID());
+    TSUNIT_EQUAL(2, file2.readPacketsInPlace(pkt, nullptr, 2, CERR));
+    TSUNIT_EQUAL(103, pkt[0].getPID());
+    TSUNIT_EQUAL(104, pkt[1].getPID());
+    TSUNIT_ASSERT(file2.seek(8, CERR));
+    TSUNIT_EQUAL(2, file2.readPacketsInPlace(pkt, nullptr, 4, CERR));
+    TSUNIT_EQUAL(108, pkt[0].getPID());
+    TSUNIT_EQUAL(109, pkt[1].getPID());
+    TSUNIT_EQUAL(0, file2.readPacketsInPlace(pkt, nullptr, 4, CERR));
+    TSUNIT_ASSERT(file2.close(CERR));
+}
+
+void TSFileTest::testDirectIO()
+{
+    // Buffer of 1024 packets, aligned for direct I/O.
+    const size_t count = 1024;
+    ts::ByteBlock mem(count * ts::PKT_SIZE + ts::TSFile::DIRECT_IO_ALIGNMENT);
+    uint8_t* base = mem.data();
+    base += (ts::TSFile::DIRECT_IO_ALIGNMENT - reinterpret_cast<size_t>(base) % ts::TSFile::DIRECT_IO_ALIGNMENT) % ts::TSFile::DIRECT_IO_ALIGNMENT;
+    ts::TSPacket* packets = reinterpret_cast<ts::TSPacket*>(base);
+    for (size_t i = 0; i < count; ++i) {
+        packets[i].init(ts::PID(i), 0, uint8_t(i));
+    }
+
+    // Aligned writes may use direct I/O, depending on the file system. Unaligned writes never do.
+    ts::TSFile file;
+    TSUNIT_ASSERT(!ts::FileExists(_tempFileName));
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::DIRECT, CERR));
+    debug() << "TSFileTest::testDirectIO: direct I/O: " << ts::UString::YesNo(file.isDirectIO()) << std::endl;
+    TSUNIT_ASSERT(file.writePackets(packets, nullptr, count, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets, nullptr, count, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets, nullptr, 3, CERR));
+    TSUNIT_ASSERT(!file.isDirectIO());
+    TSUNIT_ASSERT(file.writePackets(packets, nullptr, count, CERR));
+    TSUNIT_ASSERT(!file.isDirectIO());
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL((3 * count + 3) * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+
+    // Check content.
+    ts::TSPacketVector inpackets(3 * count + 3);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 1, 0, CERR));
+    TSUNIT_EQUAL(inpackets.size(), file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(0, inpackets[0].getPID());
+    TSUNIT_EQUAL(1023, inpackets[count - 1].getPID());
+    TSUNIT_EQUAL(0, inpackets[count].getPID());
+    TSUNIT_EQUAL(2, inpackets[2 * count + 2].getPID());
+    TSUNIT_EQUAL(0, inpackets[2 * count + 3].getPID());
+    TSUNIT_EQUAL(1023, inpackets[3 * count + 2].getPID());
+    TSUNIT_EQUAL(0xFF, inpackets[3 * count + 2].b[4]);
+}
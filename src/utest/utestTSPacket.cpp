@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
 #include "tsByteBlock.h"
 #include "tsMemory.h"
 #include "tsunit.h"
@@ -55,6 +56,7 @@ public:
     void testSetPayloadSize();
     void testFlags();
     void testPrivateData();
+    void testInputTimeStamp();
 
     TSUNIT_TEST_BEGIN(TSPacketTest);
     TSUNIT_TEST(testPacket);
@@ -64,6 +66,7 @@ public:
     TSUNIT_TEST(testSetPayloadSize);
     TSUNIT_TEST(testFlags);
     TSUNIT_TEST(testPrivateData);
+    TSUNIT_TEST(testInputTimeStamp);
     TSUNIT_TEST_END();
 };
 
@@ -495,3 +498,31 @@ void TSPacketTest::testPrivateData()
     pkt.getPrivateData(data);
     TSUNIT_ASSERT(data.empty());
 }
+
+void TSPacketTest::testInputTimeStamp()
+{
+    ts::TSPacketMetadata mdata;
+    TSUNIT_ASSERT(!mdata.hasInputTimeStamp());
+
+    // RTP-like time stamp, 90 kHz.
+    mdata.setInputTimeStamp(90000, 90000, ts::TimeSource::RTP);
+    TSUNIT_ASSERT(mdata.hasInputTimeStamp());
+    TSUNIT_EQUAL(ts::TimeSource::RTP, mdata.getInputTimeSource());
+    TSUNIT_EQUAL(ts::SYSTEM_CLOCK_FREQ, mdata.getInputTimeStamp());
+
+    // Kernel time stamps are system time since the Epoch, in micro or nano-seconds.
+    // The conversion must not overflow and must keep the sub-second accuracy.
+    const uint64_t seconds = 1600000000;
+    const uint64_t pcr = (seconds * ts::SYSTEM_CLOCK_FREQ + 27) % ts::PCR_SCALE;
+
+    mdata.setInputTimeStamp(seconds * ts::MicroSecPerSec + 1, ts::MicroSecPerSec, ts::TimeSource::KERNEL);
+    TSUNIT_EQUAL(ts::TimeSource::KERNEL, mdata.getInputTimeSource());
+    TSUNIT_EQUAL(pcr, mdata.getInputTimeStamp());
+
+    mdata.setInputTimeStamp(seconds * ts::NanoSecPerSec + 1000, ts::NanoSecPerSec, ts::TimeSource::HARDWARE);
+    TSUNIT_EQUAL(ts::TimeSource::HARDWARE, mdata.getInputTimeSource());
+    TSUNIT_EQUAL(pcr, mdata.getInputTimeStamp());
+
+    mdata.clearInputTimeStamp();
+    TSUNIT_ASSERT(!mdata.hasInputTimeStamp());
+}
@@ -0,0 +1,232 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSPacketQueue
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketQueue.h"
+#include "tsSysUtils.h"
+#include "utestTSUnitThread.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSPacketQueueTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testTransfer();
+    void testNonBlocking();
+    void testStop();
+
+    TSUNIT_TEST_BEGIN(TSPacketQueueTest);
+    TSUNIT_TEST(testTransfer);
+    TSUNIT_TEST(testNonBlocking);
+    TSUNIT_TEST(testStop);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(TSPacketQueueTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSPacketQueueTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void TSPacketQueueTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+namespace {
+    // Build a packet with a 32-bit sequence number in the payload.
+    void MakePacket(ts::TSPacket& pkt, uint32_t seq)
+    {
+        pkt = ts::NullPacket;
+        ts::PutUInt32(pkt.b + 4, seq);
+    }
+
+    // A writer thread which sends packets with increasing sequence numbers.
+    class WriterThread: public utest::TSUnitThread
+    {
+        TS_NOCOPY(WriterThread);
+    public:
+        WriterThread(ts::TSPacketQueue& queue, uint32_t count) : utest::TSUnitThread(), _queue(queue), _count(count) {}
+        virtual ~WriterThread() override { waitForTermination(); }
+        virtual void test() override
+        {
+            _queue.setBitrate(1000000);
+            uint32_t seq = 0;
+            ts::TSPacketVector pkts(7);
+            while (seq < _count) {
+                if (seq % 2 == 0) {
+                    // Copy a range of packets.
+                    size_t n = 0;
+                    for (; n < pkts.size() && seq + n < _count; ++n) {
+                        MakePacket(pkts[n], uint32_t(seq + n));
+                    }
+                    if (!_queue.putPackets(pkts.data(), n)) {
+                        TSUNIT_ASSERT(_queue.stopped());
+                        return;
+                    }
+                    seq += uint32_t(n);
+                }
+                else {
+                    // Write directly in the buffer.
+                    ts::TSPacket* buffer = nullptr;
+                    size_t size = 0;
+                    if (!_queue.lockWriteBuffer(buffer, size, 5)) {
+                        TSUNIT_ASSERT(_queue.stopped());
+                        return;
+                    }
+                    TSUNIT_ASSERT(buffer != nullptr);
+                    TSUNIT_ASSERT(size > 0);
+                    size = std::min<size_t>(size, _count - seq);
+                    for (size_t i = 0; i < size; ++i) {
+                        MakePacket(buffer[i], seq++);
+                    }
+                    _queue.releaseWriteBuffer(size);
+                }
+            }
+            _queue.setEOF();
+        }
+    private:
+        ts::TSPacketQueue& _queue;
+        uint32_t _count;
+    };
+}
+
+void TSPacketQueueTest::testTransfer()
+{
+    // Small queue with many packets to exercise wrap-around and sleeping on both sides.
+    constexpr uint32_t COUNT = 100000;
+    ts::TSPacketQueue queue(23);
+    WriterThread writer(queue, COUNT);
+    TSUNIT_ASSERT(writer.start());
+
+    ts::TSPacketVector buffer(11);
+    uint32_t seq = 0;
+    size_t count = 0;
+    ts::BitRate bitrate = 0;
+    while (queue.waitPackets(buffer.data(), buffer.size(), count, bitrate)) {
+        TSUNIT_ASSERT(count > 0);
+        TSUNIT_ASSERT(count <= buffer.size());
+        TSUNIT_EQUAL(1000000, bitrate);
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_EQUAL(seq, ts::GetUInt32(buffer[i].b + 4));
+            seq++;
+        }
+    }
+    TSUNIT_EQUAL(COUNT, seq);
+    TSUNIT_ASSERT(queue.eof());
+    TSUNIT_EQUAL(0, queue.currentSize());
+}
+
+void TSPacketQueueTest::testNonBlocking()
+{
+    ts::TSPacketQueue queue(10);
+    TSUNIT_EQUAL(10, queue.bufferSize());
+
+    ts::TSPacket pkt;
+    ts::BitRate bitrate = 0;
+    TSUNIT_ASSERT(!queue.getPacket(pkt, bitrate));
+    TSUNIT_ASSERT(!queue.eof());
+
+    // Fill the queue completely.
+    ts::TSPacketVector pkts(10);
+    for (uint32_t i = 0; i < pkts.size(); ++i) {
+        MakePacket(pkts[i], i);
+    }
+    queue.setBitrate(2000000);
+    TSUNIT_ASSERT(queue.putPackets(pkts.data(), pkts.size()));
+    TSUNIT_EQUAL(10, queue.currentSize());
+
+    // Get some, put again to wrap around the end of the buffer.
+    TSUNIT_ASSERT(queue.getPacket(pkt, bitrate));
+    TSUNIT_EQUAL(2000000, bitrate);
+    TSUNIT_EQUAL(0, ts::GetUInt32(pkt.b + 4));
+
+    ts::TSPacketVector out(6);
+    size_t count = 0;
+    TSUNIT_ASSERT(queue.getPackets(out.data(), out.size(), count, bitrate));
+    TSUNIT_EQUAL(6, count);
+    TSUNIT_EQUAL(6, ts::GetUInt32(out[5].b + 4));
+    TSUNIT_EQUAL(3, queue.currentSize());
+
+    TSUNIT_ASSERT(queue.putPackets(pkts.data(), 7));
+    TSUNIT_EQUAL(10, queue.currentSize());
+    queue.setEOF();
+    TSUNIT_ASSERT(!queue.eof());
+
+    out.resize(20);
+    TSUNIT_ASSERT(queue.getPackets(out.data(), out.size(), count, bitrate));
+    TSUNIT_EQUAL(10, count);
+    TSUNIT_EQUAL(7, ts::GetUInt32(out[0].b + 4));
+    TSUNIT_EQUAL(9, ts::GetUInt32(out[2].b + 4));
+    TSUNIT_EQUAL(0, ts::GetUInt32(out[3].b + 4));
+    TSUNIT_EQUAL(6, ts::GetUInt32(out[9].b + 4));
+    TSUNIT_ASSERT(queue.eof());
+    TSUNIT_ASSERT(!queue.waitPackets(out.data(), out.size(), count, bitrate));
+    TSUNIT_EQUAL(0, count);
+}
+
+void TSPacketQueueTest::testStop()
+{
+    // The writer thread is blocked on a full queue, until the reader stops the queue.
+    ts::TSPacketQueue queue(10);
+    WriterThread writer(queue, 1000);
+    TSUNIT_ASSERT(writer.start());
+
+    ts::TSPacket pkt;
+    ts::BitRate bitrate = 0;
+    while (queue.currentSize() < queue.bufferSize()) {
+        ts::SleepThread(5);
+    }
+    TSUNIT_ASSERT(!queue.stopped());
+    TSUNIT_ASSERT(queue.getPacket(pkt, bitrate));
+    queue.stop();
+    TSUNIT_ASSERT(queue.stopped());
+}
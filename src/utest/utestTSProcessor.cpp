@@ -49,9 +49,11 @@ public:
     virtual void afterTest() override;
 
     void testProcessing();
+    void testLockFree();
 
     TSUNIT_TEST_BEGIN(TSProcessorTest);
     TSUNIT_TEST(testProcessing);
+    TSUNIT_TEST(testLockFree);
     TSUNIT_TEST_END();
 };
 
@@ -325,3 +327,44 @@ void TSProcessorTest::testProcessing()
     TSUNIT_EQUAL(3,          handler2.logs[0].count);
     TSUNIT_EQUAL(26,         handler2.logs[0].packets);
 }
+
+void TSProcessorTest::testLockFree()
+{
+    ts::PluginRepository::Instance()->registerProcessor(TS_LIBRARY_VERSION, u"test1", TestPlugin::CreateInstance);
+
+    // Long enough chain and stream to make all threads concurrently pass packets.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testLockFree";
+    opt.lock_free = true;
+    opt.ts_buffer_size = 1000 * ts::PKT_SIZE;
+    opt.input = {u"null", {u"100000"}};
+    opt.plugins = {
+        {u"test1", {u"--count", u"25000"}},
+        {u"test1", {u"--count", u"25000"}},
+        {u"test1", {u"--count", u"25000"}},
+        {u"test1", {u"--count", u"25000"}},
+    };
+    opt.output = {u"drop"};
+
+    ts::TSProcessor tsproc(CERR);
+    TestEventHandler handler;
+    ts::TSProcessor::Criteria crit;
+    crit.event_code = TestPlugin::EVENT_STOP;
+    tsproc.registerEventHandler(&handler, crit);
+
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    // All plugins have seen all packets, in any order of termination.
+    TSUNIT_EQUAL(4, handler.logs.size());
+    std::set<size_t> indexes;
+    for (const auto& log : handler.logs) {
+        TSUNIT_EQUAL(0xBEEF0002, log.code);
+        TSUNIT_EQUAL(6, log.count);
+        TSUNIT_EQUAL(100000, log.packets);
+        indexes.insert(log.index);
+    }
+    TSUNIT_EQUAL(4, indexes.size());
+    TSUNIT_EQUAL(1, *indexes.begin());
+    TSUNIT_EQUAL(4, *indexes.rbegin());
+}
@@ -42,12 +42,23 @@
 #include "tsEIT.h"
 #include "tsAIT.h"
 #include "tsCADescriptor.h"
+#include "tsShortEventDescriptor.h"
+#include "tsContentDescriptor.h"
+#include "tsExtendedEventDescriptor.h"
 #include "tsAVCVideoDescriptor.h"
 #include "tsDVBAC3Descriptor.h"
 #include "tsEacemPreferredNameIdentifierDescriptor.h"
 #include "tsEacemLogicalChannelNumberDescriptor.h"
 #include "tsEutelsatChannelNumberDescriptor.h"
 #include "tsDuckContext.h"
+#include "tsBinaryTable.h"
+#include "tsSectionFile.h"
+#include "tsxmlDocument.h"
+#include "tsxmlElement.h"
+#include "tsxmlTextSerializer.h"
+#include "tsxmlJSONSerializer.h"
+#include "tsTextFormatter.h"
+#include "tsCerrReport.h"
 #include "tsTSPacket.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
@@ -69,6 +80,7 @@ public:
     void testBAT();
     void testCAT();
     void testEIT();
+    void testEITSerializer();
     void testNIT();
     void testSDT();
     void testTOT();
@@ -82,12 +94,16 @@ public:
     TSUNIT_TEST(testBAT);
     TSUNIT_TEST(testCAT);
     TSUNIT_TEST(testEIT);
+    TSUNIT_TEST(testEITSerializer);
     TSUNIT_TEST(testNIT);
     TSUNIT_TEST(testSDT);
     TSUNIT_TEST(testTOT);
     TSUNIT_TEST(testTSDT);
     TSUNIT_TEST(testCleanupPrivateDescriptors);
     TSUNIT_TEST_END();
+
+private:
+    ts::Report& report();
 };
 
 TSUNIT_REGISTER(TableTest);
@@ -106,6 +122,16 @@ void TableTest::afterTest()
 {
 }
 
+ts::Report& TableTest::report()
+{
+    if (tsunit::Test::debugMode()) {
+        return CERR;
+    }
+    else {
+        return NULLREP;
+    }
+}
+
 //----------------------------------------------------------------------------
 // Unitary tests.
 //----------------------------------------------------------------------------
@@ -275,6 +301,83 @@ void TableTest::testEIT()
     TSUNIT_ASSERT(eit3.events.begin()->second.descs.table() == &eit3);
 }
 
+void TableTest::testEITSerializer()
+{
+    ts::DuckContext duck;
+    ts::EIT eit(true, false, 0, 3, true, 0x1234, 0x0056, 0x0078);
+    ts::EIT::Event& ev1(eit.events[1]);
+    ev1.event_id = 0x0101;
+    ev1.start_time = ts::Time(2021, 3, 4, 5, 6, 7);
+    ev1.duration = 3600;
+    ev1.running_status = 4;
+    ev1.descs.add(duck, ts::ShortEventDescriptor(u"fre", u"Name & title", u"<Some> \"text\""));
+    ts::ContentDescriptor content;
+    content.entries.push_back(ts::ContentDescriptor::Entry(0x1234));
+    content.entries.push_back(ts::ContentDescriptor::Entry(0x5678));
+    ev1.descs.add(duck, content);
+    ts::ExtendedEventDescriptor ext;
+    ext.language_code = u"eng";
+    ext.text = u"Extended";
+    ext.entries.push_back(ts::ExtendedEventDescriptor::Entry(u"Director", u"Someone"));
+    ext.entries.push_back(ts::ExtendedEventDescriptor::Entry(u"Year", u""));
+    ev1.descs.add(duck, ext);
+    ts::EIT::Event& ev2(eit.events[2]);
+    ev2.event_id = 0x0102;
+    ev2.start_time = ts::Time(2021, 3, 4, 6, 6, 7);
+    ev2.duration = 1800;
+    ev2.CA_controlled = true;
+    ts::CADescriptor ca(0x0500, 0x0123);
+    ca.private_data = ts::ByteBlock(20, 0xAB);
+    ev2.descs.add(duck, ca);
+    static const uint8_t generic[] = {0xFE, 0x03, 0x01, 0x02, 0x03};
+    ev2.descs.add(generic, sizeof(generic));
+
+    ts::BinaryTable table;
+    eit.serialize(duck, table);
+    TSUNIT_ASSERT(table.isValid());
+    table.setSourcePID(ts::PID_EIT);
+    ts::BinaryTable::XMLOptions opt;
+    opt.setPID = true;
+
+    // Reference XML document, built as a tree.
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(table.toXML(duck, doc.initialize(u"tsduck"), opt) != nullptr);
+
+    // The serialized XML text must be identical to the print of the tree.
+    for (int one_liner = 0; one_liner < 2; ++one_liner) {
+        ts::TextFormatter ref(report());
+        ts::TextFormatter text(report());
+        ref.setString();
+        text.setString();
+        if (one_liner != 0) {
+            ref.setEndOfLineMode(ts::TextFormatter::EndOfLineMode::SPACING);
+            text.setEndOfLineMode(ts::TextFormatter::EndOfLineMode::SPACING);
+        }
+        doc.rootElement()->print(ref, false);
+        {
+            ts::xml::TextSerializer output(text, ts::xml::Tweaks(), 1);
+            output.startElement(u"tsduck");
+            TSUNIT_ASSERT(table.toXML(duck, output, opt));
+        }
+        debug() << "TableTest::testEITSerializer: " << text.toString() << std::endl;
+        TSUNIT_EQUAL(ref.toString(), text.toString());
+    }
+
+    // The serialized JSON text must be identical to the print of the converted JSON tree.
+    ts::xml::JSONConverter conv(report());
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(conv));
+    const ts::json::ValuePtr jroot(conv.convertToJSON(doc, true));
+    ts::TextFormatter text(report());
+    text.setIndentSize(2);
+    text.setString();
+    {
+        ts::xml::JSONSerializer output(text, conv, u"tsduck");
+        TSUNIT_ASSERT(table.toXML(duck, output, opt));
+    }
+    debug() << "TableTest::testEITSerializer: " << text.toString() << std::endl;
+    TSUNIT_EQUAL(jroot->query(u"#nodes[0]").printed(), text.toString());
+}
+
 void TableTest::testNIT()
 {
     ts::DuckContext duck;
@@ -34,6 +34,8 @@
 #include "tsECMGSCS.h"
 #include "tsEMMGMUX.h"
 #include "tstlvMessageFactory.h"
+#include "tstlvConnection.h"
+#include "tsTCPServer.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
 
@@ -52,12 +54,14 @@ public:
     void testEMMG();
     void testECMGError();
     void testEMMGError();
+    void testReceiveAvailable();
 
     TSUNIT_TEST_BEGIN(TagLengthValueTest);
     TSUNIT_TEST(testECMG);
     TSUNIT_TEST(testEMMG);
     TSUNIT_TEST(testECMGError);
     TSUNIT_TEST(testEMMGError);
+    TSUNIT_TEST(testReceiveAvailable);
     TSUNIT_TEST_END();
 };
 
@@ -347,3 +351,74 @@ void TagLengthValueTest::testEMMGError()
     debug() << "TagLengthValueTest::testEMMGError: dump" << std::endl << str << std::endl;
     TSUNIT_EQUAL(refString, str);
 }
+
+void TagLengthValueTest::testReceiveAvailable()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    // Three ECMG <=> SCS messages, serialized in one single buffer.
+    ts::ecmgscs::ChannelTest msg1;
+    msg1.channel_id = 1;
+    ts::ecmgscs::StreamTest msg2;
+    msg2.channel_id = 2;
+    msg2.stream_id = 3;
+    ts::ecmgscs::ChannelTest msg3;
+    msg3.channel_id = 4;
+
+    ts::ByteBlockPtr data(new ts::ByteBlock);
+    ts::tlv::Serializer zer(data);
+    msg1.serialize(zer);
+    msg2.serialize(zer);
+    const size_t size3 = data->size();
+    msg3.serialize(zer);
+    const size_t split = size3 + 3;  // in the middle of the third message header
+
+    // Server and client on the loopback interface. The connection is established in the
+    // listen backlog, there is no need for a distinct client thread.
+    const uint16_t portNumber = 12346;
+    const ts::SocketAddress serverAddress(ts::IPAddress::LocalHost, portNumber);
+    ts::TCPServer server;
+    TSUNIT_ASSERT(server.open(CERR));
+    TSUNIT_ASSERT(server.reusePort(true, CERR));
+    TSUNIT_ASSERT(server.bind(serverAddress, CERR));
+    TSUNIT_ASSERT(server.listen(5, CERR));
+
+    ts::TCPConnection client;
+    TSUNIT_ASSERT(client.open(CERR));
+    TSUNIT_ASSERT(client.connect(serverAddress, CERR));
+
+    ts::tlv::Connection<ts::NullMutex> session(ts::ecmgscs::Protocol::Instance());
+    ts::SocketAddress clientAddress;
+    TSUNIT_ASSERT(server.accept(session, clientAddress, CERR));
+
+    // Send the two first messages and the beginning of the third one.
+    ts::tlv::Logger logger(ts::Severity::Debug, &CERR);
+    std::vector<ts::tlv::MessagePtr> msgs;
+    TSUNIT_ASSERT(client.send(data->data(), split, CERR));
+    while (msgs.size() < 2) {
+        TSUNIT_ASSERT(session.receiveAvailable(msgs, logger));
+    }
+    TSUNIT_EQUAL(2, msgs.size());
+    TSUNIT_EQUAL(ts::ecmgscs::Tags::channel_test, msgs[0]->tag());
+    TSUNIT_EQUAL(1, dynamic_cast<ts::ecmgscs::ChannelTest*>(msgs[0].pointer())->channel_id);
+    TSUNIT_EQUAL(ts::ecmgscs::Tags::stream_test, msgs[1]->tag());
+    TSUNIT_EQUAL(3, dynamic_cast<ts::ecmgscs::StreamTest*>(msgs[1].pointer())->stream_id);
+
+    // Send the end of the third message.
+    TSUNIT_ASSERT(client.send(data->data() + split, data->size() - split, CERR));
+    while (msgs.size() < 3) {
+        TSUNIT_ASSERT(session.receiveAvailable(msgs, logger));
+    }
+    TSUNIT_EQUAL(3, msgs.size());
+    TSUNIT_EQUAL(ts::ecmgscs::Tags::channel_test, msgs[2]->tag());
+    TSUNIT_EQUAL(4, dynamic_cast<ts::ecmgscs::ChannelTest*>(msgs[2].pointer())->channel_id);
+
+    // The client disconnection is reported as an error.
+    TSUNIT_ASSERT(client.disconnect(CERR));
+    TSUNIT_ASSERT(!session.receiveAvailable(msgs, logger));
+    TSUNIT_EQUAL(3, msgs.size());
+
+    client.close(CERR);
+    session.close(NULLREP);
+    TSUNIT_ASSERT(server.close(CERR));
+}
@@ -61,11 +61,15 @@ public:
     void testStackSize();
     void testDeleteWhenTerminated();
     void testPriority();
+    void testAffinity();
+    void testSchedulingPolicy();
 
     TSUNIT_TEST_BEGIN(ThreadAttributesTest);
     TSUNIT_TEST(testStackSize);
     TSUNIT_TEST(testDeleteWhenTerminated);
     TSUNIT_TEST(testPriority);
+    TSUNIT_TEST(testAffinity);
+    TSUNIT_TEST(testSchedulingPolicy);
     TSUNIT_TEST_END();
 };
 
@@ -134,3 +138,32 @@ void ThreadAttributesTest::testPriority()
     attr.setPriority (ts::ThreadAttributes::GetNormalPriority());
     TSUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetNormalPriority());
 }
+
+void ThreadAttributesTest::testAffinity()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getAffinity().empty()); // default value
+
+    const std::set<size_t> cpus({0, 2, 3});
+    TSUNIT_ASSERT(attr.setAffinity(cpus).getAffinity() == cpus);
+    TSUNIT_ASSERT(attr.setAffinity(std::set<size_t>()).getAffinity().empty());
+}
+
+void ThreadAttributesTest::testSchedulingPolicy()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::DEFAULT); // default value
+    TSUNIT_EQUAL(0, attr.getSchedulingPriority());
+
+    attr.setSchedulingPolicy(ts::ThreadAttributes::SchedulingPolicy::FIFO, 60);
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::FIFO);
+    TSUNIT_EQUAL(60, attr.getSchedulingPriority());
+
+    // The real-time priority is meaningless with the default policy.
+    attr.setSchedulingPolicy(ts::ThreadAttributes::SchedulingPolicy::DEFAULT, 60);
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::DEFAULT);
+    TSUNIT_EQUAL(0, attr.getSchedulingPriority());
+
+    TSUNIT_EQUAL(u"rr", ts::ThreadAttributes::SchedulingPolicyEnum.name(ts::ThreadAttributes::SchedulingPolicy::ROUND_ROBIN));
+    TSUNIT_ASSERT(ts::ThreadAttributes::SchedulingPolicyEnum.value(u"fifo") == ts::ThreadAttributes::SchedulingPolicy::FIFO);
+}
@@ -33,6 +33,10 @@
 
 #include "tsxmlModelDocument.h"
 #include "tsxmlElement.h"
+#include "tsxmlJSONConverter.h"
+#include "tsxmlTextSerializer.h"
+#include "tsxmlTreeSerializer.h"
+#include "tsxmlStreamReader.h"
 #include "tsSectionFile.h"
 #include "tsTextFormatter.h"
 #include "tsCerrReport.h"
@@ -63,6 +67,9 @@ public:
     void testEscape();
     void testTweaks();
     void testChannels();
+    void testPrintJSON();
+    void testSerializer();
+    void testStreamReader();
 
     TSUNIT_TEST_BEGIN(XMLTest);
     TSUNIT_TEST(testDocument);
@@ -74,6 +81,9 @@ public:
     TSUNIT_TEST(testEscape);
     TSUNIT_TEST(testTweaks);
     TSUNIT_TEST(testChannels);
+    TSUNIT_TEST(testPrintJSON);
+    TSUNIT_TEST(testSerializer);
+    TSUNIT_TEST(testStreamReader);
     TSUNIT_TEST_END();
 
 private:
@@ -489,3 +499,222 @@ void XMLTest::testChannels()
     ts::xml::Document model(report());
     TSUNIT_ASSERT(model.load(ts::SectionFile::XML_TABLES_MODEL));
 }
+
+void XMLTest::testPrintJSON()
+{
+    ts::xml::JSONConverter conv(report());
+    TSUNIT_ASSERT(conv.load(ts::SectionFile::XML_TABLES_MODEL));
+
+    const ts::UString xmlContent(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<tsduck>\n"
+        u"  <PAT version='2' transport_stream_id='27'>\n"
+        u"    <service service_id='1' program_map_PID='1000'/>\n"
+        u"    <service service_id='2' program_map_PID='2000'/>\n"
+        u"  </PAT>\n"
+        u"  <!-- comment -->\n"
+        u"  <PMT version='3' service_id='789' PCR_PID='3004'>\n"
+        u"    <CA_descriptor CA_system_id='500' CA_PID='3005'>\n"
+        u"      <private_data>  00 01   02 03 04  </private_data>\n"
+        u"    </CA_descriptor>\n"
+        u"    <component stream_type='0x04' elementary_PID='3006' foo='12' bar='true'>\n"
+        u"      <!-- comment -->\n"
+        u"    </component>\n"
+        u"  </PMT>\n"
+        u"  <generic_short_table table_id='0xAB' private='no'>\n"
+        u"    <!-- comment -->\n"
+        u"  </generic_short_table>\n"
+        u"</tsduck>");
+
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(doc.parse(xmlContent));
+
+    // The printed JSON text must be identical to the print of the converted JSON tree.
+    for (int enforce = 0; enforce < 2; ++enforce) {
+        ts::xml::Tweaks tweaks;
+        tweaks.x2jEnforceInteger = tweaks.x2jEnforceBoolean = enforce != 0;
+        conv.setTweaks(tweaks);
+        const ts::json::ValuePtr jroot(conv.convertToJSON(doc, true));
+
+        size_t index = 0;
+        for (const ts::xml::Element* elem = doc.rootElement()->firstChildElement(); elem != nullptr; elem = elem->nextSiblingElement()) {
+            ts::TextFormatter text(report());
+            text.setIndentSize(2);
+            text.setString();
+            conv.printToJSON(text, elem);
+            const ts::UString printed(text.toString());
+            debug() << "XMLTest::testPrintJSON: " << printed << std::endl;
+            TSUNIT_EQUAL(jroot->query(ts::UString::Format(u"#nodes[%d]", {index++})).printed(), printed);
+        }
+        TSUNIT_EQUAL(3, index);
+    }
+}
+
+void XMLTest::testSerializer()
+{
+    const ts::UString xmlContent(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<tsduck>\n"
+        u"  <PMT version='3' service_id='789' PCR_PID='3004'>\n"
+        u"    <CA_descriptor CA_system_id='500' CA_PID='3005'>\n"
+        u"      <private_data>  00 01   02 03 04  </private_data>\n"
+        u"    </CA_descriptor>\n"
+        u"    <component stream_type='0x04' elementary_PID='3006'>\n"
+        u"      <text>A &amp; B</text>\n"
+        u"      <empty/>\n"
+        u"    </component>\n"
+        u"  </PMT>\n"
+        u"</tsduck>");
+
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(doc.parse(xmlContent));
+    const ts::xml::Element* pmt = doc.rootElement()->firstChildElement();
+    TSUNIT_ASSERT(pmt != nullptr);
+
+    // Reference print of the PMT element.
+    ts::TextFormatter ref(report());
+    ref.setIndentSize(2);
+    ref.setString();
+    ref << ts::indent;
+    pmt->print(ref, false);
+    debug() << "XMLTest::testSerializer: " << ref.toString() << std::endl;
+
+    // Direct serialization of the same element.
+    ts::TextFormatter text(report());
+    text.setIndentSize(2);
+    text.setString();
+    text << ts::indent;
+    {
+        ts::xml::TextSerializer output(text);
+        output.addElement(pmt);
+    }
+    TSUNIT_EQUAL(ref.toString(), text.toString());
+
+    // Copy of the element through a tree serializer.
+    ts::xml::Document doc2(report());
+    ts::xml::Element* root2 = doc2.initialize(u"tsduck");
+    {
+        ts::xml::TreeSerializer output(root2);
+        output.addElement(pmt);
+    }
+    const ts::xml::Element* pmt2 = root2->firstChildElement();
+    TSUNIT_ASSERT(pmt2 != nullptr);
+    TSUNIT_EQUAL(2, pmt2->depth());
+    text.setString();
+    text << ts::indent;
+    pmt2->print(text, false);
+    TSUNIT_EQUAL(ref.toString(), text.toString());
+
+    // Elements with streamed attributes and children.
+    text.setString();
+    {
+        ts::xml::TextSerializer output(text, ts::xml::Tweaks(), 1);
+        output.startElement(u"root");
+        output.setIntAttribute(u"value", 12, true);
+        output.setBoolAttribute(u"flag", true);
+        output.setAttribute(u"VALUE", u"13");
+        output.startElement(u"child");
+        output.addText(u"a<b");
+        output.endElement();
+        output.startElement(u"empty");
+        output.setAttribute(u"name", u"", true);
+        output.endElement();
+    }
+    TSUNIT_EQUAL(u"<root flag=\"true\" VALUE=\"13\">\n"
+                 u"  <child>a&lt;b</child>\n"
+                 u"  <empty/>\n"
+                 u"</root>",
+                 text.toString());
+}
+
+void XMLTest::testStreamReader()
+{
+    static const char* const document =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!-- leading <comment> -->\n"
+        "<root attr1=\"val1\"\n"
+        "      attr2='a>b'>\n"
+        "  <node1 a1=\"v1\" a2=\"<v2/>\">Text in node1</node1>\n"
+        "  <!-- <node9/> -->\n"
+        "  <node2 b1=\"x1\">\n"
+        "    <sub><![CDATA[</node2>]]></sub>\n"
+        "  </node2><node3 foo=\"bar\"/>\n"
+        "  <node4 a=\"1\" a=\"2\"/>\n"
+        "  <node5/>\n"
+        "</root>\n"
+        "<!-- trailing comment -->\n";
+
+    std::istringstream strm(document);
+    ts::xml::StreamReader reader(report());
+    TSUNIT_ASSERT(reader.open(strm));
+    TSUNIT_EQUAL(u"root", reader.rootName());
+    TSUNIT_ASSERT(!reader.endOfDocument());
+
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(reader.readElement(doc));
+    ts::xml::Element* root = doc.rootElement();
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_EQUAL(u"root", root->name());
+    TSUNIT_EQUAL(u"val1", root->attribute(u"attr1").value());
+    TSUNIT_EQUAL(u"a>b", root->attribute(u"attr2").value());
+    TSUNIT_EQUAL(1, root->childrenCount());
+    ts::xml::Element* elem = root->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node1", elem->name());
+    TSUNIT_EQUAL(5, elem->lineNumber());
+    TSUNIT_EQUAL(u"<v2/>", elem->attribute(u"a2").value());
+    TSUNIT_EQUAL(u"Text in node1", elem->text());
+
+    TSUNIT_ASSERT(reader.readElement(doc));
+    root = doc.rootElement();
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_EQUAL(1, root->childrenCount());
+    elem = root->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node2", elem->name());
+    TSUNIT_EQUAL(7, elem->lineNumber());
+    elem = elem->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"sub", elem->name());
+    TSUNIT_EQUAL(8, elem->lineNumber());
+    TSUNIT_EQUAL(u"</node2>", elem->text());
+
+    TSUNIT_ASSERT(reader.readElement(doc));
+    elem = doc.rootElement()->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node3", elem->name());
+    TSUNIT_EQUAL(9, elem->lineNumber());
+    TSUNIT_EQUAL(u"bar", elem->attribute(u"foo").value());
+
+    // The invalid node4 is reported and skipped.
+    TSUNIT_ASSERT(!reader.hasErrors());
+    TSUNIT_ASSERT(reader.readElement(doc));
+    TSUNIT_ASSERT(reader.hasErrors());
+    elem = doc.rootElement()->firstChildElement();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node5", elem->name());
+    TSUNIT_EQUAL(11, elem->lineNumber());
+
+    TSUNIT_ASSERT(!reader.readElement(doc));
+    TSUNIT_ASSERT(reader.endOfDocument());
+    TSUNIT_ASSERT(!doc.hasChildren());
+
+    // Empty root element.
+    std::istringstream strm2("<?xml version=\"1.0\"?>\n<root/>\n");
+    TSUNIT_ASSERT(reader.open(strm2));
+    TSUNIT_EQUAL(u"root", reader.rootName());
+    TSUNIT_ASSERT(!reader.readElement(doc));
+    TSUNIT_ASSERT(reader.endOfDocument());
+    TSUNIT_ASSERT(!reader.hasErrors());
+
+    // Truncated document.
+    std::istringstream strm3("<root>\n  <node1/>\n  <node2>\n");
+    TSUNIT_ASSERT(reader.open(strm3));
+    TSUNIT_ASSERT(reader.readElement(doc));
+    TSUNIT_ASSERT(!reader.readElement(doc));
+    TSUNIT_ASSERT(reader.hasErrors());
+
+    // No root element.
+    std::istringstream strm4("<?xml version=\"1.0\"?>\n");
+    TSUNIT_ASSERT(!reader.open(strm4));
+}
@@ -0,0 +1,108 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for function ts::XXHash64
+//
+//----------------------------------------------------------------------------
+
+#include "tsXXHash.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class XXHashTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testKnownValues();
+    void testSeed();
+
+    TSUNIT_TEST_BEGIN(XXHashTest);
+    TSUNIT_TEST(testKnownValues);
+    TSUNIT_TEST(testSeed);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(XXHashTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void XXHashTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void XXHashTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void XXHashTest::testKnownValues()
+{
+    // Reference values from the xxHash reference implementation.
+    static const char s1[] = "abc";
+    static const char s2[] = "Nobody inspects the spammish repetition";
+
+    TSUNIT_EQUAL(TS_UCONST64(0xEF46DB3751D8E999), ts::XXHash64(nullptr, 0));
+    TSUNIT_EQUAL(TS_UCONST64(0x44BC2CF5AD770999), ts::XXHash64(s1, sizeof(s1) - 1));
+    TSUNIT_EQUAL(TS_UCONST64(0xFBCEA83C8A378BF1), ts::XXHash64(s2, sizeof(s2) - 1));
+}
+
+void XXHashTest::testSeed()
+{
+    uint8_t data[200];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = uint8_t(i * 7);
+    }
+
+    // Check all size paths: stripes of 32 bytes, 8-byte, 4-byte and 1-byte tails.
+    for (size_t size = 0; size < sizeof(data); ++size) {
+        const uint64_t h0 = ts::XXHash64(data, size);
+        TSUNIT_EQUAL(h0, ts::XXHash64(data, size, 0));
+        TSUNIT_ASSERT(h0 != ts::XXHash64(data, size, 1));
+        if (size > 0) {
+            TSUNIT_ASSERT(h0 != ts::XXHash64(data, size - 1));
+            TSUNIT_ASSERT(h0 != ts::XXHash64(data + 1, size - 1));
+        }
+    }
+}
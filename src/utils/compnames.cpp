@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------
+//
+//  TSDuck - The MPEG Transport Stream Toolkit
+//  Copyright (c) 2005-2021, Thierry Lelegard
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//  2. Redistributions in binary form must reproduce the above copyright
+//     notice, this list of conditions and the following disclaimer in the
+//     documentation and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+//  THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  This program is used when building TSDuck. It compiles the names files
+//  (tsduck*.names) into binary images (tsduck*.names.bin) which are directly
+//  memory-mapped by TSDuck applications, instead of parsing the text files
+//  at each execution.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsNames.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+//  Command line options
+//----------------------------------------------------------------------------
+
+class Options: public ts::Args
+{
+    TS_NOBUILD_NOCOPY(Options);
+public:
+    Options(int argc, char *argv[]);
+    ts::UStringVector inFiles;
+    ts::UString     outFile;
+};
+
+Options::Options(int argc, char *argv[]) :
+    ts::Args(u"Compile TSDuck names files into binary images.", u"[options] file.names ..."),
+    inFiles(),
+    outFile()
+{
+    option(u"", 0, Args::STRING, 1, Args::UNLIMITED_COUNT);
+    help(u"", u"Names files to compile. By default, the binary image of each file is created in the same directory, with an additional \".bin\" suffix.");
+
+    option(u"output", 'o', Args::STRING);
+    help(u"output", u"Name of the binary image to create. Allowed with only one input file.");
+
+    analyze(argc, argv);
+
+    getValues(inFiles, u"");
+    getValue(outFile, u"output");
+
+    if (!outFile.empty() && inFiles.size() > 1) {
+        error(u"--output cannot be used with more than one input file");
+    }
+    exitOnError();
+}
+
+
+//-----------------------------------------------------------------------------
+// Program entry point
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    Options opt(argc, argv);
+    bool ok = true;
+    for (auto it = opt.inFiles.begin(); it != opt.inFiles.end(); ++it) {
+        ok = ts::Names::CompileFile(*it, opt.outFile, opt) && ok;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}